@@ -1,8 +1,11 @@
 #include <benchmark/benchmark.h>
 #include <cell/arena.h>
 #include <cell/context.h>
+#include <cell/memory_resource.h>
 #include <cell/pool.h>
 
+#include <memory_resource>
+#include <unordered_map>
 #include <vector>
 
 // =============================================================================
@@ -86,6 +89,21 @@ static void BM_Arena_Scope(benchmark::State &state) {
 }
 BENCHMARK(BM_Arena_Scope);
 
+// Per-request arena: a fresh arena fills 2MB in 1KB pieces and is released at the end
+static void BM_Arena_Request_2MB(benchmark::State &state) {
+    Cell::Context ctx;
+
+    for (auto _ : state) {
+        Cell::Arena arena(ctx);
+        for (int i = 0; i < 2048; ++i) {
+            void *ptr = arena.alloc(1024);
+            benchmark::DoNotOptimize(ptr);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 2048);
+}
+BENCHMARK(BM_Arena_Request_2MB);
+
 // =============================================================================
 // Pool<T> Benchmarks
 // =============================================================================
@@ -189,3 +207,80 @@ static void BM_Arena_Temporary_Pattern(benchmark::State &state) {
     state.SetItemsProcessed(state.iterations() * 100);
 }
 BENCHMARK(BM_Arena_Temporary_Pattern);
+
+// =============================================================================
+// std::pmr Resources
+// Build a 1000-element pmr::vector (push_back growth) and a 1000-entry
+// pmr::unordered_map per iteration, then drop them. Cell resources against the
+// standard monotonic and unsynchronized pool resources.
+// =============================================================================
+
+namespace {
+
+    constexpr int kPmrElements = 1000;
+
+    void pmr_vector_round(std::pmr::memory_resource *resource) {
+        std::pmr::vector<int> vec(resource);
+        for (int i = 0; i < kPmrElements; ++i) {
+            vec.push_back(i);
+        }
+        benchmark::DoNotOptimize(vec.data());
+    }
+
+    void pmr_map_round(std::pmr::memory_resource *resource) {
+        std::pmr::unordered_map<int, int> map(resource);
+        for (int i = 0; i < kPmrElements; ++i) {
+            map.emplace(i, i);
+        }
+        benchmark::DoNotOptimize(map.size());
+    }
+
+    // Runs round over five resources: 0 Context, 1 Arena (reset per iteration),
+    // 2 monotonic_buffer_resource (released per iteration), 3 unsynchronized
+    // pool, 4 new_delete_resource
+    template <void (*Round)(std::pmr::memory_resource *)>
+    void pmr_benchmark(benchmark::State &state) {
+        Cell::Context ctx;
+        Cell::ContextResource context_resource(ctx);
+        Cell::Arena arena(ctx);
+        Cell::ArenaResource arena_resource(arena);
+        std::pmr::monotonic_buffer_resource monotonic;
+        std::pmr::unsynchronized_pool_resource pool;
+
+        const int64_t kind = state.range(0);
+        for (auto _ : state) {
+            switch (kind) {
+            case 0:
+                Round(&context_resource);
+                break;
+            case 1:
+                Round(&arena_resource);
+                arena.reset();
+                break;
+            case 2:
+                Round(&monotonic);
+                monotonic.release();
+                break;
+            case 3:
+                Round(&pool);
+                break;
+            default:
+                Round(std::pmr::new_delete_resource());
+                break;
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * kPmrElements);
+        state.SetLabel(kind == 0   ? "ContextResource"
+                       : kind == 1 ? "ArenaResource"
+                       : kind == 2 ? "monotonic_buffer_resource"
+                       : kind == 3 ? "unsynchronized_pool_resource"
+                                   : "new_delete_resource");
+    }
+
+}
+
+static void BM_Pmr_Vector(benchmark::State &state) { pmr_benchmark<pmr_vector_round>(state); }
+BENCHMARK(BM_Pmr_Vector)->DenseRange(0, 4);
+
+static void BM_Pmr_UnorderedMap(benchmark::State &state) { pmr_benchmark<pmr_map_round>(state); }
+BENCHMARK(BM_Pmr_UnorderedMap)->DenseRange(0, 4);
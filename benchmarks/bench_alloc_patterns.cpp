@@ -42,6 +42,41 @@ static void BM_Cell_Small_128B(benchmark::State &state) {
 }
 BENCHMARK(BM_Cell_Small_128B);
 
+// Cache-line-aligned small block, e.g. a per-thread counter kept off shared lines
+static void BM_Cell_Aligned_64B_64(benchmark::State &state) {
+    Cell::Context ctx;
+    for (auto _ : state) {
+        void *ptr = ctx.alloc_aligned(64, 64);
+        benchmark::DoNotOptimize(ptr);
+        ctx.free_aligned_sized(ptr, 64, 64);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Cell_Aligned_64B_64);
+
+// One block from a fresh, decommitted cell in each bin: cell setup plus first-touch faults
+static void BM_Cell_FreshCells_AllBins(benchmark::State &state) {
+    Cell::Context ctx;
+    void *ptrs[Cell::kNumSizeBins];
+
+    for (auto _ : state) {
+        for (size_t bin = 0; bin < Cell::kNumSizeBins; ++bin) {
+            ptrs[bin] = ctx.alloc_bytes(Cell::kSizeClasses[bin]);
+        }
+        benchmark::DoNotOptimize(ptrs);
+
+        state.PauseTiming();
+        for (void *ptr : ptrs) {
+            ctx.free_bytes(ptr);
+        }
+        ctx.flush_tls_caches();
+        ctx.decommit_unused();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * Cell::kNumSizeBins);
+}
+BENCHMARK(BM_Cell_FreshCells_AllBins);
+
 // =============================================================================
 // Medium Allocations (Sub-Cell Bins: 256B - 8KB)
 // =============================================================================
@@ -90,6 +125,24 @@ static void BM_Cell_Medium_16KB(benchmark::State &state) {
 }
 BENCHMARK(BM_Cell_Medium_16KB);
 
+// Full cells in rounds; past the thread's cell cache (64) every round also moves
+// cells to and from the global stack
+static void BM_Cell_FullCell_Rounds(benchmark::State &state) {
+    Cell::Context ctx;
+    std::vector<Cell::CellData *> cells(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        for (auto &cell : cells) {
+            cell = ctx.alloc_cell();
+            benchmark::DoNotOptimize(cell);
+        }
+        for (auto *cell : cells) {
+            ctx.free_cell(cell);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Cell_FullCell_Rounds)->Arg(32)->Arg(256);
+
 // =============================================================================
 // Buddy Allocations (32KB - 2MB)
 // =============================================================================
@@ -127,6 +180,35 @@ static void BM_Cell_Buddy_1MB(benchmark::State &state) {
 }
 BENCHMARK(BM_Cell_Buddy_1MB);
 
+// Frees while the order's free list holds range(0) blocks whose buddies are all live,
+// so every free must decide "buddy not free" against a long, fragmented list.
+static void BM_Cell_Buddy_FragmentedFree(benchmark::State &state) {
+    Cell::Config config;
+    config.reserve_size = 1ULL * 1024 * 1024 * 1024;
+    Cell::Context ctx(config);
+    const auto fragments = static_cast<size_t>(state.range(0));
+
+    std::vector<void *> blocks(fragments * 2);
+    for (void *&ptr : blocks) {
+        ptr = ctx.alloc_bytes(48 * 1024); // 64KB buddy block with its header
+    }
+    for (size_t i = 0; i < blocks.size(); i += 2) {
+        ctx.free_bytes(blocks[i]);
+    }
+
+    for (auto _ : state) {
+        void *ptr = ctx.alloc_bytes(48 * 1024);
+        benchmark::DoNotOptimize(ptr);
+        ctx.free_bytes(ptr);
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    for (size_t i = 1; i < blocks.size(); i += 2) {
+        ctx.free_bytes(blocks[i]);
+    }
+}
+BENCHMARK(BM_Cell_Buddy_FragmentedFree)->Arg(16)->Arg(256)->Arg(4096);
+
 // =============================================================================
 // Large Allocations (>2MB, Direct OS)
 // =============================================================================
@@ -142,6 +224,22 @@ static void BM_Cell_Large_4MB(benchmark::State &state) {
 }
 BENCHMARK(BM_Cell_Large_4MB);
 
+// Per-frame staging buffer: every page is written, so fresh mappings also pay page faults
+static void BM_Cell_Large_StagingBuffer(benchmark::State &state) {
+    Cell::Context ctx;
+    const size_t size = static_cast<size_t>(state.range(0)) * 1024 * 1024;
+    for (auto _ : state) {
+        auto *ptr = static_cast<char *>(ctx.alloc_large(size));
+        for (size_t offset = 0; offset < size; offset += 4096) {
+            ptr[offset] = 1;
+        }
+        benchmark::DoNotOptimize(ptr);
+        ctx.free_large(ptr);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Cell_Large_StagingBuffer)->Arg(4)->Arg(16);
+
 // =============================================================================
 // Batch Allocation Patterns
 // =============================================================================
@@ -200,6 +298,27 @@ static void BM_Cell_BatchAPI_512B(benchmark::State &state) {
 }
 BENCHMARK(BM_Cell_BatchAPI_512B);
 
+// Particle/ECS spawn: 10k same-size objects at once, then one pass over them. Whole
+// cells are carved in address order, so the pass walks memory sequentially.
+static void BM_Cell_BatchAPI_Spawn_64B(benchmark::State &state) {
+    Cell::Context ctx;
+    const size_t batch_size = 10000;
+    std::vector<void *> ptrs(batch_size);
+
+    for (auto _ : state) {
+        size_t allocated = ctx.alloc_batch(64, ptrs.data(), batch_size);
+        for (size_t i = 0; i < allocated; ++i) {
+            static_cast<uint64_t *>(ptrs[i])[0] = i;
+        }
+        benchmark::DoNotOptimize(ptrs.data());
+
+        ctx.free_batch(ptrs.data(), allocated);
+        ctx.flush_tls_caches(); // Next spawn starts cold again
+    }
+    state.SetItemsProcessed(state.iterations() * batch_size);
+}
+BENCHMARK(BM_Cell_BatchAPI_Spawn_64B);
+
 static void BM_Cell_BatchAlloc_1KB(benchmark::State &state) {
     Cell::Context ctx;
     const size_t batch_size = 1000;
@@ -219,6 +338,33 @@ static void BM_Cell_BatchAlloc_1KB(benchmark::State &state) {
 }
 BENCHMARK(BM_Cell_BatchAlloc_1KB);
 
+// Request teardown: thousands of mixed-size objects freed together. Arg 1 frees them
+// with one free_batch() call, arg 0 one free_bytes() at a time.
+static void BM_Cell_FreeBatch_MixedTeardown(benchmark::State &state) {
+    Cell::Context ctx;
+    const bool batched = state.range(0) != 0;
+    const size_t sizes[] = {24, 48, 64, 96, 160, 256, 512, 1024, 3000, 40 * 1024};
+    const size_t batch_size = 4096;
+    std::vector<void *> ptrs(batch_size);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < batch_size; ++i) {
+            ptrs[i] = ctx.alloc_bytes(sizes[i % 10]);
+        }
+        benchmark::DoNotOptimize(ptrs.data());
+
+        if (batched) {
+            ctx.free_batch(ptrs.data(), batch_size);
+        } else {
+            for (size_t i = 0; i < batch_size; ++i) {
+                ctx.free_bytes(ptrs[i]);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * batch_size);
+}
+BENCHMARK(BM_Cell_FreeBatch_MixedTeardown)->Arg(0)->Arg(1);
+
 // =============================================================================
 // Mixed Size Patterns (Realistic Workload)
 // =============================================================================
@@ -270,3 +416,113 @@ static void BM_Cell_Realloc_Growth(benchmark::State &state) {
     state.SetItemsProcessed(state.iterations() * 8); // 8 reallocs per iteration
 }
 BENCHMARK(BM_Cell_Realloc_Growth);
+
+// Log/columnar buffer growth 4MB -> 512MB, writing the last byte after each step
+static void BM_Cell_Realloc_LargeGrowth(benchmark::State &state) {
+    Cell::Context ctx;
+
+    for (auto _ : state) {
+        auto *ptr = static_cast<char *>(ctx.alloc_bytes(4 * 1024 * 1024));
+        for (size_t size = 8 * 1024 * 1024; size <= 512 * 1024 * 1024; size *= 2) {
+            ptr = static_cast<char *>(ctx.realloc_bytes(ptr, size));
+            ptr[size - 1] = 1;
+            benchmark::DoNotOptimize(ptr);
+        }
+        ctx.free_bytes(ptr);
+    }
+    state.SetItemsProcessed(state.iterations() * 7); // 7 reallocs per iteration
+}
+BENCHMARK(BM_Cell_Realloc_LargeGrowth);
+
+// Same growth with the address space reserved up front
+static void BM_Cell_Realloc_ReservedGrowth(benchmark::State &state) {
+    Cell::Context ctx;
+
+    for (auto _ : state) {
+        auto *ptr = static_cast<char *>(ctx.alloc_reserved(4 * 1024 * 1024, 512 * 1024 * 1024));
+        for (size_t size = 8 * 1024 * 1024; size <= 512 * 1024 * 1024; size *= 2) {
+            ptr = static_cast<char *>(ctx.realloc_bytes(ptr, size));
+            ptr[size - 1] = 1;
+            benchmark::DoNotOptimize(ptr);
+        }
+        ctx.free_bytes(ptr);
+    }
+    state.SetItemsProcessed(state.iterations() * 7);
+}
+BENCHMARK(BM_Cell_Realloc_ReservedGrowth);
+
+// =============================================================================
+// Sized vs Unsized Free (one size per tier: sub-cell, buddy, large)
+// =============================================================================
+
+static void BM_Cell_Free_Unsized(benchmark::State &state) {
+    Cell::Context ctx;
+    const size_t size = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        void *ptr = ctx.alloc_bytes(size);
+        benchmark::DoNotOptimize(ptr);
+        ctx.free_bytes(ptr);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Cell_Free_Unsized)->Arg(64)->Arg(100 * 1024)->Arg(4 * 1024 * 1024);
+
+static void BM_Cell_Free_Sized(benchmark::State &state) {
+    Cell::Context ctx;
+    const size_t size = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        void *ptr = ctx.alloc_bytes(size);
+        benchmark::DoNotOptimize(ptr);
+        ctx.free_sized(ptr, size);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Cell_Free_Sized)->Arg(64)->Arg(100 * 1024)->Arg(4 * 1024 * 1024);
+
+// =============================================================================
+// Memory Efficiency (Resident Bytes per Live Byte)
+// =============================================================================
+
+// Holds a live set of one object size (or a mix when the argument is 0) and reports
+// committed cell memory divided by the bytes actually requested. 1.0 is perfect;
+// internal fragmentation from coarse size classes pushes it up.
+static void BM_Cell_ResidentPerLiveByte(benchmark::State &state) {
+    const size_t object_size = static_cast<size_t>(state.range(0));
+    const size_t mixed_sizes[] = {48, 80, 96, 160, 200, 3000};
+    constexpr size_t live_target = 32 * 1024 * 1024;
+
+    double ratio = 0.0;
+    for (auto _ : state) {
+        Cell::Config config;
+        config.reserve_size = 512ULL * 1024 * 1024;
+        Cell::Context ctx(config);
+
+        std::vector<void *> ptrs;
+        size_t live_bytes = 0;
+        for (size_t i = 0; live_bytes < live_target; ++i) {
+            size_t size = object_size ? object_size : mixed_sizes[i % 6];
+            void *ptr = ctx.alloc_bytes(size);
+            if (!ptr)
+                break;
+            ptrs.push_back(ptr);
+            live_bytes += size;
+        }
+        benchmark::DoNotOptimize(ptrs.data());
+
+        ratio = static_cast<double>(ctx.committed_bytes()) / static_cast<double>(live_bytes);
+
+        for (void *ptr : ptrs) {
+            ctx.free_bytes(ptr);
+        }
+    }
+    state.counters["resident_per_live"] = ratio;
+}
+BENCHMARK(BM_Cell_ResidentPerLiveByte)
+    ->Arg(0)
+    ->Arg(48)
+    ->Arg(80)
+    ->Arg(96)
+    ->Arg(160)
+    ->Arg(3000)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <dlfcn.h>
+#include <unistd.h>
+#endif
+
+// =============================================================================
+// Competing Allocators
+// jemalloc, mimalloc and tcmalloc, loaded at runtime when installed so the
+// benchmarks build without them. They are opened RTLD_LOCAL and called through
+// their own entry points; the process malloc stays glibc's.
+// =============================================================================
+
+namespace Bench {
+
+    struct LibraryAllocator {
+        const char *name;
+        void *(*alloc)(size_t size);
+        void (*free)(void *ptr);
+        void *(*realloc)(void *ptr, size_t size);
+    };
+
+    /** @brief Names accepted by load_allocator(), in the order benchmarks list them. */
+    inline const char *const kLibraryAllocators[] = {"jemalloc", "mimalloc", "tcmalloc"};
+
+    namespace detail {
+
+        // jemalloc's unprefixed malloc may be built with a prefix; the *allocx API never is
+        inline void *(*g_mallocx)(size_t, int) = nullptr;
+        inline void (*g_dallocx)(void *, int) = nullptr;
+        inline void *(*g_rallocx)(void *, size_t, int) = nullptr;
+
+        inline void *jemalloc_alloc(size_t size) { return g_mallocx(size, 0); }
+        inline void jemalloc_free(void *ptr) { g_dallocx(ptr, 0); }
+        inline void *jemalloc_realloc(void *ptr, size_t size) { return g_rallocx(ptr, size, 0); }
+
+        struct LibrarySpec {
+            const char *name;
+            const char *files[4];
+            const char *symbols[3]; ///< alloc, free, realloc
+        };
+
+        inline const LibrarySpec kLibrarySpecs[] = {
+            {"jemalloc",
+             {"libjemalloc.so.2", "libjemalloc.so", "libjemalloc.2.dylib", nullptr},
+             {"mallocx", "dallocx", "rallocx"}},
+            {"mimalloc",
+             {"libmimalloc.so.2", "libmimalloc.so", "libmimalloc.dylib", nullptr},
+             {"mi_malloc", "mi_free", "mi_realloc"}},
+            {"tcmalloc",
+             {"libtcmalloc_minimal.so.4", "libtcmalloc.so.4", "libtcmalloc_minimal.4.dylib",
+              nullptr},
+             {"tc_malloc", "tc_free", "tc_realloc"}},
+        };
+
+        inline bool open_library(const LibrarySpec &spec, LibraryAllocator &out) {
+#if defined(__unix__) || defined(__APPLE__)
+            for (const char *file : spec.files) {
+                if (!file) {
+                    break;
+                }
+                void *handle = dlopen(file, RTLD_NOW | RTLD_LOCAL);
+                if (!handle) {
+                    continue;
+                }
+                void *symbols[3];
+                for (int i = 0; i < 3; ++i) {
+                    symbols[i] = dlsym(handle, spec.symbols[i]);
+                }
+                if (!symbols[0] || !symbols[1] || !symbols[2]) {
+                    dlclose(handle);
+                    continue;
+                }
+                out.name = spec.name;
+                if (std::strcmp(spec.name, "jemalloc") == 0) {
+                    g_mallocx = reinterpret_cast<void *(*)(size_t, int)>(symbols[0]);
+                    g_dallocx = reinterpret_cast<void (*)(void *, int)>(symbols[1]);
+                    g_rallocx = reinterpret_cast<void *(*)(void *, size_t, int)>(symbols[2]);
+                    out.alloc = jemalloc_alloc;
+                    out.free = jemalloc_free;
+                    out.realloc = jemalloc_realloc;
+                } else {
+                    out.alloc = reinterpret_cast<void *(*)(size_t)>(symbols[0]);
+                    out.free = reinterpret_cast<void (*)(void *)>(symbols[1]);
+                    out.realloc = reinterpret_cast<void *(*)(void *, size_t)>(symbols[2]);
+                }
+                return true;
+            }
+#else
+            (void)spec;
+            (void)out;
+#endif
+            return false;
+        }
+
+    }
+
+    /**
+     * @brief Loads one of kLibraryAllocators on first use.
+     * @return The allocator, or nullptr if the name is unknown or it is not installed.
+     */
+    inline const LibraryAllocator *load_allocator(const char *name) {
+        static LibraryAllocator s_loaded[3];
+        static bool s_tried[3] = {};
+        static bool s_found[3] = {};
+        for (size_t i = 0; i < 3; ++i) {
+            if (std::strcmp(name, detail::kLibrarySpecs[i].name) != 0) {
+                continue;
+            }
+            if (!s_tried[i]) {
+                s_tried[i] = true;
+                s_found[i] = detail::open_library(detail::kLibrarySpecs[i], s_loaded[i]);
+            }
+            return s_found[i] ? &s_loaded[i] : nullptr;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Returns the process's resident set size, or 0 where it cannot be read.
+     */
+    inline size_t resident_bytes() {
+#ifdef __linux__
+        std::FILE *statm = std::fopen("/proc/self/statm", "r");
+        if (!statm) {
+            return 0;
+        }
+        unsigned long pages = 0;
+        unsigned long resident = 0;
+        int fields = std::fscanf(statm, "%lu %lu", &pages, &resident);
+        std::fclose(statm);
+        return fields == 2 ? resident * static_cast<size_t>(sysconf(_SC_PAGESIZE)) : 0;
+#else
+        return 0;
+#endif
+    }
+
+}
@@ -43,6 +43,16 @@ static void BM_Malloc_Small_128B(benchmark::State &state) {
 }
 BENCHMARK(BM_Malloc_Small_128B);
 
+static void BM_Malloc_Aligned_64B_64(benchmark::State &state) {
+    for (auto _ : state) {
+        void *ptr = std::aligned_alloc(64, 64);
+        benchmark::DoNotOptimize(ptr);
+        std::free(ptr);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Malloc_Aligned_64B_64);
+
 // =============================================================================
 // Medium Allocations
 // =============================================================================
@@ -135,6 +145,20 @@ static void BM_Malloc_Large_4MB(benchmark::State &state) {
 }
 BENCHMARK(BM_Malloc_Large_4MB);
 
+static void BM_Malloc_Large_StagingBuffer(benchmark::State &state) {
+    const size_t size = static_cast<size_t>(state.range(0)) * 1024 * 1024;
+    for (auto _ : state) {
+        auto *ptr = static_cast<char *>(std::malloc(size));
+        for (size_t offset = 0; offset < size; offset += 4096) {
+            ptr[offset] = 1;
+        }
+        benchmark::DoNotOptimize(ptr);
+        std::free(ptr);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Malloc_Large_StagingBuffer)->Arg(4)->Arg(16);
+
 // =============================================================================
 // Batch Allocation Patterns
 // =============================================================================
@@ -223,3 +247,17 @@ static void BM_Malloc_Realloc_Growth(benchmark::State &state) {
     state.SetItemsProcessed(state.iterations() * 8);
 }
 BENCHMARK(BM_Malloc_Realloc_Growth);
+
+static void BM_Malloc_Realloc_LargeGrowth(benchmark::State &state) {
+    for (auto _ : state) {
+        auto *ptr = static_cast<char *>(std::malloc(4 * 1024 * 1024));
+        for (size_t size = 8 * 1024 * 1024; size <= 512 * 1024 * 1024; size *= 2) {
+            ptr = static_cast<char *>(std::realloc(ptr, size));
+            ptr[size - 1] = 1;
+            benchmark::DoNotOptimize(ptr);
+        }
+        std::free(ptr);
+    }
+    state.SetItemsProcessed(state.iterations() * 7);
+}
+BENCHMARK(BM_Malloc_Realloc_LargeGrowth);
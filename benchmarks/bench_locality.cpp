@@ -67,6 +67,25 @@ static void BM_Cell_Pool_Sequential(benchmark::State &state) {
 }
 BENCHMARK(BM_Cell_Pool_Sequential)->Arg(1000)->Arg(10000)->Arg(100000);
 
+// Same objects in a LocalPool, walked through its slabs instead of a pointer array
+static void BM_Cell_LocalPool_ForEachLive(benchmark::State &state) {
+    const size_t count = state.range(0);
+    Cell::Context ctx;
+    Cell::LocalPool<SmallObject> pool(ctx);
+
+    for (size_t i = 0; i < count; ++i) {
+        benchmark::DoNotOptimize(pool.create());
+    }
+
+    for (auto _ : state) {
+        pool.for_each_live([](SmallObject &object) { object.touch(); });
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetBytesProcessed(state.iterations() * count * sizeof(SmallObject));
+}
+BENCHMARK(BM_Cell_LocalPool_ForEachLive)->Arg(1000)->Arg(10000)->Arg(100000);
+
 // =============================================================================
 // malloc: Sequential Traversal
 // =============================================================================
@@ -305,3 +324,41 @@ static void BM_Malloc_CacheLine_Sequential(benchmark::State &state) {
     }
 }
 BENCHMARK(BM_Malloc_CacheLine_Sequential)->Arg(1000)->Arg(10000);
+
+// =============================================================================
+// Huge Page Policy: Random Access Across Many Superblocks (dTLB pressure)
+// =============================================================================
+
+// Arg 0: objects, Arg 1: HugePagePolicy (0 = none, 1 = transparent, 2 = explicit)
+static void BM_Cell_HugePages_Random(benchmark::State &state) {
+    const size_t count = state.range(0);
+    Cell::Config config;
+    config.reserve_size = 2ULL * 1024 * 1024 * 1024;
+    config.huge_pages = static_cast<Cell::HugePagePolicy>(state.range(1));
+    Cell::Context ctx(config);
+
+    std::vector<CacheLineObject *> objects(count);
+    for (size_t i = 0; i < count; ++i) {
+        objects[i] = new (ctx.alloc_bytes(sizeof(CacheLineObject))) CacheLineObject();
+    }
+
+    std::vector<size_t> indices(count);
+    std::iota(indices.begin(), indices.end(), 0);
+    std::mt19937 rng(42);
+    std::shuffle(indices.begin(), indices.end(), rng);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) {
+            objects[indices[i]]->touch();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+    for (auto *obj : objects) {
+        ctx.free_bytes(obj);
+    }
+}
+BENCHMARK(BM_Cell_HugePages_Random)
+    ->Args({1 << 20, 0})
+    ->Args({1 << 20, 1})
+    ->Args({1 << 20, 2});
@@ -0,0 +1,487 @@
+#include <benchmark/benchmark.h>
+#include <cell/context.h>
+
+#include "bench_allocators.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+// =============================================================================
+// Multi-Threaded Stress Benchmarks
+// Workloads where allocators break down in production: cross-thread frees,
+// long- and short-lived mixes, threads that come and go, and footprint that
+// creeps up over time. Each runs on Cell, glibc malloc and every installed
+// library allocator (see bench_allocators.h).
+// =============================================================================
+
+// Shared context of the Cell variants; also where the fragmentation run samples
+// committed bytes from
+static Cell::Context *g_stress_ctx = nullptr;
+
+namespace {
+
+    using AllocFn = void *(*)(size_t);
+    using FreeFn = void (*)(void *);
+
+    void *cell_alloc(size_t size) { return g_stress_ctx->alloc_bytes(size); }
+    void cell_free(void *ptr) { g_stress_ctx->free_bytes(ptr); }
+    void *system_alloc(size_t size) { return std::malloc(size); }
+    void system_free(void *ptr) { std::free(ptr); }
+
+    /**
+     * @brief xorshift64; cheap enough not to show up next to the allocator.
+     */
+    struct Rng {
+        uint64_t state;
+
+        explicit Rng(uint64_t seed) : state(seed * 0x9E3779B97F4A7C15ULL + 1) {}
+
+        uint64_t next() {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return state;
+        }
+    };
+
+    // Writes one byte per page, as a real user of the block would
+    void touch(void *ptr, size_t size) {
+        auto *bytes = static_cast<volatile char *>(ptr);
+        for (size_t offset = 0; offset < size; offset += 4096) {
+            bytes[offset] = 1;
+        }
+    }
+
+    using Workload = void (*)(benchmark::State &, AllocFn, FreeFn);
+
+    /**
+     * @brief Registers BM_<Library>_<name> for every installed library allocator.
+     */
+    bool register_library_variants(const char *name, Workload run,
+                                   void (*apply)(benchmark::internal::Benchmark *)) {
+        for (const char *library_name : Bench::kLibraryAllocators) {
+            const Bench::LibraryAllocator *library = Bench::load_allocator(library_name);
+            if (!library) {
+                continue;
+            }
+            std::string title = std::string("BM_") +
+                                static_cast<char>(std::toupper(library_name[0])) +
+                                (library_name + 1) + "_" + name;
+            benchmark::RegisterBenchmark(title.c_str(), [library, run](benchmark::State &state) {
+                run(state, library->alloc, library->free);
+            })->Apply(apply);
+        }
+        return true;
+    }
+
+}
+
+// =============================================================================
+// Producer/Consumer: cross-thread frees
+// Even threads allocate message batches, odd threads free them. Exercises the
+// remote free path: consumers hand blocks back to the producer's queue.
+// =============================================================================
+
+namespace {
+
+    constexpr size_t kHandoffBatch = 64;
+    constexpr size_t kHandoffSlots = 64;
+
+    struct HandoffBatch {
+        void *ptrs[kHandoffBatch];
+    };
+
+    /**
+     * @brief Bounded single-producer/single-consumer ring of pointer batches.
+     */
+    struct alignas(64) Handoff {
+        alignas(64) std::atomic<size_t> head{0};
+        alignas(64) std::atomic<size_t> tail{0};
+        HandoffBatch slots[kHandoffSlots];
+
+        void push(const HandoffBatch &batch) {
+            size_t t = tail.load(std::memory_order_relaxed);
+            while (t - head.load(std::memory_order_acquire) == kHandoffSlots) {
+                std::this_thread::yield();
+            }
+            slots[t % kHandoffSlots] = batch;
+            tail.store(t + 1, std::memory_order_release);
+        }
+
+        void pop(HandoffBatch &batch) {
+            size_t h = head.load(std::memory_order_relaxed);
+            while (tail.load(std::memory_order_acquire) == h) {
+                std::this_thread::yield();
+            }
+            batch = slots[h % kHandoffSlots];
+            head.store(h + 1, std::memory_order_release);
+        }
+    };
+
+    std::vector<Handoff> *g_handoffs = nullptr;
+
+    template <typename Alloc, typename Free>
+    void run_producer_consumer(benchmark::State &state, Alloc alloc_fn, Free free_fn) {
+        if (state.thread_index() == 0) {
+            g_handoffs = new std::vector<Handoff>(state.threads() / 2);
+        }
+
+        const size_t sizes[] = {64, 128, 256, 512, 1024};
+        bool producer = (state.thread_index() % 2) == 0;
+        Handoff *handoff = nullptr;
+        HandoffBatch batch;
+        size_t n = 0;
+
+        for (auto _ : state) {
+            // Bound inside the loop: thread 0 creates the rings before the start barrier
+            if (!handoff) {
+                handoff = &(*g_handoffs)[state.thread_index() / 2];
+            }
+            if (producer) {
+                for (size_t i = 0; i < kHandoffBatch; ++i) {
+                    batch.ptrs[i] = alloc_fn(sizes[(n++) % 5]);
+                }
+                handoff->push(batch);
+            } else {
+                handoff->pop(batch);
+                for (size_t i = 0; i < kHandoffBatch; ++i) {
+                    free_fn(batch.ptrs[i]);
+                }
+            }
+        }
+
+        if (state.thread_index() == 0) {
+            delete g_handoffs;
+            g_handoffs = nullptr;
+        }
+        state.SetItemsProcessed(state.iterations() * kHandoffBatch);
+    }
+
+    void producer_consumer_args(benchmark::internal::Benchmark *b) {
+        b->Threads(2)->Threads(4)->Threads(8)->UseRealTime();
+    }
+
+}
+
+static void BM_Cell_ProducerConsumer(benchmark::State &state) {
+    if (state.thread_index() == 0) {
+        g_stress_ctx = new Cell::Context();
+    }
+
+    run_producer_consumer(
+        state, [](size_t size) { return g_stress_ctx->alloc_bytes(size); },
+        [](void *ptr) { g_stress_ctx->free_bytes(ptr); });
+
+    if (state.thread_index() == 0) {
+        delete g_stress_ctx;
+        g_stress_ctx = nullptr;
+    }
+}
+BENCHMARK(BM_Cell_ProducerConsumer)->Apply(producer_consumer_args);
+
+static void BM_Malloc_ProducerConsumer(benchmark::State &state) {
+    run_producer_consumer(
+        state, [](size_t size) { return std::malloc(size); }, [](void *ptr) { std::free(ptr); });
+}
+BENCHMARK(BM_Malloc_ProducerConsumer)->Apply(producer_consumer_args);
+
+static const bool s_producer_consumer_libraries = register_library_variants(
+    "ProducerConsumer", run_producer_consumer<AllocFn, FreeFn>, producer_consumer_args);
+
+// =============================================================================
+// Larson: server simulation
+// Every thread replaces random blocks of a shared pool with fresh ones of a
+// random size, so long-lived and short-lived blocks mix. A thread works on one
+// window of the pool and moves to the next every few thousand replacements,
+// freeing what another thread allocated, as when a connection changes hands.
+// =============================================================================
+
+namespace {
+
+    constexpr size_t kLarsonBlocksPerThread = 4096;
+    constexpr size_t kLarsonOpsPerIteration = 64;
+    constexpr size_t kLarsonIterationsPerWindow = 64;
+    constexpr size_t kLarsonMinSize = 16;
+    constexpr size_t kLarsonMaxSize = 1024;
+
+    std::vector<std::atomic<void *>> *g_larson_pool = nullptr;
+
+    template <typename Alloc, typename Free>
+    void run_larson(benchmark::State &state, Alloc alloc_fn, Free free_fn) {
+        size_t threads = static_cast<size_t>(state.threads());
+        if (state.thread_index() == 0) {
+            g_larson_pool = new std::vector<std::atomic<void *>>(threads * kLarsonBlocksPerThread);
+            Rng fill(threads);
+            for (auto &slot : *g_larson_pool) {
+                size_t size = kLarsonMinSize + fill.next() % (kLarsonMaxSize - kLarsonMinSize);
+                slot.store(alloc_fn(size), std::memory_order_relaxed);
+            }
+        }
+
+        Rng rng(static_cast<uint64_t>(state.thread_index()) + 1);
+        size_t window = static_cast<size_t>(state.thread_index());
+        size_t iteration = 0;
+
+        for (auto _ : state) {
+            // A window overlaps another thread's now and then; exchange keeps that safe
+            std::atomic<void *> *slots = g_larson_pool->data() + window * kLarsonBlocksPerThread;
+            for (size_t i = 0; i < kLarsonOpsPerIteration; ++i) {
+                uint64_t roll = rng.next();
+                size_t size = kLarsonMinSize + (roll >> 32) % (kLarsonMaxSize - kLarsonMinSize);
+                void *fresh = alloc_fn(size);
+                static_cast<char *>(fresh)[0] = 1;
+                void *old = slots[roll % kLarsonBlocksPerThread].exchange(
+                    fresh, std::memory_order_acq_rel);
+                free_fn(old);
+            }
+            if (++iteration % kLarsonIterationsPerWindow == 0) {
+                window = (window + 1) % threads;
+            }
+        }
+
+        if (state.thread_index() == 0) {
+            for (auto &slot : *g_larson_pool) {
+                free_fn(slot.load(std::memory_order_relaxed));
+            }
+            delete g_larson_pool;
+            g_larson_pool = nullptr;
+        }
+        state.SetItemsProcessed(state.iterations() * kLarsonOpsPerIteration);
+    }
+
+    void larson_args(benchmark::internal::Benchmark *b) {
+        b->Threads(1)->Threads(2)->Threads(4)->Threads(8)->UseRealTime();
+    }
+
+}
+
+static void BM_Cell_Larson(benchmark::State &state) {
+    if (state.thread_index() == 0) {
+        g_stress_ctx = new Cell::Context();
+    }
+
+    run_larson(state, cell_alloc, cell_free);
+
+    if (state.thread_index() == 0) {
+        delete g_stress_ctx;
+        g_stress_ctx = nullptr;
+    }
+}
+BENCHMARK(BM_Cell_Larson)->Apply(larson_args);
+
+static void BM_Malloc_Larson(benchmark::State &state) {
+    run_larson(state, system_alloc, system_free);
+}
+BENCHMARK(BM_Malloc_Larson)->Apply(larson_args);
+
+static const bool s_larson_libraries =
+    register_library_variants("Larson", run_larson<AllocFn, FreeFn>, larson_args);
+
+// =============================================================================
+// Thread Churn
+// Each iteration spawns a short-lived thread that allocates a burst of blocks,
+// frees half and leaves the rest to its spawner, which frees them after the
+// join. Measures per-thread setup and teardown (caches, TLS slots) and frees of
+// blocks owned by a thread that has exited.
+// =============================================================================
+
+namespace {
+
+    constexpr size_t kChurnBlocks = 256;
+
+    template <typename Alloc, typename Free>
+    void run_thread_churn(benchmark::State &state, Alloc alloc_fn, Free free_fn) {
+        const size_t sizes[] = {32, 96, 256, 1024, 4096};
+        void *orphans[kChurnBlocks / 2];
+
+        for (auto _ : state) {
+            std::thread([&] {
+                for (size_t i = 0; i < kChurnBlocks; ++i) {
+                    void *ptr = alloc_fn(sizes[i % 5]);
+                    static_cast<char *>(ptr)[0] = 1;
+                    if (i % 2 == 0) {
+                        free_fn(ptr);
+                    } else {
+                        orphans[i / 2] = ptr;
+                    }
+                }
+            }).join();
+            for (void *ptr : orphans) {
+                free_fn(ptr);
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * kChurnBlocks);
+    }
+
+    void thread_churn_args(benchmark::internal::Benchmark *b) {
+        b->Threads(1)->Threads(4)->UseRealTime();
+    }
+
+}
+
+static void BM_Cell_ThreadChurn(benchmark::State &state) {
+    if (state.thread_index() == 0) {
+        g_stress_ctx = new Cell::Context();
+    }
+
+    run_thread_churn(state, cell_alloc, cell_free);
+
+    if (state.thread_index() == 0) {
+        delete g_stress_ctx;
+        g_stress_ctx = nullptr;
+    }
+}
+BENCHMARK(BM_Cell_ThreadChurn)->Apply(thread_churn_args);
+
+static void BM_Malloc_ThreadChurn(benchmark::State &state) {
+    run_thread_churn(state, system_alloc, system_free);
+}
+BENCHMARK(BM_Malloc_ThreadChurn)->Apply(thread_churn_args);
+
+static const bool s_thread_churn_libraries =
+    register_library_variants("ThreadChurn", run_thread_churn<AllocFn, FreeFn>, thread_churn_args);
+
+// =============================================================================
+// Fragmentation Over Time
+// Every iteration is one phase: each thread fills its live set with blocks of a
+// size band, then frees a random three quarters of it. The band moves every
+// phase, so survivors of all sizes stay scattered across pages. Thread 0 samples
+// RSS (and committed bytes, on Cell) after every phase.
+//
+// Counters: live_MB is what the threads hold at the end, rss_MB and peak_rss_MB
+// the RSS growth since the run started (final and highest sample), and
+// rss_per_live their bloat. Allocators that keep freed memory around between
+// runs start from a higher baseline, so compare each allocator's rows with its
+// own history.
+// =============================================================================
+
+namespace {
+
+    constexpr size_t kFragmentationFill = 16 * 1024 * 1024; ///< Per thread, per phase.
+    constexpr size_t kFragmentationPhases = 48;
+
+    struct FragmentationBlock {
+        void *ptr;
+        size_t size;
+    };
+
+    std::atomic<size_t> g_fragmentation_live{0};
+
+    template <typename Alloc, typename Free>
+    void run_fragmentation(benchmark::State &state, Alloc alloc_fn, Free free_fn) {
+        bool sampler = state.thread_index() == 0;
+        size_t baseline_rss = 0;
+        size_t peak_rss = 0;
+        size_t final_rss = 0;
+        size_t peak_committed = 0;
+        size_t final_committed = 0;
+        if (sampler) {
+            g_fragmentation_live.store(0);
+            baseline_rss = Bench::resident_bytes();
+        }
+
+        Rng rng(static_cast<uint64_t>(state.thread_index()) + 7);
+        std::vector<FragmentationBlock> live;
+        size_t live_bytes = 0;
+        size_t phase = 0;
+
+        for (auto _ : state) {
+            // Bands 16-32B up to 4-8KB, in a stride that never repeats neighbours
+            size_t band = size_t{16} << ((phase++ * 3) % 9);
+            size_t filled = 0;
+            while (filled < kFragmentationFill) {
+                size_t size = band + rng.next() % band;
+                void *ptr = alloc_fn(size);
+                touch(ptr, size);
+                live.push_back({ptr, size});
+                filled += size;
+            }
+            live_bytes += filled;
+
+            size_t survivors = live.size() / 4;
+            while (live.size() > survivors) {
+                size_t index = rng.next() % live.size();
+                free_fn(live[index].ptr);
+                live_bytes -= live[index].size;
+                live[index] = live.back();
+                live.pop_back();
+            }
+
+            if (sampler) {
+                final_rss = Bench::resident_bytes();
+                peak_rss = std::max(peak_rss, final_rss);
+                if (g_stress_ctx) {
+                    final_committed = g_stress_ctx->committed_bytes();
+                    peak_committed = std::max(peak_committed, final_committed);
+                }
+            }
+
+            // Done before the end barrier: thread 0 reads the total and then
+            // destroys the Context once the loop is over
+            if (phase == static_cast<size_t>(state.max_iterations)) {
+                g_fragmentation_live.fetch_add(live_bytes);
+                state.PauseTiming();
+                for (const FragmentationBlock &block : live) {
+                    free_fn(block.ptr);
+                }
+                live.clear();
+                state.ResumeTiming();
+            }
+        }
+
+        if (sampler) {
+            double mb = 1024.0 * 1024.0;
+            double live_total = static_cast<double>(g_fragmentation_live.load());
+            double growth = static_cast<double>(final_rss > baseline_rss ? final_rss - baseline_rss
+                                                                          : 0);
+            double peak_growth =
+                static_cast<double>(peak_rss > baseline_rss ? peak_rss - baseline_rss : 0);
+            state.counters["live_MB"] = live_total / mb;
+            state.counters["rss_MB"] = growth / mb;
+            state.counters["peak_rss_MB"] = peak_growth / mb;
+            state.counters["rss_per_live"] = live_total > 0 ? growth / live_total : 0.0;
+            if (g_stress_ctx) {
+                state.counters["committed_MB"] = static_cast<double>(final_committed) / mb;
+                state.counters["peak_committed_MB"] = static_cast<double>(peak_committed) / mb;
+            }
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void fragmentation_args(benchmark::internal::Benchmark *b) {
+        b->Threads(1)
+            ->Threads(4)
+            ->Iterations(kFragmentationPhases)
+            ->UseRealTime()
+            ->Unit(benchmark::kMillisecond);
+    }
+
+}
+
+static void BM_Cell_Fragmentation(benchmark::State &state) {
+    if (state.thread_index() == 0) {
+        g_stress_ctx = new Cell::Context();
+    }
+
+    run_fragmentation(state, cell_alloc, cell_free);
+
+    if (state.thread_index() == 0) {
+        delete g_stress_ctx;
+        g_stress_ctx = nullptr;
+    }
+}
+BENCHMARK(BM_Cell_Fragmentation)->Apply(fragmentation_args);
+
+static void BM_Malloc_Fragmentation(benchmark::State &state) {
+    run_fragmentation(state, system_alloc, system_free);
+}
+BENCHMARK(BM_Malloc_Fragmentation)->Apply(fragmentation_args);
+
+static const bool s_fragmentation_libraries = register_library_variants(
+    "Fragmentation", run_fragmentation<AllocFn, FreeFn>, fragmentation_args);
@@ -1,4 +1,5 @@
 #include <benchmark/benchmark.h>
+#include <cell/concurrent_arena.h>
 #include <cell/context.h>
 
 #include <atomic>
@@ -55,6 +56,29 @@ static void BM_Cell_Parallel_Medium_1KB(benchmark::State &state) {
 }
 BENCHMARK(BM_Cell_Parallel_Medium_1KB)->Threads(1)->Threads(2)->Threads(4)->Threads(8);
 
+// Buddy tier scratch buffers (128KB block); exercises the per-thread buddy cache
+static void BM_Cell_Parallel_Buddy_100KB(benchmark::State &state) {
+    if (state.thread_index() == 0) {
+        Cell::Config config;
+        config.reserve_size = 1ULL * 1024 * 1024 * 1024;
+        g_shared_ctx = new Cell::Context(config);
+    }
+
+    for (auto _ : state) {
+        void *ptr = g_shared_ctx->alloc_bytes(100 * 1024);
+        benchmark::DoNotOptimize(ptr);
+        g_shared_ctx->free_bytes(ptr);
+    }
+
+    if (state.thread_index() == 0) {
+        delete g_shared_ctx;
+        g_shared_ctx = nullptr;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Cell_Parallel_Buddy_100KB)->Threads(1)->Threads(2)->Threads(4)->Threads(8);
+
 // =============================================================================
 // Thread-Local Context (No Contention)
 // Each thread has its own context - measures pure allocation speed.
@@ -133,6 +157,126 @@ static void BM_Cell_Parallel_MixedSizes(benchmark::State &state) {
 }
 BENCHMARK(BM_Cell_Parallel_MixedSizes)->Threads(1)->Threads(2)->Threads(4)->Threads(8);
 
+// =============================================================================
+// Same-Bin Churn: TLS spills and refills on a shared bin
+// =============================================================================
+
+// Every thread keeps more blocks live than its TLS cache holds, so each round
+// spills to and refills from cells; owned cells keep that off the bin lock
+static void BM_Cell_Parallel_Churn_64B(benchmark::State &state) {
+    if (state.thread_index() == 0) {
+        g_shared_ctx = new Cell::Context();
+    }
+
+    constexpr size_t kLive = 256;
+    std::vector<void *> ptrs(kLive);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < kLive; ++i) {
+            ptrs[i] = g_shared_ctx->alloc_bytes(64);
+        }
+        benchmark::DoNotOptimize(ptrs.data());
+        for (size_t i = 0; i < kLive; ++i) {
+            g_shared_ctx->free_bytes(ptrs[i]);
+        }
+    }
+
+    if (state.thread_index() == 0) {
+        delete g_shared_ctx;
+        g_shared_ctx = nullptr;
+    }
+
+    state.SetItemsProcessed(state.iterations() * kLive);
+}
+BENCHMARK(BM_Cell_Parallel_Churn_64B)->Threads(1)->Threads(2)->Threads(4)->Threads(8);
+
+// 8KB is the largest sub-cell size: one block per cell
+static void BM_Cell_Parallel_Large_8KB(benchmark::State &state) {
+    if (state.thread_index() == 0) {
+        g_shared_ctx = new Cell::Context();
+    }
+
+    for (auto _ : state) {
+        void *ptr = g_shared_ctx->alloc_bytes(8192);
+        benchmark::DoNotOptimize(ptr);
+        g_shared_ctx->free_bytes(ptr);
+    }
+
+    if (state.thread_index() == 0) {
+        delete g_shared_ctx;
+        g_shared_ctx = nullptr;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Cell_Parallel_Large_8KB)->Threads(1)->Threads(2)->Threads(4)->Threads(8);
+
+// Full cells in rounds of 256, four times the thread's cell cache: every thread
+// refills from and flushes to the shared global stack
+static void BM_Cell_Parallel_FullCell_Rounds(benchmark::State &state) {
+    if (state.thread_index() == 0) {
+        g_shared_ctx = new Cell::Context();
+    }
+
+    std::vector<Cell::CellData *> cells(256);
+    for (auto _ : state) {
+        for (auto &cell : cells) {
+            cell = g_shared_ctx->alloc_cell();
+            benchmark::DoNotOptimize(cell);
+        }
+        for (auto *cell : cells) {
+            g_shared_ctx->free_cell(cell);
+        }
+    }
+
+    if (state.thread_index() == 0) {
+        delete g_shared_ctx;
+        g_shared_ctx = nullptr;
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(cells.size()));
+}
+BENCHMARK(BM_Cell_Parallel_FullCell_Rounds)->Threads(1)->Threads(2)->Threads(4)->Threads(8);
+
+// Frame scratch: every worker bumps from its ConcurrentArena shard, rewinding it every 4096
+// blocks so the footprint stays bounded (a frame reset in miniature)
+static Cell::ConcurrentArena *g_frame_arena = nullptr;
+
+static void BM_ConcurrentArena_Parallel_64B(benchmark::State &state) {
+    if (state.thread_index() == 0) {
+        g_shared_ctx = new Cell::Context();
+        g_frame_arena = new Cell::ConcurrentArena(*g_shared_ctx);
+    }
+
+    Cell::Arena *local = nullptr;
+    Cell::Arena::Marker marker{};
+    size_t count = 0;
+    for (auto _ : state) {
+        if (!local) {
+            local = g_frame_arena->local_arena();
+            if (local) {
+                marker = local->save();
+            }
+        }
+        void *ptr = g_frame_arena->alloc(64);
+        benchmark::DoNotOptimize(ptr);
+        if (++count == 4096 && local) {
+            count = 0;
+            local->reset_to_marker(marker);
+        }
+    }
+
+    if (state.thread_index() == 0) {
+        delete g_frame_arena;
+        g_frame_arena = nullptr;
+        delete g_shared_ctx;
+        g_shared_ctx = nullptr;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConcurrentArena_Parallel_64B)->Threads(1)->Threads(2)->Threads(4)->Threads(8);
+
 // =============================================================================
 // Baseline: malloc parallel comparison
 // =============================================================================
@@ -156,3 +300,13 @@ static void BM_Malloc_Parallel_1KB(benchmark::State &state) {
     state.SetItemsProcessed(state.iterations());
 }
 BENCHMARK(BM_Malloc_Parallel_1KB)->Threads(1)->Threads(2)->Threads(4)->Threads(8);
+
+static void BM_Malloc_Parallel_100KB(benchmark::State &state) {
+    for (auto _ : state) {
+        void *ptr = std::malloc(100 * 1024);
+        benchmark::DoNotOptimize(ptr);
+        std::free(ptr);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Malloc_Parallel_100KB)->Threads(1)->Threads(2)->Threads(4)->Threads(8);
@@ -0,0 +1,628 @@
+#include <cell/context.h>
+#include <cell/trace.h>
+
+#include "bench_allocators.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// =============================================================================
+// Allocation Trace Replay
+// Replays a recorded alloc/free/realloc stream (a TraceWriter file) against Cell,
+// the system malloc and any of jemalloc / mimalloc / tcmalloc that can be loaded,
+// one child process per allocator. Reports throughput, per-op latency percentiles
+// and peak RSS.
+//
+//   cell_trace_replay heap.trace
+//   cell_trace_replay --allocators=cell,jemalloc --config tls_bin_cache_bytes=262144 heap.trace
+//   cell_trace_replay --generate=synthetic.trace --threads=4 --events=2000000
+// =============================================================================
+
+namespace {
+
+    // =========================================================================
+    // Replay Program
+    // =========================================================================
+
+    enum class OpKind : uint8_t { kAlloc, kFree, kRealloc };
+
+    /**
+     * @brief One operation of one replay thread.
+     *
+     * Blocks are named by slot (one per traced allocation) rather than address.
+     * version is the number of earlier ops on the slot, so an op handed a block by
+     * another thread waits until that thread has reached it.
+     */
+    struct Op {
+        OpKind kind;
+        uint8_t tag;
+        uint32_t slot;
+        uint32_t version;
+        uint64_t size;
+    };
+
+    struct Program {
+        std::vector<std::vector<Op>> threads;
+        size_t slots = 0;
+        size_t allocs = 0;
+        size_t frees = 0;
+        size_t reallocs = 0;
+        size_t skipped = 0; ///< Frees and reallocs of blocks allocated before recording.
+        size_t events = 0;
+    };
+
+    bool read_trace(const char *path, std::vector<Cell::TraceEvent> &events) {
+        std::FILE *in = std::fopen(path, "rb");
+        if (!in) {
+            std::fprintf(stderr, "cannot open %s: %s\n", path, std::strerror(errno));
+            return false;
+        }
+        Cell::TraceFileHeader header;
+        bool ok = std::fread(&header, sizeof(header), 1, in) == 1 &&
+                  std::memcmp(header.magic, Cell::TraceFileHeader().magic, 8) == 0 &&
+                  header.event_size == sizeof(Cell::TraceEvent);
+        if (!ok) {
+            std::fprintf(stderr, "%s is not a trace written by Cell::TraceWriter\n", path);
+            std::fclose(in);
+            return false;
+        }
+        Cell::TraceEvent batch[4096];
+        size_t count;
+        while ((count = std::fread(batch, sizeof(Cell::TraceEvent), 4096, in)) > 0) {
+            events.insert(events.end(), batch, batch + count);
+        }
+        std::fclose(in);
+        return true;
+    }
+
+    /**
+     * @brief Turns events into per-thread op lists, resolving addresses to slots.
+     */
+    Program build_program(std::vector<Cell::TraceEvent> &events) {
+        // Rings are drained round-robin, so restore the global order first
+        std::stable_sort(events.begin(), events.end(),
+                         [](const Cell::TraceEvent &a, const Cell::TraceEvent &b) {
+                             return a.timestamp < b.timestamp;
+                         });
+
+        Program program;
+        program.events = events.size();
+        std::unordered_map<uint32_t, size_t> thread_index;
+        std::unordered_map<uint64_t, uint32_t> live; // Address -> slot
+        std::vector<uint32_t> versions;
+
+        for (const Cell::TraceEvent &event : events) {
+            auto it = thread_index.find(event.thread);
+            if (it == thread_index.end()) {
+                it = thread_index.emplace(event.thread, program.threads.size()).first;
+                program.threads.emplace_back();
+            }
+            std::vector<Op> &ops = program.threads[it->second];
+
+            if (event.kind == Cell::TraceKind::kAlloc) {
+                // A block still live at the same address missed its free; leave it leaked
+                auto slot = static_cast<uint32_t>(versions.size());
+                versions.push_back(1);
+                live[event.ptr] = slot;
+                ops.push_back({OpKind::kAlloc, event.tag, slot, 0, event.size});
+                ++program.allocs;
+                continue;
+            }
+
+            auto found = live.find(event.ptr);
+            if (found == live.end()) {
+                ++program.skipped;
+                continue;
+            }
+            uint32_t slot = found->second;
+            if (event.kind == Cell::TraceKind::kFree) {
+                ops.push_back({OpKind::kFree, 0, slot, versions[slot]++, 0});
+                live.erase(found);
+                ++program.frees;
+            } else {
+                ops.push_back({OpKind::kRealloc, event.tag, slot, versions[slot]++, event.size});
+                ++program.reallocs;
+            }
+        }
+        program.slots = versions.size();
+        return program;
+    }
+
+    // =========================================================================
+    // Synthetic Traces
+    // =========================================================================
+
+    /**
+     * @brief Writes a trace of per-thread churn with some cross-thread handoff.
+     *
+     * Sizes are mostly small with a long tail, a tenth of the blocks are freed by the
+     * next thread, and a few are resized. Meant for smoke runs, not for tuning.
+     */
+    bool generate_trace(const char *path, size_t threads, size_t events, uint32_t seed) {
+        std::FILE *out = std::fopen(path, "wb");
+        if (!out) {
+            std::fprintf(stderr, "cannot create %s: %s\n", path, std::strerror(errno));
+            return false;
+        }
+        Cell::TraceFileHeader header;
+        header.ticks_per_second = 1000000000;
+        std::fwrite(&header, sizeof(header), 1, out);
+
+        std::mt19937_64 rng(seed);
+        std::vector<std::vector<uint64_t>> live(threads);
+        std::vector<std::vector<uint64_t>> handoff(threads); // Freed by the owning thread
+        uint64_t next_ptr = 0x100000;
+        size_t written = 0;
+
+        auto emit = [&](Cell::TraceKind kind, size_t thread, uint64_t ptr, uint64_t size) {
+            Cell::TraceEvent event{};
+            event.timestamp = written;
+            event.ptr = ptr;
+            event.size = size;
+            event.thread = static_cast<uint32_t>(thread + 1);
+            event.kind = kind;
+            std::fwrite(&event, sizeof(event), 1, out);
+            ++written;
+        };
+        auto pick_size = [&]() -> uint64_t {
+            uint64_t roll = rng() % 1000;
+            if (roll < 900) {
+                return 8 + rng() % 248; // Small objects
+            }
+            if (roll < 990) {
+                return 256 + rng() % 7936; // Medium
+            }
+            if (roll < 999) {
+                return 16384 + rng() % (1024 * 1024); // Buddy tier
+            }
+            return 4 * 1024 * 1024 + rng() % (4 * 1024 * 1024); // Large
+        };
+
+        while (written < events) {
+            size_t thread = rng() % threads;
+            std::vector<uint64_t> &own = live[thread];
+            uint64_t roll = rng() % 100;
+            if (!handoff[thread].empty() && roll < 10) {
+                emit(Cell::TraceKind::kFree, thread, handoff[thread].back(), 0);
+                handoff[thread].pop_back();
+            } else if (own.size() < 64 || (roll < 55 && own.size() < 4096)) {
+                uint64_t ptr = next_ptr;
+                next_ptr += 16;
+                emit(Cell::TraceKind::kAlloc, thread, ptr, pick_size());
+                if (rng() % 10 == 0) {
+                    handoff[(thread + 1) % threads].push_back(ptr);
+                } else {
+                    own.push_back(ptr);
+                }
+            } else {
+                size_t index = rng() % own.size();
+                uint64_t ptr = own[index];
+                if (roll < 60) {
+                    emit(Cell::TraceKind::kRealloc, thread, ptr, pick_size());
+                    continue;
+                }
+                own[index] = own.back();
+                own.pop_back();
+                emit(Cell::TraceKind::kFree, thread, ptr, 0);
+            }
+        }
+        std::fclose(out);
+        std::printf("wrote %zu events for %zu threads to %s\n", written, threads, path);
+        return true;
+    }
+
+    // =========================================================================
+    // Allocators
+    // =========================================================================
+
+    struct Allocator {
+        const char *name;
+        void *(*alloc)(size_t size, uint8_t tag);
+        void (*free)(void *ptr);
+        void *(*realloc)(void *ptr, size_t size, uint8_t tag);
+        const Bench::LibraryAllocator *library = nullptr; ///< Backs kLibraryAllocator.
+    };
+
+    Cell::Context *g_context = nullptr;
+    Cell::Config g_cell_config;
+
+    const Bench::LibraryAllocator *g_library = nullptr;
+
+    const Allocator kCellAllocator = {
+        "cell",
+        [](size_t size, uint8_t tag) { return g_context->alloc_bytes(size, tag); },
+        [](void *ptr) { g_context->free_bytes(ptr); },
+        [](void *ptr, size_t size, uint8_t tag) {
+            return g_context->realloc_bytes(ptr, size, tag);
+        },
+    };
+
+    const Allocator kMallocAllocator = {
+        "malloc",
+        [](size_t size, uint8_t) { return std::malloc(size); },
+        [](void *ptr) { std::free(ptr); },
+        [](void *ptr, size_t size, uint8_t) { return std::realloc(ptr, size); },
+    };
+
+    /** @brief Calls through g_library, which the child sets from Allocator::library. */
+    const Allocator kLibraryAllocator = {
+        nullptr,
+        [](size_t size, uint8_t) { return g_library->alloc(size); },
+        [](void *ptr) { g_library->free(ptr); },
+        [](void *ptr, size_t size, uint8_t) { return g_library->realloc(ptr, size); },
+    };
+
+    bool set_cell_option(const std::string &option) {
+        size_t eq = option.find('=');
+        if (eq == std::string::npos) {
+            return false;
+        }
+        std::string key = option.substr(0, eq);
+        unsigned long long value = std::strtoull(option.c_str() + eq + 1, nullptr, 0);
+        if (key == "reserve_size") {
+            g_cell_config.reserve_size = value;
+        } else if (key == "tls_bin_cache_bytes") {
+            g_cell_config.tls_bin_cache_bytes = value;
+        } else if (key == "decay_ms") {
+            g_cell_config.decay_ms = static_cast<uint32_t>(value);
+        } else if (key == "numa_nodes") {
+            g_cell_config.numa_nodes = static_cast<uint32_t>(value);
+        } else if (key == "huge_pages") {
+            g_cell_config.huge_pages = static_cast<Cell::HugePagePolicy>(value);
+        } else if (key == "background_scavenger") {
+            g_cell_config.background_scavenger = value != 0;
+        } else if (key == "scavenge_interval_ms") {
+            g_cell_config.scavenge_interval_ms = static_cast<uint32_t>(value);
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    // =========================================================================
+    // Replay
+    // =========================================================================
+
+    /** @brief Per-op latency in trace_clock() ticks, by OpKind. */
+    struct Latencies {
+        std::vector<uint32_t> ticks[3];
+    };
+
+    struct Result {
+        double seconds = 0;
+        uint64_t ops = 0;
+        uint64_t failed = 0;
+        uint64_t percentiles[3][5] = {}; ///< p50, p90, p99, p99.9, max in ns, by OpKind.
+        uint64_t peak_rss_kb = 0;
+    };
+
+    constexpr double kPercentiles[5] = {0.50, 0.90, 0.99, 0.999, 1.0};
+
+    void touch(void *ptr, size_t size) {
+        // Write every page like a real user of the block would, so RSS is comparable
+        auto *bytes = static_cast<volatile char *>(ptr);
+        for (size_t offset = 0; offset < size; offset += 4096) {
+            bytes[offset] = 1;
+        }
+    }
+
+    void replay_thread(const Allocator &allocator, const std::vector<Op> &ops,
+                       std::atomic<void *> *blocks, std::atomic<uint32_t> *versions,
+                       std::atomic<size_t> &ready, size_t threads, Latencies &latencies,
+                       std::atomic<uint64_t> &failed) {
+        for (auto &ticks : latencies.ticks) {
+            ticks.reserve(ops.size() / 2);
+        }
+        ready.fetch_add(1);
+        while (ready.load() < threads) {
+            std::this_thread::yield();
+        }
+
+        for (const Op &op : ops) {
+            if (op.kind != OpKind::kAlloc) {
+                // Blocks handed over by another thread: wait until it got there
+                while (versions[op.slot].load(std::memory_order_acquire) != op.version) {
+                    std::this_thread::yield();
+                }
+            }
+            void *ptr = blocks[op.slot].load(std::memory_order_relaxed);
+            uint64_t start = Cell::trace_clock();
+            switch (op.kind) {
+            case OpKind::kAlloc:
+                ptr = allocator.alloc(op.size, op.tag);
+                break;
+            case OpKind::kFree:
+                if (ptr) {
+                    allocator.free(ptr);
+                }
+                ptr = nullptr;
+                break;
+            case OpKind::kRealloc:
+                ptr = ptr ? allocator.realloc(ptr, op.size, op.tag) : nullptr;
+                break;
+            }
+            uint64_t elapsed = Cell::trace_clock() - start;
+            latencies.ticks[static_cast<size_t>(op.kind)].push_back(
+                static_cast<uint32_t>(std::min<uint64_t>(elapsed, UINT32_MAX)));
+
+            if (op.kind != OpKind::kFree) {
+                if (ptr) {
+                    touch(ptr, op.size);
+                } else {
+                    failed.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            blocks[op.slot].store(ptr, std::memory_order_relaxed);
+            versions[op.slot].store(op.version + 1, std::memory_order_release);
+        }
+    }
+
+    Result replay(const Allocator &allocator, const Program &program, double ns_per_tick) {
+        size_t threads = program.threads.size();
+        std::vector<std::atomic<void *>> blocks(program.slots);
+        std::vector<std::atomic<uint32_t>> versions(program.slots);
+        std::vector<Latencies> latencies(threads);
+        std::atomic<size_t> ready{0};
+        std::atomic<uint64_t> failed{0};
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back(replay_thread, std::cref(allocator), std::cref(program.threads[t]),
+                                 blocks.data(), versions.data(), std::ref(ready), threads,
+                                 std::ref(latencies[t]), std::ref(failed));
+        }
+        for (auto &worker : workers) {
+            worker.join();
+        }
+        Result result;
+        result.seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Blocks the trace never freed are released untimed
+        for (auto &block : blocks) {
+            if (void *ptr = block.load()) {
+                allocator.free(ptr);
+            }
+        }
+
+        for (size_t kind = 0; kind < 3; ++kind) {
+            std::vector<uint32_t> all;
+            for (const Latencies &thread : latencies) {
+                all.insert(all.end(), thread.ticks[kind].begin(), thread.ticks[kind].end());
+            }
+            result.ops += all.size();
+            if (all.empty()) {
+                continue;
+            }
+            std::sort(all.begin(), all.end());
+            for (size_t p = 0; p < 5; ++p) {
+                auto index =
+                    static_cast<size_t>(kPercentiles[p] * static_cast<double>(all.size() - 1));
+                result.percentiles[kind][p] = static_cast<uint64_t>(all[index] * ns_per_tick);
+            }
+        }
+        result.failed = failed.load();
+        return result;
+    }
+
+    /**
+     * @brief Replays in a child process so each allocator's peak RSS is its own.
+     */
+    bool replay_isolated(const Allocator &allocator, const Program &program, double ns_per_tick,
+                         Result &result) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            return false;
+        }
+        pid_t pid = fork();
+        if (pid < 0) {
+            return false;
+        }
+        if (pid == 0) {
+            close(fds[0]);
+            if (std::strcmp(allocator.name, "cell") == 0) {
+                g_context = new Cell::Context(g_cell_config);
+            }
+            g_library = allocator.library;
+            Result child = replay(allocator, program, ns_per_tick);
+            ssize_t written = write(fds[1], &child, sizeof(child));
+            _exit(written == static_cast<ssize_t>(sizeof(child)) ? 0 : 1);
+        }
+        close(fds[1]);
+        bool ok = read(fds[0], &result, sizeof(result)) == static_cast<ssize_t>(sizeof(result));
+        close(fds[0]);
+        int status = 0;
+        struct rusage usage {};
+        wait4(pid, &status, 0, &usage);
+        result.peak_rss_kb = static_cast<uint64_t>(usage.ru_maxrss);
+        return ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+
+    // =========================================================================
+    // Reporting
+    // =========================================================================
+
+    const char *kKindNames[3] = {"alloc", "free", "realloc"};
+
+    void print_text(const char *name, const Result &r) {
+        std::printf("%-10s %9.1f ms %8.2f Mops/s  peak RSS %8.1f MB", name, r.seconds * 1e3,
+                    static_cast<double>(r.ops) / r.seconds / 1e6,
+                    static_cast<double>(r.peak_rss_kb) / 1024.0);
+        if (r.failed > 0) {
+            std::printf("  (%" PRIu64 " failed)", r.failed);
+        }
+        std::printf("\n");
+        for (size_t kind = 0; kind < 3; ++kind) {
+            const uint64_t *p = r.percentiles[kind];
+            std::printf("    %-8s ns  p50 %6" PRIu64 "  p90 %6" PRIu64 "  p99 %7" PRIu64
+                        "  p99.9 %8" PRIu64 "  max %9" PRIu64 "\n",
+                        kKindNames[kind], p[0], p[1], p[2], p[3], p[4]);
+        }
+    }
+
+    void print_json(const char *name, const Result &r, bool first) {
+        std::printf("%s{\"allocator\":\"%s\",\"seconds\":%.6f,\"ops\":%" PRIu64
+                    ",\"failed\":%" PRIu64 ",\"peak_rss_kb\":%" PRIu64 ",\"latency_ns\":{",
+                    first ? "" : ",", name, r.seconds, r.ops, r.failed, r.peak_rss_kb);
+        for (size_t kind = 0; kind < 3; ++kind) {
+            const uint64_t *p = r.percentiles[kind];
+            std::printf("%s\"%s\":{\"p50\":%" PRIu64 ",\"p90\":%" PRIu64 ",\"p99\":%" PRIu64
+                        ",\"p999\":%" PRIu64 ",\"max\":%" PRIu64 "}",
+                        kind ? "," : "", kKindNames[kind], p[0], p[1], p[2], p[3], p[4]);
+        }
+        std::printf("}}");
+    }
+
+    void usage() {
+        std::fprintf(
+            stderr,
+            "usage: cell_trace_replay [options] TRACE\n"
+            "       cell_trace_replay --generate=TRACE [--threads=N] [--events=N] [--seed=N]\n"
+            "\n"
+            "  --allocators=LIST  comma-separated: cell, malloc, jemalloc, mimalloc, tcmalloc\n"
+            "                     (default: cell,malloc plus every optional one found)\n"
+            "  --config KEY=VALUE Cell::Config field for the cell run: reserve_size,\n"
+            "                     tls_bin_cache_bytes, decay_ms, numa_nodes, huge_pages,\n"
+            "                     background_scavenger, scavenge_interval_ms (repeatable)\n"
+            "  --json             print one JSON object instead of a table\n");
+    }
+
+    bool starts_with(const char *arg, const char *prefix, const char *&value) {
+        size_t length = std::strlen(prefix);
+        if (std::strncmp(arg, prefix, length) != 0) {
+            return false;
+        }
+        value = arg + length;
+        return true;
+    }
+
+}
+
+int main(int argc, char **argv) {
+    const char *trace_path = nullptr;
+    const char *generate_path = nullptr;
+    std::string allocator_list;
+    bool json = false;
+    size_t threads = 4;
+    size_t events = 2000000;
+    uint32_t seed = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *value = nullptr;
+        if (starts_with(argv[i], "--allocators=", value)) {
+            allocator_list = value;
+        } else if (std::strcmp(argv[i], "--config") == 0 && i + 1 < argc) {
+            if (!set_cell_option(argv[++i])) {
+                std::fprintf(stderr, "unknown Cell::Config option: %s\n", argv[i]);
+                return 2;
+            }
+        } else if (std::strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (starts_with(argv[i], "--generate=", value)) {
+            generate_path = value;
+        } else if (starts_with(argv[i], "--threads=", value)) {
+            threads = std::max<size_t>(1, std::strtoull(value, nullptr, 10));
+        } else if (starts_with(argv[i], "--events=", value)) {
+            events = std::strtoull(value, nullptr, 10);
+        } else if (starts_with(argv[i], "--seed=", value)) {
+            seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        } else if (argv[i][0] != '-' && !trace_path) {
+            trace_path = argv[i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    if (generate_path) {
+        return generate_trace(generate_path, threads, events, seed) ? 0 : 1;
+    }
+    if (!trace_path) {
+        usage();
+        return 2;
+    }
+
+    std::vector<Cell::TraceEvent> trace;
+    if (!read_trace(trace_path, trace)) {
+        return 1;
+    }
+    Program program = build_program(trace);
+    trace = {};
+    double ns_per_tick = 1e9 / static_cast<double>(Cell::trace_clock_frequency());
+
+    // Pick the allocators to run, loading the optional ones
+    std::vector<Allocator> allocators;
+    bool explicit_list = !allocator_list.empty();
+    std::string list = explicit_list ? allocator_list : "cell,malloc,jemalloc,mimalloc,tcmalloc";
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        std::string name = list.substr(start, comma == std::string::npos ? comma : comma - start);
+        start = comma == std::string::npos ? list.size() + 1 : comma + 1;
+        if (name == "cell") {
+            allocators.push_back(kCellAllocator);
+        } else if (name == "malloc") {
+            allocators.push_back(kMallocAllocator);
+        } else {
+            Allocator library = kLibraryAllocator;
+            library.library = Bench::load_allocator(name.c_str());
+            if (library.library) {
+                library.name = library.library->name;
+                allocators.push_back(library);
+            } else if (explicit_list) {
+                std::fprintf(stderr, "allocator %s not available\n", name.c_str());
+                return 1;
+            }
+        }
+    }
+
+    if (!json) {
+        std::printf("%s: %zu events, %zu threads, %zu allocs, %zu frees, %zu reallocs",
+                    trace_path, program.events, program.threads.size(), program.allocs,
+                    program.frees, program.reallocs);
+        if (program.skipped > 0) {
+            std::printf(", %zu skipped", program.skipped);
+        }
+        std::printf("\n\n");
+    } else {
+        std::printf("{\"trace\":\"%s\",\"events\":%zu,\"threads\":%zu,\"skipped\":%zu,"
+                    "\"results\":[",
+                    trace_path, program.events, program.threads.size(), program.skipped);
+    }
+
+    int status = 0;
+    for (size_t i = 0; i < allocators.size(); ++i) {
+        Result result;
+        if (!replay_isolated(allocators[i], program, ns_per_tick, result)) {
+            std::fprintf(stderr, "%s: replay failed\n", allocators[i].name);
+            status = 1;
+            continue;
+        }
+        if (json) {
+            print_json(allocators[i].name, result, i == 0);
+        } else {
+            print_text(allocators[i].name, result);
+        }
+        std::fflush(stdout);
+    }
+    if (json) {
+        std::printf("]}\n");
+    }
+    return status;
+}
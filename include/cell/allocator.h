@@ -8,6 +8,9 @@
 
 namespace Cell {
 
+    template <typename Policy> struct TlsCache;
+    template <typename Policy> struct BasicTlsSlot;
+
     /**
      * @brief State of a superblock for memory management.
      */
@@ -18,41 +21,91 @@ namespace Cell {
         kDecommitted  ///< All cells free, physical pages released to OS.
     };
 
+    /** @brief Number of SuperblockState values. */
+    static constexpr size_t kSuperblockStateCount = 4;
+
     /**
-     * @brief A free cell node for the lock-free stack.
+     * @brief A free cell node for the caches and the lock-free stacks.
      *
-     * Stored inline in the cell's memory when it's free.
+     * Stored inline in the cell's memory when it's free. The global stacks hold
+     * chains of cells rather than single cells: a chain's first cell records its
+     * length and the next chain, and its cells are linked through next. The second
+     * word is left alone so that the debug fields of the CellHeader survive.
      */
     struct FreeCell {
-        FreeCell *next;
+        FreeCell *next;       ///< Next cell of the same chain or list.
+        uint64_t reserved;    ///< Untouched; overlaps CellHeader::generation and magic.
+        FreeCell *next_chain; ///< First cell of the next chain on a stack (chain heads only).
+        size_t count;         ///< Cells in the chain (chain heads only).
     };
 
     /**
      * @brief Multi-tier memory allocator with memory decommit support.
      *
      * Tier 1: Thread-local cache (no locks)
-     * Tier 2: Global atomic stack (lock-free)
-     * Tier 3: OS superblock allocation
+     * Tier 2: Global atomic stack of cell chains (lock-free)
+     * Tier 3: Purged cells, then OS superblock allocation
+     *
+     * Cells move between Tier 1 and Tier 2 in chains of up to kChainLength, half a
+     * thread cache: a cache miss takes one chain with a single CAS and keeps the rest,
+     * and a free that finds the cache full hands its older half back the same way.
+     * The stack heads carry a version in the bits a cell address leaves clear: the
+     * low ones cell alignment frees and, on x86-64 and AArch64, the top 16 above a
+     * 48-bit address. A pop fails against a head that was popped and pushed again in
+     * between (ABA) unless exactly a multiple of 2^30 updates (16KB cells; 2^14 on
+     * other targets) happened while it was preempted.
+     *
+     * Purged cells: decommit_unused() also releases the free cells of superblocks
+     * that still hold live ones, one cell at a time. A purged cell has no pages, so
+     * it cannot sit on a free stack; it is marked in its superblock's purge bitmap
+     * instead and recommitted when Tier 3 hands it out. Tier 3 takes them from the
+     * densest superblock first, so the sparse ones drain and can be released whole.
+     *
+     * NUMA: the reserved range can be split into one pool per node, each with its
+     * own span of superblocks (bound to the node as they are committed) and its own
+     * global stack. Threads allocate from their home node's pool, and their Tier 1
+     * cache only ever holds home-node cells; cells of other nodes are freed straight
+     * to their own node's stack. A pool that runs out borrows from the others.
+     *
+     * @tparam Policy Geometry policy (cell and superblock size, TLS cache capacity).
      */
-    class Allocator {
+    template <typename Policy> class BasicAllocator {
     public:
+        static constexpr size_t kCellSize = PolicyTraits<Policy>::kCellSize;
+        static constexpr size_t kSuperblockSize = PolicyTraits<Policy>::kSuperblockSize;
+        static constexpr size_t kCellsPerSuperblock = PolicyTraits<Policy>::kCellsPerSuperblock;
+        static constexpr size_t kTlsCacheCapacity = PolicyTraits<Policy>::kTlsCacheCapacity;
+
         /** @brief Maximum superblocks supported (for 8GB reserved = 4096 superblocks). */
         static constexpr size_t kMaxSuperblocks = 8192;
 
+        /** @brief Longest chain of cells on a global stack: half a thread cache. */
+        static constexpr size_t kChainLength = kTlsCacheCapacity > 1 ? kTlsCacheCapacity / 2 : 1;
+
+        static_assert(kCellsPerSuperblock <= UINT16_MAX, "Free cell counts must fit 16 bits");
+
         /**
          * @brief Creates an allocator managing the given reserved range.
          * @param base Start of the reserved virtual address space.
          * @param reserved_size Total reserved bytes.
+         * @param tls_slot Thread-local slot index of the owning Context.
+         * @param tls_owner Id of the owning Context, used to validate the slot.
+         * @param huge_pages Backing applied to each superblock as it is committed.
+         * @param numa_nodes Number of per-node pools (clamped to 1..kMaxNumaNodes).
+         *
+         * The base is rounded up to a superblock boundary, so callers should reserve
+         * one extra superblock to keep the full capacity.
          */
-        explicit Allocator(void *base, size_t reserved_size);
+        BasicAllocator(void *base, size_t reserved_size, uint32_t tls_slot, uint64_t tls_owner,
+                       HugePagePolicy huge_pages = HugePagePolicy::kNone, size_t numa_nodes = 1);
 
-        ~Allocator();
+        ~BasicAllocator();
 
         // Non-copyable, non-movable
-        Allocator(const Allocator &) = delete;
-        Allocator &operator=(const Allocator &) = delete;
-        Allocator(Allocator &&) = delete;
-        Allocator &operator=(Allocator &&) = delete;
+        BasicAllocator(const BasicAllocator &) = delete;
+        BasicAllocator &operator=(const BasicAllocator &) = delete;
+        BasicAllocator(BasicAllocator &&) = delete;
+        BasicAllocator &operator=(BasicAllocator &&) = delete;
 
         /**
          * @brief Allocates a cell (Tier 1 → 2 → 3).
@@ -72,36 +125,155 @@ namespace Cell {
         void flush_tls_cache();
 
         /**
-         * @brief Decommits all fully-free superblocks.
+         * @brief Flushes a given thread's cell cache to the global pool.
+         *
+         * Used when a thread exits or its caches are reclaimed; the caller keeps the
+         * owning thread out of the cache for the duration.
+         */
+        void flush_tls_cache(TlsCache<Policy> &cache);
+
+        /**
+         * @brief Commits superblocks ahead of use and puts all their cells on the pool.
+         *
+         * Superblocks come from the calling thread's home pool, decommitted ones first.
+         * They are marked in use, so decommit_unused() and scavenge() leave them alone
+         * until their cells have been handed out and all returned (decommit_unused()
+         * may still purge single free cells).
+         *
+         * @param superblocks Superblocks to commit; fewer if the pool runs out.
+         * @param populate Fault every page in now rather than on first touch.
+         * @return Number of bytes committed.
+         */
+        size_t prewarm(size_t superblocks, bool populate);
+
+        /**
+         * @brief Tops up the calling thread's cell cache from its home pool.
+         * @return Number of cells moved into the cache.
+         */
+        size_t fill_tls_cache();
+
+        /**
+         * @brief Decommits all fully-free superblocks, and purges the free cells of
+         *        partly used ones found on the global pool or this thread's cache.
+         *
+         * Cells are only purged with HugePagePolicy::kNone: a 16KB release would split
+         * a transparent huge page and cannot be made from an explicit one.
+         *
          * @return Number of bytes released to the OS.
          */
         size_t decommit_unused();
 
+        /**
+         * @brief Decommits superblocks that have been fully free for at least decay_ms.
+         *
+         * Incremental counterpart to decommit_unused() for periodic use: each call
+         * inspects at most kScavengeScanLimit superblocks, starting where the previous
+         * call stopped, and releases at most kScavengeBatchLimit of them. A superblock
+         * is only released once every one of its cells is found on the global pool, so
+         * cells parked in any thread's cache keep it committed. Returns immediately if
+         * another decommit is in progress.
+         *
+         * @param decay_ms Minimum time a superblock must have been fully free.
+         * @param budget_ns Stop releasing superblocks once this much time has passed.
+         * @param lazy Release pages with MADV_FREE where available.
+         * @return Number of bytes released to the OS.
+         */
+        size_t scavenge(uint32_t decay_ms, uint64_t budget_ns, bool lazy);
+
         /**
          * @brief Returns currently committed physical memory.
          */
         [[nodiscard]] size_t committed_bytes() const;
 
+        /**
+         * @brief Returns the number of per-node pools (1 unless NUMA-aware).
+         */
+        [[nodiscard]] size_t node_count() const { return m_node_count; }
+
+        /**
+         * @brief Returns committed bytes in one node's pool.
+         */
+        [[nodiscard]] size_t node_committed_bytes(size_t node) const;
+
+        /**
+         * @brief Returns cells of one node's pool currently handed out (full cells and
+         *        cells backing sub-cell bins), counting cached cells as free.
+         */
+        [[nodiscard]] size_t node_cells_in_use(size_t node) const;
+
+        /**
+         * @brief Counts superblocks in each state, indexed by SuperblockState.
+         *
+         * Superblocks not yet claimed from any pool count as kUncommitted.
+         */
+        void superblock_state_counts(size_t (&counts)[kSuperblockStateCount]) const;
+
     private:
-        void *refill_from_global();    ///< Tier 2 → Tier 1
-        void *refill_from_os();        ///< Tier 3 → Tier 2 → Tier 1
-        void push_global(FreeCell *c); ///< Lock-free push to global
-        FreeCell *pop_global();        ///< Lock-free pop from global
+        using TlsSlot = BasicTlsSlot<Policy>; ///< Thread slot with this policy's caches.
+
+        /**
+         * @brief One NUMA node's share of the reserved range.
+         */
+        struct alignas(64) NodePool {
+            std::atomic<uintptr_t> head{0}; ///< Stack of free cell chains, versioned.
+            std::atomic<size_t> claimed{0}; ///< Superblocks claimed from the span.
+            size_t first_superblock = 0;    ///< Index of the span's first superblock.
+            size_t superblock_count = 0;    ///< Superblocks in the span.
+        };
+
+        TlsSlot *tls_slot();                   ///< Calling thread's slot, or nullptr
+        size_t home_node() const;              ///< Calling thread's pool
+        size_t node_of(size_t sb_idx) const;   ///< Pool owning a superblock
+        void *refill_from_os(size_t node);     ///< Tier 3 → Tier 2 → Tier 1
+        size_t acquire_superblock(size_t node); ///< Commit one, or m_num_superblocks
+        void *carve_superblock(size_t sb_idx); ///< Hand out cell 0, push the rest
+        void push_global(size_t node, FreeCell *c); ///< Push one cell as a chain
+        void push_global_chain(size_t node, FreeCell *first, FreeCell *last); ///< Push chains
+        void push_global_cells(size_t node, FreeCell *list); ///< Push a list as chains
+        FreeCell *pop_global_chain(size_t node);              ///< Pop a whole chain
+        FreeCell *pop_global(size_t node);                    ///< Pop just one cell
+        FreeCell *take_global(size_t node);                   ///< Empty a stack into one list
+        size_t claimed_superblock(size_t ordinal) const;      ///< ordinal-th claimed superblock
 
         size_t get_superblock_index(void *ptr) const;
         bool recommit_superblock(size_t index);
 
-        void *m_base;                                   ///< Start of reserved range.
-        size_t m_reserved_size;                         ///< Total reserved bytes.
-        std::atomic<size_t> m_committed_end{0};         ///< High-water mark for commits.
-        std::atomic<FreeCell *> m_global_head{nullptr}; ///< Lock-free stack head.
+        // Purged cells; purge_cell() and forget_purged() need m_decommit_mutex held
+        void *take_purged_cell(size_t node);        ///< Recommit a purged cell, densest first
+        bool purge_cell(FreeCell *cell);            ///< Release a free cell's pages
+        size_t forget_purged(size_t sb_idx);        ///< Clear a purge bitmap, return its count
+        size_t resident_bytes(size_t sb_idx) const; ///< Committed bytes of a superblock
+
+        void *m_base;                ///< Start of reserved range.
+        size_t m_reserved_size;      ///< Total reserved bytes.
+        uint32_t m_tls_slot;         ///< Owning Context's TLS slot.
+        uint64_t m_tls_owner;        ///< Owning Context's id.
+        HugePagePolicy m_huge_pages; ///< Superblock page backing.
+
+        NodePool m_nodes[kMaxNumaNodes]; ///< Per-node pools; only m_node_count are used.
+        size_t m_node_count = 1;         ///< Number of active pools.
+        size_t m_node_span = 0;          ///< Superblocks per pool (the last takes the rest).
 
         // Superblock tracking for decommit
         size_t m_num_superblocks{0}; ///< Total superblocks possible.
         std::atomic<SuperblockState>
             m_superblock_states[kMaxSuperblocks]{};            ///< Per-superblock state.
         std::atomic<uint16_t> m_free_cells[kMaxSuperblocks]{}; ///< Free cell count per superblock.
-        std::mutex m_decommit_mutex;                           ///< Protects decommit operations.
+        std::atomic<uint32_t>
+            m_free_since[kMaxSuperblocks]{}; ///< Tick (ms) at which each superblock became free.
+        size_t m_scavenge_cursor{0};         ///< Next superblock scavenge() inspects.
+        std::mutex m_decommit_mutex;         ///< Protects decommit operations.
+
+        // Purged cells (guarded by m_decommit_mutex; the counts are also read without it)
+        static constexpr size_t kPurgeWords = (kCellsPerSuperblock + 63) / 64;
+        uint64_t m_purged[kMaxSuperblocks][kPurgeWords]{}; ///< Purged cells per superblock.
+        std::atomic<uint16_t>
+            m_purged_cells[kMaxSuperblocks]{}; ///< Purged cell count per superblock.
+        std::atomic<size_t> m_purged_total{0}; ///< Purged cells in all superblocks.
+        size_t m_purge_hint{0};                ///< Superblock take_purged_cell() last chose.
     };
 
+    /** @brief The cell allocator of the default Context. */
+    using Allocator = BasicAllocator<DefaultPolicy>;
+
 }
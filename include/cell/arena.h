@@ -7,26 +7,63 @@
 
 namespace Cell {
 
+    /**
+     * @brief Growth and retention settings for an Arena.
+     */
+    struct ArenaConfig {
+        /**
+         * @brief Chunk bytes held as single cells before chunks come from the buddy tier.
+         *
+         * Past this, each new chunk is as large as everything the arena already holds
+         * (rounded to a power of 2), so the chunk count grows logarithmically.
+         */
+        size_t cell_chunk_bytes = 64 * 1024;
+
+        /** @brief Upper bound for a grown chunk (default: the largest buddy block). */
+        size_t max_chunk_size = BuddyAllocator::kMaxBlockSize;
+
+        /**
+         * @brief Chunk bytes reset() keeps for reuse (default: all).
+         *
+         * Chunks are kept oldest first while they fit; the rest go back to the Context.
+         */
+        size_t retain_bytes = SIZE_MAX;
+    };
+
     /**
      * @brief A fast linear allocator with bulk deallocation.
      *
-     * Allocations are O(1) pointer bumps. Individual frees are not supported.
-     * Call reset() to free all allocations at once.
+     * Allocations are O(1) pointer bumps into chunks: single cells at first, then
+     * geometrically larger buddy-tier blocks. Requests too large for a cell are
+     * allocated from the Context on their own and freed by reset(), release() or
+     * reset_to_marker(). Individual frees are not supported.
      *
      * Thread safety: NOT thread-safe. Use one Arena per thread.
      */
     class Arena {
+        struct Chunk;
+        struct Oversize;
+
     public:
         /**
          * @brief Creates an arena backed by the given context.
          *
-         * @param ctx Context to allocate cells from.
-         * @param tag Memory tag for profiling (applied to all cells).
+         * @param ctx Context to allocate chunks from.
+         * @param tag Memory tag for profiling (applied to all chunks).
          */
         explicit Arena(Context &ctx, uint8_t tag = 0);
 
         /**
-         * @brief Destroys the arena, returning all cells to the context.
+         * @brief Creates an arena with explicit growth and retention settings.
+         *
+         * @param ctx Context to allocate chunks from.
+         * @param config Growth and retention settings.
+         * @param tag Memory tag for profiling (applied to all chunks).
+         */
+        Arena(Context &ctx, const ArenaConfig &config, uint8_t tag = 0);
+
+        /**
+         * @brief Destroys the arena, returning all chunks to the context.
          */
         ~Arena();
 
@@ -77,13 +114,14 @@ namespace Cell {
         /**
          * @brief Resets the arena, freeing all allocations.
          *
-         * After reset, all previously returned pointers are invalid.
-         * Cells are NOT returned to the context — they're kept for reuse.
+         * After reset, all previously returned pointers are invalid. Oversize
+         * allocations are freed; chunks are kept for reuse up to
+         * ArenaConfig::retain_bytes and the rest are returned to the context.
          */
         void reset();
 
         /**
-         * @brief Resets the arena AND returns all cells to the context.
+         * @brief Resets the arena AND returns all chunks to the context.
          *
          * Use when the arena won't be used for a while to reduce memory.
          */
@@ -97,9 +135,10 @@ namespace Cell {
          * @brief Opaque marker representing the current allocation point.
          */
         struct Marker {
-            size_t cell_index;
-            size_t offset;
+            Chunk *chunk;
+            char *ptr;
             size_t total_allocated;
+            Oversize *oversize;
         };
 
         /**
@@ -111,8 +150,8 @@ namespace Cell {
         /**
          * @brief Resets to a previously saved marker.
          *
-         * All allocations made after the marker was saved become invalid.
-         * Cells allocated after the marker are returned for reuse (not to context).
+         * All allocations made after the marker was saved become invalid. Oversize
+         * allocations made since are freed; chunks are kept for reuse.
          *
          * @param marker Previously saved marker.
          */
@@ -128,12 +167,17 @@ namespace Cell {
         [[nodiscard]] size_t bytes_allocated() const;
 
         /**
-         * @brief Returns total bytes available before needing a new cell.
+         * @brief Returns total bytes available before needing a new chunk.
          */
         [[nodiscard]] size_t bytes_remaining() const;
 
         /**
-         * @brief Returns number of cells currently held by this arena.
+         * @brief Returns the footprint of all chunks held, excluding oversize allocations.
+         */
+        [[nodiscard]] size_t bytes_reserved() const;
+
+        /**
+         * @brief Returns number of chunks (cells or buddy blocks) currently held.
          */
         [[nodiscard]] size_t cell_count() const;
 
@@ -143,59 +187,107 @@ namespace Cell {
         // =====================================================================
 
         /**
-         * @brief Inline linked list node stored at start of each cell's payload.
+         * @brief Header at the start of each chunk's usable space.
          *
-         * This uses the first 8 bytes of usable cell space to chain cells.
+         * Chunks are linked oldest first, so reset() and reset_to_marker() leave the
+         * chunks after the allocation point in order for reuse.
          */
-        struct CellLink {
-            CellData *next;
+        struct Chunk {
+            Chunk *next;      ///< Next newer chunk.
+            size_t capacity;  ///< Usable bytes after the header.
+            size_t footprint; ///< Bytes taken from the Context (cell or buddy block).
         };
 
-        /** @brief Usable space per cell after header and link. */
-        static constexpr size_t kUsablePerCell = kCellSize - kBlockStartOffset - sizeof(CellLink);
+        /**
+         * @brief Record of one oversize allocation, itself allocated in the arena.
+         *
+         * Newest first, so rolling back to a marker frees exactly the allocations
+         * made after it.
+         */
+        struct Oversize {
+            void *ptr;      ///< Block from Context::alloc_bytes() / alloc_aligned().
+            Oversize *next; ///< Previous oversize allocation.
+        };
+
+        /** @brief Chunk header size; keeps the usable space 16-byte aligned. */
+        static constexpr size_t kChunkHeaderSize = align_up_const(sizeof(Chunk), 16);
+
+        /** @brief Usable space of a cell chunk; larger requests are oversize. */
+        static constexpr size_t kUsablePerCell = kCellSize - kBlockStartOffset - kChunkHeaderSize;
 
         // =====================================================================
         // Members
         // =====================================================================
 
         Context &m_ctx;
+        ArenaConfig m_config;
         uint8_t m_tag;
 
-        CellData *m_head = nullptr;      ///< Current cell (allocating from this).
-        size_t m_offset = 0;             ///< Current offset in head cell's usable space.
-        size_t m_cell_count = 0;         ///< Number of cells held.
-        size_t m_current_cell_index = 0; ///< Index of current cell (for markers).
-        size_t m_total_allocated = 0;    ///< Total bytes allocated.
+        Chunk *m_first = nullptr;       ///< Oldest chunk.
+        Chunk *m_last = nullptr;        ///< Newest chunk.
+        Chunk *m_current = nullptr;     ///< Chunk being allocated from (nullptr: none yet).
+        char *m_ptr = nullptr;          ///< Next free byte in m_current.
+        char *m_end = nullptr;          ///< End of m_current's usable space.
+        size_t m_chunk_count = 0;       ///< Number of chunks held.
+        size_t m_reserved_bytes = 0;    ///< Summed footprint of all chunks.
+        size_t m_total_allocated = 0;   ///< Total bytes allocated.
+        Oversize *m_oversize = nullptr; ///< Newest oversize allocation.
 
         // =====================================================================
         // Internal Methods
         // =====================================================================
 
         /**
-         * @brief Gets the start of usable space in a cell (after link).
+         * @brief Gets the start of usable space in a chunk (after the header).
+         */
+        static char *get_usable_start(Chunk *chunk);
+
+        /**
+         * @brief Bumps size bytes out of the current chunk if they fit.
+         * @return The aligned pointer, or nullptr if the chunk is too full.
+         */
+        void *bump(size_t size, size_t alignment);
+
+        /**
+         * @brief Moves to the next kept chunk, or grows a new one after the last.
+         * @return true if successful, false if allocation failed.
          */
-        static char *get_usable_start(CellData *cell);
+        bool advance();
 
         /**
-         * @brief Gets the CellLink from a cell.
+         * @brief Makes chunk the one allocated from, starting at ptr.
          */
-        static CellLink *get_link(CellData *cell);
+        void set_current(Chunk *chunk, char *ptr);
 
         /**
-         * @brief Allocates a new cell and makes it the head.
+         * @brief Takes a new chunk from the context and appends it.
+         *
+         * Single cells until ArenaConfig::cell_chunk_bytes are held, then buddy blocks
+         * doubling the arena's footprint (falling back to a cell if none is free).
+         *
          * @return true if successful, false if allocation failed.
          */
         bool grow();
 
         /**
-         * @brief Available space remaining in current cell.
+         * @brief Links a chunk in as the newest one.
+         */
+        void append_chunk(Chunk *chunk);
+
+        /**
+         * @brief Returns a chunk's memory to the context.
+         */
+        void free_chunk(Chunk *chunk);
+
+        /**
+         * @brief Allocates a request no chunk can hold directly from the context.
          */
-        size_t available() const;
+        void *alloc_oversize(size_t size, size_t alignment);
 
         /**
-         * @brief Aligns an offset up to the given alignment.
+         * @brief Frees oversize allocations newer than until.
          */
-        static size_t align_offset(size_t offset, size_t alignment);
+        void free_oversize(Oversize *until);
     };
 
 }
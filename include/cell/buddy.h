@@ -5,6 +5,7 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <mutex>
 
 namespace Cell {
@@ -38,6 +39,12 @@ namespace Cell {
         /** @brief Maximum block size / superblock size: 2MB */
         static constexpr size_t kMaxBlockSize = size_t{1} << kMaxOrder;
 
+        /** @brief Bytes in front of every user pointer; also the guaranteed alignment. */
+        static constexpr size_t kHeaderSize = 16;
+
+        /** @brief Largest request alloc() serves: a kMaxBlockSize block minus its header. */
+        static constexpr size_t kMaxAllocSize = kMaxBlockSize - kHeaderSize;
+
         // =====================================================================
         // Construction
         // =====================================================================
@@ -47,8 +54,12 @@ namespace Cell {
          *
          * @param base Base address of reserved memory region.
          * @param reserved_size Total reserved size (should be multiple of 2MB).
+         * @param huge_pages Backing applied to each superblock as it is added. Anything
+         *        other than kNone requires base to be a 2MB-aligned mapping owned by
+         *        the caller.
          */
-        BuddyAllocator(void *base, size_t reserved_size);
+        BuddyAllocator(void *base, size_t reserved_size,
+                       HugePagePolicy huge_pages = HugePagePolicy::kNone);
 
         ~BuddyAllocator();
 
@@ -79,6 +90,24 @@ namespace Cell {
          */
         void free(void *ptr);
 
+        /**
+         * @brief Allocates up to count blocks of the same size under one lock acquisition.
+         *
+         * @param size Requested size in bytes (same rounding as alloc()).
+         * @param out_ptrs Array to receive user pointers.
+         * @param count Number of blocks wanted.
+         * @return Number of blocks allocated (may be less than count if memory runs out).
+         */
+        size_t alloc_batch(size_t size, void **out_ptrs, size_t count);
+
+        /**
+         * @brief Frees several blocks under one lock acquisition.
+         *
+         * @param ptrs Pointers returned by alloc() or alloc_batch().
+         * @param count Number of pointers.
+         */
+        void free_batch(void *const *ptrs, size_t count);
+
         /**
          * @brief Reallocates a buddy block to a new size.
          *
@@ -96,6 +125,35 @@ namespace Cell {
          */
         [[nodiscard]] void *realloc_bytes(void *ptr, size_t new_size);
 
+        // =====================================================================
+        // Memory Management
+        // =====================================================================
+
+        /**
+         * @brief Returns the pages of every wholly free 2MB superblock to the OS.
+         *
+         * Released superblocks keep their address range and are recommitted, lowest
+         * address first, before the allocator grows into new space. The lock is not
+         * held across the decommit syscalls.
+         *
+         * @return Number of bytes released.
+         */
+        size_t decommit_unused();
+
+        /**
+         * @brief Releases superblocks that have been wholly free for at least decay_ms.
+         *
+         * Bounded like Allocator::scavenge(): inspects at most kScavengeScanLimit
+         * superblocks, continuing from the previous call, and releases at most
+         * kScavengeBatchLimit of them.
+         *
+         * @param decay_ms Minimum time a superblock must have been wholly free.
+         * @param budget_ns Stop releasing superblocks once this much time has passed.
+         * @param lazy Release pages with MADV_FREE where available.
+         * @return Number of bytes released.
+         */
+        size_t scavenge(uint32_t decay_ms, uint64_t budget_ns, bool lazy);
+
         // =====================================================================
         // Introspection
         // =====================================================================
@@ -111,7 +169,10 @@ namespace Cell {
         [[nodiscard]] size_t bytes_allocated() const;
 
         /**
-         * @brief Returns total bytes committed from OS.
+         * @brief Returns bytes of superblocks currently backed by the OS.
+         *
+         * Superblocks released by decommit_unused() or scavenge() are excluded until
+         * an allocation recommits them.
          */
         [[nodiscard]] size_t bytes_committed() const;
 
@@ -127,6 +188,26 @@ namespace Cell {
          */
         [[nodiscard]] size_t superblock_count() const;
 
+        /**
+         * @brief Counts the blocks on each order's free list (index: order - kMinOrder).
+         *
+         * Walks the lists under the lock, so it costs one step per free block.
+         */
+        void free_block_counts(size_t (&counts)[kNumOrders]) const;
+
+        /**
+         * @brief Returns the block order alloc() would use for a request (header included).
+         * @return Order from kMinOrder to kMaxOrder, or kMaxOrder + 1 if the request is
+         *         over kMaxAllocSize.
+         */
+        [[nodiscard]] static size_t order_for_size(size_t size);
+
+        /**
+         * @brief Returns the order of an allocated block.
+         * @param ptr User pointer from alloc(), known to be owned by this allocator.
+         */
+        [[nodiscard]] static size_t get_block_order(void *ptr);
+
     private:
         // =====================================================================
         // Internal Types
@@ -145,14 +226,15 @@ namespace Cell {
          *
          * Each superblock tracks which blocks are allocated using a bitmap.
          * We use a simple scheme: store the order in a small header before
-         * returning the pointer to the user.
+         * returning the pointer to the user. The header is padded so user pointers
+         * keep the 16-byte alignment malloc() callers expect.
          */
         struct BlockHeader {
             uint8_t order; ///< Allocation order (15-21)
-            uint8_t reserved[7];
+            uint8_t reserved[kHeaderSize - 1];
         };
 
-        static_assert(sizeof(BlockHeader) == 8, "BlockHeader should be 8 bytes");
+        static_assert(sizeof(BlockHeader) == kHeaderSize, "BlockHeader must be kHeaderSize bytes");
 
         // =====================================================================
         // Members
@@ -160,27 +242,84 @@ namespace Cell {
 
         void *m_base;                       ///< Base of reserved region
         size_t m_reserved_size;             ///< Total reserved size
-        std::atomic<size_t> m_committed{0}; ///< Bytes committed from OS
+        std::atomic<size_t> m_committed{0}; ///< End of the grown range (high-water mark)
+        std::atomic<size_t> m_decommitted{0}; ///< Bytes of the grown range released to the OS
         std::atomic<size_t> m_allocated{0}; ///< Bytes currently allocated
         size_t m_superblock_count{0};       ///< Number of superblocks
+        HugePagePolicy m_huge_pages;        ///< Superblock page backing
 
         FreeBlock *m_free_lists[kNumOrders]{}; ///< Free list per order
-        std::mutex m_lock;                     ///< Protects free lists
+        mutable std::mutex m_lock;             ///< Protects free lists and bitmap
+
+        /**
+         * @brief One bit per possible block per order, set while the block is on a free list.
+         *
+         * Lets free() and realloc_bytes() test whether a buddy is free in O(1) instead
+         * of scanning the free list. Orders are packed back to back; order o starts at
+         * bit m_bitmap_offsets[o - kMinOrder].
+         */
+        std::unique_ptr<uint64_t[]> m_free_bitmap;
+        size_t m_bitmap_offsets[kNumOrders]{}; ///< First bit of each order's range
+
+        /**
+         * @brief One bit per superblock, set while its pages are released to the OS.
+         *
+         * A released superblock is on no free list (its memory no longer holds the
+         * links); alloc_locked() recommits from here before calling grow().
+         */
+        std::unique_ptr<uint64_t[]> m_decommitted_bitmap;
+        std::unique_ptr<uint32_t[]> m_free_since; ///< Tick at which each superblock became wholly free
+        size_t m_scavenge_cursor{0};              ///< Next superblock scavenge() inspects
 
         // =====================================================================
         // Internal Methods
         // =====================================================================
 
         /**
-         * @brief Converts size to order (index into free list).
+         * @brief Converts size to order (index into free list); kMaxOrder + 1 past
+         *        kMaxBlockSize.
          */
         static size_t size_to_order(size_t size);
 
+        /**
+         * @brief Allocates a block of exactly the given order. Caller holds m_lock.
+         * @return User pointer, or nullptr if the reserved region is exhausted.
+         */
+        void *alloc_locked(size_t order);
+
+        /**
+         * @brief Returns a block to the free lists, merging buddies. Caller holds m_lock.
+         */
+        void free_locked(void *user_ptr);
+
         /**
          * @brief Allocates a new superblock from reserved memory.
          */
         bool grow();
 
+        /**
+         * @brief Commits a previously released superblock and puts it on the free list.
+         * Caller holds m_lock.
+         * @return false if none is released or the commit failed.
+         */
+        bool recommit();
+
+        /**
+         * @brief Decommits a chain of superblocks taken off the free lists (m_lock not held).
+         *
+         * Blocks are linked through FreeBlock::next. Released ones are marked in the
+         * bitmap; ones that fail to decommit, or come after budget_ns, go back on
+         * the free list.
+         *
+         * @return Number of bytes released.
+         */
+        size_t release_superblocks(FreeBlock *chain, uint64_t budget_ns, bool lazy);
+
+        /**
+         * @brief Returns the superblock index of an address in the region.
+         */
+        size_t superblock_index(void *ptr) const;
+
         /**
          * @brief Adds a block to a free list.
          */
@@ -196,6 +335,16 @@ namespace Cell {
          */
         void *get_buddy(void *ptr, size_t order) const;
 
+        /**
+         * @brief Returns the bitmap bit index for a block of the given order.
+         */
+        size_t bitmap_index(void *ptr, size_t order) const;
+
+        /**
+         * @brief Checks whether a block of the given order is on its free list (O(1)).
+         */
+        bool is_block_free(void *ptr, size_t order) const;
+
         /**
          * @brief Gets the user pointer from internal pointer (after header).
          */
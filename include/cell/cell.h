@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 
 #include "config.h"
@@ -24,12 +25,46 @@ namespace Cell {
     /**
      * @brief A free block node for the inline free-list.
      *
-     * Stored inline in freed memory blocks within a cell.
+     * Stored inline in freed memory blocks within a cell. Links are read and written
+     * through get_next() and set_next() with the owning Context's free-list key.
+     *
+     * CELL_HARDENED builds store the link XOR-encoded with the key and the block's
+     * own address, plus a check word derived from both. Every free block carries a
+     * valid pair: a block written to after it was freed no longer passes intact(),
+     * and a block that still passes it when freed again is a double free. Handing a
+     * block out clears the check word (unseal()). Other builds ignore the key.
      */
     struct FreeBlock {
-        FreeBlock *next; /**< Pointer to next free block in the cell. */
+#ifdef CELL_HARDENED
+        uintptr_t link;  /**< Next free block, encoded. */
+        uintptr_t check; /**< link re-encoded, validates the block on handout. */
+
+        static constexpr uintptr_t seal(uintptr_t link, uintptr_t key) {
+            return ((link << 29) | (link >> (sizeof(uintptr_t) * 8 - 29))) ^ key;
+        }
+
+        FreeBlock *get_next(uintptr_t key) const {
+            return reinterpret_cast<FreeBlock *>(link ^ key ^ reinterpret_cast<uintptr_t>(this));
+        }
+
+        void set_next(FreeBlock *next, uintptr_t key) {
+            link = reinterpret_cast<uintptr_t>(next) ^ key ^ reinterpret_cast<uintptr_t>(this);
+            check = seal(link, key);
+        }
+
+        bool intact(uintptr_t key) const { return check == seal(link, key); }
+
+        void unseal() { check = 0; }
+#else
+        FreeBlock *link; /**< Pointer to next free block in the cell. */
+
+        FreeBlock *get_next(uintptr_t) const { return link; }
+        void set_next(FreeBlock *next, uintptr_t) { link = next; }
+#endif
     };
 
+    static_assert(sizeof(FreeBlock) <= kMinBlockSize, "The smallest block must hold a FreeBlock");
+
     // -------------------------------------------------------------------------
     // Cell Header
     // -------------------------------------------------------------------------
@@ -44,11 +79,12 @@ namespace Cell {
         uint8_t tag;         /**< Application-defined memory tag for profiling. */
         uint8_t size_class;  /**< Size class bin index (0-9), or kFullCellMarker. */
         uint16_t free_count; /**< Number of free blocks remaining in this cell. */
+        uint8_t exclusive;   /**< Nonzero while one thread allocates from it without the bin lock. */
 #ifdef NDEBUG
-        uint8_t reserved[4]; /**< Reserved for future use. */
+        uint8_t reserved[3]; /**< Reserved for future use. */
 #else
+        uint8_t reserved;    /**< Reserved for alignment. */
         uint16_t generation; /**< Incremented on free, detects stale references. */
-        uint16_t reserved;   /**< Reserved for alignment. */
         uint32_t magic;      /**< Magic number for validation (kCellMagic or kCellFreeMagic). */
 #endif
     };
@@ -64,14 +100,23 @@ namespace Cell {
     // Cell Metadata (for sub-cell allocation)
     // -------------------------------------------------------------------------
 
+    struct RemoteFreeQueue;
+
     /**
      * @brief Extended metadata stored after CellHeader for sub-cell management.
      *
-     * Only used when the cell is dedicated to a size class (size_class != kFullCellMarker).
+     * Only used when the cell is dedicated to a size class (size_class != kFullCellMarker),
+     * except owner and heap_slot, which full cells of a tag heap use too (their payload
+     * starts at kBlockStartOffset). free_list holds only blocks that have been freed; the untouched
+     * tail from bump_index on is handed out in address order once the list is empty.
      */
     struct CellMetadata {
         CellHeader *next_partial; /**< Next cell in bin's partial list (nullptr if none). */
         FreeBlock *free_list;     /**< Head of free blocks in this cell. */
+        std::atomic<RemoteFreeQueue *> owner; /**< Queue of the thread refilling from this cell,
+                                                   or kTagHeapOwner. */
+        uint16_t bump_index; /**< First block never handed out; later blocks are free but unlisted. */
+        uint32_t heap_slot;  /**< Index in its TagHeap's cell list (tag heap cells only). */
     };
 
     /**
@@ -81,9 +126,13 @@ namespace Cell {
         return (value + alignment - 1) & ~(alignment - 1);
     }
 
+    /** @brief Offset of CellMetadata from the cell start (keeps the atomic owner aligned). */
+    static constexpr size_t kCellMetadataOffset =
+        align_up_const(sizeof(CellHeader), alignof(CellMetadata));
+
     /** @brief Offset to first allocatable block after header + metadata, aligned to 16 bytes. */
     static constexpr size_t kBlockStartOffset =
-        align_up_const(sizeof(CellHeader) + sizeof(CellMetadata), 16);
+        align_up_const(kCellMetadataOffset + sizeof(CellMetadata), 16);
 
     // -------------------------------------------------------------------------
     // Cell Data
@@ -108,23 +157,24 @@ namespace Cell {
      *
      * Performs a constant-time alignment mask.
      *
+     * @tparam Policy Geometry of the Context owning the Cell.
      * @param ptr Any pointer within a Cell's memory range.
      * @return Pointer to the CellHeader at the start of the Cell.
      */
-    inline CellHeader *get_header(void *ptr) {
+    template <typename Policy = DefaultPolicy> inline CellHeader *get_header(void *ptr) {
         auto addr = reinterpret_cast<uintptr_t>(ptr);
-        return reinterpret_cast<CellHeader *>(addr & kCellMask);
+        return reinterpret_cast<CellHeader *>(addr & PolicyTraits<Policy>::kCellMask);
     }
 
     /**
      * @brief Gets the CellMetadata for a cell.
      *
      * @param header Pointer to the cell header.
-     * @return Pointer to the CellMetadata immediately after the header.
+     * @return Pointer to the CellMetadata following the header.
      */
     inline CellMetadata *get_metadata(CellHeader *header) {
         return reinterpret_cast<CellMetadata *>(reinterpret_cast<char *>(header) +
-                                                sizeof(CellHeader));
+                                                kCellMetadataOffset);
     }
 
     /**
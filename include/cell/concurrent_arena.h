@@ -0,0 +1,257 @@
+#pragma once
+
+#include "arena.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Cell {
+
+    /**
+     * @brief Shard and shared-chunk settings for a ConcurrentArena.
+     */
+    struct ConcurrentArenaConfig {
+        /**
+         * @brief Number of per-thread shards (rounded up to a power of 2).
+         *
+         * Each thread claims the first free shard from the one its thread ordinal maps
+         * to; threads beyond the shard count bump from the shared chunk instead.
+         */
+        size_t shards = 64;
+
+        /** @brief Footprint of each shared-chunk block taken from the Context. */
+        size_t shared_chunk_size = 256 * 1024;
+
+        /** @brief Growth and retention of every shard's Arena. */
+        ArenaConfig shard;
+    };
+
+    /**
+     * @brief A linear allocator many threads allocate from, reset once per frame.
+     *
+     * Every thread claims a shard, an Arena of its own, the first time it allocates
+     * after a reset and bumps from it without atomics; a one-entry thread-local cache
+     * finds it again. Threads that find every shard claimed fall back to an atomic
+     * bump in a shared chunk chain.
+     * Requests too large for a shared chunk are allocated from the Context and freed
+     * on reset.
+     *
+     * Usage:
+     * @code
+     *     Cell::ConcurrentArena frame(ctx);
+     *     // On any worker:
+     *     auto* scratch = frame.alloc_array<float>(1024);
+     *     // Nested scratch within a task, on the worker's own shard:
+     *     if (Cell::Arena* local = frame.local_arena()) {
+     *         Cell::ArenaScope scope(*local);
+     *         auto* temp = local->alloc<TempData>();
+     *     }
+     *     // At frame end, with no worker allocating:
+     *     frame.reset();
+     * @endcode
+     *
+     * Thread safety: alloc(), alloc<T>(), alloc_array<T>() and local_arena() may be
+     * called concurrently. reset(), release() and the introspection functions must
+     * not overlap with them (e.g. run after the frame's tasks have been joined).
+     */
+    class ConcurrentArena {
+    public:
+        /**
+         * @brief Creates a concurrent arena backed by the given context.
+         *
+         * @param ctx Context to allocate chunks from.
+         * @param tag Memory tag for profiling (applied to all chunks).
+         */
+        explicit ConcurrentArena(Context &ctx, uint8_t tag = 0);
+
+        /**
+         * @brief Creates a concurrent arena with explicit shard settings.
+         *
+         * @param ctx Context to allocate chunks from.
+         * @param config Shard and shared-chunk settings.
+         * @param tag Memory tag for profiling (applied to all chunks).
+         */
+        ConcurrentArena(Context &ctx, const ConcurrentArenaConfig &config, uint8_t tag = 0);
+
+        /**
+         * @brief Destroys the arena, returning all memory to the context.
+         */
+        ~ConcurrentArena();
+
+        // Non-copyable, non-movable
+        ConcurrentArena(const ConcurrentArena &) = delete;
+        ConcurrentArena &operator=(const ConcurrentArena &) = delete;
+        ConcurrentArena(ConcurrentArena &&) = delete;
+        ConcurrentArena &operator=(ConcurrentArena &&) = delete;
+
+        // =====================================================================
+        // Allocation
+        // =====================================================================
+
+        /**
+         * @brief Allocates memory from the calling thread's shard or the shared chunk.
+         *
+         * @param size Size in bytes to allocate.
+         * @param alignment Required alignment (default: 8, must be power of 2).
+         * @return Pointer to allocated memory, or nullptr if out of space.
+         */
+        [[nodiscard]] void *alloc(size_t size, size_t alignment = 8);
+
+        /**
+         * @brief Allocates memory for a single object of type T.
+         */
+        template <typename T> [[nodiscard]] T *alloc() {
+            return static_cast<T *>(alloc(sizeof(T), alignof(T)));
+        }
+
+        /**
+         * @brief Allocates memory for an array of objects.
+         */
+        template <typename T> [[nodiscard]] T *alloc_array(size_t count) {
+            return static_cast<T *>(alloc(sizeof(T) * count, alignof(T)));
+        }
+
+        /**
+         * @brief Returns the calling thread's shard, claiming it if needed.
+         *
+         * The shard stays the thread's until reset(), so it can be used like any
+         * Arena in the meantime, including save() / reset_to_marker() and ArenaScope.
+         *
+         * @return The shard, or nullptr if every shard is held by other threads.
+         */
+        [[nodiscard]] Arena *local_arena();
+
+        // =====================================================================
+        // Lifetime Management
+        // =====================================================================
+
+        /**
+         * @brief Frees every allocation of the frame at once.
+         *
+         * Resets every shard (keeping their chunks as Arena::reset() does), rewinds
+         * the shared chunks and frees oversize allocations. Shards are unclaimed, so
+         * each thread claims one afresh on its next allocation.
+         */
+        void reset();
+
+        /**
+         * @brief reset() that also returns all chunks to the context.
+         */
+        void release();
+
+        // =====================================================================
+        // Introspection
+        // =====================================================================
+
+        /**
+         * @brief Returns total bytes allocated since the last reset.
+         */
+        [[nodiscard]] size_t bytes_allocated() const;
+
+        /**
+         * @brief Returns the footprint of all shard and shared chunks held.
+         */
+        [[nodiscard]] size_t bytes_reserved() const;
+
+        /**
+         * @brief Returns the number of shards.
+         */
+        [[nodiscard]] size_t shard_count() const { return m_shard_mask + 1; }
+
+    private:
+        // =====================================================================
+        // Internal Types
+        // =====================================================================
+
+        /**
+         * @brief One thread's Arena, on its own cache line.
+         */
+        struct alignas(64) Shard {
+            explicit Shard(Context &ctx, const ArenaConfig &config, uint8_t tag)
+                : arena(ctx, config, tag) {}
+
+            std::atomic<uint32_t> owner{0}; ///< Ordinal of the claiming thread (0: free).
+            Arena arena;                    ///< Only touched by the owner until reset().
+        };
+
+        /**
+         * @brief Header of a shared chunk; the usable space follows it.
+         */
+        struct SharedChunk {
+            std::atomic<size_t> used; ///< Bytes handed out, bumped by CAS.
+            size_t capacity;          ///< Usable bytes after the header.
+            SharedChunk *next;        ///< Next chunk in allocation order.
+        };
+
+        /** @brief Shared chunk header size; keeps the usable space 16-byte aligned. */
+        static constexpr size_t kSharedHeaderSize = align_up_const(sizeof(SharedChunk), 16);
+
+        // =====================================================================
+        // Members
+        // =====================================================================
+
+        Context &m_ctx;
+        ConcurrentArenaConfig m_config;
+        uint8_t m_tag;
+        uint64_t m_key; ///< Process-unique; renewed by reset() to drop cached shards.
+
+        std::vector<std::unique_ptr<Shard>> m_shards; ///< Power-of-2 count.
+        size_t m_shard_mask = 0;                      ///< shard_count() - 1.
+
+        std::atomic<SharedChunk *> m_shared{nullptr}; ///< Chunk being bumped (nullptr: none).
+        std::atomic<size_t> m_shared_allocated{0};    ///< Bytes from the shared path.
+        size_t m_shared_capacity = 0;                 ///< Usable bytes of each shared chunk.
+
+        std::mutex m_shared_mutex;             ///< Guards the chain and oversize list.
+        SharedChunk *m_shared_first = nullptr; ///< Oldest shared chunk.
+        SharedChunk *m_shared_last = nullptr;  ///< Newest shared chunk.
+        size_t m_shared_reserved = 0;          ///< Footprint of the shared chain.
+        std::vector<void *> m_oversize;        ///< Blocks freed on reset.
+
+        // =====================================================================
+        // Internal Methods
+        // =====================================================================
+
+        /**
+         * @brief Returns the calling thread's shard if it holds or can claim one.
+         */
+        Shard *claim_shard();
+
+        /**
+         * @brief Finds or claims a shard for the calling thread and caches the result.
+         */
+        Shard *claim_shard_slow();
+
+        /**
+         * @brief Allocates from the shared chunk chain (CAS bump).
+         */
+        void *alloc_shared(size_t size, size_t alignment);
+
+        /**
+         * @brief Bumps from one shared chunk.
+         * @return The pointer, or nullptr if the chunk is too full.
+         */
+        static void *bump_shared(SharedChunk *chunk, size_t size, size_t alignment);
+
+        /**
+         * @brief Publishes the next shared chunk after full, taking one if needed.
+         * @return false if the context is out of memory.
+         */
+        bool advance_shared(SharedChunk *full);
+
+        /**
+         * @brief Allocates a request no shared chunk can hold from the context.
+         */
+        void *alloc_oversize(size_t size, size_t alignment);
+
+        /**
+         * @brief Rewinds or frees the shared chunks and frees oversize blocks.
+         */
+        void reset_shared(bool release_chunks);
+    };
+
+}
@@ -1,87 +1,146 @@
 #pragma once
 
+#include "policy.h"
+
+#include <bitset>
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
 namespace Cell {
 
-    /**
-     * @brief Log2 of the Cell size. Default is 14 (16KB).
-     *
-     * Must be a power of 2. Minimum is 12 (4KB, standard page size).
-     */
-    static constexpr size_t kCellSizeLog2 = 14;
-
-    /** @brief Cell size in bytes (2^kCellSizeLog2). */
-    static constexpr size_t kCellSize = 1ULL << kCellSizeLog2;
-
-    /** @brief Bitmask for aligning pointers to Cell boundaries. */
-    static constexpr uintptr_t kCellMask = ~(kCellSize - 1);
+    // -------------------------------------------------------------------------
+    // Default Geometry (DefaultPolicy)
+    // -------------------------------------------------------------------------
 
-    static_assert(kCellSize >= 4096, "Cell size must be at least 4KB (standard page size)");
-    static_assert((kCellSize & (kCellSize - 1)) == 0, "Cell size must be a power of 2");
+    /// @name Geometry of Context, for code written against the default policy
+    /// BasicContext<Policy> and its parts use PolicyTraits<Policy> instead.
+    /// @{
+    using DefaultTraits = PolicyTraits<DefaultPolicy>;
+
+    static constexpr size_t kCellSizeLog2 = DefaultTraits::kCellSizeLog2; ///< 14 (16KB).
+    static constexpr size_t kCellSize = DefaultTraits::kCellSize;
+    static constexpr uintptr_t kCellMask = DefaultTraits::kCellMask;
+    static constexpr size_t kSuperblockSizeLog2 = DefaultTraits::kSuperblockSizeLog2; ///< 21.
+    static constexpr size_t kSuperblockSize = DefaultTraits::kSuperblockSize;
+    static constexpr size_t kCellsPerSuperblock = DefaultTraits::kCellsPerSuperblock;
+    static constexpr size_t kNumSizeBins = DefaultTraits::kNumSizeBins;
+    static constexpr const size_t (&kSizeClasses)[kNumSizeBins] = DefaultTraits::kSizeClasses;
+    static constexpr size_t kMaxSubCellSize = DefaultTraits::kMaxSubCellSize; ///< 8KB.
+    static constexpr size_t kTlsCacheCapacity = DefaultTraits::kTlsCacheCapacity;
+    static constexpr size_t kTlsBinCacheCount = DefaultTraits::kTlsBinCacheCount;
+    static constexpr size_t kTlsBinCacheCapacity = DefaultTraits::kTlsBinCacheCapacity;
+    static constexpr size_t kTlsBuddyCacheOrders = DefaultTraits::kTlsBuddyCacheOrders;
+    static constexpr size_t kTlsBuddyCacheCapacity = DefaultTraits::kTlsBuddyCacheCapacity;
+    /// @}
 
     // -------------------------------------------------------------------------
     // Allocation Tier Configuration
     // -------------------------------------------------------------------------
 
-    /** @brief Log2 of the superblock size. Default is 21 (2MB). */
-    static constexpr size_t kSuperblockSizeLog2 = 21;
+    /** @brief Fewest blocks a TLS bin cache shrinks to. */
+    static constexpr size_t kTlsBinCacheMinCapacity = 2;
+
+    /** @brief Bytes of blocks a TLS bin cache starts with room for. */
+    static constexpr size_t kTlsBinCacheInitialBytes = 4096;
 
-    /** @brief Superblock size in bytes (2^kSuperblockSizeLog2). */
-    static constexpr size_t kSuperblockSize = 1ULL << kSuperblockSizeLog2;
+    /** @brief Overflows without a miss in between after which a TLS bin cache halves. */
+    static constexpr size_t kTlsBinShrinkOverflows = 8;
 
-    /** @brief Number of cells carved from each superblock. */
-    static constexpr size_t kCellsPerSuperblock = kSuperblockSize / kCellSize;
+    /** @brief Number of buddy blocks moved per refill or spill (one lock acquisition). */
+    static constexpr size_t kTlsBuddyBatchRefill = 2;
 
-    /** @brief Number of cells cached per thread (TLS). */
-    static constexpr size_t kTlsCacheCapacity = 64;
+    /** @brief Uncached buddy blocks Context::free_batch() gathers per buddy lock acquisition. */
+    static constexpr size_t kFreeBatchBuddyChunk = 64;
 
-    /** @brief Number of bins with TLS caching (bins 0-8: 16B to 4KB). */
-    static constexpr size_t kTlsBinCacheCount = 9;
+    /**
+     * @brief Budget a thread leases from its Context at a time (CELL_ENABLE_BUDGET).
+     *
+     * Near the limit leases shrink to a fraction of what is left, so threads holding
+     * unspent leases cannot starve one another of much more than this each.
+     */
+    static constexpr size_t kBudgetLeaseBytes = 64 * 1024;
 
-    /** @brief Number of blocks cached per bin per thread. */
-    static constexpr size_t kTlsBinCacheCapacity = 32;
+    /** @brief Unspent lease past which a thread hands back all but kBudgetLeaseBytes. */
+    static constexpr size_t kBudgetLeaseMaxBytes = 2 * kBudgetLeaseBytes;
 
-    /** @brief Number of blocks to refill from global bin at once. */
-    static constexpr size_t kTlsBinBatchRefill = 16;
+    /** @brief Live Contexts that can use thread-local caches at once (more run uncached). */
+    static constexpr size_t kMaxTlsContexts = 16;
 
-    // Static validation for allocation tiers
-    static_assert(kSuperblockSize >= kCellSize, "Superblock must be >= cell size");
-    static_assert(kSuperblockSize % kCellSize == 0, "Superblock must be multiple of cell size");
-    static_assert(kCellsPerSuperblock >= 1, "Must have at least 1 cell per superblock");
-    static_assert(kTlsCacheCapacity >= 1, "TLS cache must hold at least 1 cell");
+    /** @brief Maximum NUMA nodes a Context keeps separate cell pools for. */
+    static constexpr size_t kMaxNumaNodes = 8;
+
+    static_assert(kTlsBinCacheMinCapacity >= 1, "TLS bin caches must hold at least 1 block");
+    static_assert(kTlsBuddyBatchRefill >= 1, "Buddy batches must move at least 1 block");
 
     // -------------------------------------------------------------------------
-    // Sub-Cell Allocation Configuration (Size Classes)
+    // Scavenger Configuration
     // -------------------------------------------------------------------------
 
-    /** @brief Number of size class bins for sub-cell allocation. */
-    static constexpr size_t kNumSizeBins = 10;
+    /** @brief Superblocks inspected per scavenge step. */
+    static constexpr size_t kScavengeScanLimit = 64;
 
-    /** @brief Minimum block size in bytes (must fit a free-list pointer). */
-    static constexpr size_t kMinBlockSize = 16;
+    /** @brief Superblocks released at most per scavenge step. */
+    static constexpr size_t kScavengeBatchLimit = 8;
 
-    /** @brief Maximum size for sub-cell allocation. Larger uses full cells. */
-    static constexpr size_t kMaxSubCellSize = 8192;
+    /** @brief Time budget of each background scavenge step (0.5ms). */
+    static constexpr uint64_t kBackgroundScavengeBudgetNs = 500000;
 
-    /** @brief Size class lookup table (power-of-2 sizes). */
-    static constexpr size_t kSizeClasses[kNumSizeBins] = {16,  32,   64,   128,  256,
-                                                          512, 1024, 2048, 4096, 8192};
+    static_assert(kScavengeBatchLimit >= 1 && kScavengeBatchLimit <= kScavengeScanLimit,
+                  "Scavenge batch must fit in one scan");
+
+    // -------------------------------------------------------------------------
+    // Sub-Cell Allocation Configuration
+    // -------------------------------------------------------------------------
 
     /** @brief Number of warm cells to keep per bin (avoids thrashing). */
     static constexpr size_t kWarmCellsPerBin = 2;
 
-    /** @brief Marker for full-cell allocations (not sub-cell). */
-    static constexpr uint8_t kFullCellMarker = 0xFF;
+    /**
+     * @brief How superblocks of the cell and buddy regions are backed.
+     *
+     * Superblocks are 2MB, the x86-64 huge page size, and are kept 2MB-aligned so
+     * that committing or decommitting one never splits a huge page.
+     */
+    enum class HugePagePolicy : uint8_t {
+        kNone,        ///< Regular 4KB pages.
+        kTransparent, ///< madvise(MADV_HUGEPAGE) each superblock as it is committed (Linux THP).
+        kExplicit,    ///< Map each superblock from the hugetlbfs pool (MAP_HUGETLB); falls back
+                      ///< to kTransparent when the pool is exhausted.
+    };
+
+    /**
+     * @brief What Context::prewarm() readies ahead of the first allocations.
+     *
+     * The defaults do nothing: every field is opt-in.
+     */
+    struct PrewarmSpec {
+        /** @brief Cell superblocks (2MB each) to commit and put on the cell pool. */
+        size_t superblocks = 0;
+
+        /**
+         * @brief Fault in the committed pages now (MADV_POPULATE_WRITE, else touching
+         *        every page), not just reserve them. Default: true.
+         */
+        bool populate = true;
+
+        /**
+         * @brief Allocation sizes whose size classes get cells set up in advance.
+         *
+         * Sizes over kMaxSubCellSize are skipped. Each class gets cells_per_size cells
+         * on its shared bin, ready to hand out blocks.
+         */
+        std::vector<size_t> sizes;
 
-    // Static validation for sub-cell configuration
-    static_assert(kNumSizeBins > 0, "Must have at least 1 size bin");
-    static_assert(kMinBlockSize >= sizeof(void *), "Min block must fit a pointer");
-    static_assert(kMaxSubCellSize < kCellSize, "Max sub-cell size must be < cell size");
-    static_assert(kSizeClasses[0] == kMinBlockSize, "First size class must match min block size");
-    static_assert(kSizeClasses[kNumSizeBins - 1] == kMaxSubCellSize,
-                  "Last size class must match max");
+        /** @brief Cells to set up for each of sizes. Default: 1. */
+        size_t cells_per_size = 1;
+
+        /**
+         * @brief Also fill the calling thread's caches: a batch of blocks for each of
+         *        sizes and a full cell cache. Default: true.
+         */
+        bool fill_thread_cache = true;
+    };
 
     /**
      * @brief Configuration for creating a Context.
@@ -94,6 +153,74 @@ namespace Cell {
          */
         size_t reserve_size = 16ULL * 1024 * 1024 * 1024;
 
+        /**
+         * @brief Huge page backing for cell and buddy superblocks.
+         *
+         * Default: kNone. Ignored on platforms without huge page support; on Windows,
+         * large pages cannot be committed into a reservation, so all policies behave
+         * like kNone.
+         */
+        HugePagePolicy huge_pages = HugePagePolicy::kNone;
+
+        /**
+         * @brief Number of NUMA nodes to keep separate cell pools for.
+         *
+         * Default: 1 (NUMA-unaware). 0 uses every node on the machine. Each pool gets
+         * an even share of the cell reservation, bound to its node, and threads take
+         * cells from their home node's pool. Capped at kMaxNumaNodes.
+         */
+        uint32_t numa_nodes = 1;
+
+        /**
+         * @brief How long a superblock must stay fully free before scavenge() releases it.
+         *
+         * Default: 1000ms. Short enough to return memory after a burst, long enough
+         * that steady churn keeps reusing warm pages.
+         */
+        uint32_t decay_ms = 1000;
+
+        /**
+         * @brief Run Context::scavenge() periodically on a background thread.
+         *
+         * Default: false. When off, scavenge() can be pumped from the application,
+         * e.g. once per frame.
+         */
+        bool background_scavenger = false;
+
+        /**
+         * @brief Interval between background scavenge steps.
+         *
+         * Default: 100ms. Only used with background_scavenger.
+         */
+        uint32_t scavenge_interval_ms = 100;
+
+        /**
+         * @brief Per-thread ceiling on the capacity of all TLS bin caches, in bytes.
+         *
+         * Default: 512KB. Each bin's cache starts at kTlsBinCacheInitialBytes and grows
+         * towards kTlsBinCacheCapacity blocks as it misses, but only while the summed
+         * capacity (blocks times block size) of the thread's bins stays under this.
+         */
+        size_t tls_bin_cache_bytes = 512 * 1024;
+
+        /**
+         * @brief Tags whose allocations get size bins and cells of their own.
+         *
+         * Default: none. alloc_bytes() requests up to a cell (and alloc_batch() /
+         * alloc_contiguous()) with one of these tags never share a cell with another
+         * tag, and Context::release_tag() hands all of the tag's cells back at once.
+         * Such a tag bypasses the thread caches: its blocks are allocated and freed
+         * under a lock of its own. Tag 0 cannot be segregated.
+         */
+        std::bitset<256> tag_heaps;
+
+        /**
+         * @brief Memory to ready while the Context is constructed (Context::prewarm()).
+         *
+         * Default: nothing. The thread caches filled are the constructing thread's.
+         */
+        PrewarmSpec prewarm;
+
 #ifdef CELL_ENABLE_BUDGET
         /**
          * @brief Maximum bytes this Context may allocate.
@@ -103,6 +230,17 @@ namespace Cell {
          */
         size_t memory_budget = 0;
 #endif
+
+#ifdef CELL_ENABLE_HEAP_PROFILE
+        /**
+         * @brief Mean bytes allocated between two heap profile samples, per thread.
+         *
+         * Each sample costs a call stack capture and a locked table insert; at the
+         * default (512KB) that is a few samples per second even for threads
+         * allocating gigabytes per second. 0 turns sampling off.
+         */
+        size_t heap_profile_sample_bytes = 512 * 1024;
+#endif
     };
 
 }
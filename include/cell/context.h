@@ -6,6 +6,7 @@
 #include "config.h"
 #include "debug.h"
 #include "large.h"
+#include "snapshot.h"
 #include "stats.h"
 #include "sub_cell.h"
 
@@ -14,9 +15,24 @@
 #ifdef CELL_DEBUG_LEAKS
 #include <unordered_map>
 #endif
+#ifdef CELL_ENABLE_TRACE
+#include "trace.h"
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+#include <cstdio>
+#endif
 
 namespace Cell {
 
+    template <typename Policy> struct TagHeap;
+    template <typename Policy> struct TlsBinCache;
+    template <typename Policy> struct BasicTlsSlot;
+    template <typename Policy> struct BasicRemoteFreeQueue;
+    struct TlsSlot;
+    struct TraceRing;
+    class Scavenger;
+    class HeapProfiler;
+
 #ifdef CELL_ENABLE_BUDGET
     /**
      * @brief Callback invoked when an allocation would exceed the budget.
@@ -45,39 +61,89 @@ namespace Cell {
     using AllocationCallback = void (*)(void *ptr, size_t size, uint8_t tag, bool is_alloc);
 #endif
 
+    /**
+     * @brief Block returned by Context::alloc_at_least(), in the spirit of
+     *        std::allocation_result: the pointer and how much of it the caller may use.
+     */
+    struct AllocationResult {
+        void *ptr = nullptr; ///< Block, or nullptr on failure.
+        size_t size = 0;     ///< Usable bytes, at least the requested size (0 on failure).
+    };
+
     /**
      * @brief A memory environment owning a reserved virtual address range.
      *
      * RAII: Memory is released when the Context is destroyed.
      *
-     * @warning DESIGN CONSTRAINT: Only ONE Context instance per thread is supported at a time.
-     * The TLS cache scheme assumes a single active Context per thread. Sequential Contexts
-     * (create → destroy → create) are safe, but concurrent Contexts on the same thread will
-     * cause cache conflicts and undefined behavior.
+     * Cross-thread frees: a sub-cell block freed by a thread other than the one that
+     * refilled from its cell is pushed onto the owner's lock-free remote free queue and
+     * reused by the owner on its next TLS miss, instead of filling the freeing thread's
+     * cache and spilling into the locked global bins.
+     *
+     * Multiple Contexts: any number of Contexts may be live and used from the same
+     * thread. Each claims one of kMaxTlsContexts thread-local slots, so its cached
+     * cells and blocks never mix with another Context's. Contexts created while every
+     * slot is taken still work, but skip the TLS caches and take the per-bin locks.
+     *
+     * Geometry: cell and superblock size, the size classes and the thread cache
+     * capacities come from Policy (see DefaultPolicy), so Contexts of different
+     * geometries can live in one program; Context is BasicContext<DefaultPolicy>. The
+     * library instantiates DefaultPolicy and LargeCellPolicy. Pointers may only be
+     * inspected with the free functions of the same policy, e.g.
+     * get_header<LargeCellPolicy>(), and the helpers taking a Context (arenas, pools,
+     * StlAllocator, TraceWriter) work with the default one.
+     *
+     * @tparam Policy Geometry policy; see PolicyTraits for what it must define.
      */
-    class Context {
+    template <typename Policy> class BasicContext {
     public:
+        using Traits = PolicyTraits<Policy>;
+
+        // =====================================================================
+        // Geometry (from Policy)
+        // =====================================================================
+
+        static constexpr size_t kCellSize = Traits::kCellSize;
+        static constexpr uintptr_t kCellMask = Traits::kCellMask;
+        static constexpr size_t kSuperblockSize = Traits::kSuperblockSize;
+        static constexpr size_t kCellsPerSuperblock = Traits::kCellsPerSuperblock;
+        static constexpr size_t kNumSizeBins = Traits::kNumSizeBins;
+        static constexpr const size_t (&kSizeClasses)[kNumSizeBins] = Traits::kSizeClasses;
+        static constexpr size_t kMaxSubCellSize = Traits::kMaxSubCellSize;
+        static constexpr size_t kTlsCacheCapacity = Traits::kTlsCacheCapacity;
+        static constexpr size_t kTlsBinCacheCount = Traits::kTlsBinCacheCount;
+        static constexpr size_t kTlsBinCacheCapacity = Traits::kTlsBinCacheCapacity;
+        static constexpr size_t kTlsBuddyCacheOrders = Traits::kTlsBuddyCacheOrders;
+        static constexpr size_t kTlsBuddyCacheCapacity = Traits::kTlsBuddyCacheCapacity;
+
+        static_assert(kTlsBuddyBatchRefill <= kTlsBuddyCacheCapacity,
+                      "Buddy batch must fit in the buddy TLS cache");
+        static_assert(kTlsBuddyCacheOrders <= BuddyAllocator::kNumOrders,
+                      "TLS-cached buddy orders must be real orders");
+        static_assert(block_starts_lossless<Policy>(),
+                      "Aligning block starts must not cost blocks");
+
         /**
          * @brief Creates a new memory environment with the given configuration.
          * @param config Configuration options for the context.
          */
-        explicit Context(const Config &config = Config{});
+        explicit BasicContext(const Config &config = Config{});
 
         /**
          * @brief Releases all virtual and physical memory.
          *
          * @warning All threads must stop using this Context before destruction.
          * Any pointers obtained from this Context become invalid after destruction.
-         * Thread-local caches are only cleared for the calling thread; other
-         * threads should call flush_tls_caches() before destruction.
+         * Other threads' caches are simply abandoned; a thread that exits while the
+         * Context is alive returns its caches automatically.
          */
-        ~Context();
+        ~BasicContext();
 
         // Non-copyable, non-movable (owns OS resources)
-        Context(const Context &) = delete;
-        Context &operator=(const Context &) = delete;
-        Context(Context &&) = delete;
-        Context &operator=(Context &&) = delete;
+        BasicContext(const BasicContext &) = delete;
+        BasicContext &operator=(const BasicContext &) = delete;
+        BasicContext(BasicContext &&) = delete;
+        BasicContext &operator=(BasicContext &&) = delete;
 
         // =====================================================================
         // Sub-Cell Allocation API (preferred for most allocations)
@@ -94,19 +160,39 @@ namespace Cell {
          *
          * Alignment guarantees:
          * - Sub-cell/cell allocations: Naturally aligned to 16 bytes (cell alignment)
-         * - Buddy allocations: 8-byte alignment (due to internal header)
-         * - For alignments > 16 bytes, use alloc_aligned() instead
+         * - Buddy allocations: 16-byte alignment (BuddyAllocator::kHeaderSize)
+         * - Alignments > 16 bytes pick a power-of-2 size class, whose blocks are
+         *   aligned to their size; requests that do not fit one fail
          *
          * @param size Size in bytes to allocate.
          * @param tag Application-defined tag for profiling (default: 0).
-         * @param alignment Required alignment (default: 8, must be power of 2, max 16).
+         * @param alignment Required alignment (default: 8, must be power of 2). Above 16,
+         *        align_up(size, alignment) must not exceed kMaxSubCellSize.
          * @return Pointer to allocated memory, or nullptr on failure.
          *
-         * @note The alignment parameter only affects size class selection for sub-cell.
-         *       For guaranteed large alignments (>16), use alloc_aligned().
+         * @note For any size with a large alignment, use alloc_aligned().
          */
         [[nodiscard]] void *alloc_bytes(size_t size, uint8_t tag = 0, size_t alignment = 8);
 
+        /**
+         * @brief Allocates at least size bytes and reports how many the block really has.
+         *
+         * Same routing as alloc_bytes(); the reported size is usable_size() of the block:
+         * its size class, the rest of the cell, the buddy block minus its header, or for
+         * the large tier the request rounded up to whole pages. Growable buffers can use
+         * the slack instead of reallocating early. Any size from the requested one up to
+         * the reported one may be passed to free_sized() and realloc_bytes() keeps the
+         * block while the new size still fits it. Blocks given guard bytes
+         * (CELL_DEBUG_GUARDS) report the requested size, as the back guard follows it.
+         *
+         * @param size Minimum size in bytes.
+         * @param tag Application-defined tag for profiling (default: 0).
+         * @param alignment Required alignment, as for alloc_bytes().
+         * @return The block and its usable size, or {nullptr, 0} on failure.
+         */
+        [[nodiscard]] AllocationResult alloc_at_least(size_t size, uint8_t tag = 0,
+                                                      size_t alignment = 8);
+
         /**
          * @brief Frees memory allocated by alloc_bytes().
          *
@@ -114,6 +200,33 @@ namespace Cell {
          */
         void free_bytes(void *ptr);
 
+        /**
+         * @brief Frees memory whose allocation size the caller knows.
+         *
+         * Routes by size instead of by address: sub-cell sizes go straight to their
+         * bin's TLS cache, and blocks over 2MB skip the large-tier ownership probe.
+         * The size is checked against where the block actually lives, so a stale size
+         * (e.g. after realloc_bytes()) only costs a fall back to free_bytes().
+         * Debug, budget and instrumentation builds always take the free_bytes() path.
+         *
+         * @param ptr Pointer to memory to free.
+         * @param size Size passed to the call that allocated ptr.
+         */
+        void free_sized(void *ptr, size_t size);
+
+        /**
+         * @brief Frees memory from alloc_aligned() or an aligned alloc_bytes() call.
+         *
+         * Alignments above 16 select the power-of-2 size class the block was served
+         * from, or for sizes beyond the size classes the large tier, which is freed
+         * without an ownership probe; smaller ones behave like free_sized().
+         *
+         * @param ptr Pointer to memory to free.
+         * @param size Size passed to the call that allocated ptr.
+         * @param alignment Alignment passed to the call that allocated ptr.
+         */
+        void free_aligned_sized(void *ptr, size_t size, size_t alignment);
+
         /**
          * @brief Reallocates memory to a new size.
          *
@@ -121,6 +234,8 @@ namespace Cell {
          * - If ptr is nullptr, behaves like alloc_bytes(new_size, tag)
          * - If new_size is 0, behaves like free_bytes(ptr)
          * - Data preserved up to min(old_size, new_size)
+         * - If new_size still fits the block's size class, cell or buddy order (see
+         *   usable_size()), returns ptr without touching any allocator state
          * - On failure, returns nullptr and old block is unchanged
          *
          * @param ptr Pointer from previous alloc_bytes/realloc_bytes
@@ -161,7 +276,9 @@ namespace Cell {
          * @brief Allocates multiple blocks of the same size.
          *
          * Optimized for batch workloads using SIMD operations when available.
-         * All blocks will be from the same size class.
+         * All blocks will be from the same size class. Once the TLS cache is empty,
+         * each whole cell's worth still wanted is carved from a fresh cell, so those
+         * blocks come back in address order.
          *
          * @param size Size of each block in bytes.
          * @param out_ptrs Output array to receive allocated pointers.
@@ -172,12 +289,28 @@ namespace Cell {
         [[nodiscard]] size_t alloc_batch(size_t size, void **out_ptrs, size_t count,
                                          uint8_t tag = 0);
 
+        /**
+         * @brief Allocates count blocks of one size class back to back in a fresh cell.
+         *
+         * Block i starts at result + i * kSizeClasses[get_size_class_fast(size)], so a
+         * size that is itself a size class yields a dense array. Each block is still an
+         * ordinary allocation, freed on its own with free_bytes() or free_batch().
+         *
+         * @param size Size of each block (at most kMaxSubCellSize).
+         * @param count Number of blocks; at most blocks_per_cell() of the size class.
+         * @param tag Application-defined tag for profiling.
+         * @return Pointer to the first block, or nullptr if the request does not fit in
+         *         one cell or no cell is available.
+         */
+        [[nodiscard]] void *alloc_contiguous(size_t size, size_t count, uint8_t tag = 0);
+
         /**
          * @brief Frees multiple blocks at once.
          *
-         * Optimized for batch workloads. All blocks must be valid allocations.
-         * All pointers must belong to the sub-cell/cell tier and share the same
-         * size class; mixed tiers or sizes are not supported by this API.
+         * The pointers may come from any mix of tiers and sizes; null entries are
+         * skipped. Sub-cell blocks fill the TLS caches first and the rest go back to
+         * their cells under one bin lock per size class. Buddy blocks are returned
+         * under one buddy lock per kFreeBatchBuddyChunk blocks.
          *
          * @param ptrs Array of pointers to free.
          * @param count Number of pointers in the array.
@@ -202,19 +335,35 @@ namespace Cell {
          */
         [[nodiscard]] void *alloc_large(size_t size, uint8_t tag = 0, bool try_huge_pages = true);
 
+        /**
+         * @brief Allocates a direct OS block that can grow in place up to reserve_size.
+         *
+         * Reserves reserve_size bytes of address space but commits only size bytes.
+         * realloc_bytes() within the reservation commits more pages without moving
+         * or copying, which suits buffers that grow from a few MB to hundreds of MB.
+         * Always uses the direct OS tier, whatever the size.
+         *
+         * @param size Initial size in bytes.
+         * @param reserve_size Address space to reserve for growth.
+         * @param tag Application-defined tag for profiling.
+         * @return Pointer to allocated memory, or nullptr on failure.
+         */
+        [[nodiscard]] void *alloc_reserved(size_t size, size_t reserve_size, uint8_t tag = 0);
+
         /**
          * @brief Frees a large allocation.
          *
-         * @param ptr Pointer returned by alloc_large().
+         * @param ptr Pointer returned by alloc_large() or alloc_reserved().
          */
         void free_large(void *ptr);
 
         /**
-         * @brief Allocates memory with explicit alignment (buddy/large only).
+         * @brief Allocates memory with explicit alignment.
          *
-         * For sizes that fit in sub-cell/cell range, use regular alloc() which
-         * provides natural 16-byte alignment. This API is for cases requiring
-         * higher alignment (e.g., SIMD, cache lines, page boundaries).
+         * Sizes that round up to at most kMaxSubCellSize at the alignment come
+         * from the size classes like alloc_bytes(), so cache-line or page-aligned
+         * small blocks cost no more than default-aligned ones. Anything larger
+         * goes to the buddy or large tier (e.g., SIMD buffers, page boundaries).
          *
          * @param size Size in bytes.
          * @param alignment Required alignment (must be power of 2).
@@ -232,15 +381,41 @@ namespace Cell {
         /**
          * @brief Flush all thread-local caches (both cell-level and bin-level) to global pools.
          *
-         * Worker threads should call this before exiting to return cached allocations
-         * to the global pool, preventing resource leaks. This flushes both t_cache
-         * (cell-level) and t_bin_cache (sub-cell bins).
+         * Flushes the cell-level, sub-cell bin and buddy block caches of the calling
+         * thread's slot for this Context, and drains and releases the thread's remote
+         * free queue. The same happens automatically when the thread exits, so this is
+         * only needed to hand memory back early (e.g. before a thread goes idle).
          *
-         * Note: This prevents resource leaks but does NOT prevent crashes. Threads must
-         * still be properly joined before Context destruction.
+         * Note: Threads must still be properly joined before Context destruction.
          */
         void flush_tls_caches();
 
+        /**
+         * @brief Returns the caches of threads that have stopped allocating.
+         *
+         * A thread counts as idle when it has made no call into this Context since
+         * the previous reclaim pass and that pass was at least idle_ms ago, so
+         * calling this periodically reclaims threads idle for one to two periods.
+         * Each thread is reclaimed once per idle stretch; a thread that is inside
+         * an allocator call is skipped. Reclaimed threads keep working and simply
+         * refill their caches on their next call.
+         *
+         * @param idle_ms Minimum time without allocator calls.
+         * @return Number of threads whose caches were released.
+         */
+        size_t reclaim_idle_tls_caches(uint32_t idle_ms);
+
+        /**
+         * @brief Returns the calling thread's current TLS cache capacity for a size bin.
+         *
+         * Capacities adapt at runtime (see Config::tls_bin_cache_bytes); this lets the
+         * adaptation be watched from the thread that allocates.
+         *
+         * @param bin_index Size class index (< kNumSizeBins).
+         * @return Capacity in blocks, or 0 if the thread has no cache for this Context.
+         */
+        [[nodiscard]] size_t tls_bin_capacity(size_t bin_index) const;
+
         // =====================================================================
         // Cell-Level Allocation API (for 16KB blocks or internal use)
         // =====================================================================
@@ -258,6 +433,32 @@ namespace Cell {
          */
         void free_cell(CellData *cell);
 
+        // =====================================================================
+        // Tag Heaps (Config::tag_heaps)
+        // =====================================================================
+
+        /**
+         * @brief Frees every allocation of a segregated tag at once.
+         *
+         * Returns all cells of the tag's heap to the cell pool in one pass over the
+         * cells, without visiting the blocks in them. Every sub-cell and full-cell
+         * allocation made with the tag becomes invalid and must not be freed again;
+         * its buddy and large allocations are not affected. The cells go back like
+         * any freed cell, so decommit_unused() can release the superblocks they leave
+         * fully free.
+         *
+         * No other thread may use the tag during the call. The frees are not traced
+         * and not reported to the allocation callback.
+         *
+         * @return Number of cells released, or 0 if tag is not in Config::tag_heaps.
+         */
+        size_t release_tag(uint8_t tag);
+
+        /**
+         * @brief Checks whether a tag has bins and cells of its own (Config::tag_heaps).
+         */
+        [[nodiscard]] bool has_tag_heap(uint8_t tag) const { return tag_heap(tag) != nullptr; }
+
         // =====================================================================
         // Memory Management API
         // =====================================================================
@@ -267,16 +468,96 @@ namespace Cell {
          *
          * Call during loading screens, pause menus, or other idle periods
          * to release physical memory while keeping virtual address space.
+         * Covers free cell superblocks and wholly free 2MB buddy blocks, which are
+         * recommitted on reuse, and unmaps large (>2MB) mappings held in the reuse cache.
+         * With HugePagePolicy::kNone the free cells of partly used superblocks found on
+         * the shared pool or the calling thread's cache are released one by one as well.
          *
          * @return Number of bytes released to the OS.
          */
         size_t decommit_unused();
 
+        /**
+         * @brief Incrementally releases memory that has been unused for Config::decay_ms.
+         *
+         * A bounded step meant to be called periodically (or run by the background
+         * scavenger): it inspects a window of superblocks, releases the ones that have
+         * stayed fully free past the decay time (lazily via MADV_FREE where available),
+         * and stops once budget_ns has elapsed. Unlike decommit_unused(), memory that
+         * was freed recently stays committed for reuse. Safe to call from any thread.
+         *
+         * @param budget_ns Time budget for this step.
+         * @return Number of bytes released to the OS.
+         */
+        size_t scavenge(uint64_t budget_ns = kBackgroundScavengeBudgetNs);
+
+        /**
+         * @brief Commits and sets up memory ahead of use, so that the first allocations
+         *        take neither page faults nor the refill paths.
+         *
+         * Meant for startup or failover of latency-sensitive services; Config::prewarm
+         * runs it from the constructor. The superblocks stay committed until their cells
+         * have been used (decommit_unused() may purge free cells of them). Cells for
+         * spec.sizes go to the shared bins, so tag heaps are not prewarmed, and the
+         * buddy and large tiers are left as they are.
+         *
+         * @param spec What to ready; see PrewarmSpec.
+         * @return Number of bytes of superblocks committed.
+         */
+        size_t prewarm(const PrewarmSpec &spec);
+
         /**
          * @brief Returns currently committed physical memory.
+         *
+         * Sum of committed cell superblocks, resident buddy superblocks, and large
+         * blocks (live plus cached for reuse).
          */
         [[nodiscard]] size_t committed_bytes() const;
 
+        // =====================================================================
+        // Introspection
+        // =====================================================================
+
+        /**
+         * @brief Checks whether a pointer was allocated by this Context (any tier).
+         *
+         * Lock-free: range checks for cells and buddy blocks plus a lookup in the large
+         * block table. Meant for routing pointers of unknown origin, e.g. in malloc
+         * interposition.
+         */
+        [[nodiscard]] bool owns(void *ptr) const;
+
+        /**
+         * @brief Checks whether a pointer lies in the cell region (sub-cell blocks and cells).
+         *
+         * A plain range check; get_header() may be used on any pointer it accepts.
+         */
+        [[nodiscard]] bool in_cell_region(const void *ptr) const {
+            auto uptr = reinterpret_cast<uintptr_t>(ptr);
+            auto base = reinterpret_cast<uintptr_t>(m_base);
+            return uptr >= base && uptr < base + m_reserved_size;
+        }
+
+        /**
+         * @brief Returns how many bytes starting at ptr the caller may use.
+         *
+         * At least the requested size: the size-class block, cell or buddy block minus
+         * what precedes ptr, or the large block's size. With guard bytes and leak
+         * tracking enabled, this is the requested size (the back guard follows it).
+         *
+         * @param ptr Pointer owned by this Context, or nullptr (returns 0).
+         */
+        [[nodiscard]] size_t usable_size(void *ptr) const;
+
+        /**
+         * @brief Reports bin fragmentation, cached blocks and per-tier occupancy.
+         *
+         * Cheap enough to scrape from a running process: each bin lock and the buddy
+         * lock are held only while their lists are walked, one at a time. Does not
+         * require CELL_ENABLE_STATS.
+         */
+        [[nodiscard]] HeapSnapshot snapshot() const;
+
         // =====================================================================
         // Statistics (compile-time optional via CELL_ENABLE_STATS)
         // =====================================================================
@@ -284,18 +565,24 @@ namespace Cell {
 #ifdef CELL_ENABLE_STATS
         /**
          * @brief Returns current memory statistics.
+         *
+         * Sums the per-thread counters into a snapshot owned by the Context; the
+         * reference stays valid, but only a later call refreshes it.
          */
-        [[nodiscard]] const MemoryStats &get_stats() const { return m_stats; }
+        [[nodiscard]] const MemoryStats &get_stats() const;
 
         /**
          * @brief Prints memory statistics to stdout.
          */
-        void dump_stats() const { m_stats.dump(); }
+        void dump_stats() const { get_stats().dump(); }
 
         /**
          * @brief Resets all statistics counters.
+         *
+         * Later snapshots count from here; current_allocated and per-tag bytes start
+         * at zero even though earlier blocks are still live.
          */
-        void reset_stats() { m_stats.reset(); }
+        void reset_stats();
 #endif
 
         // =====================================================================
@@ -305,6 +592,11 @@ namespace Cell {
 #ifdef CELL_ENABLE_BUDGET
         /**
          * @brief Sets the memory budget for this context.
+         *
+         * Sub-cell allocations are charged to a per-thread lease taken from the
+         * budget kBudgetLeaseBytes at a time, so the limit is never exceeded, but an
+         * allocation may be refused while other threads still hold up to
+         * kBudgetLeaseMaxBytes each of unspent lease.
          * @param bytes Maximum bytes to allow. 0 = unlimited.
          */
         void set_budget(size_t bytes) { m_budget = bytes; }
@@ -316,11 +608,10 @@ namespace Cell {
 
         /**
          * @brief Returns current memory usage tracked against budget.
-         * This is the actual allocated size (rounded to size classes).
+         * This is the actual allocated size (rounded to size classes); unspent
+         * thread leases are not counted.
          */
-        [[nodiscard]] size_t get_budget_current() const {
-            return m_budget_current.load(std::memory_order_relaxed);
-        }
+        [[nodiscard]] size_t get_budget_current() const;
 
         /**
          * @brief Sets a callback for when allocations exceed budget.
@@ -345,6 +636,70 @@ namespace Cell {
         [[nodiscard]] AllocationCallback get_alloc_callback() const { return m_alloc_callback; }
 #endif
 
+        // =====================================================================
+        // Event Tracing (compile-time optional via CELL_ENABLE_TRACE)
+        // =====================================================================
+
+#ifdef CELL_ENABLE_TRACE
+        /**
+         * @brief Starts or stops recording allocation events.
+         *
+         * While on, every alloc and free writes a TraceEvent to the calling thread's
+         * ring, including on the TLS fast paths, which tracing leaves compiled as
+         * they are. While off, each operation pays one relaxed load. Cell-level
+         * alloc_cell() / free_cell() are not traced.
+         */
+        void set_tracing(bool enabled) { m_tracing.store(enabled, std::memory_order_relaxed); }
+
+        /**
+         * @brief Returns whether allocation events are being recorded.
+         */
+        [[nodiscard]] bool is_tracing() const { return m_tracing.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Moves recorded events out of every thread's ring.
+         *
+         * Meant for one consumer thread (see TraceWriter); concurrent callers are
+         * serialized. Each thread's events come out in order; threads are visited
+         * round-robin so a small buffer does not starve any of them.
+         *
+         * @param out Buffer to fill.
+         * @param capacity Number of events out can hold.
+         * @return Number of events written to out.
+         */
+        size_t drain_trace(TraceEvent *out, size_t capacity);
+
+        /**
+         * @brief Returns the number of events lost so far.
+         *
+         * Counts events that found their thread's ring full and those of threads
+         * that could not get a ring (no TLS slot, or out of memory).
+         */
+        [[nodiscard]] uint64_t trace_dropped() const;
+#endif
+
+        // =====================================================================
+        // Heap Profile (compile-time optional via CELL_ENABLE_HEAP_PROFILE)
+        // =====================================================================
+
+#ifdef CELL_ENABLE_HEAP_PROFILE
+        /**
+         * @brief Writes the sampled live heap, by allocating call stack, as a pprof
+         *        heap profile (`pprof -inuse_space ./binary heap.prof`).
+         *
+         * Each thread samples about one allocation per Config::heap_profile_sample_bytes
+         * it allocates, on every path alloc_bytes() and the allocations traced by
+         * CELL_ENABLE_TRACE take, and captures a stack only for those. pprof scales
+         * the samples back up to estimated totals. Threads without a TLS slot and
+         * alloc_cell() are not sampled, and samples of blocks freed by release_tag()
+         * stay in the profile until their memory is sampled again.
+         *
+         * @param out Stream to write the text profile to.
+         * @return false if sampling is off or writing failed.
+         */
+        bool dump_heap_profile(std::FILE *out) const;
+#endif
+
         // =====================================================================
         // Debug Features (compile-time optional)
         // =====================================================================
@@ -374,6 +729,14 @@ namespace Cell {
 #endif
 
     private:
+        // Thread and heap state sized by Policy; the names hide the policy-independent
+        // bases (RemoteFreeQueue, TlsSlot) for the rest of the class
+        using Allocator = BasicAllocator<Policy>;
+        using TlsSlot = BasicTlsSlot<Policy>;
+        using TlsBinCache = Cell::TlsBinCache<Policy>;
+        using RemoteFreeQueue = BasicRemoteFreeQueue<Policy>;
+        using TagHeap = Cell::TagHeap<Policy>;
+
         // =====================================================================
         // Sub-Cell Implementation
         // =====================================================================
@@ -386,8 +749,26 @@ namespace Cell {
          */
         void *alloc_from_bin(size_t bin_index, uint8_t tag);
 
+        /**
+         * @brief Takes a block from the first cell of a bin's partial list.
+         *
+         * Caller holds the bin's lock and has made sure the list is not empty; a cell
+         * that runs out of blocks leaves the list.
+         */
+        FreeBlock *take_partial_block(SizeBin &bin);
+
+        /**
+         * @brief Locks m_bin_locks[bin_index] for the enclosing scope.
+         *
+         * With CELL_ENABLE_LATENCY_PROFILE the wait is recorded as LatencyPath::kBinLock
+         * for a thread with a slot.
+         */
+        std::unique_lock<std::mutex> lock_bin(size_t bin_index);
+
         /**
          * @brief Frees a block back to its size class bin.
+         *
+         * Blocks of tag heap cells go to free_to_tag_heap() instead.
          * @param ptr Pointer to the block.
          * @param header Cell header containing the block.
          */
@@ -398,15 +779,370 @@ namespace Cell {
          * @param cell Raw cell memory.
          * @param bin_index Size class to prepare for.
          * @param tag Tag for profiling.
+         * @param handed_out Leading blocks to leave off the free list (already allocated).
+         */
+        void init_cell_for_bin(void *cell, size_t bin_index, uint8_t tag, size_t handed_out = 0);
+
+        /**
+         * @brief Takes a fresh cell for a size class with its first count blocks allocated.
+         *
+         * The rest of the cell, if any, goes on the partial list of the bin, or of the
+         * tag's heap if it has one.
+         * @return The first block, or nullptr if no cell is available.
          */
-        void init_cell_for_bin(void *cell, size_t bin_index, uint8_t tag);
+        void *carve_cell(size_t bin_index, size_t count, uint8_t tag);
 
         /**
-         * @brief Batch refills TLS cache from global bin.
+         * @brief Fills out_ptrs with the blocks of whole fresh cells while count allows.
+         * @return Number of blocks written (a multiple of blocks_per_cell()).
+         */
+        size_t carve_cells(size_t bin_index, void **out_ptrs, size_t count, uint8_t tag);
+
+        /**
+         * @brief Frees a sub-cell block into the calling thread's TLS cache or its owner's
+         *        remote queue.
+         * @param slot The calling thread's slot from tls_slot(), or nullptr.
+         * @return false if neither applies (no slot, or the cache is full).
+         */
+        bool free_to_tls(TlsSlot *slot, void *ptr, CellHeader *header, size_t bin_index);
+
+        /**
+         * @brief free_bytes() for a sub-cell block, past tracing and the TLS cache.
+         *
+         * Settles stats and budget, then hands the block to free_to_bin().
+         */
+        void free_subcell(void *ptr, CellHeader *header);
+
+        /**
+         * @brief Frees a block as a large allocation if it is in neither the cell nor buddy range.
+         * @param in_cells Whether ptr lies in the cell region (already computed by the caller).
+         * @return false if the block belongs to the cell or buddy tier.
+         */
+        bool free_large_direct(void *ptr, bool in_cells);
+
+        /**
+         * @brief Key FreeBlock links of this Context are encoded with (0 unless CELL_HARDENED).
+         */
+        uintptr_t free_list_key() const {
+#ifdef CELL_HARDENED
+            return m_free_list_key;
+#else
+            return 0;
+#endif
+        }
+
+        /**
+         * @brief Follows a FreeBlock link. CELL_HARDENED builds abort if the block was
+         *        written after it was freed or the link leaves the cell region.
+         */
+        FreeBlock *next_free(const FreeBlock *block) const;
+
+#ifdef CELL_HARDENED
+        /**
+         * @brief Unseals a sub-cell block as it is handed out, so freeing it is not
+         *        mistaken for a double free.
+         */
+        void hardened_claim(void *block);
+
+        /**
+         * @brief Validates a sub-cell block being freed.
+         *
+         * Aborts on a pointer that is not the start of a block of the cell, and on a
+         * block that is still sealed from its last free (a double free).
+         */
+        void hardened_release(void *ptr, CellHeader *header, size_t bin_index);
+
+        /**
+         * @brief Aborts if a free block was written to since it was freed.
+         */
+        void hardened_check_freed(const FreeBlock *block) const;
+#endif
+
+        /**
+         * @brief Returns the calling thread's TLS slot for this Context, binding it if needed.
+         * @return The slot, or nullptr if this Context has no slot (runs uncached).
+         */
+        TlsSlot *tls_slot();
+
+        /**
+         * @brief Batch refills TLS cache from the remote free queue, the thread's owned
+         *        cell, then cells adopted from the global bin.
+         * @param slot The calling thread's slot for this Context.
          * @param bin_index Size class index (must be < kTlsBinCacheCount).
          * @param tag Tag for profiling (used if new cell is needed).
          */
-        void batch_refill_tls_bin(size_t bin_index, uint8_t tag);
+        void batch_refill_tls_bin(TlsSlot &slot, size_t bin_index, uint8_t tag);
+
+        /**
+         * @brief Returns a block to its cell's free list.
+         *
+         * Caller must hold m_bin_locks[bin_index]. A block whose cell another thread
+         * owns exclusively is pushed to that thread's remote queue instead.
+         *
+         * @param bin_index Size class of the block.
+         * @param header Header of the cell containing the block.
+         * @param block Block to return.
+         */
+        void release_block_to_cell(size_t bin_index, CellHeader *header, FreeBlock *block);
+
+        /**
+         * @brief Puts a block back on its cell's free list and the cell on bin's partial
+         *        list, or keeps the cell warm once every block in it is free.
+         *
+         * Caller holds the bin's lock.
+         * @return true if the cell is empty and was taken off bin; the caller frees it.
+         */
+        bool return_block_to_bin(SizeBin &bin, size_t bin_index, CellHeader *header,
+                                 FreeBlock *block);
+
+        /**
+         * @brief Takes a partial or fresh cell off the bin for one thread's exclusive use.
+         *
+         * Caller must hold m_bin_locks[bin_index].
+         *
+         * @param bin_index Size class index.
+         * @param tag Tag for profiling (used if a fresh cell is needed).
+         * @param queue Remote queue of the adopting thread; frees from other threads go there.
+         * @return The adopted cell, or nullptr if no cell is available.
+         */
+        CellHeader *adopt_cell(size_t bin_index, uint8_t tag, RemoteFreeQueue *queue);
+
+        /**
+         * @brief Ends a thread's exclusive use of a cell and hands it back to the bin.
+         *
+         * Caller must hold m_bin_locks[bin_index].
+         */
+        void retire_owned_cell(size_t bin_index, CellHeader *header);
+
+        /**
+         * @brief Moves up to count blocks from the cache's owned cell into the cache (no lock).
+         * @return Number of blocks moved.
+         */
+        static size_t take_owned_blocks(TlsBinCache &cache, size_t count, uintptr_t key);
+
+        /**
+         * @brief Doubles a TLS bin cache's capacity after a miss, within the thread's ceiling.
+         */
+        void grow_tls_bin(TlsSlot &slot, size_t bin_index);
+
+        /**
+         * @brief Spills the coldest blocks of a full TLS bin cache, down to half its capacity.
+         *
+         * Repeated overflows with no miss in between halve the capacity first.
+         */
+        void spill_tls_bin(TlsSlot &slot, size_t bin_index);
+
+        /**
+         * @brief Returns a list of blocks freed by the calling thread to their cells.
+         *
+         * Blocks from the thread's owned cell go back without the lock; the rest are
+         * released under one acquisition of m_bin_locks[bin_index].
+         *
+         * @param slot The calling thread's slot for this Context.
+         * @param bin_index Size class of every block in the list.
+         * @param list Blocks linked through FreeBlock::set_next().
+         */
+        void return_blocks_to_cells(TlsSlot &slot, size_t bin_index, FreeBlock *list);
+
+        // =====================================================================
+        // Tag Heaps
+        // =====================================================================
+
+        /**
+         * @brief The tag's heap if Config::tag_heaps segregates it, else nullptr.
+         */
+        TagHeap *tag_heap(uint8_t tag) const {
+            return CELL_UNLIKELY(tag != 0) ? m_tag_heaps[tag].get() : nullptr;
+        }
+
+        /**
+         * @brief Allocates a block of a size class from a tag heap, under its lock.
+         */
+        void *alloc_from_tag_heap(TagHeap &heap, size_t bin_index);
+
+        /**
+         * @brief Returns a block of a tag heap cell to its cell, under the heap's lock.
+         *
+         * Poisoning and hardening checks are the caller's.
+         */
+        void free_to_tag_heap(void *ptr, CellHeader *header);
+
+        /**
+         * @brief alloc_cell() for a full-cell allocation, listed in the tag's heap if any.
+         */
+        CellData *alloc_full_cell(uint8_t tag);
+
+        /**
+         * @brief Frees a full-cell allocation made by alloc_full_cell().
+         */
+        void free_full_cell(CellHeader *header);
+
+        // =====================================================================
+        // Buddy TLS Cache (32KB - 256KB blocks)
+        // =====================================================================
+
+        /**
+         * @brief Allocates a buddy block, using the thread's per-order cache when possible.
+         *
+         * Cache misses refill kTlsBuddyBatchRefill blocks under one buddy lock.
+         */
+        void *alloc_buddy(size_t size);
+
+        /**
+         * @brief Frees a buddy block into the thread's per-order cache when possible.
+         *
+         * A full cache spills its kTlsBuddyBatchRefill coldest blocks under one lock.
+         */
+        void free_buddy(void *ptr);
+
+        // =====================================================================
+        // Remote Free Queues (cross-thread sub-cell frees)
+        // =====================================================================
+
+        /**
+         * @brief Returns the calling thread's remote free queue, claiming one if needed.
+         */
+        RemoteFreeQueue *acquire_remote_queue(TlsSlot &slot);
+
+        /**
+         * @brief Moves blocks other threads freed to the caller into its TLS cache.
+         *
+         * Blocks that do not fit are returned with return_blocks_to_cells().
+         *
+         * @param slot The calling thread's slot; its remote queue must be claimed.
+         * @param bin_index Size class index (must be < kTlsBinCacheCount).
+         * @return true if any block was drained.
+         */
+        bool drain_remote_frees(TlsSlot &slot, size_t bin_index);
+
+        /**
+         * @brief Drains the calling thread's queue to the global bins and releases it.
+         *
+         * A released queue is handed to the next thread that registers, which drains
+         * any blocks that arrive in the meantime.
+         */
+        void release_remote_queue(TlsSlot &slot);
+
+        /**
+         * @brief Returns everything cached in a slot bound to this Context.
+         *
+         * The slot's thread must be the caller, have exited, or be held off by the
+         * reclaim handshake in tls_slots.h.
+         */
+        void release_tls_slot(TlsSlot &slot);
+
+        /** @brief TlsSlotReleaseFn that forwards to release_tls_slot(). */
+        static void release_slot_caches(void *context, Cell::TlsSlot &slot);
+
+#if defined(CELL_ENABLE_STATS) || defined(CELL_ENABLE_TRACE) ||                                   \
+    defined(CELL_ENABLE_LATENCY_PROFILE)
+        /**
+         * @brief TlsSlotRetireFn that folds an exiting thread's statistics and latency
+         *        shards into the Context's and hands its trace ring to the next thread.
+         */
+        static void retire_slot(void *context, Cell::TlsSlot &slot);
+#endif
+
+#ifdef CELL_ENABLE_STATS
+        // =====================================================================
+        // Statistics Recording
+        // =====================================================================
+
+        /**
+         * @brief Counts count allocations of size bytes in the calling thread's shard.
+         * @param tier Per-allocator counter to bump by count.
+         */
+        void stats_record_alloc(size_t size, uint8_t tag, StatsShard::Counter tier,
+                                size_t count = 1);
+
+        /**
+         * @brief Counts count frees of size bytes in the calling thread's shard.
+         */
+        void stats_record_free(size_t size, uint8_t tag, StatsShard::Counter tier,
+                               size_t count = 1);
+
+        /**
+         * @brief Adds n to a per-allocator counter in the calling thread's shard.
+         */
+        void stats_count(StatsShard::Counter counter, size_t n);
+
+        /**
+         * @brief Publishes net bytes for peak tracking and raises the peak if needed.
+         */
+        void stats_publish(int64_t delta);
+
+        /**
+         * @brief Sums m_shared_stats and every bound thread's shard.
+         */
+        StatsTotals collect_stats() const;
+#endif
+
+#ifdef CELL_ENABLE_TRACE
+        // =====================================================================
+        // Event Tracing
+        // =====================================================================
+
+        /**
+         * @brief Writes one event to the calling thread's ring if tracing is on.
+         */
+        void trace_event(TraceKind kind, const void *ptr, size_t size, uint8_t tag,
+                         TraceTier tier);
+
+        /**
+         * @brief Out-of-line body of trace_event(), so the off check is all that is inlined.
+         */
+        void trace_record(TraceKind kind, const void *ptr, size_t size, uint8_t tag,
+                          TraceTier tier);
+
+        /**
+         * @brief trace_event() for a free, working out tier, block size and tag from ptr.
+         *
+         * Must run before the block is released: large blocks are looked up by address.
+         */
+        void trace_free(const void *ptr);
+
+        /**
+         * @brief Traces a tier's own realloc: kRealloc if it stayed in place, else the
+         *        free of old_ptr and the allocation of new_ptr. Nothing if it failed.
+         */
+        void trace_realloc(const void *old_ptr, size_t old_block_size, const void *new_ptr,
+                           size_t new_size, uint8_t tag, TraceTier tier);
+
+        /**
+         * @brief Returns the tier serving ptr, with its block size and tag.
+         */
+        TraceTier trace_locate(const void *ptr, size_t &block_size, uint8_t &tag) const;
+
+        /**
+         * @brief Claims a ring for the calling thread (slow path of trace_event()).
+         * @return The ring, or nullptr if none can be mapped.
+         */
+        TraceRing *acquire_trace_ring(TlsSlot &slot);
+#endif
+
+#ifdef CELL_ENABLE_HEAP_PROFILE
+        // =====================================================================
+        // Heap Profile
+        // =====================================================================
+
+        /**
+         * @brief Counts a new allocation against the calling thread's sampling
+         *        countdown, and samples it when the countdown runs out.
+         * @param slot The calling thread's slot, or nullptr (not sampled).
+         */
+        void heap_profile_alloc(TlsSlot *slot, const void *ptr, size_t size);
+
+        /**
+         * @brief Out-of-line body of heap_profile_alloc(): draws the next countdown
+         *        and records the sample with its call stack.
+         */
+        void heap_profile_sample(TlsSlot &slot, const void *ptr, size_t size);
+
+        /**
+         * @brief Drops ptr's sample if it has one. Must run before the block is released.
+         */
+        void heap_profile_free(const void *ptr);
+#endif
 
         // =====================================================================
         // Members
@@ -416,8 +1152,19 @@ namespace Cell {
         size_t m_reserved_size = 0;             ///< Total reserved bytes.
         std::unique_ptr<Allocator> m_allocator; ///< Cell-level allocator.
 
-        SizeBin m_bins[kNumSizeBins];         ///< Size class bins.
-        std::mutex m_bin_locks[kNumSizeBins]; ///< Per-bin locks.
+        uint64_t m_id = 0;   ///< Unique id (never reused), validates thread-local state.
+        uint32_t m_tls_slot; ///< Thread-local slot index, or kNoTlsSlot if none was free.
+#ifdef CELL_HARDENED
+        uintptr_t m_free_list_key = 0; ///< Random per Context; see FreeBlock.
+#endif
+
+        SizeBin m_bins[kNumSizeBins];                 ///< Size class bins.
+        mutable std::mutex m_bin_locks[kNumSizeBins]; ///< Per-bin locks.
+
+        std::unique_ptr<TagHeap> m_tag_heaps[256]; ///< Config::tag_heaps, indexed by tag.
+
+        RemoteFreeQueue *m_remote_queues = nullptr; ///< All queues created for this Context.
+        std::mutex m_remote_mutex;                  ///< Protects queue registration.
 
         // Buddy allocator for 32KB - 2MB
         void *m_buddy_base = nullptr;     ///< Start of buddy region.
@@ -427,8 +1174,35 @@ namespace Cell {
         // Large allocation registry for > 2MB
         LargeAllocRegistry m_large_allocs;
 
+        uint32_t m_decay_ms = 0;                ///< Config::decay_ms.
+        size_t m_tls_bin_cache_bytes = 0;       ///< Config::tls_bin_cache_bytes.
+        std::unique_ptr<Scavenger> m_scavenger; ///< Background scavenger, if enabled.
+
 #ifdef CELL_ENABLE_STATS
-        mutable MemoryStats m_stats;
+        mutable MemoryStats m_stats;                 ///< Snapshot filled by get_stats().
+        mutable std::mutex m_stats_mutex;            ///< Serializes get_stats(), reset_stats().
+        StatsShard m_shared_stats;                   ///< Threads without a slot; exited ones.
+        std::atomic<int64_t> m_stats_flushed{0};     ///< Net bytes published by all shards.
+        mutable std::atomic<size_t> m_stats_peak{0}; ///< Highest published net bytes.
+        StatsTotals m_stats_baseline;                ///< Totals at the last reset_stats().
+#endif
+
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+        LatencyShard m_retired_latency; ///< Latencies of exited threads.
+#endif
+
+#ifdef CELL_ENABLE_TRACE
+        std::atomic<bool> m_tracing{false};          ///< set_tracing().
+        TraceRing *m_trace_rings = nullptr;          ///< All rings created for this Context.
+        mutable std::mutex m_trace_mutex;            ///< Protects ring registration.
+        std::mutex m_trace_drain_mutex;              ///< Serializes drain_trace().
+        TraceRing *m_trace_drain_next = nullptr;     ///< First ring of the next drain.
+        uint32_t m_trace_threads = 0;                ///< Rings claimed so far (m_trace_mutex).
+        std::atomic<uint64_t> m_trace_unrecorded{0}; ///< Events of threads without a ring.
+#endif
+
+#ifdef CELL_ENABLE_HEAP_PROFILE
+        std::unique_ptr<HeapProfiler> m_heap_profiler; ///< Null while sampling is off.
 #endif
 
 #ifdef CELL_DEBUG_LEAKS
@@ -438,12 +1212,56 @@ namespace Cell {
 
 #ifdef CELL_ENABLE_BUDGET
         size_t m_budget = 0;
-        std::atomic<size_t> m_budget_current{0};
+        std::atomic<size_t> m_budget_current{0}; ///< Allocated bytes plus unspent leases.
         BudgetCallback m_budget_callback = nullptr;
 
-        bool check_budget(size_t size);
-        void record_budget_alloc(size_t size);
         void record_budget_free(size_t size);
+
+        /**
+         * @brief Charges size straight to the Context, bypassing the thread's lease.
+         *
+         * Paths whose final size is only known afterwards reserve an estimate here
+         * and true it up with settle_budget().
+         * @return false (notifying the budget callback) if the budget cannot cover it.
+         */
+        bool reserve_budget(size_t size);
+
+        /**
+         * @brief Corrects a reserve_budget() charge to the bytes actually allocated.
+         * @param actual 0 if the allocation failed, refunding the whole reservation.
+         */
+        void settle_budget(size_t reserved, size_t actual);
+
+        /**
+         * @brief Charges size to the calling thread's lease, or to the Context without one.
+         * @param notify Whether a refusal reaches the budget callback.
+         * @return false if the budget cannot cover it.
+         */
+        bool charge_budget(size_t size, bool notify = true);
+
+        /**
+         * @brief Gives back size bytes charged by charge_budget().
+         */
+        void refund_budget(size_t size);
+
+        /**
+         * @brief refund_budget() for a caller that already entered slot (or has none).
+         */
+        void credit_budget(TlsSlot *slot, size_t size);
+
+        /**
+         * @brief Leases enough from the Context to cover size, net of the unspent lease.
+         *
+         * Grants up to kBudgetLeaseBytes on top, less once the budget runs low.
+         * @param slot The calling thread's entered slot, or nullptr to charge size alone.
+         */
+        bool refill_budget_lease(TlsSlot *slot, size_t size, bool notify);
+
+        /**
+         * @brief Hands back the part of a slot's lease beyond keep bytes. Slot must be
+         *        entered or reclaiming.
+         */
+        void trim_budget_lease(TlsSlot &slot, size_t keep);
 #endif
 
 #ifdef CELL_ENABLE_INSTRUMENTATION
@@ -11,6 +11,10 @@
  * - CELL_DEBUG_GUARDS: Enable guard bytes before/after allocations
  * - CELL_DEBUG_STACKTRACE: Capture stack trace on allocation
  * - CELL_DEBUG_LEAKS: Track all allocations for leak detection
+ * - CELL_HARDENED: Encoded free lists, double-free and write-after-free checks
+ *   cheap enough to keep the TLS fast paths (meant for production builds)
+ * - CELL_ENABLE_HEAP_PROFILE: Sampling heap profiler; captures stacks with
+ *   capture_stack() for sampled allocations only (meant for production builds)
  *
  * All features have zero overhead when disabled.
  */
@@ -36,7 +40,9 @@ namespace Cell {
 #ifdef CELL_DEBUG_STACKTRACE
     /** @brief Maximum stack frames to capture per allocation. */
     static constexpr size_t kMaxStackDepth = 16;
+#endif
 
+#if defined(CELL_DEBUG_STACKTRACE) || defined(CELL_ENABLE_HEAP_PROFILE)
     /**
      * @brief Captures the current call stack.
      *
@@ -74,6 +80,9 @@ namespace Cell {
         void *ptr;   ///< User-visible pointer.
         size_t size; ///< Requested size in bytes.
         uint8_t tag; ///< Application-defined tag.
+#ifdef CELL_DEBUG_GUARDS
+        bool guarded; ///< Guard bytes surround the block (alloc_bytes() only).
+#endif
 #ifdef CELL_DEBUG_STACKTRACE
         void *stack[kMaxStackDepth]; ///< Captured stack trace.
         size_t stack_depth;          ///< Number of valid stack frames.
@@ -81,4 +90,26 @@ namespace Cell {
     };
 #endif
 
+    // =========================================================================
+    // Hardening
+    // =========================================================================
+
+#ifdef CELL_HARDENED
+    /**
+     * @brief One in this many TLS fast-path allocations checks that its block was
+     *        not written after it was freed. Slower paths check every block.
+     */
+    static constexpr uint32_t kHardenedCheckInterval = 16;
+
+    /**
+     * @brief Reports heap corruption found by a CELL_HARDENED check and aborts.
+     *
+     * Runs in any build type, NDEBUG included: the heap cannot be trusted past it.
+     *
+     * @param what Which check failed.
+     * @param ptr Block the check was made on.
+     */
+    [[noreturn]] void report_heap_corruption(const char *what, const void *ptr);
+#endif
+
 } // namespace Cell
@@ -1,9 +1,9 @@
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <mutex>
-#include <unordered_map>
 
 namespace Cell {
 
@@ -13,7 +13,24 @@ namespace Cell {
      * These allocations bypass the buddy system and are allocated/freed
      * directly via mmap/VirtualAlloc. Optionally uses huge pages.
      *
-     * Thread safety: Protected by internal mutex.
+     * Live allocations are tracked in open-addressing tables keyed by address, so
+     * owns() and get_alloc_size() never take a lock; free() takes a short one after
+     * retiring its entry, to tidy the table. There is no limit on live allocations:
+     * when they outgrow the tables, another one twice the size of the last is
+     * chained on. Tables are kept until the registry is destroyed.
+     *
+     * Freed mappings up to kCacheMaxBlockSize are kept in a small cache instead of
+     * being unmapped, and handed back to the next alloc() of the same size class
+     * without a syscall or fresh page faults. The cache is bounded by entry count
+     * and kCacheMaxBytes; a mapping that goes unused for kCacheMaxAge frees is
+     * released. trim_cache() returns everything to the OS.
+     *
+     * On Linux, mapped blocks are resized with mremap(), so growth and shrink move
+     * page table entries instead of copying. alloc_reserved() additionally reserves
+     * address space past the end so a block can grow in place up to the reservation.
+     *
+     * Thread safety: Lookups are lock-free; inserts and table tidying share a short
+     * lock, and the reuse cache has another.
      */
     class LargeAllocRegistry {
     public:
@@ -27,11 +44,29 @@ namespace Cell {
         /** @brief Alignment for large allocations */
         static constexpr size_t kLargeAlignment = 2 * 1024 * 1024; // 2MB
 
+        /** @brief Slots in the first live allocation table; each chained one doubles. */
+        static constexpr size_t kTableCapacity = 8192;
+
+        /** @brief Largest mapping kept for reuse after free. */
+        static constexpr size_t kCacheMaxBlockSize = 64 * 1024 * 1024; // 64MB
+
+        /** @brief Maximum bytes of freed mappings held for reuse. */
+        static constexpr size_t kCacheMaxBytes = 128 * 1024 * 1024; // 128MB
+
+        /** @brief Maximum number of freed mappings held for reuse. */
+        static constexpr size_t kCacheMaxEntries = 16;
+
+        /** @brief A cached mapping not reused within this many frees is released. */
+        static constexpr uint64_t kCacheMaxAge = 64;
+
+        static_assert((kTableCapacity & (kTableCapacity - 1)) == 0,
+                      "Table capacity must be a power of 2");
+
         // =====================================================================
         // Construction
         // =====================================================================
 
-        LargeAllocRegistry() = default;
+        LargeAllocRegistry();
         ~LargeAllocRegistry();
 
         // Non-copyable, non-movable
@@ -47,6 +82,9 @@ namespace Cell {
         /**
          * @brief Allocates a large block directly from the OS.
          *
+         * Reuses a cached mapping of the same size class when one is available;
+         * its contents are not cleared.
+         *
          * @param size Size in bytes (should be >= kMinLargeSize).
          * @param tag Memory tag for profiling.
          * @param try_huge_pages Attempt to use huge pages if available.
@@ -54,10 +92,25 @@ namespace Cell {
          */
         [[nodiscard]] void *alloc(size_t size, uint8_t tag = 0, bool try_huge_pages = true);
 
+        /**
+         * @brief Allocates a block that can later grow in place up to reserve_size.
+         *
+         * Address space for reserve_size bytes is reserved up front but only the
+         * first size bytes are committed; realloc_bytes() within the reservation
+         * commits more pages without moving the block. Growing past it falls back
+         * to a regular resize.
+         *
+         * @param size Initial size in bytes.
+         * @param reserve_size Address space to reserve (clamped to at least size).
+         * @param tag Memory tag for profiling.
+         * @return Pointer to allocated memory, or nullptr on failure.
+         */
+        [[nodiscard]] void *alloc_reserved(size_t size, size_t reserve_size, uint8_t tag = 0);
+
         /**
          * @brief Frees a previously allocated large block.
          *
-         * @param ptr Pointer returned by alloc() or alloc_aligned().
+         * @param ptr Pointer returned by alloc(), alloc_reserved() or alloc_aligned().
          */
         void free(void *ptr);
 
@@ -67,7 +120,9 @@ namespace Cell {
          * Behavior:
          * - If ptr is nullptr, behaves like alloc(new_size, tag)
          * - If new_size is 0, behaves like free(ptr)
-         * - Otherwise, attempts to resize the allocation
+         * - Within the block's mapping (size class or reservation): resized in place
+         * - Otherwise, on Linux: mremap() with MREMAP_MAYMOVE, no copy
+         * - Otherwise (huge pages, aligned blocks, other platforms): alloc + copy + free
          * - Data is preserved up to min(old_size, new_size)
          * - May return a different pointer if reallocation requires movement
          *
@@ -104,6 +159,12 @@ namespace Cell {
          */
         [[nodiscard]] size_t bytes_allocated() const;
 
+        /**
+         * @brief Returns bytes backed by the OS: committed pages of live blocks plus
+         *        mappings held in the reuse cache.
+         */
+        [[nodiscard]] size_t bytes_committed() const;
+
         /**
          * @brief Returns number of active allocations.
          */
@@ -116,21 +177,156 @@ namespace Cell {
          */
         [[nodiscard]] size_t get_alloc_size(void *ptr) const;
 
+        /**
+         * @brief Returns how many table slots a lookup of ptr inspects (diagnostics).
+         *
+         * For a pointer the registry does not own, this is what owns() costs.
+         */
+        [[nodiscard]] size_t probe_length(const void *ptr) const;
+
+        /**
+         * @brief Returns how large a block can grow without moving.
+         * @param ptr User pointer from alloc() or alloc_reserved()
+         * @return Mapping or reservation size, or 0 if not found
+         */
+        [[nodiscard]] size_t get_capacity(void *ptr) const;
+
+        // =====================================================================
+        // Reuse Cache
+        // =====================================================================
+
+        /**
+         * @brief Returns bytes of freed mappings currently held for reuse.
+         */
+        [[nodiscard]] size_t cached_bytes() const;
+
+        /**
+         * @brief Unmaps every cached mapping.
+         * @return Number of bytes returned to the OS.
+         */
+        size_t trim_cache();
+
     private:
         /**
-         * @brief Metadata for a large allocation.
+         * @brief Table slot for one live allocation.
+         *
+         * key is 0 when the slot is empty and kTombstone after a free. Inserting claims
+         * the slot with kBusy, fills the fields, then publishes the address with a
+         * release store, so a reader that sees the key sees the fields. Tombstones
+         * that end a probe chain are emptied again (clear_tombstones()), so chains
+         * stay as long as the live entries make them, however many addresses the
+         * table has seen.
+         */
+        struct Entry {
+            std::atomic<uintptr_t> key{0};
+            std::atomic<size_t> size{0};        ///< Requested size
+            std::atomic<size_t> mapped_size{0}; ///< Mapping length, 0 for posix_memalign blocks
+            std::atomic<size_t> committed_size{0}; ///< Accessible prefix; < mapped_size if reserved
+            std::atomic<uint8_t> tag{0};
+            std::atomic<bool> huge_pages{false};
+        };
+
+        static constexpr uintptr_t kTombstone = 1;
+        static constexpr uintptr_t kBusy = 2;
+
+        /**
+         * @brief One live allocation table; further ones are chained through next.
+         *
+         * Holds at most 3/4 of its capacity in live entries, so probe chains stay short.
+         */
+        struct Table {
+            Entry *slots = nullptr;
+            size_t capacity = 0;
+            size_t live = 0;                  ///< Live entries; guarded by m_table_lock.
+            std::atomic<Table *> next{nullptr}; ///< Next (larger) table, or nullptr.
+
+            [[nodiscard]] size_t max_live() const { return capacity / 4 * 3; }
+        };
+
+        /**
+         * @brief A freed mapping waiting to be reused.
          */
-        struct LargeAlloc {
+        struct CachedMapping {
+            void *base;
             size_t size;
-            void *original_ptr; ///< Original pointer (for aligned allocs, may differ from key)
-            uint8_t tag;
+            uint64_t last_use; ///< m_cache_clock when it was cached
             bool huge_pages;
-            bool aligned; ///< Was this an aligned allocation?
         };
 
-        std::unordered_map<void *, LargeAlloc> m_allocs;
-        mutable std::mutex m_lock;
-        size_t m_total_allocated{0};
+        // Live allocations (first table created on first insert)
+        std::atomic<Table *> m_tables{nullptr};
+        std::atomic<size_t> m_table_limit{0}; ///< Sum of the tables' max_live().
+        std::mutex m_table_lock; ///< Growth, inserts and clear_tombstones(); not lookups.
+        std::atomic<size_t> m_total_allocated{0};
+        std::atomic<size_t> m_total_committed{0}; ///< Committed bytes of live blocks
+        std::atomic<size_t> m_count{0};           ///< Live allocations plus reserved ones.
+
+        // Reuse cache
+        CachedMapping m_cache[kCacheMaxEntries]{};
+        size_t m_cache_count{0};
+        size_t m_cache_bytes{0};
+        uint64_t m_cache_clock{0};
+        mutable std::mutex m_cache_lock;
+
+        // =====================================================================
+        // Internal Methods
+        // =====================================================================
+
+        /**
+         * @brief Rounds a request to its mapping size (four size classes per doubling
+         *        up to kCacheMaxBlockSize, page-rounded above it).
+         */
+        static size_t mapping_size(size_t size);
+
+        /**
+         * @brief Claims room for one more live allocation, chaining on a table if needed.
+         * @return false only if a new table cannot be allocated.
+         */
+        bool reserve_entry();
+
+        /**
+         * @brief Records a live allocation in a slot claimed by reserve_entry().
+         */
+        void insert(void *ptr, size_t size, size_t mapped_size, size_t committed_size, uint8_t tag,
+                    bool huge_pages);
+
+        /**
+         * @brief Resizes a mapped block in place or via mremap().
+         * @return New pointer, or nullptr if the block must be copied instead.
+         */
+        void *remap(Table &table, Entry *entry, void *ptr, size_t new_size);
+
+        /**
+         * @brief Counts a retired entry out of its table and tidies the slots before it.
+         */
+        void retire(Table &table, Entry *entry);
+
+        /**
+         * @brief Empties entry's slot, a tombstone, and those before it if the slot
+         *        after it is empty. Caller holds m_table_lock.
+         */
+        static void clear_tombstones(Table &table, Entry *entry);
+
+        /**
+         * @brief Finds the live entry for ptr, or nullptr (lock-free).
+         * @param owner Set to the table holding the entry, if not nullptr.
+         */
+        Entry *find(void *ptr, Table **owner = nullptr) const;
+
+        /**
+         * @brief Takes a cached mapping of exactly mapped_size, or returns nullptr.
+         */
+        void *cache_take(size_t mapped_size, bool &huge_pages);
+
+        /**
+         * @brief Caches a freed mapping, unmapping it (or older entries) if over budget.
+         */
+        void cache_put(void *base, size_t mapped_size, bool huge_pages);
+
+        static void *map_region(size_t size, bool try_huge_pages, bool &used_huge);
+        static void *reserve_region(size_t reserve_size, size_t commit_size);
+        static bool commit_region(void *base, size_t size);
+        static void unmap_region(void *base, size_t size);
     };
 
 }
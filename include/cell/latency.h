@@ -0,0 +1,208 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace Cell {
+
+    /**
+     * @brief Slow paths timed with CELL_ENABLE_LATENCY_PROFILE.
+     *
+     * Hits in a thread cache are never timed; everything listed here is what a
+     * request falls through to when they miss.
+     */
+    enum class LatencyPath : uint8_t {
+        kTlsRefill,  ///< Refilling a thread's sub-cell bin cache from its remote queue or a bin.
+        kBinLock,    ///< Waiting for a size bin's lock (0 when it was free).
+        kCellFromOs, ///< Cell pool Tier 3: recommitting a purged cell or committing a superblock.
+        kBuddy,      ///< BuddyAllocator call on a thread cache miss: lock, split, recommit, grow.
+        kLarge,      ///< Large tier allocation: reuse cache lookup or mmap.
+    };
+
+    /** @brief Number of LatencyPath values. */
+    static constexpr size_t kLatencyPathCount = 5;
+
+    /** @brief Linear sub-buckets per power of two of a latency histogram (as a log2). */
+    static constexpr size_t kLatencySubBucketBits = 2;
+
+    /** @brief Latencies from 2^kLatencyMaxLog2 ns (~69s) up share the last bucket. */
+    static constexpr size_t kLatencyMaxLog2 = 36;
+
+    /** @brief Buckets of a latency histogram. */
+    static constexpr size_t kLatencyBuckets = (kLatencyMaxLog2 - kLatencySubBucketBits + 1)
+                                              << kLatencySubBucketBits;
+
+    /**
+     * @brief Log-linear bucket of a latency: exact below 4ns, then four buckets per
+     *        power of two, so a bucket is never wider than a quarter of its value.
+     */
+    inline size_t latency_bucket(uint64_t ns) {
+        constexpr uint64_t kSub = uint64_t{1} << kLatencySubBucketBits;
+        if (ns < kSub) {
+            return static_cast<size_t>(ns);
+        }
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long msb;
+        _BitScanReverse64(&msb, ns);
+        size_t log2 = msb;
+#else
+        size_t log2 = 63 - static_cast<size_t>(__builtin_clzll(ns));
+#endif
+        if (log2 >= kLatencyMaxLog2) {
+            return kLatencyBuckets - 1;
+        }
+        size_t sub = static_cast<size_t>(ns >> (log2 - kLatencySubBucketBits)) & (kSub - 1);
+        return ((log2 - kLatencySubBucketBits + 1) << kLatencySubBucketBits) + sub;
+    }
+
+    /** @brief Smallest latency, in ns, that falls in a bucket. */
+    inline uint64_t latency_bucket_floor(size_t bucket) {
+        constexpr size_t kSub = size_t{1} << kLatencySubBucketBits;
+        if (bucket < kSub) {
+            return bucket;
+        }
+        size_t log2 = (bucket >> kLatencySubBucketBits) + kLatencySubBucketBits - 1;
+        uint64_t sub = bucket & (kSub - 1);
+        return (kSub + sub) << (log2 - kLatencySubBucketBits);
+    }
+
+    /**
+     * @brief Distribution of one slow path's latency, as reported by HeapSnapshot.
+     */
+    struct LatencyHistogram {
+        std::array<uint64_t, kLatencyBuckets> buckets{}; ///< Samples by latency_bucket().
+        uint64_t count = 0;    ///< Samples recorded.
+        uint64_t total_ns = 0; ///< Sum of all samples.
+        uint64_t max_ns = 0;   ///< Longest sample.
+
+        /** @brief Average latency, or 0 without samples. */
+        [[nodiscard]] double mean_ns() const {
+            return count ? static_cast<double>(total_ns) / static_cast<double>(count) : 0.0;
+        }
+
+        /**
+         * @brief Latency below which a fraction q of the samples fall.
+         *
+         * Reports the end of the bucket holding that sample (capped at max_ns), so it
+         * overstates by at most a quarter. 0 without samples.
+         */
+        [[nodiscard]] uint64_t percentile_ns(double q) const {
+            if (count == 0) {
+                return 0;
+            }
+            auto rank = static_cast<uint64_t>(q * static_cast<double>(count));
+            rank = rank >= count ? count - 1 : rank;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < kLatencyBuckets; ++i) {
+                seen += buckets[i];
+                if (seen > rank) {
+                    uint64_t end = i + 1 < kLatencyBuckets ? latency_bucket_floor(i + 1) - 1
+                                                           : max_ns;
+                    return end < max_ns ? end : max_ns;
+                }
+            }
+            return max_ns;
+        }
+    };
+
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+
+    /**
+     * @brief Latency histograms one thread keeps for one Context, stored in its TlsSlot.
+     *
+     * Written like StatsShard: only by the owning thread, with relaxed loads and
+     * stores, and summed by Context::snapshot(). Exited threads are folded into the
+     * Context's own shard with add().
+     */
+    struct LatencyShard {
+        struct Path {
+            std::array<std::atomic<uint64_t>, kLatencyBuckets> buckets{};
+            std::atomic<uint64_t> count{0};
+            std::atomic<uint64_t> total_ns{0};
+            std::atomic<uint64_t> max_ns{0};
+        };
+
+        std::array<Path, kLatencyPathCount> paths;
+
+        /** @brief Records one sample; owning thread only. */
+        void record(LatencyPath path, uint64_t ns) {
+            Path &p = paths[static_cast<size_t>(path)];
+            bump(p.buckets[latency_bucket(ns)], 1);
+            bump(p.count, 1);
+            bump(p.total_ns, ns);
+            if (ns > p.max_ns.load(std::memory_order_relaxed)) {
+                p.max_ns.store(ns, std::memory_order_relaxed);
+            }
+        }
+
+        /** @brief Adds another shard's samples (any thread). */
+        void add(const LatencyShard &other) {
+            for (size_t i = 0; i < kLatencyPathCount; ++i) {
+                Path &p = paths[i];
+                const Path &o = other.paths[i];
+                for (size_t b = 0; b < kLatencyBuckets; ++b) {
+                    p.buckets[b].fetch_add(o.buckets[b].load(std::memory_order_relaxed),
+                                           std::memory_order_relaxed);
+                }
+                p.count.fetch_add(o.count.load(std::memory_order_relaxed),
+                                  std::memory_order_relaxed);
+                p.total_ns.fetch_add(o.total_ns.load(std::memory_order_relaxed),
+                                     std::memory_order_relaxed);
+                uint64_t max = o.max_ns.load(std::memory_order_relaxed);
+                uint64_t current = p.max_ns.load(std::memory_order_relaxed);
+                while (max > current &&
+                       !p.max_ns.compare_exchange_weak(current, max, std::memory_order_relaxed)) {
+                }
+            }
+        }
+
+        /** @brief Adds the samples to plain histograms (safe while the owner writes). */
+        void sum_into(std::array<LatencyHistogram, kLatencyPathCount> &out) const {
+            for (size_t i = 0; i < kLatencyPathCount; ++i) {
+                const Path &p = paths[i];
+                LatencyHistogram &h = out[i];
+                for (size_t b = 0; b < kLatencyBuckets; ++b) {
+                    h.buckets[b] += p.buckets[b].load(std::memory_order_relaxed);
+                }
+                h.count += p.count.load(std::memory_order_relaxed);
+                h.total_ns += p.total_ns.load(std::memory_order_relaxed);
+                uint64_t max = p.max_ns.load(std::memory_order_relaxed);
+                h.max_ns = max > h.max_ns ? max : h.max_ns;
+            }
+        }
+
+        /** @brief Zeroes every histogram; owning thread only. */
+        void clear() {
+            for (Path &p : paths) {
+                for (auto &bucket : p.buckets) {
+                    bucket.store(0, std::memory_order_relaxed);
+                }
+                p.count.store(0, std::memory_order_relaxed);
+                p.total_ns.store(0, std::memory_order_relaxed);
+                p.max_ns.store(0, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        static void bump(std::atomic<uint64_t> &value, uint64_t n) {
+            value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * @brief Nanoseconds per trace_clock() tick, for timing the LatencyPath slow paths.
+     *
+     * Measured once (see trace_clock_frequency()); a Context built with the profile
+     * takes the measurement in its constructor so that no timed path does.
+     */
+    double latency_ns_per_tick();
+
+#endif // CELL_ENABLE_LATENCY_PROFILE
+
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "context.h"
+
+namespace Cell {
+
+    /**
+     * @brief Returns the process-wide Context behind malloc() and operator new.
+     *
+     * Only defined by the cell_malloc library (CELL_BUILD_MALLOC); creates the Context
+     * on first use, like the first allocation does. Lets a program linked against or
+     * preloading cell_malloc scavenge, reclaim idle caches or read statistics of the
+     * heap it is running on.
+     */
+    Context &process_context();
+
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "arena.h"
+#include "context.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+
+namespace Cell {
+
+    /**
+     * @brief std::pmr::memory_resource backed by a Cell Context.
+     *
+     * Lets pmr containers share one heap without making the allocator part of their
+     * type:
+     * @code
+     * Cell::Context ctx;
+     * Cell::ContextResource resource(ctx);
+     * std::pmr::vector<int> vec(&resource);
+     * vec.push_back(42);  // Uses Cell memory!
+     * @endcode
+     *
+     * Deallocation passes the size (and alignment, when over-aligned) back to the
+     * sized free paths, so no ownership probe is needed.
+     *
+     * Thread safety: Same as Context.
+     */
+    class ContextResource : public std::pmr::memory_resource {
+    public:
+        /**
+         * @brief Creates a resource allocating from ctx.
+         * @param ctx Context to allocate from (must outlive the resource).
+         * @param tag Memory tag for profiling (default: 0).
+         */
+        explicit ContextResource(Context &ctx, uint8_t tag = 0) noexcept
+            : m_ctx(&ctx), m_tag(tag) {}
+
+        /**
+         * @brief Returns the underlying context.
+         */
+        [[nodiscard]] Context *context() const noexcept { return m_ctx; }
+
+        /**
+         * @brief Returns the allocation tag.
+         */
+        [[nodiscard]] uint8_t tag() const noexcept { return m_tag; }
+
+    protected:
+        /**
+         * @brief Allocates bytes at alignment; over-aligned requests go to alloc_aligned().
+         * @throws std::bad_alloc if allocation fails.
+         */
+        void *do_allocate(size_t bytes, size_t alignment) override {
+            // Zero-byte requests still need a unique pointer
+            size_t size = bytes ? bytes : 1;
+            void *ptr;
+            if (alignment > kSizeClassGranularity) {
+                ptr = m_ctx->alloc_aligned(size, alignment, m_tag);
+            } else {
+                ptr = m_ctx->alloc_bytes(size, m_tag, alignment);
+            }
+            if (!ptr) {
+                throw std::bad_alloc();
+            }
+            return ptr;
+        }
+
+        /**
+         * @brief Frees by the size and alignment passed to do_allocate().
+         */
+        void do_deallocate(void *ptr, size_t bytes, size_t alignment) override {
+            size_t size = bytes ? bytes : 1;
+            if (alignment > kSizeClassGranularity) {
+                m_ctx->free_aligned_sized(ptr, size, alignment);
+            } else {
+                m_ctx->free_sized(ptr, size);
+            }
+        }
+
+        /**
+         * @brief Equal to any ContextResource over the same Context (tags may differ).
+         */
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+            if (this == &other) {
+                return true;
+            }
+            auto *resource = dynamic_cast<const ContextResource *>(&other);
+            return resource && resource->m_ctx == m_ctx;
+        }
+
+    private:
+        Context *m_ctx;
+        uint8_t m_tag;
+    };
+
+    /**
+     * @brief std::pmr::memory_resource that bump-allocates from an Arena.
+     *
+     * Deallocation is a no-op: memory comes back when the arena is reset, so destroy
+     * the containers first.
+     * @code
+     * Cell::Arena arena(ctx);
+     * Cell::ArenaResource resource(arena);
+     * {
+     *     std::pmr::vector<Vertex> scratch(&resource);
+     *     // ... build and use scratch ...
+     * }
+     * arena.reset();
+     * @endcode
+     *
+     * Thread safety: None, like Arena.
+     */
+    class ArenaResource : public std::pmr::memory_resource {
+    public:
+        /**
+         * @brief Creates a resource allocating from arena.
+         * @param arena Arena to allocate from (must outlive the resource).
+         */
+        explicit ArenaResource(Arena &arena) noexcept : m_arena(&arena) {}
+
+        /**
+         * @brief Returns the underlying arena.
+         */
+        [[nodiscard]] Arena *arena() const noexcept { return m_arena; }
+
+    protected:
+        /**
+         * @brief Bumps bytes at alignment from the arena.
+         * @throws std::bad_alloc if the arena cannot grow.
+         */
+        void *do_allocate(size_t bytes, size_t alignment) override {
+            void *ptr = m_arena->alloc(bytes ? bytes : 1, alignment);
+            if (!ptr) {
+                throw std::bad_alloc();
+            }
+            return ptr;
+        }
+
+        /**
+         * @brief No-op; the arena frees everything on reset.
+         */
+        void do_deallocate(void *, size_t, size_t) override {}
+
+        /**
+         * @brief Equal to any ArenaResource over the same Arena.
+         */
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+            if (this == &other) {
+                return true;
+            }
+            auto *resource = dynamic_cast<const ArenaResource *>(&other);
+            return resource && resource->m_arena == m_arena;
+        }
+
+    private:
+        Arena *m_arena;
+    };
+
+}
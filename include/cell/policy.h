@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Cell {
+
+    // -------------------------------------------------------------------------
+    // Size Class Constraints (shared by every policy)
+    // -------------------------------------------------------------------------
+
+    /** @brief Minimum block size in bytes (must fit a free-list pointer). */
+    static constexpr size_t kMinBlockSize = 16;
+
+    /** @brief Every size class is a multiple of this (and blocks are aligned to it). */
+    static constexpr size_t kSizeClassGranularity = 16;
+
+    /** @brief Marker for full-cell allocations (not sub-cell). */
+    static constexpr uint8_t kFullCellMarker = 0xFF;
+
+    static_assert(kMinBlockSize >= sizeof(void *), "Min block must fit a pointer");
+
+    // -------------------------------------------------------------------------
+    // Geometry Policies
+    // -------------------------------------------------------------------------
+
+    /**
+     * @brief Geometry of the default Context: 16KB cells in 2MB superblocks.
+     *
+     * A policy is a struct of static constexpr members, the compile-time parameters of a
+     * BasicContext: cell and superblock size, the size class table, and the capacities of
+     * the thread-local caches. Everything derived from them is in PolicyTraits, which also
+     * validates a policy when a BasicContext is instantiated with it.
+     */
+    struct DefaultPolicy {
+        /**
+         * @brief Log2 of the Cell size. Default is 14 (16KB).
+         *
+         * Minimum is 12 (4KB, standard page size), maximum 16 (64KB, so that in-cell
+         * offsets and block counts fit 16 bits).
+         */
+        static constexpr size_t kCellSizeLog2 = 14;
+
+        /** @brief Log2 of the superblock size. Default is 21 (2MB). */
+        static constexpr size_t kSuperblockSizeLog2 = 21;
+
+        /** @brief Number of size class bins for sub-cell allocation. */
+        static constexpr size_t kNumSizeBins = 32;
+
+        /**
+         * @brief Size class table; the last class is the largest sub-cell size.
+         *
+         * 16-byte steps up to 128B, then four classes per doubling, which bounds
+         * internal fragmentation at 25% (vs 50% for power-of-2 classes).
+         */
+        static constexpr size_t kSizeClasses[kNumSizeBins] = {
+            16,   32,   48,   64,   80,   96,   112,  128,  // 16B steps
+            160,  192,  224,  256,  320,  384,  448,  512,  // 4 per doubling
+            640,  768,  896,  1024, 1280, 1536, 1792, 2048, //
+            2560, 3072, 3584, 4096, 5120, 6144, 7168, 8192, //
+        };
+
+        /** @brief Number of cells cached per thread (TLS). */
+        static constexpr size_t kTlsCacheCapacity = 64;
+
+        /** @brief Number of bins with TLS caching (every sub-cell bin: 16B to 8KB). */
+        static constexpr size_t kTlsBinCacheCount = 32;
+
+        /** @brief Most blocks cached per bin per thread (ceiling of the adaptive capacity). */
+        static constexpr size_t kTlsBinCacheCapacity = 128;
+
+        /** @brief Number of buddy orders with TLS caching (orders 15-18: 32KB to 256KB blocks). */
+        static constexpr size_t kTlsBuddyCacheOrders = 4;
+
+        /** @brief Number of buddy blocks cached per order per thread. */
+        static constexpr size_t kTlsBuddyCacheCapacity = 4;
+    };
+
+    /**
+     * @brief 64KB cells with size classes up to 32KB.
+     *
+     * Fewer cells per superblock and far fewer cell-tier trips for 8KB-32KB objects,
+     * at the cost of more memory stranded in partly used cells. The cell cache holds
+     * half as many cells (still 2MB per thread); the block caches are the default ones.
+     */
+    struct LargeCellPolicy {
+        static constexpr size_t kCellSizeLog2 = 16;
+        static constexpr size_t kSuperblockSizeLog2 = 21;
+
+        static constexpr size_t kNumSizeBins = 40;
+        static constexpr size_t kSizeClasses[kNumSizeBins] = {
+            16,    32,    48,    64,    80,    96,    112,   128,   // 16B steps
+            160,   192,   224,   256,   320,   384,   448,   512,   // 4 per doubling
+            640,   768,   896,   1024,  1280,  1536,  1792,  2048,  //
+            2560,  3072,  3584,  4096,  5120,  6144,  7168,  8192,  //
+            10240, 12288, 14336, 16384, 20480, 24576, 28672, 32768, //
+        };
+
+        static constexpr size_t kTlsCacheCapacity = 32;
+        static constexpr size_t kTlsBinCacheCount = 32;
+        static constexpr size_t kTlsBinCacheCapacity = 128;
+        static constexpr size_t kTlsBuddyCacheOrders = 4;
+        static constexpr size_t kTlsBuddyCacheCapacity = 4;
+    };
+
+    /**
+     * @brief Constants derived from a geometry policy, and its validation.
+     *
+     * BasicContext and its parts read every policy constant through here, so a policy
+     * only spells out the parameters. All of it is constexpr: code instantiated for a
+     * policy pays nothing over hard-coded constants.
+     */
+    template <typename Policy> struct PolicyTraits {
+        static constexpr size_t kCellSizeLog2 = Policy::kCellSizeLog2;
+        static constexpr size_t kCellSize = size_t{1} << kCellSizeLog2;
+        static constexpr uintptr_t kCellMask = ~(uintptr_t{kCellSize} - 1);
+
+        static constexpr size_t kSuperblockSizeLog2 = Policy::kSuperblockSizeLog2;
+        static constexpr size_t kSuperblockSize = size_t{1} << kSuperblockSizeLog2;
+        static constexpr size_t kCellsPerSuperblock = kSuperblockSize / kCellSize;
+
+        static constexpr size_t kNumSizeBins = Policy::kNumSizeBins;
+        static constexpr const size_t (&kSizeClasses)[kNumSizeBins] = Policy::kSizeClasses;
+        static constexpr size_t kMaxSubCellSize = kSizeClasses[kNumSizeBins - 1];
+
+        static constexpr size_t kTlsCacheCapacity = Policy::kTlsCacheCapacity;
+        static constexpr size_t kTlsBinCacheCount = Policy::kTlsBinCacheCount;
+        static constexpr size_t kTlsBinCacheCapacity = Policy::kTlsBinCacheCapacity;
+        static constexpr size_t kTlsBuddyCacheOrders = Policy::kTlsBuddyCacheOrders;
+        static constexpr size_t kTlsBuddyCacheCapacity = Policy::kTlsBuddyCacheCapacity;
+
+        /** @brief Validates that classes ascend and are multiples of the granularity. */
+        static constexpr bool size_classes_valid() {
+            for (size_t i = 0; i < kNumSizeBins; ++i) {
+                if (kSizeClasses[i] % kSizeClassGranularity != 0) {
+                    return false;
+                }
+                if (i > 0 && kSizeClasses[i] <= kSizeClasses[i - 1]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static_assert(kCellSizeLog2 >= 12, "Cell size must be at least 4KB (standard page size)");
+        static_assert(kCellSizeLog2 <= 16, "Cell offsets and block counts must fit 16 bits");
+        static_assert(kSuperblockSizeLog2 >= kCellSizeLog2, "Superblock must be >= cell size");
+        static_assert(kTlsCacheCapacity >= 1, "TLS cache must hold at least 1 cell");
+
+        static_assert(kNumSizeBins > 0, "Must have at least 1 size bin");
+        static_assert(kNumSizeBins < kFullCellMarker, "Bin indices must fit below the marker");
+        static_assert(size_classes_valid(), "Size classes must ascend in granularity steps");
+        static_assert(kSizeClasses[0] == kMinBlockSize,
+                      "First size class must match min block size");
+        static_assert(kMaxSubCellSize < kCellSize, "Max sub-cell size must be < cell size");
+
+        static_assert(kTlsBinCacheCount >= 1 && kTlsBinCacheCount <= kNumSizeBins,
+                      "TLS-cached bins must be real bins");
+        static_assert(kSizeClasses[kTlsBinCacheCount - 1] >= 4096,
+                      "TLS-cached bins must cover the 4KB inline fast path");
+        static_assert(kTlsBinCacheCapacity >= 2, "TLS bin caches must hold at least 2 blocks");
+        static_assert(kTlsBuddyCacheCapacity >= 1, "Buddy TLS cache must hold at least 1 block");
+    };
+
+    template <typename Policy> class BasicContext;
+
+    /** @brief The Context of the default geometry; see BasicContext. */
+    using Context = BasicContext<DefaultPolicy>;
+
+}
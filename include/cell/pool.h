@@ -3,10 +3,18 @@
 #include "arena.h"
 #include "context.h"
 
+#include <algorithm>
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <new>
 #include <utility>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
 
 namespace Cell {
 
@@ -17,6 +25,9 @@ namespace Cell {
      * with optional constructor/destructor support.
      *
      * Thread safety: Same as Context (per-bin locking for sub-cell allocations).
+     * Objects belong to the Context, not the pool: they outlive it and may be freed
+     * through any Pool<T> on the same Context. For a single-threaded pool that packs
+     * objects at sizeof(T) stride and can walk them, see LocalPool<T>.
      *
      * @tparam T The type of objects to pool.
      */
@@ -62,9 +73,20 @@ namespace Cell {
         /**
          * @brief Frees memory without calling destructor.
          *
+         * Frees by size (sizeof(T)); pointers from alloc_array() are still accepted
+         * but are cheaper to free with free_array().
+         *
          * @param ptr Pointer previously returned by alloc() or alloc_array().
          */
-        void free(T *ptr) { m_ctx.free_bytes(ptr); }
+        void free(T *ptr) { m_ctx.free_sized(ptr, sizeof(T)); }
+
+        /**
+         * @brief Frees an array without calling destructors.
+         *
+         * @param ptr Pointer previously returned by alloc_array().
+         * @param count Element count passed to alloc_array().
+         */
+        void free_array(T *ptr, size_t count) { m_ctx.free_sized(ptr, sizeof(T) * count); }
 
         // =====================================================================
         // Allocation with Construction
@@ -157,6 +179,549 @@ namespace Cell {
         uint8_t m_tag;
     };
 
+    /**
+     * @brief A typed slab pool: cells dedicated to T, carved at sizeof(T) stride.
+     *
+     * Each slab is one 16KB cell taken from the Context. A small header after the
+     * CellHeader holds the slab's free list and an occupancy bitmap; objects follow
+     * it back to back, so a 48-byte T costs 48 bytes instead of a 64B size class and
+     * never shares a cell with unrelated allocations. Fresh slabs are handed out in
+     * address order, freed objects are reused most recent first, and at most one
+     * empty slab is kept for reuse; the rest go back to the Context.
+     *
+     * for_each_live() walks the allocated objects slab by slab in address order, for
+     * systems that prefer a linear scan over chasing pointers.
+     *
+     * alloc_array() / free_array() are not part of the slabs: they allocate from the
+     * Context and are not visited by for_each_live(). free() tells the two apart by a
+     * magic number in the slab header.
+     *
+     * Thread safety: None, like Arena; use one pool per thread (or guard it), or
+     * Pool<T> for objects shared between threads.
+     *
+     * Lifetime: objects live in the pool's slabs, so they must not outlive it.
+     * Destroying the pool (or calling release()) returns every slab to the Context
+     * without running destructors; any object still in use dangles.
+     *
+     * @tparam T The type of objects to pool.
+     */
+    template <typename T> class LocalPool {
+    public:
+        /** @brief Distance between consecutive objects of a slab. */
+        static constexpr size_t kObjectStride =
+            align_up_const(sizeof(T) < sizeof(void *) ? sizeof(void *) : sizeof(T), alignof(T));
+
+    private:
+        /**
+         * @brief Offset of the slab header from the cell start.
+         *
+         * Fixed past the larger (debug) CellHeader: this code is inlined into the caller, whose
+         * NDEBUG may differ from the library's (the benchmarks build with -DNDEBUG).
+         */
+        static constexpr size_t kSlabOffset = 16;
+        static_assert(sizeof(CellHeader) <= kSlabOffset && kSlabOffset % alignof(void *) == 0,
+                      "Slab header must follow the CellHeader");
+
+        /** @brief Size of the slab header without its occupancy bitmap. */
+        static constexpr size_t kSlabFixedSize =
+            sizeof(uint64_t) + 3 * sizeof(void *) + 2 * sizeof(uint32_t);
+
+        /** @brief Identifies a slab cell ("CELLSLAB"); cleared when it is returned. */
+        static constexpr uint64_t kSlabMagic = 0x43454C4C534C4142ull;
+
+        // Full cells from alloc_bytes() never write where the magic lives
+        static_assert(kSlabOffset + sizeof(uint64_t) <= kBlockStartOffset,
+                      "Slab magic must precede the payload of a full cell");
+
+        /** @brief Bitmap words for the most objects a cell could hold (an upper bound). */
+        static constexpr size_t kBitmapWords =
+            ((kCellSize - kSlabOffset - kSlabFixedSize) / kObjectStride + 63) / 64;
+
+        /**
+         * @brief Slab header, stored in the cell right after the CellHeader.
+         */
+        struct Slab {
+            uint64_t magic;                   ///< kSlabMagic while the cell is a slab.
+            Slab *next_partial;               ///< Next slab with free objects.
+            Slab *prev_partial;               ///< Previous slab with free objects.
+            void *free_list;                  ///< Freed objects, linked through their first bytes.
+            uint32_t live;                    ///< Objects currently allocated.
+            uint32_t bump;                    ///< First object never handed out.
+            uint64_t occupancy[kBitmapWords]; ///< Bit i set: object i is allocated.
+        };
+        static_assert(sizeof(Slab) == kSlabFixedSize + kBitmapWords * sizeof(uint64_t),
+                      "Slab header must have no padding");
+
+        /** @brief Offset of the first object from the cell start. */
+        static constexpr size_t kObjectsOffset =
+            align_up_const(kSlabOffset + sizeof(Slab), alignof(T));
+
+    public:
+        /** @brief Objects held by each slab. */
+        static constexpr size_t kObjectsPerSlab =
+            kObjectsOffset < kCellSize ? (kCellSize - kObjectsOffset) / kObjectStride : 0;
+
+        static_assert(kObjectsPerSlab > 0,
+                      "LocalPool<T> objects must fit in a cell; use Context::alloc_bytes() for T");
+
+        /**
+         * @brief Creates a pool backed by the given context.
+         *
+         * @param ctx Context to allocate from.
+         * @param tag Memory tag for profiling.
+         */
+        explicit LocalPool(Context &ctx, uint8_t tag = 0) : m_ctx(ctx), m_tag(tag) {}
+
+        /**
+         * @brief Returns every slab to the context (objects are not destroyed).
+         */
+        ~LocalPool() { release(); }
+
+        // Non-copyable; movable by construction only (holds a Context reference)
+        LocalPool(const LocalPool &) = delete;
+        LocalPool &operator=(const LocalPool &) = delete;
+        LocalPool(LocalPool &&other) noexcept
+            : m_ctx(other.m_ctx), m_tag(other.m_tag), m_slabs(std::move(other.m_slabs)),
+              m_partial(std::exchange(other.m_partial, nullptr)),
+              m_live(std::exchange(other.m_live, 0)),
+              m_empty_slabs(std::exchange(other.m_empty_slabs, 0)) {
+            other.m_slabs.clear();
+        }
+        LocalPool &operator=(LocalPool &&) = delete;
+
+        // =====================================================================
+        // Allocation (No Construction)
+        // =====================================================================
+
+        /**
+         * @brief Allocates memory for one object without calling constructor.
+         *
+         * @return Pointer to uninitialized memory, or nullptr on failure.
+         */
+        [[nodiscard]] T *alloc() {
+            Slab *slab = m_partial;
+            if (CELL_UNLIKELY(!slab)) {
+                slab = add_slab();
+                if (!slab) {
+                    return nullptr;
+                }
+            }
+            return take(slab);
+        }
+
+        /**
+         * @brief Allocates memory for an array without calling constructors.
+         *
+         * Served by the Context, outside the slabs.
+         *
+         * @param count Number of elements to allocate.
+         * @return Pointer to uninitialized memory, or nullptr on failure.
+         */
+        [[nodiscard]] T *alloc_array(size_t count) {
+            return static_cast<T *>(m_ctx.alloc_bytes(sizeof(T) * count, m_tag, alignof(T)));
+        }
+
+        /**
+         * @brief Frees memory without calling destructor.
+         *
+         * Pointers from alloc_array() are still accepted but are cheaper to free with
+         * free_array().
+         *
+         * @param ptr Pointer previously returned by alloc(), create(), alloc_batch()
+         *            or alloc_array(), or nullptr.
+         */
+        void free(T *ptr) {
+            if (CELL_UNLIKELY(!ptr)) {
+                return;
+            }
+            Slab *slab = slab_of(ptr);
+            if (CELL_UNLIKELY(!m_ctx.in_cell_region(ptr) ||
+                              get_header(ptr)->size_class != kFullCellMarker ||
+                              slab->magic != kSlabMagic)) {
+                m_ctx.free_bytes(ptr);
+                return;
+            }
+            size_t index = index_of(slab, ptr);
+            uint64_t bit = uint64_t{1} << (index % 64);
+            assert((slab->occupancy[index / 64] & bit) &&
+                   "LocalPool::free: object is not allocated");
+            slab->occupancy[index / 64] &= ~bit;
+
+            std::memcpy(ptr, &slab->free_list, sizeof(void *));
+            slab->free_list = ptr;
+            --m_live;
+            if (slab->live-- == kObjectsPerSlab) {
+                push_partial(slab);
+            }
+            if (CELL_UNLIKELY(slab->live == 0)) {
+                on_slab_empty(slab);
+            }
+        }
+
+        /**
+         * @brief Frees an array without calling destructors.
+         *
+         * @param ptr Pointer previously returned by alloc_array().
+         * @param count Element count passed to alloc_array().
+         */
+        void free_array(T *ptr, size_t count) { m_ctx.free_sized(ptr, sizeof(T) * count); }
+
+        // =====================================================================
+        // Allocation with Construction
+        // =====================================================================
+
+        /**
+         * @brief Allocates and constructs one object using placement new.
+         *
+         * @tparam Args Constructor argument types.
+         * @param args Arguments to forward to T's constructor.
+         * @return Pointer to constructed object, or nullptr on allocation failure.
+         */
+        template <typename... Args> [[nodiscard]] T *create(Args &&...args) {
+            T *ptr = alloc();
+            if (ptr) {
+                new (ptr) T(std::forward<Args>(args)...);
+            }
+            return ptr;
+        }
+
+        /**
+         * @brief Destroys and frees one object.
+         *
+         * Calls the destructor then frees the memory.
+         *
+         * @param ptr Pointer previously returned by create().
+         */
+        void destroy(T *ptr) {
+            if (ptr) {
+                ptr->~T();
+                free(ptr);
+            }
+        }
+
+        // =====================================================================
+        // Batch Allocation
+        // =====================================================================
+
+        /**
+         * @brief Allocates multiple objects into a caller-provided array.
+         *
+         * Drains one slab at a time; runs of never-used objects are handed out in
+         * address order with their occupancy bits set a word at a time.
+         *
+         * @param out Array to store pointers (must have space for count elements).
+         * @param count Number of objects to allocate.
+         * @return Number of objects actually allocated (may be less on failure).
+         */
+        size_t alloc_batch(T **out, size_t count) {
+            size_t allocated = 0;
+            while (allocated < count) {
+                Slab *slab = m_partial;
+                if (!slab) {
+                    slab = add_slab();
+                    if (!slab) {
+                        break;
+                    }
+                }
+
+                // Reused objects first, then a bump run from the untouched tail
+                while (slab->free_list && allocated < count &&
+                       slab->live < kObjectsPerSlab) {
+                    out[allocated++] = take(slab);
+                }
+                if (allocated == count || slab->live == kObjectsPerSlab) {
+                    continue;
+                }
+
+                size_t run = kObjectsPerSlab - slab->bump;
+                if (run > count - allocated) {
+                    run = count - allocated;
+                }
+                for (size_t i = 0; i < run; ++i) {
+                    out[allocated + i] = object_at(slab, slab->bump + i);
+                }
+                set_occupied(slab, slab->bump, run);
+                if (slab->live == 0) {
+                    --m_empty_slabs;
+                }
+                slab->bump += static_cast<uint32_t>(run);
+                slab->live += static_cast<uint32_t>(run);
+                m_live += run;
+                allocated += run;
+                if (slab->live == kObjectsPerSlab) {
+                    unlink_partial(slab);
+                }
+            }
+            return allocated;
+        }
+
+        /**
+         * @brief Frees multiple objects.
+         *
+         * @param ptrs Array of pointers to free.
+         * @param count Number of pointers in the array.
+         */
+        void free_batch(T **ptrs, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                free(ptrs[i]);
+            }
+        }
+
+        // =====================================================================
+        // Iteration
+        // =====================================================================
+
+        /**
+         * @brief Calls fn(T&) for every allocated object, in address order.
+         *
+         * Visits what alloc() handed out whether or not it was constructed; fn must
+         * not allocate from or free to the pool.
+         */
+        template <typename Fn> void for_each_live(Fn &&fn) {
+            for (Slab *slab : m_slabs) {
+                for (size_t word = 0; word < kBitmapWords; ++word) {
+                    uint64_t bits = slab->occupancy[word];
+                    if (bits == ~uint64_t{0}) {
+                        // Dense run: skip the bit scan
+                        char *object = reinterpret_cast<char *>(object_at(slab, word * 64));
+                        for (size_t i = 0; i < 64; ++i, object += kObjectStride) {
+                            fn(*reinterpret_cast<T *>(object));
+                        }
+                        continue;
+                    }
+                    while (bits) {
+                        size_t index = word * 64 + lowest_bit(bits);
+                        fn(*object_at(slab, index));
+                        bits &= bits - 1;
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Const overload of for_each_live(); calls fn(const T&).
+         */
+        template <typename Fn> void for_each_live(Fn &&fn) const {
+            const_cast<LocalPool *>(this)->for_each_live(
+                [&fn](T &object) { fn(static_cast<const T &>(object)); });
+        }
+
+        // =====================================================================
+        // Lifetime Management
+        // =====================================================================
+
+        /**
+         * @brief Returns every slab to the context at once (objects are not destroyed).
+         */
+        void release() {
+            for (Slab *slab : m_slabs) {
+                free_slab(slab);
+            }
+            m_slabs.clear();
+            m_partial = nullptr;
+            m_live = 0;
+            m_empty_slabs = 0;
+        }
+
+        // =====================================================================
+        // Introspection
+        // =====================================================================
+
+        /**
+         * @brief Returns the size of each object.
+         */
+        static constexpr size_t object_size() { return sizeof(T); }
+
+        /**
+         * @brief Returns the alignment of each object.
+         */
+        static constexpr size_t object_alignment() { return alignof(T); }
+
+        /**
+         * @brief Returns the distance between neighbouring objects in a slab.
+         */
+        static constexpr size_t object_stride() { return kObjectStride; }
+
+        /**
+         * @brief Returns how many objects one slab (cell) holds.
+         */
+        static constexpr size_t objects_per_slab() { return kObjectsPerSlab; }
+
+        /**
+         * @brief Returns the number of objects currently allocated from the slabs.
+         */
+        size_t live_count() const { return m_live; }
+
+        /**
+         * @brief Returns the number of cells held as slabs.
+         */
+        size_t slab_count() const { return m_slabs.size(); }
+
+        /**
+         * @brief Returns the memory tag used by this pool.
+         */
+        uint8_t tag() const { return m_tag; }
+
+    private:
+        // =====================================================================
+        // Slab Layout
+        // =====================================================================
+
+        static Slab *slab_of(const void *ptr) {
+            auto *cell = reinterpret_cast<char *>(get_header(const_cast<void *>(ptr)));
+            return reinterpret_cast<Slab *>(cell + kSlabOffset);
+        }
+
+        static CellData *cell_of(Slab *slab) {
+            return reinterpret_cast<CellData *>(reinterpret_cast<char *>(slab) - kSlabOffset);
+        }
+
+        static T *object_at(Slab *slab, size_t index) {
+            return reinterpret_cast<T *>(reinterpret_cast<char *>(cell_of(slab)) + kObjectsOffset +
+                                         index * kObjectStride);
+        }
+
+        static size_t index_of(Slab *slab, const T *ptr) {
+            size_t offset = static_cast<size_t>(reinterpret_cast<const char *>(ptr) -
+                                                reinterpret_cast<char *>(cell_of(slab)));
+            assert(offset >= kObjectsOffset && (offset - kObjectsOffset) % kObjectStride == 0 &&
+                   "LocalPool::free: pointer is not an object of this pool");
+            return (offset - kObjectsOffset) / kObjectStride;
+        }
+
+        /** @brief Index of the lowest set bit (bits must be non-zero). */
+        static size_t lowest_bit(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<size_t>(__builtin_ctzll(bits));
+#elif defined(_MSC_VER)
+            unsigned long idx;
+            _BitScanForward64(&idx, bits);
+            return static_cast<size_t>(idx);
+#else
+            size_t idx = 0;
+            while (!(bits & 1)) {
+                bits >>= 1;
+                ++idx;
+            }
+            return idx;
+#endif
+        }
+
+        static void set_occupied(Slab *slab, size_t first, size_t count) {
+            while (count > 0) {
+                size_t bit = first % 64;
+                size_t n = 64 - bit < count ? 64 - bit : count;
+                uint64_t mask = n == 64 ? ~uint64_t{0} : ((uint64_t{1} << n) - 1) << bit;
+                slab->occupancy[first / 64] |= mask;
+                first += n;
+                count -= n;
+            }
+        }
+
+        // =====================================================================
+        // Slab Management
+        // =====================================================================
+
+        /**
+         * @brief Hands out one object of a slab with free objects.
+         */
+        CELL_FORCE_INLINE T *take(Slab *slab) {
+            size_t index;
+            void *ptr = slab->free_list;
+            if (ptr) {
+                std::memcpy(&slab->free_list, ptr, sizeof(void *));
+                index = index_of(slab, static_cast<T *>(ptr));
+            } else {
+                index = slab->bump++;
+                ptr = object_at(slab, index);
+            }
+            slab->occupancy[index / 64] |= uint64_t{1} << (index % 64);
+
+            ++m_live;
+            if (CELL_UNLIKELY(slab->live++ == 0)) {
+                --m_empty_slabs;
+            }
+            if (CELL_UNLIKELY(slab->live == kObjectsPerSlab)) {
+                unlink_partial(slab);
+            }
+            return static_cast<T *>(ptr);
+        }
+
+        /**
+         * @brief Takes a fresh cell, keeping m_slabs sorted by address.
+         */
+        Slab *add_slab() {
+            CellData *cell = m_ctx.alloc_cell(m_tag);
+            if (!cell) {
+                return nullptr;
+            }
+            auto *slab = reinterpret_cast<Slab *>(reinterpret_cast<char *>(cell) + kSlabOffset);
+            slab->magic = kSlabMagic;
+            slab->next_partial = nullptr;
+            slab->prev_partial = nullptr;
+            slab->free_list = nullptr;
+            slab->live = 0;
+            slab->bump = 0;
+            std::memset(slab->occupancy, 0, sizeof(slab->occupancy));
+
+            m_slabs.insert(std::lower_bound(m_slabs.begin(), m_slabs.end(), slab), slab);
+            ++m_empty_slabs;
+            push_partial(slab);
+            return slab;
+        }
+
+        /**
+         * @brief Keeps the first empty slab for reuse and returns any further one.
+         */
+        void on_slab_empty(Slab *slab) {
+            if (m_empty_slabs == 0) {
+                ++m_empty_slabs;
+                return;
+            }
+            unlink_partial(slab);
+            m_slabs.erase(std::lower_bound(m_slabs.begin(), m_slabs.end(), slab));
+            free_slab(slab);
+        }
+
+        void free_slab(Slab *slab) {
+            slab->magic = 0; // The cell may come back as a full-cell alloc_bytes() block
+            m_ctx.free_cell(cell_of(slab));
+        }
+
+        void push_partial(Slab *slab) {
+            slab->prev_partial = nullptr;
+            slab->next_partial = m_partial;
+            if (m_partial) {
+                m_partial->prev_partial = slab;
+            }
+            m_partial = slab;
+        }
+
+        void unlink_partial(Slab *slab) {
+            if (slab->prev_partial) {
+                slab->prev_partial->next_partial = slab->next_partial;
+            } else {
+                m_partial = slab->next_partial;
+            }
+            if (slab->next_partial) {
+                slab->next_partial->prev_partial = slab->prev_partial;
+            }
+            slab->next_partial = nullptr;
+            slab->prev_partial = nullptr;
+        }
+
+        // =====================================================================
+        // Members
+        // =====================================================================
+
+        Context &m_ctx;
+        uint8_t m_tag;
+        std::vector<Slab *> m_slabs;  ///< Every slab, sorted by address.
+        Slab *m_partial = nullptr;    ///< Head of the slabs with free objects.
+        size_t m_live = 0;            ///< Objects allocated from the slabs.
+        size_t m_empty_slabs = 0;     ///< Slabs with no live objects (at most one kept).
+    };
+
     // =========================================================================
     // Arena Scope Guard (Stack Allocator Pattern)
     // =========================================================================
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Cell {
+
+    /**
+     * @brief File, address and capacity of a new SharedHeap.
+     */
+    struct SharedHeapConfig {
+        /**
+         * @brief Empty file to build the heap in: a memfd, shm_open() object or regular file.
+         *
+         * Grown sparsely to SharedHeap::size(). The heap does not close it; other
+         * processes attach with a descriptor of the same file.
+         */
+        int fd = -1;
+
+        /**
+         * @brief Address to map the heap at in every process; nullptr lets the OS choose.
+         *
+         * Attaching processes map it at the same address, so pick one that is free in
+         * all of them. An existing mapping is never replaced.
+         */
+        void *base = nullptr;
+
+        /** @brief Bytes available for allocations (rounded up to whole cells). */
+        size_t capacity = 256 * 1024 * 1024;
+    };
+
+    struct SharedHeapHeader;
+
+    /**
+     * @brief A heap that several processes allocate from and free to (POSIX).
+     *
+     * The whole heap, its metadata included, lives in one MAP_SHARED file mapping at
+     * the same address in every process, so a message graph built by one process is
+     * passed to another by its root pointer instead of serialized, and whichever
+     * process is done with a block frees it. One process creates the heap in an
+     * empty file; the others attach to it by descriptor. A forked child inherits the
+     * mapping and keeps using the same SharedHeap.
+     *
+     * Small requests are carved from 16KB cells by size class, each class under a
+     * lock of its own; larger ones take runs of whole cells, which coalesce when
+     * freed and have their pages punched out of the file (MADV_REMOVE). The locks
+     * are process-shared, robust mutexes: a process that dies holding one marks the
+     * heap broken, and from then on allocations fail and frees are ignored.
+     * There are no per-thread caches, so each call takes a lock. Blocks are 16-byte
+     * aligned.
+     *
+     * Usage:
+     * @code
+     *     // Supervisor
+     *     Cell::SharedHeapConfig config;
+     *     config.fd = memfd_create("heap", 0);
+     *     config.base = reinterpret_cast<void*>(0x7e0000000000);
+     *     Cell::SharedHeap heap(config);
+     *     Message* msg = build_message(heap);  // Pass msg and the fd to a worker
+     *
+     *     // Worker, e.g. with the fd received over a Unix socket
+     *     Cell::SharedHeap heap(fd);
+     *     if (heap.valid() && heap.contains(msg)) {
+     *         Reply* reply = heap.alloc<Reply>();
+     *         consume(msg, reply);
+     *         heap.free_bytes(msg);
+     *     }
+     * @endcode
+     *
+     * Thread safety: every function may be called from any thread of any process
+     * that has the heap mapped. On Windows a heap never maps.
+     */
+    class SharedHeap {
+    public:
+        /**
+         * @brief Creates a heap in an empty file.
+         *
+         * Fails, leaving valid() false, if the file is not empty, cannot be grown, or
+         * something is already mapped where the heap would go.
+         */
+        explicit SharedHeap(const SharedHeapConfig &config);
+
+        /**
+         * @brief Attaches to a heap another process created in the file.
+         *
+         * Maps the file at the address it was created at. Fails, leaving valid()
+         * false, if the file holds no heap (or one from another build of the library)
+         * or that address range is taken in this process.
+         *
+         * @param fd Descriptor of the heap's file. The heap does not close it.
+         */
+        explicit SharedHeap(int fd);
+
+        /** @brief Unmaps the heap. Its blocks stay allocated for the other processes. */
+        ~SharedHeap();
+
+        SharedHeap(const SharedHeap &) = delete;
+        SharedHeap &operator=(const SharedHeap &) = delete;
+
+        // =====================================================================
+        // Allocation
+        // =====================================================================
+
+        /**
+         * @brief Allocates a 16-byte aligned block in the shared file.
+         *
+         * @return Pointer valid in every process of the heap, or nullptr if the heap is
+         *         full, broken or not mapped.
+         */
+        [[nodiscard]] void *alloc_bytes(size_t size);
+
+        /**
+         * @brief Allocates memory for a single object of type T.
+         */
+        template <typename T> [[nodiscard]] T *alloc() {
+            static_assert(alignof(T) <= 16, "SharedHeap blocks are 16-byte aligned");
+            return static_cast<T *>(alloc_bytes(sizeof(T)));
+        }
+
+        /**
+         * @brief Allocates memory for an array of objects.
+         */
+        template <typename T> [[nodiscard]] T *alloc_array(size_t count) {
+            static_assert(alignof(T) <= 16, "SharedHeap blocks are 16-byte aligned");
+            return count > SIZE_MAX / sizeof(T) ? nullptr
+                                                : static_cast<T *>(alloc_bytes(sizeof(T) * count));
+        }
+
+        /**
+         * @brief Frees a block, whichever process of the heap allocated it.
+         *
+         * @param ptr Pointer from alloc_bytes() in any process, or nullptr.
+         */
+        void free_bytes(void *ptr);
+
+        /**
+         * @brief Returns how many bytes starting at ptr the caller may use.
+         *
+         * @param ptr Pointer from alloc_bytes() in any process, or nullptr (returns 0).
+         */
+        [[nodiscard]] size_t usable_size(const void *ptr) const;
+
+        // =====================================================================
+        // Introspection
+        // =====================================================================
+
+        /** @brief Checks whether the heap is mapped. */
+        [[nodiscard]] bool valid() const { return m_header != nullptr; }
+
+        /** @brief Start of the mapping, the same in every process; nullptr if invalid. */
+        [[nodiscard]] void *base() const { return m_header; }
+
+        /** @brief Bytes mapped: metadata plus capacity() (the file's length). */
+        [[nodiscard]] size_t size() const { return m_size; }
+
+        /** @brief Bytes available for allocations, in whole cells. */
+        [[nodiscard]] size_t capacity() const;
+
+        /** @brief Usable bytes of the live blocks, summed over every process. */
+        [[nodiscard]] size_t allocated_bytes() const;
+
+        /** @brief Checks whether a pointer lies in the mapping. */
+        [[nodiscard]] bool contains(const void *ptr) const {
+            auto uptr = reinterpret_cast<uintptr_t>(ptr);
+            auto base = reinterpret_cast<uintptr_t>(m_header);
+            return m_header && uptr >= base && uptr < base + m_size;
+        }
+
+        /**
+         * @brief Checks whether a process died holding one of the heap's locks.
+         *
+         * The metadata it was changing cannot be trusted, so a broken heap serves no
+         * more allocations. Its blocks stay readable.
+         */
+        [[nodiscard]] bool broken() const;
+
+    private:
+        SharedHeapHeader *m_header = nullptr; ///< Start of the mapping.
+        size_t m_size = 0;                    ///< Bytes mapped.
+    };
+
+}
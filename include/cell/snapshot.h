@@ -0,0 +1,108 @@
+#pragma once
+
+#include "allocator.h"
+#include "buddy.h"
+#include "config.h"
+#include "latency.h"
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Cell {
+
+    /** @brief Buckets of BinSnapshot::free_histogram, each 1/8 of a cell's blocks wide. */
+    static constexpr size_t kSnapshotFreeBuckets = 8;
+
+    /**
+     * @brief Occupancy of one size-class bin, as seen by Context::snapshot().
+     */
+    struct BinSnapshot {
+        size_t block_size = 0;        ///< Size class in bytes.
+        size_t blocks_per_cell = 0;   ///< Blocks carved from each cell of the bin.
+        size_t partial_cells = 0;     ///< Cells on the partial list (warm cells included).
+        size_t warm_cells = 0;        ///< Wholly free cells kept as reserve.
+        size_t free_blocks = 0;       ///< Free blocks summed over the partial cells.
+        size_t allocated_blocks = 0;  ///< Blocks the bin counts as handed out (cached included).
+        size_t tls_cached_blocks = 0; ///< Blocks in all threads' caches of the bin.
+
+        /**
+         * @brief Partial cells by free_count / blocks_per_cell.
+         *
+         * Bucket i holds cells with [i/8, (i+1)/8) of their blocks free; the last one
+         * also holds wholly free cells. Many cells in the low buckets means the bin
+         * is fragmented across cells that are nearly full.
+         */
+        std::array<size_t, kSnapshotFreeBuckets> free_histogram{};
+    };
+
+    /**
+     * @brief Structured occupancy report of a Context, returned by Context::snapshot().
+     *
+     * Every number is read while the Context keeps running, so they need not add up
+     * exactly across tiers. The thread-local cache counts are summed over every thread
+     * bound to the Context, each read as its owner keeps allocating, so they are
+     * approximate. Cached blocks and cells also count as allocated.
+     *
+     * The per-bin and per-cached-order vectors have one entry per size class and TLS-cached
+     * buddy order of the Context's policy.
+     */
+    struct HeapSnapshot {
+        // =====================================================================
+        // Sub-Cell Bins
+        // =====================================================================
+
+        std::vector<BinSnapshot> bins; ///< By size class.
+
+        // =====================================================================
+        // Cells and Superblocks
+        // =====================================================================
+
+        std::array<size_t, kSuperblockStateCount> superblocks{}; ///< By SuperblockState.
+        size_t cell_committed_bytes = 0; ///< Superblocks kInUse or kFree.
+        size_t tls_cached_cells = 0;     ///< Cells in all threads' cell caches.
+
+        // =====================================================================
+        // Buddy Tier
+        // =====================================================================
+
+        std::array<size_t, BuddyAllocator::kNumOrders> buddy_free_blocks{}; ///< By order.
+        std::vector<size_t> buddy_tls_cached_blocks; ///< All threads, by cached order.
+        size_t buddy_allocated_bytes = 0;
+        size_t buddy_committed_bytes = 0;
+
+        // =====================================================================
+        // Large Tier
+        // =====================================================================
+
+        size_t large_allocations = 0;
+        size_t large_allocated_bytes = 0;
+        size_t large_committed_bytes = 0; ///< Live mappings plus the reuse cache.
+        size_t large_cached_bytes = 0;    ///< Freed mappings held for reuse.
+
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+        // =====================================================================
+        // Slow Path Latency (all threads, since the Context was created)
+        // =====================================================================
+
+        std::array<LatencyHistogram, kLatencyPathCount> latency{}; ///< By LatencyPath.
+#endif
+
+        /**
+         * @brief Returns the snapshot as one JSON object.
+         */
+        [[nodiscard]] std::string to_json() const;
+
+        /**
+         * @brief Returns the snapshot in the Prometheus text exposition format.
+         *
+         * Every value is a gauge named prefix + "_" + metric; bins are labelled by
+         * block size, buddy orders by block size and superblocks by state.
+         *
+         * @param prefix Metric name prefix (default: "cell").
+         */
+        [[nodiscard]] std::string to_prometheus(const char *prefix = "cell") const;
+    };
+
+}
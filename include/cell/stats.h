@@ -1,5 +1,7 @@
 #pragma once
 
+#include "config.h"
+
 #include <array>
 #include <atomic>
 #include <cstddef>
@@ -10,10 +12,91 @@ namespace Cell {
 
 #ifdef CELL_ENABLE_STATS
 
+    /**
+     * @brief Net bytes a thread allocates or frees before publishing them for peak tracking.
+     *
+     * Bounds the error of MemoryStats::peak_allocated to this much per thread.
+     */
+    static constexpr int64_t kStatsPeakFlushBytes = 64 * 1024;
+
+    /**
+     * @brief Counters one thread keeps for one Context, stored in its TlsSlot.
+     *
+     * Only the owning thread writes them, with a relaxed load and store instead of a
+     * read-modify-write, so recording costs what a plain increment does and never
+     * shares a cache line with another thread. Context::get_stats() sums all shards.
+     * Current bytes are total_allocated - total_freed: a block freed on another
+     * thread cancels out in the sum (modulo 2^64).
+     */
+    struct StatsShard {
+        /** @brief Index of each counter in counters. */
+        enum Counter : size_t {
+            kTotalAllocated,
+            kTotalFreed,
+            kCellAllocs,
+            kCellFrees,
+            kSubcellAllocs,
+            kSubcellFrees,
+            kBuddyAllocs,
+            kBuddyFrees,
+            kLargeAllocs,
+            kLargeFrees,
+            kCounterCount
+        };
+
+        std::array<std::atomic<size_t>, kCounterCount> counters{}; ///< Cumulative, by Counter.
+        std::array<std::atomic<size_t>, 256> per_tag_current{};     ///< Net bytes per tag.
+        int64_t unflushed = 0; ///< Net bytes not yet published for peak tracking (owner only).
+
+        /** @brief Adds n to a counter; owning thread only. */
+        void add(Counter counter, size_t n) {
+            std::atomic<size_t> &value = counters[counter];
+            value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        /** @brief Adds n (wrapping, so -size subtracts) to a tag; owning thread only. */
+        void add_tag(uint8_t tag, size_t n) {
+            std::atomic<size_t> &value = per_tag_current[tag];
+            value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        /** @brief Zeroes every counter; owning thread only. */
+        void clear() {
+            for (auto &value : counters) {
+                value.store(0, std::memory_order_relaxed);
+            }
+            for (auto &value : per_tag_current) {
+                value.store(0, std::memory_order_relaxed);
+            }
+            unflushed = 0;
+        }
+    };
+
+    /**
+     * @brief Plain sum of StatsShard counters, as read by Context::get_stats().
+     */
+    struct StatsTotals {
+        std::array<size_t, StatsShard::kCounterCount> counters{};
+        std::array<size_t, 256> per_tag_current{};
+
+        /** @brief Adds a shard's counters (safe while its owner keeps writing). */
+        void add(const StatsShard &shard) {
+            for (size_t i = 0; i < StatsShard::kCounterCount; ++i) {
+                counters[i] += shard.counters[i].load(std::memory_order_relaxed);
+            }
+            for (size_t i = 0; i < 256; ++i) {
+                per_tag_current[i] += shard.per_tag_current[i].load(std::memory_order_relaxed);
+            }
+        }
+    };
+
     /**
      * @brief Memory statistics for tracking allocations.
      *
-     * All counters are atomic for thread-safe updates.
+     * A snapshot: Context::get_stats() refills it from the per-thread StatsShards
+     * on every call, so re-read it through get_stats() after allocating. Counters
+     * are exact once the threads that allocated have returned from their calls;
+     * peak_allocated may miss up to kStatsPeakFlushBytes per thread.
      * Only compiled when CELL_ENABLE_STATS is defined.
      */
     struct MemoryStats {
@@ -46,39 +129,19 @@ namespace Cell {
         std::array<std::atomic<size_t>, 256> per_tag_current{}; ///< Current bytes per tag
 
         // =====================================================================
-        // Methods
+        // Per-NUMA-Node Snapshot (refreshed by Context::get_stats())
         // =====================================================================
 
-        /**
-         * @brief Records an allocation.
-         */
-        void record_alloc(size_t size, uint8_t tag) {
-            total_allocated.fetch_add(size, std::memory_order_relaxed);
-            size_t current = current_allocated.fetch_add(size, std::memory_order_relaxed) + size;
-
-            // Update peak (relaxed is fine, approximate is okay)
-            size_t peak = peak_allocated.load(std::memory_order_relaxed);
-            while (current > peak) {
-                if (peak_allocated.compare_exchange_weak(peak, current,
-                                                         std::memory_order_relaxed)) {
-                    break;
-                }
-            }
-
-            per_tag_current[tag].fetch_add(size, std::memory_order_relaxed);
-        }
+        size_t numa_nodes = 1; ///< Cell pools in use (Config::numa_nodes)
+        std::array<std::atomic<size_t>, kMaxNumaNodes> node_committed{};    ///< Committed cell bytes
+        std::array<std::atomic<size_t>, kMaxNumaNodes> node_cells_in_use{}; ///< Cells handed out
 
-        /**
-         * @brief Records a deallocation.
-         */
-        void record_free(size_t size, uint8_t tag) {
-            total_freed.fetch_add(size, std::memory_order_relaxed);
-            current_allocated.fetch_sub(size, std::memory_order_relaxed);
-            per_tag_current[tag].fetch_sub(size, std::memory_order_relaxed);
-        }
+        // =====================================================================
+        // Methods
+        // =====================================================================
 
         /**
-         * @brief Resets all counters.
+         * @brief Zeroes the snapshot (Context::reset_stats() resets the counters behind it).
          */
         void reset() {
             total_allocated = 0;
@@ -96,6 +159,10 @@ namespace Cell {
             for (auto &tag : per_tag_current) {
                 tag = 0;
             }
+            for (size_t i = 0; i < kMaxNumaNodes; ++i) {
+                node_committed[i] = 0;
+                node_cells_in_use[i] = 0;
+            }
         }
 
         /**
@@ -126,6 +193,14 @@ namespace Cell {
                     printf("  Tag %3zu: %zu bytes\n", i, val);
                 }
             }
+
+            if (numa_nodes > 1) {
+                printf("\nPer-node cells:\n");
+                for (size_t i = 0; i < numa_nodes && i < kMaxNumaNodes; ++i) {
+                    printf("  Node %zu: %zu bytes committed, %zu cells in use\n", i,
+                           node_committed[i].load(), node_cells_in_use[i].load());
+                }
+            }
         }
     };
 
@@ -3,6 +3,7 @@
 #include "context.h"
 
 #include <cstddef>
+#include <memory>
 #include <type_traits>
 
 namespace Cell {
@@ -28,6 +29,16 @@ namespace Cell {
         using propagate_on_container_move_assignment = std::true_type;
         using is_always_equal = std::false_type;
 
+#if defined(__cpp_lib_allocate_at_least)
+        using allocation_result = std::allocation_result<T *, size_type>;
+#else
+        /** @brief Stand-in for std::allocation_result before C++23. */
+        struct allocation_result {
+            T *ptr;
+            size_type count;
+        };
+#endif
+
         /**
          * @brief Constructs an allocator using the given Context.
          * @param ctx Reference to the Cell context (must outlive the allocator).
@@ -44,6 +55,9 @@ namespace Cell {
 
         /**
          * @brief Allocates memory for n objects of type T.
+         *
+         * Over-aligned T goes through alloc_aligned(), so any n is honored.
+         *
          * @param n Number of objects.
          * @return Pointer to allocated memory.
          * @throws std::bad_alloc if allocation fails.
@@ -52,19 +66,60 @@ namespace Cell {
             if (n == 0)
                 return nullptr;
 
-            void *ptr = m_ctx->alloc_bytes(n * sizeof(T), m_tag, alignof(T));
+            void *ptr;
+            if constexpr (alignof(T) > kSizeClassGranularity) {
+                ptr = m_ctx->alloc_aligned(n * sizeof(T), alignof(T), m_tag);
+            } else {
+                ptr = m_ctx->alloc_bytes(n * sizeof(T), m_tag, alignof(T));
+            }
             if (!ptr) {
                 throw std::bad_alloc();
             }
             return static_cast<T *>(ptr);
         }
 
+        /**
+         * @brief Allocates room for at least n objects and reports how many fit (P0401).
+         *
+         * Uses the slack of the block the Context hands out (Context::alloc_at_least()),
+         * so containers that ask for it grow less often. Over-aligned T gets exactly n.
+         *
+         * @param n Minimum number of objects.
+         * @return The memory and the number of objects it holds.
+         * @throws std::bad_alloc if allocation fails.
+         */
+        [[nodiscard]] allocation_result allocate_at_least(size_type n) {
+            if constexpr (alignof(T) > kSizeClassGranularity) {
+                return {allocate(n), n};
+            } else {
+                if (n == 0)
+                    return {nullptr, 0};
+
+                AllocationResult block = m_ctx->alloc_at_least(n * sizeof(T), m_tag, alignof(T));
+                if (!block.ptr) {
+                    throw std::bad_alloc();
+                }
+                return {static_cast<T *>(block.ptr), block.size / sizeof(T)};
+            }
+        }
+
         /**
          * @brief Deallocates memory.
+         *
+         * Uses the element count the container passes back to free by size
+         * (and alignment, for over-aligned T).
+         *
          * @param p Pointer to memory.
-         * @param n Number of objects (unused, but required by interface).
+         * @param n Number of objects passed to allocate() or returned by
+         *        allocate_at_least().
          */
-        void deallocate(T *p, size_type /*n*/) noexcept { m_ctx->free_bytes(p); }
+        void deallocate(T *p, size_type n) noexcept {
+            if constexpr (alignof(T) > kSizeClassGranularity) {
+                m_ctx->free_aligned_sized(p, n * sizeof(T), alignof(T));
+            } else {
+                m_ctx->free_sized(p, n * sizeof(T));
+            }
+        }
 
         /**
          * @brief Returns the underlying context.
@@ -2,7 +2,9 @@
 
 #include "cell.h"
 #include "config.h"
+#include "debug.h"
 
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
 
@@ -23,30 +25,69 @@ namespace Cell {
         return (size + alignment - 1) & ~(alignment - 1);
     }
 
+    /**
+     * @brief Size-to-bin table indexed by size / kSizeClassGranularity (rounded up).
+     *
+     * Built at compile time from the policy's kSizeClasses, so any class table works.
+     */
+    template <typename Policy> struct SizeClassLookup {
+        using Traits = PolicyTraits<Policy>;
+
+        static constexpr size_t kEntries = Traits::kMaxSubCellSize / kSizeClassGranularity + 1;
+
+        uint8_t bins[kEntries];
+
+        constexpr SizeClassLookup() : bins{} {
+            size_t bin = 0;
+            for (size_t i = 0; i < kEntries; ++i) {
+                while (Traits::kSizeClasses[bin] < i * kSizeClassGranularity) {
+                    ++bin;
+                }
+                bins[i] = static_cast<uint8_t>(bin);
+            }
+        }
+    };
+
+    /** @brief Compile-time size class lookup table (513 bytes for DefaultPolicy). */
+    template <typename Policy> inline constexpr SizeClassLookup<Policy> kSizeClassLookup{};
+
+    static_assert(kBlockStartOffset % kSizeClassGranularity == 0,
+                  "Block start must keep blocks granularity-aligned");
+
     /**
      * @brief Finds the size class bin for a given allocation request.
      *
+     * Blocks are guaranteed kSizeClassGranularity alignment; blocks of a
+     * power-of-2 class are also aligned to the class size (see
+     * block_start_offset()). Larger alignments therefore select the smallest
+     * power-of-2 class >= alignment.
+     *
      * @param size Size of the allocation in bytes.
      * @param alignment Required alignment (must be power of 2).
      * @return Bin index (0 to kNumSizeBins-1), or kFullCellMarker if too large.
      */
+    template <typename Policy = DefaultPolicy>
     inline uint8_t get_size_class(size_t size, size_t alignment) {
+        using Traits = PolicyTraits<Policy>;
+
         // Round up to alignment requirement
         size = align_up(size, alignment);
 
-        // Ensure minimum size
-        if (size < kMinBlockSize) {
-            size = kMinBlockSize;
+        if (size > Traits::kMaxSubCellSize) {
+            return kFullCellMarker;
         }
 
-        // Find smallest bin that fits
-        for (size_t i = 0; i < kNumSizeBins; ++i) {
-            if (kSizeClasses[i] >= size) {
-                // Verify alignment is satisfied by this bin
-                // Power-of-2 sizes are naturally aligned to any smaller power-of-2
-                if (kSizeClasses[i] >= alignment) {
-                    return static_cast<uint8_t>(i);
-                }
+        uint8_t bin = kSizeClassLookup<Policy>.bins[(size + kSizeClassGranularity - 1) /
+                                                    kSizeClassGranularity];
+        if (alignment <= kSizeClassGranularity) {
+            return bin;
+        }
+
+        // Over-aligned: skip to a power-of-2 class at least as large as the alignment
+        for (size_t i = bin; i < Traits::kNumSizeBins; ++i) {
+            size_t class_size = Traits::kSizeClasses[i];
+            if (class_size >= alignment && (class_size & (class_size - 1)) == 0) {
+                return static_cast<uint8_t>(i);
             }
         }
 
@@ -66,48 +107,49 @@ namespace Cell {
 #endif
 
     /**
-     * @brief Fast O(1) size class lookup using bit manipulation.
+     * @brief Fast O(1) size class lookup for default-aligned requests.
      *
-     * Uses count-leading-zeros to find the bin in constant time.
-     * Only valid for power-of-2 size classes.
+     * A single load from kSizeClassLookup; sizes below kMinBlockSize map to bin 0.
      *
-     * @param size Size of the allocation (will be rounded up to min).
-     * @return Bin index (0-9), or kFullCellMarker if too large.
+     * @param size Size of the allocation in bytes.
+     * @return Bin index (0 to kNumSizeBins-1), or kFullCellMarker if too large.
      */
+    template <typename Policy = DefaultPolicy>
     CELL_FORCE_INLINE uint8_t get_size_class_fast(size_t size) {
-        // Clamp to minimum
-        if (CELL_UNLIKELY(size < kMinBlockSize)) {
-            size = kMinBlockSize;
-        }
-
         // Too large for sub-cell
-        if (CELL_UNLIKELY(size > kMaxSubCellSize)) {
+        if (CELL_UNLIKELY(size > PolicyTraits<Policy>::kMaxSubCellSize)) {
             return kFullCellMarker;
         }
 
-        // Round up to next power of 2
-        // Formula: ceil(log2(size)) gives us the order
-        // For power-of-2 sizes: bin = log2(size) - 4  (since 16 = 2^4 is bin 0)
-        size_t v = size - 1; // Handle exact powers correctly
-
-#if defined(__GNUC__) || defined(__clang__)
-        // Use builtin for speed: 63 - clz gives us floor(log2(v))
-        // We want ceil(log2(size)) = floor(log2(size-1)) + 1 for non-powers
-        unsigned order = (v == 0) ? 0 : (64 - __builtin_clzll(v));
-#else
-        // Fallback: bit scan
-        unsigned order = 0;
-        while (v >>= 1)
-            ++order;
-        ++order;
-#endif
+        return kSizeClassLookup<Policy>.bins[(size + kSizeClassGranularity - 1) /
+                                             kSizeClassGranularity];
+    }
 
-        // Clamp minimum to 4 (16 bytes = 2^4)
-        if (order < 4)
-            order = 4;
+    /**
+     * @brief Offset of the first block from the cell start for a size class.
+     *
+     * Power-of-2 classes start at kBlockStartOffset rounded up to the class size,
+     * so with the class size as stride every block is aligned to it. This costs
+     * no blocks: the rounding never crosses a whole block.
+     *
+     * @param bin_index The size class bin index.
+     * @return Offset in bytes; kBlockStartOffset for other classes.
+     */
+    template <typename Policy = DefaultPolicy>
+    inline constexpr size_t block_start_offset(size_t bin_index) {
+        size_t class_size = PolicyTraits<Policy>::kSizeClasses[bin_index];
+        if ((class_size & (class_size - 1)) == 0) {
+            return align_up_const(kBlockStartOffset, class_size);
+        }
+        return kBlockStartOffset;
+    }
 
-        // Bin index = order - 4 (since bin 0 = 16 = 2^4)
-        return static_cast<uint8_t>(order - 4);
+    /**
+     * @brief Gets the first block of a cell dedicated to a size class.
+     */
+    template <typename Policy = DefaultPolicy>
+    inline void *get_block_start(CellHeader *header, size_t bin_index) {
+        return reinterpret_cast<char *>(header) + block_start_offset<Policy>(bin_index);
     }
 
     /**
@@ -116,8 +158,100 @@ namespace Cell {
      * @param bin_index The size class bin index.
      * @return Number of blocks that fit in one cell.
      */
+    template <typename Policy = DefaultPolicy>
     inline constexpr size_t blocks_per_cell(size_t bin_index) {
-        return (kCellSize - kBlockStartOffset) / kSizeClasses[bin_index];
+        using Traits = PolicyTraits<Policy>;
+        return (Traits::kCellSize - block_start_offset<Policy>(bin_index)) /
+               Traits::kSizeClasses[bin_index];
+    }
+
+    /** @brief Checks that class-aligned block starts fit as many blocks as kBlockStartOffset. */
+    template <typename Policy> inline constexpr bool block_starts_lossless() {
+        using Traits = PolicyTraits<Policy>;
+        for (size_t i = 0; i < Traits::kNumSizeBins; ++i) {
+            if (blocks_per_cell<Policy>(i) !=
+                (Traits::kCellSize - kBlockStartOffset) / Traits::kSizeClasses[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Takes one free block from a sub-cell cell with free_count > 0.
+     *
+     * Reuses freed blocks first and only then bumps into the untouched tail, so a
+     * cell's pages are first written when their blocks are actually allocated.
+     * CELL_HARDENED builds check each listed block and its link before following
+     * it, and seal bumped blocks so that they pass the same checks later.
+     *
+     * @param header Header of a cell dedicated to a size class.
+     * @param key Free-list key of the Context owning the cell.
+     * @return The block; free_count is decremented.
+     */
+    template <typename Policy = DefaultPolicy>
+    inline FreeBlock *take_cell_block(CellHeader *header, uintptr_t key) {
+        CellMetadata *metadata = get_metadata(header);
+        FreeBlock *block = metadata->free_list;
+        if (block) {
+            FreeBlock *next = block->get_next(key);
+#ifdef CELL_HARDENED
+            if (CELL_UNLIKELY(!block->intact(key) ||
+                              (next && get_header<Policy>(next) != header))) {
+                report_heap_corruption("cell free list corrupted", block);
+            }
+#endif
+            metadata->free_list = next;
+        } else {
+            size_t bin_index = header->size_class;
+            assert(metadata->bump_index < blocks_per_cell<Policy>(bin_index));
+            block = reinterpret_cast<FreeBlock *>(
+                static_cast<char *>(get_block_start<Policy>(header, bin_index)) +
+                size_t{metadata->bump_index++} * PolicyTraits<Policy>::kSizeClasses[bin_index]);
+#ifdef CELL_HARDENED
+            block->set_next(nullptr, key);
+#endif
+        }
+        header->free_count--;
+        return block;
+    }
+
+    /**
+     * @brief Reciprocals of the class sizes for dividing in-cell offsets by them.
+     *
+     * (offset * kBlockIndexReciprocals[bin]) >> 32 is offset / size for every offset
+     * below kCellSize: the rounding error stays under 1 / size. PolicyTraits keeps
+     * cells at or below 64KB (2^16) for this.
+     */
+    template <typename Policy> struct BlockIndexReciprocals {
+        using Traits = PolicyTraits<Policy>;
+
+        uint64_t values[Traits::kNumSizeBins];
+
+        constexpr BlockIndexReciprocals() : values{} {
+            for (size_t i = 0; i < Traits::kNumSizeBins; ++i) {
+                values[i] = (uint64_t{1} << 32) / Traits::kSizeClasses[i] + 1;
+            }
+        }
+    };
+
+    template <typename Policy>
+    inline constexpr BlockIndexReciprocals<Policy> kBlockIndexReciprocals{};
+
+    /**
+     * @brief Index of the block of a size-class cell that contains an address.
+     *
+     * @param header Header of a cell dedicated to bin_index.
+     * @param bin_index The cell's size class.
+     * @param ptr Address within the cell, at or past its first block.
+     */
+    template <typename Policy = DefaultPolicy>
+    inline size_t block_index(const CellHeader *header, size_t bin_index, const void *ptr) {
+        uint64_t offset = static_cast<uint64_t>(static_cast<const char *>(ptr) -
+                                                reinterpret_cast<const char *>(header)) -
+                          block_start_offset<Policy>(bin_index);
+        return static_cast<size_t>(
+            (offset * kBlockIndexReciprocals<Policy>.values[bin_index]) >> 32);
     }
 
     // -------------------------------------------------------------------------
@@ -128,13 +262,16 @@ namespace Cell {
      * @brief Manages cells dedicated to a specific size class.
      *
      * Each bin maintains a list of "partial" cells that have at least one free block.
-     * The allocator tries partial cells first, then requests fresh cells.
+     * The allocator tries partial cells first, then requests fresh cells. A cell
+     * that a thread has adopted for lock-free refills is on no list until the
+     * thread retires it.
      */
     struct SizeBin {
         CellHeader *partial_head = nullptr; /**< Head of partial cell list. */
         size_t warm_cell_count = 0;         /**< Number of warm (empty) cells kept. */
 
-        // Statistics (optional, useful for debugging)
+        // Statistics (optional, useful for debugging). A cell adopted by a thread
+        // counts all of its free blocks as allocated until the thread retires it.
         size_t total_allocated = 0;   /**< Total blocks allocated from this bin. */
         size_t current_allocated = 0; /**< Currently allocated blocks. */
     };
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "policy.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace Cell {
+
+    /** @brief Events each thread's trace ring holds (power of 2); 256KB per thread. */
+    static constexpr size_t kTraceRingEvents = 8192;
+
+    static_assert((kTraceRingEvents & (kTraceRingEvents - 1)) == 0,
+                  "Trace ring size must be a power of 2");
+
+    /**
+     * @brief What a TraceEvent records.
+     */
+    enum class TraceKind : uint8_t {
+        kAlloc,   ///< ptr was handed out for size bytes.
+        kFree,    ///< ptr was freed; size is its block size (0 if unknown).
+        kRealloc, ///< ptr was resized in place to size bytes.
+    };
+
+    /**
+     * @brief The tier that served a traced block.
+     */
+    enum class TraceTier : uint8_t {
+        kSubCell, ///< Size-class bin block (<= 8KB).
+        kCell,    ///< Whole 16KB cell.
+        kBuddy,   ///< Buddy block (<= 2MB).
+        kLarge,   ///< Direct OS mapping.
+    };
+
+    /**
+     * @brief One allocation event, as written to a thread's trace ring.
+     *
+     * Two events fill a cache line. Events of one thread appear in program order;
+     * sort by timestamp to interleave threads.
+     */
+    struct TraceEvent {
+        uint64_t timestamp; ///< trace_clock() ticks.
+        uint64_t ptr;       ///< Address of the block.
+        uint64_t size;      ///< Requested bytes (kAlloc, kRealloc) or block bytes (kFree).
+        uint32_t thread;    ///< Per-Context thread number, from 1.
+        uint8_t tag;        ///< Memory tag (0 for frees the tier keeps no tag for).
+        TraceTier tier;
+        TraceKind kind;
+        uint8_t reserved = 0;
+    };
+
+    static_assert(sizeof(TraceEvent) == 32, "TraceEvent is meant to stay 32 bytes");
+
+    /**
+     * @brief Timestamp counter for TraceEvent::timestamp.
+     *
+     * The TSC on x86, the virtual counter on AArch64, nanoseconds elsewhere; convert
+     * with trace_clock_frequency().
+     */
+    inline uint64_t trace_clock() {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64_t ticks;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+#endif
+    }
+
+    /**
+     * @brief Returns trace_clock() ticks per second.
+     *
+     * Measured once against steady_clock on x86 (the first call takes ~10ms).
+     */
+    uint64_t trace_clock_frequency();
+
+    /**
+     * @brief First bytes of a trace stream written by TraceWriter; TraceEvents follow.
+     */
+    struct TraceFileHeader {
+        char magic[8] = {'C', 'E', 'L', 'L', 'T', 'R', 'C', '1'};
+        uint32_t event_size = sizeof(TraceEvent);
+        uint32_t reserved = 0;
+        uint64_t ticks_per_second = 0; ///< trace_clock_frequency() of the recording.
+    };
+
+#ifdef CELL_ENABLE_TRACE
+    /**
+     * @brief Thread that drains a Context's trace rings to a file or socket.
+     *
+     * Writes a TraceFileHeader, then raw TraceEvents as they are drained. Enables
+     * tracing on the Context while it runs and disables it on destruction, after a
+     * final drain.
+     * @code
+     * FILE *out = std::fopen("heap.trace", "wb");
+     * {
+     *     Cell::TraceWriter writer(ctx, out);
+     *     run_workload();
+     * }
+     * std::fclose(out);
+     * @endcode
+     *
+     * Sockets can be written through fdopen().
+     */
+    class TraceWriter {
+    public:
+        /**
+         * @brief Starts tracing ctx and the draining thread.
+         * @param ctx Context to trace; must outlive the writer.
+         * @param out Stream to write to; left open.
+         * @param interval_ms Sleep between drains. Each thread's ring must not fill
+         *        up in this time, or events are dropped.
+         */
+        TraceWriter(Context &ctx, std::FILE *out, uint32_t interval_ms = 10);
+
+        /** @brief Stops tracing, drains what is left and joins the thread. */
+        ~TraceWriter();
+
+        TraceWriter(const TraceWriter &) = delete;
+        TraceWriter &operator=(const TraceWriter &) = delete;
+
+        /** @brief Returns the number of events written so far. */
+        [[nodiscard]] uint64_t events_written() const {
+            return m_written.load(std::memory_order_relaxed);
+        }
+
+    private:
+        void run();
+        void drain();
+
+        Context &m_ctx;
+        std::FILE *m_out;
+        uint32_t m_interval_ms;
+        std::atomic<uint64_t> m_written{0};
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        bool m_stop = false; ///< Protected by m_mutex.
+        std::thread m_thread;
+    };
+#endif
+
+}
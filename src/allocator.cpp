@@ -1,40 +1,109 @@
 #include "cell/allocator.h"
 #include "cell/cell.h"
 
-#include "tls_cache.h"
+#include "numa.h"
+#include "os_pages.h"
+#include "tls_slots.h"
 
 #include <array>
 #include <cassert>
+#include <chrono>
+#include <cstddef>
 #include <cstring>
 
-#if defined(_WIN32)
-#include <windows.h>
-#else
-#include <sys/mman.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
 #endif
 
 namespace Cell {
 
-    Allocator::Allocator(void *base, size_t reserved_size) {
-#if defined(_WIN32)
-        // Windows VirtualAlloc has 64KB allocation granularity, which guarantees
-        // 16KB (kCellSize) alignment. No further alignment needed.
-        m_base = base;
-        m_reserved_size = reserved_size;
-#ifndef NDEBUG
-        // Verify our assumption that VirtualAlloc returns aligned addresses
-        auto addr = reinterpret_cast<uintptr_t>(base);
-        assert((addr & (kCellSize - 1)) == 0 && "VirtualAlloc should return 16KB-aligned address");
+    namespace {
+
+        /** @brief Index of the lowest set bit (bits must be non-zero). */
+        inline size_t lowest_bit(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<size_t>(__builtin_ctzll(bits));
+#elif defined(_MSC_VER)
+            unsigned long idx;
+            _BitScanForward64(&idx, bits);
+            return static_cast<size_t>(idx);
+#else
+            size_t idx = 0;
+            while (!(bits & 1)) {
+                bits >>= 1;
+                ++idx;
+            }
+            return idx;
 #endif
+        }
+
+        static_assert(offsetof(FreeCell, next_chain) >= sizeof(CellHeader),
+                      "Free cell links must not overwrite the debug CellHeader fields");
+
+        // A stack head is a chain pointer with an update count in the bits a cell
+        // address leaves clear: the low ones (cell alignment) and, on 64-bit targets
+        // whose user addresses fit in 48 bits, the top 16. The count wraps after
+        // 2^(log2(kCellSize) + 16) updates (2^30 for 16KB cells) there, 2^14 elsewhere.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__aarch64__) || defined(_M_ARM64)
+        constexpr unsigned kHeadAddressBits = 48;
 #else
-        // Linux: mmap might not align to kCellSize, so align manually
+        constexpr unsigned kHeadAddressBits = sizeof(uintptr_t) * 8;
+#endif
+
+        /** @brief Bits of a stack head above the address, part of the version. */
+        constexpr uintptr_t kHeadHighMask =
+            kHeadAddressBits < sizeof(uintptr_t) * 8 ? ~((uintptr_t{1} << kHeadAddressBits) - 1)
+                                                     : 0;
+
+        /** @brief Bits of a stack head that count its updates. */
+        template <typename Policy>
+        constexpr uintptr_t kHeadVersionMask = kHeadHighMask | (PolicyTraits<Policy>::kCellSize - 1);
+
+        /** @brief First chain of a versioned stack head. */
+        template <typename Policy> inline FreeCell *head_chain(uintptr_t head) {
+            return reinterpret_cast<FreeCell *>(head & ~kHeadVersionMask<Policy>);
+        }
+
+        /** @brief Head that replaces head with chain on top, one version later. */
+        template <typename Policy> inline uintptr_t next_head(uintptr_t head, FreeCell *chain) {
+            // Adding 1 to the low bits carries across the address into the high ones
+            uintptr_t version = (head | ~kHeadVersionMask<Policy>) + 1;
+            return reinterpret_cast<uintptr_t>(chain) | (version & kHeadVersionMask<Policy>);
+        }
+
+        /** @brief Takes the older half of a full cache as one chain. */
+        template <typename Policy> FreeCell *take_oldest_chain(TlsCache<Policy> &cache) {
+            constexpr size_t kCount = BasicAllocator<Policy>::kChainLength;
+            for (size_t i = 1; i < kCount; ++i) {
+                cache.cells[i - 1]->next = cache.cells[i];
+            }
+            FreeCell *chain = cache.cells[0];
+            cache.cells[kCount - 1]->next = nullptr;
+            chain->count = kCount;
+
+            cache.count -= kCount;
+            std::memmove(cache.cells, cache.cells + kCount, cache.count * sizeof(FreeCell *));
+            return chain;
+        }
+
+    }
+
+    template <typename Policy>
+    BasicAllocator<Policy>::BasicAllocator(void *base, size_t reserved_size, uint32_t tls_slot,
+                                           uint64_t tls_owner, HugePagePolicy huge_pages,
+                                           size_t numa_nodes)
+        : m_tls_slot(tls_slot), m_tls_owner(tls_owner), m_huge_pages(huge_pages) {
+        // Neither mmap (4KB) nor VirtualAlloc (64KB) aligns to a superblock. Align
+        // manually so each superblock covers exactly one 2MB huge page and whole
+        // superblock decommits never split one.
         auto addr = reinterpret_cast<uintptr_t>(base);
-        auto aligned_addr = (addr + kCellSize - 1) & kCellMask;
+        auto aligned_addr = (addr + kSuperblockSize - 1) & ~(uintptr_t{kSuperblockSize} - 1);
         size_t alignment_offset = aligned_addr - addr;
 
         m_base = reinterpret_cast<void *>(aligned_addr);
         m_reserved_size = reserved_size > alignment_offset ? reserved_size - alignment_offset : 0;
-#endif
+        assert(((aligned_addr + m_reserved_size - 1) & kHeadHighMask) == 0 &&
+               "Cell region must lie below the stack head version bits");
 
         // Calculate number of superblocks we can fit
         m_num_superblocks = m_reserved_size / kSuperblockSize;
@@ -48,32 +117,100 @@ namespace Cell {
             m_superblock_states[i].store(SuperblockState::kUncommitted, std::memory_order_relaxed);
             m_free_cells[i].store(0, std::memory_order_relaxed);
         }
+
+        // Split the superblocks evenly between the node pools; every pool needs at least one
+        m_node_count = numa_nodes > kMaxNumaNodes ? kMaxNumaNodes : numa_nodes;
+        if (m_node_count > m_num_superblocks) {
+            m_node_count = m_num_superblocks;
+        }
+        if (m_node_count == 0) {
+            m_node_count = 1;
+        }
+        m_node_span = m_num_superblocks / m_node_count;
+        for (size_t n = 0; n < m_node_count; ++n) {
+            m_nodes[n].first_superblock = n * m_node_span;
+            m_nodes[n].superblock_count =
+                n + 1 == m_node_count ? m_num_superblocks - n * m_node_span : m_node_span;
+        }
     }
 
-    Allocator::~Allocator() {
-        // Note: We intentionally don't clear t_cache here because on Windows,
+    template <typename Policy>
+    BasicAllocator<Policy>::~BasicAllocator() {
+        // Note: We intentionally don't clear the TLS cell cache here because on Windows,
         // thread-local destructors may run after this destructor, causing issues.
-        // The Context destructor clears the TLS bin caches which is sufficient.
+        // The Context destructor unbinds the calling thread's slot which is sufficient.
+    }
+
+    template <typename Policy>
+    CELL_FORCE_INLINE BasicTlsSlot<Policy> *BasicAllocator<Policy>::tls_slot() {
+        return get_tls_slot<Policy>(m_tls_slot, m_tls_owner);
+    }
+
+    template <typename Policy>
+    CELL_FORCE_INLINE size_t BasicAllocator<Policy>::home_node() const {
+        return m_node_count == 1 ? 0 : current_numa_node() % m_node_count;
+    }
+
+    template <typename Policy>
+    CELL_FORCE_INLINE size_t BasicAllocator<Policy>::node_of(size_t sb_idx) const {
+        if (m_node_count == 1) {
+            return 0;
+        }
+        size_t node = sb_idx / m_node_span;
+        return node < m_node_count ? node : m_node_count - 1;
     }
 
-    void *Allocator::alloc() {
+    template <typename Policy>
+    void *BasicAllocator<Policy>::alloc() {
         void *result = nullptr;
         bool from_pool = false; // Track if from TLS or global (not fresh from OS)
+        size_t home = home_node();
 
         // Tier 1: Try TLS cache first (no locks)
-        if (!t_cache.is_empty()) {
-            result = t_cache.pop();
-            from_pool = true;
-        }
-        // Tier 2: Try global pool (lock-free)
-        else if (FreeCell *cell = pop_global()) {
-            result = cell;
-            from_pool = true;
+        // (never waits on a reclaim: callers may hold the bin lock it needs)
+        TlsSlot *slot = tls_slot();
+        if (slot && try_enter_tls_slot(*slot)) {
+            if (!slot->cells.is_empty()) {
+                result = slot->cells.pop();
+                from_pool = true;
+            } else if (FreeCell *chain = pop_global_chain(home)) {
+                // Tier 2: one CAS takes a whole chain; hand out its first cell, cache the rest
+                result = chain;
+                from_pool = true;
+                FreeCell *cell = chain->next;
+                for (size_t i = 1; i < chain->count; ++i) {
+                    slot->cells.push(cell);
+                    cell = cell->next;
+                }
+            }
+            leave_tls_slot(*slot);
         }
-        // Tier 3: Allocate from OS (count already set in refill_from_os)
-        else {
-            result = refill_from_os();
-            // from_pool stays false - refill_from_os handles accounting
+        if (!result) {
+            // Tier 2 without the cache: take a single cell (lock-free)
+            if (FreeCell *cell = pop_global(home)) {
+                result = cell;
+                from_pool = true;
+            }
+            // Tier 3: Allocate from OS (count already set in refill_from_os)
+            else {
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+                uint64_t latency_start = trace_clock();
+#endif
+                result = refill_from_os(home);
+                // Home node exhausted: borrow from the other nodes, free cells first
+                for (size_t i = 1; i < m_node_count && !result; ++i) {
+                    size_t node = (home + i) % m_node_count;
+                    if (FreeCell *cell = pop_global(node)) {
+                        result = cell;
+                        from_pool = true;
+                    } else {
+                        result = refill_from_os(node);
+                    }
+                }
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+                record_latency(slot, LatencyPath::kCellFromOs, latency_start);
+#endif
+            }
         }
 
         // Track cell allocation for superblock state
@@ -99,7 +236,8 @@ namespace Cell {
         return result;
     }
 
-    void Allocator::free(void *ptr) {
+    template <typename Policy>
+    void BasicAllocator<Policy>::free(void *ptr) {
         if (!ptr)
             return;
 
@@ -117,30 +255,122 @@ namespace Cell {
             uint16_t new_free = m_free_cells[sb_idx].fetch_add(1, std::memory_order_relaxed) + 1;
             // Mark as free if all cells are now free
             if (new_free == kCellsPerSuperblock) {
+                m_free_since[sb_idx].store(monotonic_ms(), std::memory_order_relaxed);
                 m_superblock_states[sb_idx].store(SuperblockState::kFree,
                                                   std::memory_order_relaxed);
             }
         }
 
         auto *cell = static_cast<FreeCell *>(ptr);
+        size_t node = node_of(sb_idx);
+
+        // Tier 1: Return to TLS cache if not full (home-node cells only)
+        TlsSlot *slot = tls_slot();
+        if (slot && try_enter_tls_slot(*slot)) {
+            bool cached = node == home_node();
+            if (cached) {
+                if (slot->cells.is_full()) {
+                    // Hand the older half back in one CAS rather than this cell alone
+                    FreeCell *chain = take_oldest_chain<Policy>(slot->cells);
+                    push_global_chain(node_of(get_superblock_index(chain)), chain, chain);
+                }
+                slot->cells.push(cell);
+            }
+            leave_tls_slot(*slot);
+            if (cached) {
+                return;
+            }
+        }
 
-        // Tier 1: Return to TLS cache if not full
-        if (!t_cache.is_full()) {
-            t_cache.push(cell);
+        // Tier 2: Return to the owning node's global pool
+        push_global(node, cell);
+    }
+
+    template <typename Policy>
+    void BasicAllocator<Policy>::flush_tls_cache() {
+        TlsSlot *slot = find_tls_slot<Policy>(m_tls_slot, m_tls_owner);
+        if (!slot) {
             return;
         }
+        TlsSlotScope scope(slot);
+        flush_tls_cache(slot->cells);
+    }
 
-        // Tier 2: Return to global pool
-        push_global(cell);
+    template <typename Policy>
+    void BasicAllocator<Policy>::flush_tls_cache(TlsCache<Policy> &cache) {
+        // One list per node: the cells are all home-node ones unless the thread moved
+        FreeCell *lists[kMaxNumaNodes] = {};
+        while (!cache.is_empty()) {
+            FreeCell *cell = cache.pop();
+            size_t node = node_of(get_superblock_index(cell));
+            cell->next = lists[node];
+            lists[node] = cell;
+        }
+        for (size_t n = 0; n < m_node_count; ++n) {
+            push_global_cells(n, lists[n]);
+        }
     }
 
-    void Allocator::flush_tls_cache() {
-        while (!t_cache.is_empty()) {
-            push_global(t_cache.pop());
+    template <typename Policy>
+    size_t BasicAllocator<Policy>::prewarm(size_t superblocks, bool populate) {
+        size_t home = home_node();
+        size_t warmed = 0;
+
+        for (; warmed < superblocks; ++warmed) {
+            size_t sb_idx = acquire_superblock(home);
+            if (sb_idx == m_num_superblocks) {
+                break;
+            }
+            auto *base_ptr = static_cast<char *>(m_base) + sb_idx * kSuperblockSize;
+            if (populate) {
+                // Before any cell is published: nothing else can be writing here yet
+                populate_pages(base_ptr, kSuperblockSize);
+            }
+
+            // Every cell goes on the pool. The superblock stays kInUse, so neither
+            // kind of decommit takes it back before its cells have been used.
+            m_free_cells[sb_idx].store(kCellsPerSuperblock, std::memory_order_relaxed);
+            auto *first = reinterpret_cast<FreeCell *>(base_ptr);
+            FreeCell *last = first;
+            for (size_t i = 1; i < kCellsPerSuperblock; ++i) {
+                auto *cell = reinterpret_cast<FreeCell *>(base_ptr + i * kCellSize);
+                last->next = cell;
+                last = cell;
+            }
+            last->next = nullptr;
+            push_global_cells(node_of(sb_idx), first);
         }
+        return warmed * kSuperblockSize;
     }
 
-    size_t Allocator::decommit_unused() {
+    template <typename Policy>
+    size_t BasicAllocator<Policy>::fill_tls_cache() {
+        TlsSlot *slot = tls_slot();
+        if (!slot || !try_enter_tls_slot(*slot)) {
+            return 0;
+        }
+
+        // Whole chains move into the cache; the cells stay counted as free
+        size_t home = home_node();
+        size_t before = slot->cells.count;
+        while (slot->cells.count + kChainLength <= kTlsCacheCapacity) {
+            FreeCell *chain = pop_global_chain(home);
+            if (!chain) {
+                break;
+            }
+            for (size_t i = 0, count = chain->count; i < count; ++i) {
+                FreeCell *next = chain->next;
+                slot->cells.push(chain);
+                chain = next;
+            }
+        }
+        size_t filled = slot->cells.count - before;
+        leave_tls_slot(*slot);
+        return filled;
+    }
+
+    template <typename Policy>
+    size_t BasicAllocator<Policy>::decommit_unused() {
         std::lock_guard<std::mutex> lock(m_decommit_mutex);
         size_t total_freed = 0;
 
@@ -154,39 +384,58 @@ namespace Cell {
             }
         }
 
-        if (any_to_decommit) {
+        // Free cells of partly used superblocks are released one by one
+        const bool purge = m_huge_pages == HugePagePolicy::kNone;
+        FreeCell *purge_list = nullptr;
+
+        if (any_to_decommit || purge) {
             // Cells are stored inline in superblocks. If we decommit a superblock while pointers to
             // its cells remain in the TLS cache or global pool, the next alloc/pop will touch
             // decommitted memory and crash. Purge any free-list entries belonging to superblocks
-            // we're about to decommit.
+            // we're about to decommit, and collect the rest when they are to be purged.
 
             // Current thread TLS cache.
-            while (!t_cache.is_empty()) {
-                FreeCell *cell = t_cache.pop();
-                size_t sb_idx = get_superblock_index(cell);
-                if (sb_idx < m_num_superblocks && decommit_mask[sb_idx]) {
-                    continue; // drop
+            if (TlsSlot *slot = find_tls_slot<Policy>(m_tls_slot, m_tls_owner)) {
+                TlsSlotScope scope(slot);
+                FreeCell *keep[kMaxNumaNodes] = {};
+                while (!slot->cells.is_empty()) {
+                    FreeCell *cell = slot->cells.pop();
+                    size_t sb_idx = get_superblock_index(cell);
+                    if (sb_idx < m_num_superblocks && decommit_mask[sb_idx]) {
+                        continue; // drop
+                    }
+                    FreeCell *&list = purge ? purge_list : keep[node_of(sb_idx)];
+                    cell->next = list;
+                    list = cell;
+                }
+                for (size_t n = 0; n < m_node_count; ++n) {
+                    push_global_cells(n, keep[n]);
                 }
-                push_global(cell);
             }
 
-            // Global pool.
-            FreeCell *head = m_global_head.exchange(nullptr, std::memory_order_acq_rel);
-            FreeCell *keep_head = nullptr;
-
-            while (head) {
-                FreeCell *next = head->next;
-                size_t sb_idx = get_superblock_index(head);
-                if (sb_idx < m_num_superblocks && decommit_mask[sb_idx]) {
-                    // drop
-                } else {
-                    head->next = keep_head;
-                    keep_head = head;
+            // Global pools.
+            for (size_t n = 0; n < m_node_count; ++n) {
+                FreeCell *head = take_global(n);
+                FreeCell *keep_head = nullptr;
+
+                while (head) {
+                    FreeCell *next = head->next;
+                    size_t sb_idx = get_superblock_index(head);
+                    if (sb_idx < m_num_superblocks && decommit_mask[sb_idx]) {
+                        // drop
+                    } else if (purge) {
+                        head->next = purge_list;
+                        purge_list = head;
+                    } else {
+                        head->next = keep_head;
+                        keep_head = head;
+                    }
+                    head = next;
                 }
-                head = next;
-            }
 
-            m_global_head.store(keep_head, std::memory_order_release);
+                // Splice rather than store: cells freed while we walked the list are kept
+                push_global_cells(n, keep_head);
+            }
         }
 
         for (size_t i = 0; i < m_num_superblocks; ++i) {
@@ -195,46 +444,210 @@ namespace Cell {
             }
 
             void *sb_addr = static_cast<char *>(m_base) + i * kSuperblockSize;
+            size_t resident = resident_bytes(i);
 
-#if defined(_WIN32)
-            if (VirtualFree(sb_addr, kSuperblockSize, MEM_DECOMMIT)) {
+            if (decommit_pages(sb_addr, kSuperblockSize, m_huge_pages)) {
+                forget_purged(i);
+                // Release: whoever recommits it next must see our writes to its cells
                 m_superblock_states[i].store(SuperblockState::kDecommitted,
-                                             std::memory_order_relaxed);
-                total_freed += kSuperblockSize;
+                                             std::memory_order_release);
+                total_freed += resident;
             } else {
-                // Decommit failed: rebuild the free list for this fully-free superblock.
+                // Decommit failed: rebuild the free list for this fully-free superblock
+                // from the cells that still have their pages.
                 auto *base_ptr = static_cast<char *>(sb_addr);
-                for (size_t j = 0; j < kCellsPerSuperblock; ++j) {
+                FreeCell *list = nullptr;
+                for (size_t j = kCellsPerSuperblock; j-- > 0;) {
+                    if (m_purged[i][j / 64] & (uint64_t{1} << (j % 64))) {
+                        continue;
+                    }
                     auto *cell = reinterpret_cast<FreeCell *>(base_ptr + j * kCellSize);
-                    push_global(cell);
+                    cell->next = list;
+                    list = cell;
                 }
+                push_global_cells(node_of(i), list);
             }
-#else
-            if (madvise(sb_addr, kSuperblockSize, MADV_DONTNEED) == 0) {
-                m_superblock_states[i].store(SuperblockState::kDecommitted,
-                                             std::memory_order_relaxed);
-                total_freed += kSuperblockSize;
+        }
+
+        while (purge_list) {
+            FreeCell *next = purge_list->next;
+            if (purge_cell(purge_list)) {
+                total_freed += kCellSize;
             } else {
-                // Best-effort on Linux: keep the block committed; free list entries remain valid.
+                push_global(node_of(get_superblock_index(purge_list)), purge_list);
             }
-#endif
+            purge_list = next;
+        }
+
+        return total_freed;
+    }
+
+    template <typename Policy>
+    size_t BasicAllocator<Policy>::scavenge(uint32_t decay_ms, uint64_t budget_ns, bool lazy) {
+        std::unique_lock<std::mutex> lock(m_decommit_mutex, std::try_to_lock);
+        if (!lock.owns_lock() || m_num_superblocks == 0) {
+            return 0;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const uint32_t now = monotonic_ms();
+
+        // Only superblocks claimed from some pool can ever have been free
+        size_t limit = 0;
+        for (size_t n = 0; n < m_node_count; ++n) {
+            limit += m_nodes[n].claimed.load(std::memory_order_acquire);
+        }
+        if (limit == 0) {
+            return 0;
+        }
+
+        size_t candidates[kScavengeBatchLimit];
+        size_t candidate_count = 0;
+        size_t scan = limit < kScavengeScanLimit ? limit : kScavengeScanLimit;
+
+        for (size_t n = 0; n < scan && candidate_count < kScavengeBatchLimit; ++n) {
+            size_t i = claimed_superblock(m_scavenge_cursor++ % limit);
+            if (m_superblock_states[i].load(std::memory_order_relaxed) == SuperblockState::kFree &&
+                now - m_free_since[i].load(std::memory_order_relaxed) >= decay_ms) {
+                candidates[candidate_count++] = i;
+            }
+        }
+        if (candidate_count == 0) {
+            return 0;
+        }
+
+        // Pull the candidates' cells off their pools, keeping everything else in order
+        FreeCell *taken[kScavengeBatchLimit] = {};
+        size_t taken_count[kScavengeBatchLimit] = {};
+
+        for (size_t n = 0; n < m_node_count; ++n) {
+            bool has_candidate = false;
+            for (size_t k = 0; k < candidate_count; ++k) {
+                has_candidate |= node_of(candidates[k]) == n;
+            }
+            if (!has_candidate) {
+                continue;
+            }
+
+            FreeCell *keep_head = nullptr;
+            FreeCell *keep_tail = nullptr;
+
+            FreeCell *head = take_global(n);
+            while (head) {
+                FreeCell *next = head->next;
+                size_t sb_idx = get_superblock_index(head);
+
+                size_t k = 0;
+                while (k < candidate_count && candidates[k] != sb_idx) {
+                    ++k;
+                }
+
+                if (k < candidate_count) {
+                    head->next = taken[k];
+                    taken[k] = head;
+                    ++taken_count[k];
+                } else {
+                    head->next = nullptr;
+                    if (keep_tail) {
+                        keep_tail->next = head;
+                    } else {
+                        keep_head = head;
+                    }
+                    keep_tail = head;
+                }
+                head = next;
+            }
+            push_global_cells(n, keep_head);
+        }
+
+        size_t total_freed = 0;
+        for (size_t k = 0; k < candidate_count; ++k) {
+            if (!taken[k]) {
+                continue;
+            }
+
+            size_t i = candidates[k];
+            void *sb_addr = static_cast<char *>(m_base) + i * kSuperblockSize;
+            uint64_t elapsed = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count());
+
+            // With every cell in hand (or purged) nothing else can reach this superblock
+            size_t resident = resident_bytes(i);
+            if (taken_count[k] + m_purged_cells[i].load(std::memory_order_relaxed) ==
+                    kCellsPerSuperblock &&
+                elapsed < budget_ns &&
+                m_superblock_states[i].load(std::memory_order_relaxed) == SuperblockState::kFree &&
+                decommit_pages(sb_addr, kSuperblockSize, m_huge_pages, lazy)) {
+                forget_purged(i);
+                // Release: pairs with the acq_rel claim in recommit_superblock()
+                m_superblock_states[i].store(SuperblockState::kDecommitted,
+                                             std::memory_order_release);
+                total_freed += resident;
+                continue;
+            }
+
+            // Some cells are cached elsewhere, we ran out of time, or decommit failed
+            push_global_cells(node_of(i), taken[k]);
         }
 
         return total_freed;
     }
 
-    size_t Allocator::committed_bytes() const {
+    template <typename Policy>
+    size_t BasicAllocator<Policy>::committed_bytes() const {
         size_t committed = 0;
         for (size_t i = 0; i < m_num_superblocks; ++i) {
-            SuperblockState state = m_superblock_states[i].load(std::memory_order_relaxed);
-            if (state == SuperblockState::kInUse || state == SuperblockState::kFree) {
-                committed += kSuperblockSize;
-            }
+            committed += resident_bytes(i);
+        }
+        return committed;
+    }
+
+    template <typename Policy>
+    size_t BasicAllocator<Policy>::node_committed_bytes(size_t node) const {
+        if (node >= m_node_count) {
+            return 0;
+        }
+        const NodePool &pool = m_nodes[node];
+        size_t end = pool.first_superblock + pool.claimed.load(std::memory_order_relaxed);
+        size_t committed = 0;
+        for (size_t i = pool.first_superblock; i < end; ++i) {
+            committed += resident_bytes(i);
         }
         return committed;
     }
 
-    size_t Allocator::get_superblock_index(void *ptr) const {
+    template <typename Policy>
+    size_t BasicAllocator<Policy>::node_cells_in_use(size_t node) const {
+        if (node >= m_node_count) {
+            return 0;
+        }
+        const NodePool &pool = m_nodes[node];
+        size_t end = pool.first_superblock + pool.claimed.load(std::memory_order_relaxed);
+        size_t in_use = 0;
+        for (size_t i = pool.first_superblock; i < end; ++i) {
+            if (m_superblock_states[i].load(std::memory_order_relaxed) == SuperblockState::kInUse) {
+                in_use += kCellsPerSuperblock - m_free_cells[i].load(std::memory_order_relaxed);
+            }
+        }
+        return in_use;
+    }
+
+    template <typename Policy>
+    void BasicAllocator<Policy>::superblock_state_counts(
+        size_t (&counts)[kSuperblockStateCount]) const {
+        for (size_t &count : counts) {
+            count = 0;
+        }
+        for (size_t i = 0; i < m_num_superblocks; ++i) {
+            auto state = m_superblock_states[i].load(std::memory_order_relaxed);
+            ++counts[static_cast<size_t>(state)];
+        }
+    }
+
+    template <typename Policy>
+    size_t BasicAllocator<Policy>::get_superblock_index(void *ptr) const {
         auto addr = reinterpret_cast<uintptr_t>(ptr);
         auto base_addr = reinterpret_cast<uintptr_t>(m_base);
         if (addr < base_addr)
@@ -242,116 +655,315 @@ namespace Cell {
         return (addr - base_addr) / kSuperblockSize;
     }
 
-    bool Allocator::recommit_superblock(size_t index) {
+    template <typename Policy>
+    size_t BasicAllocator<Policy>::claimed_superblock(size_t ordinal) const {
+        for (size_t n = 0; n + 1 < m_node_count; ++n) {
+            size_t claimed = m_nodes[n].claimed.load(std::memory_order_relaxed);
+            if (ordinal < claimed) {
+                return m_nodes[n].first_superblock + ordinal;
+            }
+            ordinal -= claimed;
+        }
+        return m_nodes[m_node_count - 1].first_superblock + ordinal;
+    }
+
+    template <typename Policy>
+    bool BasicAllocator<Policy>::recommit_superblock(size_t index) {
         if (index >= m_num_superblocks)
             return false;
-        if (m_superblock_states[index].load(std::memory_order_relaxed) !=
-            SuperblockState::kDecommitted)
-            return true;
 
-        void *sb_addr = static_cast<char *>(m_base) + index * kSuperblockSize;
-
-#if defined(_WIN32)
-        if (!VirtualAlloc(sb_addr, kSuperblockSize, MEM_COMMIT, PAGE_READWRITE)) {
+        // Claim it first so two refilling threads never carve the same superblock
+        SuperblockState expected = SuperblockState::kDecommitted;
+        if (!m_superblock_states[index].compare_exchange_strong(
+                expected, SuperblockState::kInUse, std::memory_order_acq_rel,
+                std::memory_order_relaxed)) {
             return false;
         }
-#else
-        if (mprotect(sb_addr, kSuperblockSize, PROT_READ | PROT_WRITE) != 0) {
+
+        void *sb_addr = static_cast<char *>(m_base) + index * kSuperblockSize;
+        if (!commit_pages(sb_addr, kSuperblockSize, m_huge_pages)) {
+            m_superblock_states[index].store(SuperblockState::kDecommitted,
+                                             std::memory_order_relaxed);
             return false;
         }
-#endif
-
-        m_superblock_states[index].store(SuperblockState::kInUse, std::memory_order_relaxed);
+        if (m_node_count > 1) {
+            bind_to_numa_node(sb_addr, kSuperblockSize, static_cast<uint32_t>(node_of(index)));
+        }
         return true;
     }
 
-    void *Allocator::refill_from_global() { return pop_global(); }
+    template <typename Policy>
+    size_t BasicAllocator<Policy>::resident_bytes(size_t sb_idx) const {
+        SuperblockState state = m_superblock_states[sb_idx].load(std::memory_order_relaxed);
+        if (state != SuperblockState::kInUse && state != SuperblockState::kFree) {
+            return 0;
+        }
+        return kSuperblockSize -
+               m_purged_cells[sb_idx].load(std::memory_order_relaxed) * kCellSize;
+    }
 
-    void *Allocator::refill_from_os() {
-        // Find the next uncommitted superblock
-        size_t sb_idx = m_committed_end.load(std::memory_order_relaxed) / kSuperblockSize;
+    template <typename Policy>
+    bool BasicAllocator<Policy>::purge_cell(FreeCell *cell) {
+        size_t sb_idx = get_superblock_index(cell);
+        auto offset = static_cast<size_t>(reinterpret_cast<char *>(cell) -
+                                          static_cast<char *>(m_base));
+        size_t cell_idx = (offset - sb_idx * kSuperblockSize) / kCellSize;
+        uint64_t bit = uint64_t{1} << (cell_idx % 64);
+        assert(!(m_purged[sb_idx][cell_idx / 64] & bit) && "Purged cell found on a free list");
 
-        // Check if we need to recommit a decommitted superblock first
-        // (This handles the case where we decommitted and need to reuse)
-        for (size_t i = 0; i < m_num_superblocks; ++i) {
-            if (m_superblock_states[i].load(std::memory_order_relaxed) ==
-                SuperblockState::kDecommitted) {
-                if (recommit_superblock(i)) {
-                    // Re-carve this superblock
-                    void *sb_addr = static_cast<char *>(m_base) + i * kSuperblockSize;
-                    auto *base_ptr = static_cast<char *>(sb_addr);
-
-                    // Reset free count (we're about to hand out all cells)
-                    m_free_cells[i].store(kCellsPerSuperblock - 1, std::memory_order_relaxed);
-
-                    for (size_t j = 1; j < kCellsPerSuperblock; ++j) {
-                        auto *cell = reinterpret_cast<FreeCell *>(base_ptr + j * kCellSize);
-                        push_global(cell);
-                    }
+        if (!decommit_pages(cell, kCellSize, m_huge_pages)) {
+            return false;
+        }
+        m_purged[sb_idx][cell_idx / 64] |= bit;
+        m_purged_cells[sb_idx].fetch_add(1, std::memory_order_relaxed);
+        m_purged_total.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
 
-                    return sb_addr;
+    template <typename Policy>
+    size_t BasicAllocator<Policy>::forget_purged(size_t sb_idx) {
+        size_t count = m_purged_cells[sb_idx].load(std::memory_order_relaxed);
+        if (count == 0) {
+            return 0;
+        }
+        for (uint64_t &word : m_purged[sb_idx]) {
+            word = 0;
+        }
+        m_purged_cells[sb_idx].store(0, std::memory_order_relaxed);
+        m_purged_total.fetch_sub(count, std::memory_order_relaxed);
+        return count;
+    }
+
+    template <typename Policy>
+    void *BasicAllocator<Policy>::take_purged_cell(size_t node) {
+        if (m_purged_total.load(std::memory_order_relaxed) == 0) {
+            return nullptr;
+        }
+        // Never waits on a decommit: callers may hold a bin lock, and carving fresh
+        // cells is the better fallback anyway
+        std::unique_lock<std::mutex> lock(m_decommit_mutex, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            return nullptr;
+        }
+
+        // Densest superblock first, so the sparse ones drain. Taking a cell only makes
+        // the previous choice denser, so stay with it until its purged cells run out.
+        const NodePool &pool = m_nodes[node];
+        size_t first = pool.first_superblock;
+        size_t end = first + pool.claimed.load(std::memory_order_acquire);
+        size_t sb_idx = m_purge_hint;
+        if (sb_idx < first || sb_idx >= end ||
+            m_purged_cells[sb_idx].load(std::memory_order_relaxed) == 0) {
+            sb_idx = end;
+            size_t fewest_free = kCellsPerSuperblock + 1;
+            for (size_t i = first; i < end; ++i) {
+                if (m_purged_cells[i].load(std::memory_order_relaxed) == 0) {
+                    continue;
+                }
+                size_t free_cells = m_free_cells[i].load(std::memory_order_relaxed);
+                if (free_cells < fewest_free) {
+                    fewest_free = free_cells;
+                    sb_idx = i;
                 }
             }
+            if (sb_idx == end) {
+                return nullptr;
+            }
+            m_purge_hint = sb_idx;
         }
 
-        // Atomically claim a new superblock
-        size_t current_end = m_committed_end.load(std::memory_order_relaxed);
-        size_t new_end;
+        size_t word = 0;
+        while (m_purged[sb_idx][word] == 0) {
+            ++word;
+        }
+        size_t cell_idx = word * 64 + lowest_bit(m_purged[sb_idx][word]);
+        void *cell = static_cast<char *>(m_base) + sb_idx * kSuperblockSize + cell_idx * kCellSize;
+        if (!commit_pages(cell, kCellSize, m_huge_pages)) {
+            return nullptr;
+        }
 
+        m_purged[sb_idx][word] &= ~(uint64_t{1} << (cell_idx % 64));
+        m_purged_cells[sb_idx].fetch_sub(1, std::memory_order_relaxed);
+        m_purged_total.fetch_sub(1, std::memory_order_relaxed);
+        uint16_t old_free = m_free_cells[sb_idx].fetch_sub(1, std::memory_order_relaxed);
+        if (old_free == kCellsPerSuperblock) {
+            m_superblock_states[sb_idx].store(SuperblockState::kInUse, std::memory_order_relaxed);
+        }
+        return cell;
+    }
+
+    template <typename Policy>
+    void *BasicAllocator<Policy>::refill_from_os(size_t node) {
+        // Purged cells first: they cost a few page faults, a superblock costs 2MB
+        if (void *cell = take_purged_cell(node)) {
+            return cell;
+        }
+
+        size_t sb_idx = acquire_superblock(node);
+        if (sb_idx == m_num_superblocks) {
+            return nullptr;
+        }
+        return carve_superblock(sb_idx);
+    }
+
+    template <typename Policy>
+    size_t BasicAllocator<Policy>::acquire_superblock(size_t node) {
+        NodePool &pool = m_nodes[node];
+        size_t claimed = pool.claimed.load(std::memory_order_acquire);
+
+        // Reuse a decommitted superblock of this pool before claiming a new one
+        for (size_t i = pool.first_superblock; i < pool.first_superblock + claimed; ++i) {
+            if (m_superblock_states[i].load(std::memory_order_relaxed) ==
+                    SuperblockState::kDecommitted &&
+                recommit_superblock(i)) {
+                return i;
+            }
+        }
+
+        // Atomically claim a new superblock
         do {
-            new_end = current_end + kSuperblockSize;
-            if (new_end > m_reserved_size) {
-                return nullptr;
+            if (claimed >= pool.superblock_count) {
+                return m_num_superblocks;
             }
-        } while (!m_committed_end.compare_exchange_weak(
-            current_end, new_end, std::memory_order_acq_rel, std::memory_order_relaxed));
+        } while (!pool.claimed.compare_exchange_weak(claimed, claimed + 1,
+                                                     std::memory_order_acq_rel,
+                                                     std::memory_order_relaxed));
 
-        sb_idx = current_end / kSuperblockSize;
-        void *superblock_start = static_cast<char *>(m_base) + current_end;
+        size_t sb_idx = pool.first_superblock + claimed;
+        void *superblock_start = static_cast<char *>(m_base) + sb_idx * kSuperblockSize;
 
-#if defined(_WIN32)
-        if (!VirtualAlloc(superblock_start, kSuperblockSize, MEM_COMMIT, PAGE_READWRITE)) {
-            return nullptr;
+        if (!commit_pages(superblock_start, kSuperblockSize, m_huge_pages)) {
+            return m_num_superblocks;
         }
-#else
-        if (mprotect(superblock_start, kSuperblockSize, PROT_READ | PROT_WRITE) != 0) {
-            return nullptr;
+        if (m_node_count > 1) {
+            // Before the carve touches the first page of every cell
+            bind_to_numa_node(superblock_start, kSuperblockSize, static_cast<uint32_t>(node));
         }
-#endif
 
         // Mark superblock as in-use
         m_superblock_states[sb_idx].store(SuperblockState::kInUse, std::memory_order_relaxed);
-        m_free_cells[sb_idx].store(kCellsPerSuperblock - 1, std::memory_order_relaxed);
+        return sb_idx;
+    }
+
+    template <typename Policy>
+    void *BasicAllocator<Policy>::carve_superblock(size_t sb_idx) {
+        auto *base_ptr = static_cast<char *>(m_base) + sb_idx * kSuperblockSize;
 
-        // Carve superblock into cells, push all but one to global pool
-        auto *base_ptr = static_cast<char *>(superblock_start);
+        // We're about to hand out cell 0
+        m_free_cells[sb_idx].store(kCellsPerSuperblock - 1, std::memory_order_relaxed);
+        if (kCellsPerSuperblock == 1) {
+            return base_ptr;
+        }
 
-        for (size_t i = 1; i < kCellsPerSuperblock; ++i) {
+        // Link cells 1..N-1 in address order and publish them with a single CAS
+        auto *first = reinterpret_cast<FreeCell *>(base_ptr + kCellSize);
+        FreeCell *last = first;
+        for (size_t i = 2; i < kCellsPerSuperblock; ++i) {
             auto *cell = reinterpret_cast<FreeCell *>(base_ptr + i * kCellSize);
-            push_global(cell);
+            last->next = cell;
+            last = cell;
         }
+        last->next = nullptr;
+        push_global_cells(node_of(sb_idx), first);
+
+        return base_ptr;
+    }
 
-        return superblock_start;
+    template <typename Policy>
+    void BasicAllocator<Policy>::push_global(size_t node, FreeCell *c) {
+        c->next = nullptr;
+        c->count = 1;
+        push_global_chain(node, c, c);
     }
 
-    void Allocator::push_global(FreeCell *c) {
-        FreeCell *old_head = m_global_head.load(std::memory_order_relaxed);
+    template <typename Policy>
+    void BasicAllocator<Policy>::push_global_chain(size_t node, FreeCell *first, FreeCell *last) {
+        std::atomic<uintptr_t> &head = m_nodes[node].head;
+        uintptr_t old_head = head.load(std::memory_order_relaxed);
         do {
-            c->next = old_head;
-        } while (!m_global_head.compare_exchange_weak(old_head, c, std::memory_order_release,
-                                                      std::memory_order_relaxed));
+            last->next_chain = head_chain<Policy>(old_head);
+        } while (!head.compare_exchange_weak(old_head, next_head<Policy>(old_head, first),
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed));
+    }
+
+    template <typename Policy>
+    void BasicAllocator<Policy>::push_global_cells(size_t node, FreeCell *list) {
+        if (!list) {
+            return;
+        }
+
+        // Cut the list into chains, link them up and publish them all with one CAS
+        FreeCell *chain = list;
+        FreeCell *last = nullptr;
+        while (chain) {
+            FreeCell *tail = chain;
+            size_t count = 1;
+            while (count < kChainLength && tail->next) {
+                tail = tail->next;
+                ++count;
+            }
+            FreeCell *rest = tail->next;
+            tail->next = nullptr;
+            chain->count = count;
+            chain->next_chain = rest;
+            last = chain;
+            chain = rest;
+        }
+        push_global_chain(node, list, last);
     }
 
-    FreeCell *Allocator::pop_global() {
-        FreeCell *old_head = m_global_head.load(std::memory_order_acquire);
-        while (old_head) {
-            FreeCell *new_head = old_head->next;
-            if (m_global_head.compare_exchange_weak(old_head, new_head, std::memory_order_acq_rel,
-                                                    std::memory_order_acquire)) {
-                return old_head;
+    template <typename Policy>
+    FreeCell *BasicAllocator<Policy>::pop_global_chain(size_t node) {
+        std::atomic<uintptr_t> &head = m_nodes[node].head;
+        uintptr_t old_head = head.load(std::memory_order_acquire);
+        while (FreeCell *chain = head_chain<Policy>(old_head)) {
+            // next_chain may be stale if another thread took the chain first; the
+            // version moved on with it, so the CAS fails and we retry
+            if (head.compare_exchange_weak(old_head, next_head<Policy>(old_head, chain->next_chain),
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+                return chain;
             }
         }
         return nullptr;
     }
 
+    template <typename Policy>
+    FreeCell *BasicAllocator<Policy>::pop_global(size_t node) {
+        FreeCell *chain = pop_global_chain(node);
+        if (chain && chain->count > 1) {
+            FreeCell *rest = chain->next;
+            rest->count = chain->count - 1;
+            push_global_chain(node, rest, rest);
+        }
+        return chain;
+    }
+
+    template <typename Policy>
+    FreeCell *BasicAllocator<Policy>::take_global(size_t node) {
+        std::atomic<uintptr_t> &head = m_nodes[node].head;
+        uintptr_t old_head = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(old_head, next_head<Policy>(old_head, nullptr),
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_relaxed)) {
+        }
+
+        // Join the chains into a single list
+        FreeCell *list = head_chain<Policy>(old_head);
+        for (FreeCell *chain = list; chain;) {
+            FreeCell *next_chain = chain->next_chain;
+            FreeCell *tail = chain;
+            for (size_t i = 1; i < chain->count; ++i) {
+                tail = tail->next;
+            }
+            tail->next = next_chain;
+            chain = next_chain;
+        }
+        return list;
+    }
+
+    template class BasicAllocator<DefaultPolicy>;
+    template class BasicAllocator<LargeCellPolicy>;
+
 }
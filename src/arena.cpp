@@ -11,6 +11,9 @@ namespace Cell {
 
     Arena::Arena(Context &ctx, uint8_t tag) : m_ctx(ctx), m_tag(tag) {}
 
+    Arena::Arena(Context &ctx, const ArenaConfig &config, uint8_t tag)
+        : m_ctx(ctx), m_config(config), m_tag(tag) {}
+
     Arena::~Arena() { release(); }
 
     // =========================================================================
@@ -22,51 +25,72 @@ namespace Cell {
             return nullptr;
         }
 
-        // Handle large allocations (> cell capacity)
-        if (size > kUsablePerCell) {
-            // Route to full-cell allocation from context
-            // For very large allocations, this will use multiple cells or direct OS
-            return m_ctx.alloc_bytes(size, m_tag, alignment);
+        void *result = bump(size, alignment);
+        if (CELL_LIKELY(result)) {
+            m_total_allocated += size;
+            return result;
         }
 
-        // Ensure we have a cell
-        if (!m_head && !grow()) {
-            return nullptr;
+        // Chunk space starts 16-byte aligned; anything a fresh cell chunk cannot
+        // hold at the worst-case padding gets its own block from the context
+        size_t max_padding = alignment > 16 ? alignment - 16 : 0;
+        if (size > kUsablePerCell || max_padding > kUsablePerCell - size) {
+            return alloc_oversize(size, alignment);
         }
 
-        // Calculate the actual address and align it
-        char *usable = get_usable_start(m_head);
-        char *current_ptr = usable + m_offset;
+        if (!advance()) {
+            return nullptr;
+        }
+        result = bump(size, alignment);
+        assert(result && "Every chunk holds at least a cell's usable space");
+        m_total_allocated += size;
+        return result;
+    }
 
-        // Align the actual address, not just the offset
-        uintptr_t addr = reinterpret_cast<uintptr_t>(current_ptr);
+    void *Arena::bump(size_t size, size_t alignment) {
+        // With no chunk yet both pointers are null, which fails the size check
+        auto addr = reinterpret_cast<uintptr_t>(m_ptr);
         uintptr_t aligned_addr = (addr + alignment - 1) & ~(alignment - 1);
-        size_t padding = aligned_addr - addr;
-        size_t aligned_offset = m_offset + padding;
+        auto end = reinterpret_cast<uintptr_t>(m_end);
 
-        // Check if current cell has enough space
-        if (aligned_offset + size > kUsablePerCell) {
-            // Need a new cell
-            if (!grow()) {
-                return nullptr;
-            }
-            // Recalculate for new cell
-            usable = get_usable_start(m_head);
-            current_ptr = usable; // offset is 0 after grow()
+        if (CELL_UNLIKELY(aligned_addr > end || size > end - aligned_addr)) {
+            return nullptr;
+        }
 
-            addr = reinterpret_cast<uintptr_t>(current_ptr);
-            aligned_addr = (addr + alignment - 1) & ~(alignment - 1);
-            padding = aligned_addr - addr;
-            aligned_offset = padding;
+        m_ptr = reinterpret_cast<char *>(aligned_addr + size);
+        return reinterpret_cast<void *>(aligned_addr);
+    }
+
+    void *Arena::alloc_oversize(size_t size, size_t alignment) {
+        void *ptr = alignment > 16 ? m_ctx.alloc_aligned(size, alignment, m_tag)
+                                   : m_ctx.alloc_bytes(size, m_tag, alignment);
+        if (!ptr) {
+            return nullptr;
         }
 
-        // Allocate from current cell
-        void *result = reinterpret_cast<void *>(aligned_addr);
+        // The record lives in the arena, so a marker rollback discards it with the block
+        auto *record = static_cast<Oversize *>(bump(sizeof(Oversize), alignof(Oversize)));
+        if (!record && advance()) {
+            record = static_cast<Oversize *>(bump(sizeof(Oversize), alignof(Oversize)));
+        }
+        if (!record) {
+            m_ctx.free_bytes(ptr);
+            return nullptr;
+        }
 
-        m_offset = aligned_offset + size;
+        record->ptr = ptr;
+        record->next = m_oversize;
+        m_oversize = record;
         m_total_allocated += size;
+        return ptr;
+    }
 
-        return result;
+    void Arena::free_oversize(Oversize *until) {
+        while (m_oversize != until) {
+            Oversize *record = m_oversize;
+            m_oversize = record->next;
+            m_ctx.free_bytes(record->ptr);
+        }
     }
 
     // =========================================================================
@@ -74,63 +98,44 @@ namespace Cell {
     // =========================================================================
 
     void Arena::reset() {
-        // Keep all cells, just reset allocation state
-        if (m_head) {
-            // Walk to the first cell (oldest)
-            CellData *first = m_head;
-            while (get_link(first)->next) {
-                first = reinterpret_cast<CellData *>(get_link(first)->next);
+        free_oversize(nullptr);
+
+        // Keep chunks, oldest first, as long as they fit the retention budget
+        Chunk *chunk = m_first;
+        m_first = nullptr;
+        m_last = nullptr;
+        m_chunk_count = 0;
+        m_reserved_bytes = 0;
+        while (chunk) {
+            Chunk *next = chunk->next;
+            if (chunk->footprint <= m_config.retain_bytes - m_reserved_bytes) {
+                append_chunk(chunk);
+            } else {
+                free_chunk(chunk);
             }
-
-            // Now first is the oldest cell - but we want the first allocated
-            // Actually, our list is newest-first, so walk backwards
-            // Let's just reset to head but set offset to 0
+            chunk = next;
         }
 
-        m_offset = 0;
-        m_current_cell_index = 0;
+        set_current(m_first, m_first ? get_usable_start(m_first) : nullptr);
         m_total_allocated = 0;
-
-        // Reset to first cell if we have multiple
-        if (m_head && m_cell_count > 1) {
-            // Find the first (oldest) cell
-            CellData *current = m_head;
-
-            while (current) {
-                CellLink *link = get_link(current);
-                if (!link->next) {
-                    // This is the last in the chain (first allocated)
-                    break;
-                }
-                current = link->next;
-            }
-
-            // current is now the first allocated cell
-            // But our design has newest first, so m_head is where we should allocate
-            // For reset, we just need to reset offset; cells stay linked
-        }
-
-        // Simpler approach: just reset offset on current head
-        // On next alloc, it will fill from start
-        m_offset = 0;
-        m_current_cell_index = m_cell_count > 0 ? m_cell_count - 1 : 0;
     }
 
     void Arena::release() {
-        // Return all cells to context
-        CellData *current = m_head;
-        while (current) {
-            CellLink *link = get_link(current);
-            CellData *next = link->next;
-
-            m_ctx.free_cell(current);
-            current = next;
+        free_oversize(nullptr);
+
+        // Return all chunks to context
+        Chunk *chunk = m_first;
+        while (chunk) {
+            Chunk *next = chunk->next;
+            free_chunk(chunk);
+            chunk = next;
         }
 
-        m_head = nullptr;
-        m_offset = 0;
-        m_cell_count = 0;
-        m_current_cell_index = 0;
+        m_first = nullptr;
+        m_last = nullptr;
+        set_current(nullptr, nullptr);
+        m_chunk_count = 0;
+        m_reserved_bytes = 0;
         m_total_allocated = 0;
     }
 
@@ -139,24 +144,17 @@ namespace Cell {
     // =========================================================================
 
     Arena::Marker Arena::save() const {
-        return Marker{m_current_cell_index, m_offset, m_total_allocated};
+        return Marker{m_current, m_ptr, m_total_allocated, m_oversize};
     }
 
     void Arena::reset_to_marker(Marker marker) {
-        assert(marker.cell_index <= m_current_cell_index && "Invalid marker");
+        assert((marker.chunk != m_current || marker.ptr <= m_ptr) && "Invalid marker offset");
 
-        if (marker.cell_index == m_current_cell_index) {
-            // Same cell, just adjust offset
-            assert(marker.offset <= m_offset && "Invalid marker offset");
-        }
+        free_oversize(marker.oversize);
 
-        // Reset to marker state
-        m_offset = marker.offset;
-        m_current_cell_index = marker.cell_index;
+        // Chunks after the marker stay linked and are reused in order
+        set_current(marker.chunk, marker.ptr);
         m_total_allocated = marker.total_allocated;
-
-        // Note: Cells are not released back to context - they're kept for reuse.
-        // The linked list remains intact, we just reset the allocation point.
     }
 
     // =========================================================================
@@ -166,56 +164,95 @@ namespace Cell {
     size_t Arena::bytes_allocated() const { return m_total_allocated; }
 
     size_t Arena::bytes_remaining() const {
-        if (!m_head)
-            return 0;
-        return kUsablePerCell - m_offset;
+        return static_cast<size_t>(m_end - m_ptr);
     }
 
-    size_t Arena::cell_count() const { return m_cell_count; }
+    size_t Arena::bytes_reserved() const { return m_reserved_bytes; }
+
+    size_t Arena::cell_count() const { return m_chunk_count; }
 
     // =========================================================================
     // Internal Methods
     // =========================================================================
 
-    char *Arena::get_usable_start(CellData *cell) {
-        // Usable space starts after CellHeader + CellMetadata + CellLink
-        char *base = reinterpret_cast<char *>(cell);
-        return base + kBlockStartOffset + sizeof(CellLink);
+    char *Arena::get_usable_start(Chunk *chunk) {
+        return reinterpret_cast<char *>(chunk) + kChunkHeaderSize;
     }
 
-    Arena::CellLink *Arena::get_link(CellData *cell) {
-        // CellLink is stored right after CellHeader + CellMetadata (at kBlockStartOffset)
-        char *base = reinterpret_cast<char *>(cell);
-        return reinterpret_cast<CellLink *>(base + kBlockStartOffset);
+    bool Arena::advance() {
+        Chunk *next = m_current ? m_current->next : m_first;
+        if (!next) {
+            if (!grow()) {
+                return false;
+            }
+            next = m_last;
+        }
+
+        set_current(next, get_usable_start(next));
+        return true;
+    }
+
+    void Arena::set_current(Chunk *chunk, char *ptr) {
+        m_current = chunk;
+        m_ptr = ptr;
+        m_end = chunk ? get_usable_start(chunk) + chunk->capacity : nullptr;
     }
 
     bool Arena::grow() {
-        CellData *new_cell = m_ctx.alloc_cell(m_tag);
-        if (!new_cell) {
-            return false;
-        }
+        Chunk *chunk = nullptr;
 
-        // Initialize the link
-        CellLink *link = get_link(new_cell);
-        link->next = m_head; // Point to previous head (older cell)
+        if (m_reserved_bytes >= m_config.cell_chunk_bytes) {
+            // Double the footprint: the new chunk matches everything held so far
+            size_t footprint = BuddyAllocator::kMinBlockSize;
+            while (footprint < m_reserved_bytes && footprint < m_config.max_chunk_size) {
+                footprint <<= 1;
+            }
 
-        // Make this the new head
-        m_head = new_cell;
-        m_offset = 0;
-        m_cell_count++;
-        m_current_cell_index = m_cell_count - 1;
+            // Leave room for the buddy header so the block is exactly footprint bytes
+            size_t request = footprint - BuddyAllocator::kHeaderSize;
+            void *block = m_ctx.alloc_bytes(request, m_tag);
+            if (block) {
+                chunk = static_cast<Chunk *>(block);
+                chunk->capacity = request - kChunkHeaderSize;
+                chunk->footprint = footprint;
+            }
+        }
 
+        if (!chunk) {
+            // Below the threshold, or the buddy tier is exhausted: fall back to a cell
+            CellData *cell = m_ctx.alloc_cell(m_tag);
+            if (!cell) {
+                return false;
+            }
+            chunk = reinterpret_cast<Chunk *>(reinterpret_cast<char *>(cell) + kBlockStartOffset);
+            chunk->capacity = kUsablePerCell;
+            chunk->footprint = kCellSize;
+        }
+
+        append_chunk(chunk);
         return true;
     }
 
-    size_t Arena::available() const {
-        if (!m_head)
-            return 0;
-        return kUsablePerCell - m_offset;
+    void Arena::append_chunk(Chunk *chunk) {
+        chunk->next = nullptr;
+        if (m_last) {
+            m_last->next = chunk;
+        } else {
+            m_first = chunk;
+        }
+        m_last = chunk;
+        m_chunk_count++;
+        m_reserved_bytes += chunk->footprint;
     }
 
-    size_t Arena::align_offset(size_t offset, size_t alignment) {
-        return (offset + alignment - 1) & ~(alignment - 1);
+    void Arena::free_chunk(Chunk *chunk) {
+        // Buddy chunks are at least kMinBlockSize (two cells), so the footprint tells them apart
+        if (chunk->footprint == kCellSize) {
+            m_ctx.free_cell(
+                reinterpret_cast<CellData *>(reinterpret_cast<char *>(chunk) - kBlockStartOffset));
+        } else {
+            m_ctx.free_bytes(chunk);
+        }
     }
 
 }
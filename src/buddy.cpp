@@ -1,8 +1,12 @@
 #include "cell/buddy.h"
 
+#include "os_pages.h"
+
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstring>
+#include <limits>
 
 #if defined(_WIN32)
 #ifndef NOMINMAX
@@ -15,16 +19,46 @@
 
 namespace Cell {
 
+    namespace {
+
+        /** @brief Index of the lowest set bit (bits must be non-zero). */
+        inline unsigned count_trailing_zeros(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_ctzll(bits));
+#elif defined(_MSC_VER)
+            unsigned long idx;
+            _BitScanForward64(&idx, bits);
+            return static_cast<unsigned>(idx);
+#else
+            unsigned idx = 0;
+            while (!(bits & 1)) {
+                bits >>= 1;
+                ++idx;
+            }
+            return idx;
+#endif
+        }
+
+    }
+
     // =========================================================================
     // Construction / Destruction
     // =========================================================================
 
-    BuddyAllocator::BuddyAllocator(void *base, size_t reserved_size)
-        : m_base(base), m_reserved_size(reserved_size) {
-        // Initialize free lists
+    BuddyAllocator::BuddyAllocator(void *base, size_t reserved_size, HugePagePolicy huge_pages)
+        : m_base(base), m_reserved_size(reserved_size), m_huge_pages(huge_pages) {
+        // Initialize free lists and lay out one bitmap range per order
+        size_t bits = 0;
         for (size_t i = 0; i < kNumOrders; ++i) {
             m_free_lists[i] = nullptr;
+            m_bitmap_offsets[i] = bits;
+            bits += m_reserved_size >> (kMinOrder + i);
         }
+        m_free_bitmap = std::make_unique<uint64_t[]>((bits + 63) / 64);
+
+        size_t superblocks = m_reserved_size / kMaxBlockSize;
+        m_decommitted_bitmap = std::make_unique<uint64_t[]>((superblocks + 63) / 64);
+        m_free_since = std::make_unique<uint32_t[]>(superblocks);
     }
 
     BuddyAllocator::~BuddyAllocator() {
@@ -40,17 +74,57 @@ namespace Cell {
         if (size == 0)
             return nullptr;
 
-        // Account for header
-        size_t total_size = size + sizeof(BlockHeader);
-        size_t order = size_to_order(total_size);
-
+        size_t order = order_for_size(size);
         if (order > kMaxOrder) {
             return nullptr; // Too large for buddy
         }
 
-        while (true) {
-            std::lock_guard<std::mutex> lock(m_lock);
+        std::lock_guard<std::mutex> lock(m_lock);
+        return alloc_locked(order);
+    }
+
+    void BuddyAllocator::free(void *user_ptr) {
+        if (!user_ptr)
+            return;
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        free_locked(user_ptr);
+    }
+
+    size_t BuddyAllocator::alloc_batch(size_t size, void **out_ptrs, size_t count) {
+        if (size == 0 || !out_ptrs)
+            return 0;
+
+        size_t order = order_for_size(size);
+        if (order > kMaxOrder) {
+            return 0;
+        }
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        size_t allocated = 0;
+        while (allocated < count) {
+            void *ptr = alloc_locked(order);
+            if (!ptr)
+                break;
+            out_ptrs[allocated++] = ptr;
+        }
+        return allocated;
+    }
+
+    void BuddyAllocator::free_batch(void *const *ptrs, size_t count) {
+        if (!ptrs || count == 0)
+            return;
 
+        std::lock_guard<std::mutex> lock(m_lock);
+        for (size_t i = 0; i < count; ++i) {
+            if (ptrs[i]) {
+                free_locked(ptrs[i]);
+            }
+        }
+    }
+
+    void *BuddyAllocator::alloc_locked(size_t order) {
+        while (true) {
             // Find smallest order with a free block
             for (size_t o = order; o <= kMaxOrder; ++o) {
                 size_t list_idx = o - kMinOrder;
@@ -82,20 +156,17 @@ namespace Cell {
                 }
             }
 
-            // No free blocks, allocate new superblock from OS
+            // No free blocks: reuse a released superblock, else take new space from OS.
             // Note: grow() is called while holding the lock, which is fine
             // because it doesn't call alloc()
-            if (!grow()) {
+            if (!recommit() && !grow()) {
                 return nullptr;
             }
             // Loop again to retry with the new superblock
         }
     }
 
-    void BuddyAllocator::free(void *user_ptr) {
-        if (!user_ptr)
-            return;
-
+    void BuddyAllocator::free_locked(void *user_ptr) {
         void *internal_ptr = to_internal_ptr(user_ptr);
         BlockHeader *header = get_block_header(user_ptr);
         size_t order = header->order;
@@ -105,8 +176,6 @@ namespace Cell {
         size_t block_size = size_t{1} << order;
         m_allocated -= block_size;
 
-        std::lock_guard<std::mutex> lock(m_lock);
-
         void *ptr = internal_ptr;
 
         // Try to merge with buddy
@@ -118,24 +187,12 @@ namespace Cell {
                 break;
             }
 
-            // Check if buddy is free (it would be in the free list)
-            // We do this by checking if it's in the free list for this order
-            bool buddy_is_free = false;
-            FreeBlock *buddy_block = static_cast<FreeBlock *>(buddy);
-
-            // Simple check: scan the free list for this order
-            for (FreeBlock *b = m_free_lists[order - kMinOrder]; b; b = b->next) {
-                if (b == buddy_block) {
-                    buddy_is_free = true;
-                    break;
-                }
-            }
-
-            if (!buddy_is_free)
+            // Buddy must be free as a whole block of this order to merge
+            if (!is_block_free(buddy, order))
                 break;
 
             // Remove buddy from free list
-            remove_from_free_list(buddy_block, order);
+            remove_from_free_list(static_cast<FreeBlock *>(buddy), order);
 
             // Merge: use lower address as new block
             ptr = std::min(ptr, buddy);
@@ -144,6 +201,9 @@ namespace Cell {
 
         // Add merged block to free list
         add_to_free_list(ptr, order);
+        if (order == kMaxOrder) {
+            m_free_since[superblock_index(ptr)] = monotonic_ms();
+        }
     }
 
     void *BuddyAllocator::realloc_bytes(void *ptr, size_t new_size) {
@@ -185,20 +245,8 @@ namespace Cell {
 
             // Check bounds
             if (buddy >= m_base && buddy < static_cast<char *>(m_base) + m_committed) {
-                FreeBlock *buddy_block = static_cast<FreeBlock *>(buddy);
-                bool buddy_is_free = false;
-
-                // Scan free list for this order
-                size_t list_idx = old_order - kMinOrder;
-                for (FreeBlock *b = m_free_lists[list_idx]; b; b = b->next) {
-                    if (b == buddy_block) {
-                        buddy_is_free = true;
-                        break;
-                    }
-                }
-
-                if (buddy_is_free) {
-                    remove_from_free_list(buddy_block, old_order);
+                if (is_block_free(buddy, old_order)) {
+                    remove_from_free_list(static_cast<FreeBlock *>(buddy), old_order);
 
                     void *merged_internal = std::min(internal_ptr, buddy);
 
@@ -237,6 +285,74 @@ namespace Cell {
         return new_ptr;
     }
 
+    // =========================================================================
+    // Memory Management
+    // =========================================================================
+
+    size_t BuddyAllocator::decommit_unused() {
+        FreeBlock *chain = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            while (FreeBlock *block = m_free_lists[kNumOrders - 1]) {
+                remove_from_free_list(block, kMaxOrder);
+                block->next = chain;
+                chain = block;
+            }
+        }
+        return release_superblocks(chain, std::numeric_limits<uint64_t>::max(), false);
+    }
+
+    size_t BuddyAllocator::scavenge(uint32_t decay_ms, uint64_t budget_ns, bool lazy) {
+        const uint32_t now = monotonic_ms();
+        FreeBlock *chain = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            size_t count = m_committed / kMaxBlockSize;
+            size_t scan = count < kScavengeScanLimit ? count : kScavengeScanLimit;
+            size_t taken = 0;
+
+            for (size_t n = 0; n < scan && taken < kScavengeBatchLimit; ++n) {
+                size_t i = m_scavenge_cursor++ % count;
+                void *block = static_cast<char *>(m_base) + i * kMaxBlockSize;
+                if (is_block_free(block, kMaxOrder) && now - m_free_since[i] >= decay_ms) {
+                    remove_from_free_list(static_cast<FreeBlock *>(block), kMaxOrder);
+                    static_cast<FreeBlock *>(block)->next = chain;
+                    chain = static_cast<FreeBlock *>(block);
+                    ++taken;
+                }
+            }
+        }
+        return release_superblocks(chain, budget_ns, lazy);
+    }
+
+    size_t BuddyAllocator::release_superblocks(FreeBlock *chain, uint64_t budget_ns, bool lazy) {
+        const auto start = std::chrono::steady_clock::now();
+        size_t released = 0;
+
+        // The blocks are on no free list, so nobody else can touch them meanwhile
+        while (chain) {
+            FreeBlock *next = chain->next;
+            uint64_t elapsed = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count());
+            bool ok = elapsed < budget_ns &&
+                      decommit_pages(chain, kMaxBlockSize, m_huge_pages, lazy);
+
+            std::lock_guard<std::mutex> lock(m_lock);
+            if (ok) {
+                size_t i = superblock_index(chain);
+                m_decommitted_bitmap[i / 64] |= uint64_t{1} << (i % 64);
+                m_decommitted += kMaxBlockSize;
+                released += kMaxBlockSize;
+            } else {
+                add_to_free_list(chain, kMaxOrder);
+            }
+            chain = next;
+        }
+        return released;
+    }
+
     // =========================================================================
     // Introspection
     // =========================================================================
@@ -250,11 +366,30 @@ namespace Cell {
     }
 
     size_t BuddyAllocator::bytes_committed() const {
-        return m_committed.load(std::memory_order_relaxed);
+        return m_committed.load(std::memory_order_relaxed) -
+               m_decommitted.load(std::memory_order_relaxed);
     }
 
     size_t BuddyAllocator::superblock_count() const { return m_superblock_count; }
 
+    void BuddyAllocator::free_block_counts(size_t (&counts)[kNumOrders]) const {
+        std::lock_guard<std::mutex> lock(m_lock);
+        for (size_t i = 0; i < kNumOrders; ++i) {
+            size_t count = 0;
+            for (const FreeBlock *block = m_free_lists[i]; block; block = block->next) {
+                ++count;
+            }
+            counts[i] = count;
+        }
+    }
+
+    size_t BuddyAllocator::order_for_size(size_t size) {
+        // Account for header
+        return size_to_order(size + sizeof(BlockHeader));
+    }
+
+    size_t BuddyAllocator::get_block_order(void *ptr) { return get_block_header(ptr)->order; }
+
     size_t BuddyAllocator::get_alloc_size(void *ptr) const {
         if (!owns(ptr)) {
             return 0;
@@ -270,6 +405,8 @@ namespace Cell {
     size_t BuddyAllocator::size_to_order(size_t size) {
         if (size <= kMinBlockSize)
             return kMinOrder;
+        if (size > kMaxBlockSize)
+            return kMaxOrder + 1; // Callers refuse it rather than hand out a short block
 
         // Find smallest power of 2 >= size
         size_t order = kMinOrder;
@@ -294,13 +431,16 @@ namespace Cell {
         if (!result)
             return false;
 #else
-        // On Linux, we use mmap with MAP_FIXED to commit already-reserved pages
-        // Or if using overcommit, the pages are committed on first touch
-        // For now, assume the memory is already accessible (reserved with PROT_READ|PROT_WRITE)
-        // Just touch the first page to ensure it's committed
+        // The region is already accessible (reserved with PROT_READ|PROT_WRITE) and
+        // pages are committed on first touch; only a huge page policy needs a syscall
+        if (m_huge_pages != HugePagePolicy::kNone &&
+            !commit_pages(commit_addr, kMaxBlockSize, m_huge_pages)) {
+            return false;
+        }
         static_cast<volatile char *>(commit_addr)[0] = 0;
 #endif
 
+        m_free_since[superblock_index(commit_addr)] = monotonic_ms();
         m_committed += kMaxBlockSize;
         ++m_superblock_count;
 
@@ -310,6 +450,47 @@ namespace Cell {
         return true;
     }
 
+    bool BuddyAllocator::recommit() {
+        if (m_decommitted.load(std::memory_order_relaxed) == 0) {
+            return false;
+        }
+
+        // Lowest address first keeps the resident part of the region compact
+        size_t words = (m_committed / kMaxBlockSize + 63) / 64;
+        for (size_t w = 0; w < words; ++w) {
+            uint64_t bits = m_decommitted_bitmap[w];
+            if (!bits) {
+                continue;
+            }
+
+            size_t i = w * 64 + static_cast<size_t>(count_trailing_zeros(bits));
+            void *block = static_cast<char *>(m_base) + i * kMaxBlockSize;
+
+#ifdef _WIN32
+            if (!commit_pages(block, kMaxBlockSize, m_huge_pages))
+                return false;
+#else
+            // Released pages stay mapped read/write and fault back in on first touch
+            if (m_huge_pages != HugePagePolicy::kNone &&
+                !commit_pages(block, kMaxBlockSize, m_huge_pages)) {
+                return false;
+            }
+#endif
+
+            m_decommitted_bitmap[w] &= ~(uint64_t{1} << (i % 64));
+            m_decommitted -= kMaxBlockSize;
+            m_free_since[i] = monotonic_ms();
+            add_to_free_list(block, kMaxOrder);
+            return true;
+        }
+        return false;
+    }
+
+    size_t BuddyAllocator::superblock_index(void *ptr) const {
+        return static_cast<size_t>(static_cast<char *>(ptr) - static_cast<char *>(m_base)) /
+               kMaxBlockSize;
+    }
+
     void BuddyAllocator::add_to_free_list(void *ptr, size_t order) {
         size_t list_idx = order - kMinOrder;
         FreeBlock *block = static_cast<FreeBlock *>(ptr);
@@ -323,6 +504,9 @@ namespace Cell {
         }
 
         m_free_lists[list_idx] = block;
+
+        size_t bit = bitmap_index(ptr, order);
+        m_free_bitmap[bit / 64] |= uint64_t{1} << (bit % 64);
     }
 
     void BuddyAllocator::remove_from_free_list(FreeBlock *block, size_t order) {
@@ -337,6 +521,9 @@ namespace Cell {
         if (block->next) {
             block->next->prev = block->prev;
         }
+
+        size_t bit = bitmap_index(block, order);
+        m_free_bitmap[bit / 64] &= ~(uint64_t{1} << (bit % 64));
     }
 
     void *BuddyAllocator::get_buddy(void *ptr, size_t order) const {
@@ -346,6 +533,16 @@ namespace Cell {
         return static_cast<char *>(m_base) + buddy_offset;
     }
 
+    size_t BuddyAllocator::bitmap_index(void *ptr, size_t order) const {
+        auto offset = static_cast<size_t>(static_cast<char *>(ptr) - static_cast<char *>(m_base));
+        return m_bitmap_offsets[order - kMinOrder] + (offset >> order);
+    }
+
+    bool BuddyAllocator::is_block_free(void *ptr, size_t order) const {
+        size_t bit = bitmap_index(ptr, order);
+        return (m_free_bitmap[bit / 64] >> (bit % 64)) & 1;
+    }
+
     void *BuddyAllocator::to_user_ptr(void *internal) {
         return static_cast<char *>(internal) + sizeof(BlockHeader);
     }
@@ -0,0 +1,271 @@
+#include "cell/concurrent_arena.h"
+
+#include <cassert>
+
+namespace Cell {
+
+    namespace {
+
+        /** @brief Next thread ordinal to hand out; 0 means "none yet". */
+        std::atomic<uint32_t> g_next_thread_ordinal{1};
+
+        /** @brief The calling thread's ordinal, shared by every ConcurrentArena. */
+        thread_local uint32_t t_thread_ordinal = 0;
+
+        /** @brief Source of ConcurrentArena keys; 0 is never handed out. */
+        std::atomic<uint64_t> g_next_arena_key{1};
+
+        /** @brief Shard the calling thread last used, valid while key matches its arena. */
+        struct ShardCache {
+            uint64_t key = 0;
+            void *shard = nullptr; ///< nullptr: every shard was taken, use the shared chunk.
+        };
+        thread_local ShardCache t_shard_cache;
+
+        uint32_t thread_ordinal() {
+            uint32_t ordinal = t_thread_ordinal;
+            if (CELL_UNLIKELY(ordinal == 0)) {
+                do {
+                    ordinal = g_next_thread_ordinal.fetch_add(1, std::memory_order_relaxed);
+                } while (ordinal == 0);
+                t_thread_ordinal = ordinal;
+            }
+            return ordinal;
+        }
+
+    }
+
+    // =========================================================================
+    // Construction / Destruction
+    // =========================================================================
+
+    ConcurrentArena::ConcurrentArena(Context &ctx, uint8_t tag)
+        : ConcurrentArena(ctx, ConcurrentArenaConfig{}, tag) {}
+
+    ConcurrentArena::ConcurrentArena(Context &ctx, const ConcurrentArenaConfig &config,
+                                     uint8_t tag)
+        : m_ctx(ctx), m_config(config), m_tag(tag),
+          m_key(g_next_arena_key.fetch_add(1, std::memory_order_relaxed)) {
+        size_t shards = 1;
+        while (shards < m_config.shards) {
+            shards <<= 1;
+        }
+        m_shard_mask = shards - 1;
+        m_shards.reserve(shards);
+        for (size_t i = 0; i < shards; ++i) {
+            m_shards.push_back(std::make_unique<Shard>(ctx, m_config.shard, tag));
+        }
+
+        // Shared chunks are whole buddy blocks, like the grown chunks of an Arena
+        if (m_config.shared_chunk_size < BuddyAllocator::kMinBlockSize) {
+            m_config.shared_chunk_size = BuddyAllocator::kMinBlockSize;
+        }
+        m_shared_capacity =
+            m_config.shared_chunk_size - BuddyAllocator::kHeaderSize - kSharedHeaderSize;
+    }
+
+    ConcurrentArena::~ConcurrentArena() { release(); }
+
+    // =========================================================================
+    // Allocation
+    // =========================================================================
+
+    void *ConcurrentArena::alloc(size_t size, size_t alignment) {
+        if (size == 0) {
+            return nullptr;
+        }
+
+        if (Shard *shard = claim_shard()) {
+            return shard->arena.alloc(size, alignment);
+        }
+        return alloc_shared(size, alignment);
+    }
+
+    Arena *ConcurrentArena::local_arena() {
+        Shard *shard = claim_shard();
+        return shard ? &shard->arena : nullptr;
+    }
+
+    ConcurrentArena::Shard *ConcurrentArena::claim_shard() {
+        const ShardCache &cache = t_shard_cache;
+        if (CELL_LIKELY(cache.key == m_key)) {
+            return static_cast<Shard *>(cache.shard);
+        }
+        return claim_shard_slow();
+    }
+
+    ConcurrentArena::Shard *ConcurrentArena::claim_shard_slow() {
+        // Probe from the home shard: the thread may already hold one (its cache was
+        // taken by another arena), or claims the first free one
+        uint32_t ordinal = thread_ordinal();
+        size_t home = (ordinal - 1) & m_shard_mask;
+        Shard *found = nullptr;
+        for (size_t i = 0; i <= m_shard_mask && !found; ++i) {
+            Shard &shard = *m_shards[(home + i) & m_shard_mask];
+            uint32_t owner = shard.owner.load(std::memory_order_relaxed);
+            if (owner == ordinal ||
+                (owner == 0 && shard.owner.compare_exchange_strong(owner, ordinal,
+                                                                   std::memory_order_acquire,
+                                                                   std::memory_order_relaxed))) {
+                found = &shard;
+            }
+        }
+
+        t_shard_cache.key = m_key;
+        t_shard_cache.shard = found;
+        return found;
+    }
+
+    void *ConcurrentArena::alloc_shared(size_t size, size_t alignment) {
+        // Chunk space starts 16-byte aligned; requests that might not fit a fresh
+        // chunk at the worst-case padding get their own block
+        size_t max_padding = alignment > 16 ? alignment - 16 : 0;
+        if (size > m_shared_capacity || max_padding > m_shared_capacity - size) {
+            return alloc_oversize(size, alignment);
+        }
+
+        while (true) {
+            SharedChunk *chunk = m_shared.load(std::memory_order_acquire);
+            if (chunk) {
+                if (void *result = bump_shared(chunk, size, alignment)) {
+                    m_shared_allocated.fetch_add(size, std::memory_order_relaxed);
+                    return result;
+                }
+            }
+            if (!advance_shared(chunk)) {
+                return nullptr;
+            }
+        }
+    }
+
+    void *ConcurrentArena::bump_shared(SharedChunk *chunk, size_t size, size_t alignment) {
+        auto base = reinterpret_cast<uintptr_t>(chunk) + kSharedHeaderSize;
+        size_t used = chunk->used.load(std::memory_order_relaxed);
+        while (true) {
+            uintptr_t aligned_addr = (base + used + alignment - 1) & ~(alignment - 1);
+            size_t aligned_offset = aligned_addr - base;
+            if (aligned_offset > chunk->capacity || size > chunk->capacity - aligned_offset) {
+                return nullptr;
+            }
+            // The bytes carry no data yet, so the claim itself needs no ordering
+            if (chunk->used.compare_exchange_weak(used, aligned_offset + size,
+                                                  std::memory_order_relaxed)) {
+                return reinterpret_cast<void *>(aligned_addr);
+            }
+        }
+    }
+
+    bool ConcurrentArena::advance_shared(SharedChunk *full) {
+        std::lock_guard<std::mutex> lock(m_shared_mutex);
+        if (m_shared.load(std::memory_order_relaxed) != full) {
+            return true; // Another thread already moved on
+        }
+
+        // Chunks kept from earlier frames are rewound by reset() and reused in order
+        SharedChunk *next = full ? full->next : m_shared_first;
+        if (!next) {
+            void *block =
+                m_ctx.alloc_bytes(m_config.shared_chunk_size - BuddyAllocator::kHeaderSize, m_tag);
+            if (!block) {
+                return false;
+            }
+            next = static_cast<SharedChunk *>(block);
+            next->used.store(0, std::memory_order_relaxed);
+            next->capacity = m_shared_capacity;
+            next->next = nullptr;
+            if (m_shared_last) {
+                m_shared_last->next = next;
+            } else {
+                m_shared_first = next;
+            }
+            m_shared_last = next;
+            m_shared_reserved += m_config.shared_chunk_size;
+        }
+
+        m_shared.store(next, std::memory_order_release);
+        return true;
+    }
+
+    void *ConcurrentArena::alloc_oversize(size_t size, size_t alignment) {
+        void *ptr = alignment > 16 ? m_ctx.alloc_aligned(size, alignment, m_tag)
+                                   : m_ctx.alloc_bytes(size, m_tag, alignment);
+        if (!ptr) {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(m_shared_mutex);
+        m_oversize.push_back(ptr);
+        m_shared_allocated.fetch_add(size, std::memory_order_relaxed);
+        return ptr;
+    }
+
+    // =========================================================================
+    // Lifetime Management
+    // =========================================================================
+
+    void ConcurrentArena::reset() {
+        m_key = g_next_arena_key.fetch_add(1, std::memory_order_relaxed);
+        for (auto &shard : m_shards) {
+            shard->arena.reset();
+            shard->owner.store(0, std::memory_order_relaxed);
+        }
+        reset_shared(false);
+    }
+
+    void ConcurrentArena::release() {
+        m_key = g_next_arena_key.fetch_add(1, std::memory_order_relaxed);
+        for (auto &shard : m_shards) {
+            shard->arena.release();
+            shard->owner.store(0, std::memory_order_relaxed);
+        }
+        reset_shared(true);
+    }
+
+    void ConcurrentArena::reset_shared(bool release_chunks) {
+        std::lock_guard<std::mutex> lock(m_shared_mutex);
+
+        for (void *ptr : m_oversize) {
+            m_ctx.free_bytes(ptr);
+        }
+        m_oversize.clear();
+
+        for (SharedChunk *chunk = m_shared_first; chunk;) {
+            SharedChunk *next = chunk->next;
+            if (release_chunks) {
+                m_ctx.free_bytes(chunk);
+            } else {
+                chunk->used.store(0, std::memory_order_relaxed);
+            }
+            chunk = next;
+        }
+        if (release_chunks) {
+            m_shared_first = nullptr;
+            m_shared_last = nullptr;
+            m_shared_reserved = 0;
+        }
+
+        m_shared.store(nullptr, std::memory_order_relaxed);
+        m_shared_allocated.store(0, std::memory_order_relaxed);
+    }
+
+    // =========================================================================
+    // Introspection
+    // =========================================================================
+
+    size_t ConcurrentArena::bytes_allocated() const {
+        size_t total = m_shared_allocated.load(std::memory_order_relaxed);
+        for (const auto &shard : m_shards) {
+            total += shard->arena.bytes_allocated();
+        }
+        return total;
+    }
+
+    size_t ConcurrentArena::bytes_reserved() const {
+        size_t total = m_shared_reserved;
+        for (const auto &shard : m_shards) {
+            total += shard->arena.bytes_reserved();
+        }
+        return total;
+    }
+
+}
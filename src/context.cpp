@@ -1,11 +1,23 @@
 #include "cell/context.h"
 
-#include "tls_bin_cache.h"
-#include "tls_cache.h"
-
+#include "numa.h"
+#include "os_pages.h"
+#include "remote_free.h"
+#include "scavenger.h"
+#include "tag_heap.h"
+#include "tls_slots.h"
+#ifdef CELL_ENABLE_HEAP_PROFILE
+#include "cell/trace.h"
+#include "heap_profile.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstdio>
 #include <cstring>
+#include <new>
 
 #if defined(_WIN32)
 #ifndef NOMINMAX
@@ -16,6 +28,9 @@
 #include <sys/mman.h>
 #include <unistd.h>
 #endif
+#if defined(CELL_HARDENED) && defined(__linux__)
+#include <sys/random.h>
+#endif
 
 // SIMD intrinsics for batch operations
 #if defined(__x86_64__) || defined(_M_X64)
@@ -60,7 +75,36 @@ namespace Cell {
 #endif
     }
 
-    Context::Context(const Config &config) : m_reserved_size(config.reserve_size) {
+    /** @brief Source of Context ids; ids are never reused so stale TLS state is detectable. */
+    static std::atomic<uint64_t> s_next_context_id{1};
+
+#ifdef CELL_HARDENED
+    /**
+     * @brief Draws a free-list key: from the OS where it offers one without blocking,
+     *        otherwise mixed from the clock, the Context's address and its id.
+     */
+    static uintptr_t make_free_list_key(const void *context, uint64_t id) {
+        uint64_t key = 0;
+#ifdef __linux__
+        if (getrandom(&key, sizeof(key), GRND_NONBLOCK) == sizeof(key) && key != 0) {
+            return static_cast<uintptr_t>(key);
+        }
+#endif
+        key = static_cast<uint64_t>(
+                  std::chrono::high_resolution_clock::now().time_since_epoch().count()) ^
+              reinterpret_cast<uintptr_t>(context) ^ (id << 32);
+        // splitmix64 finalizer
+        key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+        return static_cast<uintptr_t>(key ^ (key >> 31));
+    }
+#endif
+
+    template <typename Policy>
+    BasicContext<Policy>::BasicContext(const Config &config)
+        : m_reserved_size(config.reserve_size),
+          m_id(s_next_context_id.fetch_add(1, std::memory_order_relaxed)),
+          m_tls_slot(acquire_tls_slot_index()) {
         // Split reserved space: half for cells, half for buddy
         // Both need to be reasonably sized for their use cases
         size_t cell_reserve = m_reserved_size / 2;
@@ -72,6 +116,10 @@ namespace Cell {
         buddy_reserve =
             (buddy_reserve / BuddyAllocator::kMaxBlockSize) * BuddyAllocator::kMaxBlockSize;
 
+        // One spare superblock per region lets both start on a 2MB (huge page) boundary
+        cell_reserve += kSuperblockSize;
+        buddy_reserve += BuddyAllocator::kMaxBlockSize;
+
 #if defined(_WIN32)
         m_base = VirtualAlloc(nullptr, cell_reserve, MEM_RESERVE, PAGE_NOACCESS);
         if (m_base) {
@@ -94,12 +142,19 @@ namespace Cell {
 
         if (m_base) {
             m_reserved_size = cell_reserve;
-            m_allocator = std::make_unique<Allocator>(m_base, cell_reserve);
+            size_t numa_nodes = config.numa_nodes == 0 ? numa_node_count() : config.numa_nodes;
+            m_allocator = std::make_unique<Allocator>(m_base, cell_reserve, m_tls_slot, m_id,
+                                                      config.huge_pages, numa_nodes);
         }
 
         if (m_buddy_base) {
             m_buddy_reserved_size = buddy_reserve;
-            m_buddy = std::make_unique<BuddyAllocator>(m_buddy_base, buddy_reserve);
+            auto addr = reinterpret_cast<uintptr_t>(m_buddy_base);
+            auto aligned = (addr + BuddyAllocator::kMaxBlockSize - 1) &
+                           ~(uintptr_t{BuddyAllocator::kMaxBlockSize} - 1);
+            m_buddy = std::make_unique<BuddyAllocator>(
+                reinterpret_cast<void *>(aligned),
+                buddy_reserve - BuddyAllocator::kMaxBlockSize, config.huge_pages);
         }
 
         // Initialize bins (already zero-initialized, but be explicit)
@@ -110,9 +165,49 @@ namespace Cell {
             m_bins[i].current_allocated = 0;
         }
 
+        for (size_t tag = 1; tag < config.tag_heaps.size(); ++tag) {
+            if (config.tag_heaps.test(tag)) {
+                m_tag_heaps[tag] = std::make_unique<TagHeap>(static_cast<uint8_t>(tag));
+            }
+        }
+
 #ifdef CELL_ENABLE_BUDGET
         m_budget = config.memory_budget;
 #endif
+#ifdef CELL_HARDENED
+        m_free_list_key = make_free_list_key(this, m_id);
+#endif
+
+        m_decay_ms = config.decay_ms;
+        m_tls_bin_cache_bytes = config.tls_bin_cache_bytes;
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+        // Calibrates the clock here rather than in the first timed slow path
+        latency_ns_per_tick();
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+        if (config.heap_profile_sample_bytes > 0) {
+            m_heap_profiler = std::make_unique<HeapProfiler>(config.heap_profile_sample_bytes);
+            if (!m_heap_profiler->valid()) {
+                m_heap_profiler.reset();
+            }
+        }
+#endif
+#if defined(CELL_ENABLE_STATS) || defined(CELL_ENABLE_TRACE) ||                                   \
+    defined(CELL_ENABLE_LATENCY_PROFILE)
+        register_tls_owner(m_tls_slot, m_id, &BasicContext::release_slot_caches,
+                           &BasicContext::retire_slot, this);
+#else
+        register_tls_owner(m_tls_slot, m_id, &BasicContext::release_slot_caches, nullptr, this);
+#endif
+        if (config.prewarm.superblocks > 0 || !config.prewarm.sizes.empty()) {
+            prewarm(config.prewarm);
+        }
+        if (config.background_scavenger && (m_allocator || m_buddy)) {
+            ScavengeFn step = [](void *context, uint64_t budget_ns) {
+                return static_cast<BasicContext *>(context)->scavenge(budget_ns);
+            };
+            m_scavenger = std::make_unique<Scavenger>(step, this, config.scavenge_interval_ms);
+        }
     }
 
     // =========================================================================
@@ -120,25 +215,24 @@ namespace Cell {
     // =========================================================================
 
 #ifdef CELL_ENABLE_BUDGET
-    bool Context::check_budget(size_t size) {
-        if (m_budget == 0) {
-            return true; // Unlimited
-        }
-        size_t current = m_budget_current.load(std::memory_order_relaxed);
-        if (current + size > m_budget) {
-            if (m_budget_callback) {
-                m_budget_callback(size, m_budget, current);
-            }
-            return false;
-        }
-        return true;
+    template <typename Policy>
+    bool BasicContext<Policy>::reserve_budget(size_t size) {
+        // Checking first and charging after the allocation would let concurrent
+        // callers each pass the check and overshoot together
+        return refill_budget_lease(nullptr, size, true);
     }
 
-    void Context::record_budget_alloc(size_t size) {
-        m_budget_current.fetch_add(size, std::memory_order_relaxed);
+    template <typename Policy>
+    void BasicContext<Policy>::settle_budget(size_t reserved, size_t actual) {
+        if (actual < reserved) {
+            record_budget_free(reserved - actual);
+        } else if (actual > reserved) {
+            m_budget_current.fetch_add(actual - reserved, std::memory_order_relaxed);
+        }
     }
 
-    void Context::record_budget_free(size_t size) {
+    template <typename Policy>
+    void BasicContext<Policy>::record_budget_free(size_t size) {
         m_budget_current.fetch_sub(size, std::memory_order_relaxed);
     }
 #endif
@@ -148,14 +242,23 @@ namespace Cell {
     // =========================================================================
 
 #ifdef CELL_ENABLE_INSTRUMENTATION
-    void Context::invoke_alloc_callback(void *ptr, size_t size, uint8_t tag, bool is_alloc) {
+    template <typename Policy>
+    void BasicContext<Policy>::invoke_alloc_callback(void *ptr, size_t size, uint8_t tag,
+                                                     bool is_alloc) {
         if (m_alloc_callback) {
             m_alloc_callback(ptr, size, tag, is_alloc);
         }
     }
 #endif
 
-    Context::~Context() {
+    template <typename Policy>
+    BasicContext<Policy>::~BasicContext() {
+        // Stop background scavenging before anything it touches is torn down
+        m_scavenger.reset();
+
+        // Exiting threads stop returning their caches here (waits for any in flight)
+        unregister_tls_owner(m_tls_slot);
+
 #ifdef CELL_DEBUG_LEAKS
         // Report any leaked allocations before cleanup
         if (!m_live_allocs.empty()) {
@@ -165,17 +268,27 @@ namespace Cell {
         }
 #endif
 
-        // Clear TLS bin caches to prevent stale pointers for future Contexts.
-        // The cached blocks will be freed when the memory region is unmapped.
-        // Note: This only clears the current thread's caches.
-        for (size_t i = 0; i < kTlsBinCacheCount; ++i) {
-            t_bin_cache[i].count = 0;
+        // Unbind the calling thread's slot (don't flush, just drop): the cached blocks,
+        // cells and remote queue all live in memory that is about to be released.
+        // Other threads notice the id mismatch when a later Context reuses the slot.
+        if (TlsSlot *slot = find_tls_slot<Policy>(m_tls_slot, m_id)) {
+            slot->owner = 0;
+        }
+
+        while (m_remote_queues) {
+            auto *next = static_cast<RemoteFreeQueue *>(m_remote_queues->next_registered);
+            delete m_remote_queues;
+            m_remote_queues = next;
         }
 
-        // Also clear the cell-level TLS cache (don't flush, just clear)
-        // The cached cells will be freed when the memory region is unmapped
-        // Flushing would push them to the global pool which is about to be unmapped
-        t_cache.count = 0;
+#ifdef CELL_ENABLE_TRACE
+        while (m_trace_rings) {
+            TraceRing *next = m_trace_rings->next_registered;
+            m_trace_rings->~TraceRing();
+            unmap_pages(m_trace_rings, sizeof(TraceRing));
+            m_trace_rings = next;
+        }
+#endif
 
         // Buddy allocator destructor handles its cleanup
         m_buddy.reset();
@@ -195,18 +308,561 @@ namespace Cell {
             munmap(m_buddy_base, m_buddy_reserved_size);
 #endif
         }
+
+        // Let a future Context reuse the slot index now that nothing here is reachable
+        release_tls_slot_index(m_tls_slot);
+    }
+
+    // =========================================================================
+    // Thread-Local Slot
+    // =========================================================================
+
+    template <typename Policy>
+    CELL_FORCE_INLINE typename BasicContext<Policy>::TlsSlot *BasicContext<Policy>::tls_slot() {
+        return get_tls_slot<Policy>(m_tls_slot, m_id);
+    }
+
+#ifdef CELL_ENABLE_BUDGET
+    // =========================================================================
+    // Budget Leases
+    // =========================================================================
+
+    template <typename Policy>
+    CELL_FORCE_INLINE bool BasicContext<Policy>::charge_budget(size_t size, bool notify) {
+        TlsSlot *slot = tls_slot();
+        TlsSlotScope scope(slot);
+        if (CELL_LIKELY(slot != nullptr)) {
+            size_t lease = slot->budget_lease.load(std::memory_order_relaxed);
+            if (CELL_LIKELY(lease >= size)) {
+                slot->budget_lease.store(lease - size, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return refill_budget_lease(slot, size, notify);
+    }
+
+    template <typename Policy>
+    CELL_FORCE_INLINE void BasicContext<Policy>::credit_budget(TlsSlot *slot, size_t size) {
+        if (CELL_UNLIKELY(slot == nullptr)) {
+            record_budget_free(size);
+            return;
+        }
+        size_t lease = slot->budget_lease.load(std::memory_order_relaxed) + size;
+        slot->budget_lease.store(lease, std::memory_order_relaxed);
+        if (CELL_UNLIKELY(lease > kBudgetLeaseMaxBytes)) {
+            trim_budget_lease(*slot, kBudgetLeaseBytes);
+        }
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::refund_budget(size_t size) {
+        TlsSlot *slot = tls_slot();
+        TlsSlotScope scope(slot);
+        credit_budget(slot, size);
+    }
+
+    template <typename Policy>
+    bool BasicContext<Policy>::refill_budget_lease(TlsSlot *slot, size_t size, bool notify) {
+        size_t lease = slot ? slot->budget_lease.load(std::memory_order_relaxed) : 0;
+        size_t need = size - lease;
+        size_t current = m_budget_current.load(std::memory_order_relaxed);
+        size_t grant;
+        do {
+            if (m_budget != 0 && current + need > m_budget) {
+                if (notify && m_budget_callback) {
+                    m_budget_callback(size, m_budget, current);
+                }
+                return false;
+            }
+            grant = need;
+            if (slot) {
+                // Near the limit, lease an eighth of what is left so that a few threads
+                // sitting on unspent leases cannot strand the rest of the budget
+                size_t spare = m_budget != 0 ? (m_budget - current - need) / 8 : kBudgetLeaseBytes;
+                grant += std::min(kBudgetLeaseBytes, spare);
+            }
+        } while (!m_budget_current.compare_exchange_weak(current, current + grant,
+                                                         std::memory_order_relaxed));
+        if (slot) {
+            slot->budget_lease.store(lease + grant - size, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::trim_budget_lease(TlsSlot &slot, size_t keep) {
+        size_t lease = slot.budget_lease.load(std::memory_order_relaxed);
+        if (lease > keep) {
+            slot.budget_lease.store(keep, std::memory_order_relaxed);
+            record_budget_free(lease - keep);
+        }
+    }
+
+    template <typename Policy>
+    size_t BasicContext<Policy>::get_budget_current() const {
+        // A thread refilling or trimming meanwhile skews the result by up to one lease
+        size_t leased = 0;
+        visit_bound_tls_slots(
+            m_tls_slot,
+            [](const Cell::TlsSlot &slot, void *arg) {
+                *static_cast<size_t *>(arg) += slot.budget_lease.load(std::memory_order_relaxed);
+            },
+            &leased);
+        size_t current = m_budget_current.load(std::memory_order_relaxed);
+        return current > leased ? current - leased : 0;
+    }
+#endif
+
+#ifdef CELL_ENABLE_STATS
+    // =========================================================================
+    // Statistics Recording
+    // =========================================================================
+
+    template <typename Policy>
+    CELL_FORCE_INLINE void BasicContext<Policy>::stats_record_alloc(size_t size, uint8_t tag,
+                                                                    StatsShard::Counter tier,
+                                                                    size_t count) {
+        size_t bytes = size * count;
+        if (TlsSlot *slot = tls_slot()) {
+            StatsShard &shard = slot->stats;
+            shard.add(StatsShard::kTotalAllocated, bytes);
+            shard.add(tier, count);
+            shard.add_tag(tag, bytes);
+            shard.unflushed += static_cast<int64_t>(bytes);
+            if (CELL_UNLIKELY(shard.unflushed >= kStatsPeakFlushBytes)) {
+                stats_publish(shard.unflushed);
+                shard.unflushed = 0;
+            }
+            return;
+        }
+        m_shared_stats.counters[StatsShard::kTotalAllocated].fetch_add(bytes,
+                                                                       std::memory_order_relaxed);
+        m_shared_stats.counters[tier].fetch_add(count, std::memory_order_relaxed);
+        m_shared_stats.per_tag_current[tag].fetch_add(bytes, std::memory_order_relaxed);
+        stats_publish(static_cast<int64_t>(bytes));
+    }
+
+    template <typename Policy>
+    CELL_FORCE_INLINE void BasicContext<Policy>::stats_record_free(size_t size, uint8_t tag,
+                                                                   StatsShard::Counter tier,
+                                                                   size_t count) {
+        size_t bytes = size * count;
+        if (TlsSlot *slot = tls_slot()) {
+            StatsShard &shard = slot->stats;
+            shard.add(StatsShard::kTotalFreed, bytes);
+            shard.add(tier, count);
+            shard.add_tag(tag, 0 - bytes);
+            shard.unflushed -= static_cast<int64_t>(bytes);
+            if (CELL_UNLIKELY(shard.unflushed <= -kStatsPeakFlushBytes)) {
+                stats_publish(shard.unflushed);
+                shard.unflushed = 0;
+            }
+            return;
+        }
+        m_shared_stats.counters[StatsShard::kTotalFreed].fetch_add(bytes,
+                                                                   std::memory_order_relaxed);
+        m_shared_stats.counters[tier].fetch_add(count, std::memory_order_relaxed);
+        m_shared_stats.per_tag_current[tag].fetch_sub(bytes, std::memory_order_relaxed);
+        stats_publish(-static_cast<int64_t>(bytes));
+    }
+
+    template <typename Policy>
+    CELL_FORCE_INLINE void BasicContext<Policy>::stats_count(StatsShard::Counter counter,
+                                                             size_t n) {
+        if (TlsSlot *slot = tls_slot()) {
+            slot->stats.add(counter, n);
+            return;
+        }
+        m_shared_stats.counters[counter].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::stats_publish(int64_t delta) {
+        int64_t net = m_stats_flushed.fetch_add(delta, std::memory_order_relaxed) + delta;
+        if (net <= 0) {
+            return;
+        }
+        size_t current = static_cast<size_t>(net);
+        size_t peak = m_stats_peak.load(std::memory_order_relaxed);
+        while (current > peak) {
+            if (m_stats_peak.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+    }
+
+    template <typename Policy>
+    StatsTotals BasicContext<Policy>::collect_stats() const {
+        StatsTotals totals;
+        totals.add(m_shared_stats);
+        visit_bound_tls_slots(
+            m_tls_slot,
+            [](const Cell::TlsSlot &slot, void *arg) {
+                static_cast<StatsTotals *>(arg)->add(slot.stats);
+            },
+            &totals);
+        return totals;
+    }
+#endif
+
+#ifdef CELL_ENABLE_TRACE
+    // =========================================================================
+    // Event Tracing
+    // =========================================================================
+
+    template <typename Policy>
+    CELL_FORCE_INLINE void BasicContext<Policy>::trace_event(TraceKind kind, const void *ptr,
+                                                             size_t size, uint8_t tag,
+                                                             TraceTier tier) {
+        if (CELL_UNLIKELY(m_tracing.load(std::memory_order_relaxed))) {
+            trace_record(kind, ptr, size, tag, tier);
+        }
+    }
+
+    template <typename Policy>
+    CELL_FORCE_INLINE void BasicContext<Policy>::trace_free(const void *ptr) {
+        if (CELL_UNLIKELY(m_tracing.load(std::memory_order_relaxed))) {
+            size_t block_size = 0;
+            uint8_t tag = 0;
+            TraceTier tier = trace_locate(ptr, block_size, tag);
+            trace_record(TraceKind::kFree, ptr, block_size, tag, tier);
+        }
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::trace_record(TraceKind kind, const void *ptr, size_t size,
+                                            uint8_t tag, TraceTier tier) {
+        TlsSlot *slot = tls_slot();
+        TraceRing *ring = slot ? slot->trace_ring : nullptr;
+        if (CELL_UNLIKELY(!ring)) {
+            ring = slot ? acquire_trace_ring(*slot) : nullptr;
+            if (!ring) {
+                m_trace_unrecorded.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+        TraceEvent event;
+        event.timestamp = trace_clock();
+        event.ptr = reinterpret_cast<uintptr_t>(ptr);
+        event.size = size;
+        event.thread = ring->thread;
+        event.tag = tag;
+        event.tier = tier;
+        event.kind = kind;
+        ring->push(event);
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::trace_realloc(const void *old_ptr, size_t old_block_size,
+                                             const void *new_ptr, size_t new_size, uint8_t tag,
+                                             TraceTier tier) {
+        if (CELL_LIKELY(!is_tracing()) || !new_ptr) {
+            return;
+        }
+        if (new_ptr == old_ptr) {
+            trace_event(TraceKind::kRealloc, new_ptr, new_size, tag, tier);
+            return;
+        }
+        trace_event(TraceKind::kFree, old_ptr, old_block_size, 0, tier);
+        trace_event(TraceKind::kAlloc, new_ptr, new_size, tag, tier);
+    }
+
+    template <typename Policy>
+    TraceTier BasicContext<Policy>::trace_locate(const void *ptr, size_t &block_size,
+                                                 uint8_t &tag) const {
+        auto uptr = reinterpret_cast<uintptr_t>(ptr);
+        auto base = reinterpret_cast<uintptr_t>(m_base);
+        if (uptr >= base && uptr < base + m_reserved_size) {
+            const CellHeader *header = get_header<Policy>(const_cast<void *>(ptr));
+            tag = header->tag;
+            if (header->size_class == kFullCellMarker) {
+                block_size = kCellSize;
+                return TraceTier::kCell;
+            }
+            block_size = kSizeClasses[header->size_class];
+            return TraceTier::kSubCell;
+        }
+        if (m_buddy && m_buddy->owns(const_cast<void *>(ptr))) {
+            block_size = m_buddy->get_alloc_size(const_cast<void *>(ptr));
+            return TraceTier::kBuddy;
+        }
+        block_size = m_large_allocs.get_alloc_size(const_cast<void *>(ptr));
+        return TraceTier::kLarge;
+    }
+
+    template <typename Policy>
+    TraceRing *BasicContext<Policy>::acquire_trace_ring(TlsSlot &slot) {
+        std::lock_guard<std::mutex> lock(m_trace_mutex);
+        TraceRing *ring = m_trace_rings;
+        while (ring && ring->in_use.load(std::memory_order_acquire)) {
+            ring = ring->next_registered;
+        }
+        if (!ring) {
+            void *storage = map_pages(sizeof(TraceRing));
+            if (!storage) {
+                return nullptr;
+            }
+            ring = new (storage) TraceRing();
+            ring->next_registered = m_trace_rings;
+            m_trace_rings = ring;
+        }
+        // Events still queued from the previous claimant keep their thread number
+        ring->thread = ++m_trace_threads;
+        ring->in_use.store(true, std::memory_order_relaxed);
+        slot.trace_ring = ring;
+        return ring;
+    }
+
+    template <typename Policy>
+    size_t BasicContext<Policy>::drain_trace(TraceEvent *out, size_t capacity) {
+        std::lock_guard<std::mutex> drain_lock(m_trace_drain_mutex);
+        TraceRing *first;
+        {
+            // Rings are only ever pushed at the front, so the rest of the list is stable
+            std::lock_guard<std::mutex> lock(m_trace_mutex);
+            first = m_trace_rings;
+        }
+        if (!first) {
+            return 0;
+        }
+
+        TraceRing *start = m_trace_drain_next ? m_trace_drain_next : first;
+        TraceRing *ring = start;
+        size_t count = 0;
+        do {
+            count += ring->drain(out + count, capacity - count);
+            ring = ring->next_registered ? ring->next_registered : first;
+        } while (ring != start && count < capacity);
+        m_trace_drain_next = ring;
+        return count;
+    }
+
+    template <typename Policy>
+    uint64_t BasicContext<Policy>::trace_dropped() const {
+        uint64_t dropped = m_trace_unrecorded.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(m_trace_mutex);
+        for (TraceRing *ring = m_trace_rings; ring; ring = ring->next_registered) {
+            dropped += ring->dropped.load(std::memory_order_relaxed);
+        }
+        return dropped;
+    }
+#endif
+
+#ifdef CELL_ENABLE_HEAP_PROFILE
+    // =========================================================================
+    // Heap Profile
+    // =========================================================================
+
+    template <typename Policy>
+    CELL_FORCE_INLINE void BasicContext<Policy>::heap_profile_alloc(TlsSlot *slot, const void *ptr,
+                                                                    size_t size) {
+        if (CELL_LIKELY(slot != nullptr)) {
+            if (CELL_LIKELY(size < slot->heap_sample_countdown)) {
+                slot->heap_sample_countdown -= size;
+                return;
+            }
+            heap_profile_sample(*slot, ptr, size);
+        }
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::heap_profile_sample(TlsSlot &slot, const void *ptr, size_t size) {
+        if (!m_heap_profiler) {
+            slot.heap_sample_countdown = SIZE_MAX;
+            return;
+        }
+        if (CELL_UNLIKELY(slot.heap_sample_rng == 0)) {
+            // First allocation of the thread: nothing to sample before the first draw
+            slot.heap_sample_rng = (reinterpret_cast<uintptr_t>(&slot) ^ trace_clock()) | 1;
+            slot.heap_sample_countdown = m_heap_profiler->next_countdown(slot.heap_sample_rng);
+            if (size < slot.heap_sample_countdown) {
+                slot.heap_sample_countdown -= size;
+                return;
+            }
+        }
+        slot.heap_sample_countdown = m_heap_profiler->next_countdown(slot.heap_sample_rng);
+
+        void *stack[kHeapProfileMaxDepth];
+        size_t depth = capture_stack(stack, kHeapProfileMaxDepth, 1);
+        m_heap_profiler->record(ptr, size, stack, depth);
+    }
+
+    template <typename Policy>
+    CELL_FORCE_INLINE void BasicContext<Policy>::heap_profile_free(const void *ptr) {
+        HeapProfiler *profiler = m_heap_profiler.get();
+        if (CELL_UNLIKELY(profiler && profiler->maybe_sampled(ptr))) {
+            profiler->remove(ptr);
+        }
+    }
+
+    template <typename Policy>
+    bool BasicContext<Policy>::dump_heap_profile(std::FILE *out) const {
+        return m_heap_profiler && m_heap_profiler->write(out);
+    }
+#endif
+
+#if defined(CELL_ENABLE_STATS) || defined(CELL_ENABLE_TRACE) ||                                   \
+    defined(CELL_ENABLE_LATENCY_PROFILE)
+    template <typename Policy>
+    void BasicContext<Policy>::retire_slot(void *context, Cell::TlsSlot &slot) {
+        auto *self = static_cast<BasicContext *>(context);
+#ifdef CELL_ENABLE_TRACE
+        // The drain side does not need the ring back; the next thread to claim it does
+        if (slot.trace_ring) {
+            slot.trace_ring->in_use.store(false, std::memory_order_release);
+            slot.trace_ring = nullptr;
+        }
+#endif
+#ifdef CELL_ENABLE_STATS
+        // Runs under the registry mutex, so collect_stats() sees the shard either
+        // still linked or already folded in
+        StatsShard &shard = slot.stats;
+        for (size_t i = 0; i < StatsShard::kCounterCount; ++i) {
+            self->m_shared_stats.counters[i].fetch_add(
+                shard.counters[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < 256; ++i) {
+            self->m_shared_stats.per_tag_current[i].fetch_add(
+                shard.per_tag_current[i].load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+        }
+        if (shard.unflushed != 0) {
+            self->stats_publish(shard.unflushed);
+        }
+        shard.clear();
+#endif
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+        self->m_retired_latency.add(slot.latency);
+        slot.latency.clear();
+#endif
+        (void)self;
+    }
+#endif
+
+    // =========================================================================
+    // Free-List Hardening
+    // =========================================================================
+
+    template <typename Policy>
+    CELL_FORCE_INLINE FreeBlock *BasicContext<Policy>::next_free(const FreeBlock *block) const {
+        FreeBlock *next = block->get_next(free_list_key());
+#ifdef CELL_HARDENED
+        auto addr = reinterpret_cast<uintptr_t>(next);
+        auto base = reinterpret_cast<uintptr_t>(m_base);
+        if (CELL_UNLIKELY(!block->intact(m_free_list_key) ||
+                          (next && (addr - base >= m_reserved_size ||
+                                    addr % kSizeClassGranularity != 0)))) {
+            report_heap_corruption("free list link corrupted", block);
+        }
+#endif
+        return next;
+    }
+
+#ifdef CELL_HARDENED
+    template <typename Policy>
+    CELL_FORCE_INLINE void BasicContext<Policy>::hardened_claim(void *block) {
+        static_cast<FreeBlock *>(block)->unseal();
+    }
+
+    template <typename Policy>
+    CELL_FORCE_INLINE void BasicContext<Policy>::hardened_release(void *ptr, CellHeader *header,
+                                                                  size_t bin_index) {
+        size_t start = block_start_offset<Policy>(bin_index);
+        auto offset =
+            static_cast<size_t>(static_cast<char *>(ptr) - reinterpret_cast<char *>(header));
+        size_t index = block_index<Policy>(header, bin_index, ptr);
+        if (CELL_UNLIKELY(offset < start || index >= blocks_per_cell<Policy>(bin_index) ||
+                          start + index * kSizeClasses[bin_index] != offset)) {
+            report_heap_corruption("free of a pointer that is not a block start", ptr);
+        }
+        // Still sealed: nothing handed it out since it was last freed
+        if (CELL_UNLIKELY(static_cast<FreeBlock *>(ptr)->intact(m_free_list_key))) {
+            report_heap_corruption("double free", ptr);
+        }
+    }
+
+    template <typename Policy>
+    CELL_FORCE_INLINE void
+    BasicContext<Policy>::hardened_check_freed(const FreeBlock *block) const {
+        if (CELL_UNLIKELY(!block->intact(m_free_list_key))) {
+            report_heap_corruption("block written after free", block);
+        }
+    }
+#endif
+
+    template <typename Policy>
+    CELL_FORCE_INLINE bool BasicContext<Policy>::free_to_tls(TlsSlot *slot, void *ptr,
+                                                             CellHeader *header, size_t bin_index) {
+        TlsSlotScope scope(slot);
+
+        // Block owned by another thread: hand it back through its remote queue
+        auto *owner = static_cast<RemoteFreeQueue *>(
+            get_metadata(header)->owner.load(std::memory_order_relaxed));
+        RemoteFreeQueue *local = slot ? slot->remote_queue : nullptr;
+        if (CELL_UNLIKELY(owner && owner != local)) {
+            // Tag heap blocks go back under the heap's lock, never to a cache or queue
+            if (owner == kTagHeapOwner) {
+                return false;
+            }
+#ifdef CELL_HARDENED
+            hardened_release(ptr, header, bin_index);
+#endif
+#ifndef NDEBUG
+            std::memset(ptr, kPoisonByte, kSizeClasses[bin_index]);
+#endif
+#ifdef CELL_ENABLE_STATS
+            stats_record_free(kSizeClasses[bin_index], header->tag, StatsShard::kSubcellFrees);
+#endif
+#ifdef CELL_ENABLE_BUDGET
+            credit_budget(slot, kSizeClasses[bin_index]);
+#endif
+            owner->push(bin_index, static_cast<FreeBlock *>(ptr), free_list_key());
+            return true;
+        }
+
+        // Hot bin - try TLS cache first
+        if (CELL_LIKELY(slot && !slot->bins[bin_index].is_full())) {
+            TlsBinCache &cache = slot->bins[bin_index];
+#ifdef CELL_HARDENED
+            hardened_release(ptr, header, bin_index);
+#endif
+#ifndef NDEBUG
+            std::memset(ptr, kPoisonByte, kSizeClasses[bin_index]);
+#endif
+#ifdef CELL_ENABLE_STATS
+            stats_record_free(kSizeClasses[bin_index], header->tag, StatsShard::kSubcellFrees);
+#endif
+#ifdef CELL_ENABLE_BUDGET
+            credit_budget(slot, kSizeClasses[bin_index]);
+#endif
+#ifdef CELL_HARDENED
+            // Sealed like a listed block, for the check when it is handed out again
+            static_cast<FreeBlock *>(ptr)->set_next(nullptr, m_free_list_key);
+#endif
+            cache.blocks[cache.count++] = static_cast<FreeBlock *>(ptr);
+            return true;
+        }
+        return false;
     }
 
     // =========================================================================
     // Sub-Cell Allocation API
     // =========================================================================
 
-    void *Context::alloc_bytes(size_t size, uint8_t tag, size_t alignment) {
+    template <typename Policy>
+    void *BasicContext<Policy>::alloc_bytes(size_t size, uint8_t tag, size_t alignment) {
         if (size == 0) {
             return nullptr;
         }
 
-        if (alignment == 0 || (alignment & (alignment - 1)) != 0 || alignment > 16) {
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+            return nullptr;
+        }
+
+        // Over-aligned requests are only served by the power-of-2 bins, whose blocks
+        // are aligned to their class size; full cells and larger tiers give 16 bytes
+        if (alignment > kSizeClassGranularity &&
+            (alignment > kMaxSubCellSize || align_up(size, alignment) > kMaxSubCellSize)) {
             return nullptr;
         }
 
@@ -223,7 +879,8 @@ namespace Cell {
         // For sub-cell allocations that fit with guards, add space for guard bytes
         size_t alloc_size = size;
         bool will_have_guards = false;
-        if (size + (2 * kGuardSize) <= kMaxSubCellSize) {
+        // The front guard would shift an over-aligned block off its alignment
+        if (alignment <= kGuardSize && size + (2 * kGuardSize) <= kMaxSubCellSize) {
             alloc_size = size + (2 * kGuardSize);
             will_have_guards = true;
         }
@@ -232,11 +889,10 @@ namespace Cell {
 #endif
 
 #ifdef CELL_ENABLE_BUDGET
-        // Calculate budget_size upfront so check_budget uses the same rounded size
-        // that record_budget_alloc will use, preventing budget overruns from rounding
+        // Charged at the rounded size, the same one free_bytes() gives back
         size_t budget_size = 0;
         if (alloc_size <= kMaxSubCellSize) {
-            uint8_t bin_index = get_size_class(alloc_size, alignment);
+            uint8_t bin_index = get_size_class<Policy>(alloc_size, alignment);
             if (bin_index == kFullCellMarker) {
                 budget_size = kCellSize;
             } else {
@@ -248,11 +904,6 @@ namespace Cell {
             // Large allocation - alloc_large handles its own budget check
             budget_size = 0;
         }
-
-        // Check budget with actual rounded size (skip if alloc_large will handle it)
-        if (budget_size > 0 && !check_budget(budget_size)) {
-            return nullptr;
-        }
 #endif
 
         if (CELL_LIKELY(alloc_size <= kMaxSubCellSize)) {
@@ -262,32 +913,66 @@ namespace Cell {
 
             // Fast path: common sizes with default alignment go through TLS cache
             // directly, avoiding function call overhead (bins 0-8: 16B to 4KB)
-#if !defined(CELL_DEBUG_GUARDS) && !defined(CELL_DEBUG_LEAKS) && !defined(CELL_ENABLE_BUDGET)
-            if (CELL_LIKELY(alignment <= 8 && alloc_size <= 4096)) {
+#if !defined(CELL_DEBUG_GUARDS) && !defined(CELL_DEBUG_LEAKS)
+            if (CELL_LIKELY(alignment <= 8 && alloc_size <= 4096 && !tag_heap(tag))) {
                 // Use O(1) size class lookup
-                uint8_t bin_index = get_size_class_fast(alloc_size);
+                uint8_t bin_index = get_size_class_fast<Policy>(alloc_size);
 
                 // Inline TLS cache check for maximum speed
-                TlsBinCache &cache = t_bin_cache[bin_index];
-                if (CELL_LIKELY(cache.count > 0)) {
+                TlsSlot *slot = tls_slot();
+                if (CELL_LIKELY(slot != nullptr)) {
+                    enter_tls_slot(*slot);
+                    TlsBinCache &cache = slot->bins[bin_index];
+                    if (CELL_UNLIKELY(cache.count == 0)) {
+                        leave_tls_slot(*slot);
+                        goto tls_miss;
+                    }
+#ifdef CELL_ENABLE_BUDGET
+                    // Spent from the thread's lease; the slow path below refills it
+                    size_t lease = slot->budget_lease.load(std::memory_order_relaxed);
+                    if (CELL_UNLIKELY(lease < budget_size)) {
+                        leave_tls_slot(*slot);
+                        goto tls_miss;
+                    }
+                    slot->budget_lease.store(lease - budget_size, std::memory_order_relaxed);
+#endif
                     result = cache.blocks[--cache.count];
+#ifdef CELL_HARDENED
+                    if (CELL_UNLIKELY(--slot->check_countdown == 0)) {
+                        slot->check_countdown = kHardenedCheckInterval;
+                        hardened_check_freed(static_cast<FreeBlock *>(result));
+                    }
+                    hardened_claim(result);
+#endif
+                    leave_tls_slot(*slot);
 #ifdef CELL_ENABLE_STATS
-                    m_stats.record_alloc(kSizeClasses[bin_index], tag);
-                    m_stats.subcell_allocs.fetch_add(1, std::memory_order_relaxed);
+                    stats_record_alloc(kSizeClasses[bin_index], tag, StatsShard::kSubcellAllocs);
 #endif
 #ifdef CELL_ENABLE_INSTRUMENTATION
                     invoke_alloc_callback(result, size, tag, true);
+#endif
+#ifdef CELL_ENABLE_TRACE
+                    trace_event(TraceKind::kAlloc, result, size, tag, TraceTier::kSubCell);
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+                    heap_profile_alloc(slot, result, size);
 #endif
                     return result;
                 }
-                // TLS cache empty - fall through to slow path
             }
+        tls_miss:
+            // TLS cache empty - fall through to slow path
 #endif
 
-            uint8_t bin_index = get_size_class(alloc_size, alignment);
+#ifdef CELL_ENABLE_BUDGET
+            if (!charge_budget(budget_size)) {
+                return nullptr;
+            }
+#endif
+            uint8_t bin_index = get_size_class<Policy>(alloc_size, alignment);
             if (CELL_UNLIKELY(bin_index == kFullCellMarker)) {
                 // Rare edge case: alignment pushes us to full cell
-                CellData *cell = alloc_cell(tag);
+                CellData *cell = alloc_full_cell(tag);
                 if (cell) {
                     cell->header.size_class = kFullCellMarker;
                     // Return pointer to usable area, not the header
@@ -298,16 +983,20 @@ namespace Cell {
 #endif
 #ifdef CELL_ENABLE_STATS
                 if (result) {
-                    m_stats.record_alloc(kCellSize, tag);
-                    m_stats.cell_allocs.fetch_add(1, std::memory_order_relaxed);
+                    stats_record_alloc(kCellSize, tag, StatsShard::kCellAllocs);
                 }
 #endif
             } else {
                 result = alloc_from_bin(bin_index, tag);
+#ifdef CELL_HARDENED
+                if (result) {
+                    hardened_check_freed(static_cast<FreeBlock *>(result));
+                    hardened_claim(result);
+                }
+#endif
 #ifdef CELL_ENABLE_STATS
                 if (result) {
-                    m_stats.record_alloc(kSizeClasses[bin_index], tag);
-                    m_stats.subcell_allocs.fetch_add(1, std::memory_order_relaxed);
+                    stats_record_alloc(kSizeClasses[bin_index], tag, StatsShard::kSubcellAllocs);
                 }
 #endif
             }
@@ -315,7 +1004,12 @@ namespace Cell {
             // Full cell allocation (up to ~16KB)
             if (!m_allocator)
                 return nullptr;
-            CellData *cell = alloc_cell(tag);
+#ifdef CELL_ENABLE_BUDGET
+            if (!charge_budget(budget_size)) {
+                return nullptr;
+            }
+#endif
+            CellData *cell = alloc_full_cell(tag);
             if (cell) {
                 cell->header.size_class = kFullCellMarker;
                 // Return pointer to usable area, not the header
@@ -326,8 +1020,7 @@ namespace Cell {
 #endif
 #ifdef CELL_ENABLE_STATS
             if (result) {
-                m_stats.record_alloc(kCellSize, tag);
-                m_stats.cell_allocs.fetch_add(1, std::memory_order_relaxed);
+                stats_record_alloc(kCellSize, tag, StatsShard::kCellAllocs);
             }
 #endif
         } else {
@@ -340,6 +1033,11 @@ namespace Cell {
         }
 
         if (!result) {
+#ifdef CELL_ENABLE_BUDGET
+            if (budget_size > 0) {
+                refund_budget(budget_size);
+            }
+#endif
             return nullptr;
         }
 
@@ -368,6 +1066,9 @@ namespace Cell {
             alloc.ptr = result;
             alloc.size = size;
             alloc.tag = tag;
+#ifdef CELL_DEBUG_GUARDS
+            alloc.guarded = will_have_guards;
+#endif
 #ifdef CELL_DEBUG_STACKTRACE
             alloc.stack_depth = capture_stack(alloc.stack, kMaxStackDepth, 2);
 #endif
@@ -375,30 +1076,68 @@ namespace Cell {
         }
 #endif
 
-#ifdef CELL_ENABLE_BUDGET
-        if (budget_size > 0) {
-            record_budget_alloc(budget_size);
-        }
-#endif
-
 #ifdef CELL_ENABLE_INSTRUMENTATION
         invoke_alloc_callback(result, size, tag, true);
 #endif
+#ifdef CELL_ENABLE_TRACE
+        // alloc_large() traces the larger tiers itself
+        if (is_tracing() && size <= usable_cell_size) {
+            bool full_cell = get_header<Policy>(result)->size_class == kFullCellMarker;
+            trace_event(TraceKind::kAlloc, result, size, tag,
+                        full_cell ? TraceTier::kCell : TraceTier::kSubCell);
+        }
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+        // alloc_large() samples the larger tiers itself
+        if (size <= usable_cell_size) {
+            heap_profile_alloc(tls_slot(), result, size);
+        }
+#endif
 
         return result;
     }
 
-    // =========================================================================
+    template <typename Policy>
+    AllocationResult BasicContext<Policy>::alloc_at_least(size_t size, uint8_t tag,
+                                                          size_t alignment) {
+        // The large tier records the size it is given; round it to what gets mapped
+        if (size > kCellSize - kBlockStartOffset &&
+            (size > BuddyAllocator::kMaxAllocSize || !m_buddy) && size <= SIZE_MAX - 4096) {
+            size = align_up(size, 4096);
+        }
+        void *ptr = alloc_bytes(size, tag, alignment);
+        if (!ptr) {
+            return {};
+        }
+#ifdef CELL_DEBUG_GUARDS
+        // Same test as alloc_bytes(): the back guard follows the requested size
+        if (alignment <= kGuardSize && size + (2 * kGuardSize) <= kMaxSubCellSize) {
+            return {ptr, size};
+        }
+#endif
+        return {ptr, usable_size(ptr)};
+    }
+
+    // =========================================================================
     // Batch Allocation API (SIMD-optimized)
     // =========================================================================
 
-    size_t Context::alloc_batch(size_t size, void **out_ptrs, size_t count, uint8_t tag) {
+    template <typename Policy>
+    size_t BasicContext<Policy>::alloc_batch(size_t size, void **out_ptrs, size_t count,
+                                             uint8_t tag) {
         if (CELL_UNLIKELY(count == 0 || !out_ptrs)) {
             return 0;
         }
 
         // Only sub-cell sizes benefit from TLS fast path
-        if (CELL_UNLIKELY(size > kMaxSubCellSize || !m_allocator)) {
+        bool one_by_one = size > kMaxSubCellSize || !m_allocator;
+#ifdef CELL_ENABLE_BUDGET
+        // The whole batch is charged at once; a budget that cannot cover it is
+        // used up one allocation at a time instead
+        size_t block_budget = one_by_one ? 0 : kSizeClasses[get_size_class_fast<Policy>(size)];
+        one_by_one = one_by_one || !charge_budget(count * block_budget, false);
+#endif
+        if (CELL_UNLIKELY(one_by_one)) {
             // Fall back to individual allocations for large sizes
             size_t allocated = 0;
             for (size_t i = 0; i < count; ++i) {
@@ -411,18 +1150,38 @@ namespace Cell {
             return allocated;
         }
 
-        uint8_t bin_index = get_size_class_fast(size);
+        uint8_t bin_index = get_size_class_fast<Policy>(size);
         size_t allocated = 0;
 
-#if !defined(CELL_DEBUG_GUARDS) && !defined(CELL_DEBUG_LEAKS) && !defined(CELL_ENABLE_BUDGET)
+#if !defined(CELL_DEBUG_GUARDS) && !defined(CELL_DEBUG_LEAKS)
         // SIMD-optimized TLS cache drain for supported bins
-        if (CELL_LIKELY(bin_index < kTlsBinCacheCount)) {
-            TlsBinCache &cache = t_bin_cache[bin_index];
+        TlsSlot *slot = bin_index < kTlsBinCacheCount && !tag_heap(tag) ? tls_slot() : nullptr;
+        if (CELL_LIKELY(slot != nullptr)) {
+            TlsSlotScope scope(slot);
+            TlsBinCache &cache = slot->bins[bin_index];
 
             // Fast path: drain TLS cache in batches
-            while (allocated < count && cache.count > 0) {
+            while (allocated < count) {
+                if (cache.count == 0) {
+                    // Whole cells still wanted: carve fresh ones, blocks in address order
+                    allocated += carve_cells(bin_index, out_ptrs + allocated, count - allocated, tag);
+                    if (allocated == count) {
+                        break;
+                    }
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+                    uint64_t latency_start = trace_clock();
+#endif
+                    batch_refill_tls_bin(*slot, bin_index, tag);
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+                    record_latency(slot, LatencyPath::kTlsRefill, latency_start);
+#endif
+                    if (cache.count == 0) {
+                        break;
+                    }
+                }
+
                 // Calculate how many we can take from cache
-                size_t take = std::min(count - allocated, cache.count);
+                size_t take = std::min<size_t>(count - allocated, cache.count);
 
 #if defined(__AVX2__) && defined(__x86_64__)
                 // AVX2: Copy 4 pointers (32 bytes) at a time
@@ -458,23 +1217,23 @@ namespace Cell {
                     out_ptrs[allocated++] = cache.blocks[--cache.count];
                     --take;
                 }
-
-                // Refill cache if empty and need more
-                if (allocated < count && cache.count == 0) {
-                    batch_refill_tls_bin(bin_index, tag);
-                }
             }
 
 #ifdef CELL_ENABLE_STATS
-            m_stats.subcell_allocs.fetch_add(allocated, std::memory_order_relaxed);
-            for (size_t i = 0; i < allocated; ++i) {
-                m_stats.record_alloc(kSizeClasses[bin_index], tag);
-            }
+            stats_record_alloc(kSizeClasses[bin_index], tag, StatsShard::kSubcellAllocs, allocated);
 #endif
         }
 #endif
 
-        // Slow path: allocate remaining individually
+        // Slow path: carve whole cells, then allocate remaining individually
+        if (allocated < count) {
+            size_t carved = carve_cells(bin_index, out_ptrs + allocated, count - allocated, tag);
+            allocated += carved;
+#ifdef CELL_ENABLE_STATS
+            stats_record_alloc(kSizeClasses[bin_index], tag, StatsShard::kSubcellAllocs, carved);
+#endif
+        }
+
         while (allocated < count) {
             void *ptr = alloc_from_bin(bin_index, tag);
             if (!ptr)
@@ -482,109 +1241,249 @@ namespace Cell {
             out_ptrs[allocated++] = ptr;
 
 #ifdef CELL_ENABLE_STATS
-            m_stats.record_alloc(kSizeClasses[bin_index], tag);
-            m_stats.subcell_allocs.fetch_add(1, std::memory_order_relaxed);
+            stats_record_alloc(kSizeClasses[bin_index], tag, StatsShard::kSubcellAllocs);
 #endif
         }
 
+#ifdef CELL_ENABLE_BUDGET
+        if (allocated < count) {
+            refund_budget((count - allocated) * block_budget);
+        }
+#endif
+#ifdef CELL_HARDENED
+        for (size_t i = 0; i < allocated; ++i) {
+            hardened_claim(out_ptrs[i]);
+        }
+#endif
+#ifdef CELL_ENABLE_TRACE
+        if (is_tracing()) {
+            for (size_t i = 0; i < allocated; ++i) {
+                trace_event(TraceKind::kAlloc, out_ptrs[i], size, tag, TraceTier::kSubCell);
+            }
+        }
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+        if (TlsSlot *profile_slot = tls_slot()) {
+            for (size_t i = 0; i < allocated; ++i) {
+                heap_profile_alloc(profile_slot, out_ptrs[i], size);
+            }
+        }
+#endif
         return allocated;
     }
 
-    void Context::free_batch(void **ptrs, size_t count) {
+    template <typename Policy>
+    void *BasicContext<Policy>::alloc_contiguous(size_t size, size_t count, uint8_t tag) {
+        if (CELL_UNLIKELY(size == 0 || size > kMaxSubCellSize || count == 0 || !m_allocator)) {
+            return nullptr;
+        }
+
+        uint8_t bin_index = get_size_class_fast<Policy>(size);
+        if (count > blocks_per_cell<Policy>(bin_index)) {
+            return nullptr;
+        }
+
+#ifdef CELL_ENABLE_BUDGET
+        size_t budget_size = count * kSizeClasses[bin_index];
+        if (!reserve_budget(budget_size)) {
+            return nullptr;
+        }
+#endif
+
+        void *first = carve_cell(bin_index, count, tag);
+        if (!first) {
+#ifdef CELL_ENABLE_BUDGET
+            record_budget_free(budget_size);
+#endif
+            return nullptr;
+        }
+#ifdef CELL_HARDENED
+        for (size_t i = 0; i < count; ++i) {
+            hardened_claim(static_cast<char *>(first) + i * kSizeClasses[bin_index]);
+        }
+#endif
+
+#ifdef CELL_ENABLE_STATS
+        stats_record_alloc(kSizeClasses[bin_index], tag, StatsShard::kSubcellAllocs, count);
+#endif
+#ifdef CELL_ENABLE_TRACE
+        if (is_tracing()) {
+            for (size_t i = 0; i < count; ++i) {
+                void *block = static_cast<char *>(first) + i * kSizeClasses[bin_index];
+                trace_event(TraceKind::kAlloc, block, size, tag, TraceTier::kSubCell);
+            }
+        }
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+        if (TlsSlot *slot = tls_slot()) {
+            for (size_t i = 0; i < count; ++i) {
+                heap_profile_alloc(slot, static_cast<char *>(first) + i * kSizeClasses[bin_index],
+                                   size);
+            }
+        }
+#endif
+
+        return first;
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::free_batch(void **ptrs, size_t count) {
         if (CELL_UNLIKELY(count == 0 || !ptrs)) {
             return;
         }
 
-#if !defined(CELL_DEBUG_GUARDS) && !defined(CELL_DEBUG_LEAKS) && !defined(CELL_ENABLE_BUDGET)
-        // Fast path: check if first pointer is in cell region
-        auto uptr = reinterpret_cast<uintptr_t>(ptrs[0]);
+#if !defined(CELL_DEBUG_GUARDS) && !defined(CELL_DEBUG_LEAKS) &&                                   \
+    !defined(CELL_ENABLE_INSTRUMENTATION)
         auto base = reinterpret_cast<uintptr_t>(m_base);
+        TlsSlot *slot = tls_slot();
+        TlsSlotScope scope(slot);
 
-        if (CELL_LIKELY(uptr >= base && uptr < base + m_reserved_size)) {
-            // Get size class from first pointer
-            CellHeader *first_header = get_header(ptrs[0]);
-            uint8_t size_class = first_header->size_class;
+        // Sub-cell blocks that miss the TLS cache are chained per bin, through the
+        // freed blocks themselves, and returned to their cells under one lock per bin
+        FreeBlock *deferred[kNumSizeBins] = {};
 
-#ifndef NDEBUG
-            // Validate homogeneous batch - mixed sizes corrupt freelists
-            for (size_t i = 1; i < count; ++i) {
-                auto iptr = reinterpret_cast<uintptr_t>(ptrs[i]);
-                assert(iptr >= base && iptr < base + m_reserved_size &&
-                       "free_batch requires all pointers in cell region");
-                CellHeader *h = get_header(ptrs[i]);
-                assert(h->size_class == size_class &&
-                       "free_batch requires all pointers to have same size class");
-            }
+        // Buddy blocks the TLS buddy cache does not hold go back under one m_lock
+        void *buddy_pending[kFreeBatchBuddyChunk];
+        size_t buddy_count = 0;
+#ifdef CELL_ENABLE_BUDGET
+        size_t budget_freed = 0; // Credited once at the end; free_to_tls() credits its own
 #endif
 
-            if (CELL_LIKELY(size_class < kTlsBinCacheCount)) {
-                TlsBinCache &cache = t_bin_cache[size_class];
-                size_t freed = 0;
+        for (size_t i = 0; i < count; ++i) {
+            void *ptr = ptrs[i];
+            auto uptr = reinterpret_cast<uintptr_t>(ptr);
 
-                // SIMD-optimized TLS cache fill
-                while (freed < count && cache.count < kTlsBinCacheCapacity) {
-                    size_t space = kTlsBinCacheCapacity - cache.count;
-                    size_t push = std::min(count - freed, space);
+            if (CELL_LIKELY(uptr >= base && uptr < base + m_reserved_size)) {
+                CellHeader *header = get_header<Policy>(ptr);
+                uint8_t size_class = header->size_class;
 
-#if defined(__AVX2__) && defined(__x86_64__)
-                    // AVX2: Copy 4 pointers at a time
-                    while (push >= 4) {
-                        __m256i block_ptrs =
-                            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&ptrs[freed]));
-                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(&cache.blocks[cache.count]),
-                                            block_ptrs);
-                        cache.count += 4;
-                        freed += 4;
-                        push -= 4;
-                    }
-#elif defined(__SSE2__) && defined(__x86_64__)
-                    // SSE2: Copy 2 pointers at a time
-                    while (push >= 2) {
-                        __m128i block_ptrs =
-                            _mm_loadu_si128(reinterpret_cast<const __m128i *>(&ptrs[freed]));
-                        _mm_storeu_si128(reinterpret_cast<__m128i *>(&cache.blocks[cache.count]),
-                                         block_ptrs);
-                        cache.count += 2;
-                        freed += 2;
-                        push -= 2;
-                    }
+                if (CELL_UNLIKELY(size_class == kFullCellMarker)) {
+#ifdef CELL_ENABLE_STATS
+                    stats_record_free(kCellSize, header->tag, StatsShard::kCellFrees);
 #endif
-                    // Scalar fallback
-                    while (push > 0) {
-                        cache.blocks[cache.count++] = static_cast<FreeBlock *>(ptrs[freed++]);
-                        --push;
-                    }
+#ifdef CELL_ENABLE_TRACE
+                    trace_event(TraceKind::kFree, ptr, kCellSize, header->tag, TraceTier::kCell);
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+                    heap_profile_free(ptr);
+#endif
+#ifdef CELL_ENABLE_BUDGET
+                    budget_freed += kCellSize;
+#endif
+                    free_full_cell(header);
+                    continue;
                 }
 
-#ifdef CELL_ENABLE_STATS
-                m_stats.subcell_frees.fetch_add(freed, std::memory_order_relaxed);
+#ifdef CELL_ENABLE_TRACE
+                trace_event(TraceKind::kFree, ptr, kSizeClasses[size_class], header->tag,
+                            TraceTier::kSubCell);
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+                heap_profile_free(ptr);
 #endif
+                if (CELL_LIKELY(size_class < kTlsBinCacheCount) &&
+                    free_to_tls(slot, ptr, header, size_class)) {
+                    continue;
+                }
 
-                // Fall through to free remaining
-                if (freed == count) {
-                    return;
+#ifdef CELL_HARDENED
+                hardened_release(ptr, header, size_class);
+#endif
+#ifndef NDEBUG
+                std::memset(ptr, kPoisonByte, kSizeClasses[size_class]);
+#endif
+#ifdef CELL_ENABLE_STATS
+                stats_record_free(kSizeClasses[size_class], header->tag, StatsShard::kSubcellFrees);
+#endif
+#ifdef CELL_ENABLE_BUDGET
+                budget_freed += kSizeClasses[size_class];
+#endif
+                if (CELL_UNLIKELY(in_tag_heap(header))) {
+                    free_to_tag_heap(ptr, header);
+                    continue;
                 }
+                auto *block = static_cast<FreeBlock *>(ptr);
+                block->set_next(deferred[size_class], free_list_key());
+                deferred[size_class] = block;
+                continue;
+            }
 
-                // Free remaining that didn't fit in TLS cache
-                for (size_t i = freed; i < count; ++i) {
-                    free_bytes(ptrs[i]);
+            if (ptr && m_buddy && m_buddy->owns(ptr)) {
+#ifdef CELL_ENABLE_STATS
+                stats_count(StatsShard::kBuddyFrees, 1);
+#endif
+#ifdef CELL_ENABLE_TRACE
+                trace_free(ptr);
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+                heap_profile_free(ptr);
+#endif
+#ifdef CELL_ENABLE_BUDGET
+                budget_freed += m_buddy->get_alloc_size(ptr);
+#endif
+                size_t cache_index = BuddyAllocator::get_block_order(ptr) - BuddyAllocator::kMinOrder;
+                if (slot && cache_index < kTlsBuddyCacheOrders) {
+                    free_buddy(ptr);
+                    continue;
                 }
-                return;
+                buddy_pending[buddy_count++] = ptr;
+                if (buddy_count == kFreeBatchBuddyChunk) {
+                    m_buddy->free_batch(buddy_pending, buddy_count);
+                    buddy_count = 0;
+                }
+                continue;
             }
+
+            // Large blocks each cost a cache insert or an unmap; nothing to amortize
+            free_bytes(ptr);
+        }
+
+        if (buddy_count > 0) {
+            m_buddy->free_batch(buddy_pending, buddy_count);
+        }
+#ifdef CELL_ENABLE_BUDGET
+        if (budget_freed > 0) {
+            credit_budget(slot, budget_freed);
         }
 #endif
 
-        // Fallback: free individually
+        for (size_t bin_index = 0; bin_index < kNumSizeBins; ++bin_index) {
+            if (!deferred[bin_index]) {
+                continue;
+            }
+            // Only the cached classes have a cache (and an owned cell) in the slot
+            if (slot && bin_index < kTlsBinCacheCount) {
+                return_blocks_to_cells(*slot, bin_index, deferred[bin_index]);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock = lock_bin(bin_index);
+            for (FreeBlock *block = deferred[bin_index]; block;) {
+                FreeBlock *next = next_free(block);
+                release_block_to_cell(bin_index, get_header<Policy>(block), block);
+                block = next;
+            }
+        }
+#else
+        // Debug and instrumentation builds keep their bookkeeping in free_bytes()
         for (size_t i = 0; i < count; ++i) {
             free_bytes(ptrs[i]);
         }
+#endif
     }
 
-    void Context::free_bytes(void *ptr) {
+    template <typename Policy>
+    void BasicContext<Policy>::free_bytes(void *ptr) {
         if (CELL_UNLIKELY(!ptr)) {
             return;
         }
 
+#ifdef CELL_ENABLE_TRACE
+        trace_free(ptr);
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+        heap_profile_free(ptr);
+#endif
+
 #ifdef CELL_ENABLE_INSTRUMENTATION
         // For instrumentation, we need the size before we lose it
         // The callback will receive the originally requested size if available,
@@ -596,11 +1495,17 @@ namespace Cell {
 #ifdef CELL_DEBUG_LEAKS
         // Remove from tracking and get allocation size
         size_t alloc_size = 0;
+#ifdef CELL_DEBUG_GUARDS
+        bool alloc_guarded = false;
+#endif
         {
             std::lock_guard<std::mutex> lock(m_debug_mutex);
             auto it = m_live_allocs.find(ptr);
             if (it != m_live_allocs.end()) {
                 alloc_size = it->second.size;
+#ifdef CELL_DEBUG_GUARDS
+                alloc_guarded = it->second.guarded;
+#endif
 #ifdef CELL_ENABLE_INSTRUMENTATION
                 callback_size = it->second.size;
                 callback_tag = it->second.tag;
@@ -621,25 +1526,14 @@ namespace Cell {
 
         if (CELL_LIKELY(uptr >= base && uptr < base + m_reserved_size)) {
             // Cell/sub-cell allocation - this is the hot path
-#if !defined(CELL_DEBUG_GUARDS) && !defined(CELL_DEBUG_LEAKS) && !defined(CELL_ENABLE_BUDGET)
+#if !defined(CELL_DEBUG_GUARDS) && !defined(CELL_DEBUG_LEAKS)
             // Ultra-fast path: inline TLS free for hot bins
-            CellHeader *header = get_header(ptr);
+            CellHeader *header = get_header<Policy>(ptr);
             uint8_t size_class = header->size_class;
 
-            if (CELL_LIKELY(size_class < kTlsBinCacheCount)) {
-                // Hot bin - try TLS cache first
-                TlsBinCache &cache = t_bin_cache[size_class];
-                if (CELL_LIKELY(cache.count < kTlsBinCacheCapacity)) {
-#ifndef NDEBUG
-                    std::memset(ptr, kPoisonByte, kSizeClasses[size_class]);
-#endif
-#ifdef CELL_ENABLE_STATS
-                    m_stats.record_free(kSizeClasses[size_class], header->tag);
-                    m_stats.subcell_frees.fetch_add(1, std::memory_order_relaxed);
-#endif
-                    cache.blocks[cache.count++] = static_cast<FreeBlock *>(ptr);
-                    return;
-                }
+            if (CELL_LIKELY(size_class < kTlsBinCacheCount) &&
+                free_to_tls(tls_slot(), ptr, header, size_class)) {
+                return;
             }
 #endif
             // Fall through to normal cell/sub-cell handling
@@ -649,18 +1543,18 @@ namespace Cell {
         // Slower path: check buddy and large allocations
         if (m_buddy && m_buddy->owns(ptr)) {
 #ifdef CELL_ENABLE_STATS
-            m_stats.buddy_frees.fetch_add(1, std::memory_order_relaxed);
+            stats_count(StatsShard::kBuddyFrees, 1);
 #endif
 #ifdef CELL_ENABLE_BUDGET
             record_budget_free(m_buddy->get_alloc_size(ptr));
 #endif
-            m_buddy->free(ptr);
+            free_buddy(ptr);
             return;
         }
 
         if (m_large_allocs.owns(ptr)) {
 #ifdef CELL_ENABLE_STATS
-            m_stats.large_frees.fetch_add(1, std::memory_order_relaxed);
+            stats_count(StatsShard::kLargeFrees, 1);
 #endif
 #ifdef CELL_ENABLE_BUDGET
             record_budget_free(m_large_allocs.get_alloc_size(ptr));
@@ -679,10 +1573,9 @@ namespace Cell {
         // For full-cell allocations or large sub-cell allocations, no guards
 
 #if defined(CELL_DEBUG_GUARDS) && defined(CELL_DEBUG_LEAKS)
-        // Determine if guards were applied based on allocation size
-        // Guards are only applied when: size + 2*kGuardSize <= kMaxSubCellSize
-        // Since alloc_size stores the original requested size, check that
-        bool has_guards = (alloc_size > 0 && (alloc_size + 2 * kGuardSize) <= kMaxSubCellSize);
+        // alloc_bytes() records whether it applied guards: only for sub-cell sizes
+        // that fit them (size + 2*kGuardSize <= kMaxSubCellSize) at default alignment
+        bool has_guards = alloc_guarded;
 
         if (has_guards) {
             auto *user_ptr = static_cast<uint8_t *>(ptr);
@@ -718,7 +1611,7 @@ namespace Cell {
         }
 #endif
 
-        CellHeader *header = get_header(ptr);
+        CellHeader *header = get_header<Policy>(ptr);
 
 #ifdef CELL_ENABLE_STATS
         uint8_t tag = header->tag;
@@ -727,29 +1620,140 @@ namespace Cell {
         if (header->size_class == kFullCellMarker) {
             // Full-cell allocation
 #ifdef CELL_ENABLE_STATS
-            m_stats.record_free(kCellSize, tag);
-            m_stats.cell_frees.fetch_add(1, std::memory_order_relaxed);
+            stats_record_free(kCellSize, tag, StatsShard::kCellFrees);
 #endif
 #ifdef CELL_ENABLE_BUDGET
             record_budget_free(kCellSize);
 #endif
-            free_cell(reinterpret_cast<CellData *>(header));
+            free_full_cell(header);
         } else {
-            // Sub-cell allocation
+            free_subcell(ptr, header);
+        }
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::free_subcell(void *ptr, CellHeader *header) {
 #ifdef CELL_ENABLE_STATS
-            size_t block_size = kSizeClasses[header->size_class];
-            m_stats.record_free(block_size, tag);
-            m_stats.subcell_frees.fetch_add(1, std::memory_order_relaxed);
+        stats_record_free(kSizeClasses[header->size_class], header->tag,
+                          StatsShard::kSubcellFrees);
 #endif
 #ifdef CELL_ENABLE_BUDGET
-            size_t budget_block_size = kSizeClasses[header->size_class];
-            record_budget_free(budget_block_size);
+        record_budget_free(kSizeClasses[header->size_class]);
+#endif
+        free_to_bin(ptr, header);
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::free_sized(void *ptr, size_t size) {
+#if !defined(CELL_DEBUG_GUARDS) && !defined(CELL_DEBUG_LEAKS) &&                                   \
+    !defined(CELL_ENABLE_INSTRUMENTATION)
+        if (CELL_UNLIKELY(!ptr)) {
+            return;
+        }
+
+        auto uptr = reinterpret_cast<uintptr_t>(ptr);
+        auto base = reinterpret_cast<uintptr_t>(m_base);
+        bool in_cells = uptr >= base && uptr < base + m_reserved_size;
+
+        if (CELL_LIKELY(size <= kMaxSubCellSize)) {
+            // The size names the bin; the header only has to agree with it
+            uint8_t bin_index = get_size_class_fast<Policy>(size);
+            if (CELL_LIKELY(in_cells)) {
+                CellHeader *header = get_header<Policy>(ptr);
+#ifdef CELL_ENABLE_HEAP_PROFILE
+                // Before the block can spill to its bin; free_bytes() finds nothing left
+                heap_profile_free(ptr);
+#endif
+                if (CELL_LIKELY(header->size_class == bin_index) &&
+                    CELL_LIKELY(bin_index < kTlsBinCacheCount)) {
+#ifdef CELL_ENABLE_TRACE
+                    // Before free_to_tls() publishes the block: its owner may reuse it at once
+                    trace_event(TraceKind::kFree, ptr, kSizeClasses[bin_index], header->tag,
+                                TraceTier::kSubCell);
+#endif
+                    if (CELL_UNLIKELY(!free_to_tls(tls_slot(), ptr, header, bin_index))) {
+                        free_subcell(ptr, header); // Traced already, unlike free_bytes()
+                    }
+                    return;
+                }
+            }
+        } else if (size > BuddyAllocator::kMaxAllocSize && free_large_direct(ptr, in_cells)) {
+            return;
+        }
+#else
+        (void)size;
+#endif
+        // Debug and instrumentation builds keep their bookkeeping in free_bytes()
+        free_bytes(ptr);
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::free_aligned_sized(void *ptr, size_t size, size_t alignment) {
+#if !defined(CELL_DEBUG_GUARDS) && !defined(CELL_DEBUG_LEAKS) &&                                   \
+    !defined(CELL_ENABLE_INSTRUMENTATION)
+        // Over-aligned sub-cell sizes came from the power-of-2 class alloc_bytes()
+        // picked for the alignment; larger ones only from the large tier
+        if (alignment > kSizeClassGranularity && ptr) {
+            auto uptr = reinterpret_cast<uintptr_t>(ptr);
+            auto base = reinterpret_cast<uintptr_t>(m_base);
+            bool in_cells = uptr >= base && uptr < base + m_reserved_size;
+            uint8_t bin_index = alignment <= kMaxSubCellSize
+                                    ? get_size_class<Policy>(size, alignment)
+                                    : kFullCellMarker;
+            if (bin_index != kFullCellMarker) {
+                if (CELL_LIKELY(in_cells)) {
+                    CellHeader *header = get_header<Policy>(ptr);
+#ifdef CELL_ENABLE_HEAP_PROFILE
+                    heap_profile_free(ptr);
+#endif
+                    if (CELL_LIKELY(header->size_class == bin_index) &&
+                        CELL_LIKELY(bin_index < kTlsBinCacheCount)) {
+#ifdef CELL_ENABLE_TRACE
+                        // Before the block is published, as in free_sized()
+                        trace_event(TraceKind::kFree, ptr, kSizeClasses[bin_index], header->tag,
+                                    TraceTier::kSubCell);
+#endif
+                        if (CELL_UNLIKELY(!free_to_tls(tls_slot(), ptr, header, bin_index))) {
+                            free_subcell(ptr, header);
+                        }
+                        return;
+                    }
+                }
+            } else if (free_large_direct(ptr, in_cells)) {
+                return;
+            }
+        }
+#else
+        (void)alignment;
 #endif
-            free_to_bin(ptr, header);
+        free_sized(ptr, size);
+    }
+
+    template <typename Policy>
+    bool BasicContext<Policy>::free_large_direct(void *ptr, bool in_cells) {
+        // Cell and buddy ranges are cheap to rule out; the registry lookup is left
+        // to LargeAllocRegistry::free() instead of being done twice
+        if (in_cells || (m_buddy && m_buddy->owns(ptr))) {
+            return false;
         }
+#ifdef CELL_ENABLE_STATS
+        stats_count(StatsShard::kLargeFrees, 1);
+#endif
+#ifdef CELL_ENABLE_TRACE
+        trace_free(ptr);
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+        heap_profile_free(ptr);
+#endif
+#ifdef CELL_ENABLE_BUDGET
+        record_budget_free(m_large_allocs.get_alloc_size(ptr));
+#endif
+        m_large_allocs.free(ptr);
+        return true;
     }
 
-    void *Context::realloc_bytes(void *ptr, size_t new_size, uint8_t tag) {
+    template <typename Policy>
+    void *BasicContext<Policy>::realloc_bytes(void *ptr, size_t new_size, uint8_t tag) {
         // Edge case: nullptr -> behaves like alloc
         if (!ptr) {
             return alloc_bytes(new_size, tag);
@@ -764,8 +1768,31 @@ namespace Cell {
         // Check buddy tier first
         if (m_buddy && m_buddy->owns(ptr)) {
             // For buddy allocations, check if new size still fits in buddy range
-            if (new_size <= BuddyAllocator::kMaxBlockSize &&
+            if (new_size <= BuddyAllocator::kMaxAllocSize &&
                 new_size >= BuddyAllocator::kMinBlockSize) {
+                // Same order: the block already fits, so skip the tracking round trip
+                size_t block_size = m_buddy->get_alloc_size(ptr);
+                size_t needed = new_size + BuddyAllocator::kHeaderSize;
+                if (needed <= block_size && needed > block_size / 2) {
+#ifdef CELL_ENABLE_TRACE
+                    trace_event(TraceKind::kRealloc, ptr, new_size, tag, TraceTier::kBuddy);
+#endif
+#ifdef CELL_DEBUG_LEAKS
+                    {
+                        std::lock_guard<std::mutex> lock(m_debug_mutex);
+                        auto it = m_live_allocs.find(ptr);
+                        if (it != m_live_allocs.end()) {
+                            it->second.size = new_size;
+                        }
+                    }
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+                    heap_profile_free(ptr);
+                    heap_profile_alloc(tls_slot(), ptr, new_size);
+#endif
+                    return ptr;
+                }
+
                 // Stay in buddy tier - delegate to buddy realloc
                 // Note: buddy realloc doesn't know about leak tracking, so we handle it here
 #ifdef CELL_DEBUG_LEAKS
@@ -778,8 +1805,23 @@ namespace Cell {
                         m_live_allocs.erase(it);
                     }
                 }
+#endif
+#ifdef CELL_ENABLE_TRACE
+                size_t trace_old_size = is_tracing() ? m_buddy->get_alloc_size(ptr) : 0;
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+                // Resampled as a new allocation, like one that moved
+                heap_profile_free(ptr);
 #endif
                 void *result = m_buddy->realloc_bytes(ptr, new_size);
+#ifdef CELL_ENABLE_TRACE
+                trace_realloc(ptr, trace_old_size, result, new_size, tag, TraceTier::kBuddy);
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+                if (result) {
+                    heap_profile_alloc(tls_slot(), result, new_size);
+                }
+#endif
 #ifdef CELL_DEBUG_LEAKS
                 if (result) {
                     std::lock_guard<std::mutex> lock(m_debug_mutex);
@@ -806,17 +1848,32 @@ namespace Cell {
             if (!new_ptr)
                 return nullptr;
             // Copy min(old_usable, new_size) to avoid reading past old allocation
-            size_t old_usable = m_buddy->get_alloc_size(ptr) - 8; // Subtract header
+            size_t old_usable = m_buddy->get_alloc_size(ptr) - BuddyAllocator::kHeaderSize;
             std::memcpy(new_ptr, ptr, std::min(old_usable, new_size));
-            m_buddy->free(ptr);
+#ifdef CELL_ENABLE_TRACE
+            trace_free(ptr);
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+            heap_profile_free(ptr);
+#endif
+            free_buddy(ptr);
             return new_ptr;
         }
 
         // Check large tier
         if (m_large_allocs.owns(ptr)) {
-            // For large allocations, check if new size still needs large
-            if (new_size > BuddyAllocator::kMaxBlockSize) {
+            // For large allocations, check if new size still needs large; growth
+            // always stays so reserved blocks keep growing in place
+            if (new_size > BuddyAllocator::kMaxAllocSize ||
+                new_size >= m_large_allocs.get_alloc_size(ptr)) {
                 // Stay in large tier
+#ifdef CELL_ENABLE_BUDGET
+                size_t old_budget_size = m_large_allocs.get_alloc_size(ptr);
+                size_t budget_growth = new_size > old_budget_size ? new_size - old_budget_size : 0;
+                if (budget_growth > 0 && !reserve_budget(budget_growth)) {
+                    return nullptr;
+                }
+#endif
 #ifdef CELL_DEBUG_LEAKS
                 {
                     std::lock_guard<std::mutex> lock(m_debug_mutex);
@@ -825,8 +1882,29 @@ namespace Cell {
                         m_live_allocs.erase(it);
                     }
                 }
+#endif
+#ifdef CELL_ENABLE_TRACE
+                size_t trace_old_size = is_tracing() ? m_large_allocs.get_alloc_size(ptr) : 0;
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+                heap_profile_free(ptr);
 #endif
                 void *result = m_large_allocs.realloc_bytes(ptr, new_size, tag);
+#ifdef CELL_ENABLE_TRACE
+                trace_realloc(ptr, trace_old_size, result, new_size, tag, TraceTier::kLarge);
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+                if (result) {
+                    heap_profile_alloc(tls_slot(), result, new_size);
+                }
+#endif
+#ifdef CELL_ENABLE_BUDGET
+                if (result) {
+                    settle_budget(old_budget_size + budget_growth, new_size);
+                } else {
+                    record_budget_free(budget_growth);
+                }
+#endif
 #ifdef CELL_DEBUG_LEAKS
                 if (result) {
                     std::lock_guard<std::mutex> lock(m_debug_mutex);
@@ -855,17 +1933,46 @@ namespace Cell {
             // Copy min(old_size, new_size) to avoid reading past old allocation
             size_t old_size = m_large_allocs.get_alloc_size(ptr);
             std::memcpy(new_ptr, ptr, std::min(old_size, new_size));
+#ifdef CELL_ENABLE_TRACE
+            trace_free(ptr);
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+            heap_profile_free(ptr);
+#endif
             m_large_allocs.free(ptr);
             return new_ptr;
         }
 
         // Must be cell/sub-cell allocation
-        CellHeader *header = get_header(ptr);
+        CellHeader *header = get_header<Policy>(ptr);
         size_t old_size;
 
         if (header->size_class == kFullCellMarker) {
             // Full cell allocation
             old_size = kCellSize - kBlockStartOffset;
+
+            // Still past the size classes and within the cell: keep it
+            size_t cell_left = reinterpret_cast<uintptr_t>(header) + kCellSize -
+                               reinterpret_cast<uintptr_t>(ptr);
+            if (new_size > kMaxSubCellSize && new_size <= cell_left) {
+#ifdef CELL_ENABLE_TRACE
+                trace_event(TraceKind::kRealloc, ptr, new_size, header->tag, TraceTier::kCell);
+#endif
+#ifdef CELL_DEBUG_LEAKS
+                {
+                    std::lock_guard<std::mutex> lock(m_debug_mutex);
+                    auto it = m_live_allocs.find(ptr);
+                    if (it != m_live_allocs.end()) {
+                        it->second.size = new_size;
+                    }
+                }
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+                heap_profile_free(ptr);
+                heap_profile_alloc(tls_slot(), ptr, new_size);
+#endif
+                return ptr;
+            }
         } else {
             // Sub-cell allocation
             old_size = kSizeClasses[header->size_class];
@@ -877,11 +1984,18 @@ namespace Cell {
             if (new_size + (2 * kGuardSize) <= kMaxSubCellSize) {
                 alloc_size = new_size + (2 * kGuardSize);
             }
-            uint8_t new_bin = get_size_class(alloc_size, 8);
+            uint8_t new_bin = get_size_class<Policy>(alloc_size, 8);
 #else
-            uint8_t new_bin = get_size_class(new_size, 8);
+            uint8_t new_bin = get_size_class<Policy>(new_size, 8);
 #endif
             if (new_bin != kFullCellMarker && new_bin == header->size_class) {
+#ifdef CELL_ENABLE_TRACE
+                trace_event(TraceKind::kRealloc, ptr, new_size, header->tag, TraceTier::kSubCell);
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+                heap_profile_free(ptr);
+                heap_profile_alloc(tls_slot(), ptr, new_size);
+#endif
                 return ptr; // Fits in same bin, no reallocation needed
             }
         }
@@ -902,7 +2016,8 @@ namespace Cell {
     // Large Allocation API
     // =========================================================================
 
-    void *Context::alloc_large(size_t size, uint8_t tag, bool try_huge_pages) {
+    template <typename Policy>
+    void *BasicContext<Policy>::alloc_large(size_t size, uint8_t tag, bool try_huge_pages) {
         if (size == 0) {
             return nullptr;
         }
@@ -910,13 +2025,13 @@ namespace Cell {
         void *result = nullptr;
 
 #ifdef CELL_ENABLE_BUDGET
-        // Calculate budget size upfront for check_budget
-        // Buddy allocations round to power-of-2 including 8-byte header
+        // Reserve the budget upfront, trued up to get_alloc_size() afterwards
+        // Buddy allocations round to power-of-2 including the block header
         // Large allocations get page-rounded sizes
         size_t budget_size = 0;
-        if (size <= BuddyAllocator::kMaxBlockSize && m_buddy) {
-            // Calculate buddy rounded size (power-of-2 >= size + 8 byte header)
-            size_t total = size + 8; // header
+        if (size <= BuddyAllocator::kMaxAllocSize && m_buddy) {
+            // Calculate buddy rounded size (power-of-2 >= size + header)
+            size_t total = size + BuddyAllocator::kHeaderSize;
             if (total < BuddyAllocator::kMinBlockSize) {
                 budget_size = BuddyAllocator::kMinBlockSize;
             } else {
@@ -927,25 +2042,23 @@ namespace Cell {
                 }
             }
         } else {
-            // Large allocation - page-aligned, approximate as requested size
-            // (record_budget_alloc will use get_alloc_size for actual)
+            // Large allocation - the registry records the requested size
             budget_size = size;
         }
 
-        if (!check_budget(budget_size)) {
+        if (!reserve_budget(budget_size)) {
             return nullptr;
         }
 #endif
 
-        // Route: <= 2MB to buddy, > 2MB to direct OS
-        if (size <= BuddyAllocator::kMaxBlockSize) {
+        // Route: what fits a 2MB block with its header to buddy, the rest to direct OS
+        if (size <= BuddyAllocator::kMaxAllocSize) {
             if (m_buddy) {
-                result = m_buddy->alloc(size);
+                result = alloc_buddy(size);
 #ifdef CELL_ENABLE_STATS
                 if (result) {
                     // Buddy rounds up to power-of-2
-                    m_stats.record_alloc(size, tag);
-                    m_stats.buddy_allocs.fetch_add(1, std::memory_order_relaxed);
+                    stats_record_alloc(size, tag, StatsShard::kBuddyAllocs);
                 }
 #endif
 #ifdef CELL_ENABLE_INSTRUMENTATION
@@ -953,11 +2066,19 @@ namespace Cell {
                     invoke_alloc_callback(result, size, tag, true);
                 }
 #endif
-#ifdef CELL_ENABLE_BUDGET
+#ifdef CELL_ENABLE_TRACE
                 if (result) {
-                    // Use actual rounded size for budget
-                    record_budget_alloc(m_buddy->get_alloc_size(result));
+                    trace_event(TraceKind::kAlloc, result, size, tag, TraceTier::kBuddy);
                 }
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+                if (result) {
+                    heap_profile_alloc(tls_slot(), result, size);
+                }
+#endif
+#ifdef CELL_ENABLE_BUDGET
+                // Use actual rounded size for budget
+                settle_budget(budget_size, result ? m_buddy->get_alloc_size(result) : 0);
 #endif
                 return result;
             }
@@ -965,11 +2086,16 @@ namespace Cell {
         }
 
         // Direct OS allocation for > 2MB
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+        uint64_t latency_start = trace_clock();
+#endif
         result = m_large_allocs.alloc(size, tag, try_huge_pages);
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+        record_latency(tls_slot(), LatencyPath::kLarge, latency_start);
+#endif
 #ifdef CELL_ENABLE_STATS
         if (result) {
-            m_stats.record_alloc(size, tag);
-            m_stats.large_allocs.fetch_add(1, std::memory_order_relaxed);
+            stats_record_alloc(size, tag, StatsShard::kLargeAllocs);
         }
 #endif
 #ifdef CELL_ENABLE_INSTRUMENTATION
@@ -977,59 +2103,131 @@ namespace Cell {
             invoke_alloc_callback(result, size, tag, true);
         }
 #endif
-#ifdef CELL_ENABLE_BUDGET
+#ifdef CELL_ENABLE_TRACE
         if (result) {
-            record_budget_alloc(m_large_allocs.get_alloc_size(result));
+            trace_event(TraceKind::kAlloc, result, size, tag, TraceTier::kLarge);
         }
 #endif
-        return result;
-    }
-
-    void Context::free_large(void *ptr) {
-        if (!ptr)
-            return;
-
-#ifdef CELL_ENABLE_INSTRUMENTATION
-        // Get size before freeing for callback
-        size_t freed_size = 0;
-        if (m_buddy && m_buddy->owns(ptr)) {
-            freed_size = m_buddy->get_alloc_size(ptr);
-        } else {
-            freed_size = m_large_allocs.get_alloc_size(ptr);
+#ifdef CELL_ENABLE_HEAP_PROFILE
+        if (result) {
+            heap_profile_alloc(tls_slot(), result, size);
         }
-        invoke_alloc_callback(ptr, freed_size, 0, false);
-#endif
-
-        if (m_buddy && m_buddy->owns(ptr)) {
-#ifdef CELL_ENABLE_STATS
-            m_stats.buddy_frees.fetch_add(1, std::memory_order_relaxed);
 #endif
-            m_buddy->free(ptr);
-        } else {
-#ifdef CELL_ENABLE_STATS
-            m_stats.large_frees.fetch_add(1, std::memory_order_relaxed);
+#ifdef CELL_ENABLE_BUDGET
+        settle_budget(budget_size, result ? m_large_allocs.get_alloc_size(result) : 0);
 #endif
-            m_large_allocs.free(ptr);
-        }
+        return result;
     }
 
-    void *Context::alloc_aligned(size_t size, size_t alignment, uint8_t tag) {
+    template <typename Policy>
+    void *BasicContext<Policy>::alloc_reserved(size_t size, size_t reserve_size, uint8_t tag) {
         if (size == 0) {
             return nullptr;
         }
 
-        // Validate alignment is power of 2
-        if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+#ifdef CELL_ENABLE_BUDGET
+        // Only the committed size counts; growth goes through realloc_bytes()
+        if (!reserve_budget(size)) {
             return nullptr;
         }
+#endif
 
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+        uint64_t latency_start = trace_clock();
+#endif
+        void *result = m_large_allocs.alloc_reserved(size, reserve_size, tag);
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+        record_latency(tls_slot(), LatencyPath::kLarge, latency_start);
+#endif
+#ifdef CELL_ENABLE_STATS
+        if (result) {
+            stats_record_alloc(size, tag, StatsShard::kLargeAllocs);
+        }
+#endif
+#ifdef CELL_ENABLE_INSTRUMENTATION
+        if (result) {
+            invoke_alloc_callback(result, size, tag, true);
+        }
+#endif
+#ifdef CELL_ENABLE_TRACE
+        if (result) {
+            trace_event(TraceKind::kAlloc, result, size, tag, TraceTier::kLarge);
+        }
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+        if (result) {
+            heap_profile_alloc(tls_slot(), result, size);
+        }
+#endif
 #ifdef CELL_ENABLE_BUDGET
-        // Calculate budget size upfront for check_budget
+        if (!result) {
+            record_budget_free(size);
+        }
+#endif
+        return result;
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::free_large(void *ptr) {
+        if (!ptr)
+            return;
+
+#ifdef CELL_ENABLE_TRACE
+        trace_free(ptr);
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+        heap_profile_free(ptr);
+#endif
+
+#ifdef CELL_ENABLE_INSTRUMENTATION
+        // Get size before freeing for callback
+        size_t freed_size = 0;
+        if (m_buddy && m_buddy->owns(ptr)) {
+            freed_size = m_buddy->get_alloc_size(ptr);
+        } else {
+            freed_size = m_large_allocs.get_alloc_size(ptr);
+        }
+        invoke_alloc_callback(ptr, freed_size, 0, false);
+#endif
+
+        if (m_buddy && m_buddy->owns(ptr)) {
+#ifdef CELL_ENABLE_STATS
+            stats_count(StatsShard::kBuddyFrees, 1);
+#endif
+            free_buddy(ptr);
+        } else {
+#ifdef CELL_ENABLE_STATS
+            stats_count(StatsShard::kLargeFrees, 1);
+#endif
+            m_large_allocs.free(ptr);
+        }
+    }
+
+    template <typename Policy>
+    void *BasicContext<Policy>::alloc_aligned(size_t size, size_t alignment, uint8_t tag) {
+        if (size == 0) {
+            return nullptr;
+        }
+
+        // Validate alignment is power of 2
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+            return nullptr;
+        }
+
+        // Small blocks come from the size classes, power-of-2 ones being aligned to
+        // their size; this keeps a cache-line-aligned 64B block from taking 32KB
+        if (alignment <= kMaxSubCellSize && align_up(size, alignment) <= kMaxSubCellSize) {
+            return alloc_bytes(size, tag, alignment);
+        }
+
+#ifdef CELL_ENABLE_BUDGET
+        // Reserve the budget upfront, trued up to get_alloc_size() afterwards
         // Similar logic to alloc_large: buddy rounds to power-of-2, large is page-aligned
         size_t budget_size = 0;
-        if (size <= BuddyAllocator::kMaxBlockSize && m_buddy && alignment <= 8) {
+        if (size <= BuddyAllocator::kMaxAllocSize && m_buddy &&
+            alignment <= BuddyAllocator::kHeaderSize) {
             // Will use buddy path - calculate power-of-2 rounded size
-            size_t total = size + 8; // header
+            size_t total = size + BuddyAllocator::kHeaderSize;
             if (total < BuddyAllocator::kMinBlockSize) {
                 budget_size = BuddyAllocator::kMinBlockSize;
             } else {
@@ -1040,20 +2238,20 @@ namespace Cell {
                 }
             }
         } else {
-            // Will use large allocation path - approximate as requested size
+            // Will use large allocation path - the registry records the requested size
             budget_size = size;
         }
 
-        if (!check_budget(budget_size)) {
+        if (!reserve_budget(budget_size)) {
             return nullptr;
         }
 #endif
 
         // For buddy allocations: check if natural power-of-2 alignment is sufficient
-        if (size <= BuddyAllocator::kMaxBlockSize && m_buddy) {
+        if (size <= BuddyAllocator::kMaxAllocSize && m_buddy) {
             // Calculate the order (and thus natural alignment) for this size
-            // Account for buddy header (8 bytes)
-            size_t total_size = size + 8;
+            // Account for the buddy header
+            size_t total_size = size + BuddyAllocator::kHeaderSize;
             if (total_size < BuddyAllocator::kMinBlockSize) {
                 total_size = BuddyAllocator::kMinBlockSize;
             }
@@ -1064,22 +2262,14 @@ namespace Cell {
                 block_size = BuddyAllocator::kMaxBlockSize;
             }
 
-            // Buddy blocks are naturally aligned to their size.
-            // The user pointer is offset by 8 bytes (header), so actual alignment
-            // is min(block_size, block_alignment_after_8_byte_offset).
-            // For power-of-2 blocks >= 32KB aligned, offset by 8 is still 8-byte aligned
-            // but the overall block is block_size aligned.
-            //
-            // If requested alignment <= block_size and block_size >= alignment,
-            // we can use buddy. Otherwise, use LargeAllocRegistry.
-            // Buddy user pointers are offset by 8-byte header from block start.
-            // Only 8-byte alignment is guaranteed regardless of block size.
-            if (alignment <= 8) {
-                void *result = m_buddy->alloc(size);
+            // Buddy blocks are naturally aligned to their size, but the user pointer
+            // is offset by the header, so only kHeaderSize alignment is guaranteed
+            // regardless of block size. Anything stricter uses LargeAllocRegistry.
+            if (alignment <= BuddyAllocator::kHeaderSize) {
+                void *result = alloc_buddy(size);
 #ifdef CELL_ENABLE_STATS
                 if (result) {
-                    m_stats.record_alloc(size, tag);
-                    m_stats.buddy_allocs.fetch_add(1, std::memory_order_relaxed);
+                    stats_record_alloc(size, tag, StatsShard::kBuddyAllocs);
                 }
 #endif
 #ifdef CELL_ENABLE_INSTRUMENTATION
@@ -1087,10 +2277,18 @@ namespace Cell {
                     invoke_alloc_callback(result, size, tag, true);
                 }
 #endif
-#ifdef CELL_ENABLE_BUDGET
+#ifdef CELL_ENABLE_TRACE
+                if (result) {
+                    trace_event(TraceKind::kAlloc, result, size, tag, TraceTier::kBuddy);
+                }
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
                 if (result) {
-                    record_budget_alloc(m_buddy->get_alloc_size(result));
+                    heap_profile_alloc(tls_slot(), result, size);
                 }
+#endif
+#ifdef CELL_ENABLE_BUDGET
+                settle_budget(budget_size, result ? m_buddy->get_alloc_size(result) : 0);
 #endif
                 return result;
             }
@@ -1100,11 +2298,16 @@ namespace Cell {
         // Use LargeAllocRegistry for:
         // - Sizes > 2MB
         // - Alignments exceeding buddy's natural block alignment
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+        uint64_t latency_start = trace_clock();
+#endif
         void *result = m_large_allocs.alloc_aligned(size, alignment, tag);
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+        record_latency(tls_slot(), LatencyPath::kLarge, latency_start);
+#endif
 #ifdef CELL_ENABLE_STATS
         if (result) {
-            m_stats.record_alloc(size, tag);
-            m_stats.large_allocs.fetch_add(1, std::memory_order_relaxed);
+            stats_record_alloc(size, tag, StatsShard::kLargeAllocs);
         }
 #endif
 #ifdef CELL_ENABLE_INSTRUMENTATION
@@ -1112,10 +2315,18 @@ namespace Cell {
             invoke_alloc_callback(result, size, tag, true);
         }
 #endif
-#ifdef CELL_ENABLE_BUDGET
+#ifdef CELL_ENABLE_TRACE
         if (result) {
-            record_budget_alloc(m_large_allocs.get_alloc_size(result));
+            trace_event(TraceKind::kAlloc, result, size, tag, TraceTier::kLarge);
         }
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+        if (result) {
+            heap_profile_alloc(tls_slot(), result, size);
+        }
+#endif
+#ifdef CELL_ENABLE_BUDGET
+        settle_budget(budget_size, result ? m_large_allocs.get_alloc_size(result) : 0);
 #endif
         return result;
     }
@@ -1124,7 +2335,8 @@ namespace Cell {
     // Cell-Level API
     // =========================================================================
 
-    CellData *Context::alloc_cell(uint8_t tag) {
+    template <typename Policy>
+    CellData *BasicContext<Policy>::alloc_cell(uint8_t tag) {
         if (!m_allocator) {
             return nullptr;
         }
@@ -1138,50 +2350,454 @@ namespace Cell {
         cell->header.tag = tag;
         cell->header.size_class = kFullCellMarker;
         cell->header.free_count = 0;
+        get_metadata(&cell->header)->owner.store(nullptr, std::memory_order_relaxed);
         return cell;
     }
 
-    void Context::free_cell(CellData *cell) {
+    template <typename Policy>
+    void BasicContext<Policy>::free_cell(CellData *cell) {
         if (m_allocator && cell) {
             m_allocator->free(cell);
         }
     }
 
+    // =========================================================================
+    // Tag Heaps
+    // =========================================================================
+
+    template <typename Policy>
+    CellData *BasicContext<Policy>::alloc_full_cell(uint8_t tag) {
+        CellData *cell = alloc_cell(tag);
+        TagHeap *heap = tag_heap(tag);
+        if (cell && heap) {
+            std::lock_guard<std::mutex> lock(heap->lock);
+            heap->add_cell(&cell->header);
+        }
+        return cell;
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::free_full_cell(CellHeader *header) {
+        if (CELL_UNLIKELY(in_tag_heap(header))) {
+            TagHeap &heap = *m_tag_heaps[header->tag];
+            std::lock_guard<std::mutex> lock(heap.lock);
+            heap.remove_cell(header);
+        }
+        free_cell(reinterpret_cast<CellData *>(header));
+    }
+
+    template <typename Policy>
+    void *BasicContext<Policy>::alloc_from_tag_heap(TagHeap &heap, size_t bin_index) {
+        std::lock_guard<std::mutex> lock(heap.lock);
+        SizeBin &bin = heap.bins[bin_index];
+        if (!bin.partial_head) {
+            void *raw_cell = m_allocator->alloc();
+            if (!raw_cell) {
+                return nullptr;
+            }
+            init_cell_for_bin(raw_cell, bin_index, heap.tag);
+            auto *header = static_cast<CellHeader *>(raw_cell);
+            heap.add_cell(header);
+            bin.partial_head = header;
+        }
+        return take_partial_block(bin);
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::free_to_tag_heap(void *ptr, CellHeader *header) {
+        TagHeap &heap = *m_tag_heaps[header->tag];
+        size_t bin_index = header->size_class;
+        std::lock_guard<std::mutex> lock(heap.lock);
+        if (return_block_to_bin(heap.bins[bin_index], bin_index, header,
+                                static_cast<FreeBlock *>(ptr))) {
+            heap.remove_cell(header);
+            m_allocator->free(header);
+        }
+    }
+
+    template <typename Policy>
+    size_t BasicContext<Policy>::release_tag(uint8_t tag) {
+        TagHeap *heap = tag_heap(tag);
+        if (!heap) {
+            return 0;
+        }
+        std::lock_guard<std::mutex> lock(heap->lock);
+
+#ifdef CELL_DEBUG_LEAKS
+        {
+            std::lock_guard<std::mutex> debug_lock(m_debug_mutex);
+            for (auto it = m_live_allocs.begin(); it != m_live_allocs.end();) {
+                CellHeader *header =
+                    in_cell_region(it->first) ? get_header<Policy>(it->first) : nullptr;
+                bool released = header && in_tag_heap(header) && header->tag == tag;
+                it = released ? m_live_allocs.erase(it) : std::next(it);
+            }
+        }
+#endif
+#if defined(CELL_ENABLE_STATS) || defined(CELL_ENABLE_BUDGET)
+        // Live blocks are known per cell from its free count
+        size_t full_cells = 0;
+        for (CellHeader *header : heap->cells) {
+            if (header->size_class == kFullCellMarker) {
+                ++full_cells;
+                continue;
+            }
+            size_t live = blocks_per_cell<Policy>(header->size_class) - header->free_count;
+            if (live == 0) {
+                continue;
+            }
+#ifdef CELL_ENABLE_STATS
+            stats_record_free(kSizeClasses[header->size_class], tag, StatsShard::kSubcellFrees,
+                              live);
+#endif
+#ifdef CELL_ENABLE_BUDGET
+            record_budget_free(live * kSizeClasses[header->size_class]);
+#endif
+        }
+        if (full_cells > 0) {
+#ifdef CELL_ENABLE_STATS
+            stats_record_free(kCellSize, tag, StatsShard::kCellFrees, full_cells);
+#endif
+#ifdef CELL_ENABLE_BUDGET
+            record_budget_free(full_cells * kCellSize);
+#endif
+        }
+#endif
+
+        for (CellHeader *header : heap->cells) {
+            m_allocator->free(header);
+        }
+        size_t released = heap->cells.size();
+        heap->cells.clear();
+        for (SizeBin &bin : heap->bins) {
+            bin = SizeBin{};
+        }
+        return released;
+    }
+
     // =========================================================================
     // Memory Management API
     // =========================================================================
 
-    size_t Context::decommit_unused() {
+    template <typename Policy>
+    size_t BasicContext<Policy>::decommit_unused() {
         size_t total = 0;
 
         if (m_allocator) {
             total += m_allocator->decommit_unused();
         }
+        if (m_buddy) {
+            total += m_buddy->decommit_unused();
+        }
 
-        // Could also add buddy allocator decommit here in the future
+        total += m_large_allocs.trim_cache();
 
         return total;
     }
 
-    size_t Context::committed_bytes() const {
+    template <typename Policy>
+    size_t BasicContext<Policy>::prewarm(const PrewarmSpec &spec) {
+        if (!m_allocator) {
+            return 0;
+        }
+        size_t committed = m_allocator->prewarm(spec.superblocks, spec.populate);
+        TlsSlot *slot = spec.fill_thread_cache ? tls_slot() : nullptr;
+
+        for (size_t size : spec.sizes) {
+#ifdef CELL_DEBUG_GUARDS
+            // Match the class alloc_bytes() would pick for the guarded block
+            if (size + 2 * kGuardSize <= kMaxSubCellSize) {
+                size += 2 * kGuardSize;
+            }
+#endif
+            if (size > kMaxSubCellSize) {
+                continue;
+            }
+            uint8_t bin_index = get_size_class<Policy>(size, 8);
+
+            // Set up like a refill would, then wait on the partial list
+            for (size_t i = 0; i < spec.cells_per_size; ++i) {
+                void *raw_cell = m_allocator->alloc();
+                if (!raw_cell) {
+                    break;
+                }
+                if (spec.populate) {
+                    populate_pages(raw_cell, kCellSize);
+                }
+                init_cell_for_bin(raw_cell, bin_index, 0);
+                auto *header = static_cast<CellHeader *>(raw_cell);
+
+                std::lock_guard<std::mutex> lock(m_bin_locks[bin_index]);
+                SizeBin &bin = m_bins[bin_index];
+                get_metadata(header)->next_partial = bin.partial_head;
+                bin.partial_head = header;
+            }
+
+            if (slot && bin_index < kTlsBinCacheCount) {
+                TlsSlotScope scope(slot);
+                if (slot->bins[bin_index].is_empty()) {
+                    batch_refill_tls_bin(*slot, bin_index, 0);
+                }
+            }
+        }
+
+        if (slot) {
+            m_allocator->fill_tls_cache();
+        }
+        return committed;
+    }
+
+    template <typename Policy>
+    size_t BasicContext<Policy>::scavenge(uint64_t budget_ns) {
+        const auto start = std::chrono::steady_clock::now();
+        size_t total = 0;
+
+        if (m_allocator) {
+            total += m_allocator->scavenge(m_decay_ms, budget_ns, true);
+        }
+        if (m_buddy) {
+            // Whatever the cell tier left of the budget
+            auto elapsed = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count());
+            if (elapsed < budget_ns) {
+                total += m_buddy->scavenge(m_decay_ms, budget_ns - elapsed, true);
+            }
+        }
+        return total;
+    }
+
+#ifdef CELL_ENABLE_STATS
+    template <typename Policy>
+    const MemoryStats &BasicContext<Policy>::get_stats() const {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        StatsTotals totals = collect_stats();
+
+        // Live bytes never shrink the peak below what is allocated right now, even
+        // when the threads holding them have not published their last few KB
+        size_t current = totals.counters[StatsShard::kTotalAllocated] -
+                         totals.counters[StatsShard::kTotalFreed];
+        if (static_cast<int64_t>(current) > 0) {
+            size_t peak = m_stats_peak.load(std::memory_order_relaxed);
+            while (current > peak &&
+                   !m_stats_peak.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+            }
+        }
+        size_t baseline_current = m_stats_baseline.counters[StatsShard::kTotalAllocated] -
+                                  m_stats_baseline.counters[StatsShard::kTotalFreed];
+
+        auto since_reset = [&](StatsShard::Counter counter) {
+            return totals.counters[counter] - m_stats_baseline.counters[counter];
+        };
+        m_stats.total_allocated.store(since_reset(StatsShard::kTotalAllocated),
+                                      std::memory_order_relaxed);
+        m_stats.total_freed.store(since_reset(StatsShard::kTotalFreed), std::memory_order_relaxed);
+        m_stats.current_allocated.store(current - baseline_current, std::memory_order_relaxed);
+        m_stats.peak_allocated.store(m_stats_peak.load(std::memory_order_relaxed) -
+                                         baseline_current,
+                                     std::memory_order_relaxed);
+        m_stats.cell_allocs.store(since_reset(StatsShard::kCellAllocs), std::memory_order_relaxed);
+        m_stats.cell_frees.store(since_reset(StatsShard::kCellFrees), std::memory_order_relaxed);
+        m_stats.subcell_allocs.store(since_reset(StatsShard::kSubcellAllocs),
+                                     std::memory_order_relaxed);
+        m_stats.subcell_frees.store(since_reset(StatsShard::kSubcellFrees),
+                                    std::memory_order_relaxed);
+        m_stats.buddy_allocs.store(since_reset(StatsShard::kBuddyAllocs), std::memory_order_relaxed);
+        m_stats.buddy_frees.store(since_reset(StatsShard::kBuddyFrees), std::memory_order_relaxed);
+        m_stats.large_allocs.store(since_reset(StatsShard::kLargeAllocs), std::memory_order_relaxed);
+        m_stats.large_frees.store(since_reset(StatsShard::kLargeFrees), std::memory_order_relaxed);
+        for (size_t i = 0; i < 256; ++i) {
+            m_stats.per_tag_current[i].store(totals.per_tag_current[i] -
+                                                 m_stats_baseline.per_tag_current[i],
+                                             std::memory_order_relaxed);
+        }
+
+        // The per-node breakdown is derived from superblock state rather than counted
+        // on every allocation, so refresh it on demand
+        if (m_allocator) {
+            m_stats.numa_nodes = m_allocator->node_count();
+            for (size_t i = 0; i < m_allocator->node_count(); ++i) {
+                m_stats.node_committed[i].store(m_allocator->node_committed_bytes(i),
+                                                std::memory_order_relaxed);
+                m_stats.node_cells_in_use[i].store(m_allocator->node_cells_in_use(i),
+                                                   std::memory_order_relaxed);
+            }
+        }
+        return m_stats;
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::reset_stats() {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        m_stats_baseline = collect_stats();
+        m_stats_peak.store(m_stats_baseline.counters[StatsShard::kTotalAllocated] -
+                               m_stats_baseline.counters[StatsShard::kTotalFreed],
+                           std::memory_order_relaxed);
+        m_stats.reset();
+    }
+#endif
+
+    template <typename Policy>
+    size_t BasicContext<Policy>::committed_bytes() const {
         size_t total = 0;
         if (m_allocator) {
             total += m_allocator->committed_bytes();
         }
-        // Could add buddy allocator committed bytes here
+        if (m_buddy) {
+            total += m_buddy->bytes_committed();
+        }
+        total += m_large_allocs.bytes_committed();
         return total;
     }
 
+    // =========================================================================
+    // Introspection
+    // =========================================================================
+
+    template <typename Policy>
+    bool BasicContext<Policy>::owns(void *ptr) const {
+        auto uptr = reinterpret_cast<uintptr_t>(ptr);
+        auto base = reinterpret_cast<uintptr_t>(m_base);
+        if (uptr >= base && uptr < base + m_reserved_size) {
+            return true;
+        }
+        if (m_buddy && m_buddy->owns(ptr)) {
+            return true;
+        }
+        return m_large_allocs.owns(ptr);
+    }
+
+    template <typename Policy>
+    size_t BasicContext<Policy>::usable_size(void *ptr) const {
+        if (!ptr) {
+            return 0;
+        }
+
+#if defined(CELL_DEBUG_GUARDS) && defined(CELL_DEBUG_LEAKS)
+        // Guarded blocks end at the requested size; unguarded ones are sized below
+        {
+            std::lock_guard<std::mutex> lock(m_debug_mutex);
+            auto it = m_live_allocs.find(ptr);
+            if (it != m_live_allocs.end() && it->second.guarded) {
+                return it->second.size;
+            }
+        }
+#endif
+
+        auto uptr = reinterpret_cast<uintptr_t>(ptr);
+        auto base = reinterpret_cast<uintptr_t>(m_base);
+        if (uptr >= base && uptr < base + m_reserved_size) {
+            CellHeader *header = get_header<Policy>(ptr);
+            if (header->size_class == kFullCellMarker) {
+                return reinterpret_cast<uintptr_t>(header) + kCellSize - uptr;
+            }
+            auto start =
+                reinterpret_cast<uintptr_t>(get_block_start<Policy>(header, header->size_class));
+            size_t block_size = kSizeClasses[header->size_class];
+            return block_size - (uptr - start) % block_size;
+        }
+        if (m_buddy && m_buddy->owns(ptr)) {
+            return m_buddy->get_alloc_size(ptr) - BuddyAllocator::kHeaderSize;
+        }
+        return m_large_allocs.get_alloc_size(ptr);
+    }
+
+    template <typename Policy>
+    HeapSnapshot BasicContext<Policy>::snapshot() const {
+        HeapSnapshot snapshot;
+        snapshot.bins.resize(kNumSizeBins);
+        snapshot.buddy_tls_cached_blocks.resize(kTlsBuddyCacheOrders);
+        for (size_t bin_index = 0; bin_index < kNumSizeBins; ++bin_index) {
+            BinSnapshot &bin = snapshot.bins[bin_index];
+            bin.block_size = kSizeClasses[bin_index];
+            bin.blocks_per_cell = blocks_per_cell<Policy>(bin_index);
+
+            std::lock_guard<std::mutex> lock(m_bin_locks[bin_index]);
+            const SizeBin &size_bin = m_bins[bin_index];
+            bin.warm_cells = size_bin.warm_cell_count;
+            bin.allocated_blocks = size_bin.current_allocated;
+            for (CellHeader *cell = size_bin.partial_head; cell;
+                 cell = get_metadata(cell)->next_partial) {
+                size_t free_count = cell->free_count;
+                size_t bucket = free_count * kSnapshotFreeBuckets / bin.blocks_per_cell;
+                ++bin.free_histogram[bucket < kSnapshotFreeBuckets ? bucket
+                                                                   : kSnapshotFreeBuckets - 1];
+                ++bin.partial_cells;
+                bin.free_blocks += free_count;
+            }
+        }
+
+        // Every bound thread's caches, read while their owners keep going
+        visit_bound_tls_slots(
+            m_tls_slot,
+            [](const Cell::TlsSlot &base, void *arg) {
+                auto &slot = static_cast<const TlsSlot &>(base);
+                auto &out = *static_cast<HeapSnapshot *>(arg);
+                for (size_t bin_index = 0; bin_index < kTlsBinCacheCount; ++bin_index) {
+                    out.bins[bin_index].tls_cached_blocks += slot.bins[bin_index].count;
+                }
+                out.tls_cached_cells += slot.cells.count;
+                for (size_t i = 0; i < kTlsBuddyCacheOrders; ++i) {
+                    out.buddy_tls_cached_blocks[i] += slot.buddy[i].count;
+                }
+            },
+            &snapshot);
+
+        if (m_allocator) {
+            size_t states[kSuperblockStateCount];
+            m_allocator->superblock_state_counts(states);
+            for (size_t i = 0; i < kSuperblockStateCount; ++i) {
+                snapshot.superblocks[i] = states[i];
+            }
+            snapshot.cell_committed_bytes = m_allocator->committed_bytes();
+        }
+
+        if (m_buddy) {
+            size_t free_blocks[BuddyAllocator::kNumOrders];
+            m_buddy->free_block_counts(free_blocks);
+            for (size_t i = 0; i < BuddyAllocator::kNumOrders; ++i) {
+                snapshot.buddy_free_blocks[i] = free_blocks[i];
+            }
+            snapshot.buddy_allocated_bytes = m_buddy->bytes_allocated();
+            snapshot.buddy_committed_bytes = m_buddy->bytes_committed();
+        }
+
+        snapshot.large_allocations = m_large_allocs.allocation_count();
+        snapshot.large_allocated_bytes = m_large_allocs.bytes_allocated();
+        snapshot.large_committed_bytes = m_large_allocs.bytes_committed();
+        snapshot.large_cached_bytes = m_large_allocs.cached_bytes();
+
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+        m_retired_latency.sum_into(snapshot.latency);
+        visit_bound_tls_slots(
+            m_tls_slot,
+            [](const Cell::TlsSlot &slot, void *arg) {
+                slot.latency.sum_into(
+                    *static_cast<std::array<LatencyHistogram, kLatencyPathCount> *>(arg));
+            },
+            &snapshot.latency);
+#endif
+        return snapshot;
+    }
+
     // =========================================================================
     // Sub-Cell Implementation
     // =========================================================================
 
-    void *Context::alloc_from_bin(size_t bin_index, uint8_t tag) {
+    template <typename Policy>
+    void *BasicContext<Policy>::alloc_from_bin(size_t bin_index, uint8_t tag) {
         assert(bin_index < kNumSizeBins);
 
-        // TLS fast path for hot bins (0-3: 16B, 32B, 64B, 128B)
-        if (bin_index < kTlsBinCacheCount) {
-            TlsBinCache &cache = t_bin_cache[bin_index];
+        if (TagHeap *heap = tag_heap(tag)) {
+            return alloc_from_tag_heap(*heap, bin_index);
+        }
+
+        // TLS fast path
+        TlsSlot *slot = bin_index < kTlsBinCacheCount ? tls_slot() : nullptr;
+        if (slot) {
+            TlsSlotScope scope(slot);
+            TlsBinCache &cache = slot->bins[bin_index];
 
             // Try TLS cache first (no lock)
             if (!cache.is_empty()) {
@@ -1189,61 +2805,47 @@ namespace Cell {
             }
 
             // Try batch refill from global bin
-            batch_refill_tls_bin(bin_index, tag);
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+            uint64_t latency_start = trace_clock();
+#endif
+            batch_refill_tls_bin(*slot, bin_index, tag);
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+            record_latency(slot, LatencyPath::kTlsRefill, latency_start);
+#endif
             if (!cache.is_empty()) {
                 return cache.pop();
             }
         }
 
         // Fallback: lock-based allocation from global bin
-        std::lock_guard<std::mutex> lock(m_bin_locks[bin_index]);
+        std::unique_lock<std::mutex> lock = lock_bin(bin_index);
         SizeBin &bin = m_bins[bin_index];
 
-        // Try to allocate from a partial cell
-        if (bin.partial_head) {
-            CellHeader *cell_header = bin.partial_head;
-            CellMetadata *metadata = get_metadata(cell_header);
-
-            // Pop a block from the free list
-            FreeBlock *block = metadata->free_list;
-            assert(block && "Partial cell should have free blocks");
-            metadata->free_list = block->next;
-            cell_header->free_count--;
-
-            // If cell is now full, remove from partial list
-            if (cell_header->free_count == 0) {
-                bin.partial_head = reinterpret_cast<CellHeader *>(metadata->next_partial);
-                metadata->next_partial = nullptr;
-            }
-
-            // Update stats
-            bin.total_allocated++;
-            bin.current_allocated++;
-
-            return block;
-        }
-
         // No partial cells available, get a fresh cell
-        void *raw_cell = m_allocator->alloc();
-        if (!raw_cell) {
-            return nullptr;
+        if (!bin.partial_head) {
+            void *raw_cell = m_allocator->alloc();
+            if (!raw_cell) {
+                return nullptr;
+            }
+            init_cell_for_bin(raw_cell, bin_index, tag);
+            bin.partial_head = static_cast<CellHeader *>(raw_cell);
         }
+        return take_partial_block(bin);
+    }
 
-        // Initialize the cell for this bin
-        init_cell_for_bin(raw_cell, bin_index, tag);
-
-        CellHeader *cell_header = static_cast<CellHeader *>(raw_cell);
+    template <typename Policy>
+    FreeBlock *BasicContext<Policy>::take_partial_block(SizeBin &bin) {
+        CellHeader *cell_header = bin.partial_head;
         CellMetadata *metadata = get_metadata(cell_header);
 
-        // Pop the first block
-        FreeBlock *block = metadata->free_list;
-        metadata->free_list = block->next;
-        cell_header->free_count--;
+        // Take a freed block, or the next untouched one
+        assert(cell_header->free_count > 0 && "Partial cell should have free blocks");
+        FreeBlock *block = take_cell_block<Policy>(cell_header, free_list_key());
 
-        // Add to partial list (if there are still free blocks)
-        if (cell_header->free_count > 0) {
-            metadata->next_partial = reinterpret_cast<CellHeader *>(bin.partial_head);
-            bin.partial_head = cell_header;
+        // If cell is now full, remove from partial list
+        if (cell_header->free_count == 0) {
+            bin.partial_head = reinterpret_cast<CellHeader *>(metadata->next_partial);
+            metadata->next_partial = nullptr;
         }
 
         // Update stats
@@ -1253,37 +2855,103 @@ namespace Cell {
         return block;
     }
 
-    void Context::free_to_bin(void *ptr, CellHeader *header) {
+    template <typename Policy>
+    std::unique_lock<std::mutex> BasicContext<Policy>::lock_bin(size_t bin_index) {
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+        // An uncontended lock counts as a zero wait without reading the clock
+        std::unique_lock<std::mutex> lock(m_bin_locks[bin_index], std::try_to_lock);
+        TlsSlot *slot = find_tls_slot<Policy>(m_tls_slot, m_id);
+        if (lock.owns_lock()) {
+            if (slot) {
+                slot->latency.record(LatencyPath::kBinLock, 0);
+            }
+        } else {
+            uint64_t latency_start = trace_clock();
+            lock.lock();
+            record_latency(slot, LatencyPath::kBinLock, latency_start);
+        }
+        return lock;
+#else
+        return std::unique_lock<std::mutex>(m_bin_locks[bin_index]);
+#endif
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::free_to_bin(void *ptr, CellHeader *header) {
         size_t bin_index = header->size_class;
         assert(bin_index < kNumSizeBins);
 
-        size_t block_size = kSizeClasses[bin_index];
-
+#ifdef CELL_HARDENED
+        hardened_release(ptr, header, bin_index);
+#endif
 #ifndef NDEBUG
         // Poison the freed memory
-        std::memset(ptr, kPoisonByte, block_size);
+        std::memset(ptr, kPoisonByte, kSizeClasses[bin_index]);
 #endif
 
-        // TLS fast path for hot bins (0-3: 16B, 32B, 64B, 128B)
+        if (CELL_UNLIKELY(in_tag_heap(header))) {
+            free_to_tag_heap(ptr, header);
+            return;
+        }
+
+        // TLS fast path
         if (CELL_LIKELY(bin_index < kTlsBinCacheCount)) {
-            TlsBinCache &cache = t_bin_cache[bin_index];
-            if (CELL_LIKELY(cache.count < kTlsBinCacheCapacity)) {
-                cache.blocks[cache.count++] = static_cast<FreeBlock *>(ptr);
+            TlsSlot *slot = tls_slot();
+            TlsSlotScope scope(slot);
+
+            // Route foreign frees back to the owning thread
+            auto *owner = static_cast<RemoteFreeQueue *>(
+                get_metadata(header)->owner.load(std::memory_order_relaxed));
+            RemoteFreeQueue *local = slot ? slot->remote_queue : nullptr;
+            if (owner && owner != local) {
+                owner->push(bin_index, static_cast<FreeBlock *>(ptr), free_list_key());
+                return;
+            }
+
+            if (CELL_LIKELY(slot != nullptr)) {
+                TlsBinCache &cache = slot->bins[bin_index];
+                if (CELL_UNLIKELY(cache.is_full())) {
+                    spill_tls_bin(*slot, bin_index);
+                }
+#ifdef CELL_HARDENED
+                static_cast<FreeBlock *>(ptr)->set_next(nullptr, m_free_list_key);
+#endif
+                cache.push(static_cast<FreeBlock *>(ptr));
                 return;
             }
         }
 
         // Fallback: lock-based free to global bin
-        std::lock_guard<std::mutex> lock(m_bin_locks[bin_index]);
-        SizeBin &bin = m_bins[bin_index];
+        std::unique_lock<std::mutex> lock = lock_bin(bin_index);
+        release_block_to_cell(bin_index, header, static_cast<FreeBlock *>(ptr));
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::release_block_to_cell(size_t bin_index, CellHeader *header,
+                                                     FreeBlock *block) {
+        // Another thread allocates from this cell without the lock; let it take the block
+        if (header->exclusive) {
+            auto *owner = static_cast<RemoteFreeQueue *>(
+                get_metadata(header)->owner.load(std::memory_order_relaxed));
+            owner->push(bin_index, block, free_list_key());
+            return;
+        }
+
+        if (return_block_to_bin(m_bins[bin_index], bin_index, header, block)) {
+            m_allocator->free(header);
+        }
+    }
+
+    template <typename Policy>
+    bool BasicContext<Policy>::return_block_to_bin(SizeBin &bin, size_t bin_index,
+                                                   CellHeader *header, FreeBlock *block) {
         CellMetadata *metadata = get_metadata(header);
 
         // Check if cell was full (not in partial list)
         bool was_full = (header->free_count == 0);
 
         // Add block back to cell's free list
-        auto *block = static_cast<FreeBlock *>(ptr);
-        block->next = metadata->free_list;
+        block->set_next(metadata->free_list, free_list_key());
         metadata->free_list = block;
         header->free_count++;
 
@@ -1291,14 +2959,17 @@ namespace Cell {
         bin.current_allocated--;
 
         // Calculate max blocks for this bin
-        size_t max_blocks = blocks_per_cell(bin_index);
+        size_t max_blocks = blocks_per_cell<Policy>(bin_index);
 
         // If cell is now completely empty
         if (header->free_count == max_blocks) {
             // Warm reserve policy: keep a few empty cells per bin
             if (bin.warm_cell_count < kWarmCellsPerBin) {
-                // Keep as warm reserve, stays in partial list
+                // Keep as warm reserve, stays in partial list. Every block is free, so
+                // drop the list and hand them out in address order again.
                 bin.warm_cell_count++;
+                metadata->free_list = nullptr;
+                metadata->bump_index = 0;
                 if (was_full) {
                     // Add to partial list
                     metadata->next_partial = reinterpret_cast<CellHeader *>(bin.partial_head);
@@ -1315,9 +2986,7 @@ namespace Cell {
                     *pp = reinterpret_cast<CellHeader *>(metadata->next_partial);
                 }
                 metadata->next_partial = nullptr;
-
-                // Return to allocator
-                m_allocator->free(header);
+                return true;
             }
         } else if (was_full) {
             // Cell was full, now has space - add to partial list
@@ -1325,158 +2994,472 @@ namespace Cell {
             bin.partial_head = header;
         }
         // Otherwise cell is already in partial list, nothing to do
+        return false;
     }
 
-    void Context::init_cell_for_bin(void *cell, size_t bin_index, uint8_t tag) {
+    template <typename Policy>
+    void BasicContext<Policy>::init_cell_for_bin(void *cell, size_t bin_index, uint8_t tag,
+                                                 size_t handed_out) {
         auto *header = static_cast<CellHeader *>(cell);
         CellMetadata *metadata = get_metadata(header);
 
         // Set up header
         header->tag = tag;
         header->size_class = static_cast<uint8_t>(bin_index);
+        header->exclusive = 0;
 
 #ifndef NDEBUG
         header->magic = kCellMagic;
         header->generation = 0;
 #endif
 
-        // Calculate block layout
-        size_t block_size = kSizeClasses[bin_index];
-        size_t num_blocks = blocks_per_cell(bin_index);
-        header->free_count = static_cast<uint16_t>(num_blocks);
+        size_t num_blocks = blocks_per_cell<Policy>(bin_index);
+        assert(handed_out <= num_blocks);
+        header->free_count = static_cast<uint16_t>(num_blocks - handed_out);
 
-        // Initialize metadata
+        // No block is written here: the free list starts empty and blocks are
+        // bumped out of the untouched tail as they are needed
         metadata->next_partial = nullptr;
         metadata->free_list = nullptr;
+        metadata->owner.store(nullptr, std::memory_order_relaxed);
+        metadata->bump_index = static_cast<uint16_t>(handed_out);
+    }
 
-        // Build free list (all blocks are free initially)
-        char *block_start = static_cast<char *>(get_block_start(header));
-        FreeBlock *prev = nullptr;
+    template <typename Policy>
+    void *BasicContext<Policy>::carve_cell(size_t bin_index, size_t count, uint8_t tag) {
+        void *raw_cell = m_allocator->alloc();
+        if (!raw_cell) {
+            return nullptr;
+        }
 
-        for (size_t i = num_blocks; i > 0; --i) {
-            auto *block = reinterpret_cast<FreeBlock *>(block_start + (i - 1) * block_size);
-            block->next = prev;
-            prev = block;
+        init_cell_for_bin(raw_cell, bin_index, tag, count);
+        auto *header = static_cast<CellHeader *>(raw_cell);
+
+        TagHeap *heap = tag_heap(tag);
+        std::lock_guard<std::mutex> lock(heap ? heap->lock : m_bin_locks[bin_index]);
+        SizeBin &bin = heap ? heap->bins[bin_index] : m_bins[bin_index];
+        if (heap) {
+            heap->add_cell(header);
+        }
+        if (header->free_count > 0) {
+            get_metadata(header)->next_partial = bin.partial_head;
+            bin.partial_head = header;
         }
+        bin.total_allocated += count;
+        bin.current_allocated += count;
 
-        metadata->free_list = prev;
+        return get_block_start<Policy>(header, bin_index);
     }
 
-    void Context::batch_refill_tls_bin(size_t bin_index, uint8_t tag) {
+    template <typename Policy>
+    size_t BasicContext<Policy>::carve_cells(size_t bin_index, void **out_ptrs, size_t count,
+                                             uint8_t tag) {
+        const size_t per_cell = blocks_per_cell<Policy>(bin_index);
+        const size_t block_size = kSizeClasses[bin_index];
+        size_t carved = 0;
+
+        while (count - carved >= per_cell) {
+            auto *block = static_cast<char *>(carve_cell(bin_index, per_cell, tag));
+            if (!block) {
+                break;
+            }
+            for (size_t i = 0; i < per_cell; ++i) {
+                out_ptrs[carved++] = block + i * block_size;
+            }
+        }
+        return carved;
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::batch_refill_tls_bin(TlsSlot &slot, size_t bin_index, uint8_t tag) {
         assert(bin_index < kTlsBinCacheCount);
 
-        TlsBinCache &cache = t_bin_cache[bin_index];
-        size_t to_refill = kTlsBinBatchRefill;
+        TlsBinCache &cache = slot.bins[bin_index];
+        grow_tls_bin(slot, bin_index);
+        size_t batch = cache.capacity / 2;
+
+        // Blocks other threads freed back to us are the cheapest refill: no lock
+        RemoteFreeQueue *queue = acquire_remote_queue(slot);
+        if (drain_remote_frees(slot, bin_index)) {
+            return;
+        }
+
+        // Next cheapest: the cell we own, whose free list no other thread touches
+        if (cache.owned && take_owned_blocks(cache, batch, free_list_key()) > 0) {
+            return;
+        }
 
-        std::lock_guard<std::mutex> lock(m_bin_locks[bin_index]);
+        // The owned cell is used up: swap it for new ones under one lock acquisition.
+        // Bins with few blocks per cell adopt several cells to fill one batch.
+        std::unique_lock<std::mutex> lock = lock_bin(bin_index);
+        size_t to_refill = batch;
+        while (to_refill > 0 && !cache.is_full()) {
+            if (cache.owned) {
+                retire_owned_cell(bin_index, cache.owned);
+            }
+            cache.owned = adopt_cell(bin_index, tag, queue);
+            if (!cache.owned) {
+                break;
+            }
+            to_refill -= take_owned_blocks(cache, to_refill, free_list_key());
+        }
+    }
+
+    template <typename Policy>
+    CellHeader *BasicContext<Policy>::adopt_cell(size_t bin_index, uint8_t tag,
+                                                 RemoteFreeQueue *queue) {
         SizeBin &bin = m_bins[bin_index];
 
-        // Try to get blocks from partial cells
-        while (to_refill > 0 && !cache.is_full() && bin.partial_head) {
-            CellHeader *cell_header = bin.partial_head;
+        CellHeader *cell_header = bin.partial_head;
+        if (cell_header) {
             CellMetadata *metadata = get_metadata(cell_header);
+            bin.partial_head = reinterpret_cast<CellHeader *>(metadata->next_partial);
+            metadata->next_partial = nullptr;
+        } else {
+            void *raw_cell = m_allocator->alloc();
+            if (!raw_cell) {
+                return nullptr;
+            }
+            init_cell_for_bin(raw_cell, bin_index, tag);
+            cell_header = static_cast<CellHeader *>(raw_cell);
+        }
+
+        cell_header->exclusive = 1;
+        get_metadata(cell_header)->owner.store(queue, std::memory_order_relaxed);
 
-            while (to_refill > 0 && !cache.is_full() && metadata->free_list) {
-                FreeBlock *block = metadata->free_list;
-                metadata->free_list = block->next;
-                cell_header->free_count--;
-                cache.push(block);
-                --to_refill;
+        bin.total_allocated += cell_header->free_count;
+        bin.current_allocated += cell_header->free_count;
+        return cell_header;
+    }
 
-                bin.total_allocated++;
-                bin.current_allocated++;
+    template <typename Policy>
+    void BasicContext<Policy>::retire_owned_cell(size_t bin_index, CellHeader *header) {
+        SizeBin &bin = m_bins[bin_index];
+        CellMetadata *metadata = get_metadata(header);
+
+        header->exclusive = 0;
+        bin.current_allocated -= header->free_count;
+
+        // A full cell joins the partial list on its next free, like any other
+        if (header->free_count == 0) {
+            return;
+        }
+
+        if (header->free_count == blocks_per_cell<Policy>(bin_index)) {
+            // Same warm reserve policy as release_block_to_cell()
+            if (bin.warm_cell_count >= kWarmCellsPerBin) {
+                m_allocator->free(header);
+                return;
             }
+            bin.warm_cell_count++;
+            metadata->free_list = nullptr;
+            metadata->bump_index = 0;
+        }
 
-            // If cell is now full, remove from partial list
-            if (cell_header->free_count == 0) {
-                bin.partial_head = reinterpret_cast<CellHeader *>(metadata->next_partial);
-                metadata->next_partial = nullptr;
+        metadata->next_partial = reinterpret_cast<CellHeader *>(bin.partial_head);
+        bin.partial_head = header;
+    }
+
+    template <typename Policy>
+    size_t BasicContext<Policy>::take_owned_blocks(TlsBinCache &cache, size_t count,
+                                                   uintptr_t key) {
+        CellHeader *cell_header = cache.owned;
+
+        size_t taken = 0;
+        while (taken < count && !cache.is_full() && cell_header->free_count > 0) {
+            cache.push(take_cell_block<Policy>(cell_header, key));
+            ++taken;
+        }
+        return taken;
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::grow_tls_bin(TlsSlot &slot, size_t bin_index) {
+        TlsBinCache &cache = slot.bins[bin_index];
+        cache.overflows = 0;
+
+        if (cache.capacity >= kTlsBinCacheCapacity) {
+            return;
+        }
+        size_t grown = std::min<size_t>(size_t{cache.capacity} * 2, kTlsBinCacheCapacity);
+        size_t extra = (grown - cache.capacity) * kSizeClasses[bin_index];
+        if (slot.bin_cache_bytes + extra > m_tls_bin_cache_bytes) {
+            return;
+        }
+        cache.capacity = static_cast<uint32_t>(grown);
+        slot.bin_cache_bytes += extra;
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::spill_tls_bin(TlsSlot &slot, size_t bin_index) {
+        TlsBinCache &cache = slot.bins[bin_index];
+
+        // Frees keep outpacing allocations here: hold less
+        if (++cache.overflows >= kTlsBinShrinkOverflows) {
+            cache.overflows = 0;
+            if (cache.capacity > kTlsBinCacheMinCapacity) {
+                uint32_t shrunk = std::max<uint32_t>(cache.capacity / 2, kTlsBinCacheMinCapacity);
+                slot.bin_cache_bytes -= (cache.capacity - shrunk) * kSizeClasses[bin_index];
+                cache.capacity = shrunk;
             }
         }
 
-        // If we still need more blocks, allocate a fresh cell
-        if (to_refill > 0 && !cache.is_full()) {
-            void *raw_cell = m_allocator->alloc();
-            if (raw_cell) {
-                init_cell_for_bin(raw_cell, bin_index, tag);
-
-                CellHeader *cell_header = static_cast<CellHeader *>(raw_cell);
-                CellMetadata *metadata = get_metadata(cell_header);
-
-                // Take blocks from the new cell
-                while (to_refill > 0 && !cache.is_full() && metadata->free_list) {
-                    FreeBlock *block = metadata->free_list;
-                    metadata->free_list = block->next;
-                    cell_header->free_count--;
-                    cache.push(block);
-                    --to_refill;
-
-                    bin.total_allocated++;
-                    bin.current_allocated++;
-                }
+        // Spill the coldest blocks (bottom of the stack), as free_buddy() does
+        size_t spill = cache.count - cache.capacity / 2;
+        FreeBlock *list = nullptr;
+        for (size_t i = 0; i < spill; ++i) {
+#ifdef CELL_HARDENED
+            hardened_check_freed(cache.blocks[i]);
+#endif
+            cache.blocks[i]->set_next(list, free_list_key());
+            list = cache.blocks[i];
+        }
+        cache.count -= spill;
+        std::memmove(cache.blocks, cache.blocks + spill, cache.count * sizeof(FreeBlock *));
 
-                // Add remaining blocks to partial list
-                if (cell_header->free_count > 0) {
-                    metadata->next_partial = reinterpret_cast<CellHeader *>(bin.partial_head);
-                    bin.partial_head = cell_header;
-                }
+        return_blocks_to_cells(slot, bin_index, list);
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::return_blocks_to_cells(TlsSlot &slot, size_t bin_index,
+                                                      FreeBlock *list) {
+        CellHeader *owned = slot.bins[bin_index].owned;
+
+        // Blocks of our own cell go straight back to its free list
+        FreeBlock *rest = nullptr;
+        while (list) {
+            FreeBlock *next = next_free(list);
+            if (owned && get_header<Policy>(list) == owned) {
+                CellMetadata *metadata = get_metadata(owned);
+                list->set_next(metadata->free_list, free_list_key());
+                metadata->free_list = list;
+                owned->free_count++;
+            } else {
+                list->set_next(rest, free_list_key());
+                rest = list;
             }
+            list = next;
+        }
+
+        if (!rest) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock = lock_bin(bin_index);
+        while (rest) {
+            FreeBlock *next = next_free(rest);
+            release_block_to_cell(bin_index, get_header<Policy>(rest), rest);
+            rest = next;
         }
     }
 
-    void Context::flush_tls_caches() {
+    template <typename Policy>
+    void BasicContext<Policy>::flush_tls_caches() {
+        // Nothing is cached for this Context unless the thread's slot is bound to it
+        TlsSlot *slot = find_tls_slot<Policy>(m_tls_slot, m_id);
+        if (!slot) {
+            return;
+        }
+
+        TlsSlotScope scope(slot);
+        release_tls_slot(*slot);
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::release_slot_caches(void *context, Cell::TlsSlot &slot) {
+        static_cast<BasicContext *>(context)->release_tls_slot(static_cast<TlsSlot &>(slot));
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::release_tls_slot(TlsSlot &slot) {
+#ifdef CELL_ENABLE_BUDGET
+        trim_budget_lease(slot, 0);
+#endif
         for (size_t bin_index = 0; bin_index < kTlsBinCacheCount; ++bin_index) {
-            TlsBinCache &cache = t_bin_cache[bin_index];
+            TlsBinCache &cache = slot.bins[bin_index];
+            if (cache.is_empty() && !cache.owned) {
+                continue;
+            }
 
+            // Use the lock-based path for proper cell management. The owned cell goes
+            // first so that cached blocks from it are released like any others.
+            std::lock_guard<std::mutex> lock(m_bin_locks[bin_index]);
+            if (cache.owned) {
+                retire_owned_cell(bin_index, cache.owned);
+                cache.owned = nullptr;
+            }
             while (!cache.is_empty()) {
                 FreeBlock *block = cache.pop();
-                CellHeader *header = get_header(block);
+#ifdef CELL_HARDENED
+                hardened_check_freed(block);
+#endif
+                release_block_to_cell(bin_index, get_header<Policy>(block), block);
+            }
+        }
 
-                // Use the lock-based path for proper cell management
-                std::lock_guard<std::mutex> lock(m_bin_locks[bin_index]);
-                SizeBin &bin = m_bins[bin_index];
-                CellMetadata *metadata = get_metadata(header);
+        release_remote_queue(slot);
 
-                bool was_full = (header->free_count == 0);
+        // Return parked buddy blocks so they can coalesce again
+        if (m_buddy) {
+            for (TlsBuddyCache<Policy> &cache : slot.buddy) {
+                m_buddy->free_batch(cache.blocks, cache.count);
+                cache.count = 0;
+            }
+        }
 
-                block->next = metadata->free_list;
-                metadata->free_list = block;
-                header->free_count++;
+        // Also flush the cell-level TLS cache
+        if (m_allocator) {
+            m_allocator->flush_tls_cache(slot.cells);
+        }
+    }
 
-                bin.current_allocated--;
+    template <typename Policy>
+    size_t BasicContext<Policy>::reclaim_idle_tls_caches(uint32_t idle_ms) {
+        return reclaim_idle_tls_slots(m_tls_slot, idle_ms);
+    }
 
-                size_t max_blocks = blocks_per_cell(bin_index);
+    template <typename Policy>
+    size_t BasicContext<Policy>::tls_bin_capacity(size_t bin_index) const {
+        assert(bin_index < kNumSizeBins);
+        TlsSlot *slot = find_tls_slot<Policy>(m_tls_slot, m_id);
+        if (!slot || bin_index >= kTlsBinCacheCount) {
+            return 0;
+        }
+        return slot->bins[bin_index].capacity;
+    }
 
-                if (header->free_count == max_blocks) {
-                    if (bin.warm_cell_count < kWarmCellsPerBin) {
-                        bin.warm_cell_count++;
-                        if (was_full) {
-                            metadata->next_partial =
-                                reinterpret_cast<CellHeader *>(bin.partial_head);
-                            bin.partial_head = header;
-                        }
-                    } else {
-                        CellHeader **pp = &bin.partial_head;
-                        while (*pp && *pp != header) {
-                            pp = reinterpret_cast<CellHeader **>(&get_metadata(*pp)->next_partial);
-                        }
-                        if (*pp == header) {
-                            *pp = reinterpret_cast<CellHeader *>(metadata->next_partial);
-                        }
-                        metadata->next_partial = nullptr;
-                        m_allocator->free(header);
+    // =========================================================================
+    // Buddy TLS Cache
+    // =========================================================================
+
+    template <typename Policy>
+    void *BasicContext<Policy>::alloc_buddy(size_t size) {
+        size_t cache_index = BuddyAllocator::order_for_size(size) - BuddyAllocator::kMinOrder;
+        if (cache_index < kTlsBuddyCacheOrders) {
+            if (TlsSlot *slot = tls_slot()) {
+                TlsSlotScope scope(slot);
+                TlsBuddyCache<Policy> &cache = slot->buddy[cache_index];
+                if (CELL_UNLIKELY(cache.is_empty())) {
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+                    uint64_t latency_start = trace_clock();
+#endif
+                    cache.count = m_buddy->alloc_batch(size, cache.blocks, kTlsBuddyBatchRefill);
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+                    record_latency(slot, LatencyPath::kBuddy, latency_start);
+#endif
+                    if (cache.is_empty()) {
+                        return nullptr;
                     }
-                } else if (was_full) {
-                    metadata->next_partial = reinterpret_cast<CellHeader *>(bin.partial_head);
-                    bin.partial_head = header;
                 }
+                return cache.pop();
             }
         }
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+        uint64_t latency_start = trace_clock();
+        void *result = m_buddy->alloc(size);
+        record_latency(find_tls_slot<Policy>(m_tls_slot, m_id), LatencyPath::kBuddy,
+                       latency_start);
+        return result;
+#else
+        return m_buddy->alloc(size);
+#endif
+    }
 
-        // Also flush the cell-level TLS cache
-        if (m_allocator) {
-            m_allocator->flush_tls_cache();
+    template <typename Policy>
+    void BasicContext<Policy>::free_buddy(void *ptr) {
+        size_t cache_index = BuddyAllocator::get_block_order(ptr) - BuddyAllocator::kMinOrder;
+        if (cache_index < kTlsBuddyCacheOrders) {
+            if (TlsSlot *slot = tls_slot()) {
+                TlsSlotScope scope(slot);
+                TlsBuddyCache<Policy> &cache = slot->buddy[cache_index];
+                if (CELL_UNLIKELY(cache.is_full())) {
+                    // Spill the coldest blocks (bottom of the stack) under one lock
+                    m_buddy->free_batch(cache.blocks, kTlsBuddyBatchRefill);
+                    cache.count -= kTlsBuddyBatchRefill;
+                    std::memmove(cache.blocks, cache.blocks + kTlsBuddyBatchRefill,
+                                 cache.count * sizeof(void *));
+                }
+                cache.push(ptr);
+                return;
+            }
         }
+        m_buddy->free(ptr);
+    }
+
+    // =========================================================================
+    // Remote Free Queues
+    // =========================================================================
+
+    template <typename Policy>
+    typename BasicContext<Policy>::RemoteFreeQueue *
+    BasicContext<Policy>::acquire_remote_queue(TlsSlot &slot) {
+        if (CELL_LIKELY(slot.remote_queue != nullptr)) {
+            return slot.remote_queue;
+        }
+
+        std::lock_guard<std::mutex> lock(m_remote_mutex);
+
+        // Prefer a queue released by an exited thread; we inherit its pending blocks
+        RemoteFreeQueue *queue = m_remote_queues;
+        while (queue && queue->in_use) {
+            queue = static_cast<RemoteFreeQueue *>(queue->next_registered);
+        }
+        if (!queue) {
+            queue = new RemoteFreeQueue();
+            queue->next_registered = m_remote_queues;
+            m_remote_queues = queue;
+        }
+        queue->in_use = true;
+
+        slot.remote_queue = queue;
+        return queue;
+    }
+
+    template <typename Policy>
+    bool BasicContext<Policy>::drain_remote_frees(TlsSlot &slot, size_t bin_index) {
+        FreeBlock *list = slot.remote_queue->take_all(bin_index);
+        if (!list) {
+            return false;
+        }
+
+        TlsBinCache &cache = slot.bins[bin_index];
+        while (list && !cache.is_full()) {
+            FreeBlock *next = next_free(list);
+            cache.push(list);
+            list = next;
+        }
+
+        if (list) {
+            // Cache full: give the rest back to their cells
+            return_blocks_to_cells(slot, bin_index, list);
+        }
+        return true;
+    }
+
+    template <typename Policy>
+    void BasicContext<Policy>::release_remote_queue(TlsSlot &slot) {
+        RemoteFreeQueue *queue = slot.remote_queue;
+        if (!queue) {
+            return;
+        }
+
+        for (size_t bin_index = 0; bin_index < kTlsBinCacheCount; ++bin_index) {
+            FreeBlock *list = queue->take_all(bin_index);
+            if (!list) {
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(m_bin_locks[bin_index]);
+            while (list) {
+                FreeBlock *next = next_free(list);
+                release_block_to_cell(bin_index, get_header<Policy>(list), list);
+                list = next;
+            }
+        }
+
+        slot.remote_queue = nullptr;
+
+        std::lock_guard<std::mutex> lock(m_remote_mutex);
+        queue->in_use = false;
     }
 
     // =========================================================================
@@ -1484,7 +3467,8 @@ namespace Cell {
     // =========================================================================
 
 #ifdef CELL_DEBUG_GUARDS
-    bool Context::check_guards(void *ptr) const {
+    template <typename Policy>
+    bool BasicContext<Policy>::check_guards(void *ptr) const {
         if (!ptr) {
             return false;
         }
@@ -1520,7 +3504,8 @@ namespace Cell {
 #endif
 
 #ifdef CELL_DEBUG_LEAKS
-    void Context::report_leaks() const {
+    template <typename Policy>
+    void BasicContext<Policy>::report_leaks() const {
         std::lock_guard<std::mutex> lock(m_debug_mutex);
 
         for (const auto &[ptr, alloc] : m_live_allocs) {
@@ -1534,9 +3519,13 @@ namespace Cell {
         }
     }
 
-    size_t Context::live_allocation_count() const {
+    template <typename Policy>
+    size_t BasicContext<Policy>::live_allocation_count() const {
         std::lock_guard<std::mutex> lock(m_debug_mutex);
         return m_live_allocs.size();
     }
 #endif
+    template class BasicContext<DefaultPolicy>;
+    template class BasicContext<LargeCellPolicy>;
+
 }
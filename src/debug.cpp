@@ -1,6 +1,6 @@
 #include "cell/debug.h"
 
-#ifdef CELL_DEBUG_STACKTRACE
+#if defined(CELL_DEBUG_STACKTRACE) || defined(CELL_ENABLE_HEAP_PROFILE)
 
 #include <cstdio>
 
@@ -153,4 +153,18 @@ namespace Cell {
 
 #endif
 
-#endif // CELL_DEBUG_STACKTRACE
+#endif // CELL_DEBUG_STACKTRACE || CELL_ENABLE_HEAP_PROFILE
+
+#ifdef CELL_HARDENED
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace Cell {
+    void report_heap_corruption(const char *what, const void *ptr) {
+        std::fprintf(stderr, "[CELL] FATAL: %s (block %p)\n", what, ptr);
+        std::abort();
+    }
+} // namespace Cell
+
+#endif // CELL_HARDENED
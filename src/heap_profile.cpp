@@ -0,0 +1,213 @@
+#include "heap_profile.h"
+
+#ifdef CELL_ENABLE_HEAP_PROFILE
+
+#include "os_pages.h"
+
+#include <cmath>
+#include <cstring>
+#include <new>
+
+namespace Cell {
+
+    namespace {
+        /** @brief Adds one to a filter counter; a saturated counter stays set for good. */
+        void filter_add(std::atomic<uint8_t> &counter) {
+            uint8_t value = counter.load(std::memory_order_relaxed);
+            while (value != UINT8_MAX &&
+                   !counter.compare_exchange_weak(value, static_cast<uint8_t>(value + 1),
+                                                  std::memory_order_relaxed)) {
+            }
+        }
+
+        void filter_sub(std::atomic<uint8_t> &counter) {
+            uint8_t value = counter.load(std::memory_order_relaxed);
+            while (value != UINT8_MAX && value != 0 &&
+                   !counter.compare_exchange_weak(value, static_cast<uint8_t>(value - 1),
+                                                  std::memory_order_relaxed)) {
+            }
+        }
+
+        unsigned long long ull(uint64_t value) { return static_cast<unsigned long long>(value); }
+    }
+
+    HeapProfiler::HeapProfiler(size_t sample_bytes) : m_sample_bytes(sample_bytes) {
+        void *storage = map_pages(sizeof(Tables));
+        if (storage) {
+            m_tables = new (storage) Tables;
+        }
+    }
+
+    HeapProfiler::~HeapProfiler() {
+        if (m_tables) {
+            unmap_pages(m_tables, sizeof(Tables));
+        }
+    }
+
+    size_t HeapProfiler::next_countdown(uint64_t &rng) const {
+        // xorshift64*, then an exponential draw from a uniform one in (0, 1]
+        rng ^= rng >> 12;
+        rng ^= rng << 25;
+        rng ^= rng >> 27;
+        uint64_t bits = (rng * 0x2545F4914F6CDD1DULL) >> 11;
+        double uniform = static_cast<double>(bits + 1) * (1.0 / 9007199254740992.0);
+        double bytes = -std::log(uniform) * static_cast<double>(m_sample_bytes);
+        if (bytes >= static_cast<double>(SIZE_MAX / 2)) {
+            return SIZE_MAX / 2;
+        }
+        return static_cast<size_t>(bytes) + 1;
+    }
+
+    HeapProfiler::Stack *HeapProfiler::find_stack(void *const *frames, size_t depth) {
+        if (depth == 0) {
+            return &m_tables->overflow;
+        }
+        uint64_t h = 0xCBF29CE484222325ULL;
+        for (size_t i = 0; i < depth; ++i) {
+            h = (h ^ reinterpret_cast<uintptr_t>(frames[i])) * 0x100000001B3ULL;
+        }
+
+        std::lock_guard<std::mutex> lock(m_stack_mutex);
+        size_t i = static_cast<size_t>(h >> 32) & (kHeapProfileStacks - 1);
+        for (; m_tables->stacks[i].used; i = (i + 1) & (kHeapProfileStacks - 1)) {
+            Stack &stack = m_tables->stacks[i];
+            if (stack.hash == h && stack.depth == depth &&
+                std::memcmp(stack.frames, frames, depth * sizeof(void *)) == 0) {
+                return &stack;
+            }
+        }
+        if (m_stack_count >= kHeapProfileStacks / 4 * 3) {
+            return &m_tables->overflow;
+        }
+        Stack &stack = m_tables->stacks[i];
+        stack.hash = h;
+        stack.depth = depth;
+        std::memcpy(stack.frames, frames, depth * sizeof(void *));
+        stack.used = true;
+        ++m_stack_count;
+        return &stack;
+    }
+
+    void HeapProfiler::record(const void *ptr, size_t size, void *const *stack, size_t depth) {
+        Stack *owner = find_stack(stack, depth);
+        auto uptr = reinterpret_cast<uintptr_t>(ptr);
+        uint64_t h = hash(ptr);
+        size_t shard_at = shard_index(h);
+        Shard &shard = m_tables->shards[shard_at];
+
+        std::lock_guard<std::mutex> lock(m_shard_locks[shard_at].mutex);
+        size_t i = slot_index(h);
+        while (shard.slots[i].ptr != 0 && shard.slots[i].ptr != uptr) {
+            i = (i + 1) & (kHeapProfileShardSlots - 1);
+        }
+        Sample &sample = shard.slots[i];
+        if (sample.ptr == uptr) {
+            // A block freed without a free call (release_tag()); the new one takes its place
+            sample.stack->live_count.fetch_sub(1, std::memory_order_relaxed);
+            sample.stack->live_bytes.fetch_sub(sample.size, std::memory_order_relaxed);
+        } else {
+            if (shard.count >= kHeapProfileShardSlots / 4 * 3) {
+                return;
+            }
+            ++shard.count;
+            filter_add(m_tables->filter[filter_index(h)]);
+        }
+        sample.ptr = uptr;
+        sample.size = size;
+        sample.stack = owner;
+        owner->live_count.fetch_add(1, std::memory_order_relaxed);
+        owner->live_bytes.fetch_add(size, std::memory_order_relaxed);
+        owner->total_count.fetch_add(1, std::memory_order_relaxed);
+        owner->total_bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    void HeapProfiler::remove(const void *ptr) {
+        auto uptr = reinterpret_cast<uintptr_t>(ptr);
+        uint64_t h = hash(ptr);
+        size_t shard_at = shard_index(h);
+        Shard &shard = m_tables->shards[shard_at];
+
+        std::lock_guard<std::mutex> lock(m_shard_locks[shard_at].mutex);
+        size_t hole = slot_index(h);
+        while (shard.slots[hole].ptr != uptr) {
+            if (shard.slots[hole].ptr == 0) {
+                return; // Another pointer with the same filter counter
+            }
+            hole = (hole + 1) & (kHeapProfileShardSlots - 1);
+        }
+        Sample &sample = shard.slots[hole];
+        sample.stack->live_count.fetch_sub(1, std::memory_order_relaxed);
+        sample.stack->live_bytes.fetch_sub(sample.size, std::memory_order_relaxed);
+        --shard.count;
+        filter_sub(m_tables->filter[filter_index(h)]);
+
+        // Linear probing without tombstones: pull later entries of the run back into
+        // the hole unless that would put them before their home slot
+        for (size_t next = (hole + 1) & (kHeapProfileShardSlots - 1); shard.slots[next].ptr;
+             next = (next + 1) & (kHeapProfileShardSlots - 1)) {
+            size_t home = slot_index(hash(reinterpret_cast<void *>(shard.slots[next].ptr)));
+            size_t from_home = (next - home) & (kHeapProfileShardSlots - 1);
+            size_t from_hole = (next - hole) & (kHeapProfileShardSlots - 1);
+            if (from_home >= from_hole) {
+                shard.slots[hole] = shard.slots[next];
+                hole = next;
+            }
+        }
+        shard.slots[hole].ptr = 0;
+    }
+
+    bool HeapProfiler::write(std::FILE *out) const {
+        std::lock_guard<std::mutex> lock(m_stack_mutex);
+        auto for_each_stack = [this](auto &&fn) {
+            for (const Stack &stack : m_tables->stacks) {
+                if (stack.used) {
+                    fn(&stack);
+                }
+            }
+            fn(&m_tables->overflow);
+        };
+
+        uint64_t totals[4] = {};
+        for_each_stack([&](const Stack *stack) {
+            totals[0] += stack->live_count.load(std::memory_order_relaxed);
+            totals[1] += stack->live_bytes.load(std::memory_order_relaxed);
+            totals[2] += stack->total_count.load(std::memory_order_relaxed);
+            totals[3] += stack->total_bytes.load(std::memory_order_relaxed);
+        });
+        std::fprintf(out, "heap profile: %llu: %llu [%llu: %llu] @ heap_v2/%zu\n", ull(totals[0]),
+                     ull(totals[1]), ull(totals[2]), ull(totals[3]), m_sample_bytes);
+
+        for_each_stack([&](const Stack *stack) {
+            uint64_t total_count = stack->total_count.load(std::memory_order_relaxed);
+            if (total_count == 0) {
+                return;
+            }
+            std::fprintf(out, "%llu: %llu [%llu: %llu] @",
+                         ull(stack->live_count.load(std::memory_order_relaxed)),
+                         ull(stack->live_bytes.load(std::memory_order_relaxed)), ull(total_count),
+                         ull(stack->total_bytes.load(std::memory_order_relaxed)));
+            for (size_t frame = 0; frame < stack->depth; ++frame) {
+                auto address = reinterpret_cast<uintptr_t>(stack->frames[frame]);
+                std::fprintf(out, " 0x%llx", ull(address));
+            }
+            std::fputc('\n', out);
+        });
+
+#if defined(__linux__)
+        // pprof symbolizes the addresses with the mappings they fall into
+        std::fputs("\nMAPPED_LIBRARIES:\n", out);
+        if (std::FILE *maps = std::fopen("/proc/self/maps", "r")) {
+            char buffer[4096];
+            size_t read;
+            while ((read = std::fread(buffer, 1, sizeof(buffer), maps)) > 0) {
+                std::fwrite(buffer, 1, read, out);
+            }
+            std::fclose(maps);
+        }
+#endif
+        return std::ferror(out) == 0;
+    }
+
+}
+
+#endif // CELL_ENABLE_HEAP_PROFILE
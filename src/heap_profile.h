@@ -0,0 +1,153 @@
+#pragma once
+
+#include "cell/sub_cell.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+
+namespace Cell {
+
+    /** @brief Deepest call stack kept per heap profile sample. */
+    static constexpr size_t kHeapProfileMaxDepth = 32;
+
+    /** @brief Distinct call stacks a heap profile tells apart; later ones share one entry. */
+    static constexpr size_t kHeapProfileStacks = 4096;
+
+    /** @brief Live sample table shards, each behind its own lock. */
+    static constexpr size_t kHeapProfileShards = 16;
+
+    /** @brief Slots per shard; a shard takes samples until it is three quarters full. */
+    static constexpr size_t kHeapProfileShardSlots = 4096;
+
+    /** @brief Counters of the filter that lets frees skip the sample table. */
+    static constexpr size_t kHeapProfileFilterSlots = size_t{1} << 16;
+
+    /**
+     * @brief Sampled live allocations of one Context, by call stack (CELL_ENABLE_HEAP_PROFILE).
+     *
+     * Threads pick which allocations to sample themselves, from a countdown of bytes
+     * (Context::heap_profile_alloc()); only samples reach the profiler. Each sample is
+     * kept by pointer in one of kHeapProfileShards open-addressed tables and counts
+     * towards the call stack it was taken from.
+     *
+     * Frees check a counting filter first: one relaxed load of a byte indexed by a
+     * hash of the pointer, nonzero only if some live sample hashes there too. Only
+     * those frees lock a shard.
+     *
+     * Every table is mapped straight from the OS when the profiler is created, so
+     * profiling never allocates from the heap it is profiling. All zeros is their
+     * empty state: only the pages samples land on are ever faulted in.
+     */
+    class HeapProfiler {
+    public:
+        /**
+         * @param sample_bytes Mean bytes allocated between two samples.
+         */
+        explicit HeapProfiler(size_t sample_bytes);
+        ~HeapProfiler();
+
+        HeapProfiler(const HeapProfiler &) = delete;
+        HeapProfiler &operator=(const HeapProfiler &) = delete;
+
+        /** @brief Checks whether the tables could be mapped. */
+        [[nodiscard]] bool valid() const { return m_tables != nullptr; }
+
+        /**
+         * @brief Draws the bytes a thread allocates before its next sample.
+         *
+         * Exponentially distributed with mean sample_bytes, so every byte is equally
+         * likely to be sampled and allocations of any size cannot fall into step with
+         * the countdown.
+         *
+         * @param rng The thread's random state (nonzero).
+         */
+        [[nodiscard]] size_t next_countdown(uint64_t &rng) const;
+
+        /**
+         * @brief Records a live sample.
+         * @param ptr The allocation.
+         * @param size Bytes requested.
+         * @param stack Return addresses, innermost first.
+         * @param depth Frames in stack.
+         */
+        void record(const void *ptr, size_t size, void *const *stack, size_t depth);
+
+        /** @brief Checks whether ptr may be a live sample (false means it is not). */
+        CELL_FORCE_INLINE bool maybe_sampled(const void *ptr) const {
+            return m_tables->filter[filter_index(hash(ptr))].load(std::memory_order_relaxed) != 0;
+        }
+
+        /** @brief Drops ptr's sample, if it is one. Call before ptr can be reused. */
+        void remove(const void *ptr);
+
+        /**
+         * @brief Writes the live samples in the legacy pprof heap profile format.
+         *
+         * One line per call stack, "heap_v2" with the sampling interval so that pprof
+         * scales the sampled counts back up, then the process's memory map for
+         * symbolization (Linux).
+         *
+         * @return false if writing failed.
+         */
+        bool write(std::FILE *out) const;
+
+    private:
+        // The tables below are trivially constructible: they start out as mapped zeros
+
+        struct Stack {
+            uint64_t hash;
+            size_t depth;
+            void *frames[kHeapProfileMaxDepth];
+            bool used;                         ///< Set once, under m_stack_mutex.
+            std::atomic<uint64_t> live_count;  ///< Samples not yet freed.
+            std::atomic<uint64_t> live_bytes;  ///< Bytes requested by them.
+            std::atomic<uint64_t> total_count; ///< Samples ever taken.
+            std::atomic<uint64_t> total_bytes; ///< Bytes requested by them.
+        };
+
+        struct Sample {
+            uintptr_t ptr; ///< 0 for an empty slot.
+            size_t size;
+            Stack *stack;
+        };
+
+        struct Shard {
+            size_t count; ///< Samples held; guarded by the shard's lock.
+            Sample slots[kHeapProfileShardSlots];
+        };
+
+        struct alignas(64) ShardLock {
+            std::mutex mutex;
+        };
+
+        struct Tables {
+            std::atomic<uint8_t> filter[kHeapProfileFilterSlots];
+            Shard shards[kHeapProfileShards];
+            Stack stacks[kHeapProfileStacks];
+            Stack overflow; ///< Samples of stacks that did not fit, or could not be taken.
+        };
+
+        static uint64_t hash(const void *ptr) {
+            return (reinterpret_cast<uintptr_t>(ptr) >> 4) * 0x9E3779B97F4A7C15ULL;
+        }
+        static size_t filter_index(uint64_t h) { return static_cast<size_t>(h >> 48); }
+        static size_t shard_index(uint64_t h) {
+            return static_cast<size_t>(h >> 44) & (kHeapProfileShards - 1);
+        }
+        static size_t slot_index(uint64_t h) {
+            return static_cast<size_t>(h >> 32) & (kHeapProfileShardSlots - 1);
+        }
+
+        Stack *find_stack(void *const *frames, size_t depth);
+
+        size_t m_sample_bytes;
+        Tables *m_tables = nullptr;
+        mutable ShardLock m_shard_locks[kHeapProfileShards];
+        mutable std::mutex m_stack_mutex; ///< Serializes adding and listing stacks.
+        size_t m_stack_count = 0;         ///< Entries of stacks in use (m_stack_mutex).
+    };
+
+}
@@ -1,7 +1,9 @@
 #include "cell/large.h"
 
+#include <cassert>
 #include <cstdlib>
 #include <cstring>
+#include <new>
 
 #ifdef _WIN32
 #include <malloc.h> // For _aligned_malloc, _aligned_free
@@ -12,21 +14,59 @@
 
 namespace Cell {
 
+    namespace {
+
+        constexpr size_t kPageSize = 4096;
+
+        size_t round_to_page(size_t size) {
+            return (size + kPageSize - 1) & ~(kPageSize - 1);
+        }
+
+        /**
+         * @brief Spreads addresses over a table (Fibonacci hashing).
+         *
+         * Hashes 16-byte granules, not pages: posix_memalign blocks share pages.
+         */
+        size_t hash_address(uintptr_t addr, size_t capacity) {
+            uint64_t h = static_cast<uint64_t>(addr >> 4) * 0x9E3779B97F4A7C15ULL;
+            return static_cast<size_t>(h >> 32) & (capacity - 1);
+        }
+
+    }
+
     // =========================================================================
-    // Destruction
+    // Construction / Destruction
     // =========================================================================
 
+    LargeAllocRegistry::LargeAllocRegistry() = default;
+
     LargeAllocRegistry::~LargeAllocRegistry() {
         // Free all remaining allocations
-        std::lock_guard<std::mutex> lock(m_lock);
-        for (auto &[ptr, alloc] : m_allocs) {
+        Table *table = m_tables.load(std::memory_order_acquire);
+        while (table) {
+            for (size_t i = 0; i < table->capacity; ++i) {
+                Entry &entry = table->slots[i];
+                uintptr_t key = entry.key.load(std::memory_order_relaxed);
+                if (key == 0 || key == kTombstone || key == kBusy) {
+                    continue;
+                }
+                size_t mapped = entry.mapped_size.load(std::memory_order_relaxed);
+                if (mapped) {
+                    unmap_region(reinterpret_cast<void *>(key), mapped);
+                } else {
 #ifdef _WIN32
-            VirtualFree(ptr, 0, MEM_RELEASE);
+                    _aligned_free(reinterpret_cast<void *>(key));
 #else
-            munmap(ptr, alloc.size);
+                    ::free(reinterpret_cast<void *>(key));
 #endif
+                }
+            }
+            Table *next = table->next.load(std::memory_order_relaxed);
+            delete[] table->slots;
+            delete table;
+            table = next;
         }
-        m_allocs.clear();
+        trim_cache();
     }
 
     // =========================================================================
@@ -37,54 +77,46 @@ namespace Cell {
         if (size == 0)
             return nullptr;
 
-        void *ptr = nullptr;
-        bool used_huge = false;
-
-#ifdef _WIN32
-        // Windows: Try large pages first if requested
-        if (try_huge_pages && size >= kMinLargeSize) {
-            // Note: MEM_LARGE_PAGES requires SeLockMemoryPrivilege
-            ptr = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES,
-                               PAGE_READWRITE);
-            if (ptr) {
-                used_huge = true;
-            }
+        if (!reserve_entry()) {
+            return nullptr;
         }
+
+        size_t mapped = mapping_size(size);
+        bool used_huge = false;
+        void *ptr = cache_take(mapped, used_huge);
         if (!ptr) {
-            ptr = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
-        }
-#elif defined(__linux__)
-        // Linux: Try huge pages first if requested
-        if (try_huge_pages && size >= kMinLargeSize) {
-            ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
-                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
-            if (ptr != MAP_FAILED) {
-                used_huge = true;
-            } else {
-                ptr = nullptr;
-            }
+            ptr = map_region(mapped, try_huge_pages, used_huge);
         }
         if (!ptr) {
-            ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-            if (ptr == MAP_FAILED) {
-                ptr = nullptr;
-            }
+            m_count.fetch_sub(1, std::memory_order_relaxed);
+            return nullptr;
         }
-#else
-        // Other Unix (macOS, BSD): Standard mmap without huge pages
-        (void)try_huge_pages; // Unused on this platform
-        ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-        if (ptr == MAP_FAILED) {
-            ptr = nullptr;
+
+        insert(ptr, size, mapped, mapped, tag, used_huge);
+        return ptr;
+    }
+
+    void *LargeAllocRegistry::alloc_reserved(size_t size, size_t reserve_size, uint8_t tag) {
+        if (size == 0)
+            return nullptr;
+
+        if (reserve_size < size) {
+            reserve_size = size;
+        }
+        if (!reserve_entry()) {
+            return nullptr;
         }
-#endif
 
-        if (ptr) {
-            std::lock_guard<std::mutex> lock(m_lock);
-            m_allocs[ptr] = LargeAlloc{size, ptr, tag, used_huge, false};
-            m_total_allocated += size;
+        // Reservations skip the reuse cache: only the committed prefix is accessible
+        size_t mapped = mapping_size(reserve_size);
+        size_t committed = round_to_page(size);
+        void *ptr = reserve_region(mapped, committed);
+        if (!ptr) {
+            m_count.fetch_sub(1, std::memory_order_relaxed);
+            return nullptr;
         }
 
+        insert(ptr, size, mapped, committed, tag, false);
         return ptr;
     }
 
@@ -92,31 +124,39 @@ namespace Cell {
         if (!ptr)
             return;
 
-        std::lock_guard<std::mutex> lock(m_lock);
-        auto it = m_allocs.find(ptr);
-        if (it == m_allocs.end()) {
+        Table *table = nullptr;
+        Entry *entry = find(ptr, &table);
+        if (!entry) {
             return; // Not our allocation
         }
 
-        size_t size = it->second.size;
-        void *original = it->second.original_ptr;
-        bool aligned = it->second.aligned;
-        m_allocs.erase(it);
-        m_total_allocated -= size;
+        size_t size = entry->size.load(std::memory_order_relaxed);
+        size_t mapped = entry->mapped_size.load(std::memory_order_relaxed);
+        size_t committed = entry->committed_size.load(std::memory_order_relaxed);
+        bool huge = entry->huge_pages.load(std::memory_order_relaxed);
 
-#ifdef _WIN32
-        if (aligned) {
-            _aligned_free(original);
-        } else {
-            VirtualFree(original, 0, MEM_RELEASE);
+        // Only one of two racing frees can retire the entry
+        uintptr_t expected = reinterpret_cast<uintptr_t>(ptr);
+        if (!entry->key.compare_exchange_strong(expected, kTombstone, std::memory_order_acq_rel,
+                                                std::memory_order_relaxed)) {
+            return;
         }
-#else
-        if (aligned) {
-            ::free(original); // posix_memalign uses standard free
+        retire(*table, entry);
+        m_total_allocated.fetch_sub(size, std::memory_order_relaxed);
+        m_total_committed.fetch_sub(mapped ? committed : size, std::memory_order_relaxed);
+        m_count.fetch_sub(1, std::memory_order_relaxed);
+
+        if (mapped && committed < mapped) {
+            unmap_region(ptr, mapped); // Partially committed reservation
+        } else if (mapped) {
+            cache_put(ptr, mapped, huge);
         } else {
-            munmap(original, size);
-        }
+#ifdef _WIN32
+            _aligned_free(ptr);
+#else
+            ::free(ptr); // posix_memalign uses standard free
 #endif
+        }
     }
 
     void *LargeAllocRegistry::realloc_bytes(void *ptr, size_t new_size, uint8_t tag) {
@@ -131,24 +171,19 @@ namespace Cell {
             return nullptr;
         }
 
-        // Extract allocation info under lock, then release before OS calls
-        size_t old_size = 0;
-        uint8_t old_tag = 0;
-        {
-            std::lock_guard<std::mutex> lock(m_lock);
-            auto it = m_allocs.find(ptr);
-            if (it == m_allocs.end()) {
-                // Invalid pointer - not owned by this registry
-                return nullptr;
-            }
-            old_size = it->second.size;
-            old_tag = it->second.tag;
+        Table *table = nullptr;
+        Entry *entry = find(ptr, &table);
+        if (!entry) {
+            // Invalid pointer - not owned by this registry
+            return nullptr;
         }
-        // Lock released here - ptr is still valid (we haven't freed it yet)
+        if (void *resized = remap(*table, entry, ptr, new_size)) {
+            return resized;
+        }
+        size_t old_size = entry->size.load(std::memory_order_relaxed);
+        uint8_t old_tag = entry->tag.load(std::memory_order_relaxed);
 
-        // Allocate new block
-        // Note: Using simple allocate+copy+free for phase 1.
-        // Future optimization: use mremap() on Linux for in-place expansion
+        // Allocate new block and copy (aligned blocks, huge pages, no mremap)
         void *new_ptr = alloc(new_size, old_tag);
         if (!new_ptr) {
             // Allocation failed - original block unchanged
@@ -175,6 +210,10 @@ namespace Cell {
             return nullptr;
         }
 
+        if (!reserve_entry()) {
+            return nullptr;
+        }
+
         void *ptr = nullptr;
 
 #ifdef _WIN32
@@ -191,12 +230,12 @@ namespace Cell {
         }
 #endif
 
-        if (ptr) {
-            std::lock_guard<std::mutex> lock(m_lock);
-            m_allocs[ptr] = LargeAlloc{size, ptr, tag, false, true};
-            m_total_allocated += size;
+        if (!ptr) {
+            m_count.fetch_sub(1, std::memory_order_relaxed);
+            return nullptr;
         }
 
+        insert(ptr, size, 0, 0, tag, false);
         return ptr;
     }
 
@@ -205,27 +244,446 @@ namespace Cell {
     // =========================================================================
 
     bool LargeAllocRegistry::owns(void *ptr) const {
-        std::lock_guard<std::mutex> lock(m_lock);
-        return m_allocs.find(ptr) != m_allocs.end();
+        return find(ptr) != nullptr;
     }
 
     size_t LargeAllocRegistry::bytes_allocated() const {
-        std::lock_guard<std::mutex> lock(m_lock);
-        return m_total_allocated;
+        return m_total_allocated.load(std::memory_order_relaxed);
+    }
+
+    size_t LargeAllocRegistry::bytes_committed() const {
+        return m_total_committed.load(std::memory_order_relaxed) + cached_bytes();
     }
 
     size_t LargeAllocRegistry::allocation_count() const {
-        std::lock_guard<std::mutex> lock(m_lock);
-        return m_allocs.size();
+        return m_count.load(std::memory_order_relaxed);
     }
 
     size_t LargeAllocRegistry::get_alloc_size(void *ptr) const {
-        std::lock_guard<std::mutex> lock(m_lock);
-        auto it = m_allocs.find(ptr);
-        if (it == m_allocs.end()) {
+        Entry *entry = find(ptr);
+        if (!entry) {
+            return 0;
+        }
+        return entry->size.load(std::memory_order_relaxed);
+    }
+
+    size_t LargeAllocRegistry::get_capacity(void *ptr) const {
+        Entry *entry = find(ptr);
+        if (!entry) {
             return 0;
         }
-        return it->second.size;
+        size_t mapped = entry->mapped_size.load(std::memory_order_relaxed);
+        return mapped ? mapped : entry->size.load(std::memory_order_relaxed);
+    }
+
+    // =========================================================================
+    // Reuse Cache
+    // =========================================================================
+
+    size_t LargeAllocRegistry::cached_bytes() const {
+        std::lock_guard<std::mutex> lock(m_cache_lock);
+        return m_cache_bytes;
+    }
+
+    size_t LargeAllocRegistry::trim_cache() {
+        CachedMapping victims[kCacheMaxEntries];
+        size_t victim_count = 0;
+        size_t released = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_cache_lock);
+            for (size_t i = 0; i < m_cache_count; ++i) {
+                victims[victim_count++] = m_cache[i];
+                released += m_cache[i].size;
+            }
+            m_cache_count = 0;
+            m_cache_bytes = 0;
+        }
+
+        // Unmap outside the lock so concurrent alloc/free are not held up by syscalls
+        for (size_t i = 0; i < victim_count; ++i) {
+            unmap_region(victims[i].base, victims[i].size);
+        }
+        return released;
+    }
+
+    void *LargeAllocRegistry::cache_take(size_t mapped_size, bool &huge_pages) {
+        if (mapped_size > kCacheMaxBlockSize) {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(m_cache_lock);
+        // Prefer the most recently cached mapping: its pages are likeliest to be warm
+        for (size_t i = m_cache_count; i-- > 0;) {
+            if (m_cache[i].size == mapped_size) {
+                void *base = m_cache[i].base;
+                huge_pages = m_cache[i].huge_pages;
+                m_cache_bytes -= mapped_size;
+                m_cache[i] = m_cache[--m_cache_count];
+                return base;
+            }
+        }
+        return nullptr;
+    }
+
+    void LargeAllocRegistry::cache_put(void *base, size_t mapped_size, bool huge_pages) {
+        if (mapped_size > kCacheMaxBlockSize || mapped_size > kCacheMaxBytes) {
+            unmap_region(base, mapped_size);
+            return;
+        }
+
+        CachedMapping victims[kCacheMaxEntries];
+        size_t victim_count = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_cache_lock);
+            uint64_t now = ++m_cache_clock;
+
+            // Age out mappings that no recent alloc has asked for
+            for (size_t i = 0; i < m_cache_count;) {
+                if (now - m_cache[i].last_use > kCacheMaxAge) {
+                    victims[victim_count++] = m_cache[i];
+                    m_cache_bytes -= m_cache[i].size;
+                    m_cache[i] = m_cache[--m_cache_count];
+                } else {
+                    ++i;
+                }
+            }
+
+            // Evict oldest until the new mapping fits the count and byte caps
+            while (m_cache_count == kCacheMaxEntries ||
+                   m_cache_bytes + mapped_size > kCacheMaxBytes) {
+                size_t oldest = 0;
+                for (size_t i = 1; i < m_cache_count; ++i) {
+                    if (m_cache[i].last_use < m_cache[oldest].last_use) {
+                        oldest = i;
+                    }
+                }
+                victims[victim_count++] = m_cache[oldest];
+                m_cache_bytes -= m_cache[oldest].size;
+                m_cache[oldest] = m_cache[--m_cache_count];
+            }
+
+            m_cache[m_cache_count++] = CachedMapping{base, mapped_size, now, huge_pages};
+            m_cache_bytes += mapped_size;
+        }
+
+        for (size_t i = 0; i < victim_count; ++i) {
+            unmap_region(victims[i].base, victims[i].size);
+        }
+    }
+
+    // =========================================================================
+    // Internal Methods
+    // =========================================================================
+
+    size_t LargeAllocRegistry::mapping_size(size_t size) {
+        size_t page_rounded = round_to_page(size);
+        if (page_rounded > kCacheMaxBlockSize || page_rounded <= kPageSize) {
+            return page_rounded;
+        }
+
+        // Largest power of 2 below the size; classes are a quarter of it apart
+        size_t high_bit = kPageSize;
+        while (high_bit * 2 < page_rounded) {
+            high_bit *= 2;
+        }
+        size_t step = high_bit / 4 > kPageSize ? high_bit / 4 : kPageSize;
+        return (page_rounded + step - 1) & ~(step - 1);
+    }
+
+    bool LargeAllocRegistry::reserve_entry() {
+        size_t count = m_count.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (count <= m_table_limit.load(std::memory_order_acquire)) {
+            return true;
+        }
+
+        // Chain on tables until every reserved entry has room; readers see each one
+        // complete through the release store that links it
+        std::lock_guard<std::mutex> lock(m_table_lock);
+        while (count > m_table_limit.load(std::memory_order_relaxed)) {
+            std::atomic<Table *> *link = &m_tables;
+            size_t capacity = kTableCapacity;
+            while (Table *last = link->load(std::memory_order_relaxed)) {
+                capacity = last->capacity * 2;
+                link = &last->next;
+            }
+            auto *table = new (std::nothrow) Table;
+            Entry *slots = table ? new (std::nothrow) Entry[capacity] : nullptr;
+            if (!slots) {
+                delete table;
+                m_count.fetch_sub(1, std::memory_order_relaxed);
+                return false;
+            }
+            table->slots = slots;
+            table->capacity = capacity;
+            link->store(table, std::memory_order_release);
+            m_table_limit.fetch_add(table->max_live(), std::memory_order_release);
+        }
+        return true;
+    }
+
+    void LargeAllocRegistry::insert(void *ptr, size_t size, size_t mapped_size,
+                                    size_t committed_size, uint8_t tag, bool huge_pages) {
+        uintptr_t key = reinterpret_cast<uintptr_t>(ptr);
+
+        // reserve_entry() keeps live + reserved entries within the tables' max_live(),
+        // so some table has room and, below capacity, a free slot. Under the lock no
+        // other insert or tombstone clearing can change a free slot.
+        std::lock_guard<std::mutex> lock(m_table_lock);
+        Table *table = m_tables.load(std::memory_order_relaxed);
+        while (table && table->live >= table->max_live()) {
+            table = table->next.load(std::memory_order_relaxed);
+        }
+        assert(table && "Large allocation insert without a reserved entry");
+        size_t mask = table->capacity - 1;
+        size_t index = hash_address(key, table->capacity);
+        for (size_t probe = 0; probe < table->capacity; ++probe) {
+            Entry &entry = table->slots[(index + probe) & mask];
+            uintptr_t current = entry.key.load(std::memory_order_relaxed);
+            if (current != 0 && current != kTombstone) {
+                continue;
+            }
+            entry.key.store(kBusy, std::memory_order_relaxed);
+            entry.size.store(size, std::memory_order_relaxed);
+            entry.mapped_size.store(mapped_size, std::memory_order_relaxed);
+            entry.committed_size.store(committed_size, std::memory_order_relaxed);
+            entry.tag.store(tag, std::memory_order_relaxed);
+            entry.huge_pages.store(huge_pages, std::memory_order_relaxed);
+            entry.key.store(key, std::memory_order_release);
+            ++table->live;
+
+            m_total_allocated.fetch_add(size, std::memory_order_relaxed);
+            m_total_committed.fetch_add(mapped_size ? committed_size : size,
+                                        std::memory_order_relaxed);
+            return;
+        }
+        assert(false && "Large allocation table has no free slot");
+    }
+
+    void *LargeAllocRegistry::remap(Table &table, Entry *entry, void *ptr, size_t new_size) {
+        size_t mapped = entry->mapped_size.load(std::memory_order_relaxed);
+        if (!mapped) {
+            return nullptr; // posix_memalign block
+        }
+        size_t committed = entry->committed_size.load(std::memory_order_relaxed);
+        size_t old_size = entry->size.load(std::memory_order_relaxed);
+        size_t needed = round_to_page(new_size);
+
+        // Fits the reservation, or stays in the same size class: nothing moves
+        if (needed <= mapped && (committed < mapped || mapping_size(new_size) == mapped)) {
+            if (needed > committed) {
+                if (!commit_region(static_cast<char *>(ptr) + committed, needed - committed)) {
+                    return nullptr;
+                }
+                entry->committed_size.store(needed, std::memory_order_relaxed);
+                m_total_committed.fetch_add(needed - committed, std::memory_order_relaxed);
+            }
+            entry->size.store(new_size, std::memory_order_relaxed);
+            m_total_allocated.fetch_add(new_size, std::memory_order_relaxed);
+            m_total_allocated.fetch_sub(old_size, std::memory_order_relaxed);
+            return ptr;
+        }
+
+#if defined(__linux__)
+        // Huge page mappings can only be remapped in huge page multiples
+        if (entry->huge_pages.load(std::memory_order_relaxed)) {
+            return nullptr;
+        }
+
+        // Outgrowing a reservation: make it one uniform mapping so mremap accepts it
+        if (committed < mapped) {
+            if (!commit_region(static_cast<char *>(ptr) + committed, mapped - committed)) {
+                return nullptr;
+            }
+            entry->committed_size.store(mapped, std::memory_order_relaxed);
+            m_total_committed.fetch_add(mapped - committed, std::memory_order_relaxed);
+        }
+
+        size_t new_mapped = mapping_size(new_size);
+        void *moved = mremap(ptr, mapped, new_mapped, MREMAP_MAYMOVE);
+        if (moved == MAP_FAILED) {
+            return nullptr;
+        }
+
+        if (moved == ptr) {
+            entry->size.store(new_size, std::memory_order_relaxed);
+            entry->mapped_size.store(new_mapped, std::memory_order_relaxed);
+            entry->committed_size.store(new_mapped, std::memory_order_relaxed);
+            m_total_allocated.fetch_add(new_size, std::memory_order_relaxed);
+            m_total_allocated.fetch_sub(old_size, std::memory_order_relaxed);
+            m_total_committed.fetch_add(new_mapped, std::memory_order_relaxed);
+            m_total_committed.fetch_sub(mapped, std::memory_order_relaxed);
+        } else {
+            // New address hashes elsewhere: retire the old entry, register the new one.
+            // The live count is unchanged, so insert() still finds a slot.
+            uint8_t tag = entry->tag.load(std::memory_order_relaxed);
+            entry->key.store(kTombstone, std::memory_order_release);
+            retire(table, entry);
+            m_total_allocated.fetch_sub(old_size, std::memory_order_relaxed);
+            m_total_committed.fetch_sub(mapped, std::memory_order_relaxed);
+            insert(moved, new_size, new_mapped, new_mapped, tag, false);
+        }
+        return moved;
+#else
+        return nullptr;
+#endif
+    }
+
+    void LargeAllocRegistry::retire(Table &table, Entry *entry) {
+        std::lock_guard<std::mutex> lock(m_table_lock);
+        --table.live;
+        clear_tombstones(table, entry);
+    }
+
+    void LargeAllocRegistry::clear_tombstones(Table &table, Entry *entry) {
+        size_t mask = table.capacity - 1;
+        auto index = static_cast<size_t>(entry - table.slots);
+
+        // Every probe chain through a tombstone followed by an empty slot ends at that
+        // slot anyway, so the tombstone can be emptied, and so can the run before it.
+        // Only this and insert() turn a tombstone into something else, both locked.
+        if (table.slots[(index + 1) & mask].key.load(std::memory_order_relaxed) != 0) {
+            return;
+        }
+        while (table.slots[index].key.load(std::memory_order_relaxed) == kTombstone) {
+            table.slots[index].key.store(0, std::memory_order_release);
+            index = (index - 1) & mask;
+        }
+    }
+
+    size_t LargeAllocRegistry::probe_length(const void *ptr) const {
+        uintptr_t key = reinterpret_cast<uintptr_t>(ptr);
+        if (key <= kBusy) {
+            return 0;
+        }
+
+        size_t probes = 0;
+        for (Table *table = m_tables.load(std::memory_order_acquire); table;
+             table = table->next.load(std::memory_order_acquire)) {
+            size_t mask = table->capacity - 1;
+            size_t index = hash_address(key, table->capacity);
+            for (size_t probe = 0; probe < table->capacity; ++probe) {
+                uintptr_t current =
+                    table->slots[(index + probe) & mask].key.load(std::memory_order_acquire);
+                ++probes;
+                if (current == key) {
+                    return probes;
+                }
+                if (current == 0) {
+                    break;
+                }
+            }
+        }
+        return probes;
+    }
+
+    LargeAllocRegistry::Entry *LargeAllocRegistry::find(void *ptr, Table **owner) const {
+        uintptr_t key = reinterpret_cast<uintptr_t>(ptr);
+        if (key <= kBusy) {
+            return nullptr;
+        }
+
+        for (Table *table = m_tables.load(std::memory_order_acquire); table;
+             table = table->next.load(std::memory_order_acquire)) {
+            size_t mask = table->capacity - 1;
+            size_t index = hash_address(key, table->capacity);
+            for (size_t probe = 0; probe < table->capacity; ++probe) {
+                Entry &entry = table->slots[(index + probe) & mask];
+                uintptr_t current = entry.key.load(std::memory_order_acquire);
+                if (current == key) {
+                    if (owner) {
+                        *owner = table;
+                    }
+                    return &entry;
+                }
+                if (current == 0) {
+                    break; // An empty slot ends the probe chain
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    void *LargeAllocRegistry::map_region(size_t size, bool try_huge_pages, bool &used_huge) {
+        void *ptr = nullptr;
+        used_huge = false;
+
+#ifdef _WIN32
+        // Windows: Try large pages first if requested
+        if (try_huge_pages && size >= kMinLargeSize) {
+            // Note: MEM_LARGE_PAGES requires SeLockMemoryPrivilege
+            ptr = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES,
+                               PAGE_READWRITE);
+            if (ptr) {
+                used_huge = true;
+            }
+        }
+        if (!ptr) {
+            ptr = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+        }
+#elif defined(__linux__)
+        // Linux: Try huge pages first if requested
+        if (try_huge_pages && size >= kMinLargeSize) {
+            ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (ptr != MAP_FAILED) {
+                used_huge = true;
+            } else {
+                ptr = nullptr;
+            }
+        }
+        if (!ptr) {
+            ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr == MAP_FAILED) {
+                ptr = nullptr;
+            }
+        }
+#else
+        // Other Unix (macOS, BSD): Standard mmap without huge pages
+        (void)try_huge_pages; // Unused on this platform
+        ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) {
+            ptr = nullptr;
+        }
+#endif
+
+        return ptr;
+    }
+
+    void *LargeAllocRegistry::reserve_region(size_t reserve_size, size_t commit_size) {
+#ifdef _WIN32
+        void *ptr = VirtualAlloc(nullptr, reserve_size, MEM_RESERVE, PAGE_NOACCESS);
+        if (!ptr) {
+            return nullptr;
+        }
+#else
+        void *ptr = mmap(nullptr, reserve_size, PROT_NONE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (ptr == MAP_FAILED) {
+            return nullptr;
+        }
+#endif
+        if (!commit_region(ptr, commit_size)) {
+            unmap_region(ptr, reserve_size);
+            return nullptr;
+        }
+        return ptr;
+    }
+
+    bool LargeAllocRegistry::commit_region(void *base, size_t size) {
+#ifdef _WIN32
+        return VirtualAlloc(base, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+        return mprotect(base, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+    }
+
+    void LargeAllocRegistry::unmap_region(void *base, size_t size) {
+#ifdef _WIN32
+        (void)size;
+        VirtualFree(base, 0, MEM_RELEASE);
+#else
+        munmap(base, size);
+#endif
     }
 
 }
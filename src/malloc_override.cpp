@@ -0,0 +1,369 @@
+/**
+ * @file malloc_override.cpp
+ * @brief malloc/free and the global operator new/delete served by one process-wide Context.
+ *
+ * Built as the cell_malloc shared library (CELL_BUILD_MALLOC=ON, Linux/glibc).
+ * Preloading it (LD_PRELOAD=libcell_malloc.so) or linking it ahead of libc routes every
+ * heap allocation of an unmodified program through Cell.
+ *
+ * The Context is constructed in static storage on first use and never destroyed, so
+ * frees that run during static destruction stay valid. Allocations made while the
+ * calling thread is already inside one of these entry points (the Context's own
+ * bookkeeping, thread-exit registration, the Context being constructed) go to glibc,
+ * as do allocations the Context cannot satisfy once its reservation is used up.
+ * Frees therefore route by owner: anything Context::owns() does not recognize is
+ * handed back to glibc.
+ *
+ * Environment:
+ * - CELL_MALLOC_RESERVE_MB: address space to reserve (default: Config::reserve_size)
+ * - CELL_MALLOC_SCAVENGE_MS: run the background scavenger at this interval (default: off)
+ */
+
+#include "cell/malloc_override.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#include <dlfcn.h>
+#include <unistd.h>
+
+// glibc's own allocator, for recursive calls and for pointers the Context does not own
+extern "C" {
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t count, size_t size);
+    void *__libc_realloc(void *ptr, size_t size);
+    void *__libc_memalign(size_t alignment, size_t size);
+    void __libc_free(void *ptr);
+}
+
+namespace Cell {
+
+    namespace {
+
+        /** @brief Alignment malloc() guarantees (alignof(max_align_t)). */
+        constexpr size_t kMallocAlignment = 16;
+
+        alignas(Context) unsigned char s_context_storage[sizeof(Context)];
+        std::atomic<Context *> s_context{nullptr};
+        std::atomic<bool> s_constructing{false};
+
+        /**
+         * @brief Entry-point nesting depth of the calling thread.
+         *
+         * Initial-exec so that reading it never calls into the dynamic loader (which
+         * may allocate) the first time a thread gets here.
+         */
+        __attribute__((tls_model("initial-exec"))) thread_local unsigned t_depth = 0;
+
+        /** @brief Marks the calling thread as inside an entry point for its scope. */
+        struct EntryScope {
+            EntryScope() { ++t_depth; }
+            ~EntryScope() { --t_depth; }
+        };
+
+        size_t env_size(const char *name, size_t fallback) {
+            const char *value = std::getenv(name);
+            if (!value || *value == '\0') {
+                return fallback;
+            }
+            char *end = nullptr;
+            unsigned long long parsed = std::strtoull(value, &end, 10);
+            return (*end == '\0' && parsed > 0) ? static_cast<size_t>(parsed) : fallback;
+        }
+
+        Context *create_context() {
+            bool expected = false;
+            if (!s_constructing.compare_exchange_strong(expected, true,
+                                                        std::memory_order_acquire)) {
+                // Another thread is constructing it; its allocations meanwhile go to glibc
+                Context *context;
+                while ((context = s_context.load(std::memory_order_acquire)) == nullptr) {
+                    std::this_thread::yield();
+                }
+                return context;
+            }
+
+            EntryScope scope;
+            Config config;
+            config.reserve_size =
+                env_size("CELL_MALLOC_RESERVE_MB", config.reserve_size >> 20) << 20;
+            size_t scavenge_ms = env_size("CELL_MALLOC_SCAVENGE_MS", 0);
+            if (scavenge_ms > 0) {
+                config.background_scavenger = true;
+                config.scavenge_interval_ms = static_cast<uint32_t>(scavenge_ms);
+            }
+
+            auto *context = new (s_context_storage) Context(config);
+            s_context.store(context, std::memory_order_release);
+            return context;
+        }
+
+        CELL_FORCE_INLINE Context *context() {
+            Context *context = s_context.load(std::memory_order_acquire);
+            return CELL_LIKELY(context != nullptr) ? context : create_context();
+        }
+
+        /** @brief Returns the Context if it owns ptr, nullptr for glibc pointers. */
+        CELL_FORCE_INLINE Context *owner_of(void *ptr) {
+            Context *context = s_context.load(std::memory_order_acquire);
+            return context && context->owns(ptr) ? context : nullptr;
+        }
+
+        CELL_FORCE_INLINE void *heap_alloc(size_t size) {
+            if (CELL_UNLIKELY(t_depth != 0)) {
+                return __libc_malloc(size);
+            }
+            EntryScope scope;
+            // Size classes, cells and buddy blocks all keep kMallocAlignment
+            void *ptr = context()->alloc_bytes(size ? size : 1);
+            return CELL_LIKELY(ptr != nullptr) ? ptr : __libc_malloc(size);
+        }
+
+        void *heap_alloc_aligned(size_t alignment, size_t size) {
+            if (alignment <= kMallocAlignment) {
+                return heap_alloc(size);
+            }
+            if (t_depth != 0) {
+                return __libc_memalign(alignment, size);
+            }
+            EntryScope scope;
+            void *ptr = context()->alloc_aligned(size ? size : 1, alignment);
+            return ptr ? ptr : __libc_memalign(alignment, size);
+        }
+
+        CELL_FORCE_INLINE void heap_free(void *ptr) {
+            if (CELL_UNLIKELY(ptr == nullptr)) {
+                return;
+            }
+            if (Context *context = owner_of(ptr)) {
+                EntryScope scope;
+                context->free_bytes(ptr);
+                return;
+            }
+            __libc_free(ptr);
+        }
+
+        CELL_FORCE_INLINE void heap_free_sized(void *ptr, size_t size) {
+            if (CELL_UNLIKELY(ptr == nullptr)) {
+                return;
+            }
+            if (Context *context = owner_of(ptr)) {
+                EntryScope scope;
+                context->free_sized(ptr, size ? size : 1);
+                return;
+            }
+            __libc_free(ptr);
+        }
+
+        void heap_free_aligned_sized(void *ptr, size_t size, size_t alignment) {
+            if (alignment <= kMallocAlignment) {
+                heap_free_sized(ptr, size);
+                return;
+            }
+            if (ptr == nullptr) {
+                return;
+            }
+            if (Context *context = owner_of(ptr)) {
+                EntryScope scope;
+                context->free_aligned_sized(ptr, size ? size : 1, alignment);
+                return;
+            }
+            __libc_free(ptr);
+        }
+
+        void *heap_realloc(void *ptr, size_t size) {
+            if (ptr == nullptr) {
+                return heap_alloc(size);
+            }
+            Context *context = owner_of(ptr);
+            if (!context) {
+                return __libc_realloc(ptr, size);
+            }
+            if (size == 0) {
+                heap_free(ptr);
+                return nullptr;
+            }
+
+            EntryScope scope;
+            if (void *moved = context->realloc_bytes(ptr, size)) {
+                return moved;
+            }
+            // Out of reservation: move the block to glibc
+            void *moved = __libc_malloc(size);
+            if (moved) {
+                std::memcpy(moved, ptr, std::min(context->usable_size(ptr), size));
+                context->free_bytes(ptr);
+            }
+            return moved;
+        }
+
+        size_t libc_usable_size(void *ptr) {
+            using UsableSizeFn = size_t (*)(void *);
+            static std::atomic<UsableSizeFn> s_next{nullptr};
+            UsableSizeFn next = s_next.load(std::memory_order_acquire);
+            if (!next) {
+                EntryScope scope; // dlsym may allocate
+                next = reinterpret_cast<UsableSizeFn>(dlsym(RTLD_NEXT, "malloc_usable_size"));
+                if (!next) {
+                    return 0;
+                }
+                s_next.store(next, std::memory_order_release);
+            }
+            return next(ptr);
+        }
+
+        void *new_or_throw(size_t size, size_t alignment) {
+            for (;;) {
+                void *ptr = heap_alloc_aligned(alignment, size);
+                if (CELL_LIKELY(ptr != nullptr)) {
+                    return ptr;
+                }
+                std::new_handler handler = std::get_new_handler();
+                if (!handler) {
+                    throw std::bad_alloc();
+                }
+                handler();
+            }
+        }
+
+        void *new_or_null(size_t size, size_t alignment) noexcept {
+            try {
+                return new_or_throw(size, alignment);
+            } catch (...) {
+                return nullptr;
+            }
+        }
+
+    }
+
+    Context &process_context() { return *context(); }
+
+}
+
+// =============================================================================
+// C Allocation API
+// =============================================================================
+
+using Cell::heap_alloc;
+using Cell::heap_alloc_aligned;
+using Cell::heap_free;
+
+extern "C" {
+
+    void *malloc(size_t size) noexcept { return heap_alloc(size); }
+
+    void free(void *ptr) noexcept { heap_free(ptr); }
+
+    void *calloc(size_t count, size_t size) noexcept {
+        size_t total;
+        if (__builtin_mul_overflow(count, size, &total)) {
+            errno = ENOMEM;
+            return nullptr;
+        }
+        if (Cell::t_depth != 0) {
+            return __libc_calloc(count, size);
+        }
+        void *ptr = heap_alloc(total);
+        if (ptr) {
+            std::memset(ptr, 0, total);
+        }
+        return ptr;
+    }
+
+    void *realloc(void *ptr, size_t size) noexcept { return Cell::heap_realloc(ptr, size); }
+
+    int posix_memalign(void **out, size_t alignment, size_t size) noexcept {
+        if (alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0) {
+            return EINVAL;
+        }
+        void *ptr = heap_alloc_aligned(alignment, size);
+        if (!ptr) {
+            return ENOMEM;
+        }
+        *out = ptr;
+        return 0;
+    }
+
+    void *aligned_alloc(size_t alignment, size_t size) noexcept {
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+            errno = EINVAL;
+            return nullptr;
+        }
+        return heap_alloc_aligned(alignment, size);
+    }
+
+    void *memalign(size_t alignment, size_t size) noexcept {
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+            errno = EINVAL;
+            return nullptr;
+        }
+        return heap_alloc_aligned(alignment, size);
+    }
+
+    void *valloc(size_t size) noexcept {
+        return heap_alloc_aligned(static_cast<size_t>(sysconf(_SC_PAGESIZE)), size);
+    }
+
+    size_t malloc_usable_size(void *ptr) noexcept {
+        if (ptr == nullptr) {
+            return 0;
+        }
+        if (Cell::Context *context = Cell::owner_of(ptr)) {
+            return context->usable_size(ptr);
+        }
+        return Cell::libc_usable_size(ptr);
+    }
+}
+
+// =============================================================================
+// Global operator new / delete
+// =============================================================================
+
+void *operator new(size_t size) { return Cell::new_or_throw(size, 0); }
+void *operator new[](size_t size) { return Cell::new_or_throw(size, 0); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    return Cell::new_or_null(size, 0);
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    return Cell::new_or_null(size, 0);
+}
+
+void *operator new(size_t size, std::align_val_t alignment) {
+    return Cell::new_or_throw(size, static_cast<size_t>(alignment));
+}
+void *operator new[](size_t size, std::align_val_t alignment) {
+    return Cell::new_or_throw(size, static_cast<size_t>(alignment));
+}
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return Cell::new_or_null(size, static_cast<size_t>(alignment));
+}
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return Cell::new_or_null(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *ptr) noexcept { heap_free(ptr); }
+void operator delete[](void *ptr) noexcept { heap_free(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { heap_free(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { heap_free(ptr); }
+void operator delete(void *ptr, size_t size) noexcept { Cell::heap_free_sized(ptr, size); }
+void operator delete[](void *ptr, size_t size) noexcept { Cell::heap_free_sized(ptr, size); }
+
+void operator delete(void *ptr, std::align_val_t) noexcept { heap_free(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { heap_free(ptr); }
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept {
+    heap_free(ptr);
+}
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept {
+    heap_free(ptr);
+}
+void operator delete(void *ptr, size_t size, std::align_val_t alignment) noexcept {
+    Cell::heap_free_aligned_sized(ptr, size, static_cast<size_t>(alignment));
+}
+void operator delete[](void *ptr, size_t size, std::align_val_t alignment) noexcept {
+    Cell::heap_free_aligned_sized(ptr, size, static_cast<size_t>(alignment));
+}
@@ -0,0 +1,118 @@
+#include "numa.h"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Cell {
+
+    namespace {
+
+        constexpr uint32_t kUnknownNode = ~uint32_t{0};
+
+        thread_local uint32_t t_home_node = kUnknownNode;
+
+#if defined(__linux__)
+        // Avoid <numaif.h>: it ships with libnuma, which we do not link
+        constexpr int kMpolPreferred = 1;
+
+        /** @brief Parses the highest node id from a sysfs list such as "0-1,3". */
+        size_t parse_highest_node(const char *text) {
+            size_t highest = 0;
+            size_t value = 0;
+            bool in_number = false;
+            for (const char *p = text; *p; ++p) {
+                if (*p >= '0' && *p <= '9') {
+                    value = value * 10 + static_cast<size_t>(*p - '0');
+                    in_number = true;
+                } else {
+                    if (in_number && value > highest) {
+                        highest = value;
+                    }
+                    value = 0;
+                    in_number = false;
+                }
+            }
+            if (in_number && value > highest) {
+                highest = value;
+            }
+            return highest;
+        }
+#endif
+
+    }
+
+    size_t numa_node_count() {
+#if defined(_WIN32)
+        ULONG highest = 0;
+        if (!GetNumaHighestNodeNumber(&highest)) {
+            return 1;
+        }
+        return static_cast<size_t>(highest) + 1;
+#elif defined(__linux__)
+        // Plain read(): stdio may allocate, and this can run inside a malloc shim
+        int fd = open("/sys/devices/system/node/online", O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return 1;
+        }
+        char buffer[256];
+        ssize_t length = read(fd, buffer, sizeof(buffer) - 1);
+        close(fd);
+        if (length <= 0) {
+            return 1;
+        }
+        buffer[length] = '\0';
+        return parse_highest_node(buffer) + 1;
+#else
+        return 1;
+#endif
+    }
+
+    uint32_t current_numa_node() {
+        if (t_home_node != kUnknownNode) {
+            return t_home_node;
+        }
+
+        uint32_t node = 0;
+#if defined(_WIN32)
+        PROCESSOR_NUMBER processor;
+        GetCurrentProcessorNumberEx(&processor);
+        USHORT node_number = 0;
+        if (GetNumaProcessorNodeEx(&processor, &node_number)) {
+            node = node_number;
+        }
+#elif defined(__linux__) && defined(SYS_getcpu)
+        unsigned cpu = 0;
+        unsigned node_number = 0;
+        if (syscall(SYS_getcpu, &cpu, &node_number, nullptr) == 0) {
+            node = node_number;
+        }
+#endif
+        t_home_node = node;
+        return node;
+    }
+
+    bool bind_to_numa_node(void *addr, size_t size, uint32_t node) {
+#if defined(__linux__) && defined(SYS_mbind)
+        constexpr size_t kMaskBits = 64;
+        if (node >= kMaskBits) {
+            return false;
+        }
+        unsigned long mask = 1UL << node;
+        return syscall(SYS_mbind, addr, size, kMpolPreferred, &mask, kMaskBits + 1, 0) == 0;
+#else
+        (void)addr;
+        (void)size;
+        (void)node;
+        return false;
+#endif
+    }
+
+}
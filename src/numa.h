@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Cell {
+
+    /**
+     * @brief Returns the number of NUMA nodes on this machine (at least 1).
+     */
+    size_t numa_node_count();
+
+    /**
+     * @brief Returns the calling thread's home NUMA node.
+     *
+     * Sampled from the CPU the thread runs on the first time it asks, then cached
+     * for the thread's lifetime so per-node caches never mix nodes when the
+     * scheduler migrates it.
+     */
+    uint32_t current_numa_node();
+
+    /**
+     * @brief Asks the OS to place a range's pages on the given node.
+     *
+     * Uses a preferred (not strict) policy, so allocation still succeeds from
+     * another node when this one is out of memory. Where binding is unsupported
+     * the range keeps first-touch placement.
+     *
+     * @return true if the policy was applied.
+     */
+    bool bind_to_numa_node(void *addr, size_t size, uint32_t node);
+
+}
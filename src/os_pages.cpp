@@ -0,0 +1,200 @@
+#include "os_pages.h"
+
+#include <chrono>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Cell {
+
+#if !defined(_WIN32)
+    namespace {
+
+        void advise_huge_pages(void *addr, size_t size) {
+#if defined(MADV_HUGEPAGE)
+            // Advisory only: THP may be disabled system-wide, which is not an error
+            madvise(addr, size, MADV_HUGEPAGE);
+#else
+            (void)addr;
+            (void)size;
+#endif
+        }
+
+        bool map_fixed(void *addr, size_t size, int prot, int extra_flags) {
+            void *result = mmap(addr, size, prot, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | extra_flags,
+                                -1, 0);
+            return result == addr;
+        }
+
+    }
+#endif
+
+    bool commit_pages(void *addr, size_t size, HugePagePolicy policy) {
+#if defined(_WIN32)
+        (void)policy; // Large pages cannot be committed into an existing reservation
+        return VirtualAlloc(addr, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+#if defined(MAP_HUGETLB)
+        if (policy == HugePagePolicy::kExplicit) {
+            if (map_fixed(addr, size, PROT_READ | PROT_WRITE, MAP_HUGETLB)) {
+                return true;
+            }
+            // Pool exhausted. A failed MAP_FIXED may already have dropped the old
+            // mapping, so re-map the range with regular pages rather than mprotect it.
+            if (!map_fixed(addr, size, PROT_READ | PROT_WRITE, MAP_NORESERVE)) {
+                return false;
+            }
+            advise_huge_pages(addr, size);
+            return true;
+        }
+#endif
+        if (mprotect(addr, size, PROT_READ | PROT_WRITE) != 0) {
+            return false;
+        }
+        if (policy != HugePagePolicy::kNone) {
+            advise_huge_pages(addr, size);
+        }
+        return true;
+#endif
+    }
+
+    bool decommit_pages(void *addr, size_t size, HugePagePolicy policy, bool lazy) {
+#if defined(_WIN32)
+        (void)policy;
+        (void)lazy;
+        return VirtualFree(addr, size, MEM_DECOMMIT) != 0;
+#else
+#if defined(MAP_HUGETLB)
+        if (policy == HugePagePolicy::kExplicit) {
+            // hugetlbfs pages only go back to the pool when the mapping is replaced
+            return map_fixed(addr, size, PROT_READ | PROT_WRITE, MAP_NORESERVE);
+        }
+#endif
+        (void)policy;
+#if defined(MADV_FREE)
+        // Kernels before 4.5 reject MADV_FREE; fall through to an eager release
+        if (lazy && madvise(addr, size, MADV_FREE) == 0) {
+            return true;
+        }
+#else
+        (void)lazy;
+#endif
+        return madvise(addr, size, MADV_DONTNEED) == 0;
+#endif
+    }
+
+    void populate_pages(void *addr, size_t size) {
+#if defined(__linux__)
+        // Faults the range in with one call; MADV_WILLNEED does nothing for anonymous
+        // memory. Older kernels reject the advice and take the loop below.
+#if defined(MADV_POPULATE_WRITE)
+        constexpr int kPopulateWrite = MADV_POPULATE_WRITE;
+#else
+        constexpr int kPopulateWrite = 23; // Its Linux value, for older headers
+#endif
+        if (madvise(addr, size, kPopulateWrite) == 0) {
+            return;
+        }
+#endif
+        constexpr size_t kPageSize = 4096;
+        auto *bytes = static_cast<volatile char *>(addr);
+        for (size_t offset = 0; offset < size; offset += kPageSize) {
+            bytes[offset] = bytes[offset];
+        }
+    }
+
+    void *map_pages(size_t size) {
+#if defined(_WIN32)
+        return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+        void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return ptr == MAP_FAILED ? nullptr : ptr;
+#endif
+    }
+
+    void unmap_pages(void *addr, size_t size) {
+#if defined(_WIN32)
+        (void)size;
+        VirtualFree(addr, 0, MEM_RELEASE);
+#else
+        munmap(addr, size);
+#endif
+    }
+
+    bool reserve_shared_file(int fd, size_t size) {
+#if defined(_WIN32)
+        (void)fd;
+        (void)size;
+        return false;
+#else
+        if (shared_file_size(fd) >= size) {
+            return true;
+        }
+        return ftruncate(fd, static_cast<off_t>(size)) == 0;
+#endif
+    }
+
+    size_t shared_file_size(int fd) {
+#if defined(_WIN32)
+        (void)fd;
+        return 0;
+#else
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < 0) {
+            return 0;
+        }
+        return static_cast<size_t>(st.st_size);
+#endif
+    }
+
+    void *map_shared_pages(int fd, void *base, size_t size) {
+#if defined(_WIN32)
+        (void)fd;
+        (void)base;
+        (void)size;
+        return nullptr;
+#else
+        int flags = MAP_SHARED | MAP_NORESERVE;
+#if defined(MAP_FIXED_NOREPLACE)
+        if (base) {
+            flags |= MAP_FIXED_NOREPLACE;
+        }
+#endif
+        void *ptr = mmap(base, size, PROT_READ | PROT_WRITE, flags, fd, 0);
+        if (ptr == MAP_FAILED) {
+            return nullptr;
+        }
+        // Without MAP_FIXED_NOREPLACE the address is only a hint
+        if (base && ptr != base) {
+            munmap(ptr, size);
+            return nullptr;
+        }
+        return ptr;
+#endif
+    }
+
+    bool discard_shared_pages(void *addr, size_t size) {
+#if defined(MADV_REMOVE)
+        return madvise(addr, size, MADV_REMOVE) == 0;
+#else
+        (void)addr;
+        (void)size;
+        return false;
+#endif
+    }
+
+    uint32_t monotonic_ms() {
+        using namespace std::chrono;
+        return static_cast<uint32_t>(
+            duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count());
+    }
+
+}
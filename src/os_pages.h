@@ -0,0 +1,93 @@
+#pragma once
+
+#include "cell/config.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Cell {
+
+    /**
+     * @brief Makes a reserved range readable and writable, applying the huge page policy.
+     *
+     * The range must lie inside an mmap/VirtualAlloc reservation owned by the caller:
+     * with HugePagePolicy::kExplicit it is replaced by a fresh MAP_FIXED mapping.
+     *
+     * @return true on success; on failure the range is left inaccessible.
+     */
+    bool commit_pages(void *addr, size_t size, HugePagePolicy policy);
+
+    /**
+     * @brief Returns a committed range's physical pages to the OS.
+     *
+     * Contents are lost. The range stays reserved and is brought back with
+     * commit_pages() using the same policy.
+     *
+     * @param lazy Use MADV_FREE where available: the kernel reclaims the pages only
+     *        under memory pressure, and reuse before that costs no page faults.
+     * @return true if the pages were released.
+     */
+    bool decommit_pages(void *addr, size_t size, HugePagePolicy policy, bool lazy = false);
+
+    /**
+     * @brief Faults in every page of a committed range now rather than on first touch.
+     *
+     * Uses MADV_POPULATE_WRITE (Linux 5.14+), else writes each page back its own
+     * first byte. The range must not be written concurrently by anyone else.
+     */
+    void populate_pages(void *addr, size_t size);
+
+    /**
+     * @brief Maps a fresh zeroed, readable and writable range of regular pages.
+     *
+     * For bookkeeping that must not come from a heap the Context may itself back.
+     *
+     * @return The range, or nullptr on failure.
+     */
+    void *map_pages(size_t size);
+
+    /**
+     * @brief Unmaps a range returned by map_pages() of the same size.
+     */
+    void unmap_pages(void *addr, size_t size);
+
+    /**
+     * @brief Extends a file to at least size bytes, sparsely, for a shared reservation.
+     * @return true if the file is now at least that long (always false on Windows).
+     */
+    bool reserve_shared_file(int fd, size_t size);
+
+    /**
+     * @brief Returns the length of a file, or 0 if it cannot be read.
+     */
+    size_t shared_file_size(int fd);
+
+    /**
+     * @brief Maps size bytes of a file MAP_SHARED, from offset 0.
+     *
+     * Readable and writable. With a base the mapping is made exactly there or not at
+     * all; an existing mapping is never replaced.
+     *
+     * @param base Address to map at, or nullptr to let the OS choose.
+     * @return The mapping, or nullptr on failure (always on Windows).
+     */
+    void *map_shared_pages(int fd, void *base, size_t size);
+
+    /**
+     * @brief Frees the file pages behind a range of a shared mapping.
+     *
+     * decommit_pages() would only drop this process's view of them. Afterwards the
+     * range reads as zeros, in every process that maps it, and is refilled on touch.
+     *
+     * @return true if the pages were released.
+     */
+    bool discard_shared_pages(void *addr, size_t size);
+
+    /**
+     * @brief Monotonic millisecond tick used to age free superblocks.
+     *
+     * Wraps after ~49 days; compare ticks by unsigned difference only.
+     */
+    uint32_t monotonic_ms();
+
+}
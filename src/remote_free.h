@@ -0,0 +1,68 @@
+#pragma once
+
+#include "cell/cell.h"
+#include "cell/config.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace Cell {
+
+    /**
+     * @brief Per-thread MPSC queues of sub-cell blocks freed by other threads.
+     *
+     * A thread that refills its TLS bin cache from a cell becomes that cell's owner.
+     * When another thread frees a block from the cell, it pushes the block here with a
+     * single CAS instead of caching it locally. The owner drains a whole bin's queue
+     * with one exchange on its next TLS miss, so cross-thread frees flow back to the
+     * thread that allocates that size without touching the global bin lock.
+     *
+     * Queues are owned by the Context and outlive the threads that use them, so the
+     * owner pointer stored in CellMetadata never dangles. That pointer, like the queue
+     * registry, only knows this policy-independent part; the heads, one per TLS-cached
+     * bin, are in BasicRemoteFreeQueue.
+     */
+    struct RemoteFreeQueue {
+        RemoteFreeQueue *next_registered = nullptr; ///< Context registry link.
+        bool in_use = false;                         ///< Claimed by a live thread.
+    };
+
+    /**
+     * @brief RemoteFreeQueue with the queue heads of a policy's TLS-cached bins.
+     */
+    template <typename Policy> struct BasicRemoteFreeQueue : RemoteFreeQueue {
+        /** @brief One queue head per TLS bin, padded to avoid false sharing. */
+        struct alignas(64) Head {
+            std::atomic<FreeBlock *> blocks{nullptr};
+        };
+
+        Head heads[PolicyTraits<Policy>::kTlsBinCacheCount];
+
+        /**
+         * @brief Pushes a block freed by a foreign thread (lock-free, any thread).
+         * @param key Free-list key of the Context owning the queue.
+         */
+        void push(size_t bin_index, FreeBlock *block, uintptr_t key) {
+            std::atomic<FreeBlock *> &head = heads[bin_index].blocks;
+            FreeBlock *old_head = head.load(std::memory_order_relaxed);
+            do {
+                block->set_next(old_head, key);
+            } while (!head.compare_exchange_weak(old_head, block, std::memory_order_release,
+                                                 std::memory_order_relaxed));
+        }
+
+        /**
+         * @brief Takes every queued block for a bin (owner thread only).
+         * @return Singly-linked list of blocks, or nullptr if the queue was empty.
+         */
+        [[nodiscard]] FreeBlock *take_all(size_t bin_index) {
+            std::atomic<FreeBlock *> &head = heads[bin_index].blocks;
+            if (!head.load(std::memory_order_relaxed)) {
+                return nullptr;
+            }
+            // Acquire pairs with the release CAS in push() so the block links are visible
+            return head.exchange(nullptr, std::memory_order_acquire);
+        }
+    };
+
+}
@@ -0,0 +1,38 @@
+#include "scavenger.h"
+
+#include "cell/config.h"
+
+#include <chrono>
+
+namespace Cell {
+
+    Scavenger::Scavenger(ScavengeFn step, void *context, uint32_t interval_ms)
+        : m_step(step), m_context(context), m_interval_ms(interval_ms > 0 ? interval_ms : 1),
+          m_thread(&Scavenger::run, this) {}
+
+    Scavenger::~Scavenger() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+    }
+
+    void Scavenger::run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_stop) {
+            m_wake.wait_for(lock, std::chrono::milliseconds(m_interval_ms),
+                            [this] { return m_stop; });
+            if (m_stop) {
+                break;
+            }
+
+            // Scavenge without the lock so shutdown never waits on more than one step
+            lock.unlock();
+            m_step(m_context, kBackgroundScavengeBudgetNs);
+            lock.lock();
+        }
+    }
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace Cell {
+
+    /**
+     * @brief One scavenge step of a Context: context->scavenge(budget_ns).
+     */
+    using ScavengeFn = size_t (*)(void *context, uint64_t budget_ns);
+
+    /**
+     * @brief Background thread that periodically calls Context::scavenge().
+     *
+     * Owned by the Context and destroyed before any of its allocators, so a step
+     * never runs against a half-torn-down Context.
+     */
+    class Scavenger {
+    public:
+        /**
+         * @brief Starts the thread.
+         * @param step Scavenge step, called with context.
+         * @param context Context to scavenge; must outlive the Scavenger.
+         * @param interval_ms Sleep between steps.
+         */
+        Scavenger(ScavengeFn step, void *context, uint32_t interval_ms);
+
+        /** @brief Wakes the thread and joins it. */
+        ~Scavenger();
+
+        Scavenger(const Scavenger &) = delete;
+        Scavenger &operator=(const Scavenger &) = delete;
+
+    private:
+        void run();
+
+        ScavengeFn m_step;
+        void *m_context;
+        uint32_t m_interval_ms;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        bool m_stop = false; ///< Protected by m_mutex.
+        std::thread m_thread;
+    };
+
+}
@@ -0,0 +1,515 @@
+#include "cell/shared_heap.h"
+
+#include "cell/sub_cell.h"
+#include "os_pages.h"
+
+#if !defined(_WIN32)
+
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#include <pthread.h>
+#include <unistd.h>
+
+namespace Cell {
+
+    namespace {
+        /** @brief Identifies a finished heap ("CELLHEAP"); written last by the creator. */
+        constexpr uint64_t kHeapMagic = 0x43454C4C48454150ull;
+
+        /** @brief Bumped whenever the layout of the mapping changes. */
+        constexpr uint32_t kHeapVersion = 1;
+
+        /** @brief Free cell runs are listed by floor(log2(cells)). */
+        constexpr size_t kSpanBuckets = 32;
+
+        /** @brief Largest run of cells, so that lengths fit a CellEntry. */
+        constexpr size_t kMaxCells = size_t{1} << 30;
+
+        constexpr uint32_t kNone = UINT32_MAX;
+
+        /** @brief What a cell entry describes; only the first and last cell of a run count. */
+        enum CellState : uint8_t {
+            kInterior = 0, ///< Inside a run: the entry is stale.
+            kFreeSpan,     ///< Boundary of a free run.
+            kSpan,         ///< Boundary of a run handed out whole.
+            kBinCell,      ///< One cell carved into blocks of a size class.
+        };
+
+        size_t bucket_of(size_t cells) {
+            size_t bucket = 0;
+            while (cells >>= 1) {
+                ++bucket;
+            }
+            return bucket < kSpanBuckets ? bucket : kSpanBuckets - 1;
+        }
+    }
+
+    /** @brief A mutex usable from every process that maps it. */
+    struct SharedMutex {
+        pthread_mutex_t mutex;
+    };
+
+    /**
+     * @brief Per-cell metadata, kept out of the cells so that blocks start at the cell.
+     */
+    struct CellEntry {
+        uint32_t cells;   ///< Run length (boundary cells).
+        uint8_t state;    ///< CellState.
+        uint8_t bin;      ///< Size class of a bin cell.
+        uint16_t live;    ///< Blocks of a bin cell handed out.
+        uint16_t bump;    ///< First block of a bin cell never handed out.
+        uint16_t unused;
+        uint32_t next;    ///< Next cell on a free-run or partial list, or kNone.
+        uint32_t prev;    ///< Previous cell on that list, or kNone.
+        void *free_list;  ///< Freed blocks of a bin cell, linked through their first bytes.
+    };
+    static_assert(sizeof(CellEntry) == 32, "Cell entries should stay compact");
+
+    /**
+     * @brief Start of the mapping: everything the processes of a heap share.
+     */
+    struct SharedHeapHeader {
+        /** @brief Read with pread() before attaching, to find where to map. */
+        struct Info {
+            std::atomic<uint64_t> magic; ///< kHeapMagic once the heap is ready.
+            uint32_t version;            ///< kHeapVersion.
+            uint32_t layout;             ///< Geometry check, see layout_id().
+            uint64_t base;               ///< Address the heap is mapped at.
+            uint64_t size;               ///< Bytes mapped.
+        } info;
+
+        uint64_t cells_offset; ///< First cell, from the base.
+        uint32_t cell_count;   ///< Cells after it.
+        std::atomic<uint32_t> broken{0};
+        std::atomic<uint64_t> allocated{0};
+
+        SharedMutex span_lock;             ///< Guards the free runs and cell boundaries.
+        uint32_t free_spans[kSpanBuckets]; ///< Free runs by bucket_of(cells).
+
+        /** @brief One size class: cells with free blocks and the lock over them. */
+        struct Bin {
+            SharedMutex lock;
+            uint32_t partial; ///< Cells with free blocks, or kNone.
+            uint32_t cells;   ///< Cells carved for this class.
+        } bins[kNumSizeBins];
+
+        CellEntry *entries() {
+            return reinterpret_cast<CellEntry *>(reinterpret_cast<char *>(this) +
+                                                 align_up_const(sizeof(SharedHeapHeader), 64));
+        }
+        char *cell(uint32_t index) {
+            return reinterpret_cast<char *>(this) + cells_offset + size_t{index} * kCellSize;
+        }
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                      std::atomic<uint32_t>::is_always_lock_free,
+                  "Shared counters must be address-free");
+
+    namespace {
+        /** @brief Ties a mapping to the geometry and lock type of this build. */
+        uint32_t layout_id() {
+            uint64_t h = 0xCBF29CE484222325ULL;
+            auto mix = [&h](uint64_t value) { h = (h ^ value) * 0x100000001B3ULL; };
+            mix(kCellSize);
+            mix(sizeof(SharedHeapHeader));
+            mix(sizeof(pthread_mutex_t));
+            for (size_t size : kSizeClasses) {
+                mix(size);
+            }
+            return static_cast<uint32_t>(h ^ (h >> 32));
+        }
+
+        bool init_mutex(SharedMutex &shared) {
+            pthread_mutexattr_t attr;
+            if (pthread_mutexattr_init(&attr) != 0) {
+                return false;
+            }
+            bool ok = pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED) == 0;
+#if defined(__linux__)
+            ok = ok && pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST) == 0;
+#endif
+            ok = ok && pthread_mutex_init(&shared.mutex, &attr) == 0;
+            pthread_mutexattr_destroy(&attr);
+            return ok;
+        }
+
+        /**
+         * @brief Holds a heap lock; ok() is false if the heap is (or just became) broken.
+         */
+        class SharedLock {
+        public:
+            SharedLock(SharedHeapHeader &header, SharedMutex &shared) : m_mutex(shared.mutex) {
+                int rc = pthread_mutex_lock(&m_mutex);
+#if defined(__linux__)
+                if (rc == EOWNERDEAD) {
+                    // The holder died mid-update: keep the lock usable, stop trusting the heap
+                    header.broken.store(1, std::memory_order_relaxed);
+                    pthread_mutex_consistent(&m_mutex);
+                    rc = 0;
+                }
+#endif
+                m_locked = rc == 0;
+                m_ok = m_locked && header.broken.load(std::memory_order_relaxed) == 0;
+            }
+            ~SharedLock() {
+                if (m_locked) {
+                    pthread_mutex_unlock(&m_mutex);
+                }
+            }
+            SharedLock(const SharedLock &) = delete;
+            SharedLock &operator=(const SharedLock &) = delete;
+
+            bool ok() const { return m_ok; }
+
+        private:
+            pthread_mutex_t &m_mutex;
+            bool m_locked;
+            bool m_ok;
+        };
+
+        // Lists threaded through CellEntry::next/prev, headed by an index
+
+        void list_push(CellEntry *entries, uint32_t &head, uint32_t index) {
+            entries[index].prev = kNone;
+            entries[index].next = head;
+            if (head != kNone) {
+                entries[head].prev = index;
+            }
+            head = index;
+        }
+
+        void list_remove(CellEntry *entries, uint32_t &head, uint32_t index) {
+            CellEntry &entry = entries[index];
+            if (entry.prev != kNone) {
+                entries[entry.prev].next = entry.next;
+            } else {
+                head = entry.next;
+            }
+            if (entry.next != kNone) {
+                entries[entry.next].prev = entry.prev;
+            }
+            entry.next = entry.prev = kNone;
+        }
+
+        /** @brief Writes both boundary entries of a run. */
+        void mark_span(CellEntry *entries, uint32_t start, uint32_t cells, uint8_t state) {
+            entries[start].cells = cells;
+            entries[start].state = state;
+            entries[start + cells - 1].cells = cells;
+            entries[start + cells - 1].state = state;
+        }
+
+        /** @brief Lists a free run; the span lock must be held. */
+        void insert_free_span(SharedHeapHeader &header, uint32_t start, uint32_t cells) {
+            CellEntry *entries = header.entries();
+            mark_span(entries, start, cells, kFreeSpan);
+            list_push(entries, header.free_spans[bucket_of(cells)], start);
+        }
+
+        /**
+         * @brief Takes a run of cells, splitting a larger free one; kNone if none fits.
+         *
+         * @param state kSpan or kBinCell, set under the lock that neighbours read it under.
+         */
+        uint32_t take_span(SharedHeapHeader &header, uint32_t cells, uint8_t state) {
+            SharedLock lock(header, header.span_lock);
+            if (!lock.ok()) {
+                return kNone;
+            }
+            CellEntry *entries = header.entries();
+            uint32_t found = kNone;
+            size_t bucket = bucket_of(cells);
+            // The first bucket mixes shorter runs in; any run from the later ones fits
+            for (uint32_t i = header.free_spans[bucket]; i != kNone; i = entries[i].next) {
+                if (entries[i].cells >= cells) {
+                    found = i;
+                    break;
+                }
+            }
+            while (found == kNone && ++bucket < kSpanBuckets) {
+                found = header.free_spans[bucket];
+            }
+            if (found == kNone) {
+                return kNone;
+            }
+
+            uint32_t available = entries[found].cells;
+            list_remove(entries, header.free_spans[bucket_of(available)], found);
+            if (available > cells) {
+                insert_free_span(header, found + cells, available - cells);
+            }
+            mark_span(entries, found, cells, state);
+            return found;
+        }
+
+        /** @brief Returns a run, merging it with free neighbours and punching its pages out. */
+        void release_span(SharedHeapHeader &header, uint32_t start, uint32_t cells) {
+            // Still ours until listed: drop the file pages outside the lock
+            discard_shared_pages(header.cell(start), size_t{cells} * kCellSize);
+
+            SharedLock lock(header, header.span_lock);
+            if (!lock.ok()) {
+                return;
+            }
+            CellEntry *entries = header.entries();
+            uint32_t end = start + cells;
+            if (end < header.cell_count && entries[end].state == kFreeSpan) {
+                uint32_t next_cells = entries[end].cells;
+                list_remove(entries, header.free_spans[bucket_of(next_cells)], end);
+                entries[end].state = kInterior;
+                cells += next_cells;
+            }
+            if (start > 0 && entries[start - 1].state == kFreeSpan) {
+                uint32_t prev_cells = entries[start - 1].cells;
+                uint32_t prev = start - prev_cells;
+                list_remove(entries, header.free_spans[bucket_of(prev_cells)], prev);
+                entries[start - 1].state = kInterior;
+                entries[start].state = kInterior;
+                start = prev;
+                cells += prev_cells;
+            }
+            insert_free_span(header, start, cells);
+        }
+    }
+
+    // =========================================================================
+    // Construction / Destruction
+    // =========================================================================
+
+    SharedHeap::SharedHeap(const SharedHeapConfig &config) {
+        size_t cell_count = (config.capacity + kCellSize - 1) / kCellSize;
+        if (config.fd < 0 || cell_count == 0 || cell_count >= kMaxCells ||
+            shared_file_size(config.fd) != 0) {
+            return;
+        }
+        size_t entries_offset = align_up_const(sizeof(SharedHeapHeader), 64);
+        size_t cells_offset =
+            align_up_const(entries_offset + cell_count * sizeof(CellEntry), kCellSize);
+        size_t size = cells_offset + cell_count * kCellSize;
+        if (!reserve_shared_file(config.fd, size)) {
+            return;
+        }
+        void *base = map_shared_pages(config.fd, config.base, size);
+        if (!base) {
+            return;
+        }
+
+        // The file reads as zeros: entries start out kInterior with no lists
+        auto *header = new (base) SharedHeapHeader;
+        header->info.version = kHeapVersion;
+        header->info.layout = layout_id();
+        header->info.base = reinterpret_cast<uintptr_t>(base);
+        header->info.size = size;
+        header->cells_offset = cells_offset;
+        header->cell_count = static_cast<uint32_t>(cell_count);
+        bool ok = init_mutex(header->span_lock);
+        for (uint32_t &head : header->free_spans) {
+            head = kNone;
+        }
+        for (SharedHeapHeader::Bin &bin : header->bins) {
+            ok = ok && init_mutex(bin.lock);
+            bin.partial = kNone;
+        }
+        if (!ok) {
+            unmap_pages(base, size);
+            return;
+        }
+        insert_free_span(*header, 0, header->cell_count);
+        header->info.magic.store(kHeapMagic, std::memory_order_release);
+
+        m_header = header;
+        m_size = size;
+    }
+
+    SharedHeap::SharedHeap(int fd) {
+        SharedHeapHeader::Info info;
+        size_t file_size = shared_file_size(fd);
+        if (file_size < sizeof(SharedHeapHeader) ||
+            pread(fd, &info, sizeof(info), 0) != static_cast<ssize_t>(sizeof(info))) {
+            return;
+        }
+        if (info.magic.load(std::memory_order_relaxed) != kHeapMagic ||
+            info.version != kHeapVersion || info.layout != layout_id() || info.base == 0 ||
+            info.size > file_size) {
+            return;
+        }
+        // Pointers are only valid at the creator's address, so map there or not at all
+        void *base = reinterpret_cast<void *>(static_cast<uintptr_t>(info.base));
+        size_t size = static_cast<size_t>(info.size);
+        if (!map_shared_pages(fd, base, size)) {
+            return;
+        }
+        m_header = static_cast<SharedHeapHeader *>(base);
+        m_size = size;
+    }
+
+    SharedHeap::~SharedHeap() {
+        if (m_header) {
+            unmap_pages(m_header, m_size);
+        }
+    }
+
+    // =========================================================================
+    // Allocation
+    // =========================================================================
+
+    void *SharedHeap::alloc_bytes(size_t size) {
+        if (!m_header) {
+            return nullptr;
+        }
+        SharedHeapHeader &header = *m_header;
+        CellEntry *entries = header.entries();
+
+        if (size > kMaxSubCellSize) {
+            size_t cells = size / kCellSize + (size % kCellSize != 0);
+            if (cells >= header.cell_count + size_t{1}) {
+                return nullptr;
+            }
+            uint32_t start = take_span(header, static_cast<uint32_t>(cells), kSpan);
+            if (start == kNone) {
+                return nullptr;
+            }
+            header.allocated.fetch_add(cells * kCellSize, std::memory_order_relaxed);
+            return header.cell(start);
+        }
+
+        uint8_t bin_index = get_size_class<DefaultPolicy>(size == 0 ? 1 : size, 16);
+        size_t class_size = kSizeClasses[bin_index];
+        auto capacity = static_cast<uint16_t>(kCellSize / class_size);
+        SharedHeapHeader::Bin &bin = header.bins[bin_index];
+
+        SharedLock lock(header, bin.lock);
+        if (!lock.ok()) {
+            return nullptr;
+        }
+        uint32_t index = bin.partial;
+        if (index == kNone) {
+            index = take_span(header, 1, kBinCell);
+            if (index == kNone) {
+                return nullptr;
+            }
+            CellEntry &fresh = entries[index];
+            fresh.bin = bin_index;
+            fresh.live = 0;
+            fresh.bump = 0;
+            fresh.free_list = nullptr;
+            list_push(entries, bin.partial, index);
+            ++bin.cells;
+        }
+
+        CellEntry &entry = entries[index];
+        void *block = entry.free_list;
+        if (block) {
+            std::memcpy(&entry.free_list, block, sizeof(void *));
+        } else {
+            block = header.cell(index) + size_t{entry.bump++} * class_size;
+        }
+        if (++entry.live == capacity) {
+            list_remove(entries, bin.partial, index);
+        }
+        header.allocated.fetch_add(class_size, std::memory_order_relaxed);
+        return block;
+    }
+
+    void SharedHeap::free_bytes(void *ptr) {
+        if (!ptr || !m_header) {
+            return;
+        }
+        SharedHeapHeader &header = *m_header;
+        CellEntry *entries = header.entries();
+        assert(contains(ptr) && "SharedHeap::free_bytes: pointer is not in the heap");
+        auto offset = static_cast<size_t>(static_cast<char *>(ptr) - header.cell(0));
+        auto index = static_cast<uint32_t>(offset / kCellSize);
+        CellEntry &entry = entries[index];
+
+        if (entry.state == kSpan) {
+            assert(offset % kCellSize == 0 && "SharedHeap::free_bytes: not a block start");
+            uint32_t cells = entry.cells;
+            header.allocated.fetch_sub(size_t{cells} * kCellSize, std::memory_order_relaxed);
+            release_span(header, index, cells);
+            return;
+        }
+        assert(entry.state == kBinCell && "SharedHeap::free_bytes: pointer is not allocated");
+
+        size_t class_size = kSizeClasses[entry.bin];
+        auto capacity = static_cast<uint16_t>(kCellSize / class_size);
+        SharedHeapHeader::Bin &bin = header.bins[entry.bin];
+        bool release = false;
+        {
+            SharedLock lock(header, bin.lock);
+            if (!lock.ok()) {
+                return;
+            }
+            std::memcpy(ptr, &entry.free_list, sizeof(void *));
+            entry.free_list = ptr;
+            if (entry.live-- == capacity) {
+                list_push(entries, bin.partial, index);
+            }
+            // Keep a class's last cell even when empty; hand the others back to the runs
+            if (entry.live == 0 && bin.cells > 1) {
+                list_remove(entries, bin.partial, index);
+                --bin.cells;
+                release = true;
+            }
+            header.allocated.fetch_sub(class_size, std::memory_order_relaxed);
+        }
+        if (release) {
+            release_span(header, index, 1);
+        }
+    }
+
+    size_t SharedHeap::usable_size(const void *ptr) const {
+        if (!ptr || !contains(ptr)) {
+            return 0;
+        }
+        auto offset = static_cast<size_t>(static_cast<const char *>(ptr) - m_header->cell(0));
+        const CellEntry &entry = m_header->entries()[offset / kCellSize];
+        if (entry.state == kSpan) {
+            return size_t{entry.cells} * kCellSize;
+        }
+        return entry.state == kBinCell ? kSizeClasses[entry.bin] : 0;
+    }
+
+    // =========================================================================
+    // Introspection
+    // =========================================================================
+
+    size_t SharedHeap::capacity() const {
+        return m_header ? size_t{m_header->cell_count} * kCellSize : 0;
+    }
+
+    size_t SharedHeap::allocated_bytes() const {
+        return m_header ? m_header->allocated.load(std::memory_order_relaxed) : 0;
+    }
+
+    bool SharedHeap::broken() const {
+        return m_header && m_header->broken.load(std::memory_order_relaxed) != 0;
+    }
+
+}
+
+#else
+
+namespace Cell {
+
+    // No MAP_SHARED file mappings or process-shared mutexes: a heap never maps
+    struct SharedHeapHeader {};
+
+    SharedHeap::SharedHeap(const SharedHeapConfig &) {}
+    SharedHeap::SharedHeap(int) {}
+    SharedHeap::~SharedHeap() {}
+    void *SharedHeap::alloc_bytes(size_t) { return nullptr; }
+    void SharedHeap::free_bytes(void *) {}
+    size_t SharedHeap::usable_size(const void *) const { return 0; }
+    size_t SharedHeap::capacity() const { return 0; }
+    size_t SharedHeap::allocated_bytes() const { return 0; }
+    bool SharedHeap::broken() const { return false; }
+
+}
+
+#endif
@@ -0,0 +1,293 @@
+#include "cell/snapshot.h"
+
+#include <cstdio>
+
+namespace Cell {
+
+    namespace {
+
+        /** @brief Names of SuperblockState values, in enum order. */
+        constexpr const char *kSuperblockStateNames[kSuperblockStateCount] = {
+            "uncommitted", "in_use", "free", "decommitted"};
+
+        /** @brief Block size of a buddy order index. */
+        size_t buddy_block_size(size_t index) {
+            return size_t{1} << (BuddyAllocator::kMinOrder + index);
+        }
+
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+        /** @brief Names of LatencyPath values, in enum order. */
+        constexpr const char *kLatencyPathNames[kLatencyPathCount] = {
+            "tls_refill", "bin_lock", "cell_from_os", "buddy", "large"};
+#endif
+
+        /** @brief Lower bound of a free_histogram bucket as a fraction, e.g. "0.375". */
+        std::string bucket_floor(size_t bucket) {
+            char text[16];
+            std::snprintf(text, sizeof(text), "%.3f",
+                          static_cast<double>(bucket) / kSnapshotFreeBuckets);
+            return text;
+        }
+
+        // =====================================================================
+        // JSON
+        // =====================================================================
+
+        void json_field(std::string &out, const char *name, size_t value, bool last = false) {
+            out += '"';
+            out += name;
+            out += "\":";
+            out += std::to_string(value);
+            if (!last) {
+                out += ',';
+            }
+        }
+
+        template <typename Values> void json_array(std::string &out, const Values &values) {
+            out += '[';
+            for (size_t i = 0; i < values.size(); ++i) {
+                if (i > 0) {
+                    out += ',';
+                }
+                out += std::to_string(values[i]);
+            }
+            out += ']';
+        }
+
+        // =====================================================================
+        // Prometheus
+        // =====================================================================
+
+        /**
+         * @brief Writes one metric family's HELP and TYPE lines.
+         */
+        void prom_header(std::string &out, const char *prefix, const char *name,
+                         const char *help, const char *type = "gauge") {
+            out += "# HELP ";
+            out += prefix;
+            out += '_';
+            out += name;
+            out += ' ';
+            out += help;
+            out += "\n# TYPE ";
+            out += prefix;
+            out += '_';
+            out += name;
+            out += ' ';
+            out += type;
+            out += '\n';
+        }
+
+        /**
+         * @brief Writes one sample; labels is the text between the braces, or empty.
+         */
+        void prom_sample(std::string &out, const char *prefix, const char *name,
+                         const std::string &labels, size_t value) {
+            out += prefix;
+            out += '_';
+            out += name;
+            if (!labels.empty()) {
+                out += '{';
+                out += labels;
+                out += '}';
+            }
+            out += ' ';
+            out += std::to_string(value);
+            out += '\n';
+        }
+
+        void prom_gauge(std::string &out, const char *prefix, const char *name,
+                        const char *help, size_t value) {
+            prom_header(out, prefix, name, help);
+            prom_sample(out, prefix, name, std::string(), value);
+        }
+
+        std::string size_label(size_t size) { return "size=\"" + std::to_string(size) + "\""; }
+
+        /**
+         * @brief Writes a per-bin family from one BinSnapshot field.
+         */
+        void prom_bins(std::string &out, const char *prefix, const HeapSnapshot &snapshot,
+                       const char *name, const char *help, size_t BinSnapshot::*field) {
+            prom_header(out, prefix, name, help);
+            for (const BinSnapshot &bin : snapshot.bins) {
+                prom_sample(out, prefix, name, size_label(bin.block_size), bin.*field);
+            }
+        }
+
+    }
+
+    std::string HeapSnapshot::to_json() const {
+        std::string out;
+        out.reserve(8192);
+
+        out += "{\"bins\":[";
+        for (size_t i = 0; i < bins.size(); ++i) {
+            const BinSnapshot &bin = bins[i];
+            out += i > 0 ? ",{" : "{";
+            json_field(out, "block_size", bin.block_size);
+            json_field(out, "blocks_per_cell", bin.blocks_per_cell);
+            json_field(out, "partial_cells", bin.partial_cells);
+            json_field(out, "warm_cells", bin.warm_cells);
+            json_field(out, "free_blocks", bin.free_blocks);
+            json_field(out, "allocated_blocks", bin.allocated_blocks);
+            json_field(out, "tls_cached_blocks", bin.tls_cached_blocks);
+            out += "\"free_histogram\":";
+            json_array(out, bin.free_histogram);
+            out += '}';
+        }
+
+        out += "],\"superblocks\":{";
+        for (size_t i = 0; i < kSuperblockStateCount; ++i) {
+            json_field(out, kSuperblockStateNames[i], superblocks[i],
+                       i + 1 == kSuperblockStateCount);
+        }
+        out += "},";
+        json_field(out, "cell_committed_bytes", cell_committed_bytes);
+        json_field(out, "tls_cached_cells", tls_cached_cells);
+
+        out += "\"buddy\":{\"free_blocks\":[";
+        for (size_t i = 0; i < BuddyAllocator::kNumOrders; ++i) {
+            out += i > 0 ? ",{" : "{";
+            json_field(out, "block_size", buddy_block_size(i));
+            json_field(out, "count", buddy_free_blocks[i], true);
+            out += '}';
+        }
+        out += "],\"tls_cached_blocks\":";
+        json_array(out, buddy_tls_cached_blocks);
+        out += ',';
+        json_field(out, "allocated_bytes", buddy_allocated_bytes);
+        json_field(out, "committed_bytes", buddy_committed_bytes, true);
+
+        out += "},\"large\":{";
+        json_field(out, "allocations", large_allocations);
+        json_field(out, "allocated_bytes", large_allocated_bytes);
+        json_field(out, "committed_bytes", large_committed_bytes);
+        json_field(out, "cached_bytes", large_cached_bytes, true);
+        out += '}';
+
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+        // Per path a summary, then [bucket floor ns, samples] for the non-empty buckets
+        out += ",\"latency\":{";
+        for (size_t i = 0; i < kLatencyPathCount; ++i) {
+            const LatencyHistogram &histogram = latency[i];
+            out += i > 0 ? ",\"" : "\"";
+            out += kLatencyPathNames[i];
+            out += "\":{";
+            json_field(out, "count", histogram.count);
+            json_field(out, "total_ns", histogram.total_ns);
+            json_field(out, "max_ns", histogram.max_ns);
+            json_field(out, "p50_ns", histogram.percentile_ns(0.5));
+            json_field(out, "p99_ns", histogram.percentile_ns(0.99));
+            json_field(out, "p999_ns", histogram.percentile_ns(0.999));
+            out += "\"buckets\":[";
+            bool first = true;
+            for (size_t bucket = 0; bucket < kLatencyBuckets; ++bucket) {
+                if (histogram.buckets[bucket] == 0) {
+                    continue;
+                }
+                out += first ? "[" : ",[";
+                out += std::to_string(latency_bucket_floor(bucket));
+                out += ',';
+                out += std::to_string(histogram.buckets[bucket]);
+                out += ']';
+                first = false;
+            }
+            out += "]}";
+        }
+        out += '}';
+#endif
+        out += '}';
+        return out;
+    }
+
+    std::string HeapSnapshot::to_prometheus(const char *prefix) const {
+        std::string out;
+        out.reserve(16384);
+
+        prom_bins(out, prefix, *this, "bin_partial_cells",
+                  "Cells on the partial list of each size class.", &BinSnapshot::partial_cells);
+        prom_bins(out, prefix, *this, "bin_warm_cells", "Wholly free cells kept per size class.",
+                  &BinSnapshot::warm_cells);
+        prom_bins(out, prefix, *this, "bin_free_blocks", "Free blocks in partial cells.",
+                  &BinSnapshot::free_blocks);
+        prom_bins(out, prefix, *this, "bin_allocated_blocks",
+                  "Blocks handed out by each size class, thread caches included.",
+                  &BinSnapshot::allocated_blocks);
+        prom_bins(out, prefix, *this, "bin_tls_cached_blocks",
+                  "Blocks in thread caches of each size class.",
+                  &BinSnapshot::tls_cached_blocks);
+
+        prom_header(out, prefix, "bin_cells_by_free_fraction",
+                    "Partial cells whose free fraction is at least free_ge (and below the next "
+                    "bucket).");
+        for (const BinSnapshot &bin : bins) {
+            for (size_t bucket = 0; bucket < kSnapshotFreeBuckets; ++bucket) {
+                prom_sample(out, prefix, "bin_cells_by_free_fraction",
+                            size_label(bin.block_size) + ",free_ge=\"" + bucket_floor(bucket) +
+                                "\"",
+                            bin.free_histogram[bucket]);
+            }
+        }
+
+        prom_header(out, prefix, "superblocks", "Cell superblocks by state.");
+        for (size_t i = 0; i < kSuperblockStateCount; ++i) {
+            prom_sample(out, prefix, "superblocks",
+                        std::string("state=\"") + kSuperblockStateNames[i] + "\"",
+                        superblocks[i]);
+        }
+        prom_gauge(out, prefix, "cell_committed_bytes", "Committed bytes of cell superblocks.",
+                   cell_committed_bytes);
+        prom_gauge(out, prefix, "tls_cached_cells", "Cells in thread cell caches.",
+                   tls_cached_cells);
+
+        prom_header(out, prefix, "buddy_free_blocks", "Blocks on each buddy free list.");
+        for (size_t i = 0; i < BuddyAllocator::kNumOrders; ++i) {
+            prom_sample(out, prefix, "buddy_free_blocks", size_label(buddy_block_size(i)),
+                        buddy_free_blocks[i]);
+        }
+        prom_header(out, prefix, "buddy_tls_cached_blocks",
+                    "Buddy blocks in thread caches.");
+        for (size_t i = 0; i < buddy_tls_cached_blocks.size(); ++i) {
+            prom_sample(out, prefix, "buddy_tls_cached_blocks", size_label(buddy_block_size(i)),
+                        buddy_tls_cached_blocks[i]);
+        }
+        prom_gauge(out, prefix, "buddy_allocated_bytes", "Bytes allocated from the buddy tier.",
+                   buddy_allocated_bytes);
+        prom_gauge(out, prefix, "buddy_committed_bytes", "Committed bytes of the buddy tier.",
+                   buddy_committed_bytes);
+
+        prom_gauge(out, prefix, "large_allocations", "Live large allocations.", large_allocations);
+        prom_gauge(out, prefix, "large_allocated_bytes", "Bytes of live large allocations.",
+                   large_allocated_bytes);
+        prom_gauge(out, prefix, "large_committed_bytes",
+                   "Committed bytes of large mappings, reuse cache included.",
+                   large_committed_bytes);
+        prom_gauge(out, prefix, "large_cached_bytes", "Bytes of freed mappings held for reuse.",
+                   large_cached_bytes);
+
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+        // Cumulative buckets at every power of two; each counts the samples below it
+        prom_header(out, prefix, "latency_ns", "Allocator slow path latency in nanoseconds.",
+                    "histogram");
+        for (size_t i = 0; i < kLatencyPathCount; ++i) {
+            const LatencyHistogram &histogram = latency[i];
+            std::string path = std::string("path=\"") + kLatencyPathNames[i] + "\"";
+            uint64_t below = 0;
+            for (size_t bucket = 0; bucket < kLatencyBuckets; ++bucket) {
+                uint64_t floor = latency_bucket_floor(bucket);
+                if (bucket >= (size_t{1} << kLatencySubBucketBits) && (floor & (floor - 1)) == 0) {
+                    prom_sample(out, prefix, "latency_ns_bucket",
+                                path + ",le=\"" + std::to_string(floor) + "\"", below);
+                }
+                below += histogram.buckets[bucket];
+            }
+            prom_sample(out, prefix, "latency_ns_bucket", path + ",le=\"+Inf\"", histogram.count);
+            prom_sample(out, prefix, "latency_ns_sum", path, histogram.total_ns);
+            prom_sample(out, prefix, "latency_ns_count", path, histogram.count);
+        }
+#endif
+        return out;
+    }
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "cell/cell.h"
+#include "cell/config.h"
+#include "cell/sub_cell.h"
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace Cell {
+
+    /**
+     * @brief CellMetadata::owner of every tag heap cell, full cells included.
+     *
+     * Not a real queue. It only has to differ from every thread's own, so that the
+     * free of a tag heap block leaves free_to_tls() by its foreign-owner branch and the
+     * fast path needs no test of its own.
+     */
+    inline RemoteFreeQueue *const kTagHeapOwner =
+        reinterpret_cast<RemoteFreeQueue *>(uintptr_t{64});
+
+    /** @brief Checks whether a cell belongs to a TagHeap. */
+    inline bool in_tag_heap(CellHeader *header) {
+        return get_metadata(header)->owner.load(std::memory_order_relaxed) == kTagHeapOwner;
+    }
+
+    /**
+     * @brief Size bins and cells dedicated to one tag of Config::tag_heaps.
+     *
+     * A tag heap's cells never reach the shared bins, a thread's cache or a remote
+     * queue: every block is taken and returned under the heap's lock, so the heap
+     * alone knows where its blocks are. Every cell it holds, partial, full or warm,
+     * and full cells handed out whole, is listed in cells (each cell records its
+     * index in CellMetadata::heap_slot), which lets Context::release_tag() return
+     * them all without looking at a single block.
+     */
+    template <typename Policy> struct TagHeap {
+        explicit TagHeap(uint8_t heap_tag) : tag(heap_tag) {}
+
+        const uint8_t tag;
+        std::mutex lock;
+        SizeBin bins[PolicyTraits<Policy>::kNumSizeBins];
+        std::vector<CellHeader *> cells; ///< Every cell of the heap, in no particular order.
+
+        /** @brief Lists a cell taken for the heap. Caller holds lock. */
+        void add_cell(CellHeader *header) {
+            CellMetadata *metadata = get_metadata(header);
+            metadata->owner.store(kTagHeapOwner, std::memory_order_relaxed);
+            metadata->heap_slot = static_cast<uint32_t>(cells.size());
+            cells.push_back(header);
+        }
+
+        /** @brief Unlists a cell about to leave the heap. Caller holds lock. */
+        void remove_cell(CellHeader *header) {
+            uint32_t slot = get_metadata(header)->heap_slot;
+            CellHeader *last = cells.back();
+            cells[slot] = last;
+            get_metadata(last)->heap_slot = slot;
+            cells.pop_back();
+            get_metadata(header)->owner.store(nullptr, std::memory_order_relaxed);
+        }
+    };
+
+}
@@ -2,31 +2,52 @@
 
 #include "cell/cell.h"
 #include "cell/config.h"
+#include "tls_cache_count.h"
 
 namespace Cell {
 
     /**
-     * @brief Per-thread cache for sub-cell blocks (bins 0-3 only).
+     * @brief Per-thread cache for sub-cell blocks.
      *
      * Fixed-size array, no locking required.
-     * Stores FreeBlock pointers for fast alloc/free on hot sizes.
+     * Stores FreeBlock pointers for fast alloc/free on hot sizes. Each TlsSlot holds
+     * one per TLS-cached bin (index 0 = 16B, index 1 = 32B, etc.).
+     *
+     * Only the first capacity entries are used. Capacity doubles on a miss (refills
+     * move capacity / 2 blocks) and halves after kTlsBinShrinkOverflows overflows
+     * with no miss in between, so bins a thread mostly frees into stop stranding memory.
+     *
+     * The thread also owns one cell of the bin outright: the cell is on no partial
+     * list and is marked exclusive, so refills take blocks from its free list, and
+     * spills put them back, without the bin lock.
      */
-    struct TlsBinCache {
-        FreeBlock *blocks[kTlsBinCacheCapacity] = {};
-        size_t count = 0;
+    template <typename Policy> struct TlsBinCache {
+        FreeBlock *blocks[PolicyTraits<Policy>::kTlsBinCacheCapacity] = {};
+        TlsCacheCount count; ///< Entries in use; other threads may read it.
+        uint32_t capacity = kTlsBinCacheMinCapacity; ///< Current adaptive limit on count.
+        uint32_t overflows = 0;                      ///< Overflows since the last miss.
+        CellHeader *owned = nullptr; ///< Cell this thread refills from (exclusive), if any.
 
         [[nodiscard]] bool is_empty() const { return count == 0; }
-        [[nodiscard]] bool is_full() const { return count >= kTlsBinCacheCapacity; }
+        [[nodiscard]] bool is_full() const { return count >= capacity; }
 
         void push(FreeBlock *b) { blocks[count++] = b; }
         [[nodiscard]] FreeBlock *pop() { return blocks[--count]; }
     };
 
     /**
-     * @brief Thread-local bin caches for sizes 16B, 32B, 64B, 128B.
-     *
-     * Index 0 = bin 0 (16B), index 1 = bin 1 (32B), etc.
+     * @brief Capacity a bin's cache starts at: kTlsBinCacheInitialBytes worth of blocks.
      */
-    inline thread_local TlsBinCache t_bin_cache[kTlsBinCacheCount];
+    template <typename Policy>
+    inline constexpr uint32_t initial_tls_bin_capacity(size_t bin_index) {
+        using Traits = PolicyTraits<Policy>;
+        size_t capacity = kTlsBinCacheInitialBytes / Traits::kSizeClasses[bin_index];
+        if (capacity < kTlsBinCacheMinCapacity) {
+            capacity = kTlsBinCacheMinCapacity;
+        } else if (capacity > Traits::kTlsBinCacheCapacity) {
+            capacity = Traits::kTlsBinCacheCapacity;
+        }
+        return static_cast<uint32_t>(capacity);
+    }
 
 }
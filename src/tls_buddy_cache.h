@@ -0,0 +1,29 @@
+#pragma once
+
+#include "cell/config.h"
+#include "tls_cache_count.h"
+
+#include <cstddef>
+
+namespace Cell {
+
+    /**
+     * @brief Per-thread cache of free buddy blocks for one order.
+     *
+     * Fixed-size array, no locking required. Blocks parked here still count as
+     * allocated in the BuddyAllocator, so they never coalesce while cached.
+     */
+    template <typename Policy> struct TlsBuddyCache {
+        static constexpr size_t kCapacity = PolicyTraits<Policy>::kTlsBuddyCacheCapacity;
+
+        void *blocks[kCapacity] = {};
+        TlsCacheCount count; ///< Entries in use; other threads may read it.
+
+        [[nodiscard]] bool is_empty() const { return count == 0; }
+        [[nodiscard]] bool is_full() const { return count >= kCapacity; }
+
+        void push(void *b) { blocks[count++] = b; }
+        [[nodiscard]] void *pop() { return blocks[--count]; }
+    };
+
+}
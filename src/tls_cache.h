@@ -2,26 +2,26 @@
 
 #include "cell/allocator.h"
 #include "cell/config.h"
+#include "tls_cache_count.h"
 
 namespace Cell {
 
     /**
      * @brief Per-thread cell cache.
      *
-     * Fixed-size array, no locking required.
+     * Fixed-size array, no locking required. One instance lives in each TlsSlot.
      */
-    struct TlsCache {
-        FreeCell *cells[kTlsCacheCapacity] = {};
-        size_t count = 0;
+    template <typename Policy> struct TlsCache {
+        static constexpr size_t kCapacity = PolicyTraits<Policy>::kTlsCacheCapacity;
+
+        FreeCell *cells[kCapacity] = {};
+        TlsCacheCount count; ///< Entries in use; other threads may read it.
 
         [[nodiscard]] bool is_empty() const { return count == 0; }
-        [[nodiscard]] bool is_full() const { return count >= kTlsCacheCapacity; }
+        [[nodiscard]] bool is_full() const { return count >= kCapacity; }
 
         void push(FreeCell *c) { cells[count++] = c; }
         [[nodiscard]] FreeCell *pop() { return cells[--count]; }
     };
 
-    /** @brief Thread-local cache instance. */
-    inline thread_local TlsCache t_cache;
-
 }
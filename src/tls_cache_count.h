@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace Cell {
+
+    /**
+     * @brief Entry count of a thread-local cache, readable from other threads.
+     *
+     * Only the owning thread (or a thread reclaiming the slot) changes it, so updates
+     * are a relaxed load and store rather than read-modify-writes and compile to the
+     * same moves as a plain size_t. Context::snapshot() reads it from other threads
+     * as an approximation of how much each cache holds.
+     */
+    struct TlsCacheCount {
+        std::atomic<size_t> value{0};
+
+        operator size_t() const { return value.load(std::memory_order_relaxed); }
+
+        TlsCacheCount &operator=(size_t count) {
+            value.store(count, std::memory_order_relaxed);
+            return *this;
+        }
+        TlsCacheCount &operator-=(size_t n) { return *this = size_t{*this} - n; }
+
+        size_t operator++(int) {
+            size_t count = *this;
+            *this = count + 1;
+            return count;
+        }
+        size_t operator--() {
+            size_t count = size_t{*this} - 1;
+            *this = count;
+            return count;
+        }
+    };
+
+}
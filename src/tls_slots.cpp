@@ -0,0 +1,412 @@
+#include "tls_slots.h"
+
+#include "os_pages.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Cell {
+
+    namespace {
+
+        std::mutex s_slot_mutex;
+        bool s_slot_in_use[kMaxTlsContexts] = {};
+
+        /**
+         * @brief The Context holding a slot index, and every thread's slot bound to it.
+         *
+         * The mutex is a leaf: nothing else is locked while holding it, so binding may
+         * happen under a Context's bin locks.
+         */
+        struct TlsOwnerRegistry {
+            std::mutex mutex;
+            std::condition_variable released; ///< Signalled when releasing drops to zero.
+            uint64_t owner = 0;               ///< Registered Context id, 0 if none.
+            TlsSlotReleaseFn release = nullptr;
+            TlsSlotRetireFn retire = nullptr;
+            void *context = nullptr;
+            TlsSlot *slots = nullptr; ///< Head of the bound slot list.
+            size_t releasing = 0;     ///< Exiting threads still releasing into the Context.
+        };
+
+        TlsOwnerRegistry s_registries[kMaxTlsContexts];
+
+        /** @brief Links a slot into its registry. Caller holds the registry mutex. */
+        void link_slot(TlsOwnerRegistry &registry, TlsSlot *slot) {
+            slot->prev_bound = nullptr;
+            slot->next_bound = registry.slots;
+            if (registry.slots) {
+                registry.slots->prev_bound = slot;
+            }
+            registry.slots = slot;
+            slot->observed_activity = slot->activity.load(std::memory_order_relaxed);
+            slot->observed_at_ms = monotonic_ms();
+            slot->idle_released = false;
+        }
+
+        /** @brief Unlinks a slot from its registry. Caller holds the registry mutex. */
+        void unlink_slot(TlsOwnerRegistry &registry, TlsSlot *slot) {
+            if (slot->prev_bound) {
+                slot->prev_bound->next_bound = slot->next_bound;
+            } else {
+                registry.slots = slot->next_bound;
+            }
+            if (slot->next_bound) {
+                slot->next_bound->prev_bound = slot->prev_bound;
+            }
+            slot->next_bound = nullptr;
+            slot->prev_bound = nullptr;
+        }
+
+        /** @brief True while a slot is on its registry's list. Caller holds the mutex. */
+        bool is_linked(const TlsOwnerRegistry &registry, const TlsSlot *slot) {
+            return slot->prev_bound || registry.slots == slot;
+        }
+
+        /**
+         * @brief Makes every thread's earlier stores visible before our later loads.
+         *
+         * The heavy half of the enter_tls_slot() handshake. Linux uses an expedited
+         * membarrier, or failing that an mprotect() downgrade, whose TLB shootdown
+         * interrupts every CPU running one of our threads. Windows has
+         * FlushProcessWriteBuffers(). Elsewhere both halves are full fences.
+         */
+        void heavy_barrier() {
+#if defined(_WIN32)
+            FlushProcessWriteBuffers();
+#elif defined(__linux__) && !defined(__SANITIZE_THREAD__)
+#if defined(__NR_membarrier)
+            // MEMBARRIER_CMD_PRIVATE_EXPEDITED and its registration (Linux 4.14+)
+            constexpr int kPrivateExpedited = 1 << 3;
+            constexpr int kRegisterPrivateExpedited = 1 << 4;
+            static const bool s_membarrier =
+                syscall(__NR_membarrier, kRegisterPrivateExpedited, 0, 0) == 0;
+            if (s_membarrier && syscall(__NR_membarrier, kPrivateExpedited, 0, 0) == 0) {
+                return;
+            }
+#endif
+            static std::mutex s_page_mutex;
+            static void *s_page = [] {
+                void *page = mmap(nullptr, 4096, PROT_READ | PROT_WRITE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                return page == MAP_FAILED ? nullptr : page;
+            }();
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (s_page) {
+                std::lock_guard<std::mutex> lock(s_page_mutex);
+                *static_cast<volatile char *>(s_page) = 0; // Make sure the page is mapped
+                mprotect(s_page, 4096, PROT_READ);
+                mprotect(s_page, 4096, PROT_READ | PROT_WRITE);
+            }
+#endif
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+
+        /** @brief Set once this thread's slots have been torn down at thread exit. */
+        thread_local bool t_slots_reaped = false;
+
+        // Slot storage comes straight from the OS so that binding never re-enters
+        // a general-purpose heap that may itself be backed by a Context.
+        void *map_slot_storage(size_t size) {
+#if defined(_WIN32)
+            return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+            void *ptr =
+                mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            return ptr == MAP_FAILED ? nullptr : ptr;
+#endif
+        }
+
+        /** @brief Destroys a slot and unmaps its storage. */
+        void destroy_slot(TlsSlot *slot) {
+            size_t size = slot->layout->size;
+            slot->~TlsSlot();
+#if defined(_WIN32)
+            (void)size;
+            VirtualFree(slot, 0, MEM_RELEASE);
+#else
+            munmap(slot, size);
+#endif
+        }
+
+        /**
+         * @brief Releases this thread's slot storage when the thread exits.
+         *
+         * Kept separate from t_tls_slots so the hot-path table stays trivially
+         * destructible and needs no TLS init guard. Every slot is handed back to its
+         * registered owner first, so cached blocks return to the global pools; the
+         * storage is unmapped only after all of them are released, since releasing
+         * one Context's blocks may touch this thread's other slots.
+         */
+        struct TlsSlotReaper {
+            bool armed = false;
+
+            ~TlsSlotReaper() {
+                for (size_t i = 0; i < kMaxTlsContexts; ++i) {
+                    if (TlsSlot *slot = t_tls_slots[i]) {
+                        release_on_exit(i, *slot);
+                    }
+                }
+                for (size_t i = 0; i < kMaxTlsContexts; ++i) {
+                    if (TlsSlot *slot = t_tls_slots[i]) {
+                        t_tls_slots[i] = nullptr;
+                        destroy_slot(slot);
+                    }
+                }
+                t_slots_reaped = true;
+            }
+
+            /**
+             * @brief Hands a slot's caches back to its Context if that is still alive.
+             *
+             * Entering the slot first waits out any reclaim in progress and keeps new
+             * ones away. The registry is not locked across the release; the releasing
+             * count keeps the Context's destructor waiting instead.
+             */
+            static void release_on_exit(size_t index, TlsSlot &slot) {
+                TlsOwnerRegistry &registry = s_registries[index];
+                enter_tls_slot(slot);
+
+                TlsSlotReleaseFn release = nullptr;
+                void *context = nullptr;
+                {
+                    std::lock_guard<std::mutex> lock(registry.mutex);
+                    if (is_linked(registry, &slot)) {
+                        unlink_slot(registry, &slot);
+                        if (registry.owner == slot.owner) {
+                            if (registry.retire) {
+                                registry.retire(registry.context, slot);
+                            }
+                            release = registry.release;
+                            context = registry.context;
+                            ++registry.releasing;
+                        }
+                    }
+                }
+
+                if (release) {
+                    release(context, slot);
+                    std::lock_guard<std::mutex> lock(registry.mutex);
+                    if (--registry.releasing == 0) {
+                        registry.released.notify_all();
+                    }
+                }
+                leave_tls_slot(slot);
+            }
+        };
+
+        thread_local TlsSlotReaper t_slot_reaper;
+
+    }
+
+    uint32_t acquire_tls_slot_index() {
+        std::lock_guard<std::mutex> lock(s_slot_mutex);
+        for (size_t i = 0; i < kMaxTlsContexts; ++i) {
+            if (!s_slot_in_use[i]) {
+                s_slot_in_use[i] = true;
+                return static_cast<uint32_t>(i);
+            }
+        }
+        return kNoTlsSlot;
+    }
+
+    void release_tls_slot_index(uint32_t index) {
+        if (index >= kMaxTlsContexts) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(s_slot_mutex);
+        s_slot_in_use[index] = false;
+    }
+
+    TlsSlot *bind_tls_slot(uint32_t index, uint64_t owner, const TlsSlotLayout &layout) {
+        if (index >= kMaxTlsContexts || t_slots_reaped) {
+            return nullptr;
+        }
+
+        TlsSlot *slot = t_tls_slots[index];
+        if (slot && slot->owner != owner && slot->layout != &layout) {
+            // Previous owner was destroyed and had another policy; nothing is worth keeping
+            t_tls_slots[index] = nullptr;
+            destroy_slot(slot);
+            slot = nullptr;
+        }
+        if (!slot) {
+            void *storage = map_slot_storage(layout.size);
+            if (!storage) {
+                return nullptr;
+            }
+            slot = layout.create(storage);
+            slot->layout = &layout;
+            layout.reset(*slot);
+            t_tls_slots[index] = slot;
+            t_slot_reaper.armed = true; // First odr-use registers the thread-exit destructor
+        } else if (slot->owner != owner) {
+            // Previous owner was destroyed; its cached pointers refer to unmapped memory
+            layout.reset(*slot);
+#ifdef CELL_ENABLE_STATS
+            slot->stats.clear();
+#endif
+#ifdef CELL_ENABLE_TRACE
+            slot->trace_ring = nullptr;
+#endif
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+            slot->latency.clear();
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+            slot->heap_sample_countdown = 0;
+            slot->heap_sample_rng = 0;
+#endif
+#ifdef CELL_ENABLE_BUDGET
+            slot->budget_lease.store(0, std::memory_order_relaxed);
+#endif
+        }
+
+        slot->owner = owner;
+
+        // Unregistering the previous owner unlinked the slot; join the new one's list
+        TlsOwnerRegistry &registry = s_registries[index];
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        if (registry.owner == owner && !is_linked(registry, slot)) {
+            link_slot(registry, slot);
+        }
+        return slot;
+    }
+
+    void register_tls_owner(uint32_t index, uint64_t owner, TlsSlotReleaseFn release,
+                            TlsSlotRetireFn retire, void *context) {
+        if (index >= kMaxTlsContexts) {
+            return;
+        }
+        TlsOwnerRegistry &registry = s_registries[index];
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.owner = owner;
+        registry.release = release;
+        registry.retire = retire;
+        registry.context = context;
+    }
+
+    void visit_bound_tls_slots(uint32_t index, TlsSlotVisitFn visit, void *arg) {
+        if (index >= kMaxTlsContexts) {
+            return;
+        }
+        TlsOwnerRegistry &registry = s_registries[index];
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (const TlsSlot *slot = registry.slots; slot; slot = slot->next_bound) {
+            visit(*slot, arg);
+        }
+    }
+
+    void unregister_tls_owner(uint32_t index) {
+        if (index >= kMaxTlsContexts) {
+            return;
+        }
+        TlsOwnerRegistry &registry = s_registries[index];
+        std::unique_lock<std::mutex> lock(registry.mutex);
+        registry.owner = 0;
+        registry.release = nullptr;
+        registry.retire = nullptr;
+        registry.context = nullptr;
+        while (registry.slots) {
+            unlink_slot(registry, registry.slots);
+        }
+        registry.released.wait(lock, [&] { return registry.releasing == 0; });
+    }
+
+    size_t reclaim_idle_tls_slots(uint32_t index, uint32_t idle_ms) {
+        if (index >= kMaxTlsContexts) {
+            return 0;
+        }
+        TlsOwnerRegistry &registry = s_registries[index];
+        TlsSlot *self = t_tls_slots[index];
+
+        // Pick the idle slots and flag them, then one heavy barrier for all of them
+        TlsSlot *picked = nullptr;
+        TlsSlotReleaseFn release;
+        void *context;
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            release = registry.release;
+            context = registry.context;
+            if (!release) {
+                return 0;
+            }
+
+            uint32_t now = monotonic_ms();
+            for (TlsSlot *slot = registry.slots; slot; slot = slot->next_bound) {
+                uint32_t activity = slot->activity.load(std::memory_order_relaxed);
+                if (activity != slot->observed_activity) {
+                    slot->observed_activity = activity;
+                    slot->observed_at_ms = now;
+                    slot->idle_released = false;
+                    continue;
+                }
+                if (slot == self || slot->idle_released || now - slot->observed_at_ms < idle_ms) {
+                    continue;
+                }
+                slot->reclaiming.store(1, std::memory_order_relaxed);
+                slot->next_reclaim = picked;
+                picked = slot;
+            }
+            if (!picked) {
+                return 0;
+            }
+
+            heavy_barrier();
+
+            // A thread that entered before seeing the flag is busy, not idle
+            TlsSlot **pp = &picked;
+            while (*pp) {
+                TlsSlot *slot = *pp;
+                if ((slot->activity.load(std::memory_order_acquire) & kTlsSlotDepthMask) != 0) {
+                    *pp = slot->next_reclaim;
+                    slot->reclaiming.store(0, std::memory_order_release);
+                } else {
+                    slot->idle_released = true;
+                    pp = &slot->next_reclaim;
+                }
+            }
+
+            // The picked slots stay linked: their threads block in enter_tls_slot(),
+            // including at exit, until we clear the flag
+            ++registry.releasing;
+        }
+
+        size_t count = 0;
+        while (picked) {
+            TlsSlot *slot = picked;
+            picked = slot->next_reclaim;
+            release(context, *slot);
+            slot->reclaiming.store(0, std::memory_order_release);
+            ++count;
+        }
+
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        if (--registry.releasing == 0) {
+            registry.released.notify_all();
+        }
+        return count;
+    }
+
+    void wait_for_tls_reclaim(TlsSlot &slot) {
+        while (slot.reclaiming.load(std::memory_order_acquire) != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+}
@@ -0,0 +1,358 @@
+#pragma once
+
+#include "cell/config.h"
+#include "cell/stats.h"
+#include "cell/sub_cell.h"
+#include "remote_free.h"
+#include "tls_bin_cache.h"
+#include "tls_buddy_cache.h"
+#include "tls_cache.h"
+#ifdef CELL_ENABLE_TRACE
+#include "trace_ring.h"
+#endif
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+#include "cell/latency.h"
+#include "cell/trace.h"
+#endif
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+namespace Cell {
+
+    struct TlsSlotLayout;
+
+    /**
+     * @brief All thread-local state one thread keeps for one Context.
+     *
+     * Each live Context owns a slot index; every thread lazily gets its own TlsSlot
+     * at that index. The owner id tells a thread whether the slot still belongs to
+     * the Context using it, or to a destroyed Context that previously held the index.
+     *
+     * A bound slot is also linked into its Context's registry, so the caches can be
+     * handed back when the thread exits or after it has been idle for a while (see
+     * enter_tls_slot() for how another thread empties a slot safely).
+     *
+     * This is the policy-independent part the registry works with; the caches, sized
+     * by the Context's policy, are in BasicTlsSlot, and layout says which one it is.
+     */
+    struct TlsSlot {
+        uint64_t owner = 0;                    ///< Id of the Context bound to this slot.
+        const TlsSlotLayout *layout = nullptr; ///< Policy part of the slot.
+#ifdef CELL_ENABLE_STATS
+        StatsShard stats; ///< This thread's statistics counters for the Context.
+#endif
+#ifdef CELL_ENABLE_TRACE
+        TraceRing *trace_ring = nullptr; ///< Ring claimed for this Context; released at exit.
+#endif
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+        LatencyShard latency; ///< This thread's slow path latencies for the Context.
+#endif
+#ifdef CELL_ENABLE_HEAP_PROFILE
+        size_t heap_sample_countdown = 0; ///< Bytes to allocate before the next sample; owner only.
+        uint64_t heap_sample_rng = 0;     ///< Sampling random state, 0 until first drawn.
+#endif
+#ifdef CELL_ENABLE_BUDGET
+        /// Budget charged to the Context but not yet spent; owner writes (while entered).
+        std::atomic<size_t> budget_lease{0};
+#endif
+#ifdef CELL_HARDENED
+        uint32_t check_countdown = kHardenedCheckInterval; ///< Fast-path allocs to the next check.
+#endif
+
+        std::atomic<uint32_t> activity{0};   ///< Entry depth (low 8 bits) + 256 per exit; owner writes.
+        std::atomic<uint32_t> reclaiming{0}; ///< Nonzero while another thread empties the slot.
+
+        // Guarded by the registry mutex of the slot index
+        TlsSlot *next_bound = nullptr;   ///< Next slot bound to the same Context.
+        TlsSlot *prev_bound = nullptr;   ///< Previous slot bound to the same Context.
+        TlsSlot *next_reclaim = nullptr; ///< Chain of slots picked by one reclaim pass.
+        uint32_t observed_activity = 0;  ///< activity when last seen to change.
+        uint32_t observed_at_ms = 0;     ///< When observed_activity was recorded.
+        bool idle_released = false;      ///< Already released since activity last changed.
+    };
+
+    /**
+     * @brief How bind_tls_slot() creates and empties the policy part of a slot.
+     *
+     * An index is reused by Contexts of any policy; a slot of another layout is
+     * unmapped and replaced when its index is bound again.
+     */
+    struct TlsSlotLayout {
+        size_t size;                       ///< Bytes of the whole slot.
+        TlsSlot *(*create)(void *storage); ///< Constructs a slot in size bytes of storage.
+        void (*reset)(TlsSlot &slot);      ///< Empties the caches; bins at initial capacity.
+    };
+
+    /**
+     * @brief A TlsSlot with the caches of a BasicContext<Policy>.
+     */
+    template <typename Policy> struct BasicTlsSlot : TlsSlot {
+        using Traits = PolicyTraits<Policy>;
+
+        TlsCache<Policy> cells;                                    ///< Cell cache (Tier 1).
+        TlsBinCache<Policy> bins[Traits::kTlsBinCacheCount];       ///< Sub-cell block caches.
+        TlsBuddyCache<Policy> buddy[Traits::kTlsBuddyCacheOrders]; ///< Small buddy caches.
+        BasicRemoteFreeQueue<Policy> *remote_queue = nullptr;      ///< Queue claimed.
+        size_t bin_cache_bytes = 0; ///< Summed capacity of bins, in bytes.
+
+        static TlsSlot *create(void *storage) {
+            // The thread-exit reaper only runs the TlsSlot destructor
+            static_assert(std::is_trivially_destructible<TlsCache<Policy>>::value &&
+                              std::is_trivially_destructible<TlsBinCache<Policy>>::value &&
+                              std::is_trivially_destructible<TlsBuddyCache<Policy>>::value,
+                          "Policy caches must not need destruction");
+            return new (storage) BasicTlsSlot();
+        }
+
+        static void reset(TlsSlot &base) {
+            auto &slot = static_cast<BasicTlsSlot &>(base);
+            slot.cells.count = 0;
+            slot.bin_cache_bytes = 0;
+            for (size_t i = 0; i < Traits::kTlsBinCacheCount; ++i) {
+                TlsBinCache<Policy> &cache = slot.bins[i];
+                cache.count = 0;
+                cache.capacity = initial_tls_bin_capacity<Policy>(i);
+                cache.overflows = 0;
+                cache.owned = nullptr;
+                slot.bin_cache_bytes += cache.capacity * Traits::kSizeClasses[i];
+            }
+            for (TlsBuddyCache<Policy> &cache : slot.buddy) {
+                cache.count = 0;
+            }
+            slot.remote_queue = nullptr;
+        }
+    };
+
+    /** @brief The layout of BasicTlsSlot<Policy>, which identifies its slots. */
+    template <typename Policy>
+    inline constexpr TlsSlotLayout kTlsSlotLayout = {
+        sizeof(BasicTlsSlot<Policy>), &BasicTlsSlot<Policy>::create, &BasicTlsSlot<Policy>::reset};
+
+    /**
+     * @brief Returns everything a slot caches to its Context.
+     *
+     * Called with the slot entered or reclaiming, on the slot's own thread at exit or
+     * on a reclaiming thread.
+     */
+    using TlsSlotReleaseFn = void (*)(void *context, TlsSlot &slot);
+
+    /**
+     * @brief Folds state the Context reads across bound slots out of an exiting slot.
+     *
+     * Called under the registry mutex as the slot is unlinked, so a concurrent
+     * visit_bound_tls_slots() sees the state either in the slot or folded, never
+     * both. The mutex is a leaf: the hook must not lock anything.
+     */
+    using TlsSlotRetireFn = void (*)(void *context, TlsSlot &slot);
+
+    /**
+     * @brief Reads one bound slot; see visit_bound_tls_slots().
+     */
+    using TlsSlotVisitFn = void (*)(const TlsSlot &slot, void *arg);
+
+    /** @brief Low bits of TlsSlot::activity holding the entry depth. */
+    static constexpr uint32_t kTlsSlotDepthMask = 0xFF;
+
+    /** @brief Slot index used by Contexts that could not claim one (never bound). */
+    static constexpr uint32_t kNoTlsSlot = static_cast<uint32_t>(kMaxTlsContexts);
+
+    /**
+     * @brief Per-thread slot table, indexed by Context slot index.
+     *
+     * The extra trailing entry belongs to kNoTlsSlot and always stays nullptr,
+     * so lookups need no bounds check.
+     */
+    inline thread_local TlsSlot *t_tls_slots[kMaxTlsContexts + 1] = {};
+
+    /**
+     * @brief Claims a process-wide slot index for a new Context.
+     * @return Slot index, or kNoTlsSlot if all kMaxTlsContexts are in use.
+     */
+    uint32_t acquire_tls_slot_index();
+
+    /**
+     * @brief Returns a slot index claimed by acquire_tls_slot_index().
+     */
+    void release_tls_slot_index(uint32_t index);
+
+    /**
+     * @brief Binds the calling thread's slot at index to a Context (slow path).
+     *
+     * Allocates the slot on first use. Any state left by a previous owner is
+     * discarded: slot indices are only reused after their Context is destroyed.
+     * Bin caches start at their initial capacity.
+     *
+     * @param index Slot index of the Context.
+     * @param owner Id of the Context.
+     * @param layout Layout of the Context's slots.
+     * @return The bound slot, or nullptr for kNoTlsSlot or if storage is unavailable.
+     */
+    TlsSlot *bind_tls_slot(uint32_t index, uint64_t owner, const TlsSlotLayout &layout);
+
+    /**
+     * @brief Registers a Context's release hook for its slot index.
+     *
+     * From here on, slots bound at the index are linked into the Context's registry
+     * and handed to retire (if set) and then release when their thread exits.
+     */
+    void register_tls_owner(uint32_t index, uint64_t owner, TlsSlotReleaseFn release,
+                            TlsSlotRetireFn retire, void *context);
+
+    /**
+     * @brief Calls visit for every slot bound to the Context at index.
+     *
+     * Runs under the registry mutex while the slots' threads keep going, so visit
+     * may only read what their owners publish atomically, and must not lock.
+     */
+    void visit_bound_tls_slots(uint32_t index, TlsSlotVisitFn visit, void *arg);
+
+    /**
+     * @brief Unlinks every slot of a Context that is being destroyed.
+     *
+     * Waits for exiting threads that are still releasing into it.
+     */
+    void unregister_tls_owner(uint32_t index);
+
+    /**
+     * @brief Releases the caches of other threads' slots that have been idle for idle_ms.
+     *
+     * A slot is idle once its activity count has not changed across reclaim passes
+     * spanning idle_ms. Slots whose thread is inside an operation are skipped.
+     *
+     * @return Number of slots released.
+     */
+    size_t reclaim_idle_tls_slots(uint32_t index, uint32_t idle_ms);
+
+    /**
+     * @brief Waits until a reclaim of the calling thread's slot finishes (slow path).
+     */
+    void wait_for_tls_reclaim(TlsSlot &slot);
+
+    /**
+     * @brief Orders the preceding store before the following load, paired with the
+     *        heavy barrier a reclaiming thread issues.
+     *
+     * Where the heavy side can interrupt every thread of the process (membarrier on
+     * Linux, FlushProcessWriteBuffers on Windows) this only stops the compiler from
+     * reordering; elsewhere it is a full fence.
+     */
+    CELL_FORCE_INLINE void tls_light_barrier() {
+#if (defined(__linux__) || defined(_WIN32)) && !defined(__SANITIZE_THREAD__)
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+#else
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+    }
+
+    /**
+     * @brief Marks the calling thread as using its slot; nests.
+     *
+     * A reclaiming thread sets reclaiming, issues the heavy barrier and only then
+     * looks at the entry depth. Either it sees this entry and leaves the slot alone,
+     * or this load sees its flag and waits for the reclaim to finish. The load
+     * acquires the reclaimer's release of the flag, so a thread entering just after
+     * a reclaim reads the emptied caches rather than their old contents.
+     */
+    CELL_FORCE_INLINE void enter_tls_slot(TlsSlot &slot) {
+        uint32_t activity = slot.activity.load(std::memory_order_relaxed);
+        slot.activity.store(activity + 1, std::memory_order_relaxed);
+        tls_light_barrier();
+        if (CELL_UNLIKELY(slot.reclaiming.load(std::memory_order_acquire) != 0)) {
+            wait_for_tls_reclaim(slot);
+        }
+    }
+
+    /**
+     * @brief enter_tls_slot() that gives up instead of waiting for a reclaim.
+     *
+     * For callers that may hold a bin lock the reclaim needs (the Allocator is
+     * reached from under them); they use the shared pools instead.
+     *
+     * @return true if entered; leave_tls_slot() must follow.
+     */
+    CELL_FORCE_INLINE bool try_enter_tls_slot(TlsSlot &slot) {
+        uint32_t activity = slot.activity.load(std::memory_order_relaxed);
+        slot.activity.store(activity + 1, std::memory_order_relaxed);
+        tls_light_barrier();
+        if (CELL_UNLIKELY(slot.reclaiming.load(std::memory_order_acquire) != 0)) {
+            slot.activity.store(activity, std::memory_order_release);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Ends an enter_tls_slot() and counts one more operation on the slot.
+     */
+    CELL_FORCE_INLINE void leave_tls_slot(TlsSlot &slot) {
+        uint32_t activity = slot.activity.load(std::memory_order_relaxed);
+        slot.activity.store(activity - 1 + (kTlsSlotDepthMask + 1), std::memory_order_release);
+    }
+
+    /**
+     * @brief Keeps a slot entered for the enclosing scope. A null slot is ignored.
+     */
+    class TlsSlotScope {
+    public:
+        explicit TlsSlotScope(TlsSlot *slot) : m_slot(slot) {
+            if (m_slot) {
+                enter_tls_slot(*m_slot);
+            }
+        }
+        ~TlsSlotScope() {
+            if (m_slot) {
+                leave_tls_slot(*m_slot);
+            }
+        }
+
+        TlsSlotScope(const TlsSlotScope &) = delete;
+        TlsSlotScope &operator=(const TlsSlotScope &) = delete;
+
+    private:
+        TlsSlot *m_slot;
+    };
+
+    /**
+     * @brief Returns the calling thread's slot for a Context, binding it if needed.
+     *
+     * A slot bound to owner was created for owner's policy, so the owner check alone
+     * makes the downcast safe.
+     */
+    template <typename Policy>
+    CELL_FORCE_INLINE BasicTlsSlot<Policy> *get_tls_slot(uint32_t index, uint64_t owner) {
+        TlsSlot *slot = t_tls_slots[index];
+        if (CELL_LIKELY(slot && slot->owner == owner)) {
+            return static_cast<BasicTlsSlot<Policy> *>(slot);
+        }
+        return static_cast<BasicTlsSlot<Policy> *>(
+            bind_tls_slot(index, owner, kTlsSlotLayout<Policy>));
+    }
+
+    /**
+     * @brief Returns the calling thread's slot only if it is already bound to owner.
+     */
+    template <typename Policy>
+    inline BasicTlsSlot<Policy> *find_tls_slot(uint32_t index, uint64_t owner) {
+        TlsSlot *slot = t_tls_slots[index];
+        return (slot && slot->owner == owner) ? static_cast<BasicTlsSlot<Policy> *>(slot)
+                                              : nullptr;
+    }
+
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+    /**
+     * @brief Records the time since start, a trace_clock() reading, in a slot's shard.
+     *
+     * Caller is the slot's thread. A null slot (a thread without one) records nothing.
+     */
+    inline void record_latency(TlsSlot *slot, LatencyPath path, uint64_t start) {
+        if (slot) {
+            auto ticks = static_cast<double>(trace_clock() - start);
+            slot->latency.record(path, static_cast<uint64_t>(ticks * latency_ns_per_tick()));
+        }
+    }
+#endif
+
+}
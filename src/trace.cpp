@@ -0,0 +1,93 @@
+#include "cell/trace.h"
+
+#include "cell/context.h"
+#include "cell/latency.h"
+
+namespace Cell {
+
+    uint64_t trace_clock_frequency() {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+        // The invariant TSC has no architectural way to read its rate; time it instead
+        static const uint64_t s_frequency = [] {
+            using namespace std::chrono;
+            auto start = steady_clock::now();
+            uint64_t start_ticks = trace_clock();
+            std::this_thread::sleep_for(milliseconds(10));
+            uint64_t ticks = trace_clock() - start_ticks;
+            auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+            return elapsed > 0 ? static_cast<uint64_t>(static_cast<double>(ticks) * 1e9 /
+                                                       static_cast<double>(elapsed))
+                               : uint64_t{1000000000};
+        }();
+        return s_frequency;
+#elif defined(__aarch64__)
+        uint64_t frequency;
+        asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+        return frequency;
+#else
+        return 1000000000;
+#endif
+    }
+
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+    double latency_ns_per_tick() {
+        static const double s_ns_per_tick = 1e9 / static_cast<double>(trace_clock_frequency());
+        return s_ns_per_tick;
+    }
+#endif
+
+#ifdef CELL_ENABLE_TRACE
+    namespace {
+
+        /** @brief Events moved per drain_trace() call and fwrite(). */
+        constexpr size_t kTraceWriterBatch = 1024;
+
+    }
+
+    TraceWriter::TraceWriter(Context &ctx, std::FILE *out, uint32_t interval_ms)
+        : m_ctx(ctx), m_out(out), m_interval_ms(interval_ms > 0 ? interval_ms : 1) {
+        TraceFileHeader header;
+        header.ticks_per_second = trace_clock_frequency();
+        std::fwrite(&header, sizeof(header), 1, m_out);
+        m_ctx.set_tracing(true);
+        m_thread = std::thread(&TraceWriter::run, this);
+    }
+
+    TraceWriter::~TraceWriter() {
+        m_ctx.set_tracing(false);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_one();
+        m_thread.join(); // Its last pass drains what the rings still hold
+        std::fflush(m_out);
+    }
+
+    void TraceWriter::run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_stop) {
+            m_wake.wait_for(lock, std::chrono::milliseconds(m_interval_ms),
+                            [this] { return m_stop; });
+            // Runs once more after the stop request, so nothing recorded is left behind
+            lock.unlock();
+            drain();
+            lock.lock();
+        }
+    }
+
+    void TraceWriter::drain() {
+        // On the stack: the writer must not allocate from the heap it traces
+        TraceEvent batch[kTraceWriterBatch];
+        size_t count;
+        do {
+            count = m_ctx.drain_trace(batch, kTraceWriterBatch);
+            if (count > 0) {
+                std::fwrite(batch, sizeof(TraceEvent), count, m_out);
+                m_written.fetch_add(count, std::memory_order_relaxed);
+            }
+        } while (count == kTraceWriterBatch);
+    }
+#endif
+
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "cell/sub_cell.h"
+#include "cell/trace.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Cell {
+
+    /**
+     * @brief Single-producer single-consumer ring of one thread's trace events.
+     *
+     * The producer is the thread that claimed the ring and the consumer whoever
+     * holds the Context's drain lock. Pushing is a few plain stores plus a release
+     * store of head; tail is only reloaded when the cached copy says the ring is
+     * full. A full ring drops the event and counts it instead of blocking.
+     *
+     * Rings are mapped straight from the OS, owned by the Context and reused by
+     * later threads, so tracing never allocates from the heap it is tracing.
+     */
+    struct TraceRing {
+        alignas(64) std::atomic<uint64_t> head{0}; ///< Next slot to write; producer stores.
+        uint64_t cached_tail = 0;                  ///< Producer's last view of tail.
+        std::atomic<uint64_t> dropped{0};          ///< Events lost to a full ring.
+        uint32_t thread = 0;                       ///< TraceEvent::thread of the producer.
+
+        alignas(64) std::atomic<uint64_t> tail{0}; ///< Next slot to read; consumer stores.
+
+        // Guarded by the Context's trace mutex (in_use is also cleared at thread exit)
+        TraceRing *next_registered = nullptr; ///< Context registry link; never unlinked.
+        std::atomic<bool> in_use{false};      ///< Claimed by a live thread.
+
+        alignas(64) TraceEvent events[kTraceRingEvents];
+
+        /**
+         * @brief Appends an event (producer only).
+         * @return false if the ring was full and the event was dropped.
+         */
+        CELL_FORCE_INLINE bool push(const TraceEvent &event) {
+            uint64_t h = head.load(std::memory_order_relaxed);
+            if (CELL_UNLIKELY(h - cached_tail >= kTraceRingEvents)) {
+                cached_tail = tail.load(std::memory_order_acquire);
+                if (h - cached_tail >= kTraceRingEvents) {
+                    dropped.store(dropped.load(std::memory_order_relaxed) + 1,
+                                  std::memory_order_relaxed);
+                    return false;
+                }
+            }
+            events[h & (kTraceRingEvents - 1)] = event;
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Moves up to capacity events to out (consumer only).
+         * @return Number of events moved.
+         */
+        size_t drain(TraceEvent *out, size_t capacity) {
+            uint64_t t = tail.load(std::memory_order_relaxed);
+            uint64_t available = head.load(std::memory_order_acquire) - t;
+            size_t count = available < capacity ? static_cast<size_t>(available) : capacity;
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = events[(t + i) & (kTraceRingEvents - 1)];
+            }
+            // Release keeps the copies above from reading slots the producer reuses
+            tail.store(t + count, std::memory_order_release);
+            return count;
+        }
+    };
+
+}
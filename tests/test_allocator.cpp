@@ -1,9 +1,11 @@
 #include "cell/context.h"
 
 #include <cassert>
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <cstdio>
+#include <map>
 #include <thread>
 #include <vector>
 
@@ -232,6 +234,353 @@ TEST(MemoryDecommit) {
     printf("  PASSED\n");
 }
 
+// Test 7: Every huge page policy commits, decommits and recommits 2MB-aligned superblocks
+TEST(HugePagePolicies) {
+    const Cell::HugePagePolicy policies[] = {Cell::HugePagePolicy::kNone,
+                                             Cell::HugePagePolicy::kTransparent,
+                                             Cell::HugePagePolicy::kExplicit};
+
+    for (Cell::HugePagePolicy policy : policies) {
+        Cell::Config config;
+        config.reserve_size = 64 * 1024 * 1024;
+        config.huge_pages = policy;
+
+        Cell::Context ctx(config);
+
+        // Cells come from superblocks that start on a huge page boundary
+        const size_t count = Cell::kCellsPerSuperblock * 2;
+        std::vector<Cell::CellData *> cells;
+        for (size_t i = 0; i < count; ++i) {
+            Cell::CellData *cell = ctx.alloc_cell(0);
+            assert(cell != nullptr);
+            std::memset(reinterpret_cast<char *>(cell) + 64, static_cast<int>(i), 64);
+            cells.push_back(cell);
+        }
+        assert(reinterpret_cast<uintptr_t>(cells[0]) % Cell::kSuperblockSize == 0 &&
+               "First cell should start a 2MB-aligned superblock");
+
+        // Buddy blocks are aligned to their size within the 2MB-aligned region
+        void *medium = ctx.alloc_large(512 * 1024);
+        assert(medium != nullptr);
+        assert((reinterpret_cast<uintptr_t>(medium) - Cell::BuddyAllocator::kHeaderSize) %
+                   (1024 * 1024) ==
+               0);
+        std::memset(medium, 0xAB, 512 * 1024);
+        ctx.free_large(medium);
+
+        for (auto *cell : cells) {
+            ctx.free_cell(cell);
+        }
+        cells.clear();
+
+        // Only whole superblocks are released
+        size_t freed = ctx.decommit_unused();
+        assert(freed % Cell::kSuperblockSize == 0);
+        assert(freed > 0 && "Free superblocks should be decommitted");
+
+        // Recommitted superblocks are usable again
+        for (size_t i = 0; i < count; ++i) {
+            Cell::CellData *cell = ctx.alloc_cell(0);
+            assert(cell != nullptr);
+            std::memset(reinterpret_cast<char *>(cell) + 64, 0x5A, Cell::kCellSize - 64);
+            cells.push_back(cell);
+        }
+        for (auto *cell : cells) {
+            ctx.free_cell(cell);
+        }
+        printf("  Policy %d: decommitted %zu bytes\n", static_cast<int>(policy), freed);
+    }
+
+    printf("  PASSED\n");
+}
+
+// Test 8: scavenge() only releases superblocks that stayed free past the decay time
+TEST(ScavengeHonorsDecay) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    config.decay_ms = 50;
+
+    Cell::Context ctx(config);
+
+    const size_t count = Cell::kCellsPerSuperblock * 3;
+    std::vector<Cell::CellData *> cells;
+    for (size_t i = 0; i < count; ++i) {
+        Cell::CellData *cell = ctx.alloc_cell(0);
+        assert(cell != nullptr);
+        cells.push_back(cell);
+    }
+    for (auto *cell : cells) {
+        ctx.free_cell(cell);
+    }
+    cells.clear();
+
+    size_t committed_before = ctx.committed_bytes();
+    assert(committed_before == 3 * Cell::kSuperblockSize);
+
+    // Freshly freed memory is kept for reuse
+    const uint64_t budget_ns = 1000000000;
+    assert(ctx.scavenge(budget_ns) == 0 && "Nothing has decayed yet");
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // The thread cache still holds cells of one superblock, which must stay committed
+    size_t freed = ctx.scavenge(budget_ns);
+    printf("  Released %zu bytes with cells still cached\n", freed);
+    assert(freed == 2 * Cell::kSuperblockSize);
+    assert(ctx.committed_bytes() == committed_before - freed);
+
+    ctx.flush_tls_caches();
+    assert(ctx.scavenge(budget_ns) == Cell::kSuperblockSize);
+    assert(ctx.committed_bytes() == 0);
+
+    // Scavenged superblocks are recommitted on demand
+    for (size_t i = 0; i < count; ++i) {
+        Cell::CellData *cell = ctx.alloc_cell(0);
+        assert(cell != nullptr);
+        std::memset(reinterpret_cast<char *>(cell) + 64, 0x3C, Cell::kCellSize - 64);
+        cells.push_back(cell);
+    }
+    for (auto *cell : cells) {
+        ctx.free_cell(cell);
+    }
+
+    printf("  PASSED\n");
+}
+
+// Test 9: The background scavenger returns idle memory without being pumped
+TEST(BackgroundScavenger) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    config.decay_ms = 20;
+    config.background_scavenger = true;
+    config.scavenge_interval_ms = 5;
+
+    Cell::Context ctx(config);
+
+    std::vector<Cell::CellData *> cells;
+    for (size_t i = 0; i < Cell::kCellsPerSuperblock * 2; ++i) {
+        Cell::CellData *cell = ctx.alloc_cell(0);
+        assert(cell != nullptr);
+        cells.push_back(cell);
+    }
+    for (auto *cell : cells) {
+        ctx.free_cell(cell);
+    }
+    ctx.flush_tls_caches();
+    assert(ctx.committed_bytes() > 0);
+
+    for (int i = 0; i < 400 && ctx.committed_bytes() > 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    assert(ctx.committed_bytes() == 0 && "Background scavenger should release idle superblocks");
+
+    // Allocation keeps working alongside the scavenger thread
+    Cell::CellData *cell = ctx.alloc_cell(0);
+    assert(cell != nullptr);
+    ctx.free_cell(cell);
+
+    printf("  PASSED\n");
+}
+
+// Test 10: Per-node pools split the reservation and borrow from each other when one runs out
+TEST(NumaNodePools) {
+    Cell::Config config;
+    config.reserve_size = 32 * 1024 * 1024; // 8 cell superblocks
+    config.numa_nodes = 2;                  // More pools than this machine may have nodes
+
+    Cell::Context ctx(config);
+
+    // Exhaust the whole cell region: the home pool first, then the other one
+    std::vector<Cell::CellData *> cells;
+    while (Cell::CellData *cell = ctx.alloc_cell(0)) {
+        std::memset(reinterpret_cast<char *>(cell) + 64, 0x6B, 64);
+        cells.push_back(cell);
+    }
+    size_t capacity = cells.size();
+    printf("  Cells across both pools: %zu\n", capacity);
+    assert(capacity >= 8 * Cell::kCellsPerSuperblock);
+    assert(capacity % Cell::kCellsPerSuperblock == 0);
+
+#ifdef CELL_ENABLE_STATS
+    const Cell::MemoryStats &stats = ctx.get_stats();
+    assert(stats.numa_nodes == 2);
+    assert(stats.node_cells_in_use[0] + stats.node_cells_in_use[1] == capacity);
+    assert(stats.node_cells_in_use[0] > 0 && stats.node_cells_in_use[1] > 0);
+    assert(stats.node_committed[0] + stats.node_committed[1] == ctx.committed_bytes());
+#endif
+
+    // Cells go back to the pool they came from and the full capacity is reusable
+    for (auto *cell : cells) {
+        ctx.free_cell(cell);
+    }
+    cells.clear();
+    while (Cell::CellData *cell = ctx.alloc_cell(0)) {
+        cells.push_back(cell);
+    }
+    assert(cells.size() == capacity);
+    for (auto *cell : cells) {
+        ctx.free_cell(cell);
+    }
+
+    ctx.flush_tls_caches();
+    assert(ctx.decommit_unused() == capacity / Cell::kCellsPerSuperblock * Cell::kSuperblockSize);
+    assert(ctx.committed_bytes() == 0);
+
+    printf("  PASSED\n");
+}
+
+// Test 11: Free cells of partly used superblocks are purged, and reused densest first
+TEST(PartialSuperblockPurge) {
+    Cell::Config config;
+    config.reserve_size = 32 * 1024 * 1024;
+
+    Cell::Context ctx(config);
+
+    // Three superblocks' worth of cells, grouped by the superblock holding them
+    std::map<uintptr_t, std::vector<Cell::CellData *>> by_superblock;
+    for (size_t i = 0; i < 3 * Cell::kCellsPerSuperblock; ++i) {
+        Cell::CellData *cell = ctx.alloc_cell(0);
+        assert(cell != nullptr);
+        std::memset(reinterpret_cast<char *>(cell) + 64, 0x3C, Cell::kCellSize - 64);
+        by_superblock[reinterpret_cast<uintptr_t>(cell) / Cell::kSuperblockSize].push_back(cell);
+    }
+    assert(by_superblock.size() == 3);
+
+    // Fragment them: one stays dense, one keeps a few cells, one is emptied
+    auto it = by_superblock.begin();
+    std::vector<Cell::CellData *> &dense = (it++)->second;
+    std::vector<Cell::CellData *> &sparse = (it++)->second;
+    std::vector<Cell::CellData *> &empty = it->second;
+    const size_t dense_live = Cell::kCellsPerSuperblock * 3 / 4;
+    const size_t sparse_live = 4;
+    for (size_t i = dense_live; i < dense.size(); ++i) {
+        ctx.free_cell(dense[i]);
+    }
+    dense.resize(dense_live);
+    for (size_t i = sparse_live; i < sparse.size(); ++i) {
+        ctx.free_cell(sparse[i]);
+    }
+    sparse.resize(sparse_live);
+    for (auto *cell : empty) {
+        ctx.free_cell(cell);
+    }
+
+    size_t committed_before = ctx.committed_bytes();
+    size_t freed = ctx.decommit_unused();
+    size_t purged = 2 * Cell::kCellsPerSuperblock - dense_live - sparse_live;
+    printf("  Released %zu KB, %zu cells purged one by one\n", freed / 1024, purged);
+    assert(freed == Cell::kSuperblockSize + purged * Cell::kCellSize);
+    assert(ctx.committed_bytes() == committed_before - freed);
+
+    // New cells refill the dense superblock before touching the sparse one
+    const uintptr_t dense_sb = reinterpret_cast<uintptr_t>(dense[0]) / Cell::kSuperblockSize;
+    for (size_t i = dense_live; i < Cell::kCellsPerSuperblock; ++i) {
+        Cell::CellData *cell = ctx.alloc_cell(0);
+        assert(cell != nullptr);
+        assert(reinterpret_cast<uintptr_t>(cell) / Cell::kSuperblockSize == dense_sb);
+        std::memset(reinterpret_cast<char *>(cell) + 64, 0x5A, Cell::kCellSize - 64);
+        dense.push_back(cell);
+    }
+
+    // Once its last cells go, the sparse superblock is released whole
+    for (auto *cell : sparse) {
+        ctx.free_cell(cell);
+    }
+    assert(ctx.decommit_unused() == sparse_live * Cell::kCellSize);
+    assert(ctx.committed_bytes() == Cell::kSuperblockSize);
+
+    for (auto *cell : dense) {
+        ctx.free_cell(cell);
+    }
+
+    printf("  PASSED\n");
+}
+
+// Test 12: Cells moved between thread caches and the global stack in chains are never
+// handed out twice and all come back
+TEST(GlobalChainChurn) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+
+    Cell::Context ctx(config);
+    constexpr size_t kThreads = 4;
+    constexpr size_t kRound = Cell::kTlsCacheCapacity * 3; // Overflows the cache both ways
+
+    std::atomic<bool> corrupted{false};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&ctx, &corrupted, t] {
+            std::vector<Cell::CellData *> cells;
+            for (size_t round = 0; round < 200; ++round) {
+                // Uneven rounds, so chains get split and partly cached
+                size_t count = kRound - (round * 7 + t) % Cell::kTlsCacheCapacity;
+                for (size_t i = 0; i < count; ++i) {
+                    Cell::CellData *cell = ctx.alloc_cell(0);
+                    assert(cell != nullptr);
+                    auto *stamp = reinterpret_cast<uint64_t *>(reinterpret_cast<char *>(cell) + 64);
+                    *stamp = (t << 32) | i;
+                    cells.push_back(cell);
+                }
+                for (size_t i = 0; i < cells.size(); ++i) {
+                    auto *stamp =
+                        reinterpret_cast<uint64_t *>(reinterpret_cast<char *>(cells[i]) + 64);
+                    if (*stamp != ((t << 32) | i)) {
+                        corrupted = true;
+                    }
+                    ctx.free_cell(cells[i]);
+                }
+                cells.clear();
+            }
+            ctx.flush_tls_caches();
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    assert(!corrupted && "A cell was handed to two owners at once");
+
+    // Every cell came back: all superblocks are free and are released whole
+    ctx.flush_tls_caches();
+    size_t committed = ctx.committed_bytes();
+    assert(ctx.decommit_unused() == committed);
+    assert(ctx.committed_bytes() == 0);
+    (void)committed;
+
+    printf("  PASSED\n");
+}
+
+// Test 13: The stack head version carries past the cell alignment bits and the head
+// still points at the right chains
+TEST(GlobalHeadVersionCarry) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+
+    Cell::Context ctx(config);
+    constexpr size_t kRound = Cell::kTlsCacheCapacity * 2; // One push and pop per chain
+
+    // Each round moves two chains out and back: well over 2^14 head updates in total
+    std::vector<Cell::CellData *> cells;
+    for (size_t round = 0; round < 20000; ++round) {
+        for (size_t i = 0; i < kRound; ++i) {
+            Cell::CellData *cell = ctx.alloc_cell(0);
+            assert(cell != nullptr);
+            cells.push_back(cell);
+        }
+        for (Cell::CellData *cell : cells) {
+            ctx.free_cell(cell);
+        }
+        cells.clear();
+    }
+
+    ctx.flush_tls_caches();
+    size_t committed = ctx.committed_bytes();
+    assert(committed > 0 && ctx.decommit_unused() == committed);
+    assert(ctx.committed_bytes() == 0);
+    (void)committed;
+
+    printf("  PASSED\n");
+}
+
 int main() {
     // When run under CTest (or other runners), stdout is often fully buffered.
     // Disable buffering so we see the last test name before an AV.
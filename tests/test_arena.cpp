@@ -1,9 +1,13 @@
 #include "cell/arena.h"
+#include "cell/concurrent_arena.h"
+#include "cell/pool.h"
 
 #include <atomic>
 #include <cassert>
 #include <cstdio>
+#include <cstdint>
 #include <cstring>
+#include <thread>
 #include <vector>
 
 // Simple test helper
@@ -313,6 +317,285 @@ TEST(ArenaIntrospection) {
     printf("  PASSED\n");
 }
 
+// Test 12: Chunks grow geometrically past the cell threshold
+TEST(ArenaGeometricGrowth) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+
+    Cell::Context ctx(config);
+    Cell::Arena arena(ctx);
+
+    // A 2MB per-request arena: 128 cells before, a handful of chunks now
+    constexpr size_t kTotal = 2 * 1024 * 1024;
+    std::vector<char *> blocks;
+    for (size_t used = 0; used < kTotal; used += 1024) {
+        auto *p = static_cast<char *>(arena.alloc(1024));
+        assert(p != nullptr && "Allocation failed during growth");
+        std::memset(p, static_cast<int>(blocks.size() & 0x7F), 1024);
+        blocks.push_back(p);
+    }
+    size_t chunks = arena.cell_count();
+    printf("  2MB in %zu chunks (%zu bytes reserved)\n", chunks, arena.bytes_reserved());
+    assert(chunks <= 12 && "Chunks should grow geometrically");
+    assert(arena.bytes_reserved() >= kTotal && arena.bytes_reserved() < 3 * kTotal);
+
+    // Every block kept its contents, i.e. no two overlap
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        assert(blocks[i][0] == static_cast<char>(i & 0x7F));
+        assert(blocks[i][1023] == static_cast<char>(i & 0x7F));
+    }
+
+    // Refilling after reset reuses the same chunks in order
+    arena.reset();
+    for (size_t used = 0; used < kTotal; used += 1024) {
+        void *p = arena.alloc(1024);
+        assert(p != nullptr);
+        (void)p;
+    }
+    assert(arena.cell_count() == chunks && "Reset chunks should be reused");
+    (void)chunks;
+
+    printf("  PASSED\n");
+}
+
+// Test 13: Oversize allocations are freed by reset, release and markers
+TEST(ArenaOversizeTracking) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+
+    Cell::Context ctx(config);
+    Cell::Arena arena(ctx);
+#ifdef CELL_ENABLE_STATS
+    ctx.reset_stats();
+#endif
+
+    const size_t sizes[] = {20 * 1024, 100 * 1024, 512 * 1024, 3 * 1024 * 1024};
+    for (int round = 0; round < 3; ++round) {
+        (void)arena.alloc(64);
+        auto marker = arena.save();
+        for (size_t size : sizes) {
+            void *p = arena.alloc(size, 64);
+            assert(p != nullptr && reinterpret_cast<uintptr_t>(p) % 64 == 0);
+            std::memset(p, 0xEE, size);
+        }
+        arena.reset_to_marker(marker);
+        assert(arena.bytes_allocated() == 64);
+
+        for (size_t size : sizes) {
+            void *p = arena.alloc(size);
+            assert(p != nullptr);
+            std::memset(p, 0xEF, size);
+        }
+        if (round == 2) {
+            arena.release();
+        } else {
+            arena.reset();
+        }
+    }
+
+#ifdef CELL_ENABLE_STATS
+    // Every oversize block went back to the context
+    const Cell::MemoryStats &stats = ctx.get_stats();
+    assert(stats.buddy_allocs.load() == stats.buddy_frees.load());
+    assert(stats.large_allocs.load() == stats.large_frees.load());
+#endif
+
+    printf("  PASSED\n");
+}
+
+// Test 14: reset() keeps only retain_bytes of chunks
+TEST(ArenaRetainBytes) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    Cell::ArenaConfig arena_config;
+    arena_config.retain_bytes = 256 * 1024;
+    Cell::Arena arena(ctx, arena_config, 3);
+
+    for (size_t used = 0; used < 4 * 1024 * 1024; used += 4096) {
+        void *p = arena.alloc(4096);
+        assert(p != nullptr);
+        (void)p;
+    }
+    size_t peak = arena.bytes_reserved();
+    arena.reset();
+    printf("  Reserved %zu bytes at peak, %zu after reset\n", peak, arena.bytes_reserved());
+    assert(peak > arena_config.retain_bytes);
+    assert(arena.bytes_reserved() > 0 && arena.bytes_reserved() <= arena_config.retain_bytes);
+    (void)peak;
+
+    // Growth resumes from the retained footprint
+    for (size_t used = 0; used < 4 * 1024 * 1024; used += 4096) {
+        void *p = arena.alloc(4096);
+        assert(p != nullptr);
+        (void)p;
+    }
+    assert(arena.cell_count() <= 12);
+
+    // Only cells, never buddy chunks, when the threshold is never passed
+    Cell::ArenaConfig cells_only;
+    cells_only.cell_chunk_bytes = SIZE_MAX;
+    Cell::Arena small(ctx, cells_only);
+    for (int i = 0; i < 20; ++i) {
+        void *p = small.alloc(8 * 1024);
+        assert(p != nullptr);
+        (void)p;
+    }
+    assert(small.bytes_reserved() == small.cell_count() * Cell::kCellSize);
+
+    printf("  PASSED\n");
+}
+
+// =============================================================================
+// ConcurrentArena Tests
+// =============================================================================
+
+// Fills count blocks of varying size with a per-thread pattern and checks them back
+static bool fill_and_check(Cell::ConcurrentArena &arena, int thread, int count) {
+    std::vector<std::pair<unsigned char *, size_t>> blocks;
+    for (int i = 0; i < count; ++i) {
+        size_t size = 16 + static_cast<size_t>((i * 37 + thread) % 700);
+        auto *p = static_cast<unsigned char *>(arena.alloc(size, (i % 4 == 0) ? 64 : 8));
+        if (!p) {
+            return false;
+        }
+        std::memset(p, thread + 1, size);
+        blocks.push_back({p, size});
+    }
+    for (const auto &block : blocks) {
+        for (size_t i = 0; i < block.second; ++i) {
+            if (block.first[i] != static_cast<unsigned char>(thread + 1)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Test 15: Workers allocate from their own shards, reset once per frame
+TEST(ConcurrentArenaFrames) {
+    Cell::Config config;
+    config.reserve_size = 256 * 1024 * 1024;
+    Cell::Context ctx(config);
+    Cell::ConcurrentArena frame(ctx, 2);
+
+    constexpr int kWorkers = 16;
+    constexpr int kBlocks = 2000;
+    for (int round = 0; round < 4; ++round) {
+        std::atomic<int> failures{0};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < kWorkers; ++t) {
+            workers.emplace_back([&frame, &failures, t] {
+                if (!fill_and_check(frame, t, kBlocks)) {
+                    failures.fetch_add(1);
+                }
+            });
+        }
+        for (auto &worker : workers) {
+            worker.join();
+        }
+        assert(failures.load() == 0 && "Blocks overlapped or allocation failed");
+        assert(frame.bytes_allocated() > kWorkers * kBlocks * 16);
+
+        size_t reserved = frame.bytes_reserved();
+        frame.reset();
+        assert(frame.bytes_allocated() == 0);
+        assert(frame.bytes_reserved() == reserved && "Reset keeps chunks for the next frame");
+        (void)reserved;
+    }
+
+    frame.release();
+    assert(frame.bytes_reserved() == 0);
+    printf("  PASSED (%zu shards)\n", frame.shard_count());
+}
+
+// Test 16: Threads without a shard share the atomic bump chunk
+TEST(ConcurrentArenaSharedFallback) {
+    Cell::Config config;
+    config.reserve_size = 256 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    Cell::ConcurrentArenaConfig arena_config;
+    arena_config.shards = 1;
+    arena_config.shared_chunk_size = 64 * 1024;
+    Cell::ConcurrentArena frame(ctx, arena_config);
+    assert(frame.shard_count() == 1);
+
+    constexpr int kWorkers = 8;
+    for (int round = 0; round < 3; ++round) {
+        std::atomic<int> failures{0};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < kWorkers; ++t) {
+            workers.emplace_back([&frame, &failures, t] {
+                if (!fill_and_check(frame, t, 3000)) {
+                    failures.fetch_add(1);
+                }
+                // Oversize blocks from the shared path are freed by reset()
+                void *big = frame.alloc(200 * 1024, 128);
+                if (!big || reinterpret_cast<uintptr_t>(big) % 128 != 0) {
+                    failures.fetch_add(1);
+                } else {
+                    std::memset(big, 0x77, 200 * 1024);
+                }
+            });
+        }
+        for (auto &worker : workers) {
+            worker.join();
+        }
+        assert(failures.load() == 0);
+        frame.reset();
+    }
+
+    printf("  PASSED\n");
+}
+
+// Test 17: ArenaScope works on a worker's shard
+TEST(ConcurrentArenaLocalScope) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+    Cell::ConcurrentArena frame(ctx);
+
+    int *persistent = frame.alloc_array<int>(16);
+    assert(persistent != nullptr);
+    for (int i = 0; i < 16; ++i) {
+        persistent[i] = i;
+    }
+
+    Cell::Arena *local = frame.local_arena();
+    assert(local != nullptr && "The only thread always gets its shard");
+    size_t before = frame.bytes_allocated();
+    {
+        Cell::ArenaScope scope(*local);
+        for (int i = 0; i < 100; ++i) {
+            void *temp = local->alloc(1024);
+            assert(temp != nullptr);
+            std::memset(temp, 0xAB, 1024);
+        }
+        void *big = frame.alloc(64 * 1024);
+        assert(big != nullptr);
+        (void)big;
+    }
+    assert(frame.bytes_allocated() == before && "Scope should roll the shard back");
+    (void)before;
+    for (int i = 0; i < 16; ++i) {
+        assert(persistent[i] == i);
+    }
+
+    // Another thread maps to a different shard and gets its own
+    std::thread other([&frame, local] {
+        Cell::Arena *theirs = frame.local_arena();
+        assert(theirs != nullptr && theirs != local);
+        (void)theirs;
+        (void)local;
+    });
+    other.join();
+
+    frame.reset();
+    printf("  PASSED\n");
+}
+
 // =============================================================================
 // Main
 // =============================================================================
@@ -3,6 +3,7 @@
 #include <cassert>
 #include <cstdio>
 #include <cstring>
+#include <memory>
 #include <thread>
 #include <vector>
 
@@ -347,6 +348,234 @@ TEST(ReallocShrink) {
     printf("  PASSED\n");
 }
 
+// =============================================================================
+// Buddy Free Bitmap Tests
+// =============================================================================
+
+// Test 13: Interleaved frees across a fragmented free list still coalesce fully
+TEST(FragmentedFreeCoalesces) {
+    constexpr size_t superblocks = 4;
+    constexpr size_t region_size = superblocks * Cell::BuddyAllocator::kMaxBlockSize;
+    std::unique_ptr<char[]> region(new char[region_size]);
+    Cell::BuddyAllocator buddy(region.get(), region_size);
+
+    // 64KB blocks (48KB + header rounds to order 16): exactly fills every superblock
+    constexpr size_t per_superblock = Cell::BuddyAllocator::kMaxBlockSize / (64 * 1024);
+    std::vector<void *> blocks;
+    for (size_t i = 0; i < superblocks * per_superblock; ++i) {
+        void *p = buddy.alloc(48 * 1024);
+        assert(p != nullptr);
+        blocks.push_back(p);
+    }
+    assert(buddy.alloc(48 * 1024) == nullptr && "Region should be exhausted");
+
+    // Free evens first: none can merge, leaving a long free list at order 16
+    for (size_t i = 0; i < blocks.size(); i += 2) {
+        buddy.free(blocks[i]);
+    }
+    // Odds then merge all the way up to whole superblocks
+    for (size_t i = 1; i < blocks.size(); i += 2) {
+        buddy.free(blocks[i]);
+    }
+    assert(buddy.bytes_allocated() == 0);
+
+    const size_t max_user = Cell::BuddyAllocator::kMaxBlockSize - 64;
+    std::vector<void *> whole;
+    for (size_t i = 0; i < superblocks; ++i) {
+        void *p = buddy.alloc(max_user);
+        assert(p != nullptr && "Superblock did not coalesce back to 2MB");
+        whole.push_back(p);
+    }
+    assert(buddy.superblock_count() == superblocks);
+    for (void *p : whole) {
+        buddy.free(p);
+    }
+    printf("  PASSED\n");
+}
+
+// =============================================================================
+// Buddy TLS Cache Tests
+// =============================================================================
+
+// Test 14: A freed small buddy block is reused by the same thread without the lock
+TEST(BuddyTlsCacheReuse) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    void *first = ctx.alloc_bytes(100 * 1024, 0);
+    assert(first != nullptr);
+    std::memset(first, 0x33, 100 * 1024);
+    ctx.free_bytes(first);
+
+    // Same order (128KB block): served from the thread's cache, most recent first
+    void *second = ctx.alloc_bytes(90 * 1024, 0);
+    assert(second == first && "Thread should reuse its cached buddy block");
+    std::memset(second, 0x44, 90 * 1024);
+    ctx.free_bytes(second);
+
+    ctx.flush_tls_caches();
+    printf("  PASSED\n");
+}
+
+// Test 15: Blocks parked in thread caches coalesce again once the threads flush
+TEST(BuddyTlsCacheFlushCoalesces) {
+    Cell::Config config;
+    config.reserve_size = 16 * 1024 * 1024; // 8MB buddy region = 4 superblocks
+    Cell::Context ctx(config);
+
+    constexpr int num_threads = 4;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&ctx, t]() {
+            const size_t sizes[] = {40 * 1024, 60 * 1024, 120 * 1024, 200 * 1024};
+            for (int round = 0; round < 200; ++round) {
+                void *ptrs[4];
+                for (size_t i = 0; i < 4; ++i) {
+                    ptrs[i] = ctx.alloc_bytes(sizes[(i + t) % 4], 0);
+                    assert(ptrs[i] != nullptr);
+                    std::memset(ptrs[i], t, 1024);
+                }
+                for (void *p : ptrs) {
+                    assert(static_cast<unsigned char *>(p)[1023] == static_cast<unsigned char>(t));
+                    ctx.free_bytes(p);
+                }
+            }
+            ctx.flush_tls_caches();
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    // Every superblock must be whole again to satisfy four maximal requests
+    std::vector<void *> whole;
+    for (int i = 0; i < 4; ++i) {
+        void *p = ctx.alloc_bytes(Cell::BuddyAllocator::kMaxBlockSize - 64, 0);
+        assert(p != nullptr && "Flushed buddy blocks did not coalesce");
+        whole.push_back(p);
+    }
+    for (void *p : whole) {
+        ctx.free_bytes(p);
+    }
+    printf("  PASSED\n");
+}
+
+// =============================================================================
+// Reserved Large Allocation Tests
+// =============================================================================
+
+// Test 16: A reserved block grows through realloc_bytes without moving, even from below 2MB
+TEST(ReservedReallocGrowsInPlace) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    auto *p = static_cast<unsigned char *>(ctx.alloc_reserved(1024 * 1024, 512 * 1024 * 1024, 7));
+    assert(p != nullptr);
+    std::memset(p, 0x5C, 1024 * 1024);
+
+    for (size_t size = 2 * 1024 * 1024; size <= 512 * 1024 * 1024; size *= 2) {
+        void *grown = ctx.realloc_bytes(p, size, 7);
+        assert(grown == p && "Reserved block should grow in place");
+        p[size - 1] = 0x01;
+    }
+    assert(p[0] == 0x5C && p[1024 * 1024 - 1] == 0x5C);
+
+    ctx.free_bytes(p);
+    printf("  PASSED\n");
+}
+
+// Test 17: Wholly free buddy superblocks are released and recommitted on reuse
+TEST(BuddyDecommitRecommit) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    config.decay_ms = 0;
+    Cell::Context ctx(config);
+
+    size_t baseline = ctx.committed_bytes();
+
+    // 512KB requests take 1MB blocks, two per superblock
+    std::vector<void *> ptrs;
+    for (int i = 0; i < 8; ++i) {
+        void *p = ctx.alloc_bytes(512 * 1024);
+        assert(p != nullptr);
+        std::memset(p, 0x11 * (i + 1), 512 * 1024);
+        ptrs.push_back(p);
+    }
+    size_t peak = ctx.committed_bytes();
+    assert(peak >= baseline + 4 * Cell::BuddyAllocator::kMaxBlockSize);
+
+    for (void *p : ptrs) {
+        ctx.free_bytes(p);
+    }
+    size_t freed = ctx.decommit_unused();
+    assert(freed >= 4 * Cell::BuddyAllocator::kMaxBlockSize);
+    assert(ctx.committed_bytes() == peak - freed);
+
+    // Released superblocks come back before the region grows
+    ptrs.clear();
+    for (int i = 0; i < 8; ++i) {
+        auto *p = static_cast<unsigned char *>(ctx.alloc_bytes(512 * 1024));
+        assert(p != nullptr);
+        std::memset(p, 0x5A, 512 * 1024);
+        assert(p[0] == 0x5A && p[512 * 1024 - 1] == 0x5A);
+        ptrs.push_back(p);
+    }
+    assert(ctx.committed_bytes() == peak && "Reuse should recommit, not grow");
+
+    // With no decay configured, scavenge() releases them again right away
+    for (void *p : ptrs) {
+        ctx.free_bytes(p);
+    }
+    size_t scavenged = ctx.scavenge(1000000000);
+    printf("  Decommitted %zu bytes, scavenged %zu bytes\n", freed, scavenged);
+    assert(scavenged >= 4 * Cell::BuddyAllocator::kMaxBlockSize);
+    assert(ctx.committed_bytes() == peak - scavenged);
+
+    printf("  PASSED\n");
+}
+
+// Test 18: Requests a 2MB block cannot hold with its header go to the large tier
+TEST(BuddyMaxOrderBoundary) {
+    using Cell::BuddyAllocator;
+    static_assert(BuddyAllocator::kMaxAllocSize ==
+                      BuddyAllocator::kMaxBlockSize - BuddyAllocator::kHeaderSize,
+                  "Largest buddy request");
+    assert(BuddyAllocator::order_for_size(BuddyAllocator::kMaxAllocSize) ==
+           BuddyAllocator::kMaxOrder);
+    assert(BuddyAllocator::order_for_size(BuddyAllocator::kMaxAllocSize + 1) ==
+           BuddyAllocator::kMaxOrder + 1);
+
+    // Large enough for the buddy tier to exist
+    Cell::Config config;
+    config.reserve_size = 256 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    const size_t sizes[] = {BuddyAllocator::kMaxAllocSize, BuddyAllocator::kMaxAllocSize + 1,
+                            BuddyAllocator::kMaxBlockSize};
+    for (size_t size : sizes) {
+        void *p = ctx.alloc_bytes(size);
+        assert(p != nullptr && ctx.usable_size(p) >= size);
+        std::memset(p, 0x6B, size);
+        ctx.free_sized(p, size);
+
+        void *aligned = ctx.alloc_aligned(size, 16);
+        assert(aligned != nullptr && ctx.usable_size(aligned) >= size);
+        ctx.free_bytes(aligned);
+
+        // Growing a buddy block to the boundary leaves the tier when it has to
+        void *small = ctx.alloc_bytes(64 * 1024);
+        auto *grown = static_cast<unsigned char *>(ctx.realloc_bytes(small, size));
+        assert(grown != nullptr && ctx.usable_size(grown) >= size);
+        std::memset(grown, 0x6C, size);
+        assert(grown[size - 1] == 0x6C);
+        ctx.free_bytes(grown);
+    }
+
+    printf("  PASSED\n");
+}
+
 // =============================================================================
 // Main
 // =============================================================================
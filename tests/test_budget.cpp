@@ -1,7 +1,10 @@
 #include "cell/context.h"
 
+#include <atomic>
 #include <cassert>
 #include <cstdio>
+#include <thread>
+#include <utility>
 #include <vector>
 
 // Simple test helper
@@ -89,10 +92,11 @@ TEST(BudgetCallback) {
     void *p2 = ctx.alloc_bytes(200);
     assert(p2 == nullptr && "Allocation should fail");
     assert(g_callback_invoked && "Callback should be invoked");
-    // Note: callback receives the ROUNDED/BUDGET size (256 for size class containing 200),
+    // Note: callback receives the ROUNDED/BUDGET size (224 for size class containing 200),
     // not the original requested size. This ensures consistent budget enforcement
     // where check and record use the same size.
-    assert(g_callback_requested == 256 && "Callback should receive rounded budget size");
+    assert(g_callback_requested == Cell::kSizeClasses[Cell::get_size_class_fast(200)] &&
+           "Callback should receive rounded budget size");
     assert(g_callback_budget == 512 && "Callback should receive budget");
 
     printf("  Callback: requested=%zu, budget=%zu, current=%zu\n", g_callback_requested,
@@ -186,6 +190,173 @@ TEST(BudgetRuntimeChange) {
     printf("  PASSED\n");
 }
 
+// =============================================================================
+// Thread Leases
+// =============================================================================
+
+// Test 6: Leased bytes are not reported as usage, through single and batch paths
+TEST(BudgetLeaseAccounting) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config); // Unlimited: still tracked
+
+    std::vector<void *> ptrs;
+    for (size_t i = 0; i < 1000; ++i) {
+        ptrs.push_back(ctx.alloc_bytes(64));
+    }
+    assert(ctx.get_budget_current() == 1000 * 64);
+
+    void *batch[100];
+    size_t got = ctx.alloc_batch(128, batch, 100);
+    assert(got == 100);
+    assert(ctx.get_budget_current() == 1000 * 64 + 100 * 128);
+
+    ctx.free_batch(batch, got);
+    ctx.free_batch(ptrs.data(), 500);
+    for (size_t i = 500; i < ptrs.size(); ++i) {
+        ctx.free_sized(ptrs[i], 64);
+    }
+    assert(ctx.get_budget_current() == 0);
+
+    printf("  PASSED\n");
+}
+
+// Test 7: Threads allocating against one budget never exceed it together
+TEST(BudgetThreadsHardLimit) {
+    constexpr size_t kBudget = 1024 * 1024;
+    constexpr size_t kThreads = 4;
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    config.memory_budget = kBudget;
+    Cell::Context ctx(config);
+
+    std::vector<void *> blocks[kThreads];
+    std::atomic<size_t> outstanding{kThreads};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            while (void *ptr = ctx.alloc_bytes(64)) {
+                blocks[t].push_back(ptr);
+            }
+            // Stay alive, lease and all, until every thread has hit the limit
+            outstanding.fetch_sub(1);
+            while (outstanding.load() != 0) {
+                std::this_thread::yield();
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    size_t total = 0;
+    for (const auto &list : blocks) {
+        total += list.size() * 64;
+    }
+    printf("  %zu of %zu bytes allocated\n", total, kBudget);
+    assert(total <= kBudget);
+    assert(total + kThreads * Cell::kBudgetLeaseMaxBytes >= kBudget);
+    assert(ctx.get_budget_current() == total);
+
+    // Freed here, after their threads are gone
+    for (auto &list : blocks) {
+        ctx.free_batch(list.data(), list.size());
+    }
+    assert(ctx.get_budget_current() == 0);
+
+    printf("  PASSED\n");
+}
+
+// Test 8: An exiting thread hands its unspent lease back
+TEST(BudgetLeaseReturnedOnExit) {
+    constexpr size_t kBudget = 256 * 1024;
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    config.memory_budget = kBudget;
+    Cell::Context ctx(config);
+
+    std::thread([&] { ctx.free_bytes(ctx.alloc_bytes(64)); }).join();
+    assert(ctx.get_budget_current() == 0);
+
+    // The whole budget is available to this thread again
+    std::vector<void *> ptrs;
+    while (void *ptr = ctx.alloc_bytes(64)) {
+        ptrs.push_back(ptr);
+    }
+    assert(ptrs.size() == kBudget / 64);
+    ctx.free_batch(ptrs.data(), ptrs.size());
+
+    printf("  PASSED\n");
+}
+
+// Test 9: Large, aligned and growing allocations reserve their budget before mapping
+TEST(BudgetLargeThreadsHardLimit) {
+    constexpr size_t kBlock = 3 * 1024 * 1024; // Past the buddy tier
+    constexpr size_t kBudget = 5 * kBlock;
+    constexpr size_t kThreads = 8;
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    config.memory_budget = kBudget;
+    Cell::Context ctx(config);
+
+    std::atomic<size_t> live{0};
+    std::atomic<size_t> peak{0};
+    std::atomic<bool> over{false};
+    std::atomic<size_t> ready{0};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            ready.fetch_add(1);
+            while (ready.load() != kThreads) {
+                std::this_thread::yield();
+            }
+            // Each thread holds two blocks, so together they ask for several budgets
+            std::pair<void *, size_t> held[2] = {};
+            for (size_t i = 0; i < 2000; ++i) {
+                auto &[ptr, size] = held[i % 2];
+                if (ptr) {
+                    live.fetch_sub(size);
+                    ctx.free_bytes(ptr);
+                }
+                size = kBlock;
+                ptr = (i + t) % 2 ? ctx.alloc_large(size) : ctx.alloc_aligned(size, 8192);
+                if (!ptr) {
+                    continue;
+                }
+                if (i % 3 == 0) {
+                    if (void *grown = ctx.realloc_bytes(ptr, size + kBlock / 2)) {
+                        ptr = grown;
+                        size += kBlock / 2;
+                    }
+                }
+                size_t now = live.fetch_add(size) + size;
+                size_t seen = peak.load();
+                while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+                }
+                if (ctx.get_budget_current() > kBudget) {
+                    over.store(true);
+                }
+            }
+            for (auto &[ptr, size] : held) {
+                if (ptr) {
+                    live.fetch_sub(size);
+                    ctx.free_bytes(ptr);
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    printf("  Peak %zu of %zu bytes live\n", peak.load(), kBudget);
+    assert(!over.load());
+    assert(peak.load() <= kBudget);
+    assert(ctx.get_budget_current() == 0);
+
+    printf("  PASSED\n");
+}
+
 #else
 
 // When budget is disabled, just report that
@@ -0,0 +1,251 @@
+/**
+ * @file test_hardened.cpp
+ * @brief Tests for CELL_HARDENED: encoded free lists, double-free and write-after-free checks.
+ */
+
+#include "cell/context.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#define CELL_TEST_CAN_FORK 1
+#endif
+
+// Simple test helper
+#define TEST(name)                                                                                 \
+    void test_##name();                                                                            \
+    struct Register##name {                                                                        \
+        Register##name() { tests.push_back({#name, test_##name}); }                                \
+    } reg_##name;                                                                                  \
+    void test_##name()
+
+struct TestCase {
+    const char *name;
+    void (*fn)();
+};
+std::vector<TestCase> tests;
+
+// =============================================================================
+// Hardening Tests (only run when CELL_HARDENED is defined)
+// =============================================================================
+
+#ifdef CELL_HARDENED
+
+static Cell::Config small_config() {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    return config;
+}
+
+#ifdef CELL_TEST_CAN_FORK
+/** @brief Runs body in a child process and checks that a hardening check aborted it. */
+static void expect_abort(void (*body)()) {
+    std::fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        body();
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    assert(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT);
+}
+#endif
+
+// Test 1: Ordinary use through every sub-cell path trips no check
+TEST(HardenedOrdinaryUse) {
+    Cell::Context ctx(small_config());
+
+    std::vector<void *> live;
+    for (size_t i = 0; i < 20000; ++i) {
+        live.push_back(ctx.alloc_bytes(16 + (i * 37) % 8000));
+        if (live.size() == 64) {
+            for (size_t j = 0; j < live.size(); j += 2) {
+                ctx.free_bytes(live[j]);
+            }
+            for (size_t j = 1; j < live.size(); j += 2) {
+                ctx.free_sized(live[j], 16 + ((i - 63 + j) * 37) % 8000);
+            }
+            live.clear();
+        }
+    }
+    for (void *ptr : live) {
+        ctx.free_bytes(ptr);
+    }
+
+    void *batch[300];
+    size_t got = ctx.alloc_batch(48, batch, 300);
+    assert(got == 300);
+    ctx.free_batch(batch, got);
+    void *run = ctx.alloc_contiguous(64, 20);
+    assert(run != nullptr);
+    for (size_t i = 0; i < 20; ++i) {
+        ctx.free_bytes(static_cast<char *>(run) + i * 64);
+    }
+
+    // Cross-thread frees go through the owner's remote queue and come back
+    std::vector<void *> foreign(1000);
+    for (void *&ptr : foreign) {
+        ptr = ctx.alloc_bytes(128);
+    }
+    std::thread([&] {
+        for (void *ptr : foreign) {
+            ctx.free_bytes(ptr);
+        }
+    }).join();
+    for (void *&ptr : foreign) {
+        ptr = ctx.alloc_bytes(128);
+    }
+    ctx.free_batch(foreign.data(), foreign.size());
+    ctx.flush_tls_caches();
+
+    printf("  PASSED\n");
+}
+
+// Test 2: Links stored in freed blocks are not plain pointers
+TEST(HardenedEncodedLinks) {
+    Cell::Context ctx(small_config());
+
+    void *a = ctx.alloc_bytes(64);
+    void *b = ctx.alloc_bytes(64);
+    ctx.free_bytes(a);
+    ctx.free_bytes(b);
+    ctx.flush_tls_caches(); // Both now sit on their cell's free list
+
+    uintptr_t raw_a;
+    uintptr_t raw_b;
+    std::memcpy(&raw_a, a, sizeof(raw_a));
+    std::memcpy(&raw_b, b, sizeof(raw_b));
+    assert(raw_a != 0 && raw_a != reinterpret_cast<uintptr_t>(b));
+    assert(raw_b != 0 && raw_b != reinterpret_cast<uintptr_t>(a));
+    (void)raw_a;
+    (void)raw_b;
+
+    printf("  PASSED\n");
+}
+
+#ifdef CELL_TEST_CAN_FORK
+// Test 3: Freeing a block twice aborts, whichever free path sees the second free
+TEST(HardenedDoubleFree) {
+    expect_abort([] {
+        Cell::Context ctx(small_config());
+        void *ptr = ctx.alloc_bytes(64);
+        ctx.free_bytes(ptr);
+        ctx.free_bytes(ptr);
+    });
+    expect_abort([] {
+        Cell::Context ctx(small_config());
+        void *ptr = ctx.alloc_bytes(100);
+        ctx.free_sized(ptr, 100);
+        ctx.free_sized(ptr, 100);
+    });
+    expect_abort([] {
+        Cell::Context ctx(small_config());
+        void *ptrs[2] = {ctx.alloc_bytes(32), nullptr};
+        ptrs[1] = ptrs[0];
+        ctx.free_batch(ptrs, 2);
+    });
+    expect_abort([] {
+        // The second free comes from another thread, through the remote queue
+        Cell::Context ctx(small_config());
+        void *ptr = ctx.alloc_bytes(64);
+        ctx.free_bytes(ptr);
+        std::thread([&] { ctx.free_bytes(ptr); }).join();
+    });
+
+    printf("  PASSED\n");
+}
+
+// Test 4: A pointer into the middle of a block is refused
+TEST(HardenedInteriorPointer) {
+    expect_abort([] {
+        Cell::Context ctx(small_config());
+        auto *ptr = static_cast<char *>(ctx.alloc_bytes(64));
+        ctx.free_bytes(ptr + 16);
+    });
+
+    printf("  PASSED\n");
+}
+#endif
+
+// With guard bytes the free-list words lie in the front guard, out of these writes' reach
+#if defined(CELL_TEST_CAN_FORK) && !defined(CELL_DEBUG_GUARDS)
+// Test 5: A block written after it was freed is caught before it is reused
+TEST(HardenedWriteAfterFree) {
+    expect_abort([] {
+        // Cached by the thread; found when the cache is handed back
+        Cell::Context ctx(small_config());
+        auto *ptr = static_cast<uint64_t *>(ctx.alloc_bytes(64));
+        ctx.free_bytes(ptr);
+        ptr[1] = 0x4141414141414141ULL;
+        ctx.flush_tls_caches();
+    });
+    expect_abort([] {
+        // On its cell's free list; found when the list hands it out. The cell
+        // keeps another block so that it is not reset to bump allocation.
+        Cell::Context ctx(small_config());
+        auto *ptr = static_cast<uint64_t *>(ctx.alloc_bytes(256));
+        void *keep = ctx.alloc_bytes(256);
+        (void)keep;
+        ctx.free_bytes(ptr);
+        ctx.flush_tls_caches();
+        ptr[0] = 0x4141414141414141ULL;
+        for (size_t i = 0; i < 256; ++i) {
+            void *block = ctx.alloc_bytes(256);
+            (void)block;
+        }
+    });
+
+    printf("  PASSED\n");
+}
+#endif
+
+#else
+
+// When hardening is disabled, just report that
+TEST(HardenedDisabled) {
+    printf("  CELL_HARDENED not defined, hardening tests skipped\n");
+    printf("  PASSED\n");
+}
+
+#endif
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    printf("Heap Hardening Tests\n");
+    printf("====================\n");
+#ifdef CELL_HARDENED
+    printf("CELL_HARDENED: ENABLED\n");
+#else
+    printf("CELL_HARDENED: DISABLED\n");
+#endif
+    printf("\n");
+
+    int passed = 0;
+    int failed = 0;
+
+    for (const auto &test : tests) {
+        printf("Running %s...\n", test.name);
+        try {
+            test.fn();
+            ++passed;
+        } catch (...) {
+            printf("  FAILED (exception)\n");
+            ++failed;
+        }
+    }
+
+    printf("\n");
+    printf("Results: %d passed, %d failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,300 @@
+/**
+ * @file test_heap_profile.cpp
+ * @brief Tests for the sampling heap profiler (CELL_ENABLE_HEAP_PROFILE).
+ */
+
+#include "cell/context.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Simple test helper
+#define TEST(name)                                                                                 \
+    void test_##name();                                                                            \
+    struct Register##name {                                                                        \
+        Register##name() { tests.push_back({#name, test_##name}); }                                \
+    } reg_##name;                                                                                  \
+    void test_##name()
+
+struct TestCase {
+    const char *name;
+    void (*fn)();
+};
+std::vector<TestCase> tests;
+
+// =============================================================================
+// Heap Profile Tests (only run when CELL_ENABLE_HEAP_PROFILE is defined)
+// =============================================================================
+
+#ifdef CELL_ENABLE_HEAP_PROFILE
+
+/** @brief Parsed dump_heap_profile() output. */
+struct Profile {
+    unsigned long long live_count = 0;
+    unsigned long long live_bytes = 0;
+    unsigned long long total_count = 0;
+    unsigned long long total_bytes = 0;
+    size_t period = 0;
+    size_t stacks = 0;           ///< Sample lines.
+    double estimated_bytes = 0;  ///< Live bytes scaled back up the way pprof does.
+    bool has_maps = false;       ///< MAPPED_LIBRARIES section present.
+};
+
+static Profile read_profile(const Cell::Context &ctx) {
+    std::FILE *file = std::tmpfile();
+    assert(file != nullptr);
+    bool written = ctx.dump_heap_profile(file);
+    assert(written);
+    (void)written;
+    std::rewind(file);
+
+    Profile profile;
+    char line[1024];
+    bool header = std::fgets(line, sizeof(line), file) != nullptr;
+    assert(header);
+    (void)header;
+    int fields = std::sscanf(line, "heap profile: %llu: %llu [%llu: %llu] @ heap_v2/%zu",
+                             &profile.live_count, &profile.live_bytes, &profile.total_count,
+                             &profile.total_bytes, &profile.period);
+    assert(fields == 5);
+    (void)fields;
+
+    while (std::fgets(line, sizeof(line), file)) {
+        unsigned long long count, bytes, total_count, total_bytes;
+        if (std::sscanf(line, "%llu: %llu [%llu: %llu] @", &count, &bytes, &total_count,
+                        &total_bytes) == 4) {
+            ++profile.stacks;
+            if (count > 0) {
+                double mean = static_cast<double>(bytes) / static_cast<double>(count);
+                double scale = 1.0 / (1.0 - std::exp(-mean / static_cast<double>(profile.period)));
+                profile.estimated_bytes += static_cast<double>(bytes) * scale;
+            }
+        } else if (std::strncmp(line, "MAPPED_LIBRARIES:", 17) == 0) {
+            profile.has_maps = true;
+        }
+    }
+    std::fclose(file);
+    return profile;
+}
+
+static Cell::Config profile_config(size_t sample_bytes) {
+    Cell::Config config;
+    config.reserve_size = 256 * 1024 * 1024;
+    config.heap_profile_sample_bytes = sample_bytes;
+    return config;
+}
+
+// Test 1: About one allocation per sampling interval is sampled, and scales back up
+TEST(HeapProfileSampling) {
+    Cell::Context ctx(profile_config(64 * 1024));
+
+    std::vector<void *> live;
+    for (int i = 0; i < 32 * 1024; ++i) {
+        live.push_back(ctx.alloc_bytes(1024));
+    }
+
+    // 32MB live: ~500 samples expected
+    Profile profile = read_profile(ctx);
+    printf("  %llu samples (%llu KB), estimated %.1f MB live\n", profile.live_count,
+           profile.live_bytes / 1024, profile.estimated_bytes / (1024 * 1024));
+    assert(profile.period == 64 * 1024);
+    assert(profile.live_count > 250 && profile.live_count < 1000);
+    assert(profile.live_bytes == profile.live_count * 1024);
+    assert(profile.estimated_bytes > 24.0 * 1024 * 1024);
+    assert(profile.estimated_bytes < 40.0 * 1024 * 1024);
+#if defined(__linux__)
+    assert(profile.has_maps);
+#endif
+
+    ctx.free_batch(live.data(), live.size());
+    printf("  PASSED\n");
+}
+
+// Test 2: Freed samples leave the live profile and stay in the totals
+TEST(HeapProfileFree) {
+    Cell::Context ctx(profile_config(16 * 1024));
+
+    std::vector<void *> small;
+    std::vector<void *> buddy;
+    std::vector<void *> large;
+    for (int i = 0; i < 4096; ++i) {
+        small.push_back(ctx.alloc_bytes(256));
+    }
+    for (int i = 0; i < 64; ++i) {
+        buddy.push_back(ctx.alloc_bytes(64 * 1024));
+    }
+    for (int i = 0; i < 4; ++i) {
+        large.push_back(ctx.alloc_bytes(3 * 1024 * 1024 + 100));
+    }
+
+    Profile before = read_profile(ctx);
+    printf("  %llu live samples\n", before.live_count);
+    assert(before.live_count > 0);
+    assert(before.live_count == before.total_count);
+    (void)before;
+
+    // Every release path: sized frees, free_batch, free_bytes
+    for (void *ptr : small) {
+        ctx.free_sized(ptr, 256);
+    }
+    ctx.free_batch(buddy.data(), buddy.size());
+    for (void *ptr : large) {
+        ctx.free_bytes(ptr);
+    }
+
+    Profile after = read_profile(ctx);
+    assert(after.live_count == 0 && after.live_bytes == 0);
+    assert(after.total_count == before.total_count);
+    (void)after;
+
+    printf("  PASSED\n");
+}
+
+// Test 3: Reallocated blocks are sampled at their new size and address
+TEST(HeapProfileRealloc) {
+    Cell::Context ctx(profile_config(8 * 1024));
+
+    std::vector<void *> blocks;
+    for (int i = 0; i < 2048; ++i) {
+        blocks.push_back(ctx.alloc_bytes(100));
+    }
+    for (void *&ptr : blocks) {
+        ptr = ctx.realloc_bytes(ptr, 3000);
+        assert(ptr != nullptr);
+    }
+
+    Profile grown = read_profile(ctx);
+    printf("  %llu live samples after growing\n", grown.live_count);
+    assert(grown.live_count > 0);
+    assert(grown.live_bytes == grown.live_count * 3000);
+    (void)grown;
+
+    for (void *ptr : blocks) {
+        ctx.free_bytes(ptr);
+    }
+    assert(read_profile(ctx).live_count == 0);
+
+    printf("  PASSED\n");
+}
+
+[[gnu::noinline]] static void *alloc_at_first_site(Cell::Context &ctx) {
+    return ctx.alloc_bytes(2048);
+}
+
+[[gnu::noinline]] static void *alloc_at_second_site(Cell::Context &ctx) {
+    return ctx.alloc_bytes(2048);
+}
+
+// Test 4: Samples are grouped by allocating call stack
+TEST(HeapProfileStacks) {
+    Cell::Context ctx(profile_config(16 * 1024));
+
+    std::vector<void *> live;
+    for (int i = 0; i < 2048; ++i) {
+        live.push_back(alloc_at_first_site(ctx));
+        live.push_back(alloc_at_second_site(ctx));
+    }
+
+    Profile profile = read_profile(ctx);
+    printf("  %zu stacks for %llu samples\n", profile.stacks, profile.live_count);
+    assert(profile.stacks >= 2);
+    assert(profile.stacks < profile.live_count);
+
+    ctx.free_batch(live.data(), live.size());
+    printf("  PASSED\n");
+}
+
+// Test 5: Blocks allocated on several threads and freed on another leave no samples
+TEST(HeapProfileThreads) {
+    Cell::Context ctx(profile_config(32 * 1024));
+
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 8192;
+    std::vector<std::vector<void *>> blocks(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&ctx, &blocks, t] {
+            for (int i = 0; i < kPerThread; ++i) {
+                blocks[t].push_back(ctx.alloc_bytes(64 + static_cast<size_t>(i % 8) * 64));
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    Profile profile = read_profile(ctx);
+    printf("  %llu live samples from %d threads\n", profile.live_count, kThreads);
+    assert(profile.live_count > 0);
+    (void)profile;
+
+    for (std::vector<void *> &list : blocks) {
+        for (void *ptr : list) {
+            ctx.free_bytes(ptr);
+        }
+    }
+    assert(read_profile(ctx).live_count == 0);
+
+    printf("  PASSED\n");
+}
+
+// Test 6: A sample interval of 0 turns the profiler off
+TEST(HeapProfileOff) {
+    Cell::Context ctx(profile_config(0));
+    void *ptr = ctx.alloc_bytes(1024 * 1024);
+    assert(ptr != nullptr);
+    ctx.free_bytes(ptr);
+
+    std::FILE *file = std::tmpfile();
+    assert(!ctx.dump_heap_profile(file));
+    std::fclose(file);
+
+    printf("  PASSED\n");
+}
+
+#else
+
+// When profiling is disabled, just report that
+TEST(HeapProfileDisabled) {
+    printf("  CELL_ENABLE_HEAP_PROFILE not defined, heap profile tests skipped\n");
+    printf("  PASSED\n");
+}
+
+#endif
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    printf("Heap Profile Tests\n");
+    printf("==================\n");
+#ifdef CELL_ENABLE_HEAP_PROFILE
+    printf("CELL_ENABLE_HEAP_PROFILE: ENABLED\n");
+#else
+    printf("CELL_ENABLE_HEAP_PROFILE: DISABLED\n");
+#endif
+    printf("\n");
+
+    int passed = 0;
+    int failed = 0;
+
+    for (const auto &test : tests) {
+        printf("Running %s...\n", test.name);
+        try {
+            test.fn();
+            ++passed;
+        } catch (...) {
+            printf("  FAILED (exception)\n");
+            ++failed;
+        }
+    }
+
+    printf("\n");
+    printf("Results: %d passed, %d failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}
@@ -4,6 +4,8 @@
 #include <cassert>
 #include <cstdio>
 #include <cstring>
+#include <thread>
+#include <unordered_set>
 #include <vector>
 
 // Simple test helper
@@ -44,7 +46,7 @@ TEST(ReallocGrowth) {
     auto *new_ptr = static_cast<uint8_t *>(registry.realloc_bytes(ptr, new_size, 42));
     assert(new_ptr != nullptr);
     assert(registry.owns(new_ptr));
-    assert(!registry.owns(ptr)); // Old pointer should be freed
+    assert(new_ptr == ptr || !registry.owns(ptr)); // Moved blocks drop the old pointer
 
     // Verify data was preserved
     for (size_t i = 0; i < old_size; ++i) {
@@ -197,6 +199,372 @@ TEST(ReallocAlignedAlloc) {
     printf("  PASSED\n");
 }
 
+// =============================================================================
+// Lookup and Reuse Cache Tests
+// =============================================================================
+
+TEST(FreedMappingIsReused) {
+    Cell::LargeAllocRegistry registry;
+
+    const size_t size = 4 * 1024 * 1024; // 4MB
+
+    void *ptr = registry.alloc(size, 1);
+    assert(ptr != nullptr);
+    std::memset(ptr, 0x5A, size);
+    registry.free(ptr);
+    assert(!registry.owns(ptr));
+    assert(registry.cached_bytes() >= size);
+
+    // Same size class comes straight back from the cache
+    void *again = registry.alloc(size, 2);
+    assert(again == ptr);
+    assert(registry.owns(again));
+    assert(registry.get_alloc_size(again) == size);
+    assert(registry.cached_bytes() == 0);
+
+    registry.free(again);
+    printf("  PASSED\n");
+}
+
+TEST(NearbySizesShareMappings) {
+    Cell::LargeAllocRegistry registry;
+
+    // 3.1MB and 3.4MB both round to the 3.5MB class
+    void *ptr = registry.alloc(3100 * 1024, 0);
+    assert(ptr != nullptr);
+    registry.free(ptr);
+
+    void *again = registry.alloc(3400 * 1024, 0);
+    assert(again == ptr);
+    assert(registry.get_alloc_size(again) == 3400 * 1024);
+    std::memset(again, 0xC3, 3400 * 1024);
+
+    registry.free(again);
+    printf("  PASSED\n");
+}
+
+TEST(CacheRespectsByteCap) {
+    Cell::LargeAllocRegistry registry;
+
+    const size_t size = 48 * 1024 * 1024; // 48MB (never touched, stays uncommitted)
+    void *ptrs[6];
+    for (auto &p : ptrs) {
+        p = registry.alloc(size, 0, false);
+        assert(p != nullptr);
+    }
+    for (auto &p : ptrs) {
+        registry.free(p);
+        assert(registry.cached_bytes() <= Cell::LargeAllocRegistry::kCacheMaxBytes);
+    }
+    assert(registry.cached_bytes() > 0);
+
+    // Oversized mappings bypass the cache entirely
+    void *huge = registry.alloc(Cell::LargeAllocRegistry::kCacheMaxBlockSize * 2, 0, false);
+    assert(huge != nullptr);
+    size_t before = registry.cached_bytes();
+    registry.free(huge);
+    assert(registry.cached_bytes() == before);
+
+    printf("  PASSED (cached %zuMB)\n", registry.cached_bytes() / (1024 * 1024));
+}
+
+TEST(UnusedMappingsAgeOut) {
+    Cell::LargeAllocRegistry registry;
+
+    const size_t stale_size = 8 * 1024 * 1024;   // 8MB
+    const size_t churn_size = 3 * 1024 * 1024;   // 3MB
+
+    void *stale = registry.alloc(stale_size, 0);
+    assert(stale != nullptr);
+    registry.free(stale);
+    assert(registry.cached_bytes() == stale_size);
+
+    // Only the 3MB class is ever asked for again; the 8MB mapping must be released
+    for (uint64_t i = 0; i <= Cell::LargeAllocRegistry::kCacheMaxAge; ++i) {
+        void *p = registry.alloc(churn_size, 0);
+        assert(p != nullptr);
+        registry.free(p);
+    }
+    assert(registry.cached_bytes() == churn_size);
+
+    assert(registry.trim_cache() == churn_size);
+    assert(registry.cached_bytes() == 0);
+    printf("  PASSED\n");
+}
+
+TEST(ManyLiveAllocations) {
+    Cell::LargeAllocRegistry registry;
+
+    // Enough entries to force probing past collisions and tombstones
+    const size_t count = 256;
+    const size_t size = 3 * 1024 * 1024;
+    std::vector<void *> ptrs(count);
+    for (size_t round = 0; round < 3; ++round) {
+        for (size_t i = 0; i < count; ++i) {
+            ptrs[i] = registry.alloc(size + i * 4096, static_cast<uint8_t>(i), false);
+            assert(ptrs[i] != nullptr);
+        }
+        assert(registry.allocation_count() == count);
+        for (size_t i = 0; i < count; ++i) {
+            assert(registry.owns(ptrs[i]));
+            assert(registry.get_alloc_size(ptrs[i]) == size + i * 4096);
+        }
+        // Free every other one first so lookups must skip tombstones
+        for (size_t i = 0; i < count; i += 2) {
+            registry.free(ptrs[i]);
+        }
+        for (size_t i = 1; i < count; i += 2) {
+            assert(registry.owns(ptrs[i]));
+            registry.free(ptrs[i]);
+        }
+        assert(registry.allocation_count() == 0);
+        assert(registry.bytes_allocated() == 0);
+    }
+    printf("  PASSED\n");
+}
+
+TEST(ConcurrentAllocFree) {
+    Cell::LargeAllocRegistry registry;
+
+    const int num_threads = 4;
+    const int iterations = 200;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&registry, t]() {
+            const size_t size = (3 + static_cast<size_t>(t)) * 1024 * 1024;
+            for (int i = 0; i < iterations; ++i) {
+                auto *p = static_cast<uint8_t *>(registry.alloc(size, static_cast<uint8_t>(t)));
+                assert(p != nullptr);
+                p[0] = static_cast<uint8_t>(t);
+                p[size - 1] = static_cast<uint8_t>(i);
+                assert(registry.owns(p));
+                assert(registry.get_alloc_size(p) == size);
+                registry.free(p);
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+
+    assert(registry.allocation_count() == 0);
+    assert(registry.cached_bytes() <= Cell::LargeAllocRegistry::kCacheMaxBytes);
+    printf("  PASSED\n");
+}
+
+// =============================================================================
+// Remap and Reservation Tests
+// =============================================================================
+
+static void fill_pages(uint8_t *ptr, size_t size, uint8_t seed) {
+    for (size_t offset = 0; offset < size; offset += 4096) {
+        ptr[offset] = static_cast<uint8_t>(seed + offset / 4096);
+    }
+}
+
+static bool check_pages(const uint8_t *ptr, size_t size, uint8_t seed) {
+    for (size_t offset = 0; offset < size; offset += 4096) {
+        if (ptr[offset] != static_cast<uint8_t>(seed + offset / 4096)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(ReallocRemapGrowAndShrink) {
+    Cell::LargeAllocRegistry registry;
+
+    const size_t initial = 4 * 1024 * 1024;
+    size_t size = initial;
+    auto *ptr = static_cast<uint8_t *>(registry.alloc(size, 3, false));
+    assert(ptr != nullptr);
+    fill_pages(ptr, initial, 11);
+
+    // Grow 4MB -> 256MB in doublings; every step keeps the earlier pages
+    for (size_t next = size * 2; next <= 256 * 1024 * 1024; next *= 2) {
+        ptr = static_cast<uint8_t *>(registry.realloc_bytes(ptr, next, 3));
+        assert(ptr != nullptr);
+        assert(registry.get_alloc_size(ptr) == next);
+        assert(check_pages(ptr, initial, 11));
+        ptr[next - 1] = 0xEE;
+        size = next;
+    }
+    assert(registry.allocation_count() == 1);
+    assert(registry.bytes_allocated() == size);
+
+    // Shrink back down
+    ptr = static_cast<uint8_t *>(registry.realloc_bytes(ptr, 6 * 1024 * 1024, 3));
+    assert(ptr != nullptr);
+    assert(check_pages(ptr, initial, 11));
+    assert(registry.bytes_allocated() == 6 * 1024 * 1024);
+
+    registry.free(ptr);
+    assert(registry.allocation_count() == 0);
+    printf("  PASSED\n");
+}
+
+TEST(ReservedBlockGrowsInPlace) {
+    Cell::LargeAllocRegistry registry;
+
+    const size_t initial = 4 * 1024 * 1024;
+    const size_t reserve = 256 * 1024 * 1024;
+    auto *ptr = static_cast<uint8_t *>(registry.alloc_reserved(initial, reserve, 9));
+    assert(ptr != nullptr);
+    assert(registry.get_alloc_size(ptr) == initial);
+    assert(registry.get_capacity(ptr) >= reserve);
+    fill_pages(ptr, initial, 5);
+
+    // Every growth inside the reservation keeps the address
+    for (size_t size = initial * 2; size <= reserve; size *= 2) {
+        void *grown = registry.realloc_bytes(ptr, size, 9);
+        assert(grown == ptr);
+        ptr[size - 1] = 0x77;
+    }
+    assert(check_pages(ptr, initial, 5));
+
+    // Shrinking keeps the reservation too
+    assert(registry.realloc_bytes(ptr, 8 * 1024 * 1024, 9) == ptr);
+    assert(registry.get_alloc_size(ptr) == 8 * 1024 * 1024);
+
+    // Past the reservation the block may move, but the data comes along
+    auto *moved = static_cast<uint8_t *>(registry.realloc_bytes(ptr, reserve * 2, 9));
+    assert(moved != nullptr);
+    assert(check_pages(moved, initial, 5));
+    assert(registry.owns(moved));
+
+    registry.free(moved);
+    assert(registry.allocation_count() == 0);
+    assert(registry.bytes_allocated() == 0);
+    printf("  PASSED\n");
+}
+
+TEST(ReservedBlockFreedUncommitted) {
+    Cell::LargeAllocRegistry registry;
+
+    // A partially committed reservation is unmapped, never handed to a plain alloc()
+    void *ptr = registry.alloc_reserved(3 * 1024 * 1024, 64 * 1024 * 1024, 0);
+    assert(ptr != nullptr);
+    registry.free(ptr);
+    assert(registry.cached_bytes() == 0);
+
+    // Reserve smaller than size is clamped up
+    auto *small = static_cast<uint8_t *>(registry.alloc_reserved(5 * 1024 * 1024, 0, 0));
+    assert(small != nullptr);
+    assert(registry.get_capacity(small) >= 5 * 1024 * 1024);
+    std::memset(small, 0x42, 5 * 1024 * 1024);
+    registry.free(small);
+    printf("  PASSED\n");
+}
+
+TEST(CommittedBytesTracksBlocks) {
+    Cell::LargeAllocRegistry registry;
+    const size_t mb = 1024 * 1024;
+
+    // Reservations count only their committed prefix
+    void *reserved = registry.alloc_reserved(3 * mb, 64 * mb, 0);
+    assert(reserved != nullptr);
+    assert(registry.bytes_committed() == 3 * mb);
+
+    void *grown = registry.realloc_bytes(reserved, 10 * mb, 0);
+    assert(grown == reserved);
+    assert(registry.bytes_committed() == 10 * mb);
+    registry.free(grown);
+    assert(registry.bytes_committed() == 0);
+
+    // Plain blocks count their mapping, and stay counted while cached for reuse
+    void *ptr = registry.alloc(4 * mb, 0, false);
+    assert(ptr != nullptr);
+    size_t live = registry.bytes_committed();
+    assert(live >= 4 * mb);
+    registry.free(ptr);
+    assert(registry.bytes_committed() == registry.cached_bytes());
+    registry.trim_cache();
+    assert(registry.bytes_committed() == 0);
+    printf("  PASSED\n");
+}
+
+TEST(ChurnKeepsProbesShort) {
+    Cell::LargeAllocRegistry registry;
+    // A few live blocks, replaced one at a time by reservations of varying length so
+    // the addresses keep moving: many more distinct keys than the table has slots
+    constexpr size_t kLive = 64;
+    std::vector<void *> live(kLive, nullptr);
+    std::unordered_set<void *> seen;
+    for (size_t i = 0; i < 40000; ++i) {
+        void *&slot = live[i % kLive];
+        registry.free(slot);
+        // Past kCacheMaxBlockSize reservations are only page-rounded, so each length
+        // lands somewhere else
+        slot = registry.alloc_reserved(
+            4096, Cell::LargeAllocRegistry::kCacheMaxBlockSize + (i * 7919 % 4093) * 4096, 0);
+        assert(slot != nullptr);
+        seen.insert(slot);
+    }
+    printf("  %zu distinct addresses\n", seen.size());
+    assert(seen.size() > Cell::LargeAllocRegistry::kTableCapacity);
+
+    // Freed slots do not pile up in front of lookups, hits or misses
+    size_t longest = 0;
+    for (void *ptr : live) {
+        assert(registry.owns(ptr));
+        longest = std::max(longest, registry.probe_length(ptr));
+    }
+    int foreign = 0;
+    for (size_t i = 0; i < 1024; ++i) {
+        longest = std::max(longest, registry.probe_length(reinterpret_cast<char *>(&foreign) +
+                                                         i * 4096));
+    }
+    printf("  longest probe: %zu slots\n", longest);
+    assert(longest <= kLive);
+
+    for (void *ptr : live) {
+        registry.free(ptr);
+    }
+    assert(registry.allocation_count() == 0);
+    printf("  PASSED\n");
+}
+
+TEST(LiveAllocationsOutgrowFirstTable) {
+    Cell::LargeAllocRegistry registry;
+
+    // Far past what the first table holds: further tables are chained on. Small
+    // aligned blocks keep this cheap; they are registered like any other.
+    const size_t count = Cell::LargeAllocRegistry::kTableCapacity * 3;
+    std::vector<void *> ptrs(count);
+    for (size_t i = 0; i < count; ++i) {
+        ptrs[i] = registry.alloc_aligned(64 + i % 64, 64, 0);
+        assert(ptrs[i] != nullptr);
+    }
+    assert(registry.allocation_count() == count);
+
+    void *mapped = registry.alloc(3 * 1024 * 1024, 0, false);
+    assert(mapped != nullptr && registry.owns(mapped));
+    registry.free(mapped);
+
+    size_t longest = 0;
+    for (size_t i = 0; i < count; ++i) {
+        assert(registry.owns(ptrs[i]));
+        assert(registry.get_alloc_size(ptrs[i]) == 64 + i % 64);
+        longest = std::max(longest, registry.probe_length(ptrs[i]));
+    }
+    printf("  longest probe: %zu slots\n", longest);
+    for (void *ptr : ptrs) {
+        registry.free(ptr);
+    }
+    assert(registry.allocation_count() == 0);
+    assert(registry.bytes_allocated() == 0);
+
+    // Emptied tables take new blocks again
+    for (size_t i = 0; i < count; ++i) {
+        ptrs[i] = registry.alloc_aligned(64, 64, 0);
+        assert(ptrs[i] != nullptr);
+    }
+    for (void *ptr : ptrs) {
+        registry.free(ptr);
+    }
+    printf("  PASSED\n");
+}
+
 int main() {
     printf("Large Allocation Realloc Tests\n");
     printf("===============================\n\n");
@@ -0,0 +1,231 @@
+/**
+ * @file test_latency.cpp
+ * @brief Tests for the latency histograms of CELL_ENABLE_LATENCY_PROFILE.
+ */
+
+#include "cell/context.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Simple test helper
+#define TEST(name)                                                                                 \
+    void test_##name();                                                                            \
+    struct Register##name {                                                                        \
+        Register##name() { tests.push_back({#name, test_##name}); }                                \
+    } reg_##name;                                                                                  \
+    void test_##name()
+
+struct TestCase {
+    const char *name;
+    void (*fn)();
+};
+std::vector<TestCase> tests;
+
+// Test 1: Buckets cover every latency in order, each no wider than a quarter of its floor
+TEST(LatencyBuckets) {
+    for (uint64_t ns = 0; ns < 4; ++ns) {
+        assert(Cell::latency_bucket(ns) == ns);
+    }
+    size_t previous = 0;
+    for (uint64_t ns = 1; ns < (uint64_t{1} << 20); ns += ns / 7 + 1) {
+        size_t bucket = Cell::latency_bucket(ns);
+        assert(bucket >= previous && bucket < Cell::kLatencyBuckets);
+        assert(Cell::latency_bucket_floor(bucket) <= ns);
+        assert(Cell::latency_bucket_floor(bucket + 1) > ns);
+        assert(Cell::latency_bucket_floor(bucket + 1) - Cell::latency_bucket_floor(bucket) <=
+               Cell::latency_bucket_floor(bucket) / 4 + 1);
+        previous = bucket;
+    }
+    for (size_t bucket = 0; bucket + 1 < Cell::kLatencyBuckets; ++bucket) {
+        assert(Cell::latency_bucket(Cell::latency_bucket_floor(bucket)) == bucket);
+    }
+    assert(Cell::latency_bucket(UINT64_MAX) == Cell::kLatencyBuckets - 1);
+    (void)previous;
+
+    printf("  PASSED\n");
+}
+
+// Test 2: Percentiles land in the bucket of the ranked sample
+TEST(LatencyPercentiles) {
+    Cell::LatencyHistogram histogram;
+    assert(histogram.percentile_ns(0.99) == 0 && histogram.mean_ns() == 0.0);
+
+    // 990 samples of 100ns and 10 of 10us
+    histogram.buckets[Cell::latency_bucket(100)] = 990;
+    histogram.buckets[Cell::latency_bucket(10000)] = 10;
+    histogram.count = 1000;
+    histogram.total_ns = 990 * 100 + 10 * 10000;
+    histogram.max_ns = 10000;
+
+    uint64_t p50 = histogram.percentile_ns(0.5);
+    uint64_t p999 = histogram.percentile_ns(0.999);
+    printf("  p50 %llu ns, p99.9 %llu ns\n", static_cast<unsigned long long>(p50),
+           static_cast<unsigned long long>(p999));
+    assert(p50 >= 100 && p50 < 128);
+    assert(histogram.percentile_ns(0.98) == p50);
+    assert(p999 == 10000);
+    assert(histogram.percentile_ns(1.0) == histogram.max_ns);
+    assert(histogram.mean_ns() == 199.0);
+    (void)p50;
+    (void)p999;
+
+    printf("  PASSED\n");
+}
+
+// =============================================================================
+// Profile Tests (only run when CELL_ENABLE_LATENCY_PROFILE is defined)
+// =============================================================================
+
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+
+static const Cell::LatencyHistogram &path_of(const Cell::HeapSnapshot &snapshot,
+                                             Cell::LatencyPath path) {
+    return snapshot.latency[static_cast<size_t>(path)];
+}
+
+static bool consistent(const Cell::LatencyHistogram &histogram) {
+    uint64_t sum = 0;
+    for (uint64_t bucket : histogram.buckets) {
+        sum += bucket;
+    }
+    return sum == histogram.count && histogram.max_ns * histogram.count >= histogram.total_ns;
+}
+
+// Test 3: Every slow path records its samples, and cache hits record none
+TEST(LatencySlowPaths) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    Cell::HeapSnapshot empty = ctx.snapshot();
+    for (const Cell::LatencyHistogram &histogram : empty.latency) {
+        assert(histogram.count == 0);
+    }
+
+    void *small = ctx.alloc_bytes(64);
+    void *buddy = ctx.alloc_bytes(100 * 1024);
+    void *large = ctx.alloc_bytes(4 * 1024 * 1024);
+    assert(small && buddy && large);
+
+    Cell::HeapSnapshot snapshot = ctx.snapshot();
+    const char *names[] = {"tls_refill", "bin_lock", "cell_from_os", "buddy", "large"};
+    for (size_t i = 0; i < Cell::kLatencyPathCount; ++i) {
+        const Cell::LatencyHistogram &histogram = snapshot.latency[i];
+        printf("  %-12s %3llu samples, max %llu ns\n", names[i],
+               static_cast<unsigned long long>(histogram.count),
+               static_cast<unsigned long long>(histogram.max_ns));
+        assert(histogram.count > 0);
+        assert(consistent(histogram));
+    }
+    (void)names;
+
+    // The refilled thread cache now serves without any slow path
+    std::vector<void *> hits;
+    for (int i = 0; i < 8; ++i) {
+        hits.push_back(ctx.alloc_bytes(64));
+    }
+    Cell::HeapSnapshot after = ctx.snapshot();
+    for (size_t i = 0; i < Cell::kLatencyPathCount; ++i) {
+        assert(after.latency[i].count == snapshot.latency[i].count);
+    }
+
+    for (void *ptr : hits) {
+        ctx.free_bytes(ptr);
+    }
+    ctx.free_bytes(small);
+    ctx.free_bytes(buddy);
+    ctx.free_bytes(large);
+
+    printf("  PASSED\n");
+}
+
+// Test 4: Samples of exited threads stay in the snapshot
+TEST(LatencyExitedThreads) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    constexpr int kThreads = 4;
+    for (int t = 0; t < kThreads; ++t) {
+        std::thread([&ctx] {
+            void *ptr = ctx.alloc_bytes(256);
+            assert(ptr != nullptr);
+            ctx.free_bytes(ptr);
+        }).join();
+    }
+
+    Cell::HeapSnapshot snapshot = ctx.snapshot();
+    const Cell::LatencyHistogram &refill = path_of(snapshot, Cell::LatencyPath::kTlsRefill);
+    assert(refill.count >= kThreads);
+    assert(consistent(refill));
+    (void)refill;
+
+    printf("  PASSED\n");
+}
+
+// Test 5: JSON and Prometheus output carry the histograms
+TEST(LatencyExport) {
+    Cell::Context ctx;
+    void *ptr = ctx.alloc_bytes(64);
+    ctx.free_bytes(ptr);
+
+    Cell::HeapSnapshot snapshot = ctx.snapshot();
+    std::string json = snapshot.to_json();
+    assert(json.find("\"latency\":{\"tls_refill\":{\"count\":") != std::string::npos);
+    assert(json.find("\"p999_ns\":") != std::string::npos);
+
+    std::string prom = snapshot.to_prometheus();
+    assert(prom.find("# TYPE cell_latency_ns histogram") != std::string::npos);
+    assert(prom.find("cell_latency_ns_bucket{path=\"bin_lock\",le=\"+Inf\"}") !=
+           std::string::npos);
+    assert(prom.find("cell_latency_ns_count{path=\"large\"} 0") != std::string::npos);
+
+    printf("  PASSED\n");
+}
+
+#else
+
+// When profiling is disabled, just report that
+TEST(LatencyProfileDisabled) {
+    printf("  CELL_ENABLE_LATENCY_PROFILE not defined, profile tests skipped\n");
+    printf("  PASSED\n");
+}
+
+#endif
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    printf("Latency Profile Tests\n");
+    printf("=====================\n");
+#ifdef CELL_ENABLE_LATENCY_PROFILE
+    printf("CELL_ENABLE_LATENCY_PROFILE: ENABLED\n");
+#else
+    printf("CELL_ENABLE_LATENCY_PROFILE: DISABLED\n");
+#endif
+    printf("\n");
+
+    int passed = 0;
+    int failed = 0;
+
+    for (const auto &test : tests) {
+        printf("Running %s...\n", test.name);
+        try {
+            test.fn();
+            ++passed;
+        } catch (...) {
+            printf("  FAILED (exception)\n");
+            ++failed;
+        }
+    }
+
+    printf("\n");
+    printf("Results: %d passed, %d failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,278 @@
+/**
+ * @file test_malloc.cpp
+ * @brief Tests for the cell_malloc malloc/new interposition library.
+ *
+ * Linked against cell_malloc, so the C allocation functions and the global
+ * operator new/delete used here (and by the standard library) come from Cell.
+ */
+
+#include "cell/malloc_override.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" {
+    size_t malloc_usable_size(void *ptr) noexcept;
+    void *memalign(size_t alignment, size_t size) noexcept;
+    void *__libc_malloc(size_t size);
+}
+
+// Simple test helper
+#define TEST(name)                                                                                 \
+    void test_##name();                                                                            \
+    struct Register##name {                                                                        \
+        Register##name() { tests.push_back({#name, test_##name}); }                                \
+    } reg_##name;                                                                                  \
+    void test_##name()
+
+struct TestCase {
+    const char *name;
+    void (*fn)();
+};
+std::vector<TestCase> tests;
+
+static bool is_aligned(void *ptr, size_t alignment) {
+    return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+// =============================================================================
+// C Allocation API
+// =============================================================================
+
+// Test 1: malloc serves every tier from the process Context
+TEST(MallocAllTiers) {
+    Cell::Context &ctx = Cell::process_context();
+    const size_t sizes[] = {1, 24, 64, 4000, 8192, 12000, 40000, 100000, 3 * 1024 * 1024};
+    for (size_t size : sizes) {
+        void *p = malloc(size);
+        assert(p != nullptr);
+        assert(ctx.owns(p) && "malloc should be served by Cell");
+        assert(is_aligned(p, 16) && "malloc must return max_align_t alignment");
+        assert(malloc_usable_size(p) >= size);
+        std::memset(p, 0x5A, malloc_usable_size(p));
+        free(p);
+    }
+
+    // malloc(0) returns a unique pointer that free() accepts
+    void *a = malloc(0);
+    void *b = malloc(0);
+    assert(a != nullptr && b != nullptr && a != b);
+    free(a);
+    free(b);
+    free(nullptr);
+
+    printf("  PASSED\n");
+}
+
+// Test 2: calloc zeroes recycled memory and rejects overflowing sizes
+TEST(CallocZeroesAndOverflows) {
+    for (int round = 0; round < 4; ++round) {
+        auto *dirty = static_cast<unsigned char *>(malloc(256));
+        std::memset(dirty, 0xFF, 256);
+        free(dirty);
+
+        auto *zeroed = static_cast<unsigned char *>(calloc(16, 16));
+        assert(zeroed != nullptr);
+        for (size_t i = 0; i < 256; ++i) {
+            assert(zeroed[i] == 0);
+        }
+        free(zeroed);
+    }
+
+    volatile size_t huge = SIZE_MAX / 2; // Keeps the compiler from flagging the overflow
+    errno = 0;
+    void *overflow = calloc(huge, 4);
+    assert(overflow == nullptr && errno == ENOMEM);
+    (void)overflow;
+
+    printf("  PASSED\n");
+}
+
+// Test 3: realloc keeps the contents while moving across tiers
+TEST(ReallocAcrossTiers) {
+    Cell::Context &ctx = Cell::process_context();
+    const size_t steps[] = {16, 200, 6000, 20000, 300000, 5 * 1024 * 1024, 100, 8};
+
+    auto *p = static_cast<unsigned char *>(malloc(8));
+    for (size_t i = 0; i < 8; ++i) {
+        p[i] = static_cast<unsigned char>(i + 1);
+    }
+    for (size_t size : steps) {
+        p = static_cast<unsigned char *>(realloc(p, size));
+        assert(p != nullptr && ctx.owns(p));
+        for (size_t i = 0; i < 8; ++i) {
+            assert(p[i] == static_cast<unsigned char>(i + 1));
+        }
+    }
+    void *freed = realloc(p, 0);
+    assert(freed == nullptr);
+    (void)freed;
+
+    void *fresh = realloc(nullptr, 64);
+    assert(fresh != nullptr && ctx.owns(fresh));
+    free(fresh);
+
+    printf("  PASSED\n");
+}
+
+// Test 4: posix_memalign, aligned_alloc and memalign honor large alignments
+TEST(AlignedEntryPoints) {
+    const size_t alignments[] = {8, 16, 32, 64, 256, 4096};
+    for (size_t alignment : alignments) {
+        void *p = nullptr;
+        int rc = posix_memalign(&p, alignment, 100);
+        assert(rc == 0 && p != nullptr && is_aligned(p, alignment));
+        (void)rc;
+        std::memset(p, 1, 100);
+        free(p);
+
+        void *q = aligned_alloc(alignment, 4 * alignment);
+        assert(q != nullptr && is_aligned(q, alignment));
+        free(q);
+
+        void *r = memalign(alignment, 50000);
+        assert(r != nullptr && is_aligned(r, alignment));
+        free(r);
+    }
+
+    void *p = nullptr;
+    int odd = posix_memalign(&p, 24, 64);
+    int small = posix_memalign(&p, 2, 64);
+    assert(odd == EINVAL && small == EINVAL);
+    errno = 0;
+    void *bad = aligned_alloc(48, 96);
+    assert(bad == nullptr && errno == EINVAL);
+    (void)odd;
+    (void)small;
+    (void)bad;
+
+    printf("  PASSED\n");
+}
+
+// Test 5: Pointers from glibc can still be freed, resized and measured
+TEST(ForeignPointers) {
+    Cell::Context &ctx = Cell::process_context();
+    auto *p = static_cast<char *>(__libc_malloc(100));
+    assert(p != nullptr && !ctx.owns(p));
+    std::strcpy(p, "glibc");
+    assert(malloc_usable_size(p) >= 100);
+
+    p = static_cast<char *>(realloc(p, 1000));
+    assert(p != nullptr && std::strcmp(p, "glibc") == 0);
+    free(p);
+
+    printf("  PASSED\n");
+}
+
+// =============================================================================
+// operator new / delete
+// =============================================================================
+
+struct alignas(64) CacheLine {
+    char bytes[64];
+};
+
+struct alignas(256) Overaligned {
+    int value;
+};
+
+// Test 6: Every new/delete form goes through Cell
+TEST(GlobalNewDelete) {
+    Cell::Context &ctx = Cell::process_context();
+
+    auto *value = new int(42);
+    assert(ctx.owns(value) && *value == 42);
+    delete value;
+
+    auto *array = new int[1000];
+    assert(ctx.owns(array));
+    array[999] = 7;
+    delete[] array;
+
+    auto *line = new CacheLine();
+    assert(ctx.owns(line) && is_aligned(line, 64));
+    delete line;
+
+    auto *lines = new Overaligned[10];
+    assert(ctx.owns(lines) && is_aligned(lines, 256));
+    delete[] lines;
+
+    auto *nothrow = new (std::nothrow) char[32];
+    assert(nothrow != nullptr && ctx.owns(nothrow));
+    delete[] nothrow;
+
+    // Sized and aligned sized deletes called directly
+    void *raw = ::operator new(100);
+    ::operator delete(raw, 100);
+    raw = ::operator new(3000, std::align_val_t{512});
+    assert(is_aligned(raw, 512));
+    ::operator delete(raw, 3000, std::align_val_t{512});
+
+    printf("  PASSED\n");
+}
+
+// Test 7: Standard containers and cross-thread frees
+TEST(ContainersAcrossThreads) {
+    Cell::Context &ctx = Cell::process_context();
+    constexpr int kThreads = 4;
+    constexpr int kItems = 2000;
+
+    std::vector<std::vector<std::unique_ptr<std::string>>> produced(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&produced, t] {
+            for (int i = 0; i < kItems; ++i) {
+                produced[t].push_back(std::make_unique<std::string>(
+                    "item " + std::to_string(i) + std::string(static_cast<size_t>(i % 80), 'x')));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    for (int t = 0; t < kThreads; ++t) {
+        assert(ctx.owns(produced[t].front().get()));
+        assert(produced[t].size() == kItems);
+        assert(produced[t][1234]->compare(0, 9, "item 1234") == 0);
+    }
+    produced.clear(); // Freed on a different thread than the allocating ones
+
+    printf("  PASSED\n");
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    printf("Cell malloc Interposition Tests\n");
+    printf("===============================\n\n");
+
+    int passed = 0;
+    int failed = 0;
+
+    for (const auto &test : tests) {
+        printf("Running %s...\n", test.name);
+        try {
+            test.fn();
+            ++passed;
+        } catch (...) {
+            printf("  FAILED (exception)\n");
+            ++failed;
+        }
+    }
+
+    printf("\n");
+    printf("Results: %d passed, %d failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}
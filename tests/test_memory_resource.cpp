@@ -0,0 +1,226 @@
+/**
+ * @file test_memory_resource.cpp
+ * @brief Tests for the std::pmr adapters (ContextResource, ArenaResource).
+ */
+
+#include "cell/memory_resource.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Simple test helper
+#define TEST(name)                                                                                 \
+    void test_##name();                                                                            \
+    struct Register##name {                                                                        \
+        Register##name() { tests.push_back({#name, test_##name}); }                                \
+    } reg_##name;                                                                                  \
+    void test_##name()
+
+struct TestCase {
+    const char *name;
+    void (*fn)();
+};
+std::vector<TestCase> tests;
+
+static bool is_aligned(void *ptr, size_t alignment) {
+    return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+struct alignas(64) CacheLine {
+    uint64_t words[8];
+};
+
+// =============================================================================
+// ContextResource Tests
+// =============================================================================
+
+// Test 1: Raw allocate/deallocate across tiers and alignments
+TEST(ContextResourceRoundTrip) {
+    Cell::Context ctx;
+    Cell::ContextResource resource(ctx, 5);
+    std::pmr::memory_resource &base = resource;
+
+    const size_t sizes[] = {0, 1, 24, 200, 4096, 12000, 100000, 3 * 1024 * 1024};
+    const size_t alignments[] = {1, 8, 16, 64, 256, 4096};
+    for (size_t size : sizes) {
+        for (size_t alignment : alignments) {
+            void *p = base.allocate(size, alignment);
+            assert(p != nullptr && ctx.owns(p));
+            assert(is_aligned(p, alignment));
+            if (size > 0) {
+                std::memset(p, 0xAB, size);
+            }
+            base.deallocate(p, size, alignment);
+        }
+    }
+
+    // Freed by size, so the block comes straight back
+    void *first = base.allocate(48);
+    base.deallocate(first, 48);
+    void *second = base.allocate(48);
+    assert(first == second && "Sized free should hand the block back for reuse");
+    base.deallocate(second, 48);
+
+    assert(resource.context() == &ctx && resource.tag() == 5);
+
+    printf("  PASSED\n");
+}
+
+// Test 2: Equality follows the Context, not the resource object or tag
+TEST(ContextResourceEquality) {
+    Cell::Context ctx_a;
+    Cell::Context ctx_b;
+    Cell::ContextResource a1(ctx_a, 1);
+    Cell::ContextResource a2(ctx_a, 2);
+    Cell::ContextResource b(ctx_b);
+
+    assert(a1.is_equal(a1));
+    assert(a1.is_equal(a2) && a2.is_equal(a1));
+    assert(!a1.is_equal(b));
+    assert(!a1.is_equal(*std::pmr::new_delete_resource()));
+
+    // Equal resources let containers move storage instead of copying elements
+    std::pmr::vector<int> source({1, 2, 3}, &a1);
+    const int *data = source.data();
+    std::pmr::vector<int> target(std::move(source), &a2);
+    assert(target.data() == data && "Equal resources should steal the buffer");
+    (void)data;
+
+    printf("  PASSED\n");
+}
+
+// Test 3: pmr containers and over-aligned elements
+TEST(ContextResourceContainers) {
+    Cell::Context ctx;
+    Cell::ContextResource resource(ctx);
+
+    std::pmr::vector<int> vec(&resource);
+    for (int i = 0; i < 100000; ++i) {
+        vec.push_back(i);
+    }
+    assert(ctx.owns(vec.data()));
+    for (int i = 0; i < 100000; ++i) {
+        assert(vec[i] == i);
+    }
+
+    std::pmr::unordered_map<int, std::pmr::string> map(&resource);
+    for (int i = 0; i < 5000; ++i) {
+        map.emplace(i, std::pmr::string(static_cast<size_t>(i % 100), 'x'));
+    }
+    for (int i = 0; i < 5000; i += 7) {
+        map.erase(i);
+    }
+    assert(map.find(1)->second.size() == 1 && map.count(7) == 0);
+    assert(map.find(99)->second.get_allocator().resource() == &resource &&
+           "Strings should inherit the map's resource");
+
+    std::pmr::vector<CacheLine> lines(100, &resource);
+    assert(ctx.owns(lines.data()) && is_aligned(lines.data(), alignof(CacheLine)));
+    lines.resize(5000);
+    assert(is_aligned(lines.data(), alignof(CacheLine)));
+
+    printf("  PASSED\n");
+}
+
+// Test 4: Standard pool and monotonic resources can sit on top of a Context
+TEST(ContextResourceAsUpstream) {
+    Cell::Context ctx;
+    Cell::ContextResource resource(ctx);
+
+    {
+        std::pmr::unsynchronized_pool_resource pool(&resource);
+        std::pmr::vector<std::pmr::vector<int>> nested(&pool);
+        for (int i = 0; i < 200; ++i) {
+            nested.emplace_back(static_cast<size_t>(i), i);
+        }
+        assert(ctx.owns(nested.data()));
+        assert(nested[199].size() == 199 && nested[199][0] == 199);
+    }
+    {
+        std::pmr::monotonic_buffer_resource monotonic(&resource);
+        void *p = monotonic.allocate(1000, 64);
+        assert(ctx.owns(p) && is_aligned(p, 64));
+    }
+
+    printf("  PASSED\n");
+}
+
+// =============================================================================
+// ArenaResource Tests
+// =============================================================================
+
+// Test 5: Arena-backed containers; deallocate is a no-op until reset
+TEST(ArenaResourceContainers) {
+    Cell::Context ctx;
+    Cell::Arena arena(ctx);
+    Cell::ArenaResource resource(arena);
+    assert(resource.arena() == &arena);
+
+    for (int round = 0; round < 3; ++round) {
+        {
+            std::pmr::vector<int> vec(&resource);
+            for (int i = 0; i < 10000; ++i) {
+                vec.push_back(i);
+            }
+            assert(vec[9999] == 9999);
+
+            std::pmr::unordered_map<int, int> map(&resource);
+            for (int i = 0; i < 1000; ++i) {
+                map[i] = i * 2;
+            }
+            assert(map[500] == 1000);
+
+            size_t before = arena.bytes_allocated();
+            vec.clear();
+            vec.shrink_to_fit();
+            assert(arena.bytes_allocated() == before && "Arena deallocation must be a no-op");
+            (void)before;
+
+            std::pmr::vector<CacheLine> lines(10, &resource);
+            assert(is_aligned(lines.data(), alignof(CacheLine)));
+        }
+        assert(arena.bytes_allocated() > 0);
+        arena.reset();
+        assert(arena.bytes_allocated() == 0);
+    }
+
+    Cell::Arena other_arena(ctx);
+    Cell::ArenaResource same(arena);
+    Cell::ArenaResource other(other_arena);
+    assert(resource.is_equal(same) && !resource.is_equal(other));
+
+    printf("  PASSED\n");
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    printf("Cell std::pmr Resource Tests\n");
+    printf("============================\n\n");
+
+    int passed = 0;
+    int failed = 0;
+
+    for (const auto &test : tests) {
+        printf("Running %s...\n", test.name);
+        try {
+            test.fn();
+            ++passed;
+        } catch (...) {
+            printf("  FAILED (exception)\n");
+            ++failed;
+        }
+    }
+
+    printf("\n");
+    printf("Results: %d passed, %d failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}
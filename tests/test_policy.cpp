@@ -0,0 +1,289 @@
+/**
+ * @file test_policy.cpp
+ * @brief Tests for geometry policies: BasicContext<LargeCellPolicy> next to the default Context.
+ */
+
+#include "cell/context.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+// Simple test helper
+#define TEST(name)                                                                                 \
+    void test_##name();                                                                            \
+    struct Register##name {                                                                        \
+        Register##name() { tests.push_back({#name, test_##name}); }                                \
+    } reg_##name;                                                                                  \
+    void test_##name()
+
+struct TestCase {
+    const char *name;
+    void (*fn)();
+};
+std::vector<TestCase> tests;
+
+using LargeContext = Cell::BasicContext<Cell::LargeCellPolicy>;
+using LargeTraits = Cell::PolicyTraits<Cell::LargeCellPolicy>;
+
+static Cell::Config small_config() {
+    Cell::Config config;
+    config.reserve_size = 128 * 1024 * 1024;
+    return config;
+}
+
+// Test 1: Geometry constants follow the policy
+TEST(PolicyGeometry) {
+    static_assert(LargeContext::kCellSize == 64 * 1024, "64KB cells");
+    static_assert(LargeContext::kCellsPerSuperblock == 32, "32 cells per superblock");
+    static_assert(LargeContext::kMaxSubCellSize == 32 * 1024, "Sub-cell classes up to 32KB");
+    static_assert(Cell::Context::kCellSize == Cell::kCellSize, "Context keeps the default");
+    static_assert(Cell::Context::kNumSizeBins == Cell::kNumSizeBins, "Context keeps the default");
+
+    assert(Cell::get_size_class<Cell::LargeCellPolicy>(16, 8) == 0);
+    assert(Cell::get_size_class<Cell::LargeCellPolicy>(8193, 8) == 32);
+    assert(Cell::get_size_class<Cell::LargeCellPolicy>(32768, 8) == LargeTraits::kNumSizeBins - 1);
+    assert(Cell::get_size_class<Cell::LargeCellPolicy>(32769, 8) == Cell::kFullCellMarker);
+    assert(Cell::get_size_class(8193, 8) == Cell::kFullCellMarker);
+
+    printf("  PASSED\n");
+}
+
+// Test 2: Blocks up to 32KB are carved from 64KB cells
+TEST(PolicyLargeSubCell) {
+    LargeContext ctx(small_config());
+
+    std::vector<void *> live;
+    for (size_t i = 0; i < 1500; ++i) {
+        size_t size = 16 + (i * 97) % (LargeContext::kMaxSubCellSize - 16);
+        void *ptr = ctx.alloc_bytes(size);
+        assert(ptr != nullptr);
+        std::memset(ptr, 0x5A, size);
+        assert(ctx.usable_size(ptr) >= size);
+
+        Cell::CellHeader *header = Cell::get_header<Cell::LargeCellPolicy>(ptr);
+        assert(header->size_class < LargeTraits::kNumSizeBins);
+        assert(LargeTraits::kSizeClasses[header->size_class] >= size);
+        live.push_back(ptr);
+    }
+
+    // 20KB blocks: three per cell, where the default geometry needs a whole cell each
+    std::set<Cell::CellHeader *> cells;
+    std::vector<void *> mid(30);
+    for (void *&ptr : mid) {
+        ptr = ctx.alloc_bytes(20000);
+        cells.insert(Cell::get_header<Cell::LargeCellPolicy>(ptr));
+    }
+    assert(cells.size() <= 11);
+
+    for (void *ptr : live) {
+        ctx.free_bytes(ptr);
+    }
+    ctx.free_batch(mid.data(), mid.size());
+
+    printf("  PASSED\n");
+}
+
+// Test 3: Full cells, buddy and large allocations keep working
+TEST(PolicyLargeTiers) {
+    LargeContext ctx(small_config());
+
+    void *cell = ctx.alloc_bytes(40000);
+    assert(cell != nullptr);
+    assert(Cell::get_header<Cell::LargeCellPolicy>(cell)->size_class == Cell::kFullCellMarker);
+    std::memset(cell, 0x11, 40000);
+    assert(ctx.usable_size(cell) >= 40000);
+
+    void *buddy = ctx.alloc_bytes(200 * 1024);
+    void *large = ctx.alloc_bytes(4 * 1024 * 1024);
+    assert(buddy != nullptr && large != nullptr);
+    std::memset(buddy, 0x22, 200 * 1024);
+    std::memset(large, 0x33, 4 * 1024 * 1024);
+
+    void *grown = ctx.realloc_bytes(ctx.alloc_bytes(1000), 30000);
+    assert(grown != nullptr);
+
+    ctx.free_bytes(cell);
+    ctx.free_bytes(buddy);
+    ctx.free_bytes(large);
+    ctx.free_bytes(grown);
+
+    printf("  PASSED\n");
+}
+
+// Test 4: Both geometries run side by side in one thread, across threads too
+TEST(PolicyMixedContexts) {
+    Cell::Context small(small_config());
+    LargeContext large(small_config());
+
+    std::vector<void *> small_live;
+    std::vector<void *> large_live;
+    for (size_t i = 0; i < 2000; ++i) {
+        small_live.push_back(small.alloc_bytes(16 + (i * 31) % 8000));
+        large_live.push_back(large.alloc_bytes(16 + (i * 131) % 30000));
+    }
+
+    // Another thread frees them through each Context's own remote queues
+    std::thread([&] {
+        for (size_t i = 0; i < small_live.size(); i += 2) {
+            small.free_bytes(small_live[i]);
+            large.free_bytes(large_live[i]);
+        }
+    }).join();
+    for (size_t i = 1; i < small_live.size(); i += 2) {
+        small.free_bytes(small_live[i]);
+        large.free_bytes(large_live[i]);
+    }
+
+    // The freed blocks come back to their owner
+    for (size_t i = 0; i < 500; ++i) {
+        void *ptr = large.alloc_bytes(2048);
+        assert(ptr != nullptr);
+        large.free_bytes(ptr);
+    }
+    small.flush_tls_caches();
+    large.flush_tls_caches();
+
+    printf("  PASSED\n");
+}
+
+// Test 5: Snapshots list the policy's bins, and empty superblocks decommit
+TEST(PolicySnapshotDecommit) {
+    LargeContext ctx(small_config());
+
+    std::vector<void *> live;
+    for (size_t i = 0; i < 200; ++i) {
+        void *ptr = ctx.alloc_bytes(16384);
+        std::memset(ptr, 0xCD, 16384);
+        live.push_back(ptr);
+    }
+
+    Cell::HeapSnapshot snapshot = ctx.snapshot();
+    assert(snapshot.bins.size() == LargeTraits::kNumSizeBins);
+    assert(snapshot.bins.back().block_size == 32768);
+    size_t bin_index = Cell::get_size_class<Cell::LargeCellPolicy>(16384, 8);
+    assert(snapshot.bins[bin_index].blocks_per_cell == 3);
+    (void)bin_index;
+    assert(Cell::Context(small_config()).snapshot().bins.size() == Cell::kNumSizeBins);
+
+    ctx.free_batch(live.data(), live.size());
+    ctx.flush_tls_caches();
+    size_t decommitted = ctx.decommit_unused();
+    printf("  %zu KB decommitted\n", decommitted / 1024);
+    assert(decommitted >= LargeContext::kSuperblockSize);
+    (void)decommitted;
+
+    printf("  PASSED\n");
+}
+
+// Test 6: Batch frees of the classes past the thread caches go straight to their cells
+TEST(PolicyBatchFreeUncachedBins) {
+    static_assert(LargeTraits::kTlsBinCacheCount < LargeTraits::kNumSizeBins,
+                  "LargeCellPolicy leaves its biggest classes uncached");
+    LargeContext ctx(small_config());
+
+    for (int round = 0; round < 2; ++round) {
+        std::vector<void *> live;
+        for (size_t bin = LargeTraits::kTlsBinCacheCount; bin < LargeTraits::kNumSizeBins; ++bin) {
+            // Short of the class size, so that debug guard bytes still fit the class
+            size_t size = LargeTraits::kSizeClasses[bin] - 64;
+            for (int i = 0; i < 8; ++i) {
+                void *ptr = ctx.alloc_bytes(size);
+                assert(ptr != nullptr);
+                assert(Cell::get_header<Cell::LargeCellPolicy>(ptr)->size_class == bin);
+                std::memset(ptr, 0x44, size);
+                live.push_back(ptr);
+            }
+        }
+        ctx.free_batch(live.data(), live.size());
+
+        Cell::HeapSnapshot snapshot = ctx.snapshot();
+        for (size_t bin = LargeTraits::kTlsBinCacheCount; bin < LargeTraits::kNumSizeBins; ++bin) {
+            assert(snapshot.bins[bin].allocated_blocks == 0);
+        }
+    }
+
+    printf("  PASSED\n");
+}
+
+// Test 7: Sized, aligned and realloc frees of the uncached classes skip the thread caches
+TEST(PolicySizedFreeUncachedBins) {
+    LargeContext ctx(small_config());
+    auto check_empty = [&ctx] {
+        Cell::HeapSnapshot snapshot = ctx.snapshot();
+        for (size_t bin = LargeTraits::kTlsBinCacheCount; bin < LargeTraits::kNumSizeBins; ++bin) {
+            assert(snapshot.bins[bin].allocated_blocks == 0);
+        }
+        (void)snapshot;
+    };
+
+    for (int round = 0; round < 2; ++round) {
+        for (size_t bin = LargeTraits::kTlsBinCacheCount; bin < LargeTraits::kNumSizeBins; ++bin) {
+            size_t size = LargeTraits::kSizeClasses[bin] - 64;
+            void *ptr = ctx.alloc_bytes(size);
+            assert(ptr != nullptr);
+            assert(Cell::get_header<Cell::LargeCellPolicy>(ptr)->size_class == bin);
+            std::memset(ptr, 0x45, size);
+            ctx.free_sized(ptr, size);
+        }
+        check_empty();
+
+        // Over-aligned requests land in the power-of-2 classes past the caches
+        for (size_t size : {size_t{12000}, size_t{20000}}) {
+            void *ptr = ctx.alloc_bytes(size, 0, 256);
+            assert(ptr != nullptr && reinterpret_cast<uintptr_t>(ptr) % 256 == 0);
+            assert(Cell::get_header<Cell::LargeCellPolicy>(ptr)->size_class >=
+                   LargeTraits::kTlsBinCacheCount);
+            std::memset(ptr, 0x46, size);
+            ctx.free_aligned_sized(ptr, size, 256);
+        }
+        check_empty();
+
+        // Grow from a cached class through the uncached ones, shrink back, then free
+        void *ptr = ctx.alloc_bytes(1000);
+        assert(ptr != nullptr);
+        std::memset(ptr, 0x47, 1000);
+        for (size_t bin = LargeTraits::kTlsBinCacheCount; bin < LargeTraits::kNumSizeBins; ++bin) {
+            ptr = ctx.realloc_bytes(ptr, LargeTraits::kSizeClasses[bin] - 64);
+            assert(ptr != nullptr && static_cast<unsigned char *>(ptr)[999] == 0x47);
+        }
+        ptr = ctx.realloc_bytes(ptr, 9000);
+        assert(ptr != nullptr && static_cast<unsigned char *>(ptr)[999] == 0x47);
+        ptr = ctx.realloc_bytes(ptr, 1000);
+        assert(ptr != nullptr && static_cast<unsigned char *>(ptr)[999] == 0x47);
+        ctx.free_sized(ptr, 1000);
+        check_empty();
+    }
+
+    printf("  PASSED\n");
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    printf("Geometry Policy Tests\n");
+    printf("=====================\n\n");
+
+    int passed = 0;
+    int failed = 0;
+
+    for (const auto &test : tests) {
+        printf("Running %s...\n", test.name);
+        try {
+            test.fn();
+            ++passed;
+        } catch (...) {
+            printf("  FAILED (exception)\n");
+            ++failed;
+        }
+    }
+
+    printf("\n");
+    printf("Results: %d passed, %d failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}
@@ -1,5 +1,6 @@
 #include "cell/pool.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cstdio>
@@ -273,6 +274,335 @@ TEST(ArenaScopeNested) {
     printf("  PASSED\n");
 }
 
+// Test 10: Sized frees hand blocks straight back for reuse
+TEST(PoolSizedFree) {
+    Cell::Config config;
+    config.reserve_size = 16 * 1024 * 1024;
+
+    Cell::Context ctx(config);
+    Cell::Pool<Transform> pool(ctx);
+
+    Transform *t = pool.alloc();
+    pool.free(t);
+    Transform *reused = pool.alloc();
+    assert(reused == t && "Freed object should be reused first");
+    pool.free(reused);
+
+    const size_t counts[] = {4, 100, 2000, 80000};
+    for (size_t count : counts) {
+        Transform *arr = pool.alloc_array(count);
+        assert(arr != nullptr && "Failed to allocate Transform array");
+        arr[count - 1].x = 1.0f;
+        pool.free_array(arr, count);
+    }
+
+    // An array freed with the plain overload still goes back correctly
+    Transform *arr = pool.alloc_array(100);
+    pool.free(arr);
+    Transform *reused_arr = pool.alloc_array(100);
+    assert(reused_arr == arr && "Array block should be reused");
+    pool.free_array(reused_arr, 100);
+
+    printf("  PASSED\n");
+}
+
+// Test 11: One pool shared by several threads, with objects freed on other threads
+TEST(PoolSharedAcrossThreads) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+
+    Cell::Context ctx(config);
+    Cell::Pool<Transform> pool(ctx);
+
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 20000;
+    std::vector<std::vector<Transform *>> objects(kThreads);
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&pool, &objects, &failures, t] {
+            for (int i = 0; i < kPerThread; ++i) {
+                Transform *obj = pool.create();
+                if (!obj) {
+                    failures.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+                obj->x = static_cast<float>(t);
+                obj->y = static_cast<float>(i);
+                objects[t].push_back(obj);
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+    assert(failures.load() == 0);
+
+    // Each thread checks and frees what its neighbour allocated
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&pool, &objects, &failures, t] {
+            int owner = (t + 1) % kThreads;
+            for (size_t i = 0; i < objects[owner].size(); ++i) {
+                Transform *obj = objects[owner][i];
+                if (obj->x != static_cast<float>(owner) || obj->y != static_cast<float>(i)) {
+                    failures.fetch_add(1, std::memory_order_relaxed);
+                }
+                pool.destroy(obj);
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    assert(failures.load() == 0 && "Objects must not be shared or overwritten");
+
+    printf("  PASSED\n");
+}
+
+// Test 12: Objects belong to the Context and outlive the pool that made them
+TEST(PoolObjectsOutlivePool) {
+    Cell::Config config;
+    config.reserve_size = 16 * 1024 * 1024;
+
+    Cell::Context ctx(config);
+    std::vector<Transform *> objects;
+    {
+        Cell::Pool<Transform> pool(ctx);
+        for (int i = 0; i < 1000; ++i) {
+            Transform *obj = pool.create();
+            obj->x = static_cast<float>(i);
+            objects.push_back(obj);
+        }
+    }
+
+    Cell::Pool<Transform> other(ctx);
+    Transform *fresh = other.create();
+    for (int i = 0; i < 1000; ++i) {
+        assert(objects[i] != fresh && objects[i]->x == static_cast<float>(i));
+        other.destroy(objects[i]);
+    }
+    other.destroy(fresh);
+
+    printf("  PASSED\n");
+}
+
+// =============================================================================
+// LocalPool<T> Tests
+// =============================================================================
+
+// 48 bytes: the 64B size class would waste a quarter of every block
+struct Particle {
+    float position[4];
+    float velocity[4];
+    uint32_t id;
+    uint32_t flags;
+    uint32_t pad[2];
+};
+static_assert(sizeof(Particle) == 48, "Particle must be 48 bytes");
+
+// Test 13: Objects are carved at sizeof(T) stride from dedicated cells
+TEST(LocalPoolSlabStride) {
+    Cell::Config config;
+    config.reserve_size = 16 * 1024 * 1024;
+
+    Cell::Context ctx(config);
+    Cell::LocalPool<Particle> pool(ctx, 3);
+
+    static_assert(Cell::LocalPool<Particle>::object_stride() == sizeof(Particle));
+    static_assert(Cell::LocalPool<Particle>::objects_per_slab() * sizeof(Particle) >
+                      Cell::kCellSize * 95 / 100,
+                  "A slab should lose under 5% of its cell");
+
+    const size_t per_slab = pool.objects_per_slab();
+    std::vector<Particle *> objects(per_slab + 1);
+    for (size_t i = 0; i < objects.size(); ++i) {
+        objects[i] = pool.alloc();
+        assert(objects[i] != nullptr);
+        assert(reinterpret_cast<uintptr_t>(objects[i]) % alignof(Particle) == 0);
+        std::memset(objects[i], static_cast<int>(i & 0xFF), sizeof(Particle));
+    }
+    for (size_t i = 1; i < per_slab; ++i) {
+        auto gap = reinterpret_cast<char *>(objects[i]) - reinterpret_cast<char *>(objects[i - 1]);
+        assert(gap == static_cast<ptrdiff_t>(sizeof(Particle)) && "Objects must be contiguous");
+        (void)gap;
+    }
+    assert(pool.slab_count() == 2 && pool.live_count() == per_slab + 1);
+    assert(Cell::get_header(objects[0])->tag == 3 && "Slabs carry the pool's tag");
+
+    // Arrays stay outside the slabs, and free() still recognises them (a full cell here)
+    Particle *array = pool.alloc_array(4);
+    assert(Cell::get_header(array) != Cell::get_header(objects[0]));
+    pool.free_array(array, 4);
+    Particle *cell_array = pool.alloc_array(250);
+    assert(cell_array != nullptr && Cell::get_header(cell_array)->size_class ==
+                                        Cell::kFullCellMarker);
+    pool.free(cell_array);
+    assert(pool.live_count() == per_slab + 1);
+
+    for (size_t i = 0; i < objects.size(); ++i) {
+        assert(objects[i]->id == (i & 0xFF) * 0x01010101u && "Neighbour overwrote an object");
+        pool.free(objects[i]);
+    }
+    assert(pool.live_count() == 0 && pool.slab_count() == 1 && "One empty slab is kept");
+
+    printf("  %zu objects per slab\n", per_slab);
+    printf("  PASSED\n");
+}
+
+// Test 14: for_each_live visits exactly the allocated objects, in address order
+TEST(LocalPoolForEachLive) {
+    Cell::Config config;
+    config.reserve_size = 16 * 1024 * 1024;
+
+    Cell::Context ctx(config);
+    Cell::LocalPool<Particle> pool(ctx);
+
+    constexpr uint32_t kCount = 2000;
+    std::vector<Particle *> objects;
+    for (uint32_t i = 0; i < kCount; ++i) {
+        Particle *p = pool.create();
+        p->id = i;
+        objects.push_back(p);
+    }
+    // Free every third object, then reuse some of the holes
+    for (uint32_t i = 0; i < kCount; i += 3) {
+        pool.destroy(objects[i]);
+        objects[i] = nullptr;
+    }
+    for (uint32_t i = 0; i < kCount; i += 6) {
+        objects[i] = pool.create();
+        objects[i]->id = i;
+    }
+
+    size_t expected = 0;
+    uint64_t expected_sum = 0;
+    for (Particle *p : objects) {
+        if (p) {
+            ++expected;
+            expected_sum += p->id;
+        }
+    }
+
+    size_t visited = 0;
+    uint64_t sum = 0;
+    const Particle *previous = nullptr;
+    const Cell::LocalPool<Particle> &view = pool;
+    view.for_each_live([&](const Particle &p) {
+        assert((!previous || previous < &p) && "Iteration must ascend through memory");
+        previous = &p;
+        ++visited;
+        sum += p.id;
+    });
+    assert(visited == expected && visited == pool.live_count());
+    assert(sum == expected_sum);
+
+    // Mutable iteration reaches the same objects
+    pool.for_each_live([](Particle &p) { p.flags = 0xF00D; });
+    for (Particle *p : objects) {
+        if (p) {
+            assert(p->flags == 0xF00D);
+        }
+    }
+
+    printf("  %zu live objects over %zu slabs\n", visited, pool.slab_count());
+    printf("  PASSED\n");
+}
+
+// Test 15: Batches span slabs, mix reused and fresh objects, and return empty slabs
+TEST(LocalPoolSlabBatchAndRelease) {
+    Cell::Config config;
+    config.reserve_size = 16 * 1024 * 1024;
+
+    Cell::Context ctx(config);
+    {
+        Cell::LocalPool<Transform> pool(ctx);
+        const size_t per_slab = pool.objects_per_slab();
+        const size_t count = per_slab * 3 + 17;
+        std::vector<Transform *> batch(count);
+
+        Transform *single = pool.alloc();
+        pool.free(single); // Leaves one reusable object ahead of the bump run
+
+        size_t got = pool.alloc_batch(batch.data(), count);
+        assert(got == count && pool.live_count() == count);
+        assert(batch[0] == single && "Freed objects are handed out first");
+        std::vector<Transform *> sorted(batch);
+        std::sort(sorted.begin(), sorted.end());
+        assert(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end() &&
+               "Batch must not hand out an object twice");
+        for (size_t i = 0; i < count; ++i) {
+            batch[i]->x = static_cast<float>(i);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            assert(batch[i]->x == static_cast<float>(i));
+        }
+
+        size_t visited = 0;
+        pool.for_each_live([&visited](Transform &) { ++visited; });
+        assert(visited == count);
+
+        pool.free_batch(batch.data(), count);
+        assert(pool.live_count() == 0 && pool.slab_count() == 1);
+
+        // The kept slab serves the next allocation
+        Transform *again = pool.alloc();
+        assert(Cell::get_header(again) == Cell::get_header(single));
+        (void)got;
+        (void)again;
+    }
+
+    // A moved pool takes its slabs along
+    Cell::LocalPool<Transform> source(ctx);
+    Transform *kept = source.create();
+    Cell::LocalPool<Transform> moved(std::move(source));
+    assert(moved.live_count() == 1 && source.slab_count() == 0);
+    moved.destroy(kept);
+
+    printf("  PASSED\n");
+}
+
+// Test 16: Objects die with the pool: release() and the destructor return every slab
+TEST(LocalPoolReleaseReturnsSlabs) {
+    Cell::Config config;
+    config.reserve_size = 16 * 1024 * 1024;
+
+    Cell::Context ctx(config);
+#ifdef CELL_DEBUG_LEAKS
+    const size_t baseline = ctx.live_allocation_count();
+#endif
+    {
+        Cell::LocalPool<Particle> pool(ctx);
+        const size_t count = pool.objects_per_slab() * 3;
+        for (size_t i = 0; i < count; ++i) {
+            Particle *p = pool.create();
+            assert(p != nullptr);
+            (void)p;
+        }
+        assert(pool.slab_count() == 3);
+
+        // Live objects go with their slabs: the pool is empty but still usable
+        pool.release();
+        assert(pool.slab_count() == 0 && pool.live_count() == 0);
+        size_t visited = 0;
+        pool.for_each_live([&visited](Particle &) { ++visited; });
+        assert(visited == 0);
+        (void)visited;
+
+        for (size_t i = 0; i < count; ++i) {
+            Particle *p = pool.create();
+            assert(p != nullptr);
+            (void)p;
+        }
+        assert(pool.slab_count() == 3);
+    }
+#ifdef CELL_DEBUG_LEAKS
+    assert(ctx.live_allocation_count() == baseline && "Destruction must return every slab");
+#endif
+
+    printf("  PASSED\n");
+}
+
 // =============================================================================
 // Main
 // =============================================================================
@@ -0,0 +1,220 @@
+/**
+ * @file test_prewarm.cpp
+ * @brief Tests for Context::prewarm() and Config::prewarm.
+ */
+
+#include "cell/context.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Simple test helper
+#define TEST(name)                                                                                 \
+    void test_##name();                                                                            \
+    struct Register##name {                                                                        \
+        Register##name() { tests.push_back({#name, test_##name}); }                                \
+    } reg_##name;                                                                                  \
+    void test_##name()
+
+struct TestCase {
+    const char *name;
+    void (*fn)();
+};
+std::vector<TestCase> tests;
+
+static Cell::Config small_config() {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    return config;
+}
+
+/** @brief Size class alloc_bytes() serves a request from (guard bytes included). */
+static size_t bin_of(size_t size) {
+#ifdef CELL_DEBUG_GUARDS
+    size += 2 * Cell::kGuardSize;
+#endif
+    return Cell::get_size_class(size, 8);
+}
+
+/** @brief Checks whether every page of a range is resident (always true off Linux). */
+static bool is_resident(void *addr, size_t size) {
+#if defined(__linux__)
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    auto start = reinterpret_cast<uintptr_t>(addr) & ~(uintptr_t{page} - 1);
+    size_t pages = (reinterpret_cast<uintptr_t>(addr) + size - start + page - 1) / page;
+    std::vector<unsigned char> vec(pages);
+    if (mincore(reinterpret_cast<void *>(start), pages * page, vec.data()) != 0) {
+        return false;
+    }
+    for (unsigned char v : vec) {
+        if (!(v & 1)) {
+            return false;
+        }
+    }
+#else
+    (void)addr;
+    (void)size;
+#endif
+    return true;
+}
+
+// Test 1: Prewarmed superblocks are committed, resident and kept through scavenging
+TEST(PrewarmSuperblocks) {
+    Cell::Config config = small_config();
+    config.decay_ms = 0;
+    Cell::Context ctx(config);
+    assert(ctx.committed_bytes() == 0);
+
+    Cell::PrewarmSpec spec;
+    spec.superblocks = 4;
+    spec.fill_thread_cache = false;
+    size_t committed = ctx.prewarm(spec);
+    assert(committed == 4 * Cell::kSuperblockSize);
+    assert(ctx.committed_bytes() >= committed);
+    (void)committed;
+
+    Cell::HeapSnapshot snapshot = ctx.snapshot();
+    assert(snapshot.superblocks[static_cast<size_t>(Cell::SuperblockState::kInUse)] == 4);
+    assert(snapshot.cell_committed_bytes == 4 * Cell::kSuperblockSize);
+    assert(snapshot.tls_cached_cells == 0);
+
+    // Not yet used, so not released after the decay time either
+    assert(ctx.scavenge(UINT64_MAX) == 0);
+    assert(ctx.snapshot().cell_committed_bytes == 4 * Cell::kSuperblockSize);
+
+    // The first cells handed out are already faulted in
+    void *cell = ctx.alloc_bytes(Cell::kMaxSubCellSize + 1);
+    assert(cell != nullptr);
+    assert(is_resident(cell, Cell::kCellSize - Cell::kBlockStartOffset));
+    ctx.free_bytes(cell);
+
+    printf("  PASSED\n");
+}
+
+// Test 2: Chosen size classes get cells on their bins and blocks in this thread's cache
+TEST(PrewarmBins) {
+    Cell::Context ctx(small_config());
+
+    Cell::PrewarmSpec spec;
+    spec.superblocks = 1;
+    spec.sizes = {64, 1000, 6000};
+    spec.cells_per_size = 2;
+    ctx.prewarm(spec);
+
+    Cell::HeapSnapshot snapshot = ctx.snapshot();
+    assert(snapshot.tls_cached_cells > 0);
+    for (size_t size : spec.sizes) {
+        size_t bin_index = bin_of(size);
+        const Cell::BinSnapshot &bin = snapshot.bins[bin_index];
+        printf("  %zu B: %zu partial cells, %zu cached blocks\n", size, bin.partial_cells,
+               bin.tls_cached_blocks);
+        assert(bin.partial_cells > 0 || bin.tls_cached_blocks > 0);
+        if (bin_index < Cell::kTlsBinCacheCount) {
+            assert(bin.tls_cached_blocks > 0);
+        }
+        (void)bin;
+    }
+
+    // Served without committing or setting up anything new
+    size_t committed = ctx.committed_bytes();
+    std::vector<void *> live;
+    for (size_t size : spec.sizes) {
+        void *ptr = ctx.alloc_bytes(size);
+        assert(ptr != nullptr);
+        assert(is_resident(ptr, size));
+        std::memset(ptr, 0x5A, size);
+        live.push_back(ptr);
+    }
+    assert(ctx.committed_bytes() == committed);
+    (void)committed;
+
+    for (void *ptr : live) {
+        ctx.free_bytes(ptr);
+    }
+    ctx.flush_tls_caches();
+
+    printf("  PASSED\n");
+}
+
+// Test 3: Config::prewarm readies memory from the constructor
+TEST(PrewarmAtStartup) {
+    Cell::Config config = small_config();
+    config.prewarm.superblocks = 2;
+    config.prewarm.sizes = {32};
+    Cell::Context ctx(config);
+
+    Cell::HeapSnapshot snapshot = ctx.snapshot();
+    assert(snapshot.cell_committed_bytes >= 2 * Cell::kSuperblockSize);
+    assert(snapshot.bins[bin_of(32)].tls_cached_blocks > 0);
+    assert(snapshot.tls_cached_cells > 0);
+
+    // A default Config readies nothing
+    Cell::Context cold(small_config());
+    assert(cold.committed_bytes() == 0);
+
+    printf("  PASSED\n");
+}
+
+// Test 4: Asking for more than the reservation takes what there is
+TEST(PrewarmExhausted) {
+    Cell::Context ctx(small_config());
+
+    Cell::PrewarmSpec spec;
+    spec.superblocks = 1000;
+    spec.populate = false;
+    size_t committed = ctx.prewarm(spec);
+    printf("  %zu MB committed\n", committed / (1024 * 1024));
+    assert(committed > 0 && committed < 1000 * Cell::kSuperblockSize);
+
+    // Everything committed is still ready for use
+    std::vector<void *> cells;
+    for (size_t i = 0; i < committed / Cell::kCellSize; ++i) {
+        void *cell = ctx.alloc_bytes(Cell::kMaxSubCellSize + 1);
+        assert(cell != nullptr);
+        cells.push_back(cell);
+    }
+    assert(ctx.committed_bytes() == committed);
+    for (void *cell : cells) {
+        ctx.free_bytes(cell);
+    }
+
+    // Once used and freed, the superblocks can be released again
+    ctx.flush_tls_caches();
+    assert(ctx.decommit_unused() >= committed);
+
+    printf("  PASSED\n");
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    printf("Prewarm Tests\n");
+    printf("=============\n\n");
+
+    int passed = 0;
+    int failed = 0;
+
+    for (const auto &test : tests) {
+        printf("Running %s...\n", test.name);
+        try {
+            test.fn();
+            ++passed;
+        } catch (...) {
+            printf("  FAILED (exception)\n");
+            ++failed;
+        }
+    }
+
+    printf("\n");
+    printf("Results: %d passed, %d failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}
@@ -1,5 +1,6 @@
 #include "cell/context.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <cstring>
@@ -194,8 +195,8 @@ TEST(BudgetAccountingDriftSkipped) {
 
 // =============================================================================
 // Bug #4: free_batch assumes homogeneous size class
-// The fast path uses first pointer's size class for the entire batch.
-// This test documents the contract and adds debug validation.
+// The fast path used the first pointer's size class for the entire batch.
+// Mixed batches are supported now; both shapes are covered here.
 // =============================================================================
 
 TEST(FreeBatchHomogeneousContract) {
@@ -221,8 +222,46 @@ TEST(FreeBatchHomogeneousContract) {
     printf("  PASSED\n");
 }
 
-// Note: We don't test mixed batches directly as it would corrupt memory.
-// The fix adds a debug assertion to catch this during development.
+// free_batch now groups pointers by tier and size class itself
+TEST(FreeBatchMixedTiers) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+
+    Cell::Context ctx(config);
+
+    // Far more small blocks than the TLS caches hold, so most go back under the bin locks
+    const size_t sizes[] = {16, 64, 64, 200, 3000, 8192, 12000, 100000, 1024 * 1024,
+                            3 * 1024 * 1024};
+    const size_t count = 4000;
+    std::vector<void *> ptrs(count);
+    for (size_t i = 0; i < count; ++i) {
+        size_t size = sizes[i % 10];
+        if (size > 8192 && i >= 100) {
+            size = 64;
+        }
+        ptrs[i] = ctx.alloc_bytes(size, 0);
+        assert(ptrs[i] != nullptr);
+        std::memset(ptrs[i], 0x3C, size);
+    }
+    ptrs[7] = nullptr; // Null entries are skipped
+
+    ctx.free_batch(ptrs.data(), count);
+
+    // Every block must be reusable without corrupting its free list
+    for (int round = 0; round < 2; ++round) {
+        for (size_t i = 0; i < count; ++i) {
+            ptrs[i] = ctx.alloc_bytes(sizes[i % 10] > 8192 ? 64 : sizes[i % 10], 0);
+            assert(ptrs[i] != nullptr);
+        }
+        std::sort(ptrs.begin(), ptrs.end());
+        assert(std::adjacent_find(ptrs.begin(), ptrs.end()) == ptrs.end() &&
+               "A block was handed out twice");
+        ctx.free_batch(ptrs.data(), count);
+    }
+
+    printf("  Mixed batch of %zu freed and reused\n", count);
+    printf("  PASSED\n");
+}
 
 // =============================================================================
 // Main
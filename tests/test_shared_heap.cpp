@@ -0,0 +1,450 @@
+/**
+ * @file test_shared_heap.cpp
+ * @brief Tests for SharedHeap, the heap several processes allocate from.
+ */
+
+#include "cell/config.h"
+#include "cell/shared_heap.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define CELL_TEST_SHARED 1
+#endif
+
+// Simple test helper
+#define TEST(name)                                                                                 \
+    void test_##name();                                                                            \
+    struct Register##name {                                                                        \
+        Register##name() { tests.push_back({#name, test_##name}); }                                \
+    } reg_##name;                                                                                  \
+    void test_##name()
+
+struct TestCase {
+    const char *name;
+    void (*fn)();
+};
+std::vector<TestCase> tests;
+
+#ifdef CELL_TEST_SHARED
+
+static constexpr size_t kCapacity = 64 * 1024 * 1024;
+
+/** @brief Config backed by a fresh memfd (the caller closes config.fd). */
+static Cell::SharedHeapConfig heap_config(void *base = nullptr) {
+    Cell::SharedHeapConfig config;
+    config.fd = memfd_create("cell_test", 0);
+    config.base = base;
+    config.capacity = kCapacity;
+    assert(config.fd >= 0);
+    return config;
+}
+
+/** @brief Waits for a forked child and checks that it exited cleanly. */
+static bool child_succeeded(pid_t pid) {
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/** @brief Finds a 2MB-aligned address range that is free in this process. */
+static void *free_address_range(size_t size) {
+    size_t span = size + 2 * 1024 * 1024;
+    void *probe =
+        mmap(nullptr, span, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    assert(probe != MAP_FAILED);
+    munmap(probe, span);
+    auto addr = reinterpret_cast<uintptr_t>(probe);
+    return reinterpret_cast<void *>((addr + 2 * 1024 * 1024 - 1) & ~uintptr_t{2 * 1024 * 1024 - 1});
+}
+
+/** @brief Bytes of the file actually backed by memory. */
+static size_t file_resident_bytes(int fd) {
+    struct stat st;
+    fstat(fd, &st);
+    return static_cast<size_t>(st.st_blocks) * 512;
+}
+
+struct Node {
+    Node *next;
+    uint64_t value;
+};
+
+// Test 1: Small, medium and cell-run blocks all come from the shared file
+TEST(SharedHeapCreate) {
+    Cell::SharedHeapConfig config = heap_config();
+    Cell::SharedHeap heap(config);
+    assert(heap.valid() && !heap.broken());
+    assert(heap.capacity() >= kCapacity);
+    assert(heap.size() > heap.capacity());
+
+    struct stat st;
+    fstat(config.fd, &st);
+    assert(static_cast<size_t>(st.st_size) == heap.size());
+
+    const size_t sizes[] = {1, 64, 5000, 12000, 100 * 1024, 4 * 1024 * 1024};
+    std::vector<void *> blocks;
+    for (size_t size : sizes) {
+        void *ptr = heap.alloc_bytes(size);
+        assert(ptr != nullptr);
+        assert(heap.contains(ptr));
+        assert(reinterpret_cast<uintptr_t>(ptr) % 16 == 0);
+        assert(heap.usable_size(ptr) >= size);
+        std::memset(ptr, 0x5A, size);
+        blocks.push_back(ptr);
+    }
+    assert(heap.allocated_bytes() >= 4 * 1024 * 1024);
+
+    auto *nodes = heap.alloc_array<Node>(1000);
+    assert(nodes != nullptr && heap.contains(nodes + 999));
+    assert(heap.alloc_array<Node>(SIZE_MAX / 2) == nullptr);
+    assert(heap.alloc_bytes(heap.capacity() * 2) == nullptr);
+    heap.free_bytes(nodes);
+
+    for (void *ptr : blocks) {
+        heap.free_bytes(ptr);
+    }
+    heap.free_bytes(nullptr);
+    assert(heap.allocated_bytes() == 0);
+
+    // A file that already holds data is never taken over
+    Cell::SharedHeap again(config);
+    assert(!again.valid());
+    assert(again.alloc_bytes(64) == nullptr);
+    close(config.fd);
+
+    printf("  PASSED\n");
+}
+
+// Test 2: A fixed base is used as given and never replaces an existing mapping
+TEST(SharedHeapFixedBase) {
+    void *base = free_address_range(2 * kCapacity);
+    Cell::SharedHeapConfig config = heap_config(base);
+    {
+        Cell::SharedHeap heap(config);
+        assert(heap.valid());
+        assert(heap.base() == base);
+
+        // The range is now taken in this process: neither a second heap nor an attach fits
+        Cell::SharedHeapConfig clash = heap_config(base);
+        Cell::SharedHeap other(clash);
+        assert(!other.valid());
+        close(clash.fd);
+
+        Cell::SharedHeap attached(config.fd);
+        assert(!attached.valid());
+    }
+    close(config.fd);
+
+    printf("  PASSED\n");
+}
+
+// Test 3: A forked child frees the parent's blocks and allocates ones the parent reads
+TEST(SharedHeapForkedChild) {
+    Cell::SharedHeapConfig config = heap_config();
+    Cell::SharedHeap heap(config);
+
+    Node *head = nullptr;
+    for (uint64_t i = 0; i < 1000; ++i) {
+        auto *node = heap.alloc<Node>();
+        node->next = head;
+        node->value = i;
+        head = node;
+    }
+    auto **reply = heap.alloc<Node *>();
+    *reply = nullptr;
+
+    fflush(stdout);
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        // Consume the list and answer with a new one built in the same heap
+        uint64_t sum = 0;
+        while (head) {
+            Node *next = head->next;
+            sum += head->value;
+            heap.free_bytes(head);
+            head = next;
+        }
+        for (uint64_t i = 0; i < 10; ++i) {
+            auto *node = heap.alloc<Node>();
+            if (!node) {
+                _exit(1);
+            }
+            node->next = *reply;
+            node->value = sum + i;
+            *reply = node;
+        }
+        _exit(sum == 999 * 1000 / 2 ? 0 : 1);
+    }
+    bool ok = child_succeeded(pid);
+    assert(ok);
+    (void)ok;
+
+    size_t count = 0;
+    for (Node *node = *reply; node;) {
+        assert(heap.contains(node));
+        assert(node->value == 999 * 1000 / 2 + 9 - count);
+        Node *next = node->next;
+        heap.free_bytes(node);
+        node = next;
+        ++count;
+    }
+    assert(count == 10);
+    heap.free_bytes(reply);
+    assert(heap.allocated_bytes() == 0);
+    close(config.fd);
+
+    printf("  PASSED\n");
+}
+
+// Test 4: A process that never had the mapping attaches by fd at the creator's address
+TEST(SharedHeapAttach) {
+    int to_child[2];
+    int to_parent[2];
+    int rc = pipe(to_child) | pipe(to_parent);
+    assert(rc == 0);
+    (void)rc;
+
+    // Fork first, so the child's address space holds no trace of the heap
+    Cell::SharedHeapConfig config = heap_config();
+    fflush(stdout);
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        close(to_child[1]);
+        close(to_parent[0]);
+        Node *msg = nullptr;
+        if (read(to_child[0], &msg, sizeof(msg)) != sizeof(msg)) {
+            _exit(1);
+        }
+        Cell::SharedHeap heap(config.fd);
+        if (!heap.valid() || !heap.contains(msg) || msg->value != 42) {
+            _exit(2);
+        }
+        auto *reply = heap.alloc<Node>();
+        if (!reply) {
+            _exit(3);
+        }
+        reply->next = msg;
+        reply->value = msg->value + 1;
+        if (write(to_parent[1], &reply, sizeof(reply)) != sizeof(reply)) {
+            _exit(4);
+        }
+        _exit(0);
+    }
+
+    close(to_child[0]);
+    close(to_parent[1]);
+
+    Cell::SharedHeap heap(config);
+    assert(heap.valid());
+    auto *msg = heap.alloc<Node>();
+    msg->next = nullptr;
+    msg->value = 42;
+    ssize_t sent = write(to_child[1], &msg, sizeof(msg));
+    assert(sent == sizeof(msg));
+    (void)sent;
+
+    Node *reply = nullptr;
+    ssize_t got = read(to_parent[0], &reply, sizeof(reply));
+    bool ok = child_succeeded(pid);
+    assert(ok && got == sizeof(reply));
+    (void)ok;
+    (void)got;
+    assert(heap.contains(reply));
+    assert(reply->next == msg && reply->value == 43);
+    heap.free_bytes(reply);
+    heap.free_bytes(msg);
+    assert(heap.allocated_bytes() == 0);
+
+    close(to_child[1]);
+    close(to_parent[0]);
+    close(config.fd);
+
+    printf("  PASSED\n");
+}
+
+// Test 5: Threads of several processes allocate and free concurrently
+TEST(SharedHeapConcurrent) {
+    constexpr int kProcesses = 3;
+    constexpr int kThreads = 3;
+    Cell::SharedHeapConfig config = heap_config();
+    Cell::SharedHeap heap(config);
+
+    // Pin the first cells, one per size class, so the rest can coalesce into one run
+    std::vector<void *> pinned;
+    for (size_t size : Cell::kSizeClasses) {
+        pinned.push_back(heap.alloc_bytes(size));
+    }
+
+    // Each worker frees in random order, sometimes blocks another worker allocated
+    auto worker = [&heap](unsigned seed) {
+        std::mt19937 rng(seed);
+        std::vector<std::pair<unsigned char *, size_t>> live;
+        bool ok = true;
+        for (int i = 0; i < 20000; ++i) {
+            if (live.size() < 64 && (live.empty() || rng() % 3 != 0)) {
+                size_t size = rng() % 4 == 0 ? 1 + rng() % (64 * 1024) : 1 + rng() % 1024;
+                auto *ptr = static_cast<unsigned char *>(heap.alloc_bytes(size));
+                if (!ptr) {
+                    return false;
+                }
+                std::memset(ptr, static_cast<int>(seed), size);
+                live.push_back({ptr, size});
+            } else {
+                size_t at = rng() % live.size();
+                auto [ptr, size] = live[at];
+                ok = ok && ptr[0] == static_cast<unsigned char>(seed) &&
+                     ptr[size - 1] == static_cast<unsigned char>(seed);
+                heap.free_bytes(ptr);
+                live[at] = live.back();
+                live.pop_back();
+            }
+        }
+        for (auto [ptr, size] : live) {
+            heap.free_bytes(ptr);
+        }
+        return ok;
+    };
+    auto run_threads = [&worker](unsigned first_seed) {
+        bool results[kThreads] = {};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&, t] { results[t] = worker(first_seed + t); });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        for (bool result : results) {
+            if (!result) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    std::vector<pid_t> children;
+    for (int p = 1; p < kProcesses; ++p) {
+        fflush(stdout);
+        pid_t pid = fork();
+        assert(pid >= 0);
+        if (pid == 0) {
+            _exit(run_threads(static_cast<unsigned>(p * kThreads + 1)) ? 0 : 1);
+        }
+        children.push_back(pid);
+    }
+    bool ok = run_threads(1);
+    for (pid_t pid : children) {
+        ok = child_succeeded(pid) && ok;
+    }
+    assert(ok);
+    (void)ok;
+    assert(!heap.broken());
+
+    // Freed cells and runs coalesced again: everything past the pinned cells is one run
+    void *big = heap.alloc_bytes(heap.capacity() - pinned.size() * Cell::kCellSize);
+    assert(big != nullptr);
+    heap.free_bytes(big);
+    for (void *ptr : pinned) {
+        heap.free_bytes(ptr);
+    }
+    assert(heap.allocated_bytes() == 0);
+    close(config.fd);
+
+    printf("  PASSED\n");
+}
+
+// Test 6: Freeing a run of cells gives its pages back to the file
+TEST(SharedHeapDiscard) {
+    Cell::SharedHeapConfig config = heap_config();
+    Cell::SharedHeap heap(config);
+
+    constexpr size_t kBig = 8 * 1024 * 1024;
+    auto *ptr = static_cast<char *>(heap.alloc_bytes(kBig));
+    std::memset(ptr, 0xCD, kBig);
+    size_t resident = file_resident_bytes(config.fd);
+    heap.free_bytes(ptr);
+    size_t after = file_resident_bytes(config.fd);
+    printf("  %zu KB resident, %zu KB after free\n", resident / 1024, after / 1024);
+    assert(after + kBig / 2 <= resident);
+    (void)resident;
+    (void)after;
+
+    // Released pages come back zeroed
+    auto *again = static_cast<char *>(heap.alloc_bytes(kBig));
+    assert(again == ptr && again[kBig / 2] == 0);
+    heap.free_bytes(again);
+    close(config.fd);
+
+    printf("  PASSED\n");
+}
+
+// Test 7: Files without a heap are refused
+TEST(SharedHeapInvalid) {
+    int empty = memfd_create("cell_test", 0);
+    Cell::SharedHeap from_empty(empty);
+    assert(!from_empty.valid() && from_empty.base() == nullptr);
+    assert(from_empty.alloc_bytes(64) == nullptr);
+    assert(from_empty.capacity() == 0 && from_empty.allocated_bytes() == 0);
+    from_empty.free_bytes(nullptr);
+
+    std::vector<char> junk(64 * 1024, 0x7F);
+    ssize_t written = write(empty, junk.data(), junk.size());
+    assert(written == static_cast<ssize_t>(junk.size()));
+    (void)written;
+    Cell::SharedHeap from_junk(empty);
+    assert(!from_junk.valid());
+    close(empty);
+
+    Cell::SharedHeap from_bad_fd(-1);
+    assert(!from_bad_fd.valid());
+
+    printf("  PASSED\n");
+}
+
+#else
+
+// Shared heaps need memfd_create() here
+TEST(SharedHeapUnsupported) {
+    printf("  Shared heap tests need Linux, skipped\n");
+    printf("  PASSED\n");
+}
+
+#endif
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    printf("Shared Heap Tests\n");
+    printf("=================\n\n");
+
+    int passed = 0;
+    int failed = 0;
+
+    for (const auto &test : tests) {
+        printf("Running %s...\n", test.name);
+        try {
+            test.fn();
+            ++passed;
+        } catch (...) {
+            printf("  FAILED (exception)\n");
+            ++failed;
+        }
+    }
+
+    printf("\n");
+    printf("Results: %d passed, %d failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,306 @@
+/**
+ * @file test_snapshot.cpp
+ * @brief Tests for Context::snapshot() and its JSON / Prometheus serializers.
+ */
+
+#include "cell/context.h"
+
+#include <cassert>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Simple test helper
+#define TEST(name)                                                                                 \
+    void test_##name();                                                                            \
+    struct Register##name {                                                                        \
+        Register##name() { tests.push_back({#name, test_##name}); }                                \
+    } reg_##name;                                                                                  \
+    void test_##name()
+
+struct TestCase {
+    const char *name;
+    void (*fn)();
+};
+std::vector<TestCase> tests;
+
+static size_t histogram_total(const Cell::BinSnapshot &bin) {
+    size_t total = 0;
+    for (size_t count : bin.free_histogram) {
+        total += count;
+    }
+    return total;
+}
+
+// =============================================================================
+// Snapshot Contents
+// =============================================================================
+
+// Test 1: Half-freed cells show up as partial cells in the middle bucket
+TEST(SnapshotBinFragmentation) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    // Debug guards can move a request up a class, so ask the block itself
+    void *probe = ctx.alloc_bytes(64);
+    size_t bin_index = Cell::get_header(probe)->size_class;
+    ctx.free_bytes(probe);
+
+    constexpr size_t kCells = 8;
+    size_t per_cell = Cell::blocks_per_cell(bin_index);
+    std::vector<void *> blocks;
+    for (size_t i = 0; i < kCells * per_cell; ++i) {
+        blocks.push_back(ctx.alloc_bytes(64));
+    }
+
+    // Keep every other block live, then push the freed ones out of the TLS cache
+    for (size_t i = 0; i < blocks.size(); i += 2) {
+        ctx.free_bytes(blocks[i]);
+    }
+    ctx.flush_tls_caches();
+
+    Cell::HeapSnapshot snapshot = ctx.snapshot();
+    const Cell::BinSnapshot &bin = snapshot.bins[bin_index];
+    printf("  %zuB bin: %zu partial cells, %zu free blocks, %zu allocated\n", bin.block_size,
+           bin.partial_cells, bin.free_blocks, bin.allocated_blocks);
+    assert(bin.block_size == Cell::kSizeClasses[bin_index]);
+    assert(bin.blocks_per_cell == per_cell);
+    assert(bin.partial_cells >= kCells - 1);
+    assert(histogram_total(bin) == bin.partial_cells);
+    size_t half = Cell::kSnapshotFreeBuckets / 2; // Odd block counts round down a bucket
+    assert(bin.free_histogram[half - 1] + bin.free_histogram[half] >= kCells - 2);
+    (void)half;
+    assert(bin.free_blocks >= (kCells - 1) * per_cell / 2);
+    assert(bin.allocated_blocks >= blocks.size() / 2);
+    assert(bin.tls_cached_blocks == 0);
+
+    for (size_t i = 1; i < blocks.size(); i += 2) {
+        ctx.free_bytes(blocks[i]);
+    }
+
+    printf("  PASSED\n");
+}
+
+// Test 2: Blocks and cells parked in the calling thread's caches are reported
+TEST(SnapshotTlsCaches) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    void *block = ctx.alloc_bytes(128);
+    size_t bin_index = Cell::get_header(block)->size_class;
+    ctx.free_bytes(block);
+
+    Cell::CellData *cell = ctx.alloc_cell();
+    ctx.free_cell(cell);
+
+    Cell::HeapSnapshot snapshot = ctx.snapshot();
+    assert(snapshot.bins[bin_index].tls_cached_blocks >= 1);
+    assert(snapshot.tls_cached_cells >= 1);
+
+    ctx.flush_tls_caches();
+    snapshot = ctx.snapshot();
+    assert(snapshot.bins[bin_index].tls_cached_blocks == 0);
+    assert(snapshot.tls_cached_cells == 0);
+    (void)bin_index;
+
+    printf("  PASSED\n");
+}
+
+// Test 3: Buddy, large and superblock figures follow the tiers
+TEST(SnapshotTiers) {
+    Cell::Config config;
+    config.reserve_size = 128 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    void *small = ctx.alloc_bytes(100);
+    void *buddy = ctx.alloc_bytes(300 * 1024);
+    void *large = ctx.alloc_bytes(4 * 1024 * 1024);
+
+    Cell::HeapSnapshot snapshot = ctx.snapshot();
+    auto in_use = static_cast<size_t>(Cell::SuperblockState::kInUse);
+    assert(snapshot.superblocks[in_use] >= 1);
+    assert(snapshot.cell_committed_bytes >= Cell::kSuperblockSize);
+    assert(snapshot.buddy_allocated_bytes >= 300 * 1024);
+    assert(snapshot.buddy_committed_bytes >= Cell::BuddyAllocator::kMaxBlockSize);
+    assert(snapshot.large_allocations == 1);
+    assert(snapshot.large_allocated_bytes >= 4 * 1024 * 1024);
+    assert(snapshot.large_committed_bytes >= snapshot.large_allocated_bytes);
+
+    // Splitting a 2MB block for 512KB leaves one free buddy at each order above it
+    size_t free_orders = 0;
+    for (size_t count : snapshot.buddy_free_blocks) {
+        free_orders += count > 0 ? 1 : 0;
+    }
+    assert(free_orders >= 2);
+    (void)free_orders;
+
+    ctx.free_bytes(small);
+    ctx.free_bytes(buddy);
+    ctx.free_bytes(large);
+
+    snapshot = ctx.snapshot();
+    assert(snapshot.large_allocations == 0);
+    assert(snapshot.large_allocated_bytes == 0);
+
+    printf("  PASSED\n");
+}
+
+// =============================================================================
+// Serializers
+// =============================================================================
+
+// Test 4: JSON holds every section with balanced brackets
+TEST(SnapshotJson) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    void *p = ctx.alloc_bytes(48, 3);
+    std::string json = ctx.snapshot().to_json();
+
+    assert(json.front() == '{' && json.back() == '}');
+    int depth = 0;
+    for (char c : json) {
+        depth += (c == '{' || c == '[') ? 1 : 0;
+        depth -= (c == '}' || c == ']') ? 1 : 0;
+        assert(depth >= 0);
+    }
+    assert(depth == 0);
+    assert(json.find("\"bins\":[{\"block_size\":16,") != std::string::npos);
+    assert(json.find("\"free_histogram\":[") != std::string::npos);
+    assert(json.find("\"superblocks\":{\"uncommitted\":") != std::string::npos);
+    assert(json.find("\"buddy\":{\"free_blocks\":[{\"block_size\":32768,") != std::string::npos);
+    assert(json.find("\"large\":{\"allocations\":0,") != std::string::npos);
+    assert(json.find(",}") == std::string::npos && json.find(",]") == std::string::npos);
+
+    ctx.free_bytes(p);
+    printf("  PASSED\n");
+}
+
+// Test 5: Prometheus output is HELP / TYPE lines followed by name{labels} value samples
+TEST(SnapshotPrometheus) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    void *p = ctx.alloc_bytes(48, 3);
+    std::string text = ctx.snapshot().to_prometheus("game_heap");
+
+    size_t samples = 0;
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        assert(end != std::string::npos && "Every line ends with a newline");
+        std::string line = text.substr(start, end - start);
+        if (line[0] == '#') {
+            assert(line.compare(0, 17, "# HELP game_heap_") == 0 ||
+                   line.compare(0, 17, "# TYPE game_heap_") == 0);
+        } else {
+            assert(line.compare(0, 10, "game_heap_") == 0);
+            size_t space = line.rfind(' ');
+            assert(space != std::string::npos && space + 1 < line.size());
+            for (size_t i = space + 1; i < line.size(); ++i) {
+                assert(line[i] >= '0' && line[i] <= '9');
+            }
+            ++samples;
+        }
+        start = end + 1;
+    }
+    assert(samples > Cell::kNumSizeBins * Cell::kSnapshotFreeBuckets);
+    assert(text.find("# TYPE game_heap_bin_partial_cells gauge\n") != std::string::npos);
+    assert(text.find("game_heap_bin_cells_by_free_fraction{size=\"16\",free_ge=\"0.500\"} ") !=
+           std::string::npos);
+    assert(text.find("game_heap_superblocks{state=\"in_use\"} ") != std::string::npos);
+    assert(text.find("game_heap_buddy_free_blocks{size=\"2097152\"} ") != std::string::npos);
+    (void)samples;
+
+    ctx.free_bytes(p);
+    printf("  PASSED\n");
+}
+
+// Test 6: A scraping thread sees the blocks and cells other threads have cached
+TEST(SnapshotOtherThreadsCaches) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool parked = false;
+    bool done = false;
+    size_t bin_index = 0;
+    std::thread worker([&] {
+        void *block = ctx.alloc_bytes(128);
+        bin_index = Cell::get_header(block)->size_class;
+        ctx.free_bytes(block);
+        ctx.free_cell(ctx.alloc_cell());
+        ctx.free_bytes(ctx.alloc_bytes(64 * 1024));
+
+        std::unique_lock<std::mutex> lock(mutex);
+        parked = true;
+        cv.notify_all();
+        cv.wait(lock, [&] { return done; });
+    });
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return parked; });
+    }
+
+    // This thread has cached nothing
+    Cell::HeapSnapshot snapshot = ctx.snapshot();
+    assert(snapshot.bins[bin_index].tls_cached_blocks >= 1);
+    assert(snapshot.tls_cached_cells >= 1);
+    size_t buddy_cached = 0;
+    for (size_t count : snapshot.buddy_tls_cached_blocks) {
+        buddy_cached += count;
+    }
+    assert(buddy_cached >= 1);
+    (void)buddy_cached;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+    }
+    cv.notify_all();
+    worker.join();
+
+    // The exited thread's caches went back to the Context
+    snapshot = ctx.snapshot();
+    assert(snapshot.bins[bin_index].tls_cached_blocks == 0);
+    assert(snapshot.tls_cached_cells == 0);
+
+    printf("  PASSED\n");
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    printf("Cell Heap Snapshot Tests\n");
+    printf("========================\n\n");
+
+    int passed = 0;
+    int failed = 0;
+
+    for (const auto &test : tests) {
+        printf("Running %s...\n", test.name);
+        try {
+            test.fn();
+            ++passed;
+        } catch (...) {
+            printf("  FAILED (exception)\n");
+            ++failed;
+        }
+    }
+
+    printf("\n");
+    printf("Results: %d passed, %d failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}
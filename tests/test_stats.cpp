@@ -1,7 +1,9 @@
 #include "cell/context.h"
 
+#include <atomic>
 #include <cassert>
 #include <cstdio>
+#include <thread>
 #include <vector>
 
 // Simple test helper
@@ -32,21 +34,20 @@ TEST(StatsBasicTracking) {
     Cell::Context ctx(config);
 
     // Initial state
-    const auto &stats = ctx.get_stats();
-    assert(stats.current_allocated == 0 && "Should start at zero");
+    assert(ctx.get_stats().current_allocated == 0 && "Should start at zero");
 
     // Allocate some memory
     void *p1 = ctx.alloc_bytes(100, 1);
     assert(p1 != nullptr);
 
-    assert(stats.current_allocated > 0 && "Should have allocated");
-    assert(stats.total_allocated > 0 && "Total should increase");
-    assert(stats.subcell_allocs >= 1 && "Should have sub-cell alloc");
+    assert(ctx.get_stats().current_allocated > 0 && "Should have allocated");
+    assert(ctx.get_stats().total_allocated > 0 && "Total should increase");
+    assert(ctx.get_stats().subcell_allocs >= 1 && "Should have sub-cell alloc");
 
     // Free it
     ctx.free_bytes(p1);
-    assert(stats.current_allocated == 0 && "Should be zero after free");
-    assert(stats.subcell_frees >= 1 && "Should have sub-cell free");
+    assert(ctx.get_stats().current_allocated == 0 && "Should be zero after free");
+    assert(ctx.get_stats().subcell_frees >= 1 && "Should have sub-cell free");
 
     printf("  PASSED\n");
 }
@@ -57,26 +58,25 @@ TEST(StatsPeakTracking) {
     config.reserve_size = 64 * 1024 * 1024;
 
     Cell::Context ctx(config);
-    const auto &stats = ctx.get_stats();
 
     // Allocate
     void *p1 = ctx.alloc_bytes(1000, 0);
     void *p2 = ctx.alloc_bytes(2000, 0);
 
-    size_t peak_after_alloc = stats.peak_allocated.load();
+    size_t peak_after_alloc = ctx.get_stats().peak_allocated.load();
 
     // Free one
     ctx.free_bytes(p1);
 
     // Peak should not decrease
-    assert(stats.peak_allocated >= peak_after_alloc && "Peak should not decrease");
+    assert(ctx.get_stats().peak_allocated >= peak_after_alloc && "Peak should not decrease");
 
     ctx.free_bytes(p2);
 
     // Peak should still be preserved
-    assert(stats.peak_allocated >= peak_after_alloc && "Peak should persist after free");
+    assert(ctx.get_stats().peak_allocated >= peak_after_alloc && "Peak should persist after free");
 
-    printf("  Peak: %zu bytes\n", stats.peak_allocated.load());
+    printf("  Peak: %zu bytes\n", ctx.get_stats().peak_allocated.load());
     printf("  PASSED\n");
 }
 
@@ -86,15 +86,14 @@ TEST(StatsPerTagTracking) {
     config.reserve_size = 64 * 1024 * 1024;
 
     Cell::Context ctx(config);
-    const auto &stats = ctx.get_stats();
 
     // Allocate with different tags
     void *p1 = ctx.alloc_bytes(500, 10);
     void *p2 = ctx.alloc_bytes(1000, 20);
     void *p3 = ctx.alloc_bytes(1500, 10); // Same tag as p1
 
-    size_t tag10 = stats.per_tag_current[10].load();
-    size_t tag20 = stats.per_tag_current[20].load();
+    size_t tag10 = ctx.get_stats().per_tag_current[10].load();
+    size_t tag20 = ctx.get_stats().per_tag_current[20].load();
 
     printf("  Tag 10: %zu bytes\n", tag10);
     printf("  Tag 20: %zu bytes\n", tag20);
@@ -115,24 +114,24 @@ TEST(StatsAllocatorTypes) {
     config.reserve_size = 128 * 1024 * 1024;
 
     Cell::Context ctx(config);
-    const auto &stats = ctx.get_stats();
 
     // Sub-cell allocation
     void *p1 = ctx.alloc_bytes(100, 0);
-    assert(stats.subcell_allocs >= 1);
+    assert(ctx.get_stats().subcell_allocs >= 1);
 
     // Full cell allocation
     void *p2 = ctx.alloc_bytes(10 * 1024, 0); // 10KB -> full cell
-    assert(stats.cell_allocs >= 1);
+    assert(ctx.get_stats().cell_allocs >= 1);
 
     // Buddy allocation
     void *p3 = ctx.alloc_bytes(64 * 1024, 0); // 64KB -> buddy
-    assert(stats.buddy_allocs >= 1);
+    assert(ctx.get_stats().buddy_allocs >= 1);
 
     // Large allocation
     void *p4 = ctx.alloc_bytes(4 * 1024 * 1024, 0); // 4MB -> large
-    assert(stats.large_allocs >= 1);
+    assert(ctx.get_stats().large_allocs >= 1);
 
+    const auto &stats = ctx.get_stats();
     printf("  SubCell: %zu, Cell: %zu, Buddy: %zu, Large: %zu\n", stats.subcell_allocs.load(),
            stats.cell_allocs.load(), stats.buddy_allocs.load(), stats.large_allocs.load());
 
@@ -173,20 +172,93 @@ TEST(StatsReset) {
     config.reserve_size = 64 * 1024 * 1024;
 
     Cell::Context ctx(config);
-    const auto &stats = ctx.get_stats();
 
     // Make allocations
     void *p = ctx.alloc_bytes(1000, 0);
-    assert(stats.total_allocated > 0);
+    assert(ctx.get_stats().total_allocated > 0);
 
     ctx.free_bytes(p);
 
     // Reset
     ctx.reset_stats();
 
-    assert(stats.total_allocated == 0 && "Total should be reset");
-    assert(stats.total_freed == 0 && "Freed should be reset");
-    assert(stats.peak_allocated == 0 && "Peak should be reset");
+    assert(ctx.get_stats().total_allocated == 0 && "Total should be reset");
+    assert(ctx.get_stats().total_freed == 0 && "Freed should be reset");
+    assert(ctx.get_stats().peak_allocated == 0 && "Peak should be reset");
+
+    printf("  PASSED\n");
+}
+
+// Test 7: Per-thread counters are summed while threads run and kept after they exit
+TEST(StatsThreadShards) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+
+    Cell::Context ctx(config);
+    constexpr int kThreads = 4;
+    constexpr int kBlocks = 1000;
+    constexpr size_t kBlockSize = 64;
+
+    // Blocks are counted at their size class (plus guards in debug builds)
+    void *probe = ctx.alloc_bytes(kBlockSize, 5);
+    const size_t block_bytes = ctx.get_stats().current_allocated;
+    ctx.free_bytes(probe);
+    ctx.reset_stats();
+    const size_t expected = kThreads * kBlocks * block_bytes;
+
+    std::vector<std::vector<void *>> blocks(kThreads);
+    std::atomic<int> ready{0};
+    std::atomic<bool> release{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < kBlocks; ++i) {
+                blocks[t].push_back(ctx.alloc_bytes(kBlockSize, 5));
+            }
+            ready.fetch_add(1);
+            while (!release.load()) {
+                std::this_thread::yield();
+            }
+        });
+    }
+    while (ready.load() < kThreads) {
+        std::this_thread::yield();
+    }
+
+    // Still-running threads hold their counts in their own shards
+    assert(ctx.get_stats().current_allocated == expected);
+    assert(ctx.get_stats().per_tag_current[5] == expected);
+    assert(ctx.get_stats().subcell_allocs == kThreads * kBlocks);
+    assert(ctx.get_stats().peak_allocated >= expected);
+
+    release.store(true);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    // Exited threads folded their shards into the Context
+    assert(ctx.get_stats().current_allocated == expected);
+    assert(ctx.get_stats().total_allocated == expected);
+
+    // Frees on another thread cancel out in the sum
+    for (auto &list : blocks) {
+        for (void *p : list) {
+            ctx.free_bytes(p);
+        }
+    }
+    const auto &stats = ctx.get_stats();
+    assert(stats.current_allocated == 0);
+    assert(stats.per_tag_current[5] == 0);
+    assert(stats.subcell_frees == kThreads * kBlocks);
+    assert(stats.peak_allocated >= expected);
+    (void)expected;
+
+    // Counting restarts from the reset even with exited threads' totals folded in
+    ctx.reset_stats();
+    void *p = ctx.alloc_bytes(kBlockSize, 5);
+    assert(ctx.get_stats().total_allocated == block_bytes);
+    assert(ctx.get_stats().peak_allocated == block_bytes);
+    ctx.free_bytes(p);
 
     printf("  PASSED\n");
 }
@@ -13,8 +13,10 @@
 #include <atomic>
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
 #include <cstdio>
 #include <cstring>
+#include <mutex>
 #include <random>
 #include <thread>
 #include <vector>
@@ -529,6 +531,340 @@ TEST(MaxAlignmentRequest) {
     printf("  PASSED\n");
 }
 
+// Test 19: Cross-thread frees of blocks from cells other threads own
+TEST(OwnedCellHandoff) {
+    Cell::Context ctx;
+    constexpr int num_threads = 4;
+    constexpr int rounds = 3;
+    constexpr size_t per_thread = 600;
+    const size_t sizes[] = {64, 8192};
+
+    for (size_t size : sizes) {
+        std::vector<std::vector<void *>> blocks(num_threads);
+        std::atomic<int> arrived{0};
+
+        // Every thread waits for the others between phases
+        auto sync = [&arrived](int phase) {
+            arrived.fetch_add(1);
+            while (arrived.load() < phase * num_threads) {
+                std::this_thread::yield();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; ++t) {
+            threads.emplace_back([&, t]() {
+                int phase = 0;
+                for (int round = 0; round < rounds; ++round) {
+                    // Fill (and adopt) cells, stamping each block with our id
+                    for (size_t i = 0; i < per_thread; ++i) {
+                        void *p = ctx.alloc_bytes(size);
+                        assert(p != nullptr);
+                        std::memset(p, t + 1, size);
+                        blocks[t].push_back(p);
+                    }
+                    sync(++phase);
+
+                    // Free a neighbour's blocks while it still owns their cells
+                    int victim = (t + 1) % num_threads;
+                    for (void *p : blocks[victim]) {
+                        auto *bytes = static_cast<uint8_t *>(p);
+                        assert(bytes[0] == victim + 1 && bytes[size - 1] == victim + 1);
+                        (void)bytes;
+                        ctx.free_bytes(p);
+                    }
+                    blocks[victim].clear();
+                    sync(++phase);
+                }
+                ctx.flush_tls_caches();
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+
+    // No block may have been lost or handed out twice
+    std::vector<void *> ptrs;
+    for (int i = 0; i < 4000; ++i) {
+        void *p = ctx.alloc_bytes(64);
+        assert(p != nullptr);
+        ptrs.push_back(p);
+    }
+    std::sort(ptrs.begin(), ptrs.end());
+    assert(std::adjacent_find(ptrs.begin(), ptrs.end()) == ptrs.end() && "Duplicate block");
+    for (void *p : ptrs) {
+        ctx.free_bytes(p);
+    }
+
+    printf("  PASSED\n");
+}
+
+// Test 20: Sized frees route by size on every tier and survive a stale size
+TEST(SizedFreeAllTiers) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    const size_t sizes[] = {64, 8192, 12000, 100000, 3 * 1024 * 1024};
+    for (int round = 0; round < 4; ++round) {
+        for (size_t size : sizes) {
+            void *p = ctx.alloc_bytes(size);
+            assert(p != nullptr);
+            std::memset(p, 0x5A, size);
+            ctx.free_sized(p, size);
+        }
+    }
+
+    // The sub-cell path returns the block to the TLS cache it would come from next
+    void *a = ctx.alloc_bytes(64);
+    ctx.free_sized(a, 64);
+    void *again = ctx.alloc_bytes(64);
+    assert(again == a);
+    ctx.free_sized(again, 64);
+
+    // A size that no longer matches the block falls back to the unsized path
+    void *moved = ctx.realloc_bytes(ctx.alloc_bytes(100), 5000);
+    assert(moved != nullptr);
+    ctx.free_sized(moved, 100);
+    void *moved_again = ctx.alloc_bytes(5000);
+    assert(moved_again == moved && "Block should be back in the 5KB bin");
+    ctx.free_sized(moved_again, 5000);
+
+    // Over-aligned small blocks come from, and go back to, their power-of-2 bin
+    void *aligned = ctx.alloc_aligned(256, 64);
+    assert(aligned != nullptr && reinterpret_cast<uintptr_t>(aligned) % 64 == 0);
+    ctx.free_aligned_sized(aligned, 256, 64);
+    aligned = ctx.alloc_bytes(48, 0, 16);
+    ctx.free_aligned_sized(aligned, 48, 16);
+
+    // Containers free through StlAllocator::deallocate(p, n)
+    {
+        Cell::StlAllocator<int> alloc(ctx);
+        std::vector<int, Cell::StlAllocator<int>> vec(alloc);
+        for (int i = 0; i < 100000; ++i) {
+            vec.push_back(i);
+        }
+        assert(vec[99999] == 99999);
+    }
+
+    printf("  PASSED\n");
+}
+
+// Test 21: A thread that exits without flushing hands its caches back
+TEST(ThreadExitReturnsCaches) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    void *small = nullptr;
+    void *medium = nullptr;
+    std::thread([&] {
+        small = ctx.alloc_bytes(64);
+        medium = ctx.alloc_bytes(100000);
+        assert(small != nullptr && medium != nullptr);
+        ctx.free_bytes(small);
+        ctx.free_bytes(medium);
+        // No flush_tls_caches(): both stay in this thread's caches until it exits
+    }).join();
+
+    auto cell_of = [](void *p) { return reinterpret_cast<uintptr_t>(p) & ~(Cell::kCellSize - 1); };
+    void *reused = ctx.alloc_bytes(64);
+    assert(cell_of(reused) == cell_of(small) && "Exited thread's cell should be reusable");
+    void *reused_medium = ctx.alloc_bytes(100000);
+    assert(reused_medium == medium && "Exited thread's buddy block should be reusable");
+    ctx.free_bytes(reused);
+    ctx.free_bytes(reused_medium);
+
+    // A thread that outlives its Context must not touch it on exit, even once a new
+    // Context has taken over the same slot index
+    auto *doomed = new Cell::Context(config);
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool allocated = false;
+    bool may_exit = false;
+    std::thread worker([&] {
+        doomed->free_bytes(doomed->alloc_bytes(64));
+        std::unique_lock<std::mutex> lock(mutex);
+        allocated = true;
+        cv.notify_all();
+        cv.wait(lock, [&] { return may_exit; });
+    });
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return allocated; });
+    }
+    delete doomed;
+    Cell::Context successor(config);
+    successor.free_bytes(successor.alloc_bytes(64));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        may_exit = true;
+    }
+    cv.notify_all();
+    worker.join();
+    successor.free_bytes(successor.alloc_bytes(64));
+
+    printf("  PASSED\n");
+}
+
+// Test 22: Caches of a parked thread are reclaimed and the thread carries on
+TEST(IdleThreadReclaim) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool parked = false;
+    bool wake = false;
+    void *medium = nullptr;
+    std::thread worker([&] {
+        medium = ctx.alloc_bytes(100000);
+        ctx.free_bytes(medium);
+        ctx.free_bytes(ctx.alloc_bytes(64));
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            parked = true;
+            cv.notify_all();
+            cv.wait(lock, [&] { return wake; });
+        }
+        // Caches were emptied underneath; they refill as usual
+        for (int i = 0; i < 1000; ++i) {
+            void *p = ctx.alloc_bytes(64);
+            assert(p != nullptr);
+            std::memset(p, 0x11, 64);
+            ctx.free_bytes(p);
+        }
+    });
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return parked; });
+    }
+
+    // The first pass only notes each thread's activity
+    const uint32_t idle_ms = 10;
+    assert(ctx.reclaim_idle_tls_caches(idle_ms) == 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(idle_ms * 3));
+    assert(ctx.reclaim_idle_tls_caches(idle_ms) == 1);
+    assert(ctx.reclaim_idle_tls_caches(idle_ms) == 0 && "Already released while idle");
+
+    void *reused = ctx.alloc_bytes(100000);
+    assert(reused == medium && "Parked thread's buddy block should be reusable");
+    ctx.free_bytes(reused);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        wake = true;
+    }
+    cv.notify_all();
+    worker.join();
+
+    printf("  PASSED\n");
+}
+
+// Test 23: Reclaims racing live threads never hand a block out twice
+TEST(ReclaimAlongsideLiveThreads) {
+    Cell::Config config;
+    config.reserve_size = 128 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    constexpr int kProducers = 4;
+    constexpr int kConsumers = 3;
+    constexpr int kBlocksPerProducer = 20000;
+    const size_t sizes[] = {16, 64, 256, 2048, 20000};
+
+    std::mutex mutex;
+    struct Block {
+        uint64_t *ptr;
+        size_t size;
+        uint64_t stamp;
+    };
+    std::vector<Block> handoff;
+    std::atomic<int> producing{kProducers};
+    std::atomic<bool> corrupted{false};
+    std::atomic<bool> stop{false};
+
+    // Each allocation stamps both ends with a value of its own; a block handed out
+    // twice gets the other owner's stamp
+    auto stamp = [](const Block &block) {
+        block.ptr[0] = block.stamp;
+        block.ptr[block.size / sizeof(uint64_t) - 1] = block.stamp;
+    };
+    auto check_and_free = [&](const Block &block) {
+        if (block.ptr[0] != block.stamp ||
+            block.ptr[block.size / sizeof(uint64_t) - 1] != block.stamp) {
+            corrupted = true;
+        }
+        ctx.free_bytes(block.ptr);
+    };
+
+    std::thread reclaimer([&] {
+        size_t reclaimed = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            reclaimed += ctx.reclaim_idle_tls_caches(0);
+        }
+        printf("  %zu thread caches reclaimed\n", reclaimed);
+    });
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < kProducers; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < kBlocksPerProducer; ++i) {
+                size_t size = sizes[i % 5];
+                Block block{static_cast<uint64_t *>(ctx.alloc_bytes(size)), size,
+                            (uint64_t(p + 1) << 32) | uint64_t(i)};
+                assert(block.ptr != nullptr);
+                stamp(block);
+                // Keep some blocks local so each thread's own caches see frees too
+                if (i % 3 == 0) {
+                    check_and_free(block);
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(mutex);
+                // Bound the blocks in flight (queued plus each consumer's batch) well
+                // below the buddy tier's 64MB
+                while (handoff.size() >= 512) {
+                    lock.unlock();
+                    std::this_thread::yield();
+                    lock.lock();
+                }
+                handoff.push_back(block);
+            }
+            producing.fetch_sub(1);
+        });
+    }
+    for (int c = 0; c < kConsumers; ++c) {
+        threads.emplace_back([&] {
+            std::vector<Block> batch;
+            while (true) {
+                bool done = producing.load() == 0;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    batch.swap(handoff);
+                }
+                if (batch.empty() && done) {
+                    break;
+                }
+                for (const Block &block : batch) {
+                    check_and_free(block);
+                }
+                batch.clear();
+                std::this_thread::yield();
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    stop = true;
+    reclaimer.join();
+
+    assert(!corrupted && "A block was handed to two allocations at once");
+
+    printf("  PASSED\n");
+}
+
 // =============================================================================
 // Main
 // =============================================================================
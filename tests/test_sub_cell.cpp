@@ -1,5 +1,6 @@
 #include "cell/context.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cstdio>
@@ -164,7 +165,7 @@ TEST(CellReuse) {
     Cell::Context ctx(config);
 
     // Figure out how many 64-byte blocks fit in a cell
-    size_t blocks_per_cell = Cell::blocks_per_cell(2); // bin 2 = 64 bytes
+    size_t blocks_per_cell = Cell::blocks_per_cell(Cell::get_size_class_fast(64));
     printf("  Blocks per cell (64B): %zu\n", blocks_per_cell);
 
     // Allocate exactly one cell's worth
@@ -300,8 +301,8 @@ TEST(DebugPoisonDetection) {
 
     // Check if poisoned (don't dereference in real code!)
     // This is just for testing.
-    // Note: First sizeof(FreeBlock*) bytes are overwritten by free list pointer
-    constexpr size_t skip_bytes = sizeof(void *);
+    // Note: The first sizeof(FreeBlock) bytes are overwritten by the free list link
+    constexpr size_t skip_bytes = sizeof(Cell::FreeBlock);
     bool poisoned = true;
     for (size_t i = skip_bytes; i < 64; ++i) {
         if (ptr[i] != Cell::kPoisonByte) {
@@ -670,6 +671,594 @@ TEST(StlAllocatorRebind) {
     printf("  PASSED\n");
 }
 
+// =============================================================================
+// Cross-Thread Free Tests (remote free queues)
+// =============================================================================
+
+// Test 25: Blocks freed by another thread are reused by the allocating thread
+TEST(CrossThreadFreeReturnsToOwner) {
+    Cell::Config config;
+    config.reserve_size = 16 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    constexpr size_t count = 64;
+    std::vector<void *> ptrs;
+    for (size_t i = 0; i < count; ++i) {
+        void *p = ctx.alloc_bytes(64, 0);
+        assert(p != nullptr);
+        ptrs.push_back(p);
+    }
+
+    // Consumer frees everything; blocks go to our remote queue, not its TLS cache
+    std::thread consumer([&]() {
+        for (void *p : ptrs) {
+            ctx.free_bytes(p);
+        }
+    });
+    consumer.join();
+
+    // Whatever our TLS cache still holds is handed out first; the next miss
+    // must be served from the blocks the consumer handed back
+    std::vector<void *> reused;
+    bool found = false;
+    while (!found && reused.size() <= Cell::kTlsBinCacheCapacity) {
+        void *r = ctx.alloc_bytes(64, 0);
+        assert(r != nullptr);
+        reused.push_back(r);
+        for (void *p : ptrs) {
+            found = found || p == r;
+        }
+    }
+    assert(found && "Owner should reuse blocks freed by another thread");
+
+    for (void *r : reused) {
+        ctx.free_bytes(r);
+    }
+    printf("  PASSED\n");
+}
+
+// Test 26: A released remote queue is adopted and drained by a later thread
+TEST(CrossThreadFreeAfterOwnerExit) {
+    Cell::Config config;
+    config.reserve_size = 16 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    constexpr size_t count = 200;
+    std::vector<void *> ptrs(count);
+
+    std::thread producer([&]() {
+        for (size_t i = 0; i < count; ++i) {
+            ptrs[i] = ctx.alloc_bytes(128, 0);
+            assert(ptrs[i] != nullptr);
+            std::memset(ptrs[i], 0x5A, 128);
+        }
+        ctx.flush_tls_caches();
+    });
+    producer.join();
+
+    // Producer's queue is released; these frees land in it for the next owner
+    for (void *p : ptrs) {
+        ctx.free_bytes(p);
+    }
+
+    std::thread adopter([&]() {
+        for (size_t round = 0; round < 4; ++round) {
+            std::vector<void *> local;
+            for (size_t i = 0; i < count; ++i) {
+                void *p = ctx.alloc_bytes(128, 0);
+                assert(p != nullptr);
+                std::memset(p, 0xA5, 128);
+                local.push_back(p);
+            }
+            for (void *p : local) {
+                ctx.free_bytes(p);
+            }
+        }
+        ctx.flush_tls_caches();
+    });
+    adopter.join();
+
+    ctx.flush_tls_caches();
+    printf("  PASSED\n");
+}
+
+// =============================================================================
+// Multiple Context Tests (per-Context TLS slots)
+// =============================================================================
+
+// Test 27: Interleaved Contexts on one thread never hand out each other's blocks
+TEST(InterleavedContextsStayIsolated) {
+    Cell::Config config;
+    config.reserve_size = 16 * 1024 * 1024;
+    Cell::Context ctx_a(config);
+    Cell::Context ctx_b(config);
+
+    constexpr size_t count = 100;
+    std::vector<void *> a_ptrs;
+    for (size_t i = 0; i < count; ++i) {
+        void *p = ctx_a.alloc_bytes(32, 0);
+        assert(p != nullptr);
+        std::memset(p, 0xAA, 32);
+        a_ptrs.push_back(p);
+    }
+
+    // Freed A blocks sit in A's TLS cache; B must not pick them up
+    for (void *p : a_ptrs) {
+        ctx_a.free_bytes(p);
+    }
+
+    std::vector<void *> b_ptrs;
+    for (size_t i = 0; i < count; ++i) {
+        void *p = ctx_b.alloc_bytes(32, 0);
+        assert(p != nullptr);
+        for (void *a : a_ptrs) {
+            assert(p != a && "Context B returned a block owned by Context A");
+        }
+        std::memset(p, 0xBB, 32);
+        b_ptrs.push_back(p);
+    }
+
+    // A still reuses its own cached blocks
+    void *reused = ctx_a.alloc_bytes(32, 0);
+    bool found = false;
+    for (void *a : a_ptrs) {
+        found = found || a == reused;
+    }
+    assert(found && "Context A should reuse its own cached blocks");
+    ctx_a.free_bytes(reused);
+
+    for (void *p : b_ptrs) {
+        assert(static_cast<unsigned char *>(p)[0] == 0xBB);
+        ctx_b.free_bytes(p);
+    }
+    printf("  PASSED\n");
+}
+
+// Test 28: A worker's cache for a destroyed Context is dropped when its slot is reused
+TEST(ReusedSlotDropsStaleCache) {
+    Cell::Config config;
+    config.reserve_size = 16 * 1024 * 1024;
+
+    std::atomic<int> phase{0};
+    Cell::Context *ctx = new Cell::Context(config);
+
+    std::thread worker([&]() {
+        // Leave blocks and cells cached for the first Context, without flushing
+        void *p = ctx->alloc_bytes(64, 0);
+        assert(p != nullptr);
+        ctx->free_bytes(p);
+        void *cell = ctx->alloc_bytes(8 * 1024, 0);
+        assert(cell != nullptr);
+        ctx->free_bytes(cell);
+        phase.store(1);
+
+        while (phase.load() != 2) {
+            std::this_thread::yield();
+        }
+
+        // Same slot index, new owner: stale pointers into unmapped memory must not be used
+        for (size_t i = 0; i < 200; ++i) {
+            void *q = ctx->alloc_bytes(64, 0);
+            assert(q != nullptr);
+            std::memset(q, 0x5A, 64);
+            ctx->free_bytes(q);
+        }
+        ctx->flush_tls_caches();
+    });
+
+    while (phase.load() != 1) {
+        std::this_thread::yield();
+    }
+    delete ctx;
+    ctx = new Cell::Context(config);
+    phase.store(2);
+
+    worker.join();
+    delete ctx;
+    printf("  PASSED\n");
+}
+
+// Test 29: Contexts beyond the TLS slot limit fall back to the locked paths
+TEST(MoreContextsThanTlsSlots) {
+    Cell::Config config;
+    config.reserve_size = 8 * 1024 * 1024;
+
+    constexpr size_t num_contexts = Cell::kMaxTlsContexts + 4;
+    std::vector<Cell::Context *> contexts;
+    std::vector<std::vector<void *>> ptrs(num_contexts);
+
+    for (size_t c = 0; c < num_contexts; ++c) {
+        contexts.push_back(new Cell::Context(config));
+    }
+
+    for (size_t round = 0; round < 3; ++round) {
+        for (size_t c = 0; c < num_contexts; ++c) {
+            for (size_t i = 0; i < 40; ++i) {
+                void *p = contexts[c]->alloc_bytes(48, 0);
+                assert(p != nullptr);
+                std::memset(p, static_cast<int>(c), 48);
+                ptrs[c].push_back(p);
+            }
+        }
+        for (size_t c = 0; c < num_contexts; ++c) {
+            for (void *p : ptrs[c]) {
+                assert(static_cast<unsigned char *>(p)[47] == static_cast<unsigned char>(c));
+                contexts[c]->free_bytes(p);
+            }
+            ptrs[c].clear();
+        }
+    }
+
+    for (Cell::Context *ctx : contexts) {
+        delete ctx;
+    }
+    printf("  PASSED\n");
+}
+
+// =============================================================================
+// Size Class Table Tests
+// =============================================================================
+
+// Test 30: O(1) lookup picks the tightest class for every sub-cell size
+TEST(SizeClassLookupIsTight) {
+    for (size_t size = 1; size <= Cell::kMaxSubCellSize; ++size) {
+        uint8_t bin = Cell::get_size_class_fast(size);
+        assert(bin < Cell::kNumSizeBins);
+        assert(Cell::kSizeClasses[bin] >= size && "Class too small for request");
+        assert((bin == 0 || Cell::kSizeClasses[bin - 1] < size) && "A tighter class exists");
+        assert(Cell::get_size_class(size, 8) == bin && "Slow and fast lookup disagree");
+    }
+    assert(Cell::get_size_class_fast(Cell::kMaxSubCellSize + 1) == Cell::kFullCellMarker);
+
+    // Over-aligned requests still land on a power-of-2 class >= alignment
+    assert(Cell::kSizeClasses[Cell::get_size_class(40, 64)] == 64);
+    assert(Cell::kSizeClasses[Cell::get_size_class(300, 512)] == 512);
+    printf("  PASSED\n");
+}
+
+// Test 31: Common non-power-of-2 sizes waste at most 25% of their block
+TEST(SpacedClassesBoundWaste) {
+    Cell::Config config;
+    config.reserve_size = 16 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    const size_t sizes[] = {48, 80, 96, 160, 200, 700, 3000, 5000};
+    for (size_t size : sizes) {
+        uint8_t bin = Cell::get_size_class_fast(size);
+        size_t block = Cell::kSizeClasses[bin];
+        assert(block - size <= block / 4 && "Internal fragmentation above 25%");
+
+        void *a = ctx.alloc_bytes(size, 0);
+        void *b = ctx.alloc_bytes(size, 0);
+        assert(a && b && a != b);
+        assert(reinterpret_cast<uintptr_t>(a) % Cell::kSizeClassGranularity == 0);
+        assert(reinterpret_cast<uintptr_t>(b) % Cell::kSizeClassGranularity == 0);
+        std::memset(a, 0x11, size);
+        std::memset(b, 0x22, size);
+        ctx.free_bytes(a);
+        ctx.free_bytes(b);
+    }
+    printf("  PASSED\n");
+}
+
+// Test 32: TLS bin caches grow on misses, shrink on overflows, and respect the ceiling
+TEST(AdaptiveTlsBinCapacity) {
+    Cell::Config config;
+    config.reserve_size = 32 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    // Debug guards enlarge each block, but not out of the 3KB class
+    const size_t bin = Cell::get_size_class_fast(3000);
+    assert(ctx.tls_bin_capacity(bin) == 0 && "No cache before the thread allocates");
+
+    // Allocation bursts miss over and over: the cache grows
+    std::vector<void *> ptrs;
+    for (int i = 0; i < 512; ++i) {
+        ptrs.push_back(ctx.alloc_bytes(3000, 0));
+        assert(ptrs.back() != nullptr);
+    }
+    size_t grown = ctx.tls_bin_capacity(bin);
+    assert(grown >= 16 && grown <= Cell::kTlsBinCacheCapacity);
+    assert(grown * Cell::kSizeClasses[bin] <= config.tls_bin_cache_bytes && "Capacity above the ceiling");
+
+    // Frees with no allocations in between overflow repeatedly: it shrinks again
+    for (void *p : ptrs) {
+        ctx.free_bytes(p);
+    }
+    assert(ctx.tls_bin_capacity(bin) < grown);
+
+    // A zero ceiling pins every bin at its initial capacity
+    Cell::Config tight = config;
+    tight.tls_bin_cache_bytes = 0;
+    Cell::Context pinned(tight);
+    ptrs.clear();
+    for (int i = 0; i < 64; ++i) {
+        ptrs.push_back(pinned.alloc_bytes(3000, 0));
+    }
+    for (void *p : ptrs) {
+        pinned.free_bytes(p);
+    }
+    assert(pinned.tls_bin_capacity(bin) == Cell::kTlsBinCacheMinCapacity);
+
+    ctx.flush_tls_caches();
+    pinned.flush_tls_caches();
+    printf("  PASSED\n");
+}
+
+// Test 33: Bulk batches are carved from fresh cells in address order
+TEST(BulkCarveAndContiguous) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    const size_t bin = Cell::get_size_class_fast(64);
+    const size_t per_cell = Cell::blocks_per_cell(bin);
+    const size_t count = 10000;
+    std::vector<void *> ptrs(count);
+
+    size_t allocated = ctx.alloc_batch(64, ptrs.data(), count);
+    assert(allocated == count);
+
+    // A cold cache: the first cell's worth is one run of consecutive blocks
+    auto *first = static_cast<char *>(ptrs[0]);
+    for (size_t i = 1; i < per_cell; ++i) {
+        assert(ptrs[i] == first + i * 64 && "Carved blocks should be in address order");
+    }
+    std::vector<void *> sorted = ptrs;
+    std::sort(sorted.begin(), sorted.end());
+    assert(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+    ctx.free_batch(ptrs.data(), count);
+
+    // One contiguous span; the rest of its cell stays available
+    auto *span = static_cast<char *>(ctx.alloc_contiguous(64, 100, 3));
+    assert(span != nullptr);
+    std::memset(span, 0x11, 64 * 100);
+    assert(Cell::get_header(span)->tag == 3);
+    for (size_t i = 0; i < 100; ++i) {
+        ctx.free_bytes(span + i * 64);
+    }
+
+    assert(ctx.alloc_contiguous(64, per_cell + 1) == nullptr && "Span must fit in one cell");
+    assert(ctx.alloc_contiguous(Cell::kMaxSubCellSize + 1, 1) == nullptr);
+    assert(ctx.alloc_contiguous(64, 0) == nullptr);
+
+    span = static_cast<char *>(ctx.alloc_contiguous(64, per_cell));
+    assert(span != nullptr);
+    for (size_t i = 0; i < per_cell; ++i) {
+        ctx.free_bytes(span + i * 64);
+    }
+
+    ctx.flush_tls_caches();
+    printf("  PASSED (%zu blocks per 64B cell)\n", per_cell);
+}
+
+// Test 34: Fresh cells hand out untouched blocks lazily and reuse freed ones first
+TEST(LazyCellBlocks) {
+    Cell::Config config;
+    config.reserve_size = 32 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    const size_t bin = Cell::get_size_class_fast(16);
+    const size_t per_cell = Cell::blocks_per_cell(bin);
+    const size_t count = per_cell * 2 + 5;
+
+    // Every block lies on the cell's block grid, and none is handed out twice
+    std::vector<void *> ptrs;
+    for (size_t i = 0; i < count; ++i) {
+        void *ptr = ctx.alloc_bytes(16, 0);
+        assert(ptr != nullptr);
+        size_t offset = reinterpret_cast<uintptr_t>(ptr) & (Cell::kCellSize - 1);
+        assert(offset >= Cell::kBlockStartOffset);
+        assert((offset - Cell::kBlockStartOffset) % Cell::kSizeClasses[bin] == 0);
+        assert(offset + Cell::kSizeClasses[bin] <= Cell::kCellSize);
+        std::memset(ptr, 0x42, 16);
+        ptrs.push_back(ptr);
+    }
+
+    // Free every other block and allocate as many again: freed blocks mix with the tail
+    for (size_t i = 0; i < count; i += 2) {
+        ctx.free_bytes(ptrs[i]);
+        ptrs[i] = nullptr;
+    }
+    for (size_t i = 0; i < count; i += 2) {
+        ptrs[i] = ctx.alloc_bytes(16, 0);
+        assert(ptrs[i] != nullptr);
+    }
+    std::vector<void *> sorted = ptrs;
+    std::sort(sorted.begin(), sorted.end());
+    assert(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end() &&
+           "A block was handed out twice");
+
+    // Emptied cells go back to handing out blocks in address order
+    for (void *ptr : ptrs) {
+        ctx.free_bytes(ptr);
+    }
+    ctx.flush_tls_caches();
+    void *again[4];
+    for (void *&ptr : again) {
+        ptr = ctx.alloc_bytes(16, 0);
+        assert(ptr != nullptr);
+    }
+    for (void *ptr : again) {
+        ctx.free_bytes(ptr);
+    }
+
+    ctx.flush_tls_caches();
+    printf("  PASSED (%zu blocks per 16B cell)\n", per_cell);
+}
+
+// Test 35: Small over-aligned requests come from power-of-2 bins at full density
+TEST(OverAlignedSmallBlocks) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    const size_t alignments[] = {32, 64, 128, 256, 1024, 4096};
+    const size_t sizes[] = {1, 24, 64, 100, 3000};
+    for (size_t alignment : alignments) {
+        for (size_t size : sizes) {
+            uint8_t bin = Cell::get_size_class(size, alignment);
+            assert(bin != Cell::kFullCellMarker);
+            size_t class_size = Cell::kSizeClasses[bin];
+            assert(class_size % alignment == 0 && (class_size & (class_size - 1)) == 0);
+            (void)class_size;
+
+            // Enough blocks to span more than one cell, so every stride is checked
+            std::vector<void *> ptrs;
+            for (size_t i = 0; i < Cell::blocks_per_cell(bin) + 3; ++i) {
+                void *ptr = ctx.alloc_aligned(size, alignment, 0);
+                assert(ptr != nullptr);
+                assert(reinterpret_cast<uintptr_t>(ptr) % alignment == 0 && "Misaligned block");
+                assert(Cell::get_header(ptr)->size_class == bin && "Not served by a bin");
+                assert(ctx.usable_size(ptr) == class_size);
+                std::memset(ptr, 0x5A, size);
+                ptrs.push_back(ptr);
+            }
+            for (size_t i = 0; i < ptrs.size(); ++i) {
+                if (i % 2 == 0) {
+                    ctx.free_aligned_sized(ptrs[i], size, alignment);
+                } else {
+                    ctx.free_bytes(ptrs[i]);
+                }
+            }
+
+            // alloc_bytes() takes the same alignments directly
+            void *direct = ctx.alloc_bytes(size, 0, alignment);
+            assert(direct != nullptr && reinterpret_cast<uintptr_t>(direct) % alignment == 0);
+            ctx.free_aligned_sized(direct, size, alignment);
+        }
+    }
+
+    // Aligning the block start costs no blocks in any power-of-2 class
+    for (size_t bin = 0; bin < Cell::kNumSizeBins; ++bin) {
+        assert(Cell::blocks_per_cell(bin) ==
+               (Cell::kCellSize - Cell::kBlockStartOffset) / Cell::kSizeClasses[bin]);
+    }
+
+    // Beyond the size classes alloc_bytes() refuses, alloc_aligned() uses larger tiers
+    void *too_big = ctx.alloc_bytes(8200, 0, 32);
+    void *too_aligned = ctx.alloc_bytes(64, 0, 16384);
+    assert(too_big == nullptr && too_aligned == nullptr);
+    (void)too_big;
+    (void)too_aligned;
+    void *big = ctx.alloc_aligned(64, 16384, 0);
+    assert(big != nullptr && reinterpret_cast<uintptr_t>(big) % 16384 == 0);
+    ctx.free_aligned_sized(big, 64, 16384);
+
+    ctx.flush_tls_caches();
+    printf("  PASSED\n");
+}
+
+// Test 36: alloc_at_least() reports each tier's real block size, and all of it is usable
+TEST(AllocAtLeastAllTiers) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    const size_t sizes[] = {1, 100, 1000, 5000, 9000, 15000, 40000, 700 * 1024,
+                            3 * 1024 * 1024 + 1};
+    for (size_t size : sizes) {
+        Cell::AllocationResult block = ctx.alloc_at_least(size, 3);
+        assert(block.ptr != nullptr && block.size >= size);
+        assert(block.size == ctx.usable_size(block.ptr));
+#ifndef CELL_DEBUG_GUARDS
+        if (size <= Cell::kMaxSubCellSize) {
+            assert(block.size == Cell::kSizeClasses[Cell::get_size_class(size, 8)]);
+        } else if (size > 2 * 1024 * 1024) {
+            assert(block.size % 4096 == 0);
+        }
+        (void)block.size;
+#endif
+        std::memset(block.ptr, 0xA5, block.size);
+        ctx.free_sized(block.ptr, block.size);
+    }
+
+    Cell::AllocationResult none = ctx.alloc_at_least(0);
+    assert(none.ptr == nullptr && none.size == 0);
+    (void)none;
+
+    printf("  PASSED\n");
+}
+
+// Test 37: At the largest buddy block, alloc_at_least() still returns at least the request
+TEST(AllocAtLeastBuddyBoundary) {
+    Cell::Config config;
+    config.reserve_size = 256 * 1024 * 1024; // Enough for a buddy tier
+    Cell::Context ctx(config);
+
+    const size_t sizes[] = {2 * 1024 * 1024 - 16, 2 * 1024 * 1024 - 15, 2 * 1024 * 1024};
+    for (size_t size : sizes) {
+        Cell::AllocationResult block = ctx.alloc_at_least(size);
+        assert(block.ptr != nullptr && block.size >= size);
+        assert(ctx.usable_size(block.ptr) >= size);
+        std::memset(block.ptr, 0x5C, block.size);
+        ctx.free_sized(block.ptr, block.size);
+
+        void *plain = ctx.alloc_bytes(size);
+        assert(plain != nullptr && ctx.usable_size(plain) >= size);
+        ctx.free_bytes(plain);
+    }
+
+    printf("  PASSED\n");
+}
+
+// Test 38: Reallocating within the block's class, cell or buddy order keeps the block
+TEST(ReallocWithinBlockStaysInPlace) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    // Full cell: anything past the size classes that fits the cell
+    void *cell = ctx.alloc_bytes(9000);
+    std::memset(cell, 0x11, 9000);
+    assert(ctx.realloc_bytes(cell, 12000) == cell);
+    assert(ctx.realloc_bytes(cell, ctx.usable_size(cell)) == cell);
+    assert(static_cast<unsigned char *>(cell)[8999] == 0x11);
+    ctx.free_bytes(cell);
+
+    // Buddy: growing and shrinking inside the same power of two
+    void *buddy = ctx.alloc_bytes(40000);
+    size_t buddy_size = ctx.usable_size(buddy);
+    std::memset(buddy, 0x22, 40000);
+    assert(ctx.realloc_bytes(buddy, buddy_size) == buddy);
+    assert(ctx.realloc_bytes(buddy, buddy_size / 2 + 100) == buddy);
+    assert(ctx.usable_size(buddy) == buddy_size);
+    assert(static_cast<unsigned char *>(buddy)[buddy_size / 2] == 0x22);
+    (void)buddy_size;
+    ctx.free_bytes(buddy);
+
+    // Sub-cell: up to the class size
+    Cell::AllocationResult small = ctx.alloc_at_least(100);
+    assert(ctx.realloc_bytes(small.ptr, small.size) == small.ptr);
+    ctx.free_bytes(small.ptr);
+
+    printf("  PASSED\n");
+}
+
+// Test 39: StlAllocator::allocate_at_least() hands containers the whole block
+TEST(StlAllocatorAllocateAtLeast) {
+    Cell::Config config;
+    config.reserve_size = 16 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    Cell::StlAllocator<uint32_t> alloc(ctx);
+    auto result = alloc.allocate_at_least(25);
+    assert(result.ptr != nullptr && result.count >= 25);
+#ifndef CELL_DEBUG_GUARDS
+    assert(result.count * sizeof(uint32_t) == ctx.usable_size(result.ptr));
+#endif
+    for (size_t i = 0; i < result.count; ++i) {
+        result.ptr[i] = static_cast<uint32_t>(i);
+    }
+    alloc.deallocate(result.ptr, result.count);
+
+    auto empty = alloc.allocate_at_least(0);
+    assert(empty.ptr == nullptr && empty.count == 0);
+    (void)empty;
+
+    printf("  PASSED\n");
+}
+
 // =============================================================================
 // Main
 // =============================================================================
@@ -0,0 +1,304 @@
+/**
+ * @file test_tag_heap.cpp
+ * @brief Tests for tag-segregated heaps (Config::tag_heaps) and Context::release_tag().
+ */
+
+#include "cell/context.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+// Simple test helper
+#define TEST(name)                                                                                 \
+    void test_##name();                                                                            \
+    struct Register##name {                                                                        \
+        Register##name() { tests.push_back({#name, test_##name}); }                                \
+    } reg_##name;                                                                                  \
+    void test_##name()
+
+struct TestCase {
+    const char *name;
+    void (*fn)();
+};
+std::vector<TestCase> tests;
+
+static constexpr uint8_t kLevelTag = 7;
+static constexpr uint8_t kSessionTag = 9;
+
+static Cell::Config heap_config() {
+    Cell::Config config;
+    config.reserve_size = 128 * 1024 * 1024;
+    config.tag_heaps.set(kLevelTag);
+    config.tag_heaps.set(kSessionTag);
+    return config;
+}
+
+// Test 1: Only the configured tags get a heap
+TEST(TagHeapConfig) {
+    Cell::Context ctx(heap_config());
+    assert(ctx.has_tag_heap(kLevelTag));
+    assert(ctx.has_tag_heap(kSessionTag));
+    assert(!ctx.has_tag_heap(0));
+    assert(!ctx.has_tag_heap(3));
+    assert(ctx.release_tag(3) == 0);
+
+    // Tag 0 cannot be segregated
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    config.tag_heaps.set(0);
+    Cell::Context untagged(config);
+    assert(!untagged.has_tag_heap(0));
+
+    printf("  PASSED\n");
+}
+
+// Test 2: A tag heap's cells hold nothing but that tag's blocks
+TEST(TagHeapSegregation) {
+    Cell::Context ctx(heap_config());
+
+    std::vector<void *> level;
+    std::vector<void *> other;
+    for (size_t i = 0; i < 4000; ++i) {
+        size_t size = 16 + (i * 53) % 4000;
+        level.push_back(ctx.alloc_bytes(size, kLevelTag));
+        other.push_back(ctx.alloc_bytes(size, i % 2 ? 0 : 3));
+        void *session = ctx.alloc_bytes(size, kSessionTag);
+        assert(Cell::get_header(session)->tag == kSessionTag);
+        ctx.free_bytes(session);
+    }
+
+    std::set<Cell::CellHeader *> level_cells;
+    for (void *ptr : level) {
+        assert(ptr != nullptr);
+        assert(Cell::get_header(ptr)->tag == kLevelTag);
+        level_cells.insert(Cell::get_header(ptr));
+    }
+    for (void *ptr : other) {
+        assert(level_cells.count(Cell::get_header(ptr)) == 0);
+    }
+
+    // Freed blocks go back to the heap, not to the thread's cache for other tags
+    void *block = level.back();
+    level.pop_back();
+    size_t block_size = ctx.usable_size(block);
+    ctx.free_bytes(block);
+    void *untagged = ctx.alloc_bytes(block_size);
+    assert(untagged != block);
+    void *again = ctx.alloc_bytes(block_size, kLevelTag);
+    assert(level_cells.count(Cell::get_header(again)) == 1);
+    level.push_back(again);
+
+    for (void *ptr : level) {
+        ctx.free_bytes(ptr);
+    }
+    for (void *ptr : other) {
+        ctx.free_bytes(ptr);
+    }
+    ctx.free_bytes(untagged);
+
+    printf("  PASSED\n");
+}
+
+// Test 3: Every free path returns tag heap blocks to their heap
+TEST(TagHeapFreePaths) {
+    Cell::Context ctx(heap_config());
+
+    // The first block of each cell stays live, so that no cell leaves the heap
+    std::vector<void *> blocks;
+    std::vector<void *> anchors;
+    std::set<Cell::CellHeader *> cells;
+    for (size_t i = 0; i < 600 + anchors.size(); ++i) {
+        void *ptr = ctx.alloc_bytes(96, kLevelTag);
+        if (cells.insert(Cell::get_header(ptr)).second) {
+            anchors.push_back(ptr);
+        } else {
+            blocks.push_back(ptr);
+        }
+    }
+    for (size_t i = 0; i < 200; ++i) {
+        ctx.free_sized(blocks[i], 96);
+    }
+    ctx.free_batch(blocks.data() + 200, 200);
+    std::thread([&] {
+        for (size_t i = 400; i < blocks.size(); ++i) {
+            ctx.free_bytes(blocks[i]);
+        }
+    }).join();
+
+    // All of them are free in the heap again: allocating as many reuses its cells
+    std::vector<void *> reused(blocks.size());
+    for (void *&ptr : reused) {
+        ptr = ctx.alloc_bytes(96, kLevelTag);
+        assert(cells.count(Cell::get_header(ptr)) == 1);
+    }
+
+    // Batch, contiguous and full-cell allocations are served by the heap too
+    void *batch[300];
+    size_t got = ctx.alloc_batch(48, batch, 300, kLevelTag);
+    assert(got == 300);
+    for (size_t i = 0; i < got; ++i) {
+        assert(Cell::get_header(batch[i])->tag == kLevelTag);
+    }
+    void *run = ctx.alloc_contiguous(64, 16, kLevelTag);
+    assert(run != nullptr && Cell::get_header(run)->tag == kLevelTag);
+    void *cell = ctx.alloc_bytes(12000, kLevelTag);
+    assert(cell != nullptr);
+
+    ctx.free_batch(batch, got);
+    ctx.free_batch(reused.data(), reused.size());
+    ctx.free_batch(anchors.data(), anchors.size());
+    for (size_t i = 0; i < 16; ++i) {
+        ctx.free_bytes(static_cast<char *>(run) + i * 64);
+    }
+    ctx.free_bytes(cell);
+
+    // Nothing is left, so only warm cells remain to release
+    size_t warm = ctx.release_tag(kLevelTag);
+    printf("  %zu warm cells released\n", warm);
+    assert(warm <= Cell::kNumSizeBins * Cell::kWarmCellsPerBin);
+
+    printf("  PASSED\n");
+}
+
+// Test 4: release_tag() frees a tag's allocations wholesale and leaves the rest alone
+TEST(TagHeapReleaseTag) {
+    Cell::Context ctx(heap_config());
+
+    std::vector<uint64_t *> kept;
+    for (size_t i = 0; i < 4000; ++i) {
+        void *ptr = ctx.alloc_bytes(16 + (i * 37) % 8000, kLevelTag);
+        assert(ptr != nullptr);
+        if (i % 3 == 0) {
+            auto *value = static_cast<uint64_t *>(ctx.alloc_bytes(64, kSessionTag));
+            *value = i;
+            kept.push_back(value);
+        }
+    }
+    for (size_t i = 0; i < 8; ++i) {
+        void *cell = ctx.alloc_bytes(12000, kLevelTag);
+        assert(cell != nullptr);
+    }
+
+    size_t released = ctx.release_tag(kLevelTag);
+    assert(released > 100);
+    assert(ctx.release_tag(kLevelTag) == 0);
+    (void)released;
+
+    // Other tags are untouched; the released tag allocates afresh
+    for (size_t i = 0; i < kept.size(); ++i) {
+        assert(*kept[i] == i * 3);
+    }
+    void *fresh = ctx.alloc_bytes(256, kLevelTag);
+    assert(fresh != nullptr && Cell::get_header(fresh)->tag == kLevelTag);
+    ctx.free_bytes(fresh);
+
+    for (uint64_t *value : kept) {
+        ctx.free_bytes(value);
+    }
+
+    printf("  PASSED\n");
+}
+
+// Test 5: Superblocks the released cells leave free can be decommitted at once
+TEST(TagHeapReleaseDecommit) {
+    Cell::Context ctx(heap_config());
+
+    // 4096-byte blocks: three per cell, several 2MB superblocks' worth
+    for (size_t i = 0; i < 3 * 1024; ++i) {
+        void *ptr = ctx.alloc_bytes(4096, kLevelTag);
+        assert(ptr != nullptr);
+        std::memset(ptr, 0xAB, 4096);
+    }
+    size_t committed = ctx.committed_bytes();
+    ctx.release_tag(kLevelTag);
+    size_t decommitted = ctx.decommit_unused();
+    printf("  %zu KB committed, %zu KB decommitted\n", committed / 1024, decommitted / 1024);
+    assert(decommitted >= 2 * Cell::kSuperblockSize);
+    (void)committed;
+
+    printf("  PASSED\n");
+}
+
+// Test 6: Threads share a tag heap safely
+TEST(TagHeapThreads) {
+    Cell::Context ctx(heap_config());
+
+    constexpr size_t kThreads = 4;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&ctx, t] {
+            std::vector<void *> live;
+            for (size_t i = 0; i < 20000; ++i) {
+                live.push_back(ctx.alloc_bytes(16 + (i + t * 7) % 1024, kLevelTag));
+                if (live.size() == 32) {
+                    // Free half, keep half live until the tag is released
+                    for (size_t j = 0; j < live.size(); j += 2) {
+                        ctx.free_bytes(live[j]);
+                    }
+                    live.clear();
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    assert(ctx.release_tag(kLevelTag) > 0);
+
+    printf("  PASSED\n");
+}
+
+#ifdef CELL_ENABLE_STATS
+// Test 7: Statistics drop the released allocations
+TEST(TagHeapReleaseStats) {
+    Cell::Context ctx(heap_config());
+
+    for (size_t i = 0; i < 1000; ++i) {
+        void *ptr = ctx.alloc_bytes(200, kLevelTag);
+        (void)ptr;
+    }
+    void *cell = ctx.alloc_bytes(12000, kLevelTag);
+    (void)cell;
+    void *other = ctx.alloc_bytes(200, kSessionTag);
+    assert(ctx.get_stats().per_tag_current[kLevelTag] > 1000 * 200);
+
+    ctx.release_tag(kLevelTag);
+    const Cell::MemoryStats &stats = ctx.get_stats();
+    assert(stats.per_tag_current[kLevelTag] == 0);
+    assert(stats.per_tag_current[kSessionTag] > 0);
+    ctx.free_bytes(other);
+
+    printf("  PASSED\n");
+}
+#endif
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    printf("Tag Heap Tests\n");
+    printf("==============\n\n");
+
+    int passed = 0;
+    int failed = 0;
+
+    for (const auto &test : tests) {
+        printf("Running %s...\n", test.name);
+        try {
+            test.fn();
+            ++passed;
+        } catch (...) {
+            printf("  FAILED (exception)\n");
+            ++failed;
+        }
+    }
+
+    printf("\n");
+    printf("Results: %d passed, %d failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,413 @@
+/**
+ * @file test_trace.cpp
+ * @brief Tests for the per-thread allocation event rings and TraceWriter.
+ */
+
+#include "cell/context.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Simple test helper
+#define TEST(name)                                                                                 \
+    void test_##name();                                                                            \
+    struct Register##name {                                                                        \
+        Register##name() { tests.push_back({#name, test_##name}); }                                \
+    } reg_##name;                                                                                  \
+    void test_##name()
+
+struct TestCase {
+    const char *name;
+    void (*fn)();
+};
+std::vector<TestCase> tests;
+
+// =============================================================================
+// Trace Tests (only run when CELL_ENABLE_TRACE is defined)
+// =============================================================================
+
+#ifdef CELL_ENABLE_TRACE
+
+static std::vector<Cell::TraceEvent> drain_all(Cell::Context &ctx) {
+    std::vector<Cell::TraceEvent> events;
+    Cell::TraceEvent batch[256];
+    size_t count;
+    while ((count = ctx.drain_trace(batch, 256)) > 0) {
+        events.insert(events.end(), batch, batch + count);
+    }
+    return events;
+}
+
+static bool is_event(const Cell::TraceEvent &event, Cell::TraceKind kind, const void *ptr,
+                     Cell::TraceTier tier) {
+    return event.kind == kind && event.ptr == reinterpret_cast<uintptr_t>(ptr) &&
+           event.tier == tier;
+}
+
+// Test 1: Nothing is recorded until tracing is switched on
+TEST(TraceOffByDefault) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    assert(!ctx.is_tracing());
+    ctx.free_bytes(ctx.alloc_bytes(64));
+    assert(drain_all(ctx).empty());
+    assert(ctx.trace_dropped() == 0);
+
+    printf("  PASSED\n");
+}
+
+// Test 2: Every tier's allocs and frees arrive in order with tag, size and tier
+TEST(TraceTiers) {
+    Cell::Config config;
+    config.reserve_size = 128 * 1024 * 1024;
+    Cell::Context ctx(config);
+    ctx.set_tracing(true);
+
+    void *small = ctx.alloc_bytes(64, 5);
+    void *cell = ctx.alloc_bytes(10000, 6);
+    void *buddy = ctx.alloc_bytes(300 * 1024, 7);
+    void *large = ctx.alloc_bytes(4 * 1024 * 1024, 8);
+    ctx.free_bytes(small);
+    ctx.free_bytes(cell);
+    ctx.free_bytes(buddy);
+    ctx.free_bytes(large);
+
+    std::vector<Cell::TraceEvent> events = drain_all(ctx);
+    assert(events.size() == 8);
+    using Cell::TraceKind;
+    using Cell::TraceTier;
+    assert(is_event(events[0], TraceKind::kAlloc, small, TraceTier::kSubCell));
+    assert(is_event(events[1], TraceKind::kAlloc, cell, TraceTier::kCell));
+    assert(is_event(events[2], TraceKind::kAlloc, buddy, TraceTier::kBuddy));
+    assert(is_event(events[3], TraceKind::kAlloc, large, TraceTier::kLarge));
+    assert(is_event(events[4], TraceKind::kFree, small, TraceTier::kSubCell));
+    assert(is_event(events[5], TraceKind::kFree, cell, TraceTier::kCell));
+    assert(is_event(events[6], TraceKind::kFree, buddy, TraceTier::kBuddy));
+    assert(is_event(events[7], TraceKind::kFree, large, TraceTier::kLarge));
+
+    assert(events[0].size == 64 && events[0].tag == 5);
+    assert(events[3].size == 4 * 1024 * 1024 && events[3].tag == 8);
+    assert(events[4].size >= 64 && events[4].tag == 5); // Block size of the class
+    assert(events[5].size == Cell::kCellSize);
+    assert(events[6].size >= 300 * 1024);
+    for (size_t i = 1; i < events.size(); ++i) {
+        assert(events[i].timestamp >= events[i - 1].timestamp);
+        assert(events[i].thread == events[0].thread);
+    }
+    assert(events[0].thread != 0);
+
+    // Switching off stops recording again
+    ctx.set_tracing(false);
+    ctx.free_bytes(ctx.alloc_bytes(64));
+    assert(drain_all(ctx).empty());
+
+    printf("  PASSED\n");
+}
+
+// Test 3: The sized, batch and realloc paths are traced too
+TEST(TraceSizedBatchRealloc) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+    ctx.set_tracing(true);
+
+    void *sized = ctx.alloc_bytes(100);
+    ctx.free_sized(sized, 100);
+
+    constexpr size_t kBatch = 40;
+    void *batch[kBatch];
+    size_t got = ctx.alloc_batch(48, batch, kBatch);
+    assert(got == kBatch);
+    ctx.free_batch(batch, got);
+
+    void *grown = ctx.alloc_bytes(40);
+    void *same = ctx.realloc_bytes(grown, 44); // Same size class: resized in place
+    assert(same == grown);
+    ctx.free_bytes(same);
+
+    std::vector<Cell::TraceEvent> events = drain_all(ctx);
+    size_t allocs = 0;
+    size_t frees = 0;
+    size_t reallocs = 0;
+    for (const Cell::TraceEvent &event : events) {
+        allocs += event.kind == Cell::TraceKind::kAlloc ? 1 : 0;
+        frees += event.kind == Cell::TraceKind::kFree ? 1 : 0;
+        reallocs += event.kind == Cell::TraceKind::kRealloc ? 1 : 0;
+    }
+    assert(allocs == kBatch + 2);
+    assert(frees == kBatch + 2);
+    assert(reallocs == 1);
+    assert(is_event(events[events.size() - 2], Cell::TraceKind::kRealloc, grown,
+                    Cell::TraceTier::kSubCell));
+    assert(events[events.size() - 2].size == 44);
+    (void)allocs;
+    (void)frees;
+    (void)reallocs;
+
+    printf("  PASSED\n");
+}
+
+// Test 4: A ring nobody drains keeps its oldest events and counts the rest as dropped
+TEST(TraceDropsWhenFull) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+    ctx.set_tracing(true);
+
+    constexpr size_t kPairs = Cell::kTraceRingEvents;
+    for (size_t i = 0; i < kPairs; ++i) {
+        ctx.free_bytes(ctx.alloc_bytes(32));
+    }
+    assert(ctx.trace_dropped() == 2 * kPairs - Cell::kTraceRingEvents);
+
+    std::vector<Cell::TraceEvent> events = drain_all(ctx);
+    assert(events.size() == Cell::kTraceRingEvents);
+    assert(events[0].kind == Cell::TraceKind::kAlloc);
+
+    // Draining makes room again
+    ctx.free_bytes(ctx.alloc_bytes(32));
+    assert(drain_all(ctx).size() == 2);
+
+    printf("  PASSED\n");
+}
+
+// =============================================================================
+// Threads
+// =============================================================================
+
+// Test 5: A consumer draining while workers allocate sees each worker's events in order
+TEST(TraceConcurrentConsumer) {
+    Cell::Config config;
+    config.reserve_size = 128 * 1024 * 1024;
+    Cell::Context ctx(config);
+    ctx.set_tracing(true);
+
+    constexpr size_t kThreads = 4;
+    constexpr size_t kOps = 20000;
+    std::atomic<size_t> running{kThreads};
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < kThreads; ++t) {
+        workers.emplace_back([&ctx, &running, t] {
+            std::vector<void *> live;
+            for (size_t i = 0; i < kOps; ++i) {
+                live.push_back(ctx.alloc_bytes(16 + (i + t) % 512));
+                if (live.size() == 16) {
+                    for (void *p : live) {
+                        ctx.free_bytes(p);
+                    }
+                    live.clear();
+                }
+            }
+            for (void *p : live) {
+                ctx.free_bytes(p);
+            }
+            running.fetch_sub(1);
+        });
+    }
+
+    std::map<uint32_t, uint64_t> last_timestamp;
+    size_t drained = 0;
+    Cell::TraceEvent batch[512];
+    bool done = false;
+    while (!done) {
+        done = running.load() == 0; // One more pass after the workers finish
+        size_t count;
+        while ((count = ctx.drain_trace(batch, 512)) > 0) {
+            for (size_t i = 0; i < count; ++i) {
+                auto it = last_timestamp.find(batch[i].thread);
+                assert(it == last_timestamp.end() || batch[i].timestamp >= it->second);
+                (void)it;
+                last_timestamp[batch[i].thread] = batch[i].timestamp;
+            }
+            drained += count;
+        }
+        std::this_thread::yield();
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    printf("  %zu events drained, %llu dropped\n", drained,
+           static_cast<unsigned long long>(ctx.trace_dropped()));
+    assert(drained + ctx.trace_dropped() == 2 * kThreads * kOps);
+    assert(last_timestamp.size() == kThreads);
+
+    printf("  PASSED\n");
+}
+
+// Test 6: A ring outlives its thread and is handed to the next one
+TEST(TraceRingReuse) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+    ctx.set_tracing(true);
+
+    std::thread([&] { ctx.free_bytes(ctx.alloc_bytes(64)); }).join();
+    std::vector<Cell::TraceEvent> events = drain_all(ctx);
+    assert(events.size() == 2);
+    uint32_t first = events[0].thread;
+
+    // Queued events keep the number of the thread that recorded them
+    std::thread([&] { ctx.free_bytes(ctx.alloc_bytes(64)); }).join();
+    std::thread([&] { ctx.free_bytes(ctx.alloc_bytes(64)); }).join();
+    events = drain_all(ctx);
+    assert(events.size() == 4);
+    assert(events[0].thread == events[1].thread && events[2].thread == events[3].thread);
+    assert(first != 0 && events[0].thread != first && events[2].thread != events[0].thread);
+    (void)first;
+
+    printf("  PASSED\n");
+}
+
+// Test 7: A block freed to its owner by size is traced before the owner can reuse it
+TEST(TraceRemoteSizedFreeOrder) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+    ctx.set_tracing(true);
+
+    // Fewer events per thread than a ring holds, so nothing is dropped
+    constexpr size_t kBlocks = 3000;
+    std::mutex lock;
+    std::vector<void *> handoff;
+    std::atomic<bool> produced{false};
+    std::thread producer([&] {
+        for (size_t i = 0; i < kBlocks; ++i) {
+            void *ptr = i % 2 ? ctx.alloc_bytes(64, 0, 64) : ctx.alloc_bytes(48);
+            std::lock_guard<std::mutex> guard(lock);
+            handoff.push_back(ptr);
+        }
+        produced.store(true);
+    });
+    size_t freed = 0;
+    while (freed < kBlocks) {
+        std::vector<void *> taken;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            taken.swap(handoff);
+        }
+        for (void *ptr : taken) {
+            // The allocation order is the handoff order, so freed says which size it was
+            if (freed++ % 2) {
+                ctx.free_aligned_sized(ptr, 64, 64);
+            } else {
+                ctx.free_sized(ptr, 48);
+            }
+        }
+        std::this_thread::yield();
+    }
+    producer.join();
+    assert(produced.load());
+
+    // Replayed in timestamp order, an address is never allocated while still live
+    std::vector<Cell::TraceEvent> events = drain_all(ctx);
+    assert(events.size() == 2 * kBlocks && ctx.trace_dropped() == 0);
+    std::stable_sort(events.begin(), events.end(),
+                     [](const Cell::TraceEvent &a, const Cell::TraceEvent &b) {
+                         return a.timestamp < b.timestamp;
+                     });
+    std::map<uint64_t, bool> live;
+    for (const Cell::TraceEvent &event : events) {
+        bool &is_live = live[event.ptr];
+        assert(is_live == (event.kind == Cell::TraceKind::kFree));
+        is_live = event.kind == Cell::TraceKind::kAlloc;
+    }
+
+    printf("  PASSED\n");
+}
+
+// =============================================================================
+// TraceWriter
+// =============================================================================
+
+// Test 8: The writer produces a header followed by every recorded event
+TEST(TraceWriterStream) {
+    Cell::Config config;
+    config.reserve_size = 64 * 1024 * 1024;
+    Cell::Context ctx(config);
+
+    std::FILE *out = std::tmpfile();
+    assert(out);
+    {
+        Cell::TraceWriter writer(ctx, out, 1);
+        assert(ctx.is_tracing());
+        for (size_t i = 0; i < 1000; ++i) {
+            ctx.free_bytes(ctx.alloc_bytes(16 + i % 256, 3));
+        }
+        std::thread([&] { ctx.free_bytes(ctx.alloc_bytes(128)); }).join();
+    }
+    assert(!ctx.is_tracing());
+
+    std::rewind(out);
+    Cell::TraceFileHeader header;
+    size_t read = std::fread(&header, sizeof(header), 1, out);
+    assert(read == 1);
+    assert(std::memcmp(header.magic, "CELLTRC1", 8) == 0);
+    assert(header.event_size == sizeof(Cell::TraceEvent));
+    assert(header.ticks_per_second > 0);
+    (void)read;
+
+    size_t events = 0;
+    Cell::TraceEvent event;
+    while (std::fread(&event, sizeof(event), 1, out) == 1) {
+        assert(event.kind == Cell::TraceKind::kAlloc || event.kind == Cell::TraceKind::kFree);
+        ++events;
+    }
+    std::fclose(out);
+    assert(events == 2002);
+    (void)events;
+
+    printf("  PASSED\n");
+}
+
+#else
+
+// When tracing is disabled, just report that
+TEST(TraceDisabled) {
+    printf("  CELL_ENABLE_TRACE not defined, trace tests skipped\n");
+    printf("  PASSED\n");
+}
+
+#endif
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    printf("Allocation Trace Tests\n");
+    printf("======================\n");
+#ifdef CELL_ENABLE_TRACE
+    printf("CELL_ENABLE_TRACE: ENABLED\n");
+#else
+    printf("CELL_ENABLE_TRACE: DISABLED\n");
+#endif
+    printf("\n");
+
+    int passed = 0;
+    int failed = 0;
+
+    for (const auto &test : tests) {
+        printf("Running %s...\n", test.name);
+        try {
+            test.fn();
+            ++passed;
+        } catch (...) {
+            printf("  FAILED (exception)\n");
+            ++failed;
+        }
+    }
+
+    printf("\n");
+    printf("Results: %d passed, %d failed\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}